@@ -84,11 +84,46 @@
 #define CIASICIDGFXENGINE_ARCTICISLAND 0x0000000D
 #endif
 
+/* Bounds the memory used by the layouts cached per device, which are about
+ * two radeon_surf structs each.
+ */
+#define AC_SURF_CACHE_MAX_ENTRIES 256
+
 struct ac_addrlib {
    ADDR_HANDLE handle;
    simple_mtx_t lock;
+
+   /* Computed layouts of previous ac_compute_surface calls. */
+   simple_mtx_t surf_cache_lock;
+   struct hash_table *surf_cache;
+};
+
+struct ac_surf_cache_key {
+   struct ac_surf_config config;
+   enum radeon_surf_mode mode;
+   struct radeon_surf surf;
 };
 
+struct ac_surf_cache_entry {
+   struct ac_surf_cache_key key;
+   struct radeon_surf surf;
+};
+
+static uint32_t ac_surf_cache_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct ac_surf_cache_key));
+}
+
+static bool ac_surf_cache_key_equal(const void *a, const void *b)
+{
+   return !memcmp(a, b, sizeof(struct ac_surf_cache_key));
+}
+
+static void ac_surf_cache_entry_free(struct hash_entry *entry)
+{
+   FREE(entry->data);
+}
+
 unsigned ac_pipe_config_to_num_pipes(unsigned pipe_config)
 {
    switch (pipe_config) {
@@ -671,11 +706,16 @@ struct ac_addrlib *ac_addrlib_create(const struct radeon_info *info,
 
    addrlib->handle = addrCreateOutput.hLib;
    simple_mtx_init(&addrlib->lock, mtx_plain);
+   simple_mtx_init(&addrlib->surf_cache_lock, mtx_plain);
+   addrlib->surf_cache = _mesa_hash_table_create(NULL, ac_surf_cache_key_hash,
+                                                 ac_surf_cache_key_equal);
    return addrlib;
 }
 
 void ac_addrlib_destroy(struct ac_addrlib *addrlib)
 {
+   _mesa_hash_table_destroy(addrlib->surf_cache, ac_surf_cache_entry_free);
+   simple_mtx_destroy(&addrlib->surf_cache_lock);
    simple_mtx_destroy(&addrlib->lock);
    AddrDestroy(addrlib->handle);
    free(addrlib);
@@ -3344,9 +3384,9 @@ static bool gfx12_compute_surface(struct ac_addrlib *addrlib, const struct radeo
    return true;
 }
 
-int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
-                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
-                       struct radeon_surf *surf)
+static int ac_compute_surface_uncached(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                                      const struct ac_surf_config *config,
+                                      enum radeon_surf_mode mode, struct radeon_surf *surf)
 {
    int r;
 
@@ -3442,6 +3482,62 @@ int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *inf
    return 0;
 }
 
+int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
+                       struct radeon_surf *surf)
+{
+   /* Drivers create the same kinds of images over and over, so remember the
+    * layouts addrlib computed.  The whole input surface is part of the key,
+    * because callers preset some of the layout fields.  Surface indices are
+    * counters that change the result and must be incremented, so they bypass
+    * the cache.
+    */
+   if (!addrlib->surf_cache || config->info.surf_index || config->info.fmask_surf_index)
+      return ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+
+   /* Padding is part of the key, so start from zeroes. */
+   struct ac_surf_cache_entry *entry = CALLOC_STRUCT(ac_surf_cache_entry);
+   if (!entry)
+      return ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+
+   memcpy(&entry->key.config, config, sizeof(*config));
+   entry->key.mode = mode;
+   memcpy(&entry->key.surf, surf, sizeof(*surf));
+
+   uint32_t hash = ac_surf_cache_key_hash(&entry->key);
+
+   simple_mtx_lock(&addrlib->surf_cache_lock);
+   struct hash_entry *he =
+      _mesa_hash_table_search_pre_hashed(addrlib->surf_cache, hash, &entry->key);
+   if (he) {
+      *surf = ((struct ac_surf_cache_entry *)he->data)->surf;
+      simple_mtx_unlock(&addrlib->surf_cache_lock);
+      FREE(entry);
+      return 0;
+   }
+   simple_mtx_unlock(&addrlib->surf_cache_lock);
+
+   int r = ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+   if (r) {
+      FREE(entry);
+      return r;
+   }
+
+   entry->surf = *surf;
+
+   simple_mtx_lock(&addrlib->surf_cache_lock);
+   if (_mesa_hash_table_num_entries(addrlib->surf_cache) >= AC_SURF_CACHE_MAX_ENTRIES)
+      _mesa_hash_table_clear(addrlib->surf_cache, ac_surf_cache_entry_free);
+
+   if (_mesa_hash_table_search_pre_hashed(addrlib->surf_cache, hash, &entry->key) ||
+       !_mesa_hash_table_insert_pre_hashed(addrlib->surf_cache, hash, &entry->key, entry)) {
+      FREE(entry);
+   }
+   simple_mtx_unlock(&addrlib->surf_cache_lock);
+
+   return 0;
+}
+
 /* This is meant to be used for disabling DCC. */
 void ac_surface_zero_dcc_fields(struct radeon_surf *surf)
 {
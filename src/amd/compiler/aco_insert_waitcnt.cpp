@@ -10,9 +10,9 @@
 #include "common/sid.h"
 
 #include <map>
-#include <stack>
-#include <vector>
 #include <optional>
+#include <set>
+#include <vector>
 
 namespace aco {
 
@@ -20,8 +20,9 @@ namespace {
 
 /**
  * The general idea of this pass is:
- * The CFG is traversed in reverse postorder (forward) and loops are processed
- * several times until no progress is made.
+ * The CFG is traversed in reverse postorder (forward) using a worklist, and
+ * blocks are processed again whenever the out-context of a predecessor changed,
+ * until no progress is made.
  * Per BB two wait_ctx is maintained: an in-context and out-context.
  * The in-context is the joined out-contexts of the predecessors.
  * The context contains a map: gpr -> wait_entry
@@ -792,9 +793,6 @@ insert_waitcnt(Program* program)
    std::vector<wait_ctx> in_ctx(program->blocks.size(), wait_ctx(program, &info));
    std::vector<wait_ctx> out_ctx(program->blocks.size(), wait_ctx(program, &info));
 
-   std::stack<unsigned, std::vector<unsigned>> loop_header_indices;
-   unsigned loop_progress = 0;
-
    if (program->pending_lds_access) {
       update_barrier_imm(in_ctx[0], info.get_counters_for_event(event_lds), event_lds,
                          memory_sync_info(storage_shared));
@@ -805,52 +803,48 @@ insert_waitcnt(Program* program)
       insert_wait_entry(in_ctx[0], def, event_vmem);
    }
 
-   for (unsigned i = 0; i < program->blocks.size();) {
-      Block& current = program->blocks[i++];
-
-      if (current.kind & block_kind_discard_early_exit) {
-         /* Because the jump to the discard early exit block may happen anywhere in a block, it's
-          * not possible to join it with its predecessors this way.
-          * We emit all required waits when emitting the discard block.
-          */
-         continue;
-      }
-
-      wait_ctx ctx = in_ctx[current.index];
+   /* Blocks are processed in reverse postorder, and a block is only revisited if the out-context
+    * of one of its predecessors changed. This way, only the parts of loops which are affected by
+    * a back-edge are processed again, instead of whole loop nests.
+    */
+   std::set<unsigned> worklist;
+   for (Block& block : program->blocks) {
+      /* Because the jump to the discard early exit block may happen anywhere in a block, it's
+       * not possible to join it with its predecessors this way.
+       * We emit all required waits when emitting the discard block.
+       */
+      if (!(block.kind & block_kind_discard_early_exit))
+         worklist.insert(block.index);
+   }
 
-      if (current.kind & block_kind_loop_header) {
-         loop_header_indices.push(current.index);
-      } else if (current.kind & block_kind_loop_exit) {
-         bool repeat = false;
-         if (loop_progress == loop_header_indices.size()) {
-            i = loop_header_indices.top();
-            repeat = true;
-         }
-         loop_header_indices.pop();
-         loop_progress = std::min<unsigned>(loop_progress, loop_header_indices.size());
-         if (repeat)
-            continue;
-      }
+   while (!worklist.empty()) {
+      Block& current = program->blocks[*worklist.begin()];
+      worklist.erase(worklist.begin());
 
+      /* The in-context only grows, so the predecessors can be joined in-place. */
       bool changed = false;
       for (unsigned b : current.linear_preds)
-         changed |= ctx.join(&out_ctx[b], false);
+         changed |= in_ctx[current.index].join(&out_ctx[b], false);
       for (unsigned b : current.logical_preds)
-         changed |= ctx.join(&out_ctx[b], true);
+         changed |= in_ctx[current.index].join(&out_ctx[b], true);
 
-      if (done[current.index] && !changed) {
-         in_ctx[current.index] = std::move(ctx);
+      if (done[current.index] && !changed)
          continue;
-      } else {
-         in_ctx[current.index] = ctx;
-      }
 
-      loop_progress = std::max<unsigned>(loop_progress, current.loop_nest_depth);
       done[current.index] = true;
 
+      wait_ctx ctx = in_ctx[current.index];
       handle_block(program, current, ctx);
-
       out_ctx[current.index] = std::move(ctx);
+
+      for (unsigned succ : current.linear_succs) {
+         if (!(program->blocks[succ].kind & block_kind_discard_early_exit))
+            worklist.insert(succ);
+      }
+      for (unsigned succ : current.logical_succs) {
+         if (!(program->blocks[succ].kind & block_kind_discard_early_exit))
+            worklist.insert(succ);
+      }
    }
 }
 
@@ -9,6 +9,8 @@
 #include "aco_ir.h"
 
 #include "util/memstream.h"
+#include "util/os_time.h"
+#include "util/perf/cpu_trace.h"
 
 #include "ac_gpu_info.h"
 #include "nir.h"
@@ -47,9 +49,58 @@ static const std::array<aco_compiler_statistic_info, aco_num_statistics> statist
    ret[aco_statistic_vmem] = aco_compiler_statistic_info{"VMEM", "Number of VMEM instructions"};
    ret[aco_statistic_smem] = aco_compiler_statistic_info{"SMEM", "Number of SMEM instructions"};
    ret[aco_statistic_vopd] = aco_compiler_statistic_info{"VOPD", "Number of VOPD instructions"};
+   ret[aco_statistic_reloads] =
+      aco_compiler_statistic_info{"Reloads", "Values reloaded from spill slots by the spiller"};
+   ret[aco_statistic_remats] = aco_compiler_statistic_info{
+      "Rematerializations", "Values recomputed instead of reloaded by the spiller"};
+   ret[aco_statistic_arena_peak] = aco_compiler_statistic_info{
+      "Arena Memory", "Peak memory in KiB allocated from ACO's arenas during compilation"};
+   ret[aco_statistic_compile_time] = aco_compiler_statistic_info{
+      "Compile Time", "Time in microseconds spent in the ACO backend"};
    return ret;
 }();
 
+/* Measures the time spent in one compiler pass, accumulates it into
+ * Program::compile_time_ns and emits a Perfetto slice for it.
+ */
+class pass_timer {
+public:
+   pass_timer(Program* program_, const char* name_)
+       : program(program_), name(name_), start(os_time_get_nano())
+   {
+      _MESA_TRACE_BEGIN(name);
+   }
+
+   ~pass_timer()
+   {
+      _MESA_TRACE_END();
+
+      int64_t duration = os_time_get_nano() - start;
+      program->compile_time_ns += duration;
+      if (debug_flags & DEBUG_PASS_TIME)
+         fprintf(stderr, "ACO: %-20s %10.3f ms\n", name, duration / 1000000.0);
+   }
+
+   pass_timer(const pass_timer&) = delete;
+   pass_timer& operator=(const pass_timer&) = delete;
+
+private:
+   Program* program;
+   const char* name;
+   int64_t start;
+};
+
+static void
+report_compile_time(Program* program)
+{
+   if (program->collect_statistics)
+      program->statistics[aco_statistic_compile_time] =
+         DIV_ROUND_UP(program->compile_time_ns, 1000);
+
+   if (debug_flags & DEBUG_PASS_TIME)
+      fprintf(stderr, "ACO: %-20s %10.3f ms\n", "total", program->compile_time_ns / 1000000.0);
+}
+
 static void
 validate(Program* program)
 {
@@ -113,6 +164,7 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
 
    /* Optimization */
    if (!options->optimisations_disabled) {
+      pass_timer timer(program.get(), "optimize");
       if (!(debug_flags & DEBUG_NO_VN))
          value_numbering(program.get());
       if (!(debug_flags & DEBUG_NO_OPT))
@@ -124,15 +176,24 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    }
 
    /* cleanup and exec mask handling */
-   setup_reduce_temp(program.get());
-   insert_exec_mask(program.get());
+   {
+      pass_timer timer(program.get(), "insert_exec_mask");
+      setup_reduce_temp(program.get());
+      insert_exec_mask(program.get());
+   }
    validate(program.get());
 
    /* spilling and scheduling */
-   live_var_analysis(program.get());
+   {
+      pass_timer timer(program.get(), "live_var_analysis");
+      live_var_analysis(program.get());
+   }
    if (program->collect_statistics)
       collect_presched_stats(program.get());
-   spill(program.get());
+   {
+      pass_timer timer(program.get(), "spill");
+      spill(program.get());
+   }
 
    if (options->record_ir) {
       char* data = NULL;
@@ -152,12 +213,19 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    if ((debug_flags & DEBUG_LIVE_INFO) && options->dump_ir)
       aco_print_program(program.get(), stderr, print_live_vars | print_kill);
 
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED))
+   const bool full_opt = !options->optimisations_disabled && !options->fast_compile;
+
+   if (full_opt && !(debug_flags & DEBUG_NO_SCHED)) {
+      pass_timer timer(program.get(), "schedule");
       schedule_program(program.get());
+   }
    validate(program.get());
 
    /* Register Allocation */
-   register_allocation(program.get());
+   {
+      pass_timer timer(program.get(), "register_allocation");
+      register_allocation(program.get());
+   }
 
    if (validate_ra(program.get())) {
       aco_print_program(program.get(), stderr);
@@ -169,34 +237,50 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    validate(program.get());
 
    /* Optimization */
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_OPT)) {
-      optimize_postRA(program.get());
+   if (full_opt && !(debug_flags & DEBUG_NO_OPT)) {
+      {
+         pass_timer timer(program.get(), "optimize_postRA");
+         optimize_postRA(program.get());
+      }
       validate(program.get());
    }
 
    /* Lower to HW Instructions */
-   ssa_elimination(program.get());
-   lower_to_hw_instr(program.get());
-   lower_branches(program.get());
+   {
+      pass_timer timer(program.get(), "lower_to_hw_instr");
+      ssa_elimination(program.get());
+      lower_to_hw_instr(program.get());
+      lower_branches(program.get());
+   }
    validate(program.get());
 
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_VOPD))
+   if (full_opt && !(debug_flags & DEBUG_NO_SCHED_VOPD)) {
+      pass_timer timer(program.get(), "schedule_vopd");
       schedule_vopd(program.get());
+   }
 
    /* Schedule hardware instructions for ILP */
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_ILP))
+   if (full_opt && !(debug_flags & DEBUG_NO_SCHED_ILP)) {
+      pass_timer timer(program.get(), "schedule_ilp");
       schedule_ilp(program.get());
+   }
 
-   insert_waitcnt(program.get());
-   insert_NOPs(program.get());
-   if (program->gfx_level >= GFX11)
-      insert_delay_alu(program.get());
+   {
+      pass_timer timer(program.get(), "insert_waitcnt");
+      insert_waitcnt(program.get());
+   }
+   {
+      pass_timer timer(program.get(), "insert_NOPs");
+      insert_NOPs(program.get());
+      if (program->gfx_level >= GFX11)
+         insert_delay_alu(program.get());
 
-   if (program->gfx_level >= GFX10)
-      form_hard_clauses(program.get());
+      if (program->gfx_level >= GFX10)
+         form_hard_clauses(program.get());
 
-   if (program->gfx_level >= GFX11)
-      combine_delay_alu(program.get());
+      if (program->gfx_level >= GFX11)
+         combine_delay_alu(program.get());
+   }
 
    if (program->collect_statistics || (debug_flags & DEBUG_PERF_INFO))
       collect_preasm_stats(program.get());
@@ -232,14 +316,22 @@ aco_compile_shader_part(const struct aco_compiler_options* options,
    program->is_epilog = !is_prolog;
 
    /* Instruction selection */
-   select_shader_part(program.get(), pinfo, &config, options, info, args);
+   {
+      pass_timer timer(program.get(), "isel");
+      select_shader_part(program.get(), pinfo, &config, options, info, args);
+   }
 
    aco_postprocess_shader(options, program);
 
    /* assembly */
    std::vector<uint32_t> code;
    bool append_endpgm = !(options->is_opengl && is_prolog);
-   unsigned exec_size = emit_program(program.get(), code, NULL, append_endpgm);
+   unsigned exec_size;
+   {
+      pass_timer timer(program.get(), "assembler");
+      exec_size = emit_program(program.get(), code, NULL, append_endpgm);
+   }
+   report_compile_time(program.get());
 
    std::string disasm;
    if (options->record_asm)
@@ -258,6 +350,8 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
 {
    init();
 
+   monotonic_buffer_resource::reset_peak_usage();
+
    ac_shader_config config = {0};
    std::unique_ptr<Program> program{new Program};
 
@@ -269,7 +363,10 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
    program->debug.private_data = options->debug.private_data;
 
    /* Instruction Selection */
-   select_program(program.get(), shader_count, shaders, &config, options, info, args);
+   {
+      pass_timer timer(program.get(), "isel");
+      select_program(program.get(), shader_count, shaders, &config, options, info, args);
+   }
 
    std::string llvm_ir = aco_postprocess_shader(options, program);
 
@@ -280,10 +377,18 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
     * so only last part need the s_endpgm instruction.
     */
    bool append_endpgm = !(options->is_opengl && info->ps.has_epilog);
-   unsigned exec_size = emit_program(program.get(), code, &symbols, append_endpgm);
+   unsigned exec_size;
+   {
+      pass_timer timer(program.get(), "assembler");
+      exec_size = emit_program(program.get(), code, &symbols, append_endpgm);
+   }
+   report_compile_time(program.get());
 
-   if (program->collect_statistics)
+   if (program->collect_statistics) {
       collect_postasm_stats(program.get(), code);
+      program->statistics[aco_statistic_arena_peak] =
+         DIV_ROUND_UP(monotonic_buffer_resource::peak_usage(), 1024);
+   }
 
    std::string disasm;
    if (options->record_asm)
@@ -448,7 +553,7 @@ aco_get_codegen_flags()
    /* Exclude flags which don't affect code generation. */
    uint64_t exclude =
       DEBUG_VALIDATE_IR | DEBUG_VALIDATE_RA | DEBUG_PERF_INFO | DEBUG_LIVE_INFO |
-      DEBUG_NO_VALIDATE_IR | DEBUG_VALIDATE_LIVE_VARS;
+      DEBUG_NO_VALIDATE_IR | DEBUG_VALIDATE_LIVE_VARS | DEBUG_PASS_TIME;
    return debug_flags & ~exclude;
 }
 
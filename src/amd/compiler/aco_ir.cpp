@@ -32,6 +32,8 @@ static const struct debug_control aco_debug_options[] = {
    {"nosched-vopd", DEBUG_NO_SCHED_VOPD},
    {"perfinfo", DEBUG_PERF_INFO},
    {"liveinfo", DEBUG_LIVE_INFO},
+   {"passtime", DEBUG_PASS_TIME},
+   {"vnhoist", DEBUG_VN_HOIST},
    {NULL, 0}};
 
 static once_flag init_once_flag = ONCE_FLAG_INIT;
@@ -48,6 +50,9 @@ init_once()
 
    if (debug_flags & aco::DEBUG_NO_VALIDATE_IR)
       debug_flags &= ~aco::DEBUG_VALIDATE_IR;
+
+   monotonic_buffer_resource::max_pooled_bytes =
+      debug_get_num_option("ACO_ARENA_POOL_SIZE", monotonic_buffer_resource::max_pooled_bytes);
 }
 
 void
@@ -43,6 +43,8 @@ enum {
    DEBUG_NO_VALIDATE_IR = 0x400,
    DEBUG_NO_SCHED_ILP = 0x800,
    DEBUG_NO_SCHED_VOPD = 0x1000,
+   DEBUG_PASS_TIME = 0x2000,
+   DEBUG_VN_HOIST = 0x4000,
 };
 
 enum storage_class : uint8_t {
@@ -2144,6 +2146,7 @@ public:
 
    bool collect_statistics = false;
    uint32_t statistics[aco_num_statistics];
+   uint64_t compile_time_ns = 0;
 
    float_mode next_fp_mode;
    unsigned next_loop_depth = 0;
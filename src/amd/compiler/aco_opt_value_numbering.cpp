@@ -7,12 +7,16 @@
 #include "aco_ir.h"
 #include "aco_util.h"
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
 /*
  * Implements the algorithm for dominator-tree value numbering
  * from "Value Numbering" by Briggs, Cooper, and Simpson.
+ *
+ * Optionally (ACO_DEBUG=vnhoist), instructions which are computed on both
+ * sides of an if/else are hoisted into the branch block afterwards.
  */
 
 namespace aco {
@@ -335,6 +339,25 @@ is_trivial_phi(Block& block, Instruction* instr)
                       [&](Operand& op) { return op == instr->operands[0]; });
 }
 
+void
+merge_definition_flags(Definition& orig, const Definition& other)
+{
+   if (other.isPrecise())
+      orig.setPrecise(true);
+   if (other.isSZPreserve())
+      orig.setSZPreserve(true);
+   if (other.isInfPreserve())
+      orig.setInfPreserve(true);
+   if (other.isNaNPreserve())
+      orig.setNaNPreserve(true);
+   /* SPIR_V spec says that an instruction marked with NUW wrapping
+    * around is undefined behaviour, so we can break additions in
+    * other contexts.
+    */
+   if (other.isNUW())
+      orig.setNUW(true);
+}
+
 void
 process_block(vn_ctx& ctx, Block& block)
 {
@@ -384,20 +407,7 @@ process_block(vn_ctx& ctx, Block& block)
                assert(instr->definitions[i].regClass() == orig_instr->definitions[i].regClass());
                assert(instr->definitions[i].isTemp());
                ctx.renames[instr->definitions[i].tempId()] = orig_instr->definitions[i].getTemp();
-               if (instr->definitions[i].isPrecise())
-                  orig_instr->definitions[i].setPrecise(true);
-               if (instr->definitions[i].isSZPreserve())
-                  orig_instr->definitions[i].setSZPreserve(true);
-               if (instr->definitions[i].isInfPreserve())
-                  orig_instr->definitions[i].setInfPreserve(true);
-               if (instr->definitions[i].isNaNPreserve())
-                  orig_instr->definitions[i].setNaNPreserve(true);
-               /* SPIR_V spec says that an instruction marked with NUW wrapping
-                * around is undefined behaviour, so we can break additions in
-                * other contexts.
-                */
-               if (instr->definitions[i].isNUW())
-                  orig_instr->definitions[i].setNUW(true);
+               merge_definition_flags(orig_instr->definitions[i], instr->definitions[i]);
             }
          } else {
             ctx.expr_values.erase(res.first);
@@ -428,6 +438,174 @@ rename_phi_operands(Block& block, aco::unordered_map<uint32_t, Temp>& renames)
       }
    }
 }
+
+void
+rename_operands(aco_ptr<Instruction>& instr, aco::unordered_map<uint32_t, Temp>& renames)
+{
+   for (Operand& op : instr->operands) {
+      if (!op.isTemp())
+         continue;
+      auto it = renames.find(op.tempId());
+      if (it != renames.end())
+         op.setTemp(it->second);
+   }
+}
+
+/* Returns whether an instruction can be moved from the arms of an if/else
+ * into the branch block. The branch block executes with the union of the
+ * exec masks of both arms, so only instructions computing each lane
+ * independently of the other lanes and of exec are allowed.
+ */
+bool
+can_hoist(aco_ptr<Instruction>& instr)
+{
+   if (!can_eliminate(instr))
+      return false;
+
+   if (instr->isVALU()) {
+      if (instr->isDPP() || instr->opcode == aco_opcode::v_readfirstlane_b32 ||
+          instr->opcode == aco_opcode::v_readlane_b32 ||
+          instr->opcode == aco_opcode::v_readlane_b32_e64 ||
+          instr->opcode == aco_opcode::v_writelane_b32 ||
+          instr->opcode == aco_opcode::v_writelane_b32_e64 ||
+          instr->opcode == aco_opcode::v_permlane16_b32 ||
+          instr->opcode == aco_opcode::v_permlanex16_b32 ||
+          instr->opcode == aco_opcode::v_permlane64_b32)
+         return false;
+      /* VOPC and carry-outs write lane masks which depend on exec. */
+      for (const Definition& def : instr->definitions) {
+         if (def.regClass().type() != RegType::vgpr)
+            return false;
+      }
+   } else if (!instr->isSALU() || instr->opcode == aco_opcode::s_getpc_b64) {
+      return false;
+   }
+
+   /* This excludes exec, scc and m0 dependencies. */
+   for (const Operand& op : instr->operands) {
+      if (op.isFixed())
+         return false;
+   }
+   for (const Definition& def : instr->definitions) {
+      if (def.isFixed())
+         return false;
+   }
+
+   return true;
+}
+
+/* Moves instructions which are computed by both the then- and the else-side
+ * of an if/else into the branch block, so that they are only executed once.
+ * Only arms without other predecessors are considered, and only instructions
+ * whose operands are available in the branch block.
+ */
+bool
+hoist_common_instructions(Program* program, Block& block,
+                          aco::unordered_map<uint32_t, Temp>& renames)
+{
+   if (block.logical_succs.size() != 2)
+      return false;
+
+   Block& then_block = program->blocks[block.logical_succs[0]];
+   Block& else_block = program->blocks[block.logical_succs[1]];
+   if (then_block.index == else_block.index || then_block.logical_preds.size() != 1 ||
+       else_block.logical_preds.size() != 1 || then_block.logical_idom != (int)block.index ||
+       else_block.logical_idom != (int)block.index ||
+       !block.fp_mode.canReplace(then_block.fp_mode) ||
+       !block.fp_mode.canReplace(else_block.fp_mode))
+      return false;
+
+   auto logical_end = std::find_if(block.instructions.rbegin(), block.instructions.rend(),
+                                   [](const aco_ptr<Instruction>& instr)
+                                   { return instr->opcode == aco_opcode::p_logical_end; });
+   if (logical_end == block.instructions.rend())
+      return false;
+
+   monotonic_buffer_resource m;
+   aco::unordered_map<Instruction*, uint32_t, InstrHash, InstrPred> candidates(m);
+   /* Temporaries which are defined in one of the arms and not yet hoisted. */
+   std::vector<bool> local_temps(program->peekAllocationId());
+
+   for (uint32_t i = 0; i < then_block.instructions.size(); i++) {
+      aco_ptr<Instruction>& instr = then_block.instructions[i];
+      rename_operands(instr, renames);
+      for (const Definition& def : instr->definitions) {
+         if (def.isTemp())
+            local_temps[def.tempId()] = true;
+      }
+      if (can_hoist(instr))
+         candidates.emplace(instr.get(), i);
+   }
+   if (candidates.empty())
+      return false;
+
+   for (aco_ptr<Instruction>& instr : else_block.instructions) {
+      for (const Definition& def : instr->definitions) {
+         if (def.isTemp())
+            local_temps[def.tempId()] = true;
+      }
+   }
+
+   std::vector<aco_ptr<Instruction>> hoisted;
+   for (aco_ptr<Instruction>& instr : else_block.instructions) {
+      rename_operands(instr, renames);
+      if (!can_hoist(instr))
+         continue;
+
+      bool available = std::none_of(instr->operands.begin(), instr->operands.end(),
+                                    [&](const Operand& op)
+                                    { return op.isTemp() && local_temps[op.tempId()]; });
+      if (!available)
+         continue;
+
+      auto it = candidates.find(instr.get());
+      if (it == candidates.end())
+         continue;
+
+      aco_ptr<Instruction>& orig_instr = then_block.instructions[it->second];
+      for (unsigned i = 0; i < instr->definitions.size(); i++) {
+         renames[instr->definitions[i].tempId()] = orig_instr->definitions[i].getTemp();
+         merge_definition_flags(orig_instr->definitions[i], instr->definitions[i]);
+         local_temps[orig_instr->definitions[i].tempId()] = false;
+      }
+      candidates.erase(it);
+      hoisted.emplace_back(std::move(orig_instr));
+      instr.reset();
+   }
+
+   if (hoisted.empty())
+      return false;
+
+   auto is_null = [](const aco_ptr<Instruction>& instr) { return !instr; };
+   then_block.instructions.erase(std::remove_if(then_block.instructions.begin(),
+                                                then_block.instructions.end(), is_null),
+                                 then_block.instructions.end());
+   else_block.instructions.erase(std::remove_if(else_block.instructions.begin(),
+                                                else_block.instructions.end(), is_null),
+                                 else_block.instructions.end());
+   block.instructions.insert(std::prev(logical_end.base()), std::make_move_iterator(hoisted.begin()),
+                             std::make_move_iterator(hoisted.end()));
+   return true;
+}
+
+void
+hoist_common_code(Program* program)
+{
+   monotonic_buffer_resource m;
+   aco::unordered_map<uint32_t, Temp> renames(m);
+   bool progress = false;
+
+   for (Block& block : program->blocks)
+      progress |= hoist_common_instructions(program, block, renames);
+
+   if (!progress)
+      return;
+
+   for (Block& block : program->blocks) {
+      for (aco_ptr<Instruction>& instr : block.instructions)
+         rename_operands(instr, renames);
+   }
+}
 } /* end namespace */
 
 void
@@ -470,6 +648,9 @@ value_numbering(Program* program)
       if (block.kind & block_kind_loop_header)
          rename_phi_operands(block, ctx.renames);
    }
+
+   if (debug_flags & DEBUG_VN_HOIST)
+      hoist_common_code(program);
 }
 
 } // namespace aco
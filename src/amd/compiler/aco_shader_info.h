@@ -155,6 +155,11 @@ struct aco_compiler_options {
    bool has_ls_vgpr_init_bug;
    bool load_grid_size_from_user_sgpr;
    bool optimisations_disabled;
+   /* Skip the expensive scheduling and post-RA optimization passes. The
+    * resulting code is correct but slower, so this is meant for shaders
+    * which are expected to be replaced by a fully optimized variant later.
+    */
+   bool fast_compile;
    uint8_t enable_mrt_output_nan_fixup;
    bool wgp_mode;
    bool is_opengl;
@@ -183,6 +188,10 @@ enum aco_statistic {
    aco_statistic_vmem,
    aco_statistic_smem,
    aco_statistic_vopd,
+   aco_statistic_reloads,
+   aco_statistic_remats,
+   aco_statistic_arena_peak,
+   aco_statistic_compile_time,
    aco_num_statistics
 };
 
@@ -253,12 +253,16 @@ do_reload(spill_ctx& ctx, Temp tmp, Temp new_name, uint32_t spill_id)
          }
       }
       res->definitions[0] = Definition(new_name);
+      if (ctx.program->collect_statistics)
+         ctx.program->statistics[aco_statistic_remats]++;
       return res;
    } else {
       aco_ptr<Instruction> reload{create_instruction(aco_opcode::p_reload, Format::PSEUDO, 1, 1)};
       reload->operands[0] = Operand::c32(spill_id);
       reload->definitions[0] = Definition(new_name);
       ctx.is_reloaded[spill_id] = true;
+      if (ctx.program->collect_statistics)
+         ctx.program->statistics[aco_statistic_reloads]++;
       return reload;
    }
 }
@@ -225,6 +225,10 @@ private:
  * a buffer. Both, the release() method and the destructor release all managed
  * memory.
  *
+ * Released buffers are kept in a thread-local pool and reused by subsequently
+ * created memory resources on the same thread, up to max_pooled_bytes. The
+ * pool also tracks the peak amount of buffer memory in use on the thread.
+ *
  * The memory resource is not thread-safe.
  * This class mimics std::pmr::monotonic_buffer_resource
  */
@@ -236,16 +240,14 @@ public:
        * The usable data_size is size - sizeof(Buffer).
        */
       size = MAX2(size, minimum_size);
-      buffer = (Buffer*)malloc(size);
+      buffer = get_buffer(size);
       buffer->next = nullptr;
-      buffer->data_size = size - sizeof(Buffer);
-      buffer->current_idx = 0;
    }
 
    ~monotonic_buffer_resource()
    {
       release();
-      free(buffer);
+      put_buffer(buffer);
    }
 
    /* Move-constructor and -assignment */
@@ -279,10 +281,8 @@ public:
          total_size *= 2;
       } while (total_size - sizeof(Buffer) < size);
       Buffer* next = buffer;
-      buffer = (Buffer*)malloc(total_size);
+      buffer = get_buffer(total_size);
       buffer->next = next;
-      buffer->data_size = total_size - sizeof(Buffer);
-      buffer->current_idx = 0;
 
       return allocate(size, alignment);
    }
@@ -291,7 +291,7 @@ public:
    {
       while (buffer->next) {
          Buffer* next = buffer->next;
-         free(buffer);
+         put_buffer(buffer);
          buffer = next;
       }
       buffer->current_idx = 0;
@@ -299,6 +299,15 @@ public:
 
    bool operator==(const monotonic_buffer_resource& other) { return buffer == other.buffer; }
 
+   /* Peak number of bytes held by memory resources of the calling thread
+    * since the last call to reset_peak_usage().
+    */
+   static size_t peak_usage() { return get_pool().peak_bytes; }
+   static void reset_peak_usage() { get_pool().peak_bytes = get_pool().used_bytes; }
+
+   /* Upper bound of released buffer memory kept around for reuse per thread. */
+   static inline size_t max_pooled_bytes = 8 * 1024 * 1024;
+
 private:
    struct Buffer {
       Buffer* next;
@@ -307,6 +316,74 @@ private:
       uint8_t data[];
    };
 
+   struct Pool {
+      Buffer* free_list = nullptr;
+      size_t pooled_bytes = 0;
+      size_t used_bytes = 0;
+      size_t peak_bytes = 0;
+
+      ~Pool()
+      {
+         while (free_list) {
+            Buffer* next = free_list->next;
+            free(free_list);
+            free_list = next;
+         }
+      }
+   };
+
+   static Pool& get_pool()
+   {
+      static thread_local Pool pool;
+      return pool;
+   }
+
+   /* Returns a buffer with at least size bytes including the header,
+    * preferring the smallest pooled buffer which is large enough.
+    */
+   static Buffer* get_buffer(size_t size)
+   {
+      Pool& pool = get_pool();
+      Buffer** best = nullptr;
+      for (Buffer** it = &pool.free_list; *it; it = &(*it)->next) {
+         if ((*it)->data_size + sizeof(Buffer) >= size &&
+             (!best || (*it)->data_size < (*best)->data_size))
+            best = it;
+      }
+
+      Buffer* result;
+      if (best) {
+         result = *best;
+         *best = result->next;
+         pool.pooled_bytes -= result->data_size + sizeof(Buffer);
+      } else {
+         result = (Buffer*)malloc(size);
+         result->data_size = size - sizeof(Buffer);
+      }
+      result->next = nullptr;
+      result->current_idx = 0;
+
+      pool.used_bytes += result->data_size + sizeof(Buffer);
+      pool.peak_bytes = MAX2(pool.peak_bytes, pool.used_bytes);
+      return result;
+   }
+
+   static void put_buffer(Buffer* buf)
+   {
+      Pool& pool = get_pool();
+      size_t size = buf->data_size + sizeof(Buffer);
+      pool.used_bytes -= size;
+
+      if (pool.pooled_bytes + size > max_pooled_bytes) {
+         free(buf);
+         return;
+      }
+
+      buf->next = pool.free_list;
+      pool.free_list = buf;
+      pool.pooled_bytes += size;
+   }
+
    Buffer* buffer;
    static constexpr size_t initial_size = 4096;
    static constexpr size_t minimum_size = 128;
@@ -0,0 +1,508 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Compile-time benchmark for the ACO backend.
+ *
+ * Every SPIR-V module found in the given files and directories is compiled
+ * through RADV (and therefore through the full NIR and ACO pipelines) for each
+ * requested GPU generation. Compilation is repeated several times with all
+ * shader caches disabled, and the mean/p99 of the pipeline creation time and of
+ * the time spent in ACO itself are reported, together with the peak arena memory
+ * and a histogram of the instruction counts.
+ */
+
+#include "helpers.h"
+
+#include "util/os_time.h"
+
+#include "bench-spirv.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <dirent.h>
+#include <getopt.h>
+#include <stdarg.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <set>
+#include <vector>
+
+static const char* help_message =
+   "Usage: %s [-h] [-n ITERATIONS] [-g GFX[,GFX...]] PATH [PATH ...]\n"
+   "\n"
+   "Benchmark ACO compilation of SPIR-V modules. PATH can either be a SPIR-V\n"
+   "file or a directory which is searched recursively for '.spv' files.\n"
+   "\n"
+   "optional arguments:\n"
+   "  -h, --help        Show this help message and exit.\n"
+   "  -n, --iterations  Number of times each shader is compiled (default: 10).\n"
+   "  -g, --gfx         Comma-separated list of GPU generations to compile for,\n"
+   "                    e.g. gfx9,gfx10_3,gfx11 (default: gfx9,gfx10_3,gfx11).\n";
+
+/* These are used by helpers.cpp. */
+FILE* output = NULL;
+
+bool
+set_variant(const char* name)
+{
+   return true;
+}
+
+void
+fail_test(const char* fmt, ...)
+{
+   va_list args;
+   va_start(args, fmt);
+   vfprintf(stderr, fmt, args);
+   va_end(args);
+   fprintf(stderr, "\n");
+   exit(1);
+}
+
+void
+skip_test(const char* fmt, ...)
+{
+   va_list args;
+   va_start(args, fmt);
+   vfprintf(stderr, fmt, args);
+   va_end(args);
+   fprintf(stderr, "\n");
+}
+
+namespace {
+
+struct spirv_variable {
+   uint32_t type = 0; /* pointee type */
+   uint32_t storage_class = 0;
+};
+
+struct shader_interface {
+   VkShaderStageFlagBits stage = (VkShaderStageFlagBits)0;
+   std::string entrypoint;
+   std::vector<QoShaderDecl> io;
+   struct descriptor {
+      uint32_t set, binding, count;
+      VkDescriptorType type;
+   };
+   std::vector<descriptor> descriptors;
+};
+
+/* Extracts just enough of the module interface to create a pipeline layout,
+ * vertex input state and render pass which are compatible with the shader.
+ */
+bool
+reflect_spirv(const std::vector<uint32_t>& words, shader_interface* iface)
+{
+   if (words.size() < 5 || words[0] != 0x07230203)
+      return false;
+
+   std::map<uint32_t, std::vector<uint32_t>> types;
+   std::map<uint32_t, uint32_t> constants;
+   std::map<uint32_t, spirv_variable> variables;
+   std::map<uint32_t, uint32_t> sets, bindings, locations;
+   std::set<uint32_t> blocks, buffer_blocks, builtins;
+
+   for (size_t i = 5; i < words.size();) {
+      uint16_t opcode = words[i] & 0xffff;
+      uint16_t count = words[i] >> 16;
+      if (!count || i + count > words.size())
+         return false;
+      const uint32_t* op = &words[i];
+
+      switch (opcode) {
+      case 15: /* OpEntryPoint */
+         if (iface->stage)
+            break;
+         switch (op[1]) {
+         case 0: iface->stage = VK_SHADER_STAGE_VERTEX_BIT; break;
+         case 4: iface->stage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
+         case 5: iface->stage = VK_SHADER_STAGE_COMPUTE_BIT; break;
+         default: return false;
+         }
+         iface->entrypoint = (const char*)&op[3];
+         break;
+      case 71: /* OpDecorate */
+         switch (op[2]) {
+         case 2: blocks.insert(op[1]); break;
+         case 3: buffer_blocks.insert(op[1]); break;
+         case 11: builtins.insert(op[1]); break;
+         case 30: locations[op[1]] = op[3]; break;
+         case 33: bindings[op[1]] = op[3]; break;
+         case 34: sets[op[1]] = op[3]; break;
+         }
+         break;
+      case 21: /* OpTypeInt */
+      case 22: /* OpTypeFloat */
+      case 23: /* OpTypeVector */
+      case 25: /* OpTypeImage */
+      case 26: /* OpTypeSampler */
+      case 27: /* OpTypeSampledImage */
+      case 28: /* OpTypeArray */
+      case 29: /* OpTypeRuntimeArray */
+      case 30: /* OpTypeStruct */
+      case 32: /* OpTypePointer */
+      case 5341: /* OpTypeAccelerationStructureKHR */
+         types[op[1]] = std::vector<uint32_t>(op, op + count);
+         break;
+      case 43: /* OpConstant */
+         constants[op[2]] = op[3];
+         break;
+      case 59: /* OpVariable */
+         if (types.count(op[1]) && types[op[1]].size() >= 4)
+            variables[op[2]] = spirv_variable{types[op[1]][3], op[3]};
+         break;
+      }
+
+      i += count;
+   }
+
+   if (!iface->stage)
+      return false;
+
+   for (const auto& [id, var] : variables) {
+      uint32_t type = var.type;
+      uint32_t array_size = 1;
+      /* Look through (runtime) arrays. */
+      while (types.count(type)) {
+         const std::vector<uint32_t>& t = types[type];
+         if ((t[0] & 0xffff) == 28)
+            array_size *= constants.count(t[3]) ? constants[t[3]] : 1;
+         else if ((t[0] & 0xffff) != 29)
+            break;
+         type = t[2];
+      }
+      if (!types.count(type))
+         continue;
+      const std::vector<uint32_t>& t = types[type];
+      uint16_t type_op = t[0] & 0xffff;
+
+      if (var.storage_class == 1 /* Input */ || var.storage_class == 3 /* Output */) {
+         if (builtins.count(id) || !locations.count(id))
+            continue;
+
+         /* Only the scalar component type matters for vertex inputs and color outputs. */
+         uint32_t scalar = type;
+         if (type_op == 23)
+            scalar = t[2];
+         const char* type_name = "vec4";
+         if (types.count(scalar) && (types[scalar][0] & 0xffff) == 21)
+            type_name = types[scalar][3] ? "ivec4" : "uvec4";
+
+         for (uint32_t j = 0; j < array_size; j++) {
+            QoShaderDecl decl = {};
+            decl.type = type_name;
+            decl.decl_type = var.storage_class == 1 ? QoShaderDeclType_in : QoShaderDeclType_out;
+            decl.location = locations[id] + j;
+            iface->io.push_back(decl);
+         }
+         continue;
+      }
+
+      if (!bindings.count(id))
+         continue;
+
+      VkDescriptorType desc_type;
+      if (var.storage_class == 12 /* StorageBuffer */ ||
+          (var.storage_class == 2 /* Uniform */ && buffer_blocks.count(type))) {
+         desc_type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      } else if (var.storage_class == 2) {
+         desc_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+      } else if (type_op == 25) {
+         bool buffer = t[3] == 5;
+         if (t[3] == 6)
+            desc_type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+         else if (t[7] == 2)
+            desc_type = buffer ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                               : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+         else
+            desc_type = buffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                               : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+      } else if (type_op == 26) {
+         desc_type = VK_DESCRIPTOR_TYPE_SAMPLER;
+      } else if (type_op == 27) {
+         desc_type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      } else if (type_op == 5341) {
+         desc_type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+      } else {
+         continue;
+      }
+
+      uint32_t set = sets.count(id) ? sets[id] : 0;
+      iface->descriptors.push_back({set, bindings[id], array_size, desc_type});
+   }
+
+   return true;
+}
+
+bool
+read_spirv(const char* filename, std::vector<uint32_t>& words)
+{
+   FILE* f = fopen(filename, "rb");
+   if (!f)
+      return false;
+
+   fseek(f, 0, SEEK_END);
+   long size = ftell(f);
+   fseek(f, 0, SEEK_SET);
+
+   words.resize(size / 4);
+   bool ok = size > 0 && size % 4 == 0 && fread(words.data(), 4, words.size(), f) == words.size();
+   fclose(f);
+   return ok;
+}
+
+void
+collect_files(const std::string& path, std::vector<std::string>& files)
+{
+   struct stat st;
+   if (stat(path.c_str(), &st) != 0)
+      return;
+
+   if (!S_ISDIR(st.st_mode)) {
+      files.push_back(path);
+      return;
+   }
+
+   DIR* dir = opendir(path.c_str());
+   if (!dir)
+      return;
+
+   while (struct dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name == "." || name == "..")
+         continue;
+
+      std::string child = path + "/" + name;
+      if (stat(child.c_str(), &st) != 0)
+         continue;
+
+      if (S_ISDIR(st.st_mode))
+         collect_files(child, files);
+      else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".spv") == 0)
+         files.push_back(child);
+   }
+   closedir(dir);
+}
+
+struct gfx_results {
+   std::vector<double> pipeline_ms;
+   std::vector<double> aco_ms;
+   std::vector<uint64_t> arena_kib;
+   std::vector<uint64_t> instructions;
+   unsigned num_shaders = 0;
+   unsigned num_skipped = 0;
+};
+
+void
+compile_once(VkDevice device, const std::vector<uint32_t>& words, const shader_interface& iface,
+             gfx_results& results, bool record_stats)
+{
+   PipelineBuilder pbld(device);
+   pbld.create_flags = VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+
+   for (const shader_interface::descriptor& desc : iface.descriptors)
+      pbld.add_desc_binding(VK_SHADER_STAGE_ALL, desc.set, desc.binding, desc.type, desc.count);
+   pbld.push_constant_range = {VK_SHADER_STAGE_ALL, 0, 256};
+
+   QoShaderModuleCreateInfo module = {};
+   module.spirvSize = words.size() * 4;
+   module.pSpirv = words.data();
+   module.declarationCount = iface.io.size();
+   module.pDeclarations = iface.io.data();
+   module.stage = iface.stage;
+
+   if (iface.stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+      QoShaderModuleCreateInfo vs = qoShaderModuleCreateInfoGLSL(VERTEX,
+         void main() {
+            gl_Position = vec4(0.0);
+         }
+      );
+      pbld.add_stage(VK_SHADER_STAGE_VERTEX_BIT, vs);
+   }
+   pbld.add_stage(iface.stage, module, iface.entrypoint.c_str());
+
+   int64_t start = os_time_get_nano();
+   pbld.create_pipeline();
+   int64_t duration = os_time_get_nano() - start;
+
+   results.pipeline_ms.push_back(duration / 1000000.0);
+
+   uint64_t value;
+   if (get_pipeline_statistic(device, pbld.pipeline, iface.stage, "Compile Time", &value))
+      results.aco_ms.push_back(value / 1000.0);
+   if (get_pipeline_statistic(device, pbld.pipeline, iface.stage, "Arena Memory", &value))
+      results.arena_kib.push_back(value);
+   if (record_stats &&
+       get_pipeline_statistic(device, pbld.pipeline, iface.stage, "Instructions", &value))
+      results.instructions.push_back(value);
+}
+
+template <typename T>
+T
+percentile(std::vector<T> values, double p)
+{
+   if (values.empty())
+      return 0;
+   std::sort(values.begin(), values.end());
+   size_t idx = std::min<size_t>(values.size() - 1, ceil(p * values.size()) - 1);
+   return values[idx];
+}
+
+template <typename T>
+double
+mean(const std::vector<T>& values)
+{
+   if (values.empty())
+      return 0;
+   double sum = 0;
+   for (T v : values)
+      sum += v;
+   return sum / values.size();
+}
+
+void
+print_results(const char* gfx_name, unsigned iterations, const gfx_results& r)
+{
+   printf("%s: %u shaders (%u skipped), %u iterations\n", gfx_name, r.num_shaders, r.num_skipped,
+          iterations);
+   printf("   pipeline creation: mean %8.3f ms, p99 %8.3f ms\n", mean(r.pipeline_ms),
+          percentile(r.pipeline_ms, 0.99));
+   printf("   ACO backend:       mean %8.3f ms, p99 %8.3f ms\n", mean(r.aco_ms),
+          percentile(r.aco_ms, 0.99));
+   printf("   arena memory:      mean %8.0f KiB, max %6" PRIu64 " KiB\n", mean(r.arena_kib),
+          percentile(r.arena_kib, 1.0));
+
+   if (r.instructions.empty())
+      return;
+
+   uint64_t total = 0;
+   unsigned buckets[64] = {0};
+   unsigned max_bucket = 0;
+   for (uint64_t count : r.instructions) {
+      unsigned bucket = count ? util_logbase2_64(count) : 0;
+      buckets[bucket]++;
+      max_bucket = MAX2(max_bucket, bucket);
+      total += count;
+   }
+
+   printf("   instructions:      total %" PRIu64 ", mean %.1f, p99 %" PRIu64 "\n", total,
+          mean(r.instructions), percentile(r.instructions, 0.99));
+   for (unsigned i = 0; i <= max_bucket; i++) {
+      printf("      %7" PRIu64 " - %7" PRIu64 ": %6u ", (uint64_t)1 << i, ((uint64_t)2 << i) - 1,
+             buckets[i]);
+      unsigned width = DIV_ROUND_UP(buckets[i] * 50, r.instructions.size());
+      for (unsigned j = 0; j < width; j++)
+         putchar('#');
+      putchar('\n');
+   }
+}
+
+bool
+parse_gfx_level(const char* name, amd_gfx_level* gfx_level)
+{
+   static const struct {
+      const char* name;
+      amd_gfx_level gfx_level;
+   } levels[] = {
+      {"gfx6", GFX6},   {"gfx7", GFX7},       {"gfx8", GFX8},   {"gfx9", GFX9},
+      {"gfx10", GFX10}, {"gfx10_3", GFX10_3}, {"gfx11", GFX11}, {"gfx12", GFX12},
+   };
+   for (const auto& level : levels) {
+      if (!strcmp(level.name, name)) {
+         *gfx_level = level.gfx_level;
+         return true;
+      }
+   }
+   return false;
+}
+
+} /* end namespace */
+
+int
+main(int argc, char** argv)
+{
+   unsigned iterations = 10;
+   std::vector<std::pair<std::string, amd_gfx_level>> gfx_levels;
+
+   const char* shortopts = "hn:g:";
+   const struct option longopts[] = {{"help", no_argument, NULL, 'h'},
+                                     {"iterations", required_argument, NULL, 'n'},
+                                     {"gfx", required_argument, NULL, 'g'},
+                                     {NULL, 0, NULL, 0}};
+
+   int opt;
+   while ((opt = getopt_long(argc, argv, shortopts, longopts, NULL)) != -1) {
+      switch (opt) {
+      case 'h': printf(help_message, argv[0]); return 0;
+      case 'n': iterations = MAX2(atoi(optarg), 1); break;
+      case 'g': {
+         std::string list = optarg;
+         size_t pos = 0;
+         while (pos <= list.size()) {
+            size_t end = std::min(list.find(',', pos), list.size());
+            std::string name = list.substr(pos, end - pos);
+            amd_gfx_level gfx_level;
+            if (!parse_gfx_level(name.c_str(), &gfx_level)) {
+               fprintf(stderr, "%s: unknown GPU generation '%s'\n", argv[0], name.c_str());
+               return 1;
+            }
+            gfx_levels.emplace_back(name, gfx_level);
+            pos = end + 1;
+         }
+         break;
+      }
+      case '?':
+      default: fprintf(stderr, help_message, argv[0]); return 99;
+      }
+   }
+
+   if (gfx_levels.empty())
+      gfx_levels = {{"gfx9", GFX9}, {"gfx10_3", GFX10_3}, {"gfx11", GFX11}};
+
+   std::vector<std::string> files;
+   for (int i = optind; i < argc; i++)
+      collect_files(argv[i], files);
+   std::sort(files.begin(), files.end());
+
+   if (files.empty()) {
+      fprintf(stderr, help_message, argv[0]);
+      return 99;
+   }
+
+   /* Every iteration has to go through the whole compiler. */
+   setenv("RADV_DEBUG", "nocache", 1);
+   setenv("MESA_SHADER_CACHE_DISABLE", "true", 1);
+
+   output = stdout;
+
+   for (const auto& [gfx_name, gfx_level] : gfx_levels) {
+      VkDevice device = get_vk_device(gfx_level);
+      gfx_results results;
+
+      for (const std::string& file : files) {
+         std::vector<uint32_t> words;
+         shader_interface iface;
+         if (!read_spirv(file.c_str(), words) || !reflect_spirv(words, &iface)) {
+            fprintf(stderr, "%s: skipping unsupported module '%s'\n", argv[0], file.c_str());
+            results.num_skipped++;
+            continue;
+         }
+
+         for (unsigned i = 0; i < iterations; i++)
+            compile_once(device, words, iface, results, i == 0);
+         results.num_shaders++;
+      }
+
+      print_results(gfx_name.c_str(), iterations, results);
+   }
+
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) == 0)
+      printf("peak resident memory: %ld KiB\n", usage.ru_maxrss);
+
+   return 0;
+}
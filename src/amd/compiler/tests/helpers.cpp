@@ -14,6 +14,7 @@
 #include <mutex>
 #include <sstream>
 #include <stdio.h>
+#include <vector>
 
 using namespace aco;
 
@@ -55,6 +56,7 @@ static std::mutex create_device_mutex;
    ITEM(CreateRenderPass)                                                                          \
    ITEM(DestroyRenderPass)                                                                         \
    ITEM(GetPipelineExecutablePropertiesKHR)                                                        \
+   ITEM(GetPipelineExecutableStatisticsKHR)                                                        \
    ITEM(GetPipelineExecutableInternalRepresentationsKHR)
 
 #define ITEM(n) PFN_vk##n n;
@@ -706,9 +708,9 @@ static struct DestroyDevices {
    }
 } destroy_devices;
 
-void
-print_pipeline_ir(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
-                  const char* name, bool remove_encoding)
+static bool
+find_pipeline_executable(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
+                         uint32_t* executable)
 {
    uint32_t executable_count = 16;
    VkPipelineExecutablePropertiesKHR executables[16];
@@ -716,27 +718,75 @@ print_pipeline_ir(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits st
    pipeline_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR;
    pipeline_info.pNext = NULL;
    pipeline_info.pipeline = pipeline;
-   ASSERTED VkResult result =
+   VkResult result =
       GetPipelineExecutablePropertiesKHR(device, &pipeline_info, &executable_count, executables);
-   assert(result == VK_SUCCESS);
+   if (result != VK_SUCCESS)
+      return false;
 
-   uint32_t executable = 0;
-   for (; executable < executable_count; executable++) {
-      if (executables[executable].stages == stages)
-         break;
+   for (*executable = 0; *executable < executable_count; (*executable)++) {
+      if (executables[*executable].stages == stages)
+         return true;
    }
-   assert(executable != executable_count);
+   return false;
+}
 
+bool
+get_pipeline_statistic(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
+                       const char* name, uint64_t* value)
+{
    VkPipelineExecutableInfoKHR exec_info;
    exec_info.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR;
    exec_info.pNext = NULL;
    exec_info.pipeline = pipeline;
-   exec_info.executableIndex = executable;
+   if (!find_pipeline_executable(device, pipeline, stages, &exec_info.executableIndex))
+      return false;
+
+   uint32_t stat_count = 0;
+   if (GetPipelineExecutableStatisticsKHR(device, &exec_info, &stat_count, NULL) != VK_SUCCESS)
+      return false;
+
+   std::vector<VkPipelineExecutableStatisticKHR> stats(stat_count);
+   for (VkPipelineExecutableStatisticKHR& stat : stats) {
+      stat.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR;
+      stat.pNext = NULL;
+   }
+   if (GetPipelineExecutableStatisticsKHR(device, &exec_info, &stat_count, stats.data()) !=
+       VK_SUCCESS)
+      return false;
+
+   for (const VkPipelineExecutableStatisticKHR& stat : stats) {
+      if (strcmp(stat.name, name) != 0)
+         continue;
+
+      switch (stat.format) {
+      case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR: *value = stat.value.b32; break;
+      case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR: *value = stat.value.i64; break;
+      case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR: *value = stat.value.u64; break;
+      case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR: *value = stat.value.f64; break;
+      default: return false;
+      }
+      return true;
+   }
+   return false;
+}
+
+void
+print_pipeline_ir(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
+                  const char* name, bool remove_encoding)
+{
+   VkPipelineExecutableInfoKHR exec_info;
+   exec_info.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR;
+   exec_info.pNext = NULL;
+   exec_info.pipeline = pipeline;
+   ASSERTED bool found =
+      find_pipeline_executable(device, pipeline, stages, &exec_info.executableIndex);
+   assert(found);
 
    uint32_t ir_count = 16;
    VkPipelineExecutableInternalRepresentationKHR ir[16];
    memset(ir, 0, sizeof(ir));
-   result = GetPipelineExecutableInternalRepresentationsKHR(device, &exec_info, &ir_count, ir);
+   ASSERTED VkResult result =
+      GetPipelineExecutableInternalRepresentationsKHR(device, &exec_info, &ir_count, ir);
    assert(result == VK_SUCCESS);
 
    VkPipelineExecutableInternalRepresentationKHR* requested_ir = nullptr;
@@ -787,6 +837,7 @@ PipelineBuilder::PipelineBuilder(VkDevice dev)
 {
    memset(this, 0, sizeof(*this));
    topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+   create_flags = VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR;
    device = dev;
 }
 
@@ -974,7 +1025,7 @@ PipelineBuilder::create_compute_pipeline()
    VkComputePipelineCreateInfo create_info;
    create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
    create_info.pNext = NULL;
-   create_info.flags = VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR;
+   create_info.flags = create_flags;
    create_info.stage = stages[0];
    create_info.layout = pipeline_layout;
    create_info.basePipelineHandle = VK_NULL_HANDLE;
@@ -1139,7 +1190,7 @@ PipelineBuilder::create_graphics_pipeline()
 
    gfx_pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
    gfx_pipeline_info.pNext = NULL;
-   gfx_pipeline_info.flags = VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR;
+   gfx_pipeline_info.flags = create_flags;
    gfx_pipeline_info.pVertexInputState = &vs_input;
    gfx_pipeline_info.pInputAssemblyState = &assembly_state;
    gfx_pipeline_info.pTessellationState = &tess_state;
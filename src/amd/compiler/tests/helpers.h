@@ -110,6 +110,8 @@ VkDevice get_vk_device(enum radeon_family family);
 
 void print_pipeline_ir(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
                        const char* name, bool remove_encoding = false);
+bool get_pipeline_statistic(VkDevice device, VkPipeline pipeline, VkShaderStageFlagBits stages,
+                            const char* name, uint64_t* value);
 
 VkShaderModule __qoCreateShaderModule(VkDevice dev, const QoShaderModuleCreateInfo* info);
 
@@ -133,6 +135,7 @@ public:
    VkDescriptorSetLayoutBinding desc_bindings[64][64];
    VkPipelineShaderStageCreateInfo stages[5];
    VkShaderStageFlags owned_stages;
+   VkPipelineCreateFlags create_flags;
 
    /* outputs */
    VkGraphicsPipelineCreateInfo gfx_pipeline_info;
@@ -671,14 +671,29 @@ radv_handle_sqtt(VkQueue _queue)
    device->sqtt_triggered = false;
 
    if (device->sqtt_enabled) {
-      if (!radv_sqtt_stop_capturing(queue)) {
+      bool dump = true;
+
+      if (device->sqtt_spike_threshold_ns) {
+         const uint64_t frame_time_ns = os_time_get_nano() - device->sqtt_frame_start_ns;
+
+         dump = frame_time_ns >= device->sqtt_spike_threshold_ns;
+         if (dump)
+            fprintf(stderr, "radv: Frame took %.2f ms, writing its RGP capture.\n", frame_time_ns / 1000000.0);
+      }
+
+      if (!radv_sqtt_stop_capturing(queue, dump)) {
          /* Try to capture the next frame if the buffer was too small initially. */
          trigger = true;
       }
    }
 
+   /* Keep tracing every frame while waiting for a spike. */
+   if (device->sqtt_spike_threshold_ns)
+      trigger = true;
+
    if (trigger) {
       radv_sqtt_start_capturing(queue);
+      device->sqtt_frame_start_ns = os_time_get_nano();
    }
 }
 
@@ -879,7 +894,7 @@ sqtt_QueueSubmit2(VkQueue _queue, uint32_t submitCount, const VkSubmitInfo2 *pSu
    }
 
    if (instance->vk.trace_per_submit) {
-      if (!radv_sqtt_stop_capturing(queue)) {
+      if (!radv_sqtt_stop_capturing(queue, true)) {
          fprintf(stderr,
                  "radv: Failed to capture RGP for this submit because the buffer is too small and auto-resizing "
                  "is disabled. See RADV_THREAD_TRACE_BUFFER_SIZE for increasing the size.\n");
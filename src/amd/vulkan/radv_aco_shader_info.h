@@ -106,6 +106,7 @@ radv_aco_convert_opts(struct aco_compiler_options *aco_info, const struct radv_n
    aco_info->is_opengl = false;
    aco_info->load_grid_size_from_user_sgpr = radv_args->load_grid_size_from_user_sgpr;
    aco_info->optimisations_disabled = stage_key->optimisations_disabled;
+   aco_info->fast_compile = stage_key->fast_compile;
    aco_info->gfx_level = radv->info->gfx_level;
    aco_info->family = radv->info->family;
    aco_info->address32_hi = radv->info->address32_hi;
@@ -117,6 +117,8 @@
 #define RADV_SHADER_ALLOC_MAX_ARENA_SIZE_SHIFT 5u
 #define RADV_SHADER_ALLOC_MIN_SIZE_CLASS       8
 #define RADV_SHADER_ALLOC_MAX_SIZE_CLASS       15
+/* Number of fitting holes considered when picking one in the fullest arena. */
+#define RADV_SHADER_ALLOC_MAX_CANDIDATES       8
 #define RADV_SHADER_ALLOC_NUM_FREE_LISTS       (RADV_SHADER_ALLOC_MAX_SIZE_CLASS - RADV_SHADER_ALLOC_MIN_SIZE_CLASS + 1)
 
 #define PERF_CTR_MAX_PASSES      512
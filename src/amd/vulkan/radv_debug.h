@@ -93,6 +93,9 @@ enum {
    RADV_PERFTEST_NIR_CACHE = 1u << 14,
    RADV_PERFTEST_RT_WAVE_32 = 1u << 15,
    RADV_PERFTEST_VIDEO_ENCODE = 1u << 16,
+   RADV_PERFTEST_FAST_LIBS = 1u << 17,
+   RADV_PERFTEST_WARM_CACHE = 1u << 18,
+   RADV_PERFTEST_RT_PARALLEL = 1u << 19,
 };
 
 enum {
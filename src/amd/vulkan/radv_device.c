@@ -34,6 +34,8 @@
 #include "radv_entrypoints.h"
 #include "radv_formats.h"
 #include "radv_physical_device.h"
+#include "radv_pipeline_cache.h"
+#include "radv_pipeline_rt.h"
 #include "radv_printf.h"
 #include "radv_rmv.h"
 #include "radv_shader.h"
@@ -599,6 +601,14 @@ radv_device_init_rgp(struct radv_device *device)
            radv_spm_trace_enabled(instance) ? "enabled" : "disabled",
            radv_sqtt_queue_events_enabled() ? "enabled" : "disabled");
 
+   const int64_t spike_threshold_ms = debug_get_num_option("RADV_THREAD_TRACE_SPIKE_MS", 0);
+   if (spike_threshold_ms > 0) {
+      fprintf(stderr, "radv: Capturing every frame, frames taking at least %" PRId64 " ms are written out.\n",
+              spike_threshold_ms);
+      device->sqtt_spike_threshold_ns = spike_threshold_ms * 1000000ull;
+      device->sqtt_triggered = true;
+   }
+
    if (radv_spm_trace_enabled(instance)) {
       if (pdev->info.gfx_level >= GFX10 && pdev->info.gfx_level < GFX11_5) {
          if (!radv_spm_init(device))
@@ -1070,6 +1080,9 @@ radv_device_init_msaa(struct radv_device *device)
 static void
 radv_destroy_device(struct radv_device *device, const VkAllocationCallbacks *pAllocator)
 {
+   radv_pipeline_cache_warm_finish(device);
+   radv_rt_compile_queue_finish(device);
+
    radv_device_finish_perf_counter(device);
 
    if (device->gfx_init)
@@ -1363,6 +1376,12 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
          goto fail;
    }
 
+   if (instance->perftest_flags & RADV_PERFTEST_WARM_CACHE)
+      radv_pipeline_cache_warm_init(device);
+
+   if (instance->perftest_flags & RADV_PERFTEST_RT_PARALLEL)
+      radv_rt_compile_queue_init(device);
+
    device->force_aniso = MIN2(16, (int)debug_get_num_option("RADV_TEX_ANISO", -1));
    if (device->force_aniso >= 0) {
       fprintf(stderr, "radv: Forcing anisotropy filter to %ix\n", 1 << util_logbase2(device->force_aniso));
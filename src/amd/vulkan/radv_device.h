@@ -16,6 +16,8 @@
 #include "ac_sqtt.h"
 
 #include "util/mesa-blake3.h"
+#include "util/u_dynarray.h"
+#include "util/u_queue.h"
 
 #include "radv_pipeline.h"
 #include "radv_printf.h"
@@ -239,6 +241,12 @@ struct radv_device {
    bool sqtt_enabled;
    bool sqtt_triggered;
 
+   /* With RADV_THREAD_TRACE_SPIKE_MS, every frame is traced and only the ones
+    * taking at least this long between presents are written out.
+    */
+   uint64_t sqtt_spike_threshold_ns;
+   uint64_t sqtt_frame_start_ns;
+
    /* SQTT timestamps for queue events. */
    simple_mtx_t sqtt_timestamp_mtx;
    struct radv_sqtt_timestamp sqtt_timestamp;
@@ -324,6 +332,25 @@ struct radv_device {
    simple_mtx_t pso_cache_stats_mtx;
    struct radv_pso_cache_stats pso_cache_stats[RADV_PIPELINE_TYPE_COUNT];
 
+   /* Pipelines preloaded from the disk cache with RADV_PERFTEST=warmcache, see
+    * radv_pipeline_cache_warm_init().
+    */
+   struct {
+      struct vk_pipeline_cache *cache;
+      thrd_t thread;
+      simple_mtx_t mtx;
+      bool ready;
+      bool stop;
+
+      /* SHA1s of the graphics and compute pipelines used by this device, in
+       * order of first use, preloaded by the next run of the application.
+       */
+      struct util_dynarray used;
+   } warm_cache;
+
+   /* Threads compiling ray tracing stages, see radv_rt_compile_queue_init(). */
+   struct util_queue rt_compile_queue;
+
    struct radv_address_binding_tracker *addr_binding_tracker;
 };
 
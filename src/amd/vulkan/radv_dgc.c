@@ -2611,64 +2611,68 @@ build_dgc_prepare_shader(struct radv_device *dev, struct radv_indirect_command_l
    build_dgc_buffer_tail_main(&b, sequence_count, dev);
    build_dgc_buffer_preamble_main(&b, sequence_count, dev);
 
-   /* Prepare the ACE command stream */
-   nir_push_if(&b, nir_ieq_imm(&b, load_param8(&b, has_task_shader), 1));
-   {
-      nir_def *ace_cmd_buf_stride = load_param32(&b, ace_cmd_buf_stride);
-      nir_def *ace_cmd_buf_base_offset = load_param32(&b, ace_cmd_buf_main_offset);
-
-      build_dgc_buffer_trailer_ace(&b, dev);
-
-      nir_push_if(&b, nir_ult(&b, sequence_id, sequence_count));
+   /* Prepare the ACE command stream, only layouts with mesh draws can have a task shader so skip it
+    * entirely for everything else.
+    */
+   if (layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_DRAW_MESH)) {
+      nir_push_if(&b, nir_ieq_imm(&b, load_param8(&b, has_task_shader), 1));
       {
-         struct dgc_cmdbuf cmd_buf = {
-            .b = &b,
-            .dev = dev,
-            .va = nir_pack_64_2x32_split(&b, load_param32(&b, upload_addr), nir_imm_int(&b, pdev->info.address32_hi)),
-            .offset = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "cmd_buf_offset"),
-            .upload_offset = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "upload_offset"),
-            .layout = layout,
-         };
-         nir_store_var(&b, cmd_buf.offset,
-                       nir_iadd(&b, nir_imul(&b, global_id, ace_cmd_buf_stride), ace_cmd_buf_base_offset), 1);
-         nir_def *cmd_buf_end = nir_iadd(&b, nir_load_var(&b, cmd_buf.offset), ace_cmd_buf_stride);
-
-         nir_def *stream_addr = load_param64(&b, stream_addr);
-         stream_addr = nir_iadd(&b, stream_addr, nir_u2u64(&b, nir_imul_imm(&b, sequence_id, layout->vk.stride)));
-
-         nir_def *upload_offset_init = nir_iadd(&b, load_param32(&b, upload_main_offset),
-                                                nir_imul(&b, load_param32(&b, upload_stride), sequence_id));
-         nir_store_var(&b, cmd_buf.upload_offset, upload_offset_init, 0x1);
+         nir_def *ace_cmd_buf_stride = load_param32(&b, ace_cmd_buf_stride);
+         nir_def *ace_cmd_buf_base_offset = load_param32(&b, ace_cmd_buf_main_offset);
 
-         if (layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_IES))
-            cmd_buf.ies_va = dgc_load_ies_va(&cmd_buf, stream_addr);
+         build_dgc_buffer_trailer_ace(&b, dev);
 
-         if (layout->push_constant_mask) {
-            nir_def *push_constant_stages = dgc_get_push_constant_stages(&cmd_buf);
+         nir_push_if(&b, nir_ult(&b, sequence_id, sequence_count));
+         {
+            struct dgc_cmdbuf cmd_buf = {
+               .b = &b,
+               .dev = dev,
+               .va = nir_pack_64_2x32_split(&b, load_param32(&b, upload_addr), nir_imm_int(&b, pdev->info.address32_hi)),
+               .offset = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "cmd_buf_offset"),
+               .upload_offset = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "upload_offset"),
+               .layout = layout,
+            };
+            nir_store_var(&b, cmd_buf.offset,
+                          nir_iadd(&b, nir_imul(&b, global_id, ace_cmd_buf_stride), ace_cmd_buf_base_offset), 1);
+            nir_def *cmd_buf_end = nir_iadd(&b, nir_load_var(&b, cmd_buf.offset), ace_cmd_buf_stride);
+
+            nir_def *stream_addr = load_param64(&b, stream_addr);
+            stream_addr = nir_iadd(&b, stream_addr, nir_u2u64(&b, nir_imul_imm(&b, sequence_id, layout->vk.stride)));
+
+            nir_def *upload_offset_init = nir_iadd(&b, load_param32(&b, upload_main_offset),
+                                                   nir_imul(&b, load_param32(&b, upload_stride), sequence_id));
+            nir_store_var(&b, cmd_buf.upload_offset, upload_offset_init, 0x1);
+
+            if (layout->vk.dgc_info & BITFIELD_BIT(MESA_VK_DGC_IES))
+               cmd_buf.ies_va = dgc_load_ies_va(&cmd_buf, stream_addr);
+
+            if (layout->push_constant_mask) {
+               nir_def *push_constant_stages = dgc_get_push_constant_stages(&cmd_buf);
+
+               nir_push_if(&b, nir_test_mask(&b, push_constant_stages, VK_SHADER_STAGE_TASK_BIT_EXT));
+               {
+                  const struct dgc_pc_params params = dgc_get_pc_params(&cmd_buf);
+                  dgc_emit_push_constant_for_stage(&cmd_buf, stream_addr, sequence_id, &params, MESA_SHADER_TASK);
+               }
+               nir_pop_if(&b, NULL);
+            }
 
-            nir_push_if(&b, nir_test_mask(&b, push_constant_stages, VK_SHADER_STAGE_TASK_BIT_EXT));
-            {
-               const struct dgc_pc_params params = dgc_get_pc_params(&cmd_buf);
-               dgc_emit_push_constant_for_stage(&cmd_buf, stream_addr, sequence_id, &params, MESA_SHADER_TASK);
+            if (layout->vk.draw_count) {
+               dgc_emit_draw_mesh_tasks_with_count_ace(&cmd_buf, stream_addr, sequence_id);
+            } else {
+               dgc_emit_draw_mesh_tasks_ace(&cmd_buf, stream_addr);
             }
-            nir_pop_if(&b, NULL);
-         }
 
-         if (layout->vk.draw_count) {
-            dgc_emit_draw_mesh_tasks_with_count_ace(&cmd_buf, stream_addr, sequence_id);
-         } else {
-            dgc_emit_draw_mesh_tasks_ace(&cmd_buf, stream_addr);
+            /* Pad the cmdbuffer if we did not use the whole stride */
+            dgc_pad_cmdbuf(&cmd_buf, cmd_buf_end);
          }
+         nir_pop_if(&b, NULL);
 
-         /* Pad the cmdbuffer if we did not use the whole stride */
-         dgc_pad_cmdbuf(&cmd_buf, cmd_buf_end);
+         build_dgc_buffer_tail_ace(&b, sequence_count, dev);
+         build_dgc_buffer_preamble_ace(&b, sequence_count, dev);
       }
       nir_pop_if(&b, NULL);
-
-      build_dgc_buffer_tail_ace(&b, sequence_count, dev);
-      build_dgc_buffer_preamble_ace(&b, sequence_count, dev);
    }
-   nir_pop_if(&b, NULL);
 
    return b.shader;
 }
@@ -115,6 +115,9 @@ static const struct debug_control radv_perftest_options[] = {{"localbos", RADV_P
                                                              {"nircache", RADV_PERFTEST_NIR_CACHE},
                                                              {"rtwave32", RADV_PERFTEST_RT_WAVE_32},
                                                              {"video_encode", RADV_PERFTEST_VIDEO_ENCODE},
+                                                             {"fastlibs", RADV_PERFTEST_FAST_LIBS},
+                                                             {"warmcache", RADV_PERFTEST_WARM_CACHE},
+                                                             {"rtparallel", RADV_PERFTEST_RT_PARALLEL},
                                                              {NULL, 0}};
 
 static const struct debug_control radv_trap_excp_options[] = {
@@ -145,6 +145,13 @@ radv_pipeline_get_shader_key(const struct radv_device *device, const VkPipelineS
    if (flags & VK_PIPELINE_CREATE_2_DISABLE_OPTIMIZATION_BIT)
       key.optimisations_disabled = 1;
 
+   /* Libraries that retain link-time optimization info are expected to be linked again with
+    * LINK_TIME_OPTIMIZATION, usually in the background, so compile them as fast as possible.
+    */
+   if ((instance->perftest_flags & RADV_PERFTEST_FAST_LIBS) && (flags & VK_PIPELINE_CREATE_2_LIBRARY_BIT_KHR) &&
+       (flags & VK_PIPELINE_CREATE_2_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT))
+      key.fast_compile = 1;
+
    if (flags & VK_PIPELINE_CREATE_2_VIEW_INDEX_FROM_DEVICE_INDEX_BIT)
       key.view_index_from_device_index = 1;
 
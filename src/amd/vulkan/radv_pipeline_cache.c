@@ -11,6 +11,9 @@
 #include "util/mesa-sha1.h"
 #include "util/u_atomic.h"
 #include "util/u_debug.h"
+#include "util/u_dynarray.h"
+#include "util/u_process.h"
+#include "util/u_thread.h"
 #include "nir_serialize.h"
 #include "nir.h"
 #include "radv_debug.h"
@@ -328,6 +331,157 @@ radv_report_pso_cache_stats(struct radv_device *device, const struct radv_pipeli
    simple_mtx_unlock(&device->pso_cache_stats_mtx);
 }
 
+/* Don't let the usage index of an application grow without bounds. */
+#define RADV_WARM_CACHE_MAX_PIPELINES 4096
+
+static void
+radv_warm_cache_index_key(struct radv_device *device, cache_key key)
+{
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+   const struct radv_instance *instance = radv_physical_device_instance(pdev);
+   const char *app_name = instance->vk.app_info.app_name;
+   const char *engine_name = instance->vk.app_info.engine_name;
+   const char *process_name = util_get_process_name();
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+
+   /* One index per application and device configuration, anything that
+    * changes the compiled pipelines changes device->cache_hash.
+    */
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, "radv_warm_cache_index", strlen("radv_warm_cache_index"));
+   _mesa_sha1_update(&ctx, device->cache_hash, sizeof(device->cache_hash));
+   if (app_name)
+      _mesa_sha1_update(&ctx, app_name, strlen(app_name) + 1);
+   if (engine_name)
+      _mesa_sha1_update(&ctx, engine_name, strlen(engine_name) + 1);
+   if (process_name)
+      _mesa_sha1_update(&ctx, process_name, strlen(process_name) + 1);
+   _mesa_sha1_final(&ctx, sha1);
+
+   disk_cache_compute_key(pdev->vk.disk_cache, sha1, sizeof(sha1), key);
+}
+
+static int
+radv_warm_cache_thread(void *data)
+{
+   struct radv_device *device = data;
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+   struct vk_pipeline_cache *cache = device->warm_cache.cache;
+   cache_key index_key;
+   size_t index_size;
+
+   u_thread_setname("radv_warm_cache");
+
+   radv_warm_cache_index_key(device, index_key);
+   uint8_t *index = disk_cache_get(pdev->vk.disk_cache, index_key, &index_size);
+
+   /* Looking the pipelines up pulls them and their shaders out of the disk
+    * cache and uploads the shaders, the warm cache then keeps them around.
+    */
+   for (size_t offset = 0; index && offset + SHA1_DIGEST_LENGTH <= index_size; offset += SHA1_DIGEST_LENGTH) {
+      if (p_atomic_read(&device->warm_cache.stop))
+         break;
+
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_lookup_object(cache, index + offset, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, NULL);
+      if (object)
+         vk_pipeline_cache_object_unref(&device->vk, object);
+   }
+
+   free(index);
+
+   /* From now on, the warm cache is only consulted for what it holds. */
+   simple_mtx_lock(&device->warm_cache.mtx);
+   cache->skip_disk_cache = true;
+   device->warm_cache.ready = true;
+   simple_mtx_unlock(&device->warm_cache.mtx);
+
+   return 0;
+}
+
+/**
+ * Start preloading the pipelines the application used during its previous run, as recorded in a
+ * per-application index in the disk cache, so that creating them again is an in-memory hit instead
+ * of disk cache reads and shader uploads.  Failing to start is not an error.
+ */
+void
+radv_pipeline_cache_warm_init(struct radv_device *device)
+{
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+
+   if (!pdev->vk.disk_cache || radv_is_cache_disabled(device, NULL))
+      return;
+
+   struct vk_pipeline_cache_create_info info = {0};
+   device->warm_cache.cache = vk_pipeline_cache_create(&device->vk, &info, NULL);
+   if (!device->warm_cache.cache)
+      return;
+
+   simple_mtx_init(&device->warm_cache.mtx, mtx_plain);
+   util_dynarray_init(&device->warm_cache.used, NULL);
+
+   if (thrd_create(&device->warm_cache.thread, radv_warm_cache_thread, device) != thrd_success) {
+      simple_mtx_destroy(&device->warm_cache.mtx);
+      util_dynarray_fini(&device->warm_cache.used);
+      vk_pipeline_cache_destroy(device->warm_cache.cache, NULL);
+      device->warm_cache.cache = NULL;
+   }
+}
+
+void
+radv_pipeline_cache_warm_finish(struct radv_device *device)
+{
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+
+   if (!device->warm_cache.cache)
+      return;
+
+   p_atomic_set(&device->warm_cache.stop, true);
+   thrd_join(device->warm_cache.thread, NULL);
+
+   if (device->warm_cache.used.size) {
+      cache_key index_key;
+
+      radv_warm_cache_index_key(device, index_key);
+      disk_cache_put(pdev->vk.disk_cache, index_key, device->warm_cache.used.data, device->warm_cache.used.size,
+                     NULL);
+   }
+
+   util_dynarray_fini(&device->warm_cache.used);
+   simple_mtx_destroy(&device->warm_cache.mtx);
+   vk_pipeline_cache_destroy(device->warm_cache.cache, NULL);
+   device->warm_cache.cache = NULL;
+}
+
+/* Adds the pipeline to the usage index and returns whether the warm cache can be looked up. */
+static bool
+radv_warm_cache_record(struct radv_device *device, const unsigned char *sha1)
+{
+   bool ready;
+
+   simple_mtx_lock(&device->warm_cache.mtx);
+   if (util_dynarray_num_elements(&device->warm_cache.used, uint8_t) <
+       RADV_WARM_CACHE_MAX_PIPELINES * SHA1_DIGEST_LENGTH)
+      util_dynarray_append_array(&device->warm_cache.used, uint8_t, sha1, SHA1_DIGEST_LENGTH);
+   ready = device->warm_cache.ready;
+   simple_mtx_unlock(&device->warm_cache.mtx);
+
+   return ready;
+}
+
+static struct vk_pipeline_cache_object *
+radv_warm_cache_lookup(struct radv_device *device, struct vk_pipeline_cache *cache, const unsigned char *sha1)
+{
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_lookup_object(device->warm_cache.cache, sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, NULL);
+   if (!object)
+      return NULL;
+
+   /* Keep the application visible cache contents the same as without warming. */
+   return vk_pipeline_cache_add_object(cache, object);
+}
+
 static struct radv_pipeline_cache_object *
 radv_pipeline_cache_object_search(struct radv_device *device, struct vk_pipeline_cache *cache,
                                   const struct radv_pipeline *pipeline, bool *found_in_application_cache)
@@ -346,6 +500,9 @@ radv_pipeline_cache_object_search(struct radv_device *device, struct vk_pipeline
    struct vk_pipeline_cache_object *object =
       vk_pipeline_cache_lookup_object(cache, pipeline->sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, found);
 
+   if (device->warm_cache.cache && radv_warm_cache_record(device, pipeline->sha1) && !object)
+      object = radv_warm_cache_lookup(device, cache, pipeline->sha1);
+
    radv_report_pso_cache_stats(device, pipeline, !!object);
 
    if (!object)
@@ -46,6 +46,10 @@ bool radv_compute_pipeline_cache_search(struct radv_device *device, struct vk_pi
 void radv_pipeline_cache_insert(struct radv_device *device, struct vk_pipeline_cache *cache,
                                 struct radv_pipeline *pipeline);
 
+void radv_pipeline_cache_warm_init(struct radv_device *device);
+
+void radv_pipeline_cache_warm_finish(struct radv_device *device);
+
 bool radv_ray_tracing_pipeline_cache_search(struct radv_device *device, struct vk_pipeline_cache *cache,
                                             struct radv_ray_tracing_pipeline *pipeline,
                                             bool *found_in_application_cache);
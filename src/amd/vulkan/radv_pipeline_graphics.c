@@ -2432,6 +2432,9 @@ radv_pipeline_import_retained_shaders(const struct radv_device *device, struct r
 
       radv_pipeline_stage_init(lib->base.base.create_flags, sinfo,
                                &lib->layout, &lib->stage_keys[s], &stages[s]);
+
+      /* The imported stages are compiled again for the optimized pipeline. */
+      stages[s].key.fast_compile = 0;
    }
 
    /* Import the NIR shaders (after SPIRV->NIR). */
@@ -2452,6 +2455,7 @@ radv_pipeline_import_retained_shaders(const struct radv_device *device, struct r
       stages[s].entrypoint = nir_shader_get_entrypoint(stages[s].nir)->function->name;
       memcpy(stages[s].shader_sha1, retained_shaders->stages[s].shader_sha1, sizeof(stages[s].shader_sha1));
       memcpy(&stages[s].key, &retained_shaders->stages[s].key, sizeof(stages[s].key));
+      stages[s].key.fast_compile = 0;
 
       radv_shader_layout_init(&lib->layout, s, &stages[s].layout);
 
@@ -7,6 +7,7 @@
 #include "nir/nir.h"
 #include "nir/nir_builder.h"
 #include "nir/nir_serialize.h"
+#include "util/u_cpu_detect.h"
 
 #include "vk_shader_module.h"
 
@@ -581,6 +582,61 @@ radv_ray_tracing_stage_is_always_inlined(struct radv_ray_tracing_stage *stage)
    return stage->stage == MESA_SHADER_ANY_HIT || stage->stage == MESA_SHADER_INTERSECTION;
 }
 
+/**
+ * Start the threads that compile the separately compiled stages of ray tracing pipelines.  Failing
+ * to start them is not an error, stages are then compiled on the calling thread.
+ */
+void
+radv_rt_compile_queue_init(struct radv_device *device)
+{
+   const int nr_cpus = util_get_cpu_caps()->nr_cpus;
+
+   if (nr_cpus < 2)
+      return;
+
+   util_queue_init(&device->rt_compile_queue, "radv_rt", 64, MIN2(nr_cpus - 1, 8),
+                   UTIL_QUEUE_INIT_RESIZE_IF_FULL | UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL);
+}
+
+void
+radv_rt_compile_queue_finish(struct radv_device *device)
+{
+   if (util_queue_is_initialized(&device->rt_compile_queue))
+      util_queue_destroy(&device->rt_compile_queue);
+}
+
+struct radv_rt_compile_job {
+   struct radv_device *device;
+   struct vk_pipeline_cache *cache;
+   const VkRayTracingPipelineCreateInfoKHR *pCreateInfo;
+   struct radv_ray_tracing_pipeline *pipeline;
+   struct radv_shader_stage *stage;
+   struct radv_ray_tracing_stage *rt_stage;
+   bool skip_shaders_cache;
+
+   struct util_queue_fence fence;
+   bool submitted;
+   VkResult result;
+};
+
+static void
+radv_rt_compile_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct radv_rt_compile_job *job = data;
+   int64_t stage_start = os_time_get_nano();
+   uint32_t stack_size = 0;
+
+   job->result = radv_rt_nir_to_asm(job->device, job->cache, job->pCreateInfo, job->pipeline, false, job->stage,
+                                    &stack_size, &job->rt_stage->info, NULL, NULL, job->skip_shaders_cache,
+                                    &job->rt_stage->shader);
+   if (job->result == VK_SUCCESS) {
+      assert(job->rt_stage->stack_size <= stack_size);
+      job->rt_stage->stack_size = stack_size;
+   }
+
+   job->stage->feedback.duration += os_time_get_nano() - stage_start;
+}
+
 static VkResult
 radv_rt_compile_shaders(struct radv_device *device, struct vk_pipeline_cache *cache,
                         const VkRayTracingPipelineCreateInfoKHR *pCreateInfo,
@@ -668,10 +724,54 @@ radv_rt_compile_shaders(struct radv_device *device, struct vk_pipeline_cache *ca
       stage->feedback.duration += os_time_get_nano() - stage_start;
    }
 
+   /* Unless other stages are inlined into them, the stages are compiled independently of each other, so
+    * they can be spread over the compile threads.  Their results are still consumed in stage order below.
+    * Capture/replay needs shader memory at given addresses and is left on the calling thread.
+    */
+   struct radv_rt_compile_job *jobs = NULL;
+   if (util_queue_is_initialized(&device->rt_compile_queue) && !monolithic &&
+       !(pipeline->base.base.create_flags & VK_PIPELINE_CREATE_2_RAY_TRACING_SHADER_GROUP_HANDLE_CAPTURE_REPLAY_BIT_KHR))
+      jobs = calloc(pCreateInfo->stageCount, sizeof(*jobs));
+
+   if (jobs) {
+      for (uint32_t idx = 0; idx < pCreateInfo->stageCount; idx++) {
+         util_queue_fence_init(&jobs[idx].fence);
+
+         if (radv_ray_tracing_stage_is_always_inlined(&rt_stages[idx]) || rt_stages[idx].shader)
+            continue;
+
+         struct radv_rt_compile_job *job = &jobs[idx];
+         job->device = device;
+         job->cache = cache;
+         job->pCreateInfo = pCreateInfo;
+         job->pipeline = pipeline;
+         job->stage = &stages[idx];
+         job->rt_stage = &rt_stages[idx];
+         job->skip_shaders_cache = skip_shaders_cache;
+         job->submitted = true;
+
+         util_queue_add_job(&device->rt_compile_queue, job, &job->fence, radv_rt_compile_job_execute, NULL, 0);
+      }
+   }
+
    for (uint32_t idx = 0; idx < pCreateInfo->stageCount; idx++) {
       int64_t stage_start = os_time_get_nano();
       struct radv_shader_stage *stage = &stages[idx];
 
+      if (jobs && jobs[idx].submitted) {
+         util_queue_fence_wait(&jobs[idx].fence);
+
+         result = jobs[idx].result;
+         if (result != VK_SUCCESS)
+            goto cleanup;
+
+         if (creation_feedback && creation_feedback->pipelineStageCreationFeedbackCount) {
+            assert(idx < creation_feedback->pipelineStageCreationFeedbackCount);
+            creation_feedback->pPipelineStageCreationFeedbacks[idx] = stage->feedback;
+         }
+         continue;
+      }
+
       /* Cases in which we need to compile the shader (raygen/callable/chit/miss):
        *    TODO: - monolithic: Extend the loop to cover imported stages and force compilation of imported raygen
        *                        shaders since pipeline library shaders use separate compilation.
@@ -753,6 +853,14 @@ radv_rt_compile_shaders(struct radv_device *device, struct vk_pipeline_cache *ca
    ralloc_free(traversal_nir);
 
 cleanup:
+   if (jobs) {
+      for (uint32_t i = 0; i < pCreateInfo->stageCount; i++) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+      free(jobs);
+   }
+
    for (uint32_t i = 0; i < pCreateInfo->stageCount; i++)
       ralloc_free(stages[i].nir);
    free(stages);
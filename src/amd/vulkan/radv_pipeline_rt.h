@@ -122,6 +122,10 @@ VkResult radv_generate_ray_tracing_state_key(struct radv_device *device,
 
 void radv_ray_tracing_state_key_finish(struct radv_ray_tracing_state_key *rt_state);
 
+void radv_rt_compile_queue_init(struct radv_device *device);
+
+void radv_rt_compile_queue_finish(struct radv_device *device);
+
 struct radv_ray_tracing_binary_header {
    uint32_t is_traversal_shader : 1;
    uint32_t has_shader : 1;
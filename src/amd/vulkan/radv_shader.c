@@ -1012,6 +1012,7 @@ insert_block(struct radv_device *device, union radv_shader_arena_block *hole, ui
 
    if (free_list)
       remove_hole(free_list, hole);
+   hole->arena->used += size;
    return hole;
 }
 
@@ -1047,12 +1048,27 @@ radv_alloc_shader_memory(struct radv_device *device, uint32_t size, bool replaya
    if (size_class) {
       size_class--;
 
-      list_for_each_entry (union radv_shader_arena_block, hole, &free_list->free_lists[size_class], freelist) {
-         if (hole->size < size)
+      /* Prefer holes in the fullest arena, so that allocations drain out of mostly empty arenas
+       * and those can be released once their last shader is freed.
+       */
+      union radv_shader_arena_block *hole = NULL;
+      unsigned candidates = 0;
+      list_for_each_entry (union radv_shader_arena_block, candidate, &free_list->free_lists[size_class], freelist) {
+         if (candidate->size < size)
             continue;
 
+         if (!hole || candidate->arena->used > hole->arena->used)
+            hole = candidate;
+
+         if (++candidates == RADV_SHADER_ALLOC_MAX_CANDIDATES)
+            break;
+      }
+
+      if (hole) {
          assert(hole->offset % RADV_SHADER_ALLOC_ALIGNMENT == 0);
 
+         hole->arena->used += size;
+
          if (size == hole->size) {
             remove_hole(free_list, hole);
             hole->freelist.next = ptr;
@@ -1061,6 +1077,7 @@ radv_alloc_shader_memory(struct radv_device *device, uint32_t size, bool replaya
          } else {
             union radv_shader_arena_block *alloc = alloc_block_obj(device);
             if (!alloc) {
+               hole->arena->used -= size;
                mtx_unlock(&device->shader_arena_mutex);
                return NULL;
             }
@@ -1131,6 +1148,8 @@ radv_free_shader_memory(struct radv_device *device, union radv_shader_arena_bloc
 
    struct radv_shader_free_list *free_list;
 
+   alloc->arena->used -= alloc->size;
+
    switch (alloc->arena->type) {
    case RADV_SHADER_ARENA_DEFAULT:
       free_list = &device->shader_free_list;
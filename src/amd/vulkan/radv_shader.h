@@ -90,7 +90,12 @@ struct radv_shader_stage_key {
    /* Whether the shader is used with indirect pipeline binds. */
    uint8_t indirect_bindable : 1;
 
-   uint32_t reserved : 18;
+   /* Whether the shader is compiled with the fast ACO tier because an optimized variant is expected
+    * to be linked later (graphics pipeline libraries with RETAIN_LINK_TIME_OPTIMIZATION_INFO).
+    */
+   uint8_t fast_compile : 1;
+
+   uint32_t reserved : 17;
 };
 
 struct radv_ps_epilog_key {
@@ -398,6 +403,8 @@ struct radv_shader_arena {
    struct list_head list;
    struct list_head entries;
    uint32_t size;
+   /* Bytes of the arena used by allocations. */
+   uint32_t used;
    struct radeon_winsys_bo *bo;
    char *ptr;
    enum radv_shader_arena_type type;
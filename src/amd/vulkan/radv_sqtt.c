@@ -661,8 +661,11 @@ radv_sqtt_start_capturing(struct radv_queue *queue)
    device->sqtt_enabled = true;
 }
 
+/* Returns false if the trace didn't fit and the buffer was resized.  The
+ * trace is only written to an RGP file when dump is set.
+ */
 bool
-radv_sqtt_stop_capturing(struct radv_queue *queue)
+radv_sqtt_stop_capturing(struct radv_queue *queue, bool dump)
 {
    struct radv_device *device = radv_queue_device(queue);
    const struct radv_physical_device *pdev = radv_device_physical(device);
@@ -677,7 +680,8 @@ radv_sqtt_stop_capturing(struct radv_queue *queue)
    device->vk.dispatch_table.QueueWaitIdle(radv_queue_to_handle(queue));
 
    if (radv_get_sqtt_trace(queue, &sqtt_trace) && (!device->spm.bo || radv_get_spm_trace(queue, &spm_trace))) {
-      ac_dump_rgp_capture(&pdev->info, &sqtt_trace, device->spm.bo ? &spm_trace : NULL);
+      if (dump)
+         ac_dump_rgp_capture(&pdev->info, &sqtt_trace, device->spm.bo ? &spm_trace : NULL);
    } else {
       /* Failed to capture because the buffer was too small. */
       captured = false;
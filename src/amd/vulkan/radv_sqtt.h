@@ -77,7 +77,7 @@ void radv_sqtt_finish(struct radv_device *device);
 
 void radv_sqtt_start_capturing(struct radv_queue *queue);
 
-bool radv_sqtt_stop_capturing(struct radv_queue *queue);
+bool radv_sqtt_stop_capturing(struct radv_queue *queue, bool dump);
 
 bool radv_get_sqtt_trace(struct radv_queue *queue, struct ac_sqtt_trace *sqtt_trace);
 
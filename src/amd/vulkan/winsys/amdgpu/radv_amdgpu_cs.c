@@ -193,10 +193,10 @@ radv_amdgpu_cs_destroy(struct radeon_cmdbuf *rcs)
    _mesa_hash_table_destroy(cs->annotations, radv_amdgpu_cs_free_annotation);
 
    if (cs->ib_buffer)
-      cs->ws->base.buffer_destroy(&cs->ws->base, cs->ib_buffer);
+      radv_amdgpu_cs_release_ib(cs, cs->ib_buffer);
 
    for (unsigned i = 0; i < cs->num_ib_buffers; ++i)
-      cs->ws->base.buffer_destroy(&cs->ws->base, cs->ib_buffers[i].bo);
+      radv_amdgpu_cs_release_ib(cs, cs->ib_buffers[i].bo);
 
    free(cs->ib_buffers);
    free(cs->virtual_buffers);
@@ -233,18 +233,101 @@ radv_amdgpu_cs_domain(const struct radeon_winsys *_ws)
    return use_sam ? RADEON_DOMAIN_VRAM : RADEON_DOMAIN_GTT;
 }
 
-static VkResult
-radv_amdgpu_cs_bo_create(struct radv_amdgpu_cs *cs, uint32_t ib_size)
-{
-   struct radeon_winsys *ws = &cs->ws->base;
+/* Upper bound of the memory kept in the IB cache of a winsys. */
+#define RADV_AMDGPU_IB_CACHE_MAX_SIZE (64 * 1024 * 1024)
 
+static void
+radv_amdgpu_cs_get_ib_params(struct radv_amdgpu_cs *cs, enum radeon_bo_domain *domain, enum radeon_bo_flag *flags)
+{
    /* Avoid memcpy from VRAM when a secondary cmdbuf can't always rely on IB2. */
    const bool can_always_use_ib2 = cs->ws->info.gfx_level >= GFX8 && cs->hw_ip == AMD_IP_GFX;
    const bool avoid_vram = cs->is_secondary && !can_always_use_ib2;
-   const enum radeon_bo_domain domain = avoid_vram ? RADEON_DOMAIN_GTT : radv_amdgpu_cs_domain(ws);
    const enum radeon_bo_flag gtt_wc_flag = avoid_vram ? 0 : RADEON_FLAG_GTT_WC;
-   const enum radeon_bo_flag flags =
-      RADEON_FLAG_CPU_ACCESS | RADEON_FLAG_NO_INTERPROCESS_SHARING | RADEON_FLAG_READ_ONLY | gtt_wc_flag;
+
+   *domain = avoid_vram ? RADEON_DOMAIN_GTT : radv_amdgpu_cs_domain(&cs->ws->base);
+   *flags = RADEON_FLAG_CPU_ACCESS | RADEON_FLAG_NO_INTERPROCESS_SHARING | RADEON_FLAG_READ_ONLY | gtt_wc_flag;
+}
+
+/* IB buffers only ever come in the sizes radv_amdgpu_cs_grow() doubles to, so an exact size match
+ * is enough.  Buffers the GPU may still be reading, which the Vulkan lifetime rules only allow for
+ * driver-internal command streams, are skipped.
+ */
+static struct radeon_winsys_bo *
+radv_amdgpu_ib_cache_get(struct radv_amdgpu_winsys *ws, uint64_t size, enum radeon_bo_domain domain,
+                         enum radeon_bo_flag flags)
+{
+   struct radeon_winsys_bo *bo = NULL;
+
+   simple_mtx_lock(&ws->ib_cache.mtx);
+   for (unsigned i = 0; i < ws->ib_cache.count; i++) {
+      struct radv_amdgpu_cached_ib *entry = &ws->ib_cache.entries[i];
+      bool busy = true;
+
+      if (entry->bo->size != size || entry->domain != domain || entry->flags != flags)
+         continue;
+
+      if (ac_drm_bo_wait_for_idle(ws->dev, radv_amdgpu_winsys_bo(entry->bo)->bo, 0, &busy) || busy)
+         continue;
+
+      bo = entry->bo;
+      ws->ib_cache.size -= bo->size;
+      *entry = ws->ib_cache.entries[--ws->ib_cache.count];
+      break;
+   }
+   simple_mtx_unlock(&ws->ib_cache.mtx);
+
+   return bo;
+}
+
+static void
+radv_amdgpu_cs_release_ib(struct radv_amdgpu_cs *cs, struct radeon_winsys_bo *bo)
+{
+   struct radv_amdgpu_winsys *ws = cs->ws;
+   enum radeon_bo_domain domain;
+   enum radeon_bo_flag flags;
+
+   radv_amdgpu_cs_get_ib_params(cs, &domain, &flags);
+
+   simple_mtx_lock(&ws->ib_cache.mtx);
+   if (ws->ib_cache.count < ARRAY_SIZE(ws->ib_cache.entries) &&
+       ws->ib_cache.size + bo->size <= RADV_AMDGPU_IB_CACHE_MAX_SIZE) {
+      ws->ib_cache.entries[ws->ib_cache.count++] = (struct radv_amdgpu_cached_ib){
+         .bo = bo,
+         .domain = domain,
+         .flags = flags,
+      };
+      ws->ib_cache.size += bo->size;
+      bo = NULL;
+   }
+   simple_mtx_unlock(&ws->ib_cache.mtx);
+
+   if (bo)
+      ws->base.buffer_destroy(&ws->base, bo);
+}
+
+void
+radv_amdgpu_cs_finish_ib_cache(struct radv_amdgpu_winsys *ws)
+{
+   for (unsigned i = 0; i < ws->ib_cache.count; i++)
+      ws->base.buffer_destroy(&ws->base, ws->ib_cache.entries[i].bo);
+
+   ws->ib_cache.count = 0;
+   ws->ib_cache.size = 0;
+   simple_mtx_destroy(&ws->ib_cache.mtx);
+}
+
+static VkResult
+radv_amdgpu_cs_bo_create(struct radv_amdgpu_cs *cs, uint32_t ib_size)
+{
+   struct radeon_winsys *ws = &cs->ws->base;
+   enum radeon_bo_domain domain;
+   enum radeon_bo_flag flags;
+
+   radv_amdgpu_cs_get_ib_params(cs, &domain, &flags);
+
+   cs->ib_buffer = radv_amdgpu_ib_cache_get(cs->ws, ib_size, domain, flags);
+   if (cs->ib_buffer)
+      return VK_SUCCESS;
 
    return ws->buffer_create(ws, ib_size, cs->ws->info.ip[cs->hw_ip].ib_alignment, domain, flags, RADV_BO_PRIORITY_CS, 0,
                             &cs->ib_buffer);
@@ -526,7 +609,7 @@ radv_amdgpu_cs_reset(struct radeon_cmdbuf *_cs)
    cs->ws->base.cs_add_buffer(&cs->base, cs->ib_buffer);
 
    for (unsigned i = 0; i < cs->num_ib_buffers; ++i)
-      cs->ws->base.buffer_destroy(&cs->ws->base, cs->ib_buffers[i].bo);
+      radv_amdgpu_cs_release_ib(cs, cs->ib_buffers[i].bo);
 
    cs->num_ib_buffers = 0;
    cs->ib.ib_mc_address = radv_amdgpu_winsys_bo(cs->ib_buffer)->base.va;
@@ -1937,6 +2020,8 @@ error_out:
 void
 radv_amdgpu_cs_init_functions(struct radv_amdgpu_winsys *ws)
 {
+   simple_mtx_init(&ws->ib_cache.mtx, mtx_plain);
+
    ws->base.ctx_create = radv_amdgpu_ctx_create;
    ws->base.ctx_destroy = radv_amdgpu_ctx_destroy;
    ws->base.ctx_wait_idle = radv_amdgpu_ctx_wait_idle;
@@ -45,4 +45,6 @@ radv_amdgpu_ctx(struct radeon_winsys_ctx *base)
 
 void radv_amdgpu_cs_init_functions(struct radv_amdgpu_winsys *ws);
 
+void radv_amdgpu_cs_finish_ib_cache(struct radv_amdgpu_winsys *ws);
+
 #endif /* RADV_AMDGPU_CS_H */
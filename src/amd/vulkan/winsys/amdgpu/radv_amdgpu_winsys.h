@@ -15,6 +15,7 @@
 #include <pthread.h>
 #include "util/list.h"
 #include "util/rwlock.h"
+#include "util/simple_mtx.h"
 #include "ac_gpu_info.h"
 #include "ac_linux_drm.h"
 #include "radv_radeon_winsys.h"
@@ -52,6 +53,20 @@ struct radv_amdgpu_winsys {
    struct u_rwlock log_bo_list_lock;
    struct list_head log_bo_list;
 
+   /* IB buffers given up by reset and destroyed command streams, reused by
+    * radv_amdgpu_cs_bo_create() instead of allocating and mapping new ones.
+    */
+   struct {
+      simple_mtx_t mtx;
+      struct radv_amdgpu_cached_ib {
+         struct radeon_winsys_bo *bo;
+         enum radeon_bo_domain domain;
+         enum radeon_bo_flag flags;
+      } entries[32];
+      unsigned count;
+      uint64_t size;
+   } ib_cache;
+
    const struct vk_sync_type *sync_types[3];
    struct vk_sync_type syncobj_sync_type;
    struct vk_sync_timeline_type emulated_timeline_sync_type;
@@ -116,7 +116,7 @@ agx_bo_cache_put_locked(struct agx_device *dev, struct agx_bo *bo)
    /* Update statistics */
    dev->bo_cache.size += bo->size;
 
-   if (0) {
+   if (dev->debug & AGX_DBG_BOCACHE) {
       printf("BO cache: %zu KiB (+%zu KiB from %s, hit/miss %" PRIu64
              "/%" PRIu64 ")\n",
              DIV_ROUND_UP(dev->bo_cache.size, 1024),
@@ -73,6 +73,7 @@ static const struct debug_named_value agx_debug_options[] = {
    {"1queue",    AGX_DBG_1QUEUE,   "Force usage of a single queue for multiple contexts"},
    {"nosoft",    AGX_DBG_NOSOFT,   "Disable soft fault optimizations"},
    {"bodumpverbose", AGX_DBG_BODUMPVERBOSE,   "Include extra info with dumps"},
+   {"bocache",   AGX_DBG_BOCACHE,  "Log BO cache usage"},
    DEBUG_NAMED_VALUE_END
 };
 /* clang-format on */
@@ -78,6 +78,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include "util/simple_mtx.h"
+#include "util/set.h"
 #include "main/consts_exts.h"
 #include "main/shader_types.h"
 #include "main/shaderobj.h"
@@ -1142,6 +1143,12 @@ public:
    ir_function_signature *find(_mesa_glsl_parse_state *state,
                                const char *name, exec_list *actual_parameters);
 
+   /**
+    * Generate the IR for the built-in function \p name, unless that was
+    * already done.
+    */
+   void materialize(const char *name);
+
    /**
     * A symbol table to hold all the built-in signatures; created by this
     * module.
@@ -1149,12 +1156,32 @@ public:
     * This includes signatures for every built-in, regardless of version or
     * enabled extensions.  The availability predicate associated with each
     * signature allows matching_signature() to filter out the irrelevant ones.
+    *
+    * Only the intrinsics are created up front, the other functions are
+    * added by materialize() the first time a shader refers to them.
     */
    struct glsl_symbol_table *symbols;
 
 private:
    void *mem_ctx;
 
+   /**
+    * Names that materialize() was already called for, including the ones
+    * which aren't built-in functions.
+    */
+   struct set *materialized;
+
+   /**
+    * While running create_builtins() on behalf of materialize(), the only
+    * function to generate.  NULL means every function.
+    */
+   const char *materialize_name;
+
+   bool wants_function(const char *name) const
+   {
+      return materialize_name == NULL || strcmp(name, materialize_name) == 0;
+   }
+
    void create_shader();
    void create_intrinsics();
    void create_builtins();
@@ -1599,6 +1626,8 @@ builtin_builder::builtin_builder()
    : symbols(NULL)
 {
    mem_ctx = NULL;
+   materialized = NULL;
+   materialize_name = NULL;
 }
 
 builtin_builder::~builtin_builder()
@@ -1608,6 +1637,7 @@ builtin_builder::~builtin_builder()
    ralloc_free(mem_ctx);
    mem_ctx = NULL;
    symbols = NULL;
+   materialized = NULL;
 
    simple_mtx_unlock(&builtins_lock);
 }
@@ -1625,6 +1655,8 @@ builtin_builder::find(_mesa_glsl_parse_state *state,
     */
    state->uses_builtin_functions = true;
 
+   materialize(name);
+
    ir_function *f = symbols->get_function(name);
    if (f == NULL)
       return NULL;
@@ -1650,9 +1682,30 @@ builtin_builder::initialize()
    glsl_type_singleton_init_or_ref();
 
    mem_ctx = ralloc_context(NULL);
+   materialized = _mesa_set_create(mem_ctx, _mesa_hash_string,
+                                   _mesa_key_string_equal);
    create_shader();
    create_intrinsics();
+}
+
+void
+builtin_builder::materialize(const char *name)
+{
+   if (_mesa_set_search(materialized, name))
+      return;
+
+   _mesa_set_add(materialized, ralloc_strdup(mem_ctx, name));
+
+   /* The intrinsics all exist already. */
+   if (strncmp(name, "__intrinsic_", 12) == 0)
+      return;
+
+   /* Walk the list of built-ins, only building the signatures of the
+    * requested function.  Skipping the others costs a string compare each.
+    */
+   materialize_name = name;
    create_builtins();
+   materialize_name = NULL;
 }
 
 void
@@ -1661,6 +1714,7 @@ builtin_builder::release()
    ralloc_free(mem_ctx);
    mem_ctx = NULL;
    symbols = NULL;
+   materialized = NULL;
 
    glsl_type_singleton_decref();
 }
@@ -2042,6 +2096,15 @@ builtin_builder::create_intrinsics()
 void
 builtin_builder::create_builtins()
 {
+   /* Don't evaluate the signature generators of the functions that weren't
+    * asked for.
+    */
+#define add_function(NAME, ...)                         \
+   do {                                                 \
+      if (wants_function(NAME))                         \
+         this->add_function(NAME, __VA_ARGS__);         \
+   } while (0)
+
 #define F(NAME)                                 \
    add_function(#NAME,                          \
                 _##NAME(&glsl_type_builtin_float), \
@@ -5985,6 +6048,7 @@ builtin_builder::create_builtins()
 #undef FIUDHF_VEC
 #undef FIUBDHF_VEC
 #undef FIU2_MIXED
+#undef add_function
 }
 
 void
@@ -6057,6 +6121,9 @@ builtin_builder::add_image_function(const char *name,
       &glsl_type_builtin_uimage2DMSArray
    };
 
+   if (!wants_function(name))
+      return;
+
    ir_function *f = new(mem_ctx) ir_function(name);
 
    for (unsigned i = 0; i < ARRAY_SIZE(types); ++i) {
@@ -9538,6 +9605,7 @@ _mesa_glsl_has_builtin_function(_mesa_glsl_parse_state *state, const char *name)
    ir_function *f;
    bool ret = false;
    simple_mtx_lock(&builtins_lock);
+   builtins.materialize(name);
    f = builtins.symbols->get_function(name);
    if (f != NULL) {
       foreach_in_list(ir_function_signature, sig, &f->signatures) {
@@ -4131,22 +4131,35 @@ assign_final_varying_locations(const struct gl_constants *consts,
 
    bool found_match = false;
    if (consumer) {
+      /* Index the producer matches by location, so that matching the inputs
+       * doesn't scan all of them for every input.
+       */
+      struct hash_table_u64 *producer_matches =
+         _mesa_hash_table_u64_create(mem_ctx);
+      for (unsigned i = 0; i < vm->num_matches; i++) {
+         nir_variable *var = vm->matches[i].producer_var;
+         if (!var)
+            continue;
+
+         uint64_t key = (uint64_t)var->data.location << 2 | var->data.location_frac;
+         if (!_mesa_hash_table_u64_search(producer_matches, key))
+            _mesa_hash_table_u64_insert(producer_matches, key,
+                                        (void *)(uintptr_t)(i + 1));
+      }
+
       nir_foreach_shader_in_variable(var_in, consumer->Program->nir) {
          if (var_in->data.location < VARYING_SLOT_VAR0 ||
              var_in->data.explicit_location)
             continue;
 
-         found_match = false;
-         for (unsigned i = 0; i < vm->num_matches; i++) {
-            if (vm->matches[i].producer_var &&
-                (vm->matches[i].producer_var->data.location == var_in->data.location &&
-                 vm->matches[i].producer_var->data.location_frac == var_in->data.location_frac)) {
+         uint64_t key = (uint64_t)var_in->data.location << 2 | var_in->data.location_frac;
+         uintptr_t match = (uintptr_t)
+            _mesa_hash_table_u64_search(producer_matches, key);
+
+         found_match = match != 0;
+         if (found_match)
+            vm->matches[match - 1].consumer_var = var_in;
 
-               vm->matches[i].consumer_var = var_in;
-               found_match = true;
-               break;
-            }
-         }
          if (!found_match) {
             if (vm->num_matches == vm->matches_capacity) {
                vm->matches_capacity *= 2;
@@ -47,60 +47,65 @@ gl_nir_opts(nir_shader *nir)
 
    MESA_TRACE_FUNC();
 
+   /* Passes which didn't make progress are skipped until another pass
+    * changes the shader.
+    */
+   struct set *skip = _mesa_pointer_set_create(NULL);
    do {
       progress = false;
 
-      NIR_PASS(_, nir, nir_lower_vars_to_ssa);
+      NIR_LOOP_PASS(_, skip, nir, nir_lower_vars_to_ssa);
 
       /* Linking deals with unused inputs/outputs, but here we can remove
        * things local to the shader in the hopes that we can cleanup other
        * things. This pass will also remove variables with only stores, so we
        * might be able to make progress after it.
        */
-      NIR_PASS(progress, nir, nir_remove_dead_variables,
-               nir_var_function_temp | nir_var_shader_temp |
-               nir_var_mem_shared,
-               NULL);
+      NIR_LOOP_PASS(progress, skip, nir, nir_remove_dead_variables,
+                    nir_var_function_temp | nir_var_shader_temp |
+                    nir_var_mem_shared,
+                    NULL);
 
-      NIR_PASS(progress, nir, nir_opt_find_array_copies);
-      NIR_PASS(progress, nir, nir_opt_copy_prop_vars);
-      NIR_PASS(progress, nir, nir_opt_dead_write_vars);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_find_array_copies);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_copy_prop_vars);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_dead_write_vars);
 
       if (nir->options->lower_to_scalar) {
-         NIR_PASS(_, nir, nir_lower_alu_to_scalar,
-                    nir->options->lower_to_scalar_filter, NULL);
-         NIR_PASS(_, nir, nir_lower_phis_to_scalar, false);
+         NIR_LOOP_PASS(_, skip, nir, nir_lower_alu_to_scalar,
+                       nir->options->lower_to_scalar_filter, NULL);
+         NIR_LOOP_PASS(_, skip, nir, nir_lower_phis_to_scalar, false);
       }
 
-      NIR_PASS(_, nir, nir_lower_alu);
-      NIR_PASS(_, nir, nir_lower_pack);
-      NIR_PASS(progress, nir, nir_copy_prop);
-      NIR_PASS(progress, nir, nir_opt_remove_phis);
-      NIR_PASS(progress, nir, nir_opt_dce);
+      NIR_LOOP_PASS(_, skip, nir, nir_lower_alu);
+      NIR_LOOP_PASS(_, skip, nir, nir_lower_pack);
+      NIR_LOOP_PASS(progress, skip, nir, nir_copy_prop);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_remove_phis);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_dce);
 
       bool opt_loop_progress = false;
-      NIR_PASS(opt_loop_progress, nir, nir_opt_loop);
+      NIR_LOOP_PASS_NOT_IDEMPOTENT(opt_loop_progress, skip, nir, nir_opt_loop);
       if (opt_loop_progress) {
          progress = true;
-         NIR_PASS(progress, nir, nir_copy_prop);
-         NIR_PASS(progress, nir, nir_opt_dce);
+         NIR_LOOP_PASS(progress, skip, nir, nir_copy_prop);
+         NIR_LOOP_PASS(progress, skip, nir, nir_opt_dce);
       }
-      NIR_PASS(progress, nir, nir_opt_if, 0);
-      NIR_PASS(progress, nir, nir_opt_dead_cf);
-      NIR_PASS(progress, nir, nir_opt_cse);
+      NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, nir, nir_opt_if, 0);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_dead_cf);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_cse);
 
       nir_opt_peephole_select_options peephole_select_options = {
          .limit = 8,
          .indirect_load_ok = true,
          .expensive_alu_ok = true,
       };
-      NIR_PASS(progress, nir, nir_opt_peephole_select, &peephole_select_options);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_peephole_select,
+                    &peephole_select_options);
 
-      NIR_PASS(progress, nir, nir_opt_phi_precision);
-      NIR_PASS(progress, nir, nir_opt_algebraic);
-      NIR_PASS(progress, nir, nir_opt_constant_folding);
-      NIR_PASS(progress, nir, nir_io_add_const_offset_to_base,
-               nir_var_shader_in | nir_var_shader_out);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_phi_precision);
+      NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, nir, nir_opt_algebraic);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_constant_folding);
+      NIR_LOOP_PASS(progress, skip, nir, nir_io_add_const_offset_to_base,
+                    nir_var_shader_in | nir_var_shader_out);
 
       if (!nir->info.flrp_lowered) {
          unsigned lower_flrp =
@@ -115,8 +120,8 @@ gl_nir_opts(nir_shader *nir)
                      lower_flrp,
                      false /* always_precise */);
             if (lower_flrp_progress) {
-               NIR_PASS(progress, nir,
-                        nir_opt_constant_folding);
+               _mesa_set_clear(skip, NULL);
+               NIR_LOOP_PASS(progress, skip, nir, nir_opt_constant_folding);
                progress = true;
             }
          }
@@ -127,19 +132,30 @@ gl_nir_opts(nir_shader *nir)
          nir->info.flrp_lowered = true;
       }
 
-      NIR_PASS(progress, nir, nir_opt_undef);
+      NIR_LOOP_PASS(progress, skip, nir, nir_opt_undef);
 
+      /* The skip set is keyed by the pass, not by its options, so run the
+       * second peephole select unconditionally.
+       */
+      bool peephole_select_progress = false;
       peephole_select_options = (nir_opt_peephole_select_options){
          .limit = 0,
          .discard_ok = true,
       };
-      NIR_PASS(progress, nir, nir_opt_peephole_select, &peephole_select_options);
+      NIR_PASS(peephole_select_progress, nir, nir_opt_peephole_select,
+               &peephole_select_options);
+      if (peephole_select_progress) {
+         _mesa_set_clear(skip, NULL);
+         progress = true;
+      }
+
       if (nir->options->max_unroll_iterations ||
             (nir->options->max_unroll_iterations_fp64 &&
                (nir->options->lower_doubles_options & nir_lower_fp64_full_software))) {
-         NIR_PASS(progress, nir, nir_opt_loop_unroll);
+         NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, nir, nir_opt_loop_unroll);
       }
    } while (progress);
+   _mesa_set_destroy(skip, NULL);
 
    NIR_PASS(_, nir, nir_lower_var_copies);
 }
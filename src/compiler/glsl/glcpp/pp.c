@@ -221,14 +221,194 @@ remove_line_continuations(glcpp_parser_t *ctx, const char *shader)
 	return sb->buf;
 }
 
+static bool
+is_hspace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+}
+
+static bool
+is_word_char(char c)
+{
+	return isalnum((unsigned char) c) || c == '_';
+}
+
+/* Characters that glcpp passes through a text line unchanged. */
+static bool
+is_plain_text_char(char c)
+{
+	return is_word_char(c) || strchr("[](){}.&*~!/%<>^|;,=+-?:", c);
+}
+
+/* Most shaders handed to us by applications and engines are already
+ * fully preprocessed: a #version line, maybe some #extension lines and
+ * then plain GLSL. Running those through the lexer and parser only
+ * collapses whitespace, so handle them with a single scan that produces
+ * exactly the output glcpp would and fall back to the full preprocessor
+ * for anything that could make a difference: other directives, comments,
+ * line continuations and identifiers that may name a predefined macro
+ * (GL_* and anything containing "__").
+ *
+ * Returns NULL if the shader needs the full preprocessor.
+ */
+static char *
+preprocess_trivial_shader(void *ralloc_ctx, const char *shader)
+{
+	/* Whitespace only ever shrinks and at most a final newline is
+	 * added, so the output always fits.
+	 */
+	char *output = ralloc_size(ralloc_ctx, strlen(shader) + 2);
+	char *out = output;
+	const char *p = shader;
+	bool seen_tokens = false;
+
+	if (output == NULL)
+		return NULL;
+
+	while (*p) {
+		bool pending_space = false;
+		bool line_has_tokens = false;
+
+		while (is_hspace(*p)) {
+			pending_space = true;
+			p++;
+		}
+
+		if (*p == '#') {
+			p++;
+			while (is_hspace(*p))
+				p++;
+
+			if (!seen_tokens && strncmp(p, "version", 7) == 0 &&
+			    is_hspace(p[7])) {
+				const char *number;
+
+				p += 7;
+				while (is_hspace(*p))
+					p++;
+
+				/* Only a plain decimal version number. */
+				number = p;
+				if (*p < '1' || *p > '9')
+					goto fail;
+				while (isdigit((unsigned char) *p))
+					p++;
+				if (p - number > 9 || !(is_hspace(*p) ||
+				    *p == '\n' || *p == '\0'))
+					goto fail;
+
+				memcpy(out, "#version ", 9);
+				out += 9;
+				memcpy(out, number, p - number);
+				out += p - number;
+
+				while (is_hspace(*p))
+					p++;
+
+				if (isalpha((unsigned char) *p) || *p == '_') {
+					*out++ = ' ';
+					while (is_word_char(*p))
+						*out++ = *p++;
+					while (is_hspace(*p))
+						p++;
+				}
+
+				if (*p != '\n' && *p != '\0')
+					goto fail;
+			} else if (strncmp(p, "extension", 9) == 0 ||
+				   strncmp(p, "pragma", 6) == 0) {
+				const char *end = p + strcspn(p, "\n");
+				const char *c;
+
+				/* glcpp swallows empty pragmas. */
+				if (p[0] == 'p') {
+					for (c = p + 6; c < end && is_hspace(*c); c++)
+						;
+					if (c == end)
+						goto fail;
+				}
+
+				for (c = p; c < end; c++) {
+					if (*c == '\\' || *c == '\r' ||
+					    (c[0] == '/' && (c[1] == '/' || c[1] == '*')))
+						goto fail;
+				}
+
+				*out++ = '#';
+				memcpy(out, p, end - p);
+				out += end - p;
+				p = end;
+			} else {
+				goto fail;
+			}
+
+			/* Any #version after this point is an error. */
+			seen_tokens = true;
+		} else {
+			while (*p && *p != '\n') {
+				if (is_hspace(*p)) {
+					pending_space = true;
+					p++;
+					continue;
+				}
+
+				if (!is_plain_text_char(*p) ||
+				    (p[0] == '/' && (p[1] == '/' || p[1] == '*')) ||
+				    (p[0] == '_' && p[1] == '_') ||
+				    (strncmp(p, "GL_", 3) == 0 &&
+				     (p == shader || !is_word_char(p[-1]))))
+					goto fail;
+
+				if (pending_space) {
+					*out++ = ' ';
+					pending_space = false;
+				}
+				*out++ = *p++;
+				line_has_tokens = true;
+			}
+
+			/* Trailing space is trimmed, but a line that consists
+			 * only of whitespace keeps a single space.
+			 */
+			if (pending_space && !line_has_tokens)
+				*out++ = ' ';
+
+			seen_tokens |= line_has_tokens;
+		}
+
+		/* A missing newline at the end of the shader is added. */
+		*out++ = '\n';
+		if (*p == '\n')
+			p++;
+	}
+
+	if (out == output)
+		*out++ = '\n';
+	*out = '\0';
+
+	return output;
+
+fail:
+	ralloc_free(output);
+	return NULL;
+}
+
 int
 glcpp_preprocess(void *ralloc_ctx, const char **shader, char **info_log,
                  glcpp_extension_iterator extensions, void *state,
                  struct gl_context *gl_ctx)
 {
 	int errors;
-	glcpp_parser_t *parser =
-		glcpp_parser_create(gl_ctx, extensions, state);
+	glcpp_parser_t *parser;
+	char *output;
+
+	output = preprocess_trivial_shader(ralloc_ctx, *shader);
+	if (output) {
+		*shader = output;
+		return 0;
+	}
+
+	parser = glcpp_parser_create(gl_ctx, extensions, state);
 
 	if (! gl_ctx->Const.DisableGLSLLineContinuations)
 		*shader = remove_line_continuations(parser, *shader);
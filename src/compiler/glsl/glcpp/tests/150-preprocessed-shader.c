@@ -0,0 +1,9 @@
+#version 130
+#extension GL_ARB_foo : enable
+#pragma optimize(off)
+
+   uniform  vec4	color;   
+void main()
+{
+   gl_FragColor = color.x > 0.5 ? color : vec4(1.0);
+}
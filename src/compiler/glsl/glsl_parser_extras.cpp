@@ -2228,9 +2228,6 @@ opt_shader(const struct gl_constants *consts,
    do_vec_index_to_cond_assign(shader->ir);
 
    validate_ir_tree(shader->ir);
-
-   /* Retain any live IR, but trash the rest. */
-   reparent_ir(shader->ir, shader->ir);
 }
 
 static bool
@@ -2243,13 +2240,26 @@ can_skip_compile(struct gl_context *ctx, struct gl_shader *shader,
          char buf[41];
          disk_cache_compute_key(ctx->Cache, source, strlen(source),
                                 shader->disk_cache_sha1);
-         if (disk_cache_has_key(ctx->Cache, shader->disk_cache_sha1)) {
-            /* We've seen this shader before and know it compiles */
+         bool seen = disk_cache_has_key(ctx->Cache, shader->disk_cache_sha1);
+
+         /* Even if the key of this shader was evicted or never written, the
+          * program it gets linked into may well be in the cache. Defer the
+          * compile until the compile status or info log is queried, or until
+          * linking misses the cache, instead of parsing the shader now.
+          */
+         bool defer = !seen && !source_has_shader_include &&
+                      !(ctx->_Shader->Flags & (GLSL_DUMP | GLSL_LOG |
+                                               GLSL_DUMP_ON_ERROR |
+                                               GLSL_REPORT_ERRORS));
+
+         if (seen || defer) {
+            /* If we've seen this shader before, we know it compiles. */
             if (ctx->_Shader->Flags & GLSL_CACHE_INFO) {
                _mesa_sha1_format(buf, shader->disk_cache_sha1);
                fprintf(stderr, "deferring compile of shader: %s\n", buf);
             }
             shader->CompileStatus = COMPILE_SKIPPED;
+            shader->CompileDeferred = defer;
 
             free((void *)shader->FallbackSource);
 
@@ -2384,6 +2394,7 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
       set_shader_inout_layout(shader, state);
 
    shader->CompileStatus = state->error ? COMPILE_FAILURE : COMPILE_SUCCESS;
+   shader->CompileDeferred = false;
    shader->InfoLog = state->info_log;
    shader->Version = state->language_version;
    shader->IsES = state->es_shader;
@@ -2419,9 +2430,6 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
       }
    }
 
-   delete state->symbols;
-   ralloc_free(state);
-
    if (ctx->_Shader && ctx->_Shader->Flags & GLSL_DUMP) {
       if (shader->CompileStatus) {
          assert(shader->ir);
@@ -2450,6 +2458,14 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
       shader->nir = glsl_to_nir(shader, options->NirOptions, source_blake3);
    }
 
+   /* The IR is allocated from the parse state, along with the AST and the
+    * IR that the lowering and optimization passes dropped.  Now that the
+    * shader was converted to NIR, release all of it at once instead of
+    * moving the live IR out of the parse state first.
+    */
+   delete state->symbols;
+   ralloc_free(state);
+
    if (ctx->Cache && shader->CompileStatus == COMPILE_SUCCESS) {
       char sha1_buf[41];
       disk_cache_put_key(ctx->Cache, shader->disk_cache_sha1);
@@ -32,6 +32,7 @@
 #include "util/half_float.h"
 #include "util/macros.h"
 #include "util/u_math.h"
+#include "util/simple_mtx.h"
 #include "util/u_qsort.h"
 #include "nir_builder.h"
 #include "nir_control_flow_private.h"
@@ -92,6 +93,10 @@ static const struct debug_named_value nir_debug_control[] = {
      "Print shaders even if they are marked as internal" },
    { "print_pass_flags", NIR_DEBUG_PRINT_PASS_FLAGS,
      "Print pass_flags for every instruction when pass_flags are non-zero" },
+   { "pass_stats", NIR_DEBUG_PASS_STATS,
+     "Count how often each pass runs, makes progress and is skipped by NIR_LOOP_PASS, and print the counts at exit" },
+   { "validate_instr_set", NIR_DEBUG_VALIDATE_INSTR_SET,
+     "Check the instruction sets used by CSE and GVN against the generic hash set" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -127,6 +132,86 @@ nir_process_debug_variable(void)
    static once_flag flag = ONCE_FLAG_INIT;
    call_once(&flag, nir_process_debug_variable_once);
 }
+
+struct nir_pass_stats {
+   const char *pass;
+   unsigned runs;
+   unsigned progress;
+   unsigned skipped;
+};
+
+static simple_mtx_t pass_stats_mutex = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *pass_stats;
+
+static int
+compare_pass_stats(const void *a, const void *b)
+{
+   const struct nir_pass_stats *sa = *(const struct nir_pass_stats **)a;
+   const struct nir_pass_stats *sb = *(const struct nir_pass_stats **)b;
+
+   if (sa->runs != sb->runs)
+      return sa->runs < sb->runs ? 1 : -1;
+   return strcmp(sa->pass, sb->pass);
+}
+
+static void
+print_pass_stats(void)
+{
+   simple_mtx_lock(&pass_stats_mutex);
+
+   unsigned count = pass_stats->entries, i = 0;
+   struct nir_pass_stats **sorted = malloc(count * sizeof(*sorted));
+
+   hash_table_foreach(pass_stats, entry)
+      sorted[i++] = entry->data;
+   qsort(sorted, count, sizeof(*sorted), compare_pass_stats);
+
+   fprintf(stderr, "NIR pass statistics:\n");
+   fprintf(stderr, "%-40s %10s %10s %10s\n", "pass", "runs", "progress",
+           "skipped");
+   for (i = 0; i < count; i++) {
+      fprintf(stderr, "%-40s %10u %10u %10u\n", sorted[i]->pass,
+              sorted[i]->runs, sorted[i]->progress, sorted[i]->skipped);
+   }
+
+   free(sorted);
+   simple_mtx_unlock(&pass_stats_mutex);
+}
+
+/**
+ * Account for one NIR_PASS() or NIR_LOOP_PASS() of \p pass, for
+ * NIR_DEBUG=pass_stats.
+ */
+void
+nir_record_pass_stats(const char *pass, bool skipped, bool progress)
+{
+   simple_mtx_lock(&pass_stats_mutex);
+
+   if (!pass_stats) {
+      pass_stats = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                           _mesa_key_string_equal);
+      atexit(print_pass_stats);
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(pass_stats, pass);
+   struct nir_pass_stats *stats;
+   if (entry) {
+      stats = entry->data;
+   } else {
+      stats = rzalloc(pass_stats, struct nir_pass_stats);
+      stats->pass = pass;
+      _mesa_hash_table_insert(pass_stats, pass, stats);
+   }
+
+   if (skipped) {
+      stats->skipped++;
+   } else {
+      stats->runs++;
+      stats->progress += progress;
+   }
+
+   simple_mtx_unlock(&pass_stats_mutex);
+}
 #endif
 
 /** Return true if the component mask "mask" with bit size "old_bit_size" can
@@ -91,6 +91,8 @@ extern bool nir_debug_print_shader[MESA_SHADER_KERNEL + 1];
 #define NIR_DEBUG_PRINT_INTERNAL         (1u << 21)
 #define NIR_DEBUG_PRINT_PASS_FLAGS       (1u << 22)
 #define NIR_DEBUG_INVALIDATE_METADATA    (1u << 23)
+#define NIR_DEBUG_PASS_STATS             (1u << 24)
+#define NIR_DEBUG_VALIDATE_INSTR_SET     (1u << 25)
 
 #define NIR_DEBUG_PRINT (NIR_DEBUG_PRINT_VS |  \
                          NIR_DEBUG_PRINT_TCS | \
@@ -136,6 +138,15 @@ nir_component_mask(unsigned num_components)
 void
 nir_process_debug_variable(void);
 
+#ifndef NDEBUG
+void nir_record_pass_stats(const char *pass, bool skipped, bool progress);
+#else
+static inline void
+nir_record_pass_stats(const char *pass, bool skipped, bool progress)
+{
+}
+#endif
+
 bool nir_component_mask_can_reinterpret(nir_component_mask_t mask,
                                         unsigned old_bit_size,
                                         unsigned new_bit_size);
@@ -3707,6 +3718,12 @@ typedef struct nir_shader {
    u_printf_info *printf_info;
 
    bool has_debug_info;
+
+   /**
+    * Names and constant data point into the blob the shader was read from,
+    * see nir_deserialize_view().
+    */
+   bool is_view;
 } nir_shader;
 
 #define nir_foreach_function(func, shader) \
@@ -4531,6 +4548,7 @@ nir_variable *nir_variable_clone(const nir_variable *c, nir_shader *shader);
 void nir_shader_replace(nir_shader *dest, nir_shader *src);
 
 void nir_shader_serialize_deserialize(nir_shader *s);
+void nir_shader_materialize(nir_shader *s);
 
 #ifndef NDEBUG
 void nir_validate_shader(nir_shader *shader, const char *when);
@@ -4612,6 +4630,8 @@ should_print_nir(UNUSED nir_shader *shader)
          printf("skipping %s\n", #pass);                                \
          break;                                                         \
       }                                                                 \
+      if (unlikely((nir)->is_view))                                     \
+         nir_shader_materialize(nir);                                   \
       if (NIR_DEBUG(INVALIDATE_METADATA))                               \
          nir_metadata_invalidate(nir);                                  \
       else if (NIR_DEBUG(EXTENDED_VALIDATION))                          \
@@ -4633,7 +4653,10 @@ should_print_nir(UNUSED nir_shader *shader)
    nir_metadata_set_validation_flag(nir);                                                   \
    if (should_print_nir(nir))                                                               \
       printf("%s\n", #pass);                                                                \
-   if (pass(nir, ##__VA_ARGS__)) {                                                          \
+   bool nir_pass_progress = pass(nir, ##__VA_ARGS__);                                       \
+   if (NIR_DEBUG(PASS_STATS))                                                               \
+      nir_record_pass_stats(#pass, false, nir_pass_progress);                               \
+   if (nir_pass_progress) {                                                                 \
       nir_validate_shader(nir, "after " #pass " in " __FILE__ ":" NIR_STRINGIZE(__LINE__)); \
       UNUSED bool _;                                                                        \
       progress = true;                                                                      \
@@ -4663,6 +4686,8 @@ do {                                                                 \
    bool nir_loop_pass_progress = false;                              \
    if (!_mesa_set_search(skip, (void (*)())&pass))                   \
       NIR_PASS(nir_loop_pass_progress, nir, pass, ##__VA_ARGS__);    \
+   else if (NIR_DEBUG(PASS_STATS))                                   \
+      nir_record_pass_stats(#pass, true, false);                     \
    if (nir_loop_pass_progress)                                       \
       _mesa_set_clear(skip, NULL);                                   \
    if (idempotent || !nir_loop_pass_progress)                        \
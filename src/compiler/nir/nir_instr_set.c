@@ -748,28 +748,167 @@ cmp_func(const void *data1, const void *data2)
    return nir_instrs_equal(data1, data2);
 }
 
-struct set *
+/* The instruction set is an open-addressing hash table with linear probing,
+ * which keeps the hash of each instruction next to it so that probing
+ * doesn't touch the instructions until the hashes match.
+ */
+struct nir_instr_set_entry {
+   uint32_t hash;
+   nir_instr *instr;
+};
+
+#define DELETED_INSTR     ((nir_instr *)(uintptr_t)1)
+#define INSTR_SET_MIN_SIZE 16
+
+struct nir_instr_set {
+   struct nir_instr_set_entry *table;
+   uint32_t size_mask;
+   uint32_t entries;
+   /* Entries plus deleted entries. */
+   uint32_t used;
+
+   /* With NIR_DEBUG=validate_instr_set, a generic set that every operation
+    * is mirrored in and checked against.
+    */
+   struct set *ref;
+};
+
+static void
+instr_set_rehash(struct nir_instr_set *set, uint32_t size)
+{
+   struct nir_instr_set_entry *old_table = set->table;
+   uint32_t old_size = old_table ? set->size_mask + 1 : 0;
+
+   set->table = rzalloc_array(set, struct nir_instr_set_entry, size);
+   set->size_mask = size - 1;
+   set->used = set->entries;
+
+   for (uint32_t i = 0; i < old_size; i++) {
+      if (old_table[i].instr <= DELETED_INSTR)
+         continue;
+
+      uint32_t j = old_table[i].hash & set->size_mask;
+      while (set->table[j].instr)
+         j = (j + 1) & set->size_mask;
+      set->table[j] = old_table[i];
+   }
+
+   ralloc_free(old_table);
+}
+
+static struct nir_instr_set_entry *
+instr_set_search(struct nir_instr_set *set, uint32_t hash,
+                 const nir_instr *instr)
+{
+   for (uint32_t i = hash & set->size_mask;; i = (i + 1) & set->size_mask) {
+      struct nir_instr_set_entry *entry = &set->table[i];
+
+      if (!entry->instr)
+         return NULL;
+      if (entry->instr != DELETED_INSTR && entry->hash == hash &&
+          nir_instrs_equal(entry->instr, instr))
+         return entry;
+   }
+}
+
+static struct nir_instr_set_entry *
+instr_set_search_or_add(struct nir_instr_set *set, nir_instr *instr)
+{
+   uint32_t size = set->size_mask + 1;
+
+   /* Keep at least half of the table empty, so that probe sequences stay
+    * short.  Only grow if that's not achieved by dropping the deleted
+    * entries.
+    */
+   if ((set->used + 1) * 2 > size)
+      instr_set_rehash(set, (set->entries + 1) * 4 > size ? size * 2 : size);
+
+   uint32_t hash = hash_instr(instr);
+   struct nir_instr_set_entry *deleted = NULL;
+
+   for (uint32_t i = hash & set->size_mask;; i = (i + 1) & set->size_mask) {
+      struct nir_instr_set_entry *entry = &set->table[i];
+
+      if (!entry->instr) {
+         if (deleted) {
+            entry = deleted;
+         } else {
+            set->used++;
+         }
+
+         entry->hash = hash;
+         entry->instr = instr;
+         set->entries++;
+         return entry;
+      }
+
+      if (entry->instr == DELETED_INSTR) {
+         if (!deleted)
+            deleted = entry;
+      } else if (entry->hash == hash && nir_instrs_equal(entry->instr, instr)) {
+         return entry;
+      }
+   }
+}
+
+struct nir_instr_set *
 nir_instr_set_create(void *mem_ctx)
 {
-   return _mesa_set_create(mem_ctx, hash_instr, cmp_func);
+   struct nir_instr_set *set = rzalloc(mem_ctx, struct nir_instr_set);
+
+   instr_set_rehash(set, INSTR_SET_MIN_SIZE);
+
+   if (NIR_DEBUG(VALIDATE_INSTR_SET))
+      set->ref = _mesa_set_create(set, hash_instr, cmp_func);
+
+   return set;
+}
+
+void
+nir_instr_set_destroy(struct nir_instr_set *instr_set)
+{
+   ralloc_free(instr_set);
+}
+
+void
+nir_instr_set_resize(struct nir_instr_set *instr_set, uint32_t entries)
+{
+   uint32_t size = MAX2(util_next_power_of_two(entries * 2),
+                        INSTR_SET_MIN_SIZE);
+
+   if (size > instr_set->size_mask + 1)
+      instr_set_rehash(instr_set, size);
 }
 
 void
-nir_instr_set_destroy(struct set *instr_set)
+nir_instr_set_clear(struct nir_instr_set *instr_set)
 {
-   _mesa_set_destroy(instr_set, NULL);
+   memset(instr_set->table, 0,
+          (instr_set->size_mask + 1) * sizeof(*instr_set->table));
+   instr_set->entries = 0;
+   instr_set->used = 0;
+
+   if (instr_set->ref)
+      _mesa_set_clear(instr_set->ref, NULL);
 }
 
 nir_instr *
-nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr,
+nir_instr_set_add_or_rewrite(struct nir_instr_set *instr_set, nir_instr *instr,
                              bool (*cond_function)(const nir_instr *a,
                                                    const nir_instr *b))
 {
    if (!instr_can_rewrite(instr))
       return NULL;
 
-   struct set_entry *e = _mesa_set_search_or_add(instr_set, instr, NULL);
-   nir_instr *match = (nir_instr *)e->key;
+   struct nir_instr_set_entry *e = instr_set_search_or_add(instr_set, instr);
+   nir_instr *match = e->instr;
+
+   struct set_entry *ref_entry = NULL;
+   if (instr_set->ref) {
+      ref_entry = _mesa_set_search_or_add(instr_set->ref, instr, NULL);
+      assert(ref_entry->key == match);
+   }
+
    if (match == instr)
       return NULL;
 
@@ -795,18 +934,30 @@ nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr,
       return match;
    } else {
       /* otherwise, replace hashed instruction */
-      e->key = instr;
+      e->instr = instr;
+      if (ref_entry)
+         ref_entry->key = instr;
       return NULL;
    }
 }
 
 void
-nir_instr_set_remove(struct set *instr_set, nir_instr *instr)
+nir_instr_set_remove(struct nir_instr_set *instr_set, nir_instr *instr)
 {
    if (!instr_can_rewrite(instr))
       return;
 
-   struct set_entry *entry = _mesa_set_search(instr_set, instr);
-   if (entry)
-      _mesa_set_remove(instr_set, entry);
+   struct nir_instr_set_entry *entry =
+      instr_set_search(instr_set, hash_instr(instr), instr);
+   if (entry) {
+      entry->instr = DELETED_INSTR;
+      instr_set->entries--;
+   }
+
+   if (instr_set->ref) {
+      struct set_entry *ref_entry = _mesa_set_search(instr_set->ref, instr);
+      assert(!ref_entry == !entry);
+      if (ref_entry)
+         _mesa_set_remove(instr_set->ref, ref_entry);
+   }
 }
@@ -40,11 +40,22 @@
 
 /*@{*/
 
+struct nir_instr_set;
+
 /** Creates an instruction set, using a given ralloc mem_ctx */
-struct set *nir_instr_set_create(void *mem_ctx);
+struct nir_instr_set *nir_instr_set_create(void *mem_ctx);
 
 /** Destroys an instruction set. */
-void nir_instr_set_destroy(struct set *instr_set);
+void nir_instr_set_destroy(struct nir_instr_set *instr_set);
+
+/**
+ * Makes room for \p entries instructions, to avoid growing the set
+ * repeatedly while it's filled.
+ */
+void nir_instr_set_resize(struct nir_instr_set *instr_set, uint32_t entries);
+
+/** Removes all the instructions from an instruction set. */
+void nir_instr_set_clear(struct nir_instr_set *instr_set);
 
 /**
  * Adds an instruction to an instruction set if it doesn't exist. If it does
@@ -55,7 +66,7 @@ void nir_instr_set_destroy(struct set *instr_set);
  * cond_function(old_instr, new_instr) returns true.
  */
 nir_instr *
-nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr,
+nir_instr_set_add_or_rewrite(struct nir_instr_set *instr_set, nir_instr *instr,
                              bool (*cond_function)(const nir_instr *a,
                                                    const nir_instr *b));
 
@@ -63,7 +74,7 @@ nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr,
  * Removes an instruction from an instruction set, so that other instructions
  * won't be merged with it.
  */
-void nir_instr_set_remove(struct set *instr_set, nir_instr *instr);
+void nir_instr_set_remove(struct nir_instr_set *instr_set, nir_instr *instr);
 
 /*@}*/
 
@@ -146,6 +146,10 @@ struct entry_key {
 struct entry {
    struct list_head head;
    unsigned index;
+   /* Number of stores with the same mode index created before this entry.
+    * Stores are only ever removed, so this is an upper bound.
+    */
+   unsigned stores_before;
 
    struct entry_key *key;
    union {
@@ -171,8 +175,16 @@ struct vectorize_ctx {
    struct list_head entries[nir_num_variable_modes];
    struct hash_table *loads[nir_num_variable_modes];
    struct hash_table *stores[nir_num_variable_modes];
+   unsigned num_stores[nir_num_variable_modes];
 };
 
+/* Upper bound on the number of accesses vectorize_sorted_entries() tries to
+ * combine with a single access, which keeps the pass linear for blocks with
+ * lots of accesses to close offsets.  Candidates are visited in offset
+ * order, so the ones that matter are tried first.
+ */
+#define MAX_VECTORIZE_CANDIDATES 64
+
 static uint32_t
 hash_entry_key(const void *key_)
 {
@@ -1103,6 +1115,10 @@ check_for_aliasing(struct vectorize_ctx *ctx, struct entry *first, struct entry
             return true;
       }
    } else {
+      /* there were no stores in between */
+      if (second->stores_before == first->stores_before)
+         return false;
+
       /* find previous store that aliases this load */
       list_for_each_entry_from_rev(struct entry, prev, second, &ctx->entries[mode_index], head) {
          if (prev == second)
@@ -1384,11 +1400,15 @@ vectorize_sorted_entries(struct vectorize_ctx *ctx, nir_function_impl *impl,
       if (!low)
          continue;
 
+      unsigned candidates = 0;
       for (unsigned second_idx = first_idx + 1; second_idx < num_entries; second_idx++) {
          struct entry *high = *util_dynarray_element(arr, struct entry *, second_idx);
          if (!high)
             continue;
 
+         if (++candidates > MAX_VECTORIZE_CANDIDATES)
+            break;
+
          struct entry *first = low->index < high->index ? low : high;
          struct entry *second = low->index < high->index ? high : low;
 
@@ -1411,6 +1431,10 @@ vectorize_sorted_entries(struct vectorize_ctx *ctx, nir_function_impl *impl,
                 get_variable_mode(first) != nir_var_mem_shared)
                break;
 
+            /* further entries are out of reach of the largest stride */
+            if (diff > 255 * 64 * low_size)
+               break;
+
             if (try_vectorize_shared2(ctx, low, high, first, second)) {
                low = NULL;
                *util_dynarray_element(arr, struct entry *, second_idx) = NULL;
@@ -1536,6 +1560,7 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
 
    for (unsigned i = 0; i < nir_num_variable_modes; i++) {
       list_inithead(&ctx->entries[i]);
+      ctx->num_stores[i] = 0;
       if (ctx->loads[i])
          _mesa_hash_table_clear(ctx->loads[i], delete_entry_dynarray);
       if (ctx->stores[i])
@@ -1570,6 +1595,9 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
       /* create entry */
       struct entry *entry = create_entry(ctx, info, intrin);
       entry->index = next_index++;
+      entry->stores_before = ctx->num_stores[mode_index];
+      if (entry->is_store)
+         ctx->num_stores[mode_index]++;
 
       list_addtail(&entry->head, &ctx->entries[mode_index]);
 
@@ -91,6 +91,9 @@ typedef struct {
    struct nir_variable_data last_var_data;
 
    struct hash_table *strings;
+
+   /* Point names and constant data into the blob instead of copying them. */
+   bool view;
 } read_ctx;
 
 static void
@@ -360,8 +363,8 @@ read_variable(read_ctx *ctx)
    }
 
    if (flags.u.has_name) {
-      const char *name = blob_read_string(ctx->blob);
-      var->name = ralloc_strdup(var, name);
+      char *name = blob_read_string(ctx->blob);
+      var->name = ctx->view ? name : ralloc_strdup(var, name);
    } else {
       var->name = NULL;
    }
@@ -2057,8 +2060,11 @@ read_function(read_ctx *ctx)
    for (unsigned i = 0; i < fxn->num_params; i++) {
       uint32_t val = blob_read_uint32(ctx->blob);
       bool has_name = (val & 0x10000);
-      if (has_name)
-         fxn->params[i].name = blob_read_string(ctx->blob);
+      if (has_name) {
+         char *name = blob_read_string(ctx->blob);
+         fxn->params[i].name = ctx->view ? name :
+                               ralloc_strdup(fxn->params, name);
+      }
 
       fxn->params[i].num_components = val & 0xff;
       fxn->params[i].bit_size = (val >> 8) & 0xff;
@@ -2202,13 +2208,14 @@ nir_serialize(struct blob *blob, const nir_shader *nir, bool strip)
    util_dynarray_fini(&ctx.phi_fixups);
 }
 
-nir_shader *
-nir_deserialize(void *mem_ctx,
-                const struct nir_shader_compiler_options *options,
-                struct blob_reader *blob)
+static nir_shader *
+deserialize_shader(void *mem_ctx,
+                   const struct nir_shader_compiler_options *options,
+                   struct blob_reader *blob, bool view)
 {
    read_ctx ctx = { 0 };
    ctx.blob = blob;
+   ctx.view = view;
    list_inithead(&ctx.phi_srcs);
    ctx.idx_table_len = blob_read_uint32(blob);
    ctx.idx_table = calloc(ctx.idx_table_len, sizeof(uintptr_t));
@@ -2226,10 +2233,16 @@ nir_deserialize(void *mem_ctx,
    if (ctx.nir->has_debug_info)
       ctx.strings = _mesa_hash_table_create(NULL, _mesa_hash_string, _mesa_key_string_equal);
 
-   info.name = name ? ralloc_strdup(ctx.nir, name) : NULL;
-   info.label = label ? ralloc_strdup(ctx.nir, label) : NULL;
+   if (!view) {
+      info.name = name ? ralloc_strdup(ctx.nir, name) : NULL;
+      info.label = label ? ralloc_strdup(ctx.nir, label) : NULL;
+   } else {
+      info.name = name;
+      info.label = label;
+   }
 
    ctx.nir->info = info;
+   ctx.nir->is_view = view;
 
    read_var_list(&ctx, &ctx.nir->variables);
 
@@ -2249,10 +2262,15 @@ nir_deserialize(void *mem_ctx,
 
    ctx.nir->constant_data_size = blob_read_uint32(blob);
    if (ctx.nir->constant_data_size > 0) {
-      ctx.nir->constant_data =
-         ralloc_size(ctx.nir, ctx.nir->constant_data_size);
-      blob_copy_bytes(blob, ctx.nir->constant_data,
-                      ctx.nir->constant_data_size);
+      if (view) {
+         ctx.nir->constant_data =
+            (void *)blob_read_bytes(blob, ctx.nir->constant_data_size);
+      } else {
+         ctx.nir->constant_data =
+            ralloc_size(ctx.nir, ctx.nir->constant_data_size);
+         blob_copy_bytes(blob, ctx.nir->constant_data,
+                         ctx.nir->constant_data_size);
+      }
    }
 
    ctx.nir->xfb_info = read_xfb_info(&ctx);
@@ -2271,6 +2289,68 @@ nir_deserialize(void *mem_ctx,
    return ctx.nir;
 }
 
+nir_shader *
+nir_deserialize(void *mem_ctx,
+                const struct nir_shader_compiler_options *options,
+                struct blob_reader *blob)
+{
+   return deserialize_shader(mem_ctx, options, blob, false);
+}
+
+/**
+ * Like nir_deserialize(), but the variable and parameter names, the shader
+ * name and label and the constant data of the returned shader point into
+ * the blob instead of being copied out of it.  This is meant for shaders
+ * read straight from a (memory-mapped) cache entry, which must then outlive
+ * the shader or its nir_shader_materialize() call.
+ *
+ * The shader must not be modified before being materialized, which
+ * NIR_PASS() and nir_sweep() do automatically.
+ */
+nir_shader *
+nir_deserialize_view(void *mem_ctx,
+                     const struct nir_shader_compiler_options *options,
+                     struct blob_reader *blob)
+{
+   return deserialize_shader(mem_ctx, options, blob, true);
+}
+
+/**
+ * Copy everything a shader returned by nir_deserialize_view() still
+ * references in the blob, so that it can be modified and the blob freed.
+ */
+void
+nir_shader_materialize(nir_shader *nir)
+{
+   if (!nir->is_view)
+      return;
+
+   nir_foreach_variable_in_shader(var, nir)
+      var->name = ralloc_strdup(var, var->name);
+
+   nir_foreach_function(fxn, nir) {
+      for (unsigned i = 0; i < fxn->num_params; i++) {
+         fxn->params[i].name = ralloc_strdup(fxn->params,
+                                             fxn->params[i].name);
+      }
+
+      if (fxn->impl) {
+         nir_foreach_function_temp_variable(var, fxn->impl)
+            var->name = ralloc_strdup(var, var->name);
+      }
+   }
+
+   nir->info.name = ralloc_strdup(nir, nir->info.name);
+   nir->info.label = ralloc_strdup(nir, nir->info.label);
+
+   if (nir->constant_data_size > 0) {
+      nir->constant_data = ralloc_memdup(nir, nir->constant_data,
+                                         nir->constant_data_size);
+   }
+
+   nir->is_view = false;
+}
+
 nir_function *
 nir_deserialize_function(void *mem_ctx,
                          const struct nir_shader_compiler_options *options,
@@ -36,6 +36,9 @@ void nir_serialize(struct blob *blob, const nir_shader *nir, bool strip);
 nir_shader *nir_deserialize(void *mem_ctx,
                             const struct nir_shader_compiler_options *options,
                             struct blob_reader *blob);
+nir_shader *nir_deserialize_view(void *mem_ctx,
+                                 const struct nir_shader_compiler_options *options,
+                                 struct blob_reader *blob);
 
 void
 nir_serialize_function(struct blob *blob, const nir_function *fxn);
@@ -147,6 +147,9 @@ sweep_function(nir_shader *nir, nir_function *f)
 void
 nir_sweep(nir_shader *nir)
 {
+   /* Everything the shader keeps must be owned by it. */
+   nir_shader_materialize(nir);
+
    void *rubbish = ralloc_context(NULL);
 
    struct list_head instr_gc_list;
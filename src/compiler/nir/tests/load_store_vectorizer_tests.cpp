@@ -543,6 +543,26 @@ TEST_F(nir_load_store_vectorize_test, ssbo_load_adjacent)
    EXPECT_INSTR_SWIZZLES(movs[0x2], load, "y");
 }
 
+TEST_F(nir_load_store_vectorize_test, ssbo_load_adjacent_many)
+{
+   for (unsigned i = 0; i < 256; i++)
+      create_load(nir_var_mem_ssbo, 0, i * 4, i);
+
+   nir_validate_shader(b->shader, NULL);
+   ASSERT_EQ(count_intrinsics(nir_intrinsic_load_ssbo), 256);
+
+   EXPECT_TRUE(run_vectorizer(nir_var_mem_ssbo));
+
+   ASSERT_EQ(count_intrinsics(nir_intrinsic_load_ssbo), 64);
+
+   nir_intrinsic_instr *load = get_intrinsic(nir_intrinsic_load_ssbo, 63);
+   ASSERT_EQ(load->def.bit_size, 32);
+   ASSERT_EQ(load->def.num_components, 4);
+   ASSERT_EQ(nir_src_as_uint(load->src[1]), 1008);
+   EXPECT_INSTR_SWIZZLES(movs[252], load, "x");
+   EXPECT_INSTR_SWIZZLES(movs[255], load, "w");
+}
+
 TEST_F(nir_load_store_vectorize_test, ssbo_load_adjacent_indirect)
 {
    nir_def *index_base = nir_load_local_invocation_index(b);
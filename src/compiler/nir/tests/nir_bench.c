@@ -0,0 +1,640 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Compile-time benchmark for the shared NIR passes.
+ *
+ * Every file given on the command line is expected to contain a shader
+ * serialized with nir_serialize(). Each shader is deserialized with the
+ * compiler options of the selected driver profile and run through a pass
+ * pipeline several times. For every step of the pipeline, the wall time, the
+ * number of heap allocations and the change in instruction count are reported
+ * as JSON on stdout, so that results can be compared across drivers and
+ * across Mesa versions.
+ *
+ * The pipeline is a comma-separated list of pass names. Passes wrapped in
+ * "loop(...)" are repeated until none of them makes progress, like the
+ * optimization loops drivers run:
+ *
+ *    nir_bench -p 'nir_lower_vars_to_ssa,loop(nir_copy_prop,nir_opt_dce)' *.nir
+ */
+
+#include "nir.h"
+#include "nir_serialize.h"
+
+#include "util/blob.h"
+#include "util/os_file.h"
+#include "util/os_time.h"
+#include "util/u_atomic.h"
+#include "util/u_dynarray.h"
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *help_message =
+   "Usage: %s [-h] [-n ITERATIONS] [-d PROFILE] [-p PIPELINE] FILE [FILE ...]\n"
+   "\n"
+   "Benchmark NIR passes on shaders serialized with nir_serialize().\n"
+   "\n"
+   "optional arguments:\n"
+   "  -h, --help        Show this help message and exit.\n"
+   "  -n, --iterations  Number of times each shader is optimized (default: 10).\n"
+   "  -d, --driver      Compiler options profile: radeonsi, anv or generic\n"
+   "                    (default: generic).\n"
+   "  -p, --pipeline    Comma-separated list of passes, \"loop(...)\" repeats\n"
+   "                    the enclosed passes until none of them makes progress.\n"
+   "  -l, --list        List the available passes and exit.\n";
+
+/* Allocation counting.
+ *
+ * ralloc, the gc allocator and the hash tables all end up in malloc(), so
+ * wrapping the libc entry points is enough to count the allocations made by
+ * a pass. This relies on glibc exporting the __libc_* symbols; elsewhere the
+ * counters simply stay at zero.
+ */
+static uint64_t num_allocs;
+static uint64_t alloc_bytes;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *
+malloc(size_t size)
+{
+   p_atomic_inc(&num_allocs);
+   p_atomic_add(&alloc_bytes, size);
+   return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+   p_atomic_inc(&num_allocs);
+   p_atomic_add(&alloc_bytes, nmemb * size);
+   return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+   p_atomic_inc(&num_allocs);
+   p_atomic_add(&alloc_bytes, size);
+   return __libc_realloc(ptr, size);
+}
+#endif
+
+/* Driver profiles.
+ *
+ * The real option structs are filled in by the drivers at screen/device
+ * creation and depend on the GPU, so these copy the subset that changes what
+ * the shared passes do (chiefly nir_opt_algebraic and the loop passes) from
+ * ac_nir_set_options()/si_init_screen_get_functions() for GFX10.3 and from
+ * brw_scalar_nir_options. Keep them roughly in sync when those change.
+ */
+static const nir_shader_compiler_options generic_options = {
+   .max_unroll_iterations = 32,
+};
+
+static const nir_shader_compiler_options radeonsi_options = {
+   .vertex_id_zero_based = true,
+   .lower_scmp = true,
+   .lower_flrp16 = true,
+   .lower_flrp32 = true,
+   .lower_flrp64 = true,
+   .lower_device_index_to_zero = true,
+   .lower_fdiv = true,
+   .lower_fmod = true,
+   .lower_ineg = true,
+   .lower_bitfield_insert = true,
+   .lower_bitfield_extract = true,
+   .lower_pack_snorm_4x8 = true,
+   .lower_pack_unorm_4x8 = true,
+   .lower_pack_half_2x16 = true,
+   .lower_pack_64_2x32 = true,
+   .lower_pack_64_4x16 = true,
+   .lower_pack_32_2x16 = true,
+   .lower_unpack_snorm_2x16 = true,
+   .lower_unpack_snorm_4x8 = true,
+   .lower_unpack_unorm_2x16 = true,
+   .lower_unpack_unorm_4x8 = true,
+   .lower_unpack_half_2x16 = true,
+   .lower_fpow = true,
+   .lower_mul_2x32_64 = true,
+   .lower_hadd = true,
+   .lower_mul_32x16 = true,
+   .lower_fisnormal = true,
+   .lower_ffma16 = false,
+   .lower_ffma32 = false,
+   .fuse_ffma16 = true,
+   .fuse_ffma32 = true,
+   .fuse_ffma64 = true,
+   .has_bfe = true,
+   .has_bfm = true,
+   .has_bitfield_select = true,
+   .has_fneo_fcmpu = true,
+   .has_ford_funord = true,
+   .has_fsub = true,
+   .has_isub = true,
+   .has_find_msb_rev = true,
+   .has_pack_32_4x8 = true,
+   .has_pack_half_2x16_rtz = true,
+   .has_bit_test = true,
+   .has_fmulz = true,
+   .has_msad = true,
+   .has_shfr32 = true,
+   .lower_int64_options = nir_lower_imul64 | nir_lower_imul_high64 |
+                          nir_lower_imul_2x32_64 | nir_lower_divmod64 |
+                          nir_lower_minmax64 | nir_lower_iabs64 |
+                          nir_lower_iadd_sat64 | nir_lower_conv64,
+   .support_16bit_alu = true,
+   .vectorize_vec2_16bit = true,
+   .discard_is_demote = true,
+   .lower_uniforms_to_ubo = true,
+   .lower_to_scalar = true,
+   .max_unroll_iterations = 128,
+   .max_unroll_iterations_aggressive = 128,
+};
+
+static const nir_shader_compiler_options anv_options = {
+   .force_indirect_unrolling = nir_var_function_temp,
+   .has_bfe = true,
+   .has_bfi = true,
+   .has_bfm = true,
+   .has_pack_32_4x8 = true,
+   .has_uclz = true,
+   .lower_base_vertex = true,
+   .lower_bitfield_extract = true,
+   .lower_bitfield_insert = true,
+   .lower_device_index_to_zero = true,
+   .lower_fdiv = true,
+   .lower_fisnormal = true,
+   .lower_flrp16 = true,
+   .lower_flrp64 = true,
+   .lower_fmod = true,
+   .lower_hadd64 = true,
+   .lower_insert_byte = true,
+   .lower_insert_word = true,
+   .lower_isign = true,
+   .lower_ldexp = true,
+   .lower_pack_half_2x16 = true,
+   .lower_pack_snorm_2x16 = true,
+   .lower_pack_snorm_4x8 = true,
+   .lower_pack_unorm_2x16 = true,
+   .lower_pack_unorm_4x8 = true,
+   .lower_pack_64_4x16 = true,
+   .lower_scmp = true,
+   .lower_to_scalar = true,
+   .lower_uadd_carry = true,
+   .lower_ufind_msb = true,
+   .lower_uniforms_to_ubo = true,
+   .lower_unpack_half_2x16 = true,
+   .lower_unpack_snorm_2x16 = true,
+   .lower_unpack_snorm_4x8 = true,
+   .lower_unpack_unorm_2x16 = true,
+   .lower_unpack_unorm_4x8 = true,
+   .lower_usub_borrow = true,
+   .max_unroll_iterations = 32,
+   .support_16bit_alu = true,
+   .vectorize_tess_levels = true,
+   .vertex_id_zero_based = true,
+   .scalarize_ddx = true,
+};
+
+static const struct {
+   const char *name;
+   const nir_shader_compiler_options *options;
+} profiles[] = {
+   { "generic", &generic_options },
+   { "radeonsi", &radeonsi_options },
+   { "anv", &anv_options },
+};
+
+/* Passes which take arguments are wrapped with the arguments drivers most
+ * commonly use.
+ */
+static bool
+opt_if(nir_shader *nir)
+{
+   return nir_opt_if(nir, nir_opt_if_optimize_phi_true_false);
+}
+
+static bool
+opt_peephole_select(nir_shader *nir)
+{
+   const nir_opt_peephole_select_options options = {
+      .limit = 8,
+      .indirect_load_ok = true,
+      .expensive_alu_ok = true,
+   };
+   return nir_opt_peephole_select(nir, &options);
+}
+
+static bool
+opt_gcm(nir_shader *nir)
+{
+   return nir_opt_gcm(nir, true);
+}
+
+static bool
+opt_sink(nir_shader *nir)
+{
+   return nir_opt_sink(nir, nir_move_const_undef | nir_move_load_ubo |
+                               nir_move_load_input | nir_move_comparisons |
+                               nir_move_copies);
+}
+
+static bool
+opt_move(nir_shader *nir)
+{
+   return nir_opt_move(nir, nir_move_const_undef | nir_move_load_ubo |
+                               nir_move_load_input | nir_move_comparisons |
+                               nir_move_copies);
+}
+
+static bool
+opt_shrink_vectors(nir_shader *nir)
+{
+   return nir_opt_shrink_vectors(nir, true);
+}
+
+static bool
+lower_alu_to_scalar(nir_shader *nir)
+{
+   return nir_lower_alu_to_scalar(nir, NULL, NULL);
+}
+
+static bool
+lower_phis_to_scalar(nir_shader *nir)
+{
+   return nir_lower_phis_to_scalar(nir, false);
+}
+
+#define PASS(name) { #name, name }
+#define WRAPPED_PASS(name) { "nir_" #name, name }
+
+static const struct bench_pass {
+   const char *name;
+   bool (*run)(nir_shader *nir);
+} passes[] = {
+   PASS(nir_copy_prop),
+   PASS(nir_lower_alu),
+   PASS(nir_lower_int64),
+   PASS(nir_lower_pack),
+   PASS(nir_lower_vars_to_ssa),
+   PASS(nir_opt_algebraic),
+   PASS(nir_opt_algebraic_late),
+   PASS(nir_opt_constant_folding),
+   PASS(nir_opt_copy_prop_vars),
+   PASS(nir_opt_cse),
+   PASS(nir_opt_dce),
+   PASS(nir_opt_dead_cf),
+   PASS(nir_opt_dead_write_vars),
+   PASS(nir_opt_deref),
+   PASS(nir_opt_find_array_copies),
+   PASS(nir_opt_intrinsics),
+   PASS(nir_opt_loop),
+   PASS(nir_opt_loop_unroll),
+   PASS(nir_opt_phi_precision),
+   PASS(nir_opt_remove_phis),
+   PASS(nir_opt_undef),
+   WRAPPED_PASS(lower_alu_to_scalar),
+   WRAPPED_PASS(lower_phis_to_scalar),
+   WRAPPED_PASS(opt_gcm),
+   WRAPPED_PASS(opt_if),
+   WRAPPED_PASS(opt_move),
+   WRAPPED_PASS(opt_peephole_select),
+   WRAPPED_PASS(opt_shrink_vectors),
+   WRAPPED_PASS(opt_sink),
+};
+
+/* Roughly the optimization loop of gl_nir_opts() and most drivers. */
+static const char *default_pipeline =
+   "nir_lower_vars_to_ssa,"
+   "loop(nir_copy_prop,nir_opt_remove_phis,nir_opt_dce,nir_opt_cse,"
+   "nir_opt_if,nir_opt_dead_cf,nir_opt_peephole_select,nir_opt_algebraic,"
+   "nir_opt_constant_folding,nir_opt_undef,nir_opt_loop,nir_opt_loop_unroll),"
+   "nir_opt_algebraic_late,nir_copy_prop,nir_opt_dce,nir_opt_sink,"
+   "nir_opt_move";
+
+struct step {
+   const struct bench_pass *pass;
+
+   /* Steps with the same non-negative loop index form one loop. */
+   int loop;
+
+   uint64_t runs;
+   uint64_t progress;
+   uint64_t time_ns;
+   uint64_t allocs;
+   uint64_t bytes;
+   int64_t instr_delta;
+};
+
+static const struct bench_pass *
+find_pass(const char *name, size_t len)
+{
+   for (unsigned i = 0; i < ARRAY_SIZE(passes); i++) {
+      if (strlen(passes[i].name) == len && !strncmp(passes[i].name, name, len))
+         return &passes[i];
+   }
+   return NULL;
+}
+
+static bool
+parse_pipeline(const char *str, struct util_dynarray *steps)
+{
+   int num_loops = 0;
+   int loop = -1;
+
+   while (*str) {
+      if (!strncmp(str, "loop(", 5)) {
+         if (loop >= 0) {
+            fprintf(stderr, "nir_bench: nested loops are not supported\n");
+            return false;
+         }
+         loop = num_loops++;
+         str += 5;
+         continue;
+      }
+
+      size_t len = strcspn(str, ",)");
+      if (len) {
+         const struct bench_pass *pass = find_pass(str, len);
+         if (!pass) {
+            fprintf(stderr, "nir_bench: unknown pass '%.*s'\n", (int)len, str);
+            return false;
+         }
+
+         struct step step = { .pass = pass, .loop = loop };
+         util_dynarray_append(steps, struct step, step);
+         str += len;
+      }
+
+      if (*str == ')') {
+         if (loop < 0) {
+            fprintf(stderr, "nir_bench: unbalanced ')' in pipeline\n");
+            return false;
+         }
+         loop = -1;
+         str++;
+      }
+      if (*str == ',')
+         str++;
+   }
+
+   if (loop >= 0) {
+      fprintf(stderr, "nir_bench: unterminated loop in pipeline\n");
+      return false;
+   }
+
+   return true;
+}
+
+static unsigned
+count_instrs(nir_shader *nir)
+{
+   unsigned count = 0;
+   nir_foreach_function_impl(impl, nir) {
+      nir_foreach_block(block, impl) {
+         nir_foreach_instr(instr, block)
+            count++;
+      }
+   }
+   return count;
+}
+
+static bool
+run_step(nir_shader *nir, struct step *step)
+{
+   unsigned instrs_before = count_instrs(nir);
+   uint64_t allocs_before = p_atomic_read(&num_allocs);
+   uint64_t bytes_before = p_atomic_read(&alloc_bytes);
+   int64_t start = os_time_get_nano();
+
+   bool progress = step->pass->run(nir);
+
+   step->time_ns += os_time_get_nano() - start;
+   step->allocs += p_atomic_read(&num_allocs) - allocs_before;
+   step->bytes += p_atomic_read(&alloc_bytes) - bytes_before;
+   step->instr_delta += (int64_t)count_instrs(nir) - instrs_before;
+   step->runs++;
+   step->progress += progress;
+
+   nir_validate_shader(nir, step->pass->name);
+
+   return progress;
+}
+
+static void
+run_pipeline(nir_shader *nir, struct step *steps, unsigned num_steps)
+{
+   for (unsigned i = 0; i < num_steps;) {
+      if (steps[i].loop < 0) {
+         run_step(nir, &steps[i++]);
+         continue;
+      }
+
+      unsigned end = i;
+      while (end < num_steps && steps[end].loop == steps[i].loop)
+         end++;
+
+      /* Bound the loop like the drivers' optimization loops are expected to
+       * terminate, so that a pass pair undoing each other doesn't hang the
+       * benchmark.
+       */
+      bool progress;
+      unsigned iterations = 0;
+      do {
+         progress = false;
+         for (unsigned j = i; j < end; j++)
+            progress |= run_step(nir, &steps[j]);
+      } while (progress && ++iterations < 1000);
+
+      i = end;
+   }
+}
+
+static void
+print_json_string(const char *str)
+{
+   putchar('"');
+   for (; str && *str; str++) {
+      if (*str == '"' || *str == '\\')
+         printf("\\%c", *str);
+      else if ((unsigned char)*str < 0x20)
+         printf("\\u%04x", *str);
+      else
+         putchar(*str);
+   }
+   putchar('"');
+}
+
+static bool
+bench_file(const char *filename, const nir_shader_compiler_options *options,
+           struct util_dynarray *pipeline, unsigned iterations, bool first)
+{
+   size_t size;
+   char *data = os_read_file(filename, &size);
+   if (!data) {
+      fprintf(stderr, "nir_bench: failed to read '%s'\n", filename);
+      return false;
+   }
+
+   unsigned num_steps = util_dynarray_num_elements(pipeline, struct step);
+   struct step *steps = malloc(num_steps * sizeof(*steps));
+   memcpy(steps, pipeline->data, num_steps * sizeof(*steps));
+
+   unsigned instrs_before = 0, instrs_after = 0;
+   gl_shader_stage stage = MESA_SHADER_NONE;
+   char *name = NULL;
+   bool ok = true;
+
+   for (unsigned i = 0; i < iterations; i++) {
+      struct blob_reader blob;
+      blob_reader_init(&blob, data, size);
+
+      nir_shader *nir = nir_deserialize(NULL, options, &blob);
+      if (!nir || blob.overrun) {
+         fprintf(stderr, "nir_bench: '%s' is not a serialized NIR shader\n",
+                 filename);
+         ralloc_free(nir);
+         ok = false;
+         break;
+      }
+
+      if (i == 0) {
+         stage = nir->info.stage;
+         name = nir->info.name ? strdup(nir->info.name) : NULL;
+         instrs_before = count_instrs(nir);
+      }
+
+      run_pipeline(nir, steps, num_steps);
+
+      instrs_after = count_instrs(nir);
+      ralloc_free(nir);
+   }
+
+   if (ok) {
+      printf("%s    {\n", first ? "" : ",\n");
+      printf("      \"file\": ");
+      print_json_string(filename);
+      printf(",\n      \"name\": ");
+      print_json_string(name);
+      printf(",\n      \"stage\": ");
+      print_json_string(gl_shader_stage_name(stage));
+      printf(",\n      \"instrs_before\": %u,\n", instrs_before);
+      printf("      \"instrs_after\": %u,\n", instrs_after);
+      printf("      \"passes\": [\n");
+      for (unsigned i = 0; i < num_steps; i++) {
+         const struct step *s = &steps[i];
+         printf("        { \"pass\": \"%s\", \"loop\": %d, "
+                "\"runs\": %.2f, \"progress\": %.2f, \"time_ns\": %" PRIu64 ", "
+                "\"allocs\": %" PRIu64 ", \"alloc_bytes\": %" PRIu64 ", "
+                "\"instr_delta\": %" PRId64 " }%s\n",
+                s->pass->name, s->loop,
+                (double)s->runs / iterations, (double)s->progress / iterations,
+                s->time_ns / iterations, s->allocs / iterations,
+                s->bytes / iterations, s->instr_delta / (int64_t)iterations,
+                i + 1 < num_steps ? "," : "");
+      }
+      printf("      ]\n    }");
+   }
+
+   free(name);
+   free(steps);
+   free(data);
+   return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+   const nir_shader_compiler_options *options = &generic_options;
+   const char *profile = "generic";
+   const char *pipeline_str = default_pipeline;
+   unsigned iterations = 10;
+
+   static const struct option long_options[] = {
+      { "help", no_argument, NULL, 'h' },
+      { "iterations", required_argument, NULL, 'n' },
+      { "driver", required_argument, NULL, 'd' },
+      { "pipeline", required_argument, NULL, 'p' },
+      { "list", no_argument, NULL, 'l' },
+      { NULL, 0, NULL, 0 },
+   };
+
+   int c;
+   while ((c = getopt_long(argc, argv, "hn:d:p:l", long_options, NULL)) != -1) {
+      switch (c) {
+      case 'h':
+         printf(help_message, argv[0]);
+         return 0;
+      case 'n':
+         iterations = MAX2(atoi(optarg), 1);
+         break;
+      case 'd':
+         options = NULL;
+         for (unsigned i = 0; i < ARRAY_SIZE(profiles); i++) {
+            if (!strcmp(optarg, profiles[i].name))
+               options = profiles[i].options;
+         }
+         if (!options) {
+            fprintf(stderr, "nir_bench: unknown driver profile '%s'\n", optarg);
+            return 1;
+         }
+         profile = optarg;
+         break;
+      case 'p':
+         pipeline_str = optarg;
+         break;
+      case 'l':
+         for (unsigned i = 0; i < ARRAY_SIZE(passes); i++)
+            printf("%s\n", passes[i].name);
+         return 0;
+      default:
+         fprintf(stderr, help_message, argv[0]);
+         return 1;
+      }
+   }
+
+   if (optind >= argc) {
+      fprintf(stderr, help_message, argv[0]);
+      return 1;
+   }
+
+   struct util_dynarray pipeline;
+   util_dynarray_init(&pipeline, NULL);
+   if (!parse_pipeline(pipeline_str, &pipeline))
+      return 1;
+
+   glsl_type_singleton_init_or_ref();
+
+   printf("{\n  \"driver\": ");
+   print_json_string(profile);
+   printf(",\n  \"iterations\": %u,\n  \"pipeline\": ", iterations);
+   print_json_string(pipeline_str);
+   printf(",\n  \"shaders\": [\n");
+
+   bool first = true;
+   int ret = 0;
+   for (int i = optind; i < argc; i++) {
+      if (bench_file(argv[i], options, &pipeline, iterations, first))
+         first = false;
+      else
+         ret = 1;
+   }
+
+   printf("\n  ]\n}\n");
+
+   glsl_type_singleton_decref();
+   util_dynarray_fini(&pipeline);
+
+   return ret;
+}
@@ -100,6 +100,7 @@ nir_serialize_test::ASSERT_SWIZZLE_EQ(nir_alu_instr *a, nir_alu_instr *b, unsign
 
 class nir_serialize_all_test : public nir_serialize_test {};
 class nir_serialize_all_but_one_test : public nir_serialize_test {};
+class nir_serialize_view_test : public nir_serialize_test {};
 
 } // namespace
 
@@ -195,3 +196,37 @@ TEST_P(nir_serialize_all_but_one_test, single_channel)
 
    ASSERT_SWIZZLE_EQ(vec_alu, vec_alu_dup, 1, 0);
 }
+
+TEST_F(nir_serialize_view_test, materialize)
+{
+   static const uint32_t data[] = { 1, 2, 3, 4 };
+   nir_variable *var = nir_variable_create(b->shader, nir_var_mem_ssbo,
+                                           glsl_uint_type(), "ssbo_var");
+   b->shader->constant_data = ralloc_memdup(b->shader, data, sizeof(data));
+   b->shader->constant_data_size = sizeof(data);
+
+   struct blob blob;
+   struct blob_reader reader;
+
+   blob_init(&blob);
+   nir_serialize(&blob, b->shader, false);
+   blob_reader_init(&reader, blob.data, blob.size);
+   dup = nir_deserialize_view(b->shader, &options, &reader);
+
+   nir_variable *var_dup = nir_find_variable_with_location(dup, nir_var_mem_ssbo,
+                                                          var->data.location);
+   ASSERT_TRUE(dup->is_view);
+   ASSERT_GE((uint8_t *)var_dup->name, blob.data);
+   ASSERT_LT((uint8_t *)var_dup->name, blob.data + blob.size);
+   ASSERT_GE((uint8_t *)dup->constant_data, blob.data);
+   ASSERT_LT((uint8_t *)dup->constant_data, blob.data + blob.size);
+
+   nir_shader_materialize(dup);
+   blob_finish(&blob);
+
+   ASSERT_FALSE(dup->is_view);
+   ASSERT_STREQ(var_dup->name, "ssbo_var");
+   ASSERT_STREQ(dup->info.name, b->shader->info.name);
+   ASSERT_EQ(memcmp(dup->constant_data, data, sizeof(data)), 0);
+   nir_validate_shader(dup, "materialized");
+}
@@ -1899,24 +1899,32 @@ vtn_handle_type(struct vtn_builder *b, SpvOp opcode,
       NIR_VLA(struct glsl_struct_field, fields, count);
       for (unsigned i = 0; i < num_fields; i++) {
          val->type->members[i] = vtn_get_type(b, w[i + 2]);
-         const char *name = NULL;
-         for (struct vtn_decoration *dec = val->decoration; dec; dec = dec->next) {
-            if (dec->scope == VTN_DEC_STRUCT_MEMBER_NAME0 - i) {
-               name = dec->member_name;
-               break;
-            }
-         }
-         if (!name)
-            name = ralloc_asprintf(b, "field%d", i);
-
          fields[i] = (struct glsl_struct_field) {
             .type = val->type->members[i]->type,
-            .name = name,
             .location = -1,
             .offset = -1,
          };
       }
 
+      /* Look up all the member names in a single walk over the decorations
+       * rather than one per member, which is quadratic for wide structs.
+       * Decorations are prepended, so the first name found for a member
+       * is the last one that was declared.
+       */
+      for (struct vtn_decoration *dec = val->decoration; dec; dec = dec->next) {
+         if (dec->scope > VTN_DEC_STRUCT_MEMBER_NAME0)
+            continue;
+
+         unsigned member = VTN_DEC_STRUCT_MEMBER_NAME0 - dec->scope;
+         if (member < num_fields && !fields[member].name)
+            fields[member].name = dec->member_name;
+      }
+
+      for (unsigned i = 0; i < num_fields; i++) {
+         if (!fields[i].name)
+            fields[i].name = ralloc_asprintf(b, "field%d", i);
+      }
+
       vtn_foreach_decoration(b, val, struct_packed_decoration_cb, NULL);
 
       struct member_decoration_ctx ctx = {
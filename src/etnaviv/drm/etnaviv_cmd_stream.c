@@ -178,18 +178,26 @@ static uint32_t bo2idx(struct etna_cmd_stream *stream, struct etna_bo *bo,
 		uint32_t flags)
 {
 	struct etna_cmd_stream_priv *priv = etna_cmd_stream_priv(stream);
-	uint32_t hash = _mesa_hash_pointer(bo);
-	struct hash_entry *entry;
 	uint32_t idx;
 
-	entry = _mesa_hash_table_search_pre_hashed(priv->bo_table, hash, bo);
-
-	if (entry) {
-		idx = (uint32_t)(uintptr_t)entry->data;
+	if (priv->last_bo_idx < priv->nr_bos &&
+	    priv->bos[priv->last_bo_idx] == bo) {
+		idx = priv->last_bo_idx;
 	} else {
-		idx = append_bo(stream, bo);
-		_mesa_hash_table_insert_pre_hashed(priv->bo_table, hash, bo,
-			(void *)(uintptr_t)idx);
+		uint32_t hash = _mesa_hash_pointer(bo);
+		struct hash_entry *entry;
+
+		entry = _mesa_hash_table_search_pre_hashed(priv->bo_table, hash, bo);
+
+		if (entry) {
+			idx = (uint32_t)(uintptr_t)entry->data;
+		} else {
+			idx = append_bo(stream, bo);
+			_mesa_hash_table_insert_pre_hashed(priv->bo_table, hash, bo,
+				(void *)(uintptr_t)idx);
+		}
+
+		priv->last_bo_idx = idx;
 	}
 
 	if (flags & ETNA_RELOC_READ)
@@ -161,6 +161,11 @@ struct etna_cmd_stream_priv {
 	void *force_flush_priv;
 
 	void *bo_table;
+
+	/* index of the bo that was referenced last, consecutive relocs (e.g.
+	 * the mip levels of a texture) tend to point into the same bo:
+	 */
+	uint32_t last_bo_idx;
 };
 
 struct etna_perfmon {
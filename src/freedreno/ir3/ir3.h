@@ -13,6 +13,7 @@
 
 #include "util/bitscan.h"
 #include "util/list.h"
+#include "util/perf/cpu_trace.h"
 #include "util/set.h"
 #include "util/u_debug.h"
 
@@ -2111,6 +2112,7 @@ __ssa_srcp_n(struct ir3_instruction *instr, unsigned n)
 
 #define IR3_PASS(ir, pass, ...)                                                \
    ({                                                                          \
+      MESA_TRACE_SCOPE(#pass);                                                 \
       bool progress = pass(ir, ##__VA_ARGS__);                                 \
       if (progress) {                                                          \
          ir3_debug_print(ir, "AFTER: " #pass);                                 \
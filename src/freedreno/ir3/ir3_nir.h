@@ -133,8 +133,9 @@ nir_def *ir3_load_driver_ubo_indirect(nir_builder *b, unsigned components,
 bool ir3_def_is_rematerializable_for_preamble(nir_def *def,
                                               nir_def **preamble_defs);
 
+struct nir_instr_set;
 nir_def *ir3_rematerialize_def_for_preamble(nir_builder *b, nir_def *def,
-                                            struct set *instr_set,
+                                            struct nir_instr_set *instr_set,
                                             nir_def **preamble_defs);
 
 struct driver_param_info {
@@ -416,7 +416,7 @@ dominates(const nir_instr *old_instr, const nir_instr *new_instr)
 
 static nir_def *
 _rematerialize_def(nir_builder *b, struct hash_table *remap_ht,
-                   struct set *instr_set, nir_def **preamble_defs,
+                   struct nir_instr_set *instr_set, nir_def **preamble_defs,
                    nir_def *def)
 {
    if (_mesa_hash_table_search(remap_ht, def->parent_instr))
@@ -489,7 +489,7 @@ _rematerialize_def(nir_builder *b, struct hash_table *remap_ht,
 
 nir_def *
 ir3_rematerialize_def_for_preamble(nir_builder *b, nir_def *def,
-                                   struct set *instr_set,
+                                   struct nir_instr_set *instr_set,
                                    nir_def **preamble_defs)
 {
    struct hash_table *remap_ht = _mesa_pointer_hash_table_create(NULL);
@@ -661,7 +661,7 @@ ir3_nir_opt_prefetch_descriptors(nir_shader *nir, struct ir3_shader_variant *v)
    const struct ir3_const_state *const_state = ir3_const_state(v);
 
    nir_function_impl *main = nir_shader_get_entrypoint(nir);
-   struct set *instr_set = nir_instr_set_create(NULL);
+   struct nir_instr_set *instr_set = nir_instr_set_create(NULL);
    nir_function_impl *preamble = main->preamble ? main->preamble->impl : NULL;
    nir_builder b;
    bool progress = false;
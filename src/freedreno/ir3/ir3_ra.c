@@ -2612,6 +2612,8 @@ calc_limit_pressure_for_cs_with_barrier(struct ir3_shader_variant *v,
 int
 ir3_ra(struct ir3_shader_variant *v)
 {
+   MESA_TRACE_FUNC();
+
    ir3_calc_dominance(v->ir);
 
    /* Predicate RA needs dominance. */
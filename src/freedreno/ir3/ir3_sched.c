@@ -1248,6 +1248,8 @@ sched_block(struct ir3_sched_ctx *ctx, struct ir3_block *block)
 int
 ir3_sched(struct ir3 *ir)
 {
+   MESA_TRACE_FUNC();
+
    struct ir3_sched_ctx *ctx = rzalloc(NULL, struct ir3_sched_ctx);
 
    ctx->compiler = ir->compiler;
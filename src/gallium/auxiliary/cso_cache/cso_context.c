@@ -47,6 +47,7 @@
 #include "cso_cache/cso_context.h"
 #include "cso_cache/cso_cache.h"
 #include "cso_cache/cso_hash.h"
+#include "cso_cache/cso_shared_cache.h"
 #include "cso_context.h"
 #include "driver_trace/tr_dump.h"
 #include "util/u_threaded_context.h"
@@ -122,6 +123,11 @@ struct cso_context_priv {
    unsigned min_samples, min_samples_saved;
    struct pipe_stencil_ref stencil_ref, stencil_ref_saved;
 
+   /* Screen-wide cache used instead of the one below for blend, DSA and
+    * rasterizer states, see CSO_SHARE_STATES.
+    */
+   struct cso_shared_cache *shared;
+
    /* This should be last to keep all of the above together in memory. */
    struct cso_cache cache;
 };
@@ -291,6 +297,10 @@ cso_create_context(struct pipe_context *pipe, unsigned flags)
    ctx->base.pipe = pipe;
    ctx->sample_mask = ~0;
 
+   if ((flags & CSO_SHARE_STATES) &&
+       pipe->screen->caps.shareable_state_objects)
+      ctx->shared = cso_shared_cache_acquire(pipe->screen);
+
    if (!(flags & CSO_NO_VBUF))
       cso_init_vbuf(ctx, flags);
 
@@ -481,6 +491,8 @@ cso_destroy_context(struct cso_context *cso)
 
    cso_unbind_context(cso);
    cso_cache_delete(&ctx->cache);
+   if (ctx->shared)
+      cso_shared_cache_release(ctx->shared, ctx->base.pipe);
 
    if (ctx->vbuf)
       u_vbuf_destroy(ctx->vbuf);
@@ -512,6 +524,15 @@ cso_set_blend(struct cso_context *cso,
    struct cso_hash_iter iter;
    void *handle;
 
+   if (ctx->shared) {
+      handle = cso_shared_cache_get(ctx->shared, ctx->base.pipe, CSO_BLEND, templ,
+                                    templ->independent_blend_enable ?
+                                       CSO_BLEND_KEY_SIZE_ALL_RT :
+                                       CSO_BLEND_KEY_SIZE_RT0);
+      if (handle)
+         goto bind;
+   }
+
    if (templ->independent_blend_enable) {
       /* This is duplicated with the else block below because we want key_size
        * to be a literal constant, so that memcpy and the hash computation can
@@ -548,6 +569,7 @@ cso_set_blend(struct cso_context *cso,
       handle = ((struct cso_blend *)cso_hash_iter_data(iter))->data;
    }
 
+bind:
    if (ctx->blend != handle) {
       ctx->blend = handle;
       ctx->base.pipe->bind_blend_state(ctx->base.pipe, handle);
@@ -582,12 +604,18 @@ cso_set_depth_stencil_alpha(struct cso_context *cso,
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
    const unsigned key_size = sizeof(struct pipe_depth_stencil_alpha_state);
    const unsigned hash_key = cso_construct_key(templ, key_size);
-   struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
-                                                       hash_key,
-                                                       CSO_DEPTH_STENCIL_ALPHA,
-                                                       templ, key_size);
+   struct cso_hash_iter iter;
    void *handle;
 
+   if (ctx->shared) {
+      handle = cso_shared_cache_get(ctx->shared, ctx->base.pipe,
+                                    CSO_DEPTH_STENCIL_ALPHA, templ, key_size);
+      if (handle)
+         goto bind;
+   }
+
+   iter = cso_find_state_template(&ctx->cache, hash_key,
+                                  CSO_DEPTH_STENCIL_ALPHA, templ, key_size);
    if (cso_hash_iter_is_null(iter)) {
       struct cso_depth_stencil_alpha *cso =
          MALLOC(sizeof(struct cso_depth_stencil_alpha));
@@ -611,6 +639,7 @@ cso_set_depth_stencil_alpha(struct cso_context *cso,
                 cso_hash_iter_data(iter))->data;
    }
 
+bind:
    if (ctx->depth_stencil != handle) {
       ctx->depth_stencil = handle;
       ctx->base.pipe->bind_depth_stencil_alpha_state(ctx->base.pipe, handle);
@@ -646,10 +675,7 @@ cso_set_rasterizer(struct cso_context *cso,
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
    const unsigned key_size = sizeof(struct pipe_rasterizer_state);
    const unsigned hash_key = cso_construct_key(templ, key_size);
-   struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
-                                                       hash_key,
-                                                       CSO_RASTERIZER,
-                                                       templ, key_size);
+   struct cso_hash_iter iter;
    void *handle = NULL;
 
    /* We can't have both point_quad_rasterization (sprites) and point_smooth
@@ -657,6 +683,15 @@ cso_set_rasterizer(struct cso_context *cso,
     */
    assert(!(templ->point_quad_rasterization && templ->point_smooth));
 
+   if (ctx->shared) {
+      handle = cso_shared_cache_get(ctx->shared, ctx->base.pipe,
+                                    CSO_RASTERIZER, templ, key_size);
+      if (handle)
+         goto bind;
+   }
+
+   iter = cso_find_state_template(&ctx->cache, hash_key,
+                                  CSO_RASTERIZER, templ, key_size);
    if (cso_hash_iter_is_null(iter)) {
       struct cso_rasterizer *cso = MALLOC(sizeof(struct cso_rasterizer));
       if (!cso)
@@ -676,6 +711,7 @@ cso_set_rasterizer(struct cso_context *cso,
       handle = ((struct cso_rasterizer *)cso_hash_iter_data(iter))->data;
    }
 
+bind:
    if (ctx->rasterizer != handle) {
       ctx->rasterizer = handle;
       ctx->flatshade_first = templ->flatshade_first;
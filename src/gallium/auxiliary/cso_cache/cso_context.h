@@ -49,6 +49,10 @@ struct cso_context {
 #define CSO_NO_USER_VERTEX_BUFFERS (1 << 0)
 #define CSO_NO_64B_VERTEX_BUFFERS  (1 << 1)
 #define CSO_NO_VBUF  (1 << 2)
+/* Share blend, DSA and rasterizer CSOs with the other cso_contexts of the
+ * screen that use this flag, if pipe_caps::shareable_state_objects is set.
+ */
+#define CSO_SHARE_STATES  (1 << 3)
 
 struct cso_context *
 cso_create_context(struct pipe_context *pipe, unsigned flags);
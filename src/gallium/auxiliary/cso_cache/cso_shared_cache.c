@@ -0,0 +1,288 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/hash_table.h"
+#include "util/simple_mtx.h"
+#include "util/u_atomic.h"
+#include "util/u_memory.h"
+
+#include "cso_shared_cache.h"
+
+
+#define CSO_SHARED_SHARDS_LOG2 4
+#define CSO_SHARED_SHARDS (1 << CSO_SHARED_SHARDS_LOG2)
+
+/* Matches the 4096 entries a cso_context caches by default. */
+#define CSO_SHARED_MAX_PER_SHARD (4096 / CSO_SHARED_SHARDS)
+
+struct cso_shared_entry {
+   uint32_t hash;
+   uint16_t type;
+   uint16_t key_size;
+   void *data;
+   uint8_t key[];
+};
+
+struct cso_shared_table {
+   /* Smaller tables this one replaced, lookups may still be using them. */
+   struct cso_shared_table *retired;
+   uint32_t mask;
+   struct cso_shared_entry *slots[];
+};
+
+struct cso_shared_shard {
+   simple_mtx_t lock;
+   struct cso_shared_table *table;
+   unsigned count;
+};
+
+struct cso_shared_cache {
+   struct pipe_screen *screen;
+   unsigned refcount;
+   struct cso_shared_shard shards[CSO_SHARED_SHARDS];
+};
+
+static simple_mtx_t caches_lock = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *caches = NULL;
+
+
+struct cso_shared_cache *
+cso_shared_cache_acquire(struct pipe_screen *screen)
+{
+   struct cso_shared_cache *cache = NULL;
+
+   simple_mtx_lock(&caches_lock);
+
+   if (!caches)
+      caches = _mesa_pointer_hash_table_create(NULL);
+   if (!caches)
+      goto out;
+
+   struct hash_entry *entry = _mesa_hash_table_search(caches, screen);
+   if (entry) {
+      cache = entry->data;
+      cache->refcount++;
+      goto out;
+   }
+
+   cache = CALLOC_STRUCT(cso_shared_cache);
+   if (!cache)
+      goto out;
+
+   cache->screen = screen;
+   cache->refcount = 1;
+   for (unsigned i = 0; i < CSO_SHARED_SHARDS; i++)
+      simple_mtx_init(&cache->shards[i].lock, mtx_plain);
+
+   _mesa_hash_table_insert(caches, screen, cache);
+
+out:
+   simple_mtx_unlock(&caches_lock);
+   return cache;
+}
+
+
+static void *
+create_state(struct pipe_context *pipe, enum cso_cache_type type,
+             const void *templ, unsigned key_size)
+{
+   switch (type) {
+   case CSO_BLEND: {
+      /* The key may only cover the first render target. */
+      struct pipe_blend_state state;
+
+      memset(&state, 0, sizeof(state));
+      memcpy(&state, templ, key_size);
+      return pipe->create_blend_state(pipe, &state);
+   }
+   case CSO_DEPTH_STENCIL_ALPHA:
+      return pipe->create_depth_stencil_alpha_state(pipe, templ);
+   case CSO_RASTERIZER:
+      return pipe->create_rasterizer_state(pipe, templ);
+   default:
+      unreachable("CSO type isn't shared");
+   }
+}
+
+
+static void
+delete_state(struct pipe_context *pipe, enum cso_cache_type type, void *data)
+{
+   switch (type) {
+   case CSO_BLEND:
+      pipe->delete_blend_state(pipe, data);
+      break;
+   case CSO_DEPTH_STENCIL_ALPHA:
+      pipe->delete_depth_stencil_alpha_state(pipe, data);
+      break;
+   case CSO_RASTERIZER:
+      pipe->delete_rasterizer_state(pipe, data);
+      break;
+   default:
+      unreachable("CSO type isn't shared");
+   }
+}
+
+
+/**
+ * Drop a reference to the cache.  The last one deletes all the CSOs through
+ * pipe, which mustn't have any of them bound anymore.
+ */
+void
+cso_shared_cache_release(struct cso_shared_cache *cache,
+                         struct pipe_context *pipe)
+{
+   simple_mtx_lock(&caches_lock);
+   if (--cache->refcount) {
+      simple_mtx_unlock(&caches_lock);
+      return;
+   }
+
+   _mesa_hash_table_remove_key(caches, cache->screen);
+   if (!_mesa_hash_table_num_entries(caches)) {
+      _mesa_hash_table_destroy(caches, NULL);
+      caches = NULL;
+   }
+   simple_mtx_unlock(&caches_lock);
+
+   for (unsigned i = 0; i < CSO_SHARED_SHARDS; i++) {
+      struct cso_shared_shard *shard = &cache->shards[i];
+      struct cso_shared_table *table = shard->table;
+
+      if (table) {
+         for (unsigned j = 0; j <= table->mask; j++) {
+            struct cso_shared_entry *entry = table->slots[j];
+
+            if (entry) {
+               delete_state(pipe, entry->type, entry->data);
+               FREE(entry);
+            }
+         }
+      }
+
+      while (table) {
+         struct cso_shared_table *retired = table->retired;
+         FREE(table);
+         table = retired;
+      }
+
+      simple_mtx_destroy(&shard->lock);
+   }
+
+   FREE(cache);
+}
+
+
+static struct cso_shared_entry *
+lookup(struct cso_shared_table *table, uint32_t hash, enum cso_cache_type type,
+       const void *templ, unsigned key_size)
+{
+   /* Tables are at most half full, so this always reaches an empty slot. */
+   for (uint32_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+      struct cso_shared_entry *entry = p_atomic_read(&table->slots[i]);
+
+      if (!entry)
+         return NULL;
+
+      if (entry->hash == hash && entry->type == type &&
+          entry->key_size == key_size && !memcmp(entry->key, templ, key_size))
+         return entry;
+   }
+}
+
+
+static void
+insert(struct cso_shared_table *table, struct cso_shared_entry *entry)
+{
+   uint32_t i = entry->hash & table->mask;
+
+   while (table->slots[i])
+      i = (i + 1) & table->mask;
+
+   /* Publishes the filled in entry to lookups in other threads. */
+   p_atomic_set(&table->slots[i], entry);
+}
+
+
+/* Called with the shard lock held. */
+static struct cso_shared_table *
+grow(struct cso_shared_shard *shard)
+{
+   struct cso_shared_table *old = shard->table;
+   unsigned size = old ? (old->mask + 1) * 2 : 16;
+   struct cso_shared_table *table =
+      CALLOC(1, sizeof(*table) + size * sizeof(table->slots[0]));
+
+   if (!table)
+      return NULL;
+
+   table->mask = size - 1;
+   table->retired = old;
+   if (old) {
+      for (unsigned i = 0; i <= old->mask; i++) {
+         if (old->slots[i])
+            insert(table, old->slots[i]);
+      }
+   }
+
+   p_atomic_set(&shard->table, table);
+   return table;
+}
+
+
+/**
+ * Return the driver CSO for the first key_size bytes of templ, creating it
+ * through pipe if it's not cached yet.  Returns NULL if the cache is full or
+ * out of memory, callers should then use their own cache.
+ */
+void *
+cso_shared_cache_get(struct cso_shared_cache *cache, struct pipe_context *pipe,
+                     enum cso_cache_type type, const void *templ,
+                     unsigned key_size)
+{
+   uint32_t hash = _mesa_hash_data(templ, key_size) ^ (type * 0x9e3779b9);
+   struct cso_shared_shard *shard =
+      &cache->shards[hash >> (32 - CSO_SHARED_SHARDS_LOG2)];
+   struct cso_shared_table *table = p_atomic_read(&shard->table);
+   struct cso_shared_entry *entry;
+
+   if (table) {
+      entry = lookup(table, hash, type, templ, key_size);
+      if (entry)
+         return entry->data;
+   }
+
+   simple_mtx_lock(&shard->lock);
+
+   /* Somebody else may have added it in the meantime. */
+   table = shard->table;
+   entry = table ? lookup(table, hash, type, templ, key_size) : NULL;
+
+   if (!entry && shard->count < CSO_SHARED_MAX_PER_SHARD) {
+      if (!table || (shard->count + 1) * 2 > table->mask + 1)
+         table = grow(shard);
+
+      entry = table ? MALLOC(sizeof(*entry) + key_size) : NULL;
+      if (entry) {
+         entry->hash = hash;
+         entry->type = type;
+         entry->key_size = key_size;
+         memcpy(entry->key, templ, key_size);
+         entry->data = create_state(pipe, type, templ, key_size);
+
+         if (entry->data) {
+            insert(table, entry);
+            shard->count++;
+         } else {
+            FREE(entry);
+            entry = NULL;
+         }
+      }
+   }
+
+   simple_mtx_unlock(&shard->lock);
+
+   return entry ? entry->data : NULL;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Screen-wide cache of blend, depth/stencil/alpha and rasterizer CSOs that
+ * all cso_contexts of a screen can share, see CSO_SHARE_STATES.
+ *
+ * The cache is split into shards by hash, each an open addressing table
+ * that is only ever appended to.  Lookups don't take any lock, inserts take
+ * the lock of their shard.  Entries live until the last cso_context using
+ * the cache goes away, and a shard stops accepting entries when it is full
+ * so that applications creating endless unique states fall back to the
+ * per-context cache and its eviction.
+ */
+
+#ifndef CSO_SHARED_CACHE_H
+#define CSO_SHARED_CACHE_H
+
+#include "cso_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct cso_shared_cache;
+
+struct cso_shared_cache *
+cso_shared_cache_acquire(struct pipe_screen *screen);
+
+void
+cso_shared_cache_release(struct cso_shared_cache *cache,
+                         struct pipe_context *pipe);
+
+void *
+cso_shared_cache_get(struct cso_shared_cache *cache, struct pipe_context *pipe,
+                     enum cso_cache_type type, const void *templ,
+                     unsigned key_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,10 +30,12 @@
  * @file
  * Trace dumping functions.
  *
- * For now we just use standard XML for dumping the trace calls, as this is
- * simple to write, parse, and visually inspect, but the actual representation
- * is abstracted out of this file, so that we can switch to a binary
- * representation if/when it becomes justified.
+ * By default we use standard XML for dumping the trace calls, as this is
+ * simple to write, parse, and visually inspect.  GALLIUM_TRACE_BINARY selects
+ * a compact binary representation instead, which is buffered, optionally
+ * compressed, and written out on a separate thread, see the "binary
+ * format" section below.  src/gallium/tools/trace/binary2xml.py converts it
+ * back to XML.
  *
  * @author Jose Fonseca <jfonseca@vmware.com>
  */
@@ -49,6 +51,11 @@
 #endif
 
 #include "util/compiler.h"
+#include "util/compress.h"
+#include "util/hash_table.h"
+#include "util/memstream.h"
+#include "util/ralloc.h"
+#include "util/u_queue.h"
 #include "util/u_thread.h"
 #include "util/os_time.h"
 #include "util/simple_mtx.h"
@@ -74,6 +81,9 @@ static long nir_count = 0;
 static bool trigger_active = true;
 static char *trigger_filename = NULL;
 
+static bool binary = false;
+static bool compress = false;
+
 void
 trace_dump_trigger_active(bool active)
 {
@@ -207,10 +217,286 @@ trace_dump_tag_end(const char *name)
    trace_dump_writes(">");
 }
 
+/*
+ * Binary format
+ *
+ * The file starts with the TRACE_BIN_MAGIC string, followed by the format
+ * version and the TRACE_BIN_FILE_* flags as little endian 32-bit words.
+ * Then come chunks, each a 32-bit uncompressed size, a 32-bit stored size
+ * with TRACE_BIN_CHUNK_COMPRESSED set if the data was compressed, and the
+ * data.  The uncompressed chunks concatenated form one stream of
+ * trace_bin_op tokens, which map one to one to the XML elements.
+ *
+ * Numbers and lengths are LEB128 varints, signed ones zigzag encoded,
+ * floats are little endian doubles.  Names (classes, methods, arguments,
+ * struct members and enums) are sent once as TRACE_BIN_NAME and referred
+ * to by index afterwards.
+ */
+
+#define TRACE_BIN_MAGIC "GALTRACE"
+#define TRACE_BIN_VERSION 1
+#define TRACE_BIN_FILE_ZSTD (1u << 0)
+#define TRACE_BIN_FILE_ZLIB (1u << 1)
+#define TRACE_BIN_CHUNK_COMPRESSED (1u << 31)
+#define TRACE_BIN_CHUNK_SIZE (1u << 20)
+
+enum trace_bin_op {
+   TRACE_BIN_NAME = 1,     /* index, length, bytes */
+   TRACE_BIN_CALL_BEGIN,   /* call number, class name, method name */
+   TRACE_BIN_CALL_END,     /* time */
+   TRACE_BIN_ARG_BEGIN,    /* name */
+   TRACE_BIN_ARG_END,
+   TRACE_BIN_RET_BEGIN,
+   TRACE_BIN_RET_END,
+   TRACE_BIN_FALSE,
+   TRACE_BIN_TRUE,
+   TRACE_BIN_INT,          /* signed value */
+   TRACE_BIN_UINT,         /* value */
+   TRACE_BIN_FLOAT,        /* double */
+   TRACE_BIN_BYTES,        /* length, bytes */
+   TRACE_BIN_STRING,       /* length, bytes */
+   TRACE_BIN_ENUM,         /* name */
+   TRACE_BIN_ARRAY_BEGIN,
+   TRACE_BIN_ARRAY_END,
+   TRACE_BIN_ELEM_BEGIN,
+   TRACE_BIN_ELEM_END,
+   TRACE_BIN_STRUCT_BEGIN, /* name */
+   TRACE_BIN_STRUCT_END,
+   TRACE_BIN_MEMBER_BEGIN, /* name */
+   TRACE_BIN_MEMBER_END,
+   TRACE_BIN_NULL,
+   TRACE_BIN_PTR,          /* value */
+   TRACE_BIN_NIR,          /* length, bytes */
+};
+
+struct trace_bin_chunk {
+   struct util_queue_fence fence;
+   uint32_t size;
+   uint8_t data[TRACE_BIN_CHUNK_SIZE];
+};
+
+/* Everything but the writer thread is protected by call_mutex. */
+static struct util_queue bin_queue;
+static struct trace_bin_chunk *bin_chunk = NULL;
+static struct hash_table *bin_names = NULL;
+static unsigned bin_num_names = 0;
+
+static void
+trace_bin_write_chunk(void *job, UNUSED void *gdata, UNUSED int thread_index)
+{
+   struct trace_bin_chunk *chunk = job;
+   const uint8_t *data = chunk->data;
+   uint32_t size = chunk->size;
+   uint32_t stored_size = size;
+   uint8_t *compressed = NULL;
+
+#ifdef HAVE_COMPRESSION
+   if (compress) {
+      size_t max_size = util_compress_max_compressed_len(size);
+
+      compressed = malloc(max_size);
+      if (compressed) {
+         size_t compressed_size =
+            util_compress_deflate(data, size, compressed, max_size);
+
+         /* Keep the chunk uncompressed if that failed. */
+         if (compressed_size) {
+            data = compressed;
+            stored_size = compressed_size | TRACE_BIN_CHUNK_COMPRESSED;
+         }
+      }
+   }
+#endif
+
+   uint32_t header[2] = {
+      util_cpu_to_le32(size),
+      util_cpu_to_le32(stored_size),
+   };
+   fwrite(header, sizeof(header), 1, stream);
+   fwrite(data, stored_size & ~TRACE_BIN_CHUNK_COMPRESSED, 1, stream);
+   fflush(stream);
+
+   free(compressed);
+}
+
+static void
+trace_bin_free_chunk(void *job, UNUSED void *gdata, UNUSED int thread_index)
+{
+   struct trace_bin_chunk *chunk = job;
+
+   util_queue_fence_destroy(&chunk->fence);
+   free(chunk);
+}
+
+static void
+trace_bin_flush_chunk(void)
+{
+   if (!bin_chunk || !bin_chunk->size)
+      return;
+
+   util_queue_fence_init(&bin_chunk->fence);
+   util_queue_add_job(&bin_queue, bin_chunk, &bin_chunk->fence,
+                      trace_bin_write_chunk, trace_bin_free_chunk, 0);
+   bin_chunk = NULL;
+}
+
+static void
+trace_bin_write(const void *buf, size_t size)
+{
+   const uint8_t *p = buf;
+
+   if (!stream || !trigger_active)
+      return;
+
+   while (size) {
+      if (!bin_chunk) {
+         bin_chunk = malloc(sizeof(*bin_chunk));
+         if (!bin_chunk)
+            return;
+         bin_chunk->size = 0;
+      }
+
+      size_t n = MIN2(size, TRACE_BIN_CHUNK_SIZE - bin_chunk->size);
+      memcpy(bin_chunk->data + bin_chunk->size, p, n);
+      bin_chunk->size += n;
+      p += n;
+      size -= n;
+
+      if (bin_chunk->size == TRACE_BIN_CHUNK_SIZE)
+         trace_bin_flush_chunk();
+   }
+}
+
+static inline void
+trace_bin_op(enum trace_bin_op op)
+{
+   uint8_t byte = op;
+   trace_bin_write(&byte, 1);
+}
+
+static inline void
+trace_bin_uint(uint64_t value)
+{
+   uint8_t buf[10];
+   unsigned n = 0;
+
+   do {
+      buf[n] = value & 0x7f;
+      value >>= 7;
+      if (value)
+         buf[n] |= 0x80;
+      n++;
+   } while (value);
+
+   trace_bin_write(buf, n);
+}
+
+static inline void
+trace_bin_int(int64_t value)
+{
+   trace_bin_uint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static inline void
+trace_bin_data(enum trace_bin_op op, const void *data, size_t size)
+{
+   trace_bin_op(op);
+   trace_bin_uint(size);
+   trace_bin_write(data, size);
+}
+
+/**
+ * Return the index of a name, sending its TRACE_BIN_NAME first if it's new.
+ * Names are looked up by contents as some of them are formatted on the fly.
+ */
+static unsigned
+trace_bin_name(const char *name)
+{
+   if (!stream || !trigger_active)
+      return 0;
+
+   struct hash_entry *entry = _mesa_hash_table_search(bin_names, name);
+   if (entry)
+      return (uintptr_t)entry->data;
+
+   unsigned index = bin_num_names++;
+   trace_bin_op(TRACE_BIN_NAME);
+   trace_bin_uint(index);
+   trace_bin_uint(strlen(name));
+   trace_bin_write(name, strlen(name));
+
+   _mesa_hash_table_insert(bin_names, ralloc_strdup(bin_names, name),
+                           (void *)(uintptr_t)index);
+   return index;
+}
+
+static inline void
+trace_bin_op_name(enum trace_bin_op op, const char *name)
+{
+   unsigned index = trace_bin_name(name);
+
+   trace_bin_op(op);
+   trace_bin_uint(index);
+}
+
+static bool
+trace_bin_begin(void)
+{
+   uint32_t header[2] = {
+      util_cpu_to_le32(TRACE_BIN_VERSION),
+      0,
+   };
+
+#ifdef HAVE_COMPRESSION
+   if (compress) {
+#ifdef HAVE_ZSTD
+      header[1] = util_cpu_to_le32(TRACE_BIN_FILE_ZSTD);
+#else
+      header[1] = util_cpu_to_le32(TRACE_BIN_FILE_ZLIB);
+#endif
+   }
+#else
+   if (compress)
+      fprintf(stderr, "gallium: trace compression is not available\n");
+   compress = false;
+#endif
+
+   bin_names = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                       _mesa_key_string_equal);
+   if (!bin_names)
+      return false;
+
+   /* This must come before the atexit() in trace_dump_trace_begin() so that
+    * the queue's own exit handler only runs after the last chunk is out.
+    */
+   if (!util_queue_init(&bin_queue, "trace", 16, 1, 0, NULL)) {
+      _mesa_hash_table_destroy(bin_names, NULL);
+      bin_names = NULL;
+      return false;
+   }
+
+   fwrite(TRACE_BIN_MAGIC, strlen(TRACE_BIN_MAGIC), 1, stream);
+   fwrite(header, sizeof(header), 1, stream);
+   return true;
+}
+
+static void
+trace_bin_end(void)
+{
+   trace_bin_flush_chunk();
+   util_queue_finish(&bin_queue);
+   util_queue_destroy(&bin_queue);
+
+   _mesa_hash_table_destroy(bin_names, NULL);
+   bin_names = NULL;
+   bin_num_names = 0;
+}
+
 void
 trace_dump_trace_flush(void)
 {
-   if (stream) {
+   /* Binary traces are only written when a chunk fills up. */
+   if (stream && !binary) {
       fflush(stream);
    }
 }
@@ -220,7 +506,10 @@ trace_dump_trace_close(void)
 {
    if (stream) {
       trigger_active = true;
-      trace_dump_writes("</trace>\n");
+      if (binary)
+         trace_bin_end();
+      else
+         trace_dump_writes("</trace>\n");
       if (close_stream) {
          fclose(stream);
          close_stream = false;
@@ -255,6 +544,8 @@ trace_dump_trace_begin(void)
       return false;
 
    nir_count = debug_get_num_option("GALLIUM_TRACE_NIR", 32);
+   compress = debug_get_bool_option("GALLIUM_TRACE_COMPRESS", false);
+   binary = compress || debug_get_bool_option("GALLIUM_TRACE_BINARY", false);
 
    if (!stream) {
 
@@ -268,14 +559,23 @@ trace_dump_trace_begin(void)
       }
       else {
          close_stream = true;
-         stream = fopen(filename, "wt");
+         stream = fopen(filename, binary ? "wb" : "wt");
          if (!stream)
             return false;
       }
 
-      trace_dump_writes("<?xml version='1.0' encoding='UTF-8'?>\n");
-      trace_dump_writes("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n");
-      trace_dump_writes("<trace version='0.1'>\n");
+      if (binary) {
+         if (!trace_bin_begin()) {
+            if (close_stream)
+               fclose(stream);
+            stream = NULL;
+            return false;
+         }
+      } else {
+         trace_dump_writes("<?xml version='1.0' encoding='UTF-8'?>\n");
+         trace_dump_writes("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n");
+         trace_dump_writes("<trace version='0.1'>\n");
+      }
 
       /* Many applications don't exit cleanly, others may create and destroy a
        * screen multiple times, so we only write </trace> tag and close at exit
@@ -367,6 +667,19 @@ void trace_dump_call_begin_locked(const char *klass, const char *method)
       return;
 
    ++call_no;
+   call_start_time = os_time_get();
+
+   if (binary) {
+      unsigned klass_index = trace_bin_name(klass);
+      unsigned method_index = trace_bin_name(method);
+
+      trace_bin_op(TRACE_BIN_CALL_BEGIN);
+      trace_bin_uint(call_no);
+      trace_bin_uint(klass_index);
+      trace_bin_uint(method_index);
+      return;
+   }
+
    trace_dump_indent(1);
    trace_dump_writes("<call no=\'");
    trace_dump_writef("%lu", call_no);
@@ -376,8 +689,6 @@ void trace_dump_call_begin_locked(const char *klass, const char *method)
    trace_dump_escape(method);
    trace_dump_writes("\'>");
    trace_dump_newline();
-
-   call_start_time = os_time_get();
 }
 
 void trace_dump_call_end_locked(void)
@@ -389,6 +700,12 @@ void trace_dump_call_end_locked(void)
 
    call_end_time = os_time_get();
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_CALL_END);
+      trace_bin_int(call_end_time - call_start_time);
+      return;
+   }
+
    trace_dump_call_time(call_end_time - call_start_time);
    trace_dump_indent(1);
    trace_dump_tag_end("call");
@@ -413,6 +730,11 @@ void trace_dump_arg_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op_name(TRACE_BIN_ARG_BEGIN, name);
+      return;
+   }
+
    trace_dump_indent(2);
    trace_dump_tag_begin1("arg", "name", name);
 }
@@ -422,6 +744,11 @@ void trace_dump_arg_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_ARG_END);
+      return;
+   }
+
    trace_dump_tag_end("arg");
    trace_dump_newline();
 }
@@ -431,6 +758,11 @@ void trace_dump_ret_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_RET_BEGIN);
+      return;
+   }
+
    trace_dump_indent(2);
    trace_dump_tag_begin("ret");
 }
@@ -440,6 +772,11 @@ void trace_dump_ret_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_RET_END);
+      return;
+   }
+
    trace_dump_tag_end("ret");
    trace_dump_newline();
 }
@@ -449,6 +786,11 @@ void trace_dump_bool(bool value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(value ? TRACE_BIN_TRUE : TRACE_BIN_FALSE);
+      return;
+   }
+
    trace_dump_writef("<bool>%c</bool>", value ? '1' : '0');
 }
 
@@ -457,6 +799,12 @@ void trace_dump_int(int64_t value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_INT);
+      trace_bin_int(value);
+      return;
+   }
+
    trace_dump_writef("<int>%" PRIi64 "</int>", value);
 }
 
@@ -465,6 +813,12 @@ void trace_dump_uint(uint64_t value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_UINT);
+      trace_bin_uint(value);
+      return;
+   }
+
    trace_dump_writef("<uint>%" PRIu64 "</uint>", value);
 }
 
@@ -473,6 +827,14 @@ void trace_dump_float(double value)
    if (!dumping)
       return;
 
+   if (binary) {
+      uint64_t bits = util_cpu_to_le64(dui(value));
+
+      trace_bin_op(TRACE_BIN_FLOAT);
+      trace_bin_write(&bits, sizeof(bits));
+      return;
+   }
+
    trace_dump_writef("<float>%g</float>", value);
 }
 
@@ -486,6 +848,11 @@ void trace_dump_bytes(const void *data,
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_data(TRACE_BIN_BYTES, data, size);
+      return;
+   }
+
    trace_dump_writes("<bytes>");
    for(i = 0; i < size; ++i) {
       uint8_t byte = *p++;
@@ -531,6 +898,11 @@ void trace_dump_string(const char *str)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_data(TRACE_BIN_STRING, str, strlen(str));
+      return;
+   }
+
    trace_dump_writes("<string>");
    trace_dump_escape(str);
    trace_dump_writes("</string>");
@@ -541,6 +913,11 @@ void trace_dump_enum(const char *value)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op_name(TRACE_BIN_ENUM, value);
+      return;
+   }
+
    trace_dump_writes("<enum>");
    trace_dump_escape(value);
    trace_dump_writes("</enum>");
@@ -551,6 +928,11 @@ void trace_dump_array_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_ARRAY_BEGIN);
+      return;
+   }
+
    trace_dump_writes("<array>");
 }
 
@@ -559,6 +941,11 @@ void trace_dump_array_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_ARRAY_END);
+      return;
+   }
+
    trace_dump_writes("</array>");
 }
 
@@ -567,6 +954,11 @@ void trace_dump_elem_begin(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_ELEM_BEGIN);
+      return;
+   }
+
    trace_dump_writes("<elem>");
 }
 
@@ -575,6 +967,11 @@ void trace_dump_elem_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_ELEM_END);
+      return;
+   }
+
    trace_dump_writes("</elem>");
 }
 
@@ -583,6 +980,11 @@ void trace_dump_struct_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op_name(TRACE_BIN_STRUCT_BEGIN, name);
+      return;
+   }
+
    trace_dump_writef("<struct name='%s'>", name);
 }
 
@@ -591,6 +993,11 @@ void trace_dump_struct_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_STRUCT_END);
+      return;
+   }
+
    trace_dump_writes("</struct>");
 }
 
@@ -599,6 +1006,11 @@ void trace_dump_member_begin(const char *name)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op_name(TRACE_BIN_MEMBER_BEGIN, name);
+      return;
+   }
+
    trace_dump_writef("<member name='%s'>", name);
 }
 
@@ -607,6 +1019,11 @@ void trace_dump_member_end(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_MEMBER_END);
+      return;
+   }
+
    trace_dump_writes("</member>");
 }
 
@@ -615,6 +1032,11 @@ void trace_dump_null(void)
    if (!dumping)
       return;
 
+   if (binary) {
+      trace_bin_op(TRACE_BIN_NULL);
+      return;
+   }
+
    trace_dump_writes("<null/>");
 }
 
@@ -623,7 +1045,10 @@ void trace_dump_ptr(const void *value)
    if (!dumping)
       return;
 
-   if(value)
+   if (binary && value) {
+      trace_bin_op(TRACE_BIN_PTR);
+      trace_bin_uint((uintptr_t)value);
+   } else if(value)
       trace_dump_writef("<ptr>0x%08lx</ptr>", (unsigned long)(uintptr_t)value);
    else
       trace_dump_null();
@@ -661,7 +1086,24 @@ void trace_dump_nir(struct nir_shader *nir)
       return;
 
    if (--nir_count < 0) {
-      fputs("<string>...</string>", stream);
+      if (binary)
+         trace_dump_string("...");
+      else
+         fputs("<string>...</string>", stream);
+      return;
+   }
+
+   if (binary) {
+      struct u_memstream mem;
+      char *buf;
+      size_t size;
+
+      if (u_memstream_open(&mem, &buf, &size)) {
+         nir_print_shader(nir, u_memstream_get(&mem));
+         u_memstream_close(&mem);
+         trace_bin_data(TRACE_BIN_NIR, buf, size);
+         free(buf);
+      }
       return;
    }
 
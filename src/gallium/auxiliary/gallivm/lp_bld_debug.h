@@ -51,6 +51,8 @@
 #define GALLIVM_PERF_NO_QUAD_LOD     (1 << 2)
 #define GALLIVM_PERF_NO_OPT          (1 << 3)
 #define GALLIVM_PERF_NO_AOS_SAMPLING (1 << 4)
+#define GALLIVM_PERF_LAZY            (1 << 5)
+#define GALLIVM_PERF_NO_HALF_FILTER  (1 << 6)
 
 #ifdef __cplusplus
 extern "C" {
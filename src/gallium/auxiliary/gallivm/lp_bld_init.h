@@ -58,6 +58,8 @@ struct gallivm_state
    LLVMOrcThreadSafeContextRef _ts_context;
    /* each module is in its own jitdylib */
    LLVMOrcJITDylibRef _per_module_jd;
+   /* background compilation of the module, if any */
+   void *_pending_compile;
 #else
    LLVMExecutionEngineRef engine;
    struct lp_passmgr *passmgr;
@@ -43,6 +43,8 @@ static const struct debug_named_value lp_bld_perf_flags[] = {
    { "no_quad_lod", GALLIVM_PERF_NO_QUAD_LOD, "disable quad_lod optimization" },
    { "no_aos_sampling", GALLIVM_PERF_NO_AOS_SAMPLING, "disable aos sampling optimization" },
    { "nopt",   GALLIVM_PERF_NO_OPT, "disable optimization passes to speed up shader compilation" },
+   { "lazy",   GALLIVM_PERF_LAZY, "compile each function on its first call (ORC JIT only)" },
+   { "no_half_filter", GALLIVM_PERF_NO_HALF_FILTER, "disable filtering of half float textures in half precision" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -9,7 +9,9 @@
 #include "util/os_time.h"
 #include <string>
 #include <vector>
+#include <map>
 #include <mutex>
+#include <condition_variable>
 #include <cstdlib>
 #include "lp_bld.h"
 #include "lp_bld_debug.h"
@@ -40,6 +42,7 @@
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
 #include <llvm/ExecutionEngine/ObjectCache.h>
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
 #include <llvm/Target/TargetMachine.h>
@@ -101,6 +104,64 @@ public:
 
 };
 
+/* The compile layer only takes a single object cache, while each gallivm
+ * module has its own lp_cached_code.  Route objects to the cache of the
+ * module they were compiled from.  Modules may be compiled concurrently
+ * on the compile threads, hence the lock.
+ */
+class LPObjectCacheDispatch : public llvm::ObjectCache {
+private:
+   std::mutex mutex;
+   std::map<std::string, LPObjectCacheORC *> caches;
+
+   LPObjectCacheORC *find(const llvm::Module *M) {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto I = caches.find(M->getModuleIdentifier());
+      return I == caches.end() ? NULL : I->second;
+   }
+public:
+   void add(const char *module_name, LPObjectCacheORC *cache) {
+      std::lock_guard<std::mutex> lock(mutex);
+      caches[module_name] = cache;
+   }
+
+   void remove(const char *module_name) {
+      std::lock_guard<std::mutex> lock(mutex);
+      caches.erase(module_name);
+   }
+
+   void notifyObjectCompiled(const llvm::Module *M, llvm::MemoryBufferRef Obj) override {
+      LPObjectCacheORC *cache = find(M);
+      if (cache)
+         cache->notifyObjectCompiled(M, Obj);
+   }
+
+   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *M) override {
+      LPObjectCacheORC *cache = find(M);
+      return cache ? cache->getObject(M) : NULL;
+   }
+};
+
+/* Tracks the background compilation gallivm_compile_module() kicks off,
+ * so that the module isn't torn down underneath the compile threads.
+ */
+struct LPPendingCompile {
+   std::mutex mutex;
+   std::condition_variable cond;
+   bool done = false;
+
+   void signal() {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+      cond.notify_all();
+   }
+
+   void wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [this] { return done; });
+   }
+};
+
 class LPJit;
 
 void lpjit_exit();
@@ -196,15 +257,61 @@ public:
    static void add_ir_module_to_jd(
          LLVMOrcThreadSafeContextRef ts_context,
          LLVMModuleRef mod,
-         LLVMOrcJITDylibRef jd) {
+         LLVMOrcJITDylibRef jd,
+         bool lazy) {
       using llvm::Module;
       using llvm::orc::ThreadSafeModule;
       using llvm::orc::JITDylib;
+      using llvm::orc::LLLazyJIT;
+      LPJit* jit = get_instance();
       ThreadSafeModule tsm(
          std::unique_ptr<Module>(llvm::unwrap(mod)), *::unwrap(ts_context));
-      ExitOnErr(get_instance()->lljit->addIRModule(
-         *::unwrap(jd), std::move(tsm)
-      ));
+      if (lazy && jit->lazy) {
+         /* Each function is split out and compiled on its first call. */
+         ExitOnErr(static_cast<LLLazyJIT &>(*jit->lljit).addLazyIRModule(
+            *::unwrap(jd), std::move(tsm)
+         ));
+      } else {
+         ExitOnErr(jit->lljit->addIRModule(
+            *::unwrap(jd), std::move(tsm)
+         ));
+      }
+   }
+
+   /* Start compiling the given functions on the compile threads, the
+    * lookup in gallivm_jit_function() then only waits for the result.
+    */
+   static void compile_in_background(
+         const std::vector<std::string> &func_names,
+         LLVMOrcJITDylibRef jd,
+         LPPendingCompile *pending) {
+      using llvm::orc::JITDylibLookupFlags;
+      using llvm::orc::LookupKind;
+      using llvm::orc::SymbolLookupSet;
+      using llvm::orc::SymbolMap;
+      using llvm::orc::SymbolState;
+      LPJit* jit = get_instance();
+      auto& es = jit->lljit->getExecutionSession();
+      SymbolLookupSet symbols;
+      for (const std::string &name : func_names)
+         symbols.add(jit->lljit->mangleAndIntern(name));
+
+      es.lookup(LookupKind::Static,
+                llvm::orc::makeJITDylibSearchOrder(
+                   ::unwrap(jd), JITDylibLookupFlags::MatchAllSymbols),
+                std::move(symbols), SymbolState::Ready,
+                [pending](llvm::Expected<SymbolMap> result) {
+                   /* Errors resurface in the lookup of the function. */
+                   if (!result)
+                      llvm::consumeError(result.takeError());
+                   pending->signal();
+                },
+                llvm::orc::NoDependenciesToRegister);
+   }
+
+   static bool compiles_in_background() {
+      LPJit* jit = get_instance();
+      return jit->num_compile_threads > 0 && !jit->lazy;
    }
 
    static void add_mapping_to_jd(
@@ -242,9 +349,15 @@ public:
       using llvm::orc::ExecutorAddr;
       JITDylib* JD = ::unwrap(jd);
       LPJit* jit = get_instance();
-      jit->lookup_mutex.lock();
+      /* Without compile threads the module is compiled on the looking up
+       * thread, with the one shared TargetMachine.
+       */
+      std::unique_lock<std::mutex> lock(jit->lookup_mutex, std::defer_lock);
+      if (!jit->num_compile_threads)
+         lock.lock();
       auto func = ExitOnErr(jit->lljit->lookup(*JD, func_name));
-      jit->lookup_mutex.unlock();
+      if (lock.owns_lock())
+         lock.unlock();
 #if LLVM_VERSION_MAJOR >= 15
       return func.toPtr<void *>();
 #else
@@ -259,11 +372,28 @@ public:
       ExitOnErr(es.removeJITDylib(* ::unwrap(jd)));
    }
 
-   static void set_object_cache(llvm::ObjectCache *objcache) {
-      auto &ircl = LPJit::get_instance()->lljit->getIRCompileLayer();
-      auto &irc = ircl.getCompiler();
-      auto &sc = dynamic_cast<llvm::orc::SimpleCompiler &>(irc);
-      sc.setObjectCache(objcache);
+   static void add_object_cache(const char *module_name,
+                                LPObjectCacheORC *objcache) {
+      LPJit::get_instance()->objcache.add(module_name, objcache);
+   }
+
+   static void remove_object_cache(const char *module_name) {
+      LPJit::get_instance()->objcache.remove(module_name);
+   }
+
+   /* The TargetMachine the optimization passes of a module run with.
+    * They run on the compile threads when there are any, so each of those
+    * gets its own.
+    */
+   static LLVMTargetMachineRef get_pass_tm() {
+      LPJit* jit = get_instance();
+      if (!jit->num_compile_threads)
+         return jit->tm;
+
+      static thread_local std::unique_ptr<llvm::TargetMachine> thread_tm;
+      if (!thread_tm)
+         thread_tm = ExitOnErr(jit->pass_jtmb->createTargetMachine());
+      return wrap(thread_tm.get());
    }
    LLVMTargetMachineRef tm;
 
@@ -277,6 +407,9 @@ private:
 
    static void init_native_targets();
    llvm::orc::JITTargetMachineBuilder create_jtdb();
+   template <typename Builder>
+   Builder &setup_builder(Builder &builder,
+                          llvm::orc::JITTargetMachineBuilder JTMB);
 
    static void init_lpjit() {
       jit = new LPJit;
@@ -284,10 +417,16 @@ private:
    }
    static LPJit* jit;
 
+   /* must outlive the compilers of lljit */
+   LPObjectCacheDispatch objcache;
    std::unique_ptr<llvm::orc::LLJIT> lljit;
    std::unique_ptr<llvm::TargetMachine> tm_unique;
+   std::unique_ptr<llvm::orc::JITTargetMachineBuilder> pass_jtmb;
    /* avoid name conflict */
    unsigned jit_dylib_count;
+   unsigned num_compile_threads;
+   /* lljit is a LLLazyJIT */
+   bool lazy;
 
    std::mutex lookup_mutex;
 
@@ -310,7 +449,7 @@ LLVMErrorRef module_transform(void *Ctx, LLVMModuleRef mod) {
    lp_passmgr_create(mod, &mgr);
 
    lp_passmgr_run(mgr, mod,
-                  LPJit::get_instance()->tm,
+                  LPJit::get_pass_tm(),
                   get_module_name(mod));
 
    lp_passmgr_dispose(mgr);
@@ -323,36 +462,88 @@ LLVMErrorRef module_transform_wrapper(
    return LLVMOrcThreadSafeModuleWithModuleDo(*ModInOut, *module_transform, Ctx);
 }
 
-LPJit::LPJit() :jit_dylib_count(0) {
+/* Settings shared by the LLJIT and LLLazyJIT builders. */
+template <typename Builder>
+Builder &LPJit::setup_builder(Builder &builder,
+                              llvm::orc::JITTargetMachineBuilder JTMB) {
    using namespace llvm::orc;
 
-   lp_init_env_options();
-
-   init_native_targets();
-   JITTargetMachineBuilder JTMB = create_jtdb();
-   tm_unique = ExitOnErr(JTMB.createTargetMachine());
-   tm = wrap(tm_unique.get());
-
    /* Create an LLJIT instance with an ObjectLinkingLayer (JITLINK)
     * or RuntimeDyld as the base layer.
     * intel & perf listeners are not supported by ObjectLinkingLayer yet
     */
-   lljit = ExitOnErr(
-      LLJITBuilder()
-         .setJITTargetMachineBuilder(std::move(JTMB))
+   return builder
+      .setJITTargetMachineBuilder(std::move(JTMB))
+      .setNumCompileThreads(num_compile_threads)
+      .setCompileFunctionCreator(
+         [this](JITTargetMachineBuilder JTMB)
+            -> llvm::Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+            /* The concurrent compiler creates a TargetMachine per module. */
+            if (num_compile_threads)
+               return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+                                                              &objcache);
+            auto TM = JTMB.createTargetMachine();
+            if (!TM)
+               return TM.takeError();
+            return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM),
+                                                            &objcache);
+         })
 #ifdef USE_JITLINK
-         .setObjectLinkingLayerCreator(
-            [&](ExecutionSession &ES, const llvm::Triple &TT) {
-               return std::make_unique<ObjectLinkingLayer>(
-                  ES, ExitOnErr(llvm::jitlink::InProcessMemoryManager::Create()));
-            })
+      .setObjectLinkingLayerCreator(
+         [&](ExecutionSession &ES, const llvm::Triple &TT) {
+            return std::make_unique<ObjectLinkingLayer>(
+               ES, ExitOnErr(llvm::jitlink::InProcessMemoryManager::Create()));
+         })
 #else
 #if LLVM_USE_INTEL_JITEVENTS
-         .RegisterJITEventListener(
-               llvm::JITEventListener::createIntelJITEventListener())
+      .RegisterJITEventListener(
+            llvm::JITEventListener::createIntelJITEventListener())
 #endif
 #endif
-         .create());
+      ;
+}
+
+LPJit::LPJit() :jit_dylib_count(0) {
+   using namespace llvm::orc;
+
+   lp_init_env_options();
+
+   init_native_targets();
+   JITTargetMachineBuilder JTMB = create_jtdb();
+   tm_unique = ExitOnErr(JTMB.createTargetMachine());
+   tm = wrap(tm_unique.get());
+   pass_jtmb = std::make_unique<JITTargetMachineBuilder>(JTMB);
+
+   /* Compile modules on a few threads of their own, so that several shaders
+    * can be compiled at once and compilation can overlap with the caller.
+    */
+   int nr_cpus = util_get_cpu_caps()->nr_cpus;
+   num_compile_threads = debug_get_num_option("GALLIVM_COMPILE_THREADS",
+                                              CLAMP(nr_cpus - 1, 0, 4));
+
+   lazy = false;
+   if (gallivm_perf & GALLIVM_PERF_LAZY) {
+      /* Lazily compiled functions are compiled by whichever thread calls
+       * them first, that needs the per module TargetMachines of the
+       * concurrent compiler.
+       */
+      num_compile_threads = MAX2(num_compile_threads, 1);
+
+      LLLazyJITBuilder builder;
+      auto lazyjit = setup_builder(builder, JTMB).create();
+      if (lazyjit) {
+         lljit = std::move(*lazyjit);
+         lazy = true;
+      } else {
+         /* No lazy call-through support for this target. */
+         llvm::consumeError(lazyjit.takeError());
+      }
+   }
+
+   if (!lljit) {
+      LLJITBuilder builder;
+      lljit = ExitOnErr(setup_builder(builder, std::move(JTMB)).create());
+   }
 
    LLVMOrcIRTransformLayerRef TL = wrap(&lljit->getIRTransformLayer());
    LLVMOrcIRTransformLayerSetTransform(TL, *module_transform_wrapper, NULL);
@@ -588,9 +779,23 @@ gallivm_create(const char *name, lp_context_ref *context,
    return gallivm;
 }
 
+static void
+gallivm_wait_compile(struct gallivm_state *gallivm)
+{
+   auto *pending = (LPPendingCompile *)gallivm->_pending_compile;
+   if (pending) {
+      pending->wait();
+      delete pending;
+      gallivm->_pending_compile = NULL;
+   }
+}
+
 void
 gallivm_destroy(struct gallivm_state *gallivm)
 {
+   gallivm_wait_compile(gallivm);
+   if (gallivm->module_name)
+      LPJit::remove_object_cache(gallivm->module_name);
    LPJit::remove_jd(gallivm->_per_module_jd);
    gallivm->_per_module_jd = nullptr;
    FREE(gallivm);
@@ -599,8 +804,13 @@ gallivm_destroy(struct gallivm_state *gallivm)
 void
 gallivm_free_ir(struct gallivm_state *gallivm)
 {
+   /* The object cache must stay around until the object was written. */
+   gallivm_wait_compile(gallivm);
+
    if (gallivm->module)
       LLVMDisposeModule(gallivm->module);
+   if (gallivm->module_name)
+      LPJit::remove_object_cache(gallivm->module_name);
    FREE(gallivm->module_name);
 
    if (gallivm->target) {
@@ -624,7 +834,6 @@ gallivm_free_ir(struct gallivm_state *gallivm)
    gallivm->_ts_context=NULL;
    gallivm->cache=NULL;
    LPJit::deregister_gallivm_state(gallivm);
-   LPJit::set_object_cache(NULL);
 }
 
 void
@@ -646,23 +855,45 @@ gallivm_compile_module(struct gallivm_state *gallivm)
 
    lp_build_coro_add_malloc_hooks(gallivm);
 
+   if (gallivm->cache) {
+      if (!gallivm->cache->jit_obj_cache) {
+         LPObjectCacheORC *objcache = new LPObjectCacheORC(gallivm->cache);
+         gallivm->cache->jit_obj_cache = (void *)objcache;
+      }
+      auto *objcache = (LPObjectCacheORC *)gallivm->cache->jit_obj_cache;
+      LPJit::add_object_cache(gallivm->module_name, objcache);
+   }
+
+   /* Functions are only split out and compiled lazily if there's no
+    * cached object to load, and the object won't be cached then.
+    */
+   bool lazy = !gallivm->cache || !gallivm->cache->data_size;
+
+   std::vector<std::string> func_names;
+   if (LPJit::compiles_in_background()) {
+      for (llvm::Function &func : *llvm::unwrap(gallivm->module)) {
+         if (!func.isDeclaration() && !func.hasLocalLinkage())
+            func_names.push_back(func.getName().str());
+      }
+   }
+
    LPJit::add_ir_module_to_jd(gallivm->_ts_context, gallivm->module,
-      gallivm->_per_module_jd);
+      gallivm->_per_module_jd, lazy);
    /* ownership of module is now transferred into orc jit,
     * disallow modifying it
     */
    LPJit::register_gallivm_state(gallivm);
    gallivm->module = nullptr;
 
-   if (gallivm->cache) {
-      if (!gallivm->cache->jit_obj_cache) {
-         LPObjectCacheORC *objcache = new LPObjectCacheORC(gallivm->cache);
-         gallivm->cache->jit_obj_cache = (void *)objcache;
-      }
-      auto *objcache = (LPObjectCacheORC *)gallivm->cache->jit_obj_cache;
-      LPJit::set_object_cache(objcache);
+   /* Without compile threads, or with lazy compilation, defer compilation
+    * till first lookup by gallivm_jit_function.
+    */
+   if (!func_names.empty()) {
+      auto *pending = new LPPendingCompile;
+      gallivm->_pending_compile = pending;
+      LPJit::compile_in_background(func_names, gallivm->_per_module_jd,
+                                   pending);
    }
-   /* defer compilation till first lookup by gallivm_jit_function */
 }
 
 func_pointer
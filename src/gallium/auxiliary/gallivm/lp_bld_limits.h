@@ -83,6 +83,17 @@ lp_has_fp16(void)
    return util_get_cpu_caps()->has_f16c || DETECT_ARCH_AARCH64;
 }
 
+/**
+ * Whether half float vectors can be added and multiplied natively, rather
+ * than the backend widening every operation to float.
+ */
+static inline bool
+lp_has_fp16_arith(void)
+{
+   return util_get_cpu_caps()->has_avx512fp16 ||
+          util_get_cpu_caps()->has_neon_fp16;
+}
+
 /**
  * Some of these limits are actually infinite (i.e., only limited by available
  * memory), however advertising INT_MAX would cause some test problems to
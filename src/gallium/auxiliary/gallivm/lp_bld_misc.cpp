@@ -383,6 +383,13 @@ lp_build_fill_mattrs(std::vector<std::string> &MAttrs)
    MAttrs.push_back(util_get_cpu_caps()->has_avx512bw ? "+avx512bw"  : "-avx512bw");
    MAttrs.push_back(util_get_cpu_caps()->has_avx512dq ? "+avx512dq"  : "-avx512dq");
    MAttrs.push_back(util_get_cpu_caps()->has_avx512vl ? "+avx512vl"  : "-avx512vl");
+#if LLVM_VERSION_MAJOR >= 14
+   MAttrs.push_back(util_get_cpu_caps()->has_avx512fp16 ? "+avx512fp16"  : "-avx512fp16");
+#endif
+#endif
+#if DETECT_ARCH_AARCH64
+   if (util_get_cpu_caps()->has_neon_fp16)
+      MAttrs.push_back("+fullfp16");
 #endif
 #if DETECT_ARCH_ARM
    if (!util_get_cpu_caps()->has_neon) {
@@ -62,6 +62,9 @@ void lp_build_nir_aos(struct gallivm_state *gallivm,
                       LLVMValueRef *outputs,
                       const struct lp_build_sampler_aos *sampler);
 
+void
+lp_build_nir_aos_prepasses(struct nir_shader *nir);
+
 struct lp_build_fn {
    LLVMTypeRef fn_type;
    LLVMValueRef fn;
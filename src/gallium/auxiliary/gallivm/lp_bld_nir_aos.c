@@ -34,6 +34,7 @@
 #include "lp_bld_swizzle.h"
 #include "lp_bld_debug.h"
 #include "util/u_math.h"
+#include "nir_builder.h"
 #include "nir_deref.h"
 
 
@@ -487,6 +488,14 @@ do_alu_action(struct lp_build_nir_aos_context *bld,
    LLVMValueRef result = NULL;
 
    switch (instr->op) {
+   case nir_op_fadd:
+      result = lp_build_add(get_flt_bld(bld, src_bit_size[0]),
+                            src[0], src[1]);
+      break;
+   case nir_op_flrp:
+      result = lp_build_lerp(get_flt_bld(bld, src_bit_size[0]),
+                             src[2], src[0], src[1], 0);
+      break;
    case nir_op_fmul:
       result = lp_build_mul(get_flt_bld(bld, src_bit_size[0]),
                             src[0], src[1]);
@@ -863,6 +872,151 @@ visit_cf_list(struct lp_build_nir_aos_context *bld,
    }
 }
 
+/*
+ * Return the ALU instruction feeding source srcn of alu, if it is an op
+ * instruction used without any swizzling.
+ */
+static nir_alu_instr *
+aos_src_alu(const nir_alu_instr *alu, unsigned srcn, nir_op op)
+{
+   if (!nir_alu_src_is_trivial_ssa(alu, srcn))
+      return NULL;
+
+   nir_instr *parent = alu->src[srcn].src.ssa->parent_instr;
+   if (parent->type != nir_instr_type_alu ||
+       nir_instr_as_alu(parent)->op != op)
+      return NULL;
+
+   return nir_instr_as_alu(parent);
+}
+
+
+static bool
+aos_src_is_one(const nir_alu_instr *alu, unsigned srcn)
+{
+   if (!nir_src_is_const(alu->src[srcn].src))
+      return false;
+
+   for (unsigned i = 0; i < nir_ssa_alu_instr_src_components(alu, srcn); i++) {
+      if (nir_src_comp_as_float(alu->src[srcn].src,
+                                alu->src[srcn].swizzle[i]) != 1.0)
+         return false;
+   }
+   return true;
+}
+
+
+/*
+ * Match 1 - t, ie. fadd(1.0, fneg(t)), and return the fneg.
+ */
+static nir_alu_instr *
+aos_match_one_minus(const nir_alu_instr *add)
+{
+   if (add->op != nir_op_fadd)
+      return NULL;
+
+   for (unsigned i = 0; i < 2; i++) {
+      nir_alu_instr *neg = aos_src_alu(add, 1 - i, nir_op_fneg);
+      if (neg && aos_src_is_one(add, i))
+         return neg;
+   }
+   return NULL;
+}
+
+
+/*
+ * The GL frontend lowers flrp, so a mix() in the shader arrives here either
+ * as a + t * (b - a) or as a * (1 - t) + b * t.  Neither can be evaluated
+ * with the saturating unorm8 arithmetic the AoS path uses, so turn them
+ * back into flrp, which maps onto lp_build_lerp().  Once no more of those
+ * are left, a lone 1 - t becomes flrp(1, 0, t).
+ */
+static bool
+aos_fold_lerp_instr(nir_builder *b, nir_alu_instr *add, void *data)
+{
+   if (add->op != nir_op_fadd)
+      return false;
+
+   const unsigned num_components = add->def.num_components;
+   const unsigned bit_size = add->def.bit_size;
+   nir_def *a = NULL, *v = NULL, *t = NULL;
+
+   b->cursor = nir_before_instr(&add->instr);
+
+   for (unsigned i = 0; i < 2 && !a; i++) {
+      /* a + t * (b + -a) */
+      nir_alu_instr *mul = aos_src_alu(add, 1 - i, nir_op_fmul);
+      for (unsigned j = 0; mul && j < 2 && !a; j++) {
+         nir_alu_instr *sub = aos_src_alu(mul, 1 - j, nir_op_fadd);
+         for (unsigned k = 0; sub && k < 2 && !a; k++) {
+            nir_alu_instr *neg = aos_src_alu(sub, 1 - k, nir_op_fneg);
+            if (neg && nir_alu_srcs_equal(add, neg, i, 0)) {
+               a = nir_ssa_for_alu_src(b, add, i);
+               v = nir_ssa_for_alu_src(b, sub, k);
+               t = nir_ssa_for_alu_src(b, mul, j);
+            }
+         }
+      }
+
+      /* a * (1 + -t) + b * t */
+      nir_alu_instr *mul_a = aos_src_alu(add, i, nir_op_fmul);
+      nir_alu_instr *mul_b = aos_src_alu(add, 1 - i, nir_op_fmul);
+      for (unsigned j = 0; mul_a && mul_b && j < 2 && !a; j++) {
+         nir_alu_instr *comp = aos_src_alu(mul_a, 1 - j, nir_op_fadd);
+         nir_alu_instr *neg = comp ? aos_match_one_minus(comp) : NULL;
+         for (unsigned k = 0; neg && k < 2 && !a; k++) {
+            if (nir_alu_srcs_equal(mul_b, neg, k, 0)) {
+               a = nir_ssa_for_alu_src(b, mul_a, j);
+               v = nir_ssa_for_alu_src(b, mul_b, 1 - k);
+               t = nir_ssa_for_alu_src(b, mul_b, k);
+            }
+         }
+      }
+   }
+
+   if (!a) {
+      const bool *fold_one_minus = data;
+      nir_alu_instr *neg = *fold_one_minus ? aos_match_one_minus(add) : NULL;
+      if (!neg)
+         return false;
+
+      nir_const_value one[NIR_MAX_VEC_COMPONENTS];
+      for (unsigned i = 0; i < num_components; i++)
+         one[i] = nir_const_value_for_float(1.0, bit_size);
+
+      a = nir_build_imm(b, num_components, bit_size, one);
+      v = nir_imm_zero(b, num_components, bit_size);
+      t = nir_ssa_for_alu_src(b, neg, 0);
+   }
+
+   nir_def_replace(&add->def, nir_flrp(b, a, v, t));
+   return true;
+}
+
+
+/*
+ * Passes run on the shader before lp_build_nir_aos() consumes it.  Also
+ * used by llvmpipe's linear shader analysis, so that both agree on which
+ * instructions the AoS path sees.
+ */
+void
+lp_build_nir_aos_prepasses(struct nir_shader *nir)
+{
+   bool progress = false;
+
+   /* The 1 - t of a * (1 - t) + b * t must only be folded after the whole
+    * expression had its chance to match.
+    */
+   for (unsigned i = 0; i < 2; i++) {
+      bool fold_one_minus = i == 1;
+      NIR_PASS(progress, nir, nir_shader_alu_pass, aos_fold_lerp_instr,
+               nir_metadata_control_flow, &fold_one_minus);
+   }
+   if (progress)
+      NIR_PASS(_, nir, nir_opt_dce);
+}
+
+
 void
 lp_build_nir_aos(struct gallivm_state *gallivm,
                  struct nir_shader *shader,
@@ -890,6 +1044,8 @@ lp_build_nir_aos(struct gallivm_state *gallivm,
    bld.outputs = outputs;
    bld.consts_ptr = consts_ptr;
 
+   lp_build_nir_aos_prepasses(shader);
+
    NIR_PASS_V(shader, nir_convert_to_lcssa, true, true);
    NIR_PASS_V(shader, nir_convert_from_ssa, true, false);
    NIR_PASS_V(shader, nir_lower_locals_to_regs, 32);
@@ -49,6 +49,7 @@
 #include "lp_bld_pack.h"
 #include "lp_bld_quad.h"
 #include "lp_bld_bitarit.h"
+#include "lp_bld_limits.h"
 
 
 /*
@@ -90,6 +91,51 @@ lp_sampler_wrap_mode_uses_border_color(enum pipe_tex_wrap mode,
 }
 
 
+/**
+ * Can bilinear filtering of this texture be done on half floats?
+ *
+ * Only for textures whose channels are all 16-bit floats, so the texels
+ * are exact in half precision and only the weights and the filtered
+ * result get rounded to the format's own precision.  The border color is
+ * an arbitrary float, so wrap modes which may sample it are excluded.
+ */
+bool
+lp_sampler_half_filter_supported(const struct lp_static_texture_state *texture,
+                                 const struct lp_static_sampler_state *sampler)
+{
+   const struct util_format_description *desc =
+      util_format_description(texture->format);
+
+   if (!lp_has_fp16_arith() ||
+       (gallivm_perf & GALLIVM_PERF_NO_HALF_FILTER))
+      return false;
+
+   if (desc->layout != UTIL_FORMAT_LAYOUT_PLAIN ||
+       desc->colorspace != UTIL_FORMAT_COLORSPACE_RGB)
+      return false;
+
+   for (unsigned chan = 0; chan < desc->nr_channels; chan++) {
+      if (desc->channel[chan].type != UTIL_FORMAT_TYPE_FLOAT ||
+          desc->channel[chan].size != 16)
+         return false;
+   }
+
+   if (sampler->compare_mode != PIPE_TEX_COMPARE_NONE ||
+       sampler->reduction_mode != PIPE_TEX_REDUCTION_WEIGHTED_AVERAGE)
+      return false;
+
+   return !lp_sampler_wrap_mode_uses_border_color(sampler->wrap_s,
+                                                  sampler->min_img_filter,
+                                                  sampler->mag_img_filter) &&
+          !lp_sampler_wrap_mode_uses_border_color(sampler->wrap_t,
+                                                  sampler->min_img_filter,
+                                                  sampler->mag_img_filter) &&
+          !lp_sampler_wrap_mode_uses_border_color(sampler->wrap_r,
+                                                  sampler->min_img_filter,
+                                                  sampler->mag_img_filter);
+}
+
+
 /**
  * Initialize lp_sampler_static_texture_state object with the gallium
  * texture/sampler_view state (this contains the parts which are
@@ -2500,6 +2546,49 @@ lp_build_reduce_filter_2d(struct lp_build_context *bld,
 }
 
 
+/**
+ * Bilinear weighted average of float texels, computed on half floats.
+ *
+ * The texels must be exactly representable as halves (see
+ * lp_sampler_half_filter_supported()), in which case LLVM folds the
+ * truncation below into the widening done by the texel fetch.
+ */
+void
+lp_build_half_filter_2d(struct lp_build_context *bld,
+                        unsigned num_chan,
+                        LLVMValueRef x,
+                        LLVMValueRef y,
+                        LLVMValueRef *v00,
+                        LLVMValueRef *v01,
+                        LLVMValueRef *v10,
+                        LLVMValueRef *v11,
+                        LLVMValueRef *out)
+{
+   LLVMBuilderRef builder = bld->gallivm->builder;
+   struct lp_type half_type = bld->type;
+   struct lp_build_context half_bld;
+
+   assert(bld->type.floating && bld->type.width == 32);
+
+   half_type.width = 16;
+   lp_build_context_init(&half_bld, bld->gallivm, half_type);
+
+   x = LLVMBuildFPTrunc(builder, x, half_bld.vec_type, "");
+   y = LLVMBuildFPTrunc(builder, y, half_bld.vec_type, "");
+
+   for (unsigned chan = 0; chan < num_chan; chan++) {
+      LLVMValueRef h00 = LLVMBuildFPTrunc(builder, v00[chan], half_bld.vec_type, "");
+      LLVMValueRef h01 = LLVMBuildFPTrunc(builder, v01[chan], half_bld.vec_type, "");
+      LLVMValueRef h10 = LLVMBuildFPTrunc(builder, v10[chan], half_bld.vec_type, "");
+      LLVMValueRef h11 = LLVMBuildFPTrunc(builder, v11[chan], half_bld.vec_type, "");
+      LLVMValueRef res = lp_build_lerp_2d(&half_bld, x, y,
+                                          h00, h01, h10, h11, 0);
+
+      out[chan] = LLVMBuildFPExt(builder, res, bld->vec_type, "");
+   }
+}
+
+
 void
 lp_build_reduce_filter_3d(struct lp_build_context *bld,
                           enum pipe_tex_reduction_mode mode,
@@ -614,6 +614,10 @@ lp_sampler_wrap_mode_uses_border_color(enum pipe_tex_wrap mode,
                                        enum pipe_tex_filter min_img_filter,
                                        enum pipe_tex_filter mag_img_filter);
 
+bool
+lp_sampler_half_filter_supported(const struct lp_static_texture_state *texture,
+                                 const struct lp_static_sampler_state *sampler);
+
 /**
  * Derive the sampler static state.
  */
@@ -887,6 +891,17 @@ lp_build_reduce_filter_2d(struct lp_build_context *bld,
                           LLVMValueRef *v11,
                           LLVMValueRef *out);
 
+void
+lp_build_half_filter_2d(struct lp_build_context *bld,
+                        unsigned num_chan,
+                        LLVMValueRef x,
+                        LLVMValueRef y,
+                        LLVMValueRef *v00,
+                        LLVMValueRef *v01,
+                        LLVMValueRef *v10,
+                        LLVMValueRef *v11,
+                        LLVMValueRef *out);
+
 void
 lp_build_reduce_filter_3d(struct lp_build_context *bld,
                           enum pipe_tex_reduction_mode mode,
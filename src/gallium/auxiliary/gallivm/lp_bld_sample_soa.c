@@ -1152,7 +1152,7 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
    LLVMValueRef s_fpart, t_fpart = NULL, r_fpart = NULL;
    LLVMValueRef xs[4], ys[4], zs[4];
    LLVMValueRef neighbors[2][2][4];
-   bool seamless_cube_filter, accurate_cube_corners;
+   bool seamless_cube_filter, accurate_cube_corners, half_filter;
    unsigned chan_swiz = bld->static_texture_state->swizzle_r;
 
    if (is_gather) {
@@ -1177,6 +1177,15 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
    accurate_cube_corners = ACCURATE_CUBE_CORNERS && seamless_cube_filter &&
      !util_format_is_pure_integer(bld->static_texture_state->format);
 
+   /*
+    * Filter half float textures in half precision where the cpu can do
+    * that natively, converting each bilinear result back to float just once.
+    */
+   half_filter = !is_gather &&
+                 texel_bld->type.floating && texel_bld->type.width == 32 &&
+                 lp_sampler_half_filter_supported(bld->static_texture_state,
+                                                  bld->static_sampler_state);
+
    lp_build_extract_image_sizes(bld,
                                 &bld->int_size_bld,
                                 bld->int_coord_type,
@@ -1725,6 +1734,11 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
             colors0[3] = lp_build_swizzle_soa_channel(texel_bld,
                                                       neighbors[0][0],
                                                       chan_swiz);
+         } else if (half_filter) {
+            lp_build_half_filter_2d(texel_bld, 4, s_fpart, t_fpart,
+                                    neighbors[0][0], neighbors[0][1],
+                                    neighbors[1][0], neighbors[1][1],
+                                    colors0);
          } else {
             /* Bilinear interpolate the four samples from the 2D image / 3D slice */
             lp_build_reduce_filter_2d(texel_bld,
@@ -1808,17 +1822,24 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
 
          if (bld->static_sampler_state->compare_mode == PIPE_TEX_COMPARE_NONE) {
             /* Bilinear interpolate the four samples from the second Z slice */
-            lp_build_reduce_filter_2d(texel_bld,
-                                      bld->static_sampler_state->reduction_mode,
-                                      0,
-                                      4,
-                                      s_fpart,
-                                      t_fpart,
-                                      neighbors1[0][0],
-                                      neighbors1[0][1],
-                                      neighbors1[1][0],
-                                      neighbors1[1][1],
-                                      colors1);
+            if (half_filter) {
+               lp_build_half_filter_2d(texel_bld, 4, s_fpart, t_fpart,
+                                       neighbors1[0][0], neighbors1[0][1],
+                                       neighbors1[1][0], neighbors1[1][1],
+                                       colors1);
+            } else {
+               lp_build_reduce_filter_2d(texel_bld,
+                                         bld->static_sampler_state->reduction_mode,
+                                         0,
+                                         4,
+                                         s_fpart,
+                                         t_fpart,
+                                         neighbors1[0][0],
+                                         neighbors1[0][1],
+                                         neighbors1[1][0],
+                                         neighbors1[1][1],
+                                         colors1);
+            }
 
             /* Linearly interpolate the two samples from the two 3D slices */
             lp_build_reduce_filter(texel_bld,
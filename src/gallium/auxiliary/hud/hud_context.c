@@ -62,6 +62,7 @@
 #include "util/u_memory.h"
 #include "util/u_math.h"
 #include "util/u_sampler.h"
+#include "util/u_cpu_section.h"
 #include "util/u_simple_shaders.h"
 #include "util/u_string.h"
 #include "util/u_upload_mgr.h"
@@ -730,7 +731,8 @@ hud_stop_queries(struct hud_context *hud, struct pipe_context *pipe)
          gr->query_new_value(gr, pipe);
       }
 
-      if (pane->sort_items) {
+      /* Stacked graphs are drawn on top of their predecessors. */
+      if (pane->sort_items && !pane->stacked) {
          LIST_FOR_EACH_ENTRY_SAFE(gr, next, &pane->graph_list, head) {
             /* ignore the last one */
             if (&gr->head == pane->graph_list.prev)
@@ -916,7 +918,7 @@ hud_pane_create(struct hud_context *hud,
                 unsigned x1, unsigned y1, unsigned x2, unsigned y2,
                 unsigned y_simple,
                 unsigned period, uint64_t max_value, uint64_t ceiling,
-                bool dyn_ceiling, bool sort_items)
+                bool dyn_ceiling, bool sort_items, bool stacked)
 {
    struct hud_pane *pane = CALLOC_STRUCT(hud_pane);
 
@@ -941,6 +943,7 @@ hud_pane_create(struct hud_context *hud,
    pane->dyn_ceiling = dyn_ceiling;
    pane->dyn_ceil_last_ran = 0;
    pane->sort_items = sort_items;
+   pane->stacked = stacked;
    pane->initial_max_value = max_value;
    hud_pane_set_max_value(pane, max_value);
    list_inithead(&pane->graph_list);
@@ -1000,6 +1003,15 @@ void
 hud_graph_add_value(struct hud_graph *gr, double value)
 {
    gr->current_value = value;
+
+   /* Draw the sum of this and all previous graphs of the pane. */
+   if (gr->pane->stacked && gr->head.prev != &gr->pane->graph_list) {
+      struct hud_graph *prev = list_entry(gr->head.prev, struct hud_graph, head);
+
+      if (prev->index)
+         value += prev->vertices[(prev->index - 1) * 2 + 1];
+   }
+
    value = value > gr->pane->ceiling ? gr->pane->ceiling : value;
 
    if (gr->fd) {
@@ -1132,7 +1144,7 @@ static char *
 read_pane_settings(char *str, unsigned * const x, unsigned * const y,
                unsigned * const width, unsigned * const height,
                uint64_t * const ceiling, bool * const dyn_ceiling,
-               bool *reset_colors, bool *sort_items)
+               bool *reset_colors, bool *sort_items, bool *stacked)
 {
    char *ret = str;
    unsigned tmp;
@@ -1195,6 +1207,12 @@ read_pane_settings(char *str, unsigned * const x, unsigned * const y,
          *sort_items = true;
          break;
 
+      case 'a':
+         ++str;
+         ret = str;
+         *stacked = true;
+         break;
+
       default:
          fprintf(stderr, "gallium_hud: syntax error: unexpected '%c'\n", *str);
          fflush(stderr);
@@ -1239,6 +1257,7 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
    bool dyn_ceiling = false;
    bool reset_colors = false;
    bool sort_items = false;
+   bool stacked = false;
    bool is_csv = false;
    bool to_stdout = false;
    const char *period_env;
@@ -1268,7 +1287,8 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
 
       /* check for explicit location, size and etc. settings */
       name = read_pane_settings(name_a, &x, &y, &width, &height, &ceiling,
-                                &dyn_ceiling, &reset_colors, &sort_items);
+                                &dyn_ceiling, &reset_colors, &sort_items,
+                                &stacked);
 
      /*
       * Keep track of overall column width to avoid pane overlapping in case
@@ -1279,7 +1299,8 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
 
       if (!pane) {
          pane = hud_pane_create(hud, x, y, x + width, y + height, y_simple,
-                                period, 10, ceiling, dyn_ceiling, sort_items);
+                                period, 10, ceiling, dyn_ceiling, sort_items,
+                                stacked);
          if (!pane)
             return;
       }
@@ -1324,6 +1345,10 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       else if (strcmp(name, "main-thread-busy") == 0) {
          hud_thread_busy_install(pane, name, true);
       }
+      else if (strncmp(name, "cpu-time-", 9) == 0 &&
+               hud_cpu_section_install(pane, name, name + 9)) {
+         pane->type = PIPE_DRIVER_QUERY_TYPE_MICROSECONDS;
+      }
 #ifdef HAVE_GALLIUM_EXTRA_HUD
       else if (sscanf(name, "nic-rx-%s", arg_name) == 1) {
          hud_nic_graph_install(pane, arg_name, NIC_DIRECTION_RX);
@@ -1546,6 +1571,7 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       ceiling = UINT64_MAX;
       dyn_ceiling = false;
       sort_items = false;
+      stacked = false;
 
    }
 
@@ -1619,6 +1645,7 @@ print_help(struct pipe_screen *screen)
    puts("      the Y axis to match the highest value still visible in the graph.");
    puts("  'r' resets the color counter (the next color will be green)");
    puts("  's' sort items below graphs in descending order");
+   puts("  'a' stacks the graphs, each is drawn on top of the previous ones");
    puts("");
    puts("  If 'c' and 'd' modifiers are used simultaneously, both are in effect:");
    puts("  the Y axis does not go above the restriction imposed by 'c' while");
@@ -1640,6 +1667,9 @@ print_help(struct pipe_screen *screen)
    for (i = 0; i < num_cpus; i++)
       printf("    cpu%i\n", i);
 
+   for (i = 0; i < UTIL_CPU_SECTION_COUNT; i++)
+      printf("    cpu-time-%s (per frame)\n", util_cpu_section_name(i));
+
    if (has_occlusion_query(screen))
       puts("    samples-passed");
    if (has_streamout(screen))
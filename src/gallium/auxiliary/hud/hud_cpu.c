@@ -33,6 +33,7 @@
 #include "util/u_thread.h"
 #include "util/u_memory.h"
 #include "util/u_queue.h"
+#include "util/u_cpu_section.h"
 #include <stdio.h>
 #include <inttypes.h>
 #if DETECT_OS_WINDOWS
@@ -474,3 +475,78 @@ void hud_thread_counter_install(struct hud_pane *pane, const char *name,
    hud_pane_add_graph(pane, gr);
    hud_pane_set_max_value(pane, 100);
 }
+
+struct cpu_section_info {
+   enum util_cpu_section section;
+   unsigned frames;
+   int64_t last_time;
+   uint64_t last_section_time;
+};
+
+static void
+query_cpu_section(struct hud_graph *gr, struct pipe_context *pipe)
+{
+   struct cpu_section_info *info = gr->query_data;
+   int64_t now = os_time_get_nano();
+   uint64_t section_time =
+      p_atomic_read(&util_cpu_section_time_ns[info->section]);
+
+   info->frames++;
+
+   if (info->last_time) {
+      if (info->last_time + gr->pane->period*1000 <= now) {
+         /* microseconds per frame */
+         hud_graph_add_value(gr, (section_time - info->last_section_time) /
+                                 (1000.0 * info->frames));
+
+         info->frames = 0;
+         info->last_time = now;
+         info->last_section_time = section_time;
+      }
+   } else {
+      /* initialize */
+      info->frames = 0;
+      info->last_time = now;
+      info->last_section_time = section_time;
+   }
+}
+
+bool
+hud_cpu_section_install(struct hud_pane *pane, const char *name,
+                        const char *section_name)
+{
+   struct hud_graph *gr;
+   unsigned i;
+
+   for (i = 0; i < UTIL_CPU_SECTION_COUNT; i++) {
+      if (!strcmp(section_name, util_cpu_section_name(i)))
+         break;
+   }
+   if (i == UTIL_CPU_SECTION_COUNT)
+      return false;
+
+   gr = CALLOC_STRUCT(hud_graph);
+   if (!gr)
+      return true;
+
+   strcpy(gr->name, name);
+
+   gr->query_data = CALLOC_STRUCT(cpu_section_info);
+   if (!gr->query_data) {
+      FREE(gr);
+      return true;
+   }
+
+   ((struct cpu_section_info*)gr->query_data)->section = i;
+   gr->query_new_value = query_cpu_section;
+
+   /* Don't use free() as our callback as that messes up Gallium's
+    * memory debugger.  Use simple free_query_data() wrapper.
+    */
+   gr->free_query_data = free_query_data;
+
+   util_cpu_sections_enable();
+
+   hud_pane_add_graph(pane, gr);
+   return true;
+}
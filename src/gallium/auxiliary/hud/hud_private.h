@@ -145,6 +145,7 @@ struct hud_pane {
    unsigned dyn_ceil_last_ran;
    bool dyn_ceiling;
    bool sort_items;
+   bool stacked;
    enum pipe_driver_query_type type;
    uint64_t period; /* in microseconds */
 
@@ -172,6 +173,8 @@ void hud_cpu_graph_install(struct hud_pane *pane, unsigned cpu_index);
 void hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main);
 void hud_thread_counter_install(struct hud_pane *pane, const char *name,
                                 enum hud_counter counter);
+bool hud_cpu_section_install(struct hud_pane *pane, const char *name,
+                             const char *section_name);
 void hud_pipe_query_install(struct hud_batch_query_context **pbq,
                             struct hud_pane *pane,
                             const char *name,
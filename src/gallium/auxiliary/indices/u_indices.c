@@ -24,6 +24,7 @@
 
 #include "u_indices.h"
 #include "u_indices_priv.h"
+#include "u_indices_simd.h"
 
 static void translate_byte_to_ushort( const void *in,
                                       unsigned start,
@@ -32,11 +33,7 @@ static void translate_byte_to_ushort( const void *in,
                                       UNUSED unsigned restart_index,
                                       void *out )
 {
-   uint8_t *src = (uint8_t *)in + start;
-   uint16_t *dst = out;
-   while (out_nr--) {
-      *dst++ = *src++;
-   }
+   u_index_widen_8_to_16((const uint8_t *)in + start, out, out_nr);
 }
 
 enum mesa_prim
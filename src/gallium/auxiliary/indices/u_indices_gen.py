@@ -85,6 +85,7 @@ def prolog(f: 'T.TextIO') -> None:
  */
 
 #include "indices/u_indices_priv.h"
+#include "indices/u_indices_simd.h"
 #include "util/u_debug.h"
 #include "util/u_memory.h"
 
@@ -200,6 +201,14 @@ def prim_restart(f: 'T.TextIO', in_verts, out_verts, out_prims, close_func = Non
 
 def points(f: 'T.TextIO', intype, outtype, inpv, outpv, pr):
     preamble(f, intype, outtype, inpv, outpv, pr, out_prim=OUT_TRIS, prim='points')
+    widen = {(UINT8, UINT16): 'u_index_widen_8_to_16',
+             (UINT8, UINT32): 'u_index_widen_8_to_32',
+             (UINT16, UINT32): 'u_index_widen_16_to_32'}.get((intype, outtype))
+    if widen is not None:
+        f.write(f'  (void)i;\n')
+        f.write(f'  {widen}(in + start, out, out_nr);\n')
+        postamble(f)
+        return
     f.write('  for (i = start, j = 0; j < out_nr; j++, i++) {\n')
     do_point(f, intype, outtype, 'out+j',  'i' );
     f.write('   }\n')
@@ -292,9 +301,31 @@ def polygon(f: 'T.TextIO', intype, outtype, inpv, outpv, pr):
     postamble(f)
 
 
+def quad_tris_pattern(inpv, outpv):
+    """The six quad vertices do_quad() emits for OUT_TRIS, as 0..3."""
+    def tri(v):
+        if inpv == outpv:
+            return v
+        elif inpv == FIRST:
+            return [v[1], v[2], v[0]]
+        else:
+            return [v[2], v[0], v[1]]
+    if inpv == LAST:
+        return tri([0, 1, 3]) + tri([1, 2, 3])
+    else:
+        return tri([0, 1, 2]) + tri([0, 2, 3])
+
 def quads(f: 'T.TextIO', intype, outtype, inpv, outpv, pr, out_prim):
     preamble(f, intype, outtype, inpv, outpv, pr, out_prim=out_prim, prim='quads')
-    if out_prim == OUT_TRIS:
+    if (out_prim == OUT_TRIS and pr == PRDISABLE and intype == outtype and
+        intype in (UINT16, UINT32)):
+        bits = 16 if intype == UINT16 else 32
+        pattern = ', '.join(str(p) for p in quad_tris_pattern(inpv, outpv))
+        f.write('  i = start;\n')
+        f.write('  j = 0;\n')
+        f.write(f'  U_INDEX_QUADS_TO_TRIS_{bits}(in, out, i, j, out_nr, {pattern})\n')
+        f.write('  for (; j < out_nr; j+=6, i+=4) {\n')
+    elif out_prim == OUT_TRIS:
         f.write('  for (i = start, j = 0; j < out_nr; j+=6, i+=4) {\n')
     else:
         f.write('  for (i = start, j = 0; j < out_nr; j+=4, i+=4) {\n')
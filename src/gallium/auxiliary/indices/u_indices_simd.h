@@ -0,0 +1,353 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Vector helpers for the index translation hot paths: widening, primitive
+ * restart scanning and rewriting, and quads to triangles.
+ *
+ * Only the baseline instruction sets are used, SSE2 on x86 and NEON on
+ * aarch64, so that no runtime dispatch is needed.  Everything has a scalar
+ * fallback, and every function handles any count.
+ */
+
+#ifndef U_INDICES_SIMD_H
+#define U_INDICES_SIMD_H
+
+#include <string.h>
+
+#include "util/detect_arch.h"
+#include "util/macros.h"
+
+#if DETECT_ARCH_SSE
+#include <emmintrin.h>
+#elif DETECT_ARCH_AARCH64
+#include <arm_neon.h>
+#endif
+
+
+static inline void
+u_index_widen_8_to_16(const uint8_t *restrict in, uint16_t *restrict out,
+                      unsigned n)
+{
+   unsigned i = 0;
+
+#if DETECT_ARCH_SSE
+   const __m128i zero = _mm_setzero_si128();
+
+   for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_unpacklo_epi8(v, zero));
+      _mm_storeu_si128((__m128i *)(out + i + 8), _mm_unpackhi_epi8(v, zero));
+   }
+#elif DETECT_ARCH_AARCH64
+   for (; i + 16 <= n; i += 16) {
+      uint8x16_t v = vld1q_u8(in + i);
+      vst1q_u16(out + i, vmovl_u8(vget_low_u8(v)));
+      vst1q_u16(out + i + 8, vmovl_u8(vget_high_u8(v)));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i];
+}
+
+static inline void
+u_index_widen_8_to_32(const uint8_t *restrict in, uint32_t *restrict out,
+                      unsigned n)
+{
+   unsigned i = 0;
+
+#if DETECT_ARCH_SSE
+   const __m128i zero = _mm_setzero_si128();
+
+   for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(in + i)), zero);
+      _mm_storeu_si128((__m128i *)(out + i), _mm_unpacklo_epi16(v, zero));
+      _mm_storeu_si128((__m128i *)(out + i + 4), _mm_unpackhi_epi16(v, zero));
+   }
+#elif DETECT_ARCH_AARCH64
+   for (; i + 8 <= n; i += 8) {
+      uint16x8_t v = vmovl_u8(vld1_u8(in + i));
+      vst1q_u32(out + i, vmovl_u16(vget_low_u16(v)));
+      vst1q_u32(out + i + 4, vmovl_u16(vget_high_u16(v)));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i];
+}
+
+static inline void
+u_index_widen_16_to_32(const uint16_t *restrict in, uint32_t *restrict out,
+                       unsigned n)
+{
+   unsigned i = 0;
+
+#if DETECT_ARCH_SSE
+   const __m128i zero = _mm_setzero_si128();
+
+   for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_unpacklo_epi16(v, zero));
+      _mm_storeu_si128((__m128i *)(out + i + 4), _mm_unpackhi_epi16(v, zero));
+   }
+#elif DETECT_ARCH_AARCH64
+   for (; i + 8 <= n; i += 8) {
+      uint16x8_t v = vld1q_u16(in + i);
+      vst1q_u32(out + i, vmovl_u16(vget_low_u16(v)));
+      vst1q_u32(out + i + 4, vmovl_u16(vget_high_u16(v)));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i];
+}
+
+
+/**
+ * Return the position of the first index equal to restart_index in
+ * in[start..n), or n if there is none.
+ */
+static inline unsigned
+u_index_find_restart(const void *in, unsigned index_size,
+                     unsigned start, unsigned n, unsigned restart_index)
+{
+   unsigned i = start;
+
+#if DETECT_ARCH_SSE || DETECT_ARCH_AARCH64
+   /* A restart index that does not fit the index type never matches. */
+   if (index_size < 4 && restart_index >> (index_size * 8))
+      return n;
+
+   const unsigned step = 16 / index_size;
+   for (; i + step <= n; i += step) {
+      const uint8_t *p = (const uint8_t *)in + i * index_size;
+#if DETECT_ARCH_SSE
+      __m128i v = _mm_loadu_si128((const __m128i *)p);
+      __m128i eq;
+
+      if (index_size == 1)
+         eq = _mm_cmpeq_epi8(v, _mm_set1_epi8(restart_index));
+      else if (index_size == 2)
+         eq = _mm_cmpeq_epi16(v, _mm_set1_epi16(restart_index));
+      else
+         eq = _mm_cmpeq_epi32(v, _mm_set1_epi32(restart_index));
+
+      if (_mm_movemask_epi8(eq))
+         break;
+#else
+      uint8x16_t v = vld1q_u8(p);
+      uint8x16_t eq;
+
+      if (index_size == 1)
+         eq = vceqq_u8(v, vdupq_n_u8(restart_index));
+      else if (index_size == 2)
+         eq = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(v),
+                                             vdupq_n_u16(restart_index)));
+      else
+         eq = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(v),
+                                             vdupq_n_u32(restart_index)));
+
+      if (vmaxvq_u8(eq))
+         break;
+#endif
+   }
+#endif
+
+   /* Finish the vector that matched, or the tail. */
+   switch (index_size) {
+   case 1:
+      for (; i < n; i++)
+         if (((const uint8_t *)in)[i] == restart_index)
+            return i;
+      break;
+   case 2:
+      for (; i < n; i++)
+         if (((const uint16_t *)in)[i] == restart_index)
+            return i;
+      break;
+   default:
+      for (; i < n; i++)
+         if (((const uint32_t *)in)[i] == restart_index)
+            return i;
+      break;
+   }
+
+   return n;
+}
+
+
+/**
+ * out[i] = in[i] == restart ? 0xffff : in[i]; in and out may alias for the
+ * 16 and 32-bit variants.
+ */
+static inline void
+u_index_replace_restart_8_to_16(const uint8_t *in, uint16_t *out,
+                                unsigned n, unsigned restart_index)
+{
+   unsigned i = 0;
+
+   if (restart_index > 0xff) {
+      u_index_widen_8_to_16(in, out, n);
+      return;
+   }
+
+#if DETECT_ARCH_SSE
+   const __m128i restart = _mm_set1_epi8(restart_index);
+
+   for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      __m128i eq = _mm_cmpeq_epi8(v, restart);
+
+      /* The matching bytes become 0xff and their high bytes 0xff too. */
+      _mm_storeu_si128((__m128i *)(out + i),
+                       _mm_unpacklo_epi8(_mm_or_si128(v, eq), eq));
+      _mm_storeu_si128((__m128i *)(out + i + 8),
+                       _mm_unpackhi_epi8(_mm_or_si128(v, eq), eq));
+   }
+#elif DETECT_ARCH_AARCH64
+   const uint8x16_t restart = vdupq_n_u8(restart_index);
+
+   for (; i + 16 <= n; i += 16) {
+      uint8x16_t v = vld1q_u8(in + i);
+      uint8x16_t eq = vceqq_u8(v, restart);
+      uint8x16x2_t z = vzipq_u8(vorrq_u8(v, eq), eq);
+
+      vst1q_u16(out + i, vreinterpretq_u16_u8(z.val[0]));
+      vst1q_u16(out + i + 8, vreinterpretq_u16_u8(z.val[1]));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i] == restart_index ? 0xffff : in[i];
+}
+
+static inline void
+u_index_replace_restart_16(const uint16_t *in, uint16_t *out,
+                           unsigned n, unsigned restart_index)
+{
+   unsigned i = 0;
+
+   if (restart_index > 0xffff) {
+      if (in != out)
+         memmove(out, in, n * sizeof(*out));
+      return;
+   }
+
+#if DETECT_ARCH_SSE
+   const __m128i restart = _mm_set1_epi16(restart_index);
+
+   for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i),
+                       _mm_or_si128(v, _mm_cmpeq_epi16(v, restart)));
+   }
+#elif DETECT_ARCH_AARCH64
+   const uint16x8_t restart = vdupq_n_u16(restart_index);
+
+   for (; i + 8 <= n; i += 8) {
+      uint16x8_t v = vld1q_u16(in + i);
+      vst1q_u16(out + i, vorrq_u16(v, vceqq_u16(v, restart)));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i] == restart_index ? 0xffff : in[i];
+}
+
+static inline void
+u_index_replace_restart_32(const uint32_t *in, uint32_t *out,
+                           unsigned n, unsigned restart_index)
+{
+   unsigned i = 0;
+
+#if DETECT_ARCH_SSE
+   const __m128i restart = _mm_set1_epi32(restart_index);
+
+   for (; i + 4 <= n; i += 4) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+      _mm_storeu_si128((__m128i *)(out + i),
+                       _mm_or_si128(v, _mm_cmpeq_epi32(v, restart)));
+   }
+#elif DETECT_ARCH_AARCH64
+   const uint32x4_t restart = vdupq_n_u32(restart_index);
+
+   for (; i + 4 <= n; i += 4) {
+      uint32x4_t v = vld1q_u32(in + i);
+      vst1q_u32(out + i, vorrq_u32(v, vceqq_u32(v, restart)));
+   }
+#endif
+
+   for (; i < n; i++)
+      out[i] = in[i] == restart_index ? 0xffffffff : in[i];
+}
+
+
+/*
+ * Quads to triangles without primitive restart: every quad i[0..3] turns
+ * into the six indices i[p0] .. i[p5].  These are macros because the
+ * shuffles need immediates.  They advance i by 4 and j by 6 per quad and
+ * leave whatever is left for the scalar loop that follows.
+ */
+#if DETECT_ARCH_SSE
+
+#define U_INDEX_QUADS_TO_TRIS_32(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5) \
+   for (; (j) + 6 <= (out_nr); (j) += 6, (i) += 4) {                          \
+      __m128i _q = _mm_loadu_si128((const __m128i *)((in) + (i)));              \
+      _mm_storeu_si128((__m128i *)((out) + (j)),                               \
+                       _mm_shuffle_epi32(_q, _MM_SHUFFLE(p3, p2, p1, p0)));    \
+      _mm_storel_epi64((__m128i *)((out) + (j) + 4),                           \
+                       _mm_shuffle_epi32(_q, _MM_SHUFFLE(0, 0, p5, p4)));      \
+   }
+
+#define U_INDEX_QUADS_TO_TRIS_16(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5) \
+   for (; (j) + 6 <= (out_nr); (j) += 6, (i) += 4) {                          \
+      __m128i _q = _mm_loadl_epi64((const __m128i *)((in) + (i)));              \
+      uint32_t _hi = _mm_cvtsi128_si32(                                        \
+         _mm_shufflelo_epi16(_q, _MM_SHUFFLE(0, 0, p5, p4)));                  \
+      _mm_storel_epi64((__m128i *)((out) + (j)),                               \
+                       _mm_shufflelo_epi16(_q, _MM_SHUFFLE(p3, p2, p1, p0)));  \
+      memcpy((out) + (j) + 4, &_hi, 4);                                        \
+   }
+
+#elif DETECT_ARCH_AARCH64
+
+#define U_INDEX_BYTES_32(p) 4 * (p), 4 * (p) + 1, 4 * (p) + 2, 4 * (p) + 3
+#define U_INDEX_BYTES_16(p) 2 * (p), 2 * (p) + 1
+
+#define U_INDEX_QUADS_TO_TRIS_32(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5) \
+   for (; (j) + 6 <= (out_nr); (j) += 6, (i) += 4) {                          \
+      static const uint8_t _lo[16] = {                                         \
+         U_INDEX_BYTES_32(p0), U_INDEX_BYTES_32(p1),                           \
+         U_INDEX_BYTES_32(p2), U_INDEX_BYTES_32(p3) };                         \
+      static const uint8_t _hi[8] = {                                          \
+         U_INDEX_BYTES_32(p4), U_INDEX_BYTES_32(p5) };                         \
+      uint8x16_t _q = vreinterpretq_u8_u32(vld1q_u32((in) + (i)));              \
+      vst1q_u32((out) + (j), vreinterpretq_u32_u8(vqtbl1q_u8(_q, vld1q_u8(_lo)))); \
+      vst1_u32((out) + (j) + 4, vreinterpret_u32_u8(vqtbl1_u8(_q, vld1_u8(_hi)))); \
+   }
+
+#define U_INDEX_QUADS_TO_TRIS_16(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5) \
+   for (; (j) + 6 <= (out_nr); (j) += 6, (i) += 4) {                          \
+      static const uint8_t _lo[8] = {                                          \
+         U_INDEX_BYTES_16(p0), U_INDEX_BYTES_16(p1),                           \
+         U_INDEX_BYTES_16(p2), U_INDEX_BYTES_16(p3) };                         \
+      static const uint8_t _hi[8] = {                                          \
+         U_INDEX_BYTES_16(p4), U_INDEX_BYTES_16(p5), 0, 0, 0, 0 };             \
+      uint8x8_t _q = vreinterpret_u8_u16(vld1_u16((in) + (i)));                 \
+      uint32_t _h = vget_lane_u32(vreinterpret_u32_u8(vtbl1_u8(_q, vld1_u8(_hi))), 0); \
+      vst1_u16((out) + (j), vreinterpret_u16_u8(vtbl1_u8(_q, vld1_u8(_lo))));   \
+      memcpy((out) + (j) + 4, &_h, 4);                                         \
+   }
+
+#else
+
+#define U_INDEX_QUADS_TO_TRIS_32(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5)
+#define U_INDEX_QUADS_TO_TRIS_16(in, out, i, j, out_nr, p0, p1, p2, p3, p4, p5)
+
+#endif
+
+#endif /* U_INDICES_SIMD_H */
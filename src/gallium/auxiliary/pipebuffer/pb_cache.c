@@ -29,6 +29,13 @@
 #include "pb_cache.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
+#include "util/u_math.h"
+
+/* Limits of the per-bucket keep time, relative to the one the cache was
+ * created with.
+ */
+#define PB_CACHE_MIN_MSECS_SHIFT 2
+#define PB_CACHE_MAX_MSECS_SHIFT 3
 
 /*
  * Helper function for detecting time outs, taking in account overflow.
@@ -59,6 +66,44 @@ get_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry)
    return (struct pb_buffer_lean*)((char*)entry - mgr->offsetof_pb_cache_entry);
 }
 
+static unsigned
+get_size_class(uint64_t size)
+{
+   unsigned log2 = util_logbase2_64(MAX2(size, 1));
+
+   if (log2 <= PB_CACHE_MIN_SIZE_CLASS_LOG2)
+      return 0;
+
+   return MIN2(log2 - PB_CACHE_MIN_SIZE_CLASS_LOG2,
+               PB_CACHE_NUM_SIZE_CLASSES - 1);
+}
+
+static struct pb_cache_bucket *
+get_bucket(struct pb_cache *mgr, unsigned heap, uint64_t size)
+{
+   return &mgr->buckets[heap * PB_CACHE_NUM_SIZE_CLASSES + get_size_class(size)];
+}
+
+/**
+ * Remove the buffer from the cache without destroying it.
+ */
+static void
+remove_buffer_locked(struct pb_cache *mgr, struct pb_cache_entry *entry)
+{
+   struct pb_buffer_lean *buf = get_buffer(mgr, entry);
+   struct pb_cache_bucket *bucket =
+      get_bucket(mgr, entry->bucket_index, buf->size);
+
+   list_del(&entry->head);
+   list_del(&entry->lru);
+   if (list_is_empty(&bucket->buffers))
+      list_delinit(&bucket->link);
+
+   assert(mgr->num_buffers);
+   --mgr->num_buffers;
+   mgr->cache_size -= buf->size;
+}
+
 /**
  * Actually destroy the buffer.
  */
@@ -68,38 +113,49 @@ destroy_buffer_locked(struct pb_cache *mgr, struct pb_cache_entry *entry)
    struct pb_buffer_lean *buf = get_buffer(mgr, entry);
 
    assert(!pipe_is_referenced(&buf->reference));
-   if (list_is_linked(&entry->head)) {
-      list_del(&entry->head);
-      assert(mgr->num_buffers);
-      --mgr->num_buffers;
-      mgr->cache_size -= buf->size;
-   }
+   if (list_is_linked(&entry->head))
+      remove_buffer_locked(mgr, entry);
    mgr->destroy_buffer(mgr->winsys, buf);
 }
 
 /**
- * Free as many cache buffers from the list head as possible.
+ * Destroy a buffer that wasn't reused within the keep time of its bucket.
+ *
+ * If nothing was taken from the bucket since the last expiration, the size
+ * class isn't popular enough for its keep time, so shorten it.
  */
 static void
-release_expired_buffers_locked(struct pb_cache *mgr, struct list_head *cache,
-                               unsigned current_time_ms)
+expire_buffer_locked(struct pb_cache *mgr, struct pb_cache_bucket *bucket,
+                     struct pb_cache_entry *entry, unsigned current_time_ms)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *entry;
-
-   curr = cache->next;
-   next = curr->next;
-   while (curr != cache) {
-      entry = list_entry(curr, struct pb_cache_entry, head);
+   if (!bucket->hits_since_expired &&
+       (!bucket->expired_recently ||
+        time_timeout_ms(bucket->last_expired_ms, bucket->msecs, current_time_ms)))
+      bucket->msecs = MAX2(bucket->msecs / 2,
+                           mgr->msecs >> PB_CACHE_MIN_MSECS_SHIFT);
+
+   bucket->last_expired_ms = current_time_ms;
+   bucket->hits_since_expired = 0;
+   bucket->expired_recently = true;
+   mgr->stats.expired++;
+
+   destroy_buffer_locked(mgr, entry);
+}
 
-      if (!time_timeout_ms(entry->start_ms, mgr->msecs,
-                           current_time_ms))
+/**
+ * Free as many cache buffers from the bucket as possible.
+ */
+static void
+release_expired_buffers_locked(struct pb_cache *mgr,
+                               struct pb_cache_bucket *bucket,
+                               unsigned current_time_ms)
+{
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &bucket->buffers,
+                            head) {
+      if (!time_timeout_ms(entry->start_ms, bucket->msecs, current_time_ms))
          break;
 
-      destroy_buffer_locked(mgr, entry);
-
-      curr = next;
-      next = curr->next;
+      expire_buffer_locked(mgr, bucket, entry, current_time_ms);
    }
 }
 
@@ -110,27 +166,41 @@ release_expired_buffers_locked(struct pb_cache *mgr, struct list_head *cache,
 void
 pb_cache_add_buffer(struct pb_cache *mgr, struct pb_cache_entry *entry)
 {
-   struct list_head *cache = &mgr->buckets[entry->bucket_index];
    struct pb_buffer_lean *buf = get_buffer(mgr, entry);
-   unsigned i;
+   struct pb_cache_bucket *bucket =
+      get_bucket(mgr, entry->bucket_index, buf->size);
 
    simple_mtx_lock(&mgr->mutex);
    assert(!pipe_is_referenced(&buf->reference));
 
    unsigned current_time_ms = time_get_ms(mgr);
 
-   for (i = 0; i < mgr->num_heaps; i++)
-      release_expired_buffers_locked(mgr, &mgr->buckets[i], current_time_ms);
+   list_for_each_entry_safe(struct pb_cache_bucket, active,
+                            &mgr->active_buckets, link)
+      release_expired_buffers_locked(mgr, active, current_time_ms);
 
-   /* Directly release any buffer that exceeds the limit. */
-   if (mgr->cache_size + buf->size > mgr->max_cache_size) {
+   /* Directly release any buffer that exceeds the limit by itself. */
+   if (buf->size > mgr->max_cache_size) {
+      mgr->stats.trimmed++;
       mgr->destroy_buffer(mgr->winsys, buf);
       simple_mtx_unlock(&mgr->mutex);
       return;
    }
 
-   entry->start_ms = time_get_ms(mgr);
-   list_addtail(&entry->head, cache);
+   /* Otherwise make room by dropping the buffers that have been unused for
+    * the longest time, the new one is the most likely to be needed again.
+    */
+   while (mgr->cache_size + buf->size > mgr->max_cache_size) {
+      mgr->stats.trimmed++;
+      destroy_buffer_locked(mgr, list_first_entry(&mgr->lru,
+                                                  struct pb_cache_entry, lru));
+   }
+
+   entry->start_ms = current_time_ms;
+   list_addtail(&entry->head, &bucket->buffers);
+   list_addtail(&entry->lru, &mgr->lru);
+   if (!list_is_linked(&bucket->link))
+      list_addtail(&bucket->link, &mgr->active_buckets);
    ++mgr->num_buffers;
    mgr->cache_size += buf->size;
    simple_mtx_unlock(&mgr->mutex);
@@ -165,38 +235,31 @@ pb_cache_is_buffer_compat(struct pb_cache *mgr, struct pb_cache_entry *entry,
 }
 
 /**
- * Find a compatible buffer in the cache, return it, and remove it
- * from the cache.
+ * Find a compatible buffer in one bucket, expiring old buffers on the way.
  */
-struct pb_buffer_lean *
-pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
-                        unsigned alignment, unsigned usage,
-                        unsigned bucket_index)
+static struct pb_cache_entry *
+reclaim_from_bucket_locked(struct pb_cache *mgr, struct pb_cache_bucket *bucket,
+                           pb_size size, unsigned alignment, unsigned usage,
+                           unsigned now)
 {
-   struct pb_cache_entry *entry;
+   struct list_head *cache = &bucket->buffers;
+   struct pb_cache_entry *entry = NULL;
    struct pb_cache_entry *cur_entry;
    struct list_head *cur, *next;
    int ret = 0;
 
-   assert(bucket_index < mgr->num_heaps);
-   struct list_head *cache = &mgr->buckets[bucket_index];
-
-   simple_mtx_lock(&mgr->mutex);
-
-   entry = NULL;
    cur = cache->next;
    next = cur->next;
 
    /* search in the expired buffers, freeing them in the process */
-   unsigned now = time_get_ms(mgr);
    while (cur != cache) {
       cur_entry = list_entry(cur, struct pb_cache_entry, head);
 
       if (!entry && (ret = pb_cache_is_buffer_compat(mgr, cur_entry, size,
                                                      alignment, usage)) > 0)
          entry = cur_entry;
-      else if (time_timeout_ms(cur_entry->start_ms, mgr->msecs, now))
-         destroy_buffer_locked(mgr, cur_entry);
+      else if (time_timeout_ms(cur_entry->start_ms, bucket->msecs, now))
+         expire_buffer_locked(mgr, bucket, cur_entry, now);
       else
          /* This buffer (and all hereafter) are still hot in cache */
          break;
@@ -227,19 +290,68 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
       }
    }
 
+   return entry;
+}
+
+/**
+ * Find a compatible buffer in the cache, return it, and remove it
+ * from the cache.
+ */
+struct pb_buffer_lean *
+pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
+                        unsigned alignment, unsigned usage,
+                        unsigned bucket_index)
+{
+   struct pb_cache_entry *entry = NULL;
+
+   assert(bucket_index < mgr->num_heaps);
+
+   /* Compatible buffers can be up to size_factor times bigger, which may
+    * put them into the next size classes.
+    */
+   struct pb_cache_bucket *first = get_bucket(mgr, bucket_index, size);
+   struct pb_cache_bucket *last =
+      get_bucket(mgr, bucket_index, (uint64_t)(mgr->size_factor * size));
+
+   simple_mtx_lock(&mgr->mutex);
+
+   unsigned now = time_get_ms(mgr);
+
+   /* Expirations while searching are of incompatible buffers. */
+   bool expired_recently = first->expired_recently &&
+      !time_timeout_ms(first->last_expired_ms, first->msecs, now);
+
+   for (struct pb_cache_bucket *bucket = first; bucket <= last; bucket++) {
+      entry = reclaim_from_bucket_locked(mgr, bucket, size, alignment, usage,
+                                         now);
+      if (entry) {
+         bucket->hits_since_expired++;
+         break;
+      }
+   }
+
    /* found a compatible buffer, return it */
    if (entry) {
       struct pb_buffer_lean *buf = get_buffer(mgr, entry);
 
-      mgr->cache_size -= buf->size;
-      list_del(&entry->head);
-      --mgr->num_buffers;
+      remove_buffer_locked(mgr, entry);
+      mgr->stats.hits++;
       simple_mtx_unlock(&mgr->mutex);
       /* Increase refcount */
       pipe_reference_init(&buf->reference, 1);
       return buf;
    }
 
+   /* A buffer of this size class expired shortly before it would have been
+    * reused, so the keep time is too short for how the class is used.
+    */
+   if (expired_recently) {
+      first->msecs = MIN2(first->msecs * 2,
+                          mgr->msecs << PB_CACHE_MAX_MSECS_SHIFT);
+      first->expired_recently = false;
+   }
+
+   mgr->stats.misses++;
    simple_mtx_unlock(&mgr->mutex);
    return NULL;
 }
@@ -250,29 +362,31 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
 unsigned
 pb_cache_release_all_buffers(struct pb_cache *mgr)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *buf;
    unsigned num_reclaims = 0;
-   unsigned i;
 
    simple_mtx_lock(&mgr->mutex);
-   for (i = 0; i < mgr->num_heaps; i++) {
-      struct list_head *cache = &mgr->buckets[i];
-
-      curr = cache->next;
-      next = curr->next;
-      while (curr != cache) {
-         buf = list_entry(curr, struct pb_cache_entry, head);
-         destroy_buffer_locked(mgr, buf);
-         num_reclaims++;
-         curr = next;
-         next = curr->next;
-      }
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &mgr->lru, lru) {
+      destroy_buffer_locked(mgr, entry);
+      num_reclaims++;
    }
+   mgr->stats.trimmed += num_reclaims;
    simple_mtx_unlock(&mgr->mutex);
    return num_reclaims;
 }
 
+/**
+ * Return the reuse statistics of the cache, e.g. for driver queries.
+ */
+void
+pb_cache_get_stats(struct pb_cache *mgr, struct pb_cache_stats *stats)
+{
+   simple_mtx_lock(&mgr->mutex);
+   *stats = mgr->stats;
+   stats->cache_size = mgr->cache_size;
+   stats->num_buffers = mgr->num_buffers;
+   simple_mtx_unlock(&mgr->mutex);
+}
+
 void
 pb_cache_init_entry(struct pb_cache *mgr, struct pb_cache_entry *entry,
                     struct pb_buffer_lean *buf, unsigned bucket_index)
@@ -291,13 +405,16 @@ pb_cache_init_entry(struct pb_cache *mgr, struct pb_cache_entry *entry,
  *                   for faster buffer matching (alternative to slower
  *                   "usage"-based matching).
  * @param usecs   Unused buffers may be released from the cache after this
- *                time
+ *                time. The cache adjusts it per size class, between a
+ *                quarter and 8 times of it, depending on how often buffers
+ *                of the class are reused.
  * @param size_factor  Declare buffers that are size_factor times bigger than
  *                     the requested size as cache hits.
  * @param bypass_usage  Bitmask. If (requested usage & bypass_usage) != 0,
  *                      buffer allocation requests are rejected.
  * @param maximum_cache_size  Maximum size of all unused buffers the cache can
- *                            hold.
+ *                            hold. The least recently added buffers are
+ *                            released to stay below it.
  * @param offsetof_pb_cache_entry  offsetof(driver_bo, pb_cache_entry)
  * @param destroy_buffer  Function that destroys a buffer for good.
  * @param can_reclaim     Whether a buffer can be reclaimed (e.g. is not busy)
@@ -310,14 +427,20 @@ pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
               void (*destroy_buffer)(void *winsys, struct pb_buffer_lean *buf),
               bool (*can_reclaim)(void *winsys, struct pb_buffer_lean *buf))
 {
+   unsigned num_buckets = num_heaps * PB_CACHE_NUM_SIZE_CLASSES;
    unsigned i;
 
-   mgr->buckets = CALLOC(num_heaps, sizeof(struct list_head));
+   mgr->buckets = CALLOC(num_buckets, sizeof(struct pb_cache_bucket));
    if (!mgr->buckets)
       return;
 
-   for (i = 0; i < num_heaps; i++)
-      list_inithead(&mgr->buckets[i]);
+   for (i = 0; i < num_buckets; i++) {
+      list_inithead(&mgr->buckets[i].buffers);
+      list_inithead(&mgr->buckets[i].link);
+      mgr->buckets[i].msecs = usecs / 1000;
+   }
+   list_inithead(&mgr->active_buckets);
+   list_inithead(&mgr->lru);
 
    (void) simple_mtx_init(&mgr->mutex, mtx_plain);
    mgr->winsys = winsys;
@@ -330,6 +453,7 @@ pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
    mgr->bypass_usage = bypass_usage;
    mgr->size_factor = size_factor;
    mgr->offsetof_pb_cache_entry = offsetof_pb_cache_entry;
+   memset(&mgr->stats, 0, sizeof(mgr->stats));
    mgr->destroy_buffer = destroy_buffer;
    mgr->can_reclaim = can_reclaim;
 }
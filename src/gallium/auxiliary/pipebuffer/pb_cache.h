@@ -34,22 +34,57 @@
 #include "util/list.h"
 #include "util/u_thread.h"
 
+/* Each heap is further divided into power-of-two size classes, starting
+ * with everything up to 8 KB.
+ */
+#define PB_CACHE_MIN_SIZE_CLASS_LOG2 12
+#define PB_CACHE_NUM_SIZE_CLASSES 32
+
 /**
  * Statically inserted into the driver-specific buffer structure.
  */
 struct pb_cache_entry
 {
    struct list_head head;
+   struct list_head lru; /**< In pb_cache::lru */
    unsigned start_ms; /**< Cached start time */
    unsigned bucket_index;
 };
 
+struct pb_cache_bucket
+{
+   /* Cached buffers, oldest first. */
+   struct list_head buffers;
+   /* In pb_cache::active_buckets while there are any buffers. */
+   struct list_head link;
+
+   /* How long buffers are kept, adjusted to how the size class is used. */
+   unsigned msecs;
+   unsigned last_expired_ms;
+   unsigned hits_since_expired;
+   bool expired_recently;
+};
+
+struct pb_cache_stats
+{
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t expired; /**< Buffers that weren't reused in time */
+   uint64_t trimmed; /**< Buffers dropped to stay below the size limit */
+   uint64_t cache_size;
+   unsigned num_buffers;
+};
+
 struct pb_cache
 {
    /* The cache is divided into buckets for minimizing cache misses.
-    * The driver controls which buffer goes into which bucket.
+    * The driver controls which heap a buffer goes into, and the cache
+    * sorts it into a size class within the heap.
     */
-   struct list_head *buckets;
+   struct pb_cache_bucket *buckets;
+   struct list_head active_buckets;
+   /* All cached buffers, least recently added first. */
+   struct list_head lru;
 
    simple_mtx_t mutex;
    void *winsys;
@@ -62,6 +97,7 @@ struct pb_cache
    unsigned bypass_usage;
    float size_factor;
    unsigned offsetof_pb_cache_entry; /* offsetof(driver_bo, pb_cache_entry) */
+   struct pb_cache_stats stats;
 
    void (*destroy_buffer)(void *winsys, struct pb_buffer_lean *buf);
    bool (*can_reclaim)(void *winsys, struct pb_buffer_lean *buf);
@@ -72,6 +108,7 @@ struct pb_buffer_lean *pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size siz
                                           unsigned alignment, unsigned usage,
                                           unsigned bucket_index);
 unsigned pb_cache_release_all_buffers(struct pb_cache *mgr);
+void pb_cache_get_stats(struct pb_cache *mgr, struct pb_cache_stats *stats);
 void pb_cache_init_entry(struct pb_cache *mgr, struct pb_cache_entry *entry,
                          struct pb_buffer_lean *buf, unsigned bucket_index);
 void pb_cache_init(struct pb_cache *mgr, unsigned num_heaps,
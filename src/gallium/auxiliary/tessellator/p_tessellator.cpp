@@ -30,6 +30,7 @@
 #include "tessellator.hpp"
 
 #include <new>
+#include <string.h>
 
 namespace pipe_tessellator_wrap
 {
@@ -43,6 +44,14 @@ namespace pipe_tessellator_wrap
       alignas(32) float      domain_points_u[MAX_POINT_COUNT];
       alignas(32) float      domain_points_v[MAX_POINT_COUNT];
       uint32_t               num_domain_points;
+      uint32_t               num_indices;
+
+      /* Patches of a draw very often share the same factors, in which case
+       * the pattern of the previous patch is still valid.
+       */
+      bool                   have_last_factors;
+      float                  last_outer_tf[4];
+      float                  last_inner_tf[2];
 
    public:
       void Init(enum mesa_prim tes_prim_mode,
@@ -70,11 +79,20 @@ namespace pipe_tessellator_wrap
 
          prim_mode          = tes_prim_mode;
          num_domain_points = 0;
+         num_indices = 0;
+         have_last_factors = false;
       }
 
       void Tessellate(const struct pipe_tessellation_factors *tess_factors,
                       struct pipe_tessellator_data *tess_data)
       {
+         if (have_last_factors &&
+             !memcmp(last_outer_tf, tess_factors->outer_tf, sizeof(last_outer_tf)) &&
+             !memcmp(last_inner_tf, tess_factors->inner_tf, sizeof(last_inner_tf))) {
+            fill_data(tess_data);
+            return;
+         }
+
          switch (prim_mode)
             {
             case MESA_PRIM_QUADS:
@@ -103,6 +121,7 @@ namespace pipe_tessellator_wrap
 
             default:
                assert(0);
+               have_last_factors = false;
                return;
             }
 
@@ -113,11 +132,23 @@ namespace pipe_tessellator_wrap
             domain_points_u[i] = points[i].u;
             domain_points_v[i] = points[i].v;
          }
+         num_indices = (uint32_t)SUPER::GetIndexCount();
+
+         memcpy(last_outer_tf, tess_factors->outer_tf, sizeof(last_outer_tf));
+         memcpy(last_inner_tf, tess_factors->inner_tf, sizeof(last_inner_tf));
+         have_last_factors = true;
+
+         fill_data(tess_data);
+      }
+
+   private:
+      void fill_data(struct pipe_tessellator_data *tess_data)
+      {
          tess_data->num_domain_points = num_domain_points;
          tess_data->domain_points_u = &domain_points_u[0];
          tess_data->domain_points_v = &domain_points_v[0];
 
-         tess_data->num_indices = (uint32_t)SUPER::GetIndexCount();
+         tess_data->num_indices = num_indices;
 
          tess_data->indices = (uint32_t*)SUPER::GetIndices();
       }
@@ -31,13 +31,37 @@
   */
 
 #include "util/detect.h"
+#include "util/u_cpu_detect.h"
 #include "pipe/p_state.h"
 #include "translate.h"
 
+/**
+ * Whether translate_simd_create() may be called on this CPU.  On x86-64 it
+ * is built with AVX2 and F16C enabled.
+ */
+bool translate_simd_is_supported(void)
+{
+#if DETECT_ARCH_X86_64
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+
+   return caps->has_avx2 && caps->has_f16c;
+#elif DETECT_ARCH_AARCH64 && UTIL_ARCH_LITTLE_ENDIAN
+   return true;
+#else
+   return false;
+#endif
+}
+
 struct translate *translate_create( const struct translate_key *key )
 {
    struct translate *translate = NULL;
 
+   if (translate_simd_is_supported()) {
+      translate = translate_simd_create( key );
+      if (translate)
+         return translate;
+   }
+
 #if DETECT_ARCH_X86 || DETECT_ARCH_X86_64
    translate = translate_sse2_create( key );
    if (translate)
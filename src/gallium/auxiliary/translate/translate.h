@@ -169,6 +169,10 @@ static inline void translate_key_sanitize( struct translate_key *a )
  */
 struct translate *translate_sse2_create( const struct translate_key *key );
 
+bool translate_simd_is_supported(void);
+
+struct translate *translate_simd_create( const struct translate_key *key );
+
 struct translate *translate_generic_create( const struct translate_key *key );
 
 bool translate_generic_is_output_format_supported(enum pipe_format format);
@@ -0,0 +1,911 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Vertex fetch/emit with compiler intrinsics, for AVX2 + F16C on x86-64 and
+ * NEON on aarch64.
+ *
+ * Unlike translate_generic and translate_sse, which walk every attribute
+ * of one vertex before moving to the next, this works attribute by
+ * attribute over a block of vertices.  The format decision is made once
+ * per attribute and block, and the loop body that remains is a load, a
+ * widen/convert and a store, unrolled four vertices at a time.  Blocks are
+ * small enough that the output vertices stay in L1 between attributes.
+ *
+ * Only the common formats are handled: 8/16-bit (un)signed normalized,
+ * scaled and pure integer, 16-bit and 32-bit float, B8G8R8A8_UNORM,
+ * fetched to 32-bit float or integer outputs, plus float to R8G8B8A8 /
+ * B8G8R8A8 UNORM emit and plain copies.  translate_simd_create() returns
+ * NULL for anything else so that translate_create() falls back.
+ *
+ * The x86-64 build uses avx2_args and must only be entered after
+ * translate_simd_is_supported() said so.
+ */
+
+#include "util/detect_arch.h"
+#include "util/u_endian.h"
+#include "util/u_math.h"
+#include "util/u_memory.h"
+#include "util/format/u_format.h"
+#include "translate.h"
+
+#if (DETECT_ARCH_X86_64 || DETECT_ARCH_AARCH64) && UTIL_ARCH_LITTLE_ENDIAN
+
+#if DETECT_ARCH_X86_64
+#include <immintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+
+/* Vertices per block, see the comment at the top of the file. */
+#define SIMD_BLOCK 64
+
+enum translate_simd_fetch {
+   SIMD_FETCH_MEMCPY,
+   SIMD_FETCH_COPY,
+   SIMD_FETCH_32,
+   SIMD_FETCH_HALF,
+   SIMD_FETCH_U8,
+   SIMD_FETCH_S8,
+   SIMD_FETCH_U16,
+   SIMD_FETCH_S16,
+   SIMD_FETCH_INSTANCE_ID,
+};
+
+struct translate_simd_attrib {
+   enum translate_simd_fetch fetch;
+
+   /* Integer inputs converted to float, optionally multiplied by scale,
+    * and clamped to -1 for snorm.
+    */
+   bool to_float;
+   bool snorm;
+   float scale;
+
+   /* B8G8R8A8 input or output. */
+   bool bgra_in;
+   bool bgra_out;
+
+   /* Float result packed to four unorm8. */
+   bool emit_unorm8;
+
+   unsigned input_size;
+   unsigned output_size;
+
+   /* Or'ed into the result to supply the channels the input lacks. */
+   uint32_t fill[4];
+
+   unsigned buffer;
+   unsigned input_offset;
+   unsigned instance_divisor;
+   unsigned output_offset;
+
+   const uint8_t *input_ptr;
+   unsigned input_stride;
+   unsigned max_index;
+};
+
+struct translate_simd {
+   struct translate translate;
+
+   struct translate_simd_attrib attrib[TRANSLATE_MAX_ATTRIBS];
+   unsigned nr_attrib;
+};
+
+
+static struct translate_simd *
+translate_simd(struct translate *translate)
+{
+   return (struct translate_simd *)translate;
+}
+
+
+static ALWAYS_INLINE uint64_t
+load_lo(const uint8_t *src, unsigned size)
+{
+   uint64_t v = 0;
+   uint32_t u32;
+   uint16_t u16;
+
+   switch (size) {
+   case 1:
+      v = src[0];
+      break;
+   case 2:
+      memcpy(&u16, src, 2);
+      v = u16;
+      break;
+   case 3:
+      memcpy(&u16, src, 2);
+      v = u16 | (uint32_t)src[2] << 16;
+      break;
+   case 4:
+      memcpy(&u32, src, 4);
+      v = u32;
+      break;
+   case 6:
+      memcpy(&u32, src, 4);
+      memcpy(&u16, src + 4, 2);
+      v = u32 | (uint64_t)u16 << 32;
+      break;
+   case 8:
+      memcpy(&v, src, 8);
+      break;
+   default:
+      unreachable("unexpected attribute size");
+   }
+
+   return v;
+}
+
+static ALWAYS_INLINE void
+store_lo(uint8_t *dst, uint64_t v, unsigned size)
+{
+   uint32_t u32 = v;
+   uint16_t u16 = v;
+
+   switch (size) {
+   case 1:
+      dst[0] = v;
+      break;
+   case 2:
+      memcpy(dst, &u16, 2);
+      break;
+   case 3:
+      memcpy(dst, &u16, 2);
+      dst[2] = v >> 16;
+      break;
+   case 4:
+      memcpy(dst, &u32, 4);
+      break;
+   case 6:
+      memcpy(dst, &u32, 4);
+      u16 = v >> 32;
+      memcpy(dst + 4, &u16, 2);
+      break;
+   case 8:
+      memcpy(dst, &v, 8);
+      break;
+   default:
+      unreachable("unexpected attribute size");
+   }
+}
+
+static inline bool
+simd_size_supported(unsigned size)
+{
+   return size == 1 || size == 2 || size == 3 || size == 4 ||
+          size == 6 || size == 8 || size == 12 || size == 16;
+}
+
+/* Swaps bytes 0 and 2, which turns BGRA8 into RGBA8 and back. */
+static inline uint32_t
+bgra_swap(uint32_t v)
+{
+   return (v & 0xff00ff00) | ((v >> 16) & 0xff) | ((v & 0xff) << 16);
+}
+
+
+#if DETECT_ARCH_X86_64
+
+typedef __m128i simd_vec;
+
+static ALWAYS_INLINE simd_vec
+simd_load(const uint8_t *src, unsigned size)
+{
+   uint32_t hi;
+
+   switch (size) {
+   case 16:
+      return _mm_loadu_si128((const __m128i *)src);
+   case 12:
+      memcpy(&hi, src + 8, 4);
+      return _mm_insert_epi32(_mm_loadl_epi64((const __m128i *)src), hi, 2);
+   case 8:
+      return _mm_loadl_epi64((const __m128i *)src);
+   default:
+      return _mm_cvtsi64_si128(load_lo(src, size));
+   }
+}
+
+static ALWAYS_INLINE void
+simd_store(uint8_t *dst, simd_vec v, unsigned size)
+{
+   uint32_t hi;
+
+   switch (size) {
+   case 16:
+      _mm_storeu_si128((__m128i *)dst, v);
+      break;
+   case 12:
+      _mm_storel_epi64((__m128i *)dst, v);
+      hi = _mm_extract_epi32(v, 2);
+      memcpy(dst + 8, &hi, 4);
+      break;
+   case 8:
+      _mm_storel_epi64((__m128i *)dst, v);
+      break;
+   default:
+      store_lo(dst, _mm_cvtsi128_si64(v), size);
+      break;
+   }
+}
+
+static ALWAYS_INLINE simd_vec
+simd_from_u32(uint32_t v)
+{
+   return _mm_cvtsi32_si128(v);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_u8(simd_vec v)
+{
+   return _mm_cvtepu8_epi32(v);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_s8(simd_vec v)
+{
+   return _mm_cvtepi8_epi32(v);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_u16(simd_vec v)
+{
+   return _mm_cvtepu16_epi32(v);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_s16(simd_vec v)
+{
+   return _mm_cvtepi16_epi32(v);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_half_to_float(simd_vec v)
+{
+   return _mm_castps_si128(_mm_cvtph_ps(v));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_int_to_float(simd_vec v, float scale, bool snorm)
+{
+   __m128 f = _mm_cvtepi32_ps(v);
+
+   if (scale != 0.0f)
+      f = _mm_mul_ps(f, _mm_set1_ps(scale));
+   if (snorm)
+      f = _mm_max_ps(f, _mm_set1_ps(-1.0f));
+
+   return _mm_castps_si128(f);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_fill(simd_vec v, const uint32_t fill[4])
+{
+   return _mm_or_si128(v, _mm_loadu_si128((const __m128i *)fill));
+}
+
+/* Same as translate_sse: round to nearest and let the saturating packs do
+ * the clamping.
+ */
+static ALWAYS_INLINE uint32_t
+simd_pack_unorm8(simd_vec v)
+{
+   __m128i i = _mm_cvtps_epi32(_mm_mul_ps(_mm_castsi128_ps(v),
+                                          _mm_set1_ps(255.0f)));
+
+   i = _mm_packs_epi32(i, i);
+   i = _mm_packus_epi16(i, i);
+
+   return _mm_cvtsi128_si32(i);
+}
+
+#else /* DETECT_ARCH_AARCH64 */
+
+typedef uint32x4_t simd_vec;
+
+static ALWAYS_INLINE simd_vec
+simd_load(const uint8_t *src, unsigned size)
+{
+   uint32_t hi;
+
+   switch (size) {
+   case 16:
+      return vreinterpretq_u32_u8(vld1q_u8(src));
+   case 12:
+      memcpy(&hi, src + 8, 4);
+      return vcombine_u32(vcreate_u32(load_lo(src, 8)), vcreate_u32(hi));
+   default:
+      return vcombine_u32(vcreate_u32(load_lo(src, size)), vdup_n_u32(0));
+   }
+}
+
+static ALWAYS_INLINE void
+simd_store(uint8_t *dst, simd_vec v, unsigned size)
+{
+   uint32_t hi;
+
+   switch (size) {
+   case 16:
+      vst1q_u8(dst, vreinterpretq_u8_u32(v));
+      break;
+   case 12:
+      store_lo(dst, vgetq_lane_u64(vreinterpretq_u64_u32(v), 0), 8);
+      hi = vgetq_lane_u32(v, 2);
+      memcpy(dst + 8, &hi, 4);
+      break;
+   default:
+      store_lo(dst, vgetq_lane_u64(vreinterpretq_u64_u32(v), 0), size);
+      break;
+   }
+}
+
+static ALWAYS_INLINE simd_vec
+simd_from_u32(uint32_t v)
+{
+   return vsetq_lane_u32(v, vdupq_n_u32(0), 0);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_u8(simd_vec v)
+{
+   uint16x8_t w = vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(v)));
+
+   return vmovl_u16(vget_low_u16(w));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_s8(simd_vec v)
+{
+   int16x8_t w = vmovl_s8(vget_low_s8(vreinterpretq_s8_u32(v)));
+
+   return vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(w)));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_u16(simd_vec v)
+{
+   return vmovl_u16(vget_low_u16(vreinterpretq_u16_u32(v)));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_widen_s16(simd_vec v)
+{
+   return vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(vreinterpretq_s16_u32(v))));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_half_to_float(simd_vec v)
+{
+   return vreinterpretq_u32_f32(vcvt_f32_f16(vreinterpret_f16_u32(vget_low_u32(v))));
+}
+
+static ALWAYS_INLINE simd_vec
+simd_int_to_float(simd_vec v, float scale, bool snorm)
+{
+   float32x4_t f = vcvtq_f32_s32(vreinterpretq_s32_u32(v));
+
+   if (scale != 0.0f)
+      f = vmulq_n_f32(f, scale);
+   if (snorm)
+      f = vmaxq_f32(f, vdupq_n_f32(-1.0f));
+
+   return vreinterpretq_u32_f32(f);
+}
+
+static ALWAYS_INLINE simd_vec
+simd_fill(simd_vec v, const uint32_t fill[4])
+{
+   return vorrq_u32(v, vld1q_u32(fill));
+}
+
+static ALWAYS_INLINE uint32_t
+simd_pack_unorm8(simd_vec v)
+{
+   int32x4_t i = vcvtnq_s32_f32(vmulq_n_f32(vreinterpretq_f32_u32(v), 255.0f));
+   uint16x4_t h = vqmovun_s32(i);
+   uint8x8_t b = vqmovn_u16(vcombine_u16(h, h));
+
+   return vget_lane_u32(vreinterpret_u32_u8(b), 0);
+}
+
+#endif
+
+
+static ALWAYS_INLINE void
+simd_fetch_emit(const struct translate_simd_attrib *a,
+                enum translate_simd_fetch fetch,
+                const uint8_t *src, uint8_t *dst)
+{
+   simd_vec v;
+
+   switch (fetch) {
+   case SIMD_FETCH_MEMCPY:
+      memcpy(dst, src, a->output_size);
+      return;
+   case SIMD_FETCH_COPY:
+      simd_store(dst, simd_load(src, a->input_size), a->output_size);
+      return;
+   case SIMD_FETCH_32:
+      v = simd_load(src, a->input_size);
+      break;
+   case SIMD_FETCH_HALF:
+      v = simd_half_to_float(simd_load(src, a->input_size));
+      break;
+   case SIMD_FETCH_U8:
+      if (a->bgra_in)
+         v = simd_widen_u8(simd_from_u32(bgra_swap(load_lo(src, 4))));
+      else
+         v = simd_widen_u8(simd_load(src, a->input_size));
+      break;
+   case SIMD_FETCH_S8:
+      v = simd_widen_s8(simd_load(src, a->input_size));
+      break;
+   case SIMD_FETCH_U16:
+      v = simd_widen_u16(simd_load(src, a->input_size));
+      break;
+   case SIMD_FETCH_S16:
+      v = simd_widen_s16(simd_load(src, a->input_size));
+      break;
+   default:
+      unreachable("unexpected fetch");
+   }
+
+   if (fetch != SIMD_FETCH_32 && fetch != SIMD_FETCH_HALF && a->to_float)
+      v = simd_int_to_float(v, a->scale, a->snorm);
+
+   v = simd_fill(v, a->fill);
+
+   if (a->emit_unorm8) {
+      uint32_t packed = simd_pack_unorm8(v);
+
+      if (a->bgra_out)
+         packed = bgra_swap(packed);
+      memcpy(dst, &packed, 4);
+   } else {
+      simd_store(dst, v, a->output_size);
+   }
+}
+
+static ALWAYS_INLINE const uint8_t *
+simd_vertex_src(const struct translate_simd_attrib *a,
+                const void *elts, unsigned index_size,
+                unsigned start, unsigned i)
+{
+   unsigned index;
+
+   switch (index_size) {
+   case 4:
+      index = ((const unsigned *)elts)[i];
+      break;
+   case 2:
+      index = ((const uint16_t *)elts)[i];
+      break;
+   case 1:
+      index = ((const uint8_t *)elts)[i];
+      break;
+   default:
+      index = start + i;
+      break;
+   }
+
+   /* clamp to avoid going out of bounds */
+   if (index_size > 0)
+      index = MIN2(index, a->max_index);
+
+   return a->input_ptr + (ptrdiff_t)a->input_stride * index;
+}
+
+static ALWAYS_INLINE void
+simd_run_attrib(const struct translate_simd_attrib *a,
+                enum translate_simd_fetch fetch,
+                const void *elts, unsigned index_size,
+                unsigned start, unsigned count,
+                unsigned start_instance, unsigned instance_id,
+                uint8_t *vert, unsigned stride)
+{
+   uint8_t *dst = vert + a->output_offset;
+   unsigned i = 0;
+
+   if (fetch == SIMD_FETCH_INSTANCE_ID) {
+      uint32_t value = instance_id;
+
+      if (a->to_float) {
+         float f = (float)instance_id;
+         memcpy(&value, &f, 4);
+      }
+      for (; i < count; i++)
+         memcpy(dst + i * stride, &value, 4);
+      return;
+   }
+
+   if (a->instance_divisor) {
+      /* XXX we need to clamp the index here too, but to a
+       * per-array max value, not the draw->pt.max_index value
+       * that's being given to us via translate->set_buffer().
+       */
+      unsigned index = start_instance + instance_id / a->instance_divisor;
+      const uint8_t *src = a->input_ptr + (ptrdiff_t)a->input_stride * index;
+
+      for (; i < count; i++)
+         simd_fetch_emit(a, fetch, src, dst + i * stride);
+      return;
+   }
+
+   for (; i + 4 <= count; i += 4) {
+      const uint8_t *src0 = simd_vertex_src(a, elts, index_size, start, i + 0);
+      const uint8_t *src1 = simd_vertex_src(a, elts, index_size, start, i + 1);
+      const uint8_t *src2 = simd_vertex_src(a, elts, index_size, start, i + 2);
+      const uint8_t *src3 = simd_vertex_src(a, elts, index_size, start, i + 3);
+
+      simd_fetch_emit(a, fetch, src0, dst + (i + 0) * stride);
+      simd_fetch_emit(a, fetch, src1, dst + (i + 1) * stride);
+      simd_fetch_emit(a, fetch, src2, dst + (i + 2) * stride);
+      simd_fetch_emit(a, fetch, src3, dst + (i + 3) * stride);
+   }
+
+   for (; i < count; i++) {
+      simd_fetch_emit(a, fetch,
+                      simd_vertex_src(a, elts, index_size, start, i),
+                      dst + i * stride);
+   }
+}
+
+static ALWAYS_INLINE void
+simd_run_block(const struct translate_simd *ts,
+               const void *elts, unsigned index_size,
+               unsigned start, unsigned count,
+               unsigned start_instance, unsigned instance_id,
+               uint8_t *vert)
+{
+   const unsigned stride = ts->translate.key.output_stride;
+
+   for (unsigned attr = 0; attr < ts->nr_attrib; attr++) {
+      const struct translate_simd_attrib *a = &ts->attrib[attr];
+
+#define CASE(fetch) \
+      case fetch: \
+         simd_run_attrib(a, fetch, elts, index_size, start, count, \
+                         start_instance, instance_id, vert, stride); \
+         break;
+
+      switch (a->fetch) {
+      CASE(SIMD_FETCH_MEMCPY)
+      CASE(SIMD_FETCH_COPY)
+      CASE(SIMD_FETCH_32)
+      CASE(SIMD_FETCH_HALF)
+      CASE(SIMD_FETCH_U8)
+      CASE(SIMD_FETCH_S8)
+      CASE(SIMD_FETCH_U16)
+      CASE(SIMD_FETCH_S16)
+      CASE(SIMD_FETCH_INSTANCE_ID)
+      }
+
+#undef CASE
+   }
+}
+
+static ALWAYS_INLINE void
+simd_run(struct translate *translate,
+         const void *elts, unsigned index_size,
+         unsigned start, unsigned count,
+         unsigned start_instance, unsigned instance_id,
+         void *output_buffer)
+{
+   const struct translate_simd *ts = translate_simd(translate);
+   const unsigned stride = ts->translate.key.output_stride;
+   uint8_t *vert = output_buffer;
+
+   for (unsigned i = 0; i < count; i += SIMD_BLOCK) {
+      const unsigned n = MIN2(count - i, SIMD_BLOCK);
+      const void *block_elts = NULL;
+
+      if (index_size)
+         block_elts = (const uint8_t *)elts + i * index_size;
+
+      simd_run_block(ts, block_elts, index_size, start + i, n,
+                     start_instance, instance_id, vert + i * stride);
+   }
+}
+
+static void UTIL_CDECL
+simd_run_elts(struct translate *translate,
+              const unsigned *elts,
+              unsigned count,
+              unsigned start_instance,
+              unsigned instance_id,
+              void *output_buffer)
+{
+   simd_run(translate, elts, 4, 0, count, start_instance, instance_id,
+            output_buffer);
+}
+
+static void UTIL_CDECL
+simd_run_elts16(struct translate *translate,
+                const uint16_t *elts,
+                unsigned count,
+                unsigned start_instance,
+                unsigned instance_id,
+                void *output_buffer)
+{
+   simd_run(translate, elts, 2, 0, count, start_instance, instance_id,
+            output_buffer);
+}
+
+static void UTIL_CDECL
+simd_run_elts8(struct translate *translate,
+               const uint8_t *elts,
+               unsigned count,
+               unsigned start_instance,
+               unsigned instance_id,
+               void *output_buffer)
+{
+   simd_run(translate, elts, 1, 0, count, start_instance, instance_id,
+            output_buffer);
+}
+
+static void UTIL_CDECL
+simd_run_linear(struct translate *translate,
+                unsigned start,
+                unsigned count,
+                unsigned start_instance,
+                unsigned instance_id,
+                void *output_buffer)
+{
+   simd_run(translate, NULL, 0, start, count, start_instance, instance_id,
+            output_buffer);
+}
+
+
+static void
+simd_set_buffer(struct translate *translate,
+                unsigned buf,
+                const void *ptr,
+                unsigned stride,
+                unsigned max_index)
+{
+   struct translate_simd *ts = translate_simd(translate);
+
+   for (unsigned i = 0; i < ts->nr_attrib; i++) {
+      if (ts->attrib[i].buffer == buf) {
+         ts->attrib[i].input_ptr = ((const uint8_t *)ptr +
+                                    ts->attrib[i].input_offset);
+         ts->attrib[i].input_stride = stride;
+         ts->attrib[i].max_index = max_index;
+      }
+   }
+}
+
+
+static void
+simd_release(struct translate *translate)
+{
+   FREE(translate);
+}
+
+
+/**
+ * Whether the first nr_channels of desc are all of one type and size and
+ * appear in memory in RGBA order, with the rest of the swizzle set to the
+ * 0, 0, 0, 1 defaults.
+ */
+static bool
+is_plain_rgba(const struct util_format_description *desc)
+{
+   if (desc->layout != UTIL_FORMAT_LAYOUT_PLAIN ||
+       desc->colorspace != UTIL_FORMAT_COLORSPACE_RGB ||
+       desc->block.width != 1 || desc->block.height != 1 ||
+       desc->nr_channels == 0 || desc->nr_channels > 4)
+      return false;
+
+   for (unsigned c = 0; c < desc->nr_channels; c++) {
+      if (desc->channel[c].type != desc->channel[0].type ||
+          desc->channel[c].size != desc->channel[0].size ||
+          desc->channel[c].normalized != desc->channel[0].normalized ||
+          desc->channel[c].pure_integer != desc->channel[0].pure_integer ||
+          desc->swizzle[c] != PIPE_SWIZZLE_X + c)
+         return false;
+   }
+
+   for (unsigned c = desc->nr_channels; c < 4; c++) {
+      if (desc->swizzle[c] != (c == 3 ? PIPE_SWIZZLE_1 : PIPE_SWIZZLE_0))
+         return false;
+   }
+
+   return true;
+}
+
+static bool
+setup_fetch(struct translate_simd_attrib *a,
+            const struct util_format_description *in,
+            bool to_int)
+{
+   const struct util_format_channel_description *chan = &in->channel[0];
+
+   a->input_size = in->block.bits / 8;
+   if (!simd_size_supported(a->input_size))
+      return false;
+
+   switch (chan->type) {
+   case UTIL_FORMAT_TYPE_FLOAT:
+      if (to_int)
+         return false;
+      if (chan->size == 32)
+         a->fetch = SIMD_FETCH_32;
+      else if (chan->size == 16)
+         a->fetch = SIMD_FETCH_HALF;
+      else
+         return false;
+      return true;
+
+   case UTIL_FORMAT_TYPE_UNSIGNED:
+   case UTIL_FORMAT_TYPE_SIGNED: {
+      const bool is_signed = chan->type == UTIL_FORMAT_TYPE_SIGNED;
+
+      if (chan->pure_integer != to_int)
+         return false;
+
+      if (chan->size == 8)
+         a->fetch = is_signed ? SIMD_FETCH_S8 : SIMD_FETCH_U8;
+      else if (chan->size == 16)
+         a->fetch = is_signed ? SIMD_FETCH_S16 : SIMD_FETCH_U16;
+      else if (chan->size == 32 && chan->pure_integer)
+         a->fetch = SIMD_FETCH_32;
+      else
+         return false;
+
+      if (!to_int) {
+         a->to_float = true;
+         if (chan->normalized) {
+            a->scale = 1.0f / (float)(is_signed ? u_intN_max(chan->size) :
+                                                  u_uintN_max(chan->size));
+            a->snorm = is_signed;
+         }
+      }
+      return true;
+   }
+
+   default:
+      return false;
+   }
+}
+
+static bool
+setup_attrib(struct translate_simd_attrib *a,
+             const struct translate_element *element)
+{
+   const struct util_format_description *in =
+      util_format_description(element->input_format);
+   const struct util_format_description *out =
+      util_format_description(element->output_format);
+
+   if (element->type == TRANSLATE_ELEMENT_INSTANCE_ID) {
+      a->fetch = SIMD_FETCH_INSTANCE_ID;
+      switch (element->output_format) {
+      case PIPE_FORMAT_R32_USCALED:
+      case PIPE_FORMAT_R32_SSCALED:
+         return true;
+      case PIPE_FORMAT_R32_FLOAT:
+         a->to_float = true;
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   if (!in || !out)
+      return false;
+
+   if (element->input_format == element->output_format) {
+      if (in->block.width != 1 || in->block.height != 1 ||
+          (in->block.bits & 7))
+         return false;
+
+      a->input_size = a->output_size = in->block.bits / 8;
+      a->fetch = simd_size_supported(a->input_size) ? SIMD_FETCH_COPY :
+                                                       SIMD_FETCH_MEMCPY;
+      return true;
+   }
+
+   /* draw's EMIT_4UB and EMIT_4UB_BGRA */
+   if (element->output_format == PIPE_FORMAT_R8G8B8A8_UNORM ||
+       element->output_format == PIPE_FORMAT_B8G8R8A8_UNORM) {
+      if (!is_plain_rgba(in) ||
+          in->channel[0].type != UTIL_FORMAT_TYPE_FLOAT ||
+          in->channel[0].size != 32 ||
+          !setup_fetch(a, in, false))
+         return false;
+
+      a->emit_unorm8 = true;
+      a->bgra_out = element->output_format == PIPE_FORMAT_B8G8R8A8_UNORM;
+      a->output_size = 4;
+   } else {
+      if (!is_plain_rgba(out) || out->channel[0].size != 32)
+         return false;
+
+      const bool to_int = out->channel[0].pure_integer;
+      if (out->channel[0].type == UTIL_FORMAT_TYPE_FLOAT) {
+         if (to_int)
+            return false;
+      } else if (!to_int) {
+         return false;
+      }
+
+      if (element->input_format == PIPE_FORMAT_B8G8R8A8_UNORM) {
+         a->fetch = SIMD_FETCH_U8;
+         a->input_size = 4;
+         a->bgra_in = true;
+         a->to_float = true;
+         a->scale = 1.0f / 255.0f;
+      } else if (!is_plain_rgba(in) || !setup_fetch(a, in, to_int)) {
+         return false;
+      }
+
+      /* The generic path requires the signs to match for integers. */
+      if (to_int && in->channel[0].type != out->channel[0].type)
+         return false;
+
+      a->output_size = out->block.bits / 8;
+   }
+
+   const unsigned nr_in = element->input_format == PIPE_FORMAT_B8G8R8A8_UNORM ?
+                          4 : in->nr_channels;
+   const uint32_t one = a->to_float || a->fetch == SIMD_FETCH_HALF ||
+                        (a->fetch == SIMD_FETCH_32 &&
+                         in->channel[0].type == UTIL_FORMAT_TYPE_FLOAT) ?
+                        fui(1.0f) : 1;
+   if (nr_in < 4)
+      a->fill[3] = one;
+
+   return true;
+}
+
+struct translate *
+translate_simd_create(const struct translate_key *key)
+{
+   struct translate_simd *ts = CALLOC_STRUCT(translate_simd);
+
+   if (!ts)
+      return NULL;
+
+   assert(key->nr_elements <= TRANSLATE_MAX_ATTRIBS);
+
+   ts->translate.key = *key;
+   ts->translate.release = simd_release;
+   ts->translate.set_buffer = simd_set_buffer;
+   ts->translate.run_elts = simd_run_elts;
+   ts->translate.run_elts16 = simd_run_elts16;
+   ts->translate.run_elts8 = simd_run_elts8;
+   ts->translate.run = simd_run_linear;
+
+   for (unsigned i = 0; i < key->nr_elements; i++) {
+      struct translate_simd_attrib *a = &ts->attrib[i];
+
+      if (!setup_attrib(a, &key->element[i])) {
+         FREE(ts);
+         return NULL;
+      }
+
+      a->buffer = key->element[i].input_buffer;
+      a->input_offset = key->element[i].input_offset;
+      a->instance_divisor = key->element[i].instance_divisor;
+      a->output_offset = key->element[i].output_offset;
+   }
+
+   ts->nr_attrib = key->nr_elements;
+
+   return &ts->translate;
+}
+
+#else
+
+struct translate *
+translate_simd_create(const struct translate_key *key)
+{
+   return NULL;
+}
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/u_cpu_section.h"
+
+bool util_cpu_sections_enabled;
+uint64_t util_cpu_section_time_ns[UTIL_CPU_SECTION_COUNT];
+
+/**
+ * Start accounting. There is no way back, sections that are in flight when
+ * a HUD goes away would otherwise be lost or counted twice.
+ */
+void
+util_cpu_sections_enable(void)
+{
+   p_atomic_set(&util_cpu_sections_enabled, true);
+}
+
+const char *
+util_cpu_section_name(enum util_cpu_section section)
+{
+   static const char *names[] = {
+      [UTIL_CPU_SECTION_TC_BATCH] = "tc-batch",
+      [UTIL_CPU_SECTION_TC_SYNC] = "tc-sync",
+      [UTIL_CPU_SECTION_STATE_UPDATE] = "state-update",
+      [UTIL_CPU_SECTION_SHADER_VARIANT] = "shader-variant",
+      [UTIL_CPU_SECTION_MAP_STALL] = "map-stall",
+   };
+   static_assert(ARRAY_SIZE(names) == UTIL_CPU_SECTION_COUNT,
+                 "missing section name");
+
+   return names[section];
+}
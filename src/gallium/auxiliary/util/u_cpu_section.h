@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Cheap wall-clock accounting of where the driver spends CPU time, for the
+ * "cpu-time-*" HUD graphs.
+ *
+ * Hot paths bracket their work with util_cpu_section_begin/end. This costs
+ * one predictable branch while no HUD graph wants the numbers, and two clock
+ * reads and an atomic add otherwise. Times are accumulated over all
+ * contexts and threads of the process. Sections may nest, e.g. state-update
+ * includes shader-variant with llvmpipe.
+ */
+
+#ifndef U_CPU_SECTION_H
+#define U_CPU_SECTION_H
+
+#include "util/os_time.h"
+#include "util/u_atomic.h"
+#include "util/macros.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum util_cpu_section {
+   /* threaded_context executing batches in the driver thread. */
+   UTIL_CPU_SECTION_TC_BATCH,
+   /* The application thread waiting for the driver thread. */
+   UTIL_CPU_SECTION_TC_SYNC,
+   /* Validating state before draws and dispatches. */
+   UTIL_CPU_SECTION_STATE_UPDATE,
+   /* Looking up and compiling shader variants. */
+   UTIL_CPU_SECTION_SHADER_VARIANT,
+   /* Waiting for the GPU or rasterizer when mapping resources. */
+   UTIL_CPU_SECTION_MAP_STALL,
+   UTIL_CPU_SECTION_COUNT,
+};
+
+extern bool util_cpu_sections_enabled;
+extern uint64_t util_cpu_section_time_ns[UTIL_CPU_SECTION_COUNT];
+
+static inline int64_t
+util_cpu_section_begin(void)
+{
+   return unlikely(p_atomic_read_relaxed(&util_cpu_sections_enabled)) ?
+          os_time_get_nano() : 0;
+}
+
+static inline void
+util_cpu_section_end(enum util_cpu_section section, int64_t begin)
+{
+   if (unlikely(begin))
+      p_atomic_add(&util_cpu_section_time_ns[section], os_time_get_nano() - begin);
+}
+
+void
+util_cpu_sections_enable(void);
+
+const char *
+util_cpu_section_name(enum util_cpu_section section);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "u_inlines.h"
 #include "util/u_memory.h"
+#include "indices/u_indices_simd.h"
 #include "u_prim_restart.h"
 #include "u_prim.h"
 
@@ -64,29 +65,14 @@ util_translate_prim_restart_data(unsigned index_size,
                                  unsigned count, unsigned restart_index)
 {
    if (index_size == 1) {
-      uint8_t *src = (uint8_t *) src_map;
-      uint16_t *dst = (uint16_t *) dst_map;
-      unsigned i;
-      for (i = 0; i < count; i++) {
-         dst[i] = (src[i] == restart_index) ? 0xffff : src[i];
-      }
+      u_index_replace_restart_8_to_16(src_map, dst_map, count, restart_index);
    }
    else if (index_size == 2) {
-      uint16_t *src = (uint16_t *) src_map;
-      uint16_t *dst = (uint16_t *) dst_map;
-      unsigned i;
-      for (i = 0; i < count; i++) {
-         dst[i] = (src[i] == restart_index) ? 0xffff : src[i];
-      }
+      u_index_replace_restart_16(src_map, dst_map, count, restart_index);
    }
    else {
-      uint32_t *src = (uint32_t *) src_map;
-      uint32_t *dst = (uint32_t *) dst_map;
-      unsigned i;
       assert(index_size == 4);
-      for (i = 0; i < count; i++) {
-         dst[i] = (src[i] == restart_index) ? 0xffffffff : src[i];
-      }
+      u_index_replace_restart_32(src_map, dst_map, count, restart_index);
    }
 }
 
@@ -152,47 +138,36 @@ util_prim_restart_convert_to_direct(const void *index_map,
                                     unsigned *total_index_count)
 {
    struct range_info ranges = { .min_index = UINT32_MAX, 0 };
-   unsigned i, start, count;
+   unsigned start, end;
    ranges.min_index = UINT32_MAX;
 
    assert(info->index_size);
    assert(info->primitive_restart);
 
-#define SCAN_INDEXES(TYPE) \
-   for (i = 0; i <= draw->count; i++) { \
-      if (i == draw->count || \
-          ((const TYPE *) index_map)[i] == info->restart_index) { \
-         /* cut / restart */ \
-         if (count > 0) { \
-            if (!add_range(info->mode, &ranges, draw->start + start, count, draw->index_bias)) { \
-               return NULL; \
-            } \
-         } \
-         start = i + 1; \
-         count = 0; \
-      } \
-      else { \
-         count++; \
-      } \
-   }
-
-   start = 0;
-   count = 0;
    switch (info->index_size) {
    case 1:
-      SCAN_INDEXES(uint8_t);
-      break;
    case 2:
-      SCAN_INDEXES(uint16_t);
-      break;
    case 4:
-      SCAN_INDEXES(uint32_t);
       break;
    default:
       assert(!"Bad index size");
       return NULL;
    }
 
+   /* Jump from one restart index to the next rather than testing each
+    * index, restarts are usually rare.
+    */
+   for (start = 0; start <= draw->count; start = end + 1) {
+      end = u_index_find_restart(index_map, info->index_size, start,
+                                 draw->count, info->restart_index);
+      if (end > start) {
+         if (!add_range(info->mode, &ranges, draw->start + start,
+                        end - start, draw->index_bias)) {
+            return NULL;
+         }
+      }
+   }
+
    *num_draws = ranges.count;
    *min_index = ranges.min_index;
    *max_index = ranges.max_index;
@@ -26,6 +26,7 @@
 
 #include "util/u_threaded_context.h"
 #include "util/u_cpu_detect.h"
+#include "util/u_cpu_section.h"
 #include "util/format/u_format.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
@@ -655,7 +656,10 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
 
    /* Only wait for queued calls... */
    if (!util_queue_fence_is_signalled(&last->fence)) {
+      int64_t section_begin = util_cpu_section_begin();
+
       util_queue_fence_wait(&last->fence);
+      util_cpu_section_end(UTIL_CPU_SECTION_TC_SYNC, section_begin);
       synced = true;
    }
 
@@ -1298,8 +1302,42 @@ tc_render_condition(struct pipe_context *_pipe,
       return pipe->create_##name##_state(pipe, state); \
    }
 
-#define TC_CSO_BIND(name, ...) TC_FUNC1(bind_##name##_state, , void *, , , ##__VA_ARGS__)
-#define TC_CSO_DELETE(name) TC_FUNC1(delete_##name##_state, , void *, , )
+/* Never a valid CSO, so the next bind after it is always queued. */
+#define TC_UNKNOWN_CSO ((void *)(uintptr_t)1)
+
+#define TC_CSO_BIND(name, ...) \
+   struct tc_call_bind_##name##_state { \
+      struct tc_call_base base; \
+      void *state; \
+   }; \
+   \
+   static uint16_t ALWAYS_INLINE \
+   tc_call_bind_##name##_state(struct pipe_context *pipe, void *call) \
+   { \
+      pipe->bind_##name##_state(pipe, to_call(call, tc_call_bind_##name##_state)->state); \
+      return call_size(tc_call_bind_##name##_state); \
+   } \
+   \
+   static void \
+   tc_bind_##name##_state(struct pipe_context *_pipe, void *param) \
+   { \
+      struct threaded_context *tc = threaded_context(_pipe); \
+      if (tc->options.skip_redundant_binds && tc->bound_cso.name == param) { \
+         p_atomic_inc(&tc->num_redundant_binds); \
+      } else { \
+         struct tc_call_bind_##name##_state *p = \
+            tc_add_call(tc, TC_CALL_bind_##name##_state, tc_call_bind_##name##_state); \
+         p->state = param; \
+         tc->bound_cso.name = param; \
+      } \
+      __VA_ARGS__; \
+   }
+
+/* A new CSO can be created at the address of a deleted one. */
+#define TC_CSO_DELETE(name) TC_FUNC1(delete_##name##_state, , void *, , , \
+   if (tc->bound_cso.name == param) \
+      tc->bound_cso.name = TC_UNKNOWN_CSO; \
+)
 
 #define TC_CSO(name, sname, ...) \
    TC_CSO_CREATE(name, sname) \
@@ -1348,7 +1386,7 @@ TC_CSO_SHADER_TRACK(gs)
 TC_CSO_SHADER_TRACK(tcs)
 TC_CSO_SHADER_TRACK(tes)
 TC_CSO_CREATE(sampler, sampler)
-TC_CSO_DELETE(sampler)
+TC_FUNC1(delete_sampler_state, , void *, , )
 TC_CSO_BIND(vertex_elements)
 TC_CSO_DELETE(vertex_elements)
 
@@ -2151,6 +2189,9 @@ tc_add_set_vertex_elements_and_buffers_call(struct pipe_context *_pipe,
     */
    tc->num_vertex_buffers = count;
 
+   /* The caller binds the vertex elements without telling us which. */
+   tc->bound_cso.vertex_elements = TC_UNKNOWN_CSO;
+
    struct tc_vertex_elements_and_buffers *p =
       tc_add_slot_based_call(tc, TC_CALL_set_vertex_elements_and_buffers,
                              tc_vertex_elements_and_buffers, count);
@@ -3837,6 +3878,20 @@ tc_call_draw_multi(struct pipe_context *pipe, void *call)
 #define DRAW_INFO_SIZE_WITHOUT_INDEXBUF_AND_MIN_MAX_INDEX \
    offsetof(struct pipe_draw_info, index)
 
+/* Count the draws tc_call_draw_single() will merge for the HUD.  prev is
+ * the call in front of p if it was the last one of the same batch.
+ */
+static void
+tc_count_merged_draw(struct threaded_context *tc, struct tc_call_base *prev,
+                     unsigned batch, struct tc_draw_single *p)
+{
+   if (prev && prev->call_id == TC_CALL_draw_single && batch == tc->next &&
+       is_next_call_a_mergeable_draw((struct tc_draw_single *)prev, p))
+      p_atomic_inc(&tc->num_merged_draws);
+
+   tc_mark_call_mergeable(tc, &p->base);
+}
+
 /* Single draw with drawid_offset == 0. */
 static void
 tc_draw_single(struct pipe_context *_pipe, const struct pipe_draw_info *info,
@@ -3846,6 +3901,8 @@ tc_draw_single(struct pipe_context *_pipe, const struct pipe_draw_info *info,
                unsigned num_draws)
 {
    struct threaded_context *tc = threaded_context(_pipe);
+   struct tc_call_base *prev = tc_get_last_mergeable_call(tc);
+   unsigned batch = tc->next;
    struct tc_draw_single *p =
       tc_add_call(tc, TC_CALL_draw_single, tc_draw_single);
 
@@ -3862,6 +3919,7 @@ tc_draw_single(struct pipe_context *_pipe, const struct pipe_draw_info *info,
    p->info.max_index = draws[0].count;
    p->index_bias = draws[0].index_bias;
    simplify_draw_info(&p->info);
+   tc_count_merged_draw(tc, prev, batch, p);
 }
 
 /* Single draw with drawid_offset > 0. */
@@ -3921,6 +3979,8 @@ tc_draw_user_indices_single(struct pipe_context *_pipe,
    if (unlikely(!buffer))
       return;
 
+   struct tc_call_base *prev = tc_get_last_mergeable_call(tc);
+   unsigned batch = tc->next;
    struct tc_draw_single *p =
       tc_add_call(tc, TC_CALL_draw_single, tc_draw_single);
    memcpy(&p->info, info, DRAW_INFO_SIZE_WITHOUT_INDEXBUF_AND_MIN_MAX_INDEX);
@@ -3930,6 +3990,7 @@ tc_draw_user_indices_single(struct pipe_context *_pipe,
    p->info.max_index = draws[0].count;
    p->index_bias = draws[0].index_bias;
    simplify_draw_info(&p->info);
+   tc_count_merged_draw(tc, prev, batch, p);
 }
 
 /* Single draw with user indices and drawid_offset > 0. */
@@ -5147,6 +5208,7 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
 {
    struct tc_batch *batch = job;
    struct pipe_context *pipe = batch->tc->pipe;
+   int64_t section_begin = util_cpu_section_begin();
 
    tc_batch_check(batch);
    tc_set_driver_thread(batch->tc);
@@ -5202,6 +5264,8 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
 #if !defined(NDEBUG)
    batch->closed = false;
 #endif
+
+   util_cpu_section_end(UTIL_CPU_SECTION_TC_BATCH, section_begin);
 }
 
 /********************************************************************
@@ -5305,6 +5369,20 @@ threaded_context_create(struct pipe_context *pipe,
       tc->options = *options;
    }
 
+   if (debug_get_bool_option("GALLIUM_THREAD_SKIP_REDUNDANT_BINDS", false))
+      tc->options.skip_redundant_binds = true;
+
+   tc->bound_cso.blend = TC_UNKNOWN_CSO;
+   tc->bound_cso.rasterizer = TC_UNKNOWN_CSO;
+   tc->bound_cso.depth_stencil_alpha = TC_UNKNOWN_CSO;
+   tc->bound_cso.compute = TC_UNKNOWN_CSO;
+   tc->bound_cso.fs = TC_UNKNOWN_CSO;
+   tc->bound_cso.vs = TC_UNKNOWN_CSO;
+   tc->bound_cso.gs = TC_UNKNOWN_CSO;
+   tc->bound_cso.tcs = TC_UNKNOWN_CSO;
+   tc->bound_cso.tes = TC_UNKNOWN_CSO;
+   tc->bound_cso.vertex_elements = TC_UNKNOWN_CSO;
+
    pipe = trace_context_create_threaded(pipe->screen, pipe, &replace_buffer, &tc->options);
 
    /* The driver context isn't wrapped, so set its "priv" to NULL. */
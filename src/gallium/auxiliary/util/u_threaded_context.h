@@ -561,6 +561,16 @@ struct threaded_context_options {
     */
    void (*dsa_parse)(void *state, struct tc_renderpass_info *info);
    void (*fs_parse)(void *state, struct tc_renderpass_info *info);
+
+   /**
+    * If true, binding the CSO that is already bound is dropped in the
+    * frontend thread instead of being queued, so that the driver thread can
+    * merge the draws around it into one multi draw.  Drivers must then not
+    * leave CSOs of their own bound behind the back of the context, e.g.
+    * after internal blits.  GALLIUM_THREAD_SKIP_REDUNDANT_BINDS=true forces
+    * this on.
+    */
+   bool skip_redundant_binds;
 };
 
 struct tc_vertex_buffers {
@@ -584,6 +594,10 @@ struct threaded_context {
    unsigned num_offloaded_slots;
    unsigned num_direct_slots;
    unsigned num_syncs;
+   /* Single draws that will be merged with the previous draw. */
+   unsigned num_merged_draws;
+   /* CSO binds dropped by threaded_context_options::skip_redundant_binds. */
+   unsigned num_redundant_binds;
 
    bool use_forced_staging_uploads;
    bool add_all_gfx_bindings_to_buffer_list;
@@ -617,6 +631,22 @@ struct threaded_context {
    bool seen_tcs;
    bool seen_tes;
    bool seen_gs;
+
+   /* The CSOs last bound through the context, or TC_UNKNOWN_CSO, for
+    * threaded_context_options::skip_redundant_binds.
+    */
+   struct {
+      void *blend;
+      void *rasterizer;
+      void *depth_stencil_alpha;
+      void *compute;
+      void *fs;
+      void *vs;
+      void *gs;
+      void *tcs;
+      void *tes;
+      void *vertex_elements;
+   } bound_cso;
    /* whether the current renderpass has seen a set_framebuffer_state call */
    bool seen_fb_state;
    /* whether a renderpass is currently active */
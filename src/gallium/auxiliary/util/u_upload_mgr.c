@@ -32,12 +32,25 @@
 #include "pipe/p_defines.h"
 #include "util/u_inlines.h"
 #include "pipe/p_context.h"
+#include "pipe/p_screen.h"
 #include "util/u_memory.h"
 #include "util/u_math.h"
 
 #include "u_upload_mgr.h"
 
 
+/* How many full buffers a ring mode uploader keeps around for reuse. */
+#define U_UPLOAD_RING_SIZE 8
+
+struct u_upload_retired {
+   struct pipe_resource *buffer;
+   struct pipe_transfer *transfer;
+   uint8_t *map;
+   int private_refcount;
+   struct pipe_fence_handle *fence;
+   bool fenced; /* Whether a flush has been fenced since it was retired. */
+};
+
 struct u_upload_mgr {
    struct pipe_context *pipe;
 
@@ -55,6 +68,13 @@ struct u_upload_mgr {
    unsigned offset; /* Aligned offset to the upload buffer, pointing
                      * at the first unused byte. */
    int buffer_private_refcount;
+
+   /* Ring mode, see u_upload_enable_ring. Full buffers are kept mapped,
+    * oldest first, until they are idle and can be reused.
+    */
+   bool ring;
+   unsigned num_retired;
+   struct u_upload_retired retired[U_UPLOAD_RING_SIZE];
 };
 
 
@@ -112,9 +132,36 @@ u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload)
    return result;
 }
 
+static void
+u_upload_release_retired(struct u_upload_mgr *upload,
+                         struct u_upload_retired *retired)
+{
+   struct pipe_screen *screen = upload->pipe->screen;
+
+   if (retired->transfer)
+      pipe_buffer_unmap(upload->pipe, retired->transfer);
+   if (retired->private_refcount) {
+      p_atomic_add(&retired->buffer->reference.count,
+                   -retired->private_refcount);
+   }
+   pipe_resource_reference(&retired->buffer, NULL);
+   screen->fence_reference(screen, &retired->fence, NULL);
+   memset(retired, 0, sizeof(*retired));
+}
+
+static void
+u_upload_release_all_retired(struct u_upload_mgr *upload)
+{
+   for (unsigned i = 0; i < upload->num_retired; i++)
+      u_upload_release_retired(upload, &upload->retired[i]);
+   upload->num_retired = 0;
+}
+
 void
 u_upload_disable_persistent(struct u_upload_mgr *upload)
 {
+   u_upload_release_all_retired(upload);
+   upload->ring = false;
    upload->map_persistent = false;
    upload->map_flags &= ~(PIPE_MAP_COHERENT | PIPE_MAP_PERSISTENT);
    upload->map_flags |= PIPE_MAP_FLUSH_EXPLICIT;
@@ -165,9 +212,117 @@ u_upload_release_buffer(struct u_upload_mgr *upload)
 }
 
 
+bool
+u_upload_enable_ring(struct u_upload_mgr *upload)
+{
+   /* Buffers stay mapped while the GPU reads them. */
+   if (!upload->map_persistent)
+      return false;
+
+   upload->ring = true;
+   return true;
+}
+
+
+void
+u_upload_fence(struct u_upload_mgr *upload, struct pipe_fence_handle *fence)
+{
+   struct pipe_screen *screen = upload->pipe->screen;
+
+   /* Only buffers retired since the previous flush need the new fence. */
+   for (int i = upload->num_retired - 1;
+        i >= 0 && !upload->retired[i].fenced; i--) {
+      screen->fence_reference(screen, &upload->retired[i].fence, fence);
+      upload->retired[i].fenced = true;
+   }
+}
+
+
+/* Move the full upload buffer to the list of retired buffers. */
+static void
+u_upload_retire_buffer(struct u_upload_mgr *upload)
+{
+   if (upload->num_retired == U_UPLOAD_RING_SIZE) {
+      /* The oldest buffer hasn't become idle in time, let it go. */
+      u_upload_release_retired(upload, &upload->retired[0]);
+      memmove(&upload->retired[0], &upload->retired[1],
+              (U_UPLOAD_RING_SIZE - 1) * sizeof(upload->retired[0]));
+      upload->num_retired--;
+   }
+
+   upload->retired[upload->num_retired++] = (struct u_upload_retired) {
+      .buffer = upload->buffer,
+      .transfer = upload->transfer,
+      .map = upload->map,
+      .private_refcount = upload->buffer_private_refcount,
+   };
+
+   upload->buffer = NULL;
+   upload->transfer = NULL;
+   upload->map = NULL;
+   upload->buffer_private_refcount = 0;
+   upload->buffer_size = 0;
+}
+
+
+/* Make the oldest idle retired buffer of at least min_size bytes the upload
+ * buffer again. Return its size or 0 if there is none.
+ */
+static unsigned
+u_upload_reuse_buffer(struct u_upload_mgr *upload, unsigned min_size)
+{
+   struct pipe_screen *screen = upload->pipe->screen;
+
+   for (unsigned i = 0; i < upload->num_retired; i++) {
+      struct u_upload_retired *retired = &upload->retired[i];
+      struct pipe_resource *buffer = retired->buffer;
+
+      /* Fences signal in order, so newer buffers aren't idle either. */
+      if (!retired->fenced ||
+          (retired->fence &&
+           !screen->fence_finish(screen, NULL, retired->fence, 0)))
+         break;
+
+      /* Suballocations that are still bound somewhere keep a reference,
+       * the buffer can only be overwritten once all of them are gone.
+       */
+      if (buffer->width0 < min_size ||
+          p_atomic_read(&buffer->reference.count) !=
+          1 + retired->private_refcount)
+         continue;
+
+      upload->buffer = buffer;
+      upload->transfer = retired->transfer;
+      upload->map = retired->map;
+      upload->buffer_private_refcount = retired->private_refcount;
+      upload->buffer_size = buffer->width0;
+      upload->offset = 0;
+      screen->fence_reference(screen, &retired->fence, NULL);
+
+      memmove(&upload->retired[i], &upload->retired[i + 1],
+              (upload->num_retired - i - 1) * sizeof(upload->retired[0]));
+      upload->num_retired--;
+
+      /* Top up the private references for another round of
+       * suballocations, see u_upload_alloc_buffer.
+       */
+      int needed = 1 + (upload->buffer_size - min_size);
+      if (upload->buffer_private_refcount < needed) {
+         p_atomic_add(&buffer->reference.count,
+                      needed - upload->buffer_private_refcount);
+         upload->buffer_private_refcount = needed;
+      }
+      return upload->buffer_size;
+   }
+
+   return 0;
+}
+
+
 void
 u_upload_destroy(struct u_upload_mgr *upload)
 {
+   u_upload_release_all_retired(upload);
    u_upload_release_buffer(upload);
    FREE(upload);
 }
@@ -180,9 +335,19 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    struct pipe_resource buffer;
    unsigned size;
 
-   /* Release the old buffer, if present:
-    */
-   u_upload_release_buffer(upload);
+   if (upload->ring) {
+      /* Keep the old buffer for later and try to recycle an idle one. */
+      if (upload->buffer)
+         u_upload_retire_buffer(upload);
+
+      size = u_upload_reuse_buffer(upload, min_size);
+      if (size)
+         return size;
+   } else {
+      /* Release the old buffer, if present:
+       */
+      u_upload_release_buffer(upload);
+   }
 
    /* Allocate a new one:
     */
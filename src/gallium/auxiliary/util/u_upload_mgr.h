@@ -36,6 +36,7 @@
 #include "pipe/p_defines.h"
 
 struct pipe_context;
+struct pipe_fence_handle;
 struct pipe_resource;
 
 #ifdef __cplusplus
@@ -73,6 +74,27 @@ u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload);
 void
 u_upload_disable_persistent(struct u_upload_mgr *upload);
 
+/**
+ * Switch the uploader to ring mode, which only works with persistent
+ * mappings and returns false without them.
+ *
+ * Full upload buffers stay mapped and are reused once the GPU is done with
+ * them and nothing references them anymore, instead of being released and
+ * reallocated. That means no allocations at steady state, but the driver
+ * has to call u_upload_fence after every flush.
+ */
+bool
+u_upload_enable_ring(struct u_upload_mgr *upload);
+
+/**
+ * Tell a ring mode uploader about a flush.
+ *
+ * \param fence  Fence of the flush, or NULL if all work submitted so far
+ *               has already completed.
+ */
+void
+u_upload_fence(struct u_upload_mgr *upload, struct pipe_fence_handle *fence);
+
 /**
  * Destroy the upload manager.
  */
@@ -28,6 +28,7 @@
 
 #include "pipe/p_video_codec.h"
 #include "util/u_memory.h"
+#include "util/u_queue.h"
 #include "util/vl_vlc.h"
 
 #include "vl_mpeg12_bitstream.h"
@@ -799,6 +800,62 @@ entry:
       vl_vlc_eatbits(&bs->vlc, 1);
 }
 
+#define BLOCKS_PER_MB (64 * 6)
+
+struct vl_mpg12_slice
+{
+   struct util_queue_fence fence;
+
+   /* Private copy of the bitstream state, starting at the slice. */
+   struct vl_mpg12_bs bs;
+   struct vl_vlc start;
+   struct pipe_video_buffer *target;
+   bool failed;
+
+   struct pipe_mpeg12_macroblock *mbs;
+   short *blocks;
+   unsigned num_mbs, max_mbs;
+};
+
+static void
+emit_macroblock(struct vl_mpg12_bs *bs, struct pipe_video_buffer *target,
+                const struct pipe_mpeg12_macroblock *mb)
+{
+   struct vl_mpg12_slice *slice = bs->slice;
+
+   if (!slice) {
+      bs->decoder->decode_macroblock(bs->decoder, target, &bs->desc->base, &mb->base, 1);
+      return;
+   }
+
+   if (slice->num_mbs == slice->max_mbs) {
+      unsigned max_mbs = MAX2(slice->max_mbs * 2, 128);
+      struct pipe_mpeg12_macroblock *mbs =
+         REALLOC(slice->mbs, slice->max_mbs * sizeof(*mbs), max_mbs * sizeof(*mbs));
+      if (mbs)
+         slice->mbs = mbs;
+
+      short *blocks =
+         REALLOC(slice->blocks, slice->max_mbs * BLOCKS_PER_MB * sizeof(short),
+                 max_mbs * BLOCKS_PER_MB * sizeof(short));
+      if (blocks)
+         slice->blocks = blocks;
+
+      if (!mbs || !blocks) {
+         slice->failed = true;
+         return;
+      }
+      slice->max_mbs = max_mbs;
+   }
+
+   /* The block pointers are set up once the slice is complete. */
+   slice->mbs[slice->num_mbs] = *mb;
+   if (mb->macroblock_type & (PIPE_MPEG12_MB_TYPE_INTRA | PIPE_MPEG12_MB_TYPE_PATTERN))
+      memcpy(slice->blocks + slice->num_mbs * BLOCKS_PER_MB, mb->blocks,
+             BLOCKS_PER_MB * sizeof(short));
+   slice->num_mbs++;
+}
+
 static inline void
 decode_slice(struct vl_mpg12_bs *bs, struct pipe_video_buffer *target)
 {
@@ -846,7 +903,7 @@ decode_slice(struct vl_mpg12_bs *bs, struct pipe_video_buffer *target)
          if (!inc)
             return;
          mb.num_skipped_macroblocks = inc - 1;
-         bs->decoder->decode_macroblock(bs->decoder, target, &bs->desc->base, &mb.base, 1);
+         emit_macroblock(bs, target, &mb);
       }
       mb.x = x += inc;
       if (bs->decoder->profile == PIPE_VIDEO_PROFILE_MPEG1) {
@@ -956,7 +1013,101 @@ decode_slice(struct vl_mpg12_bs *bs, struct pipe_video_buffer *target)
    } while (vl_vlc_bits_left(&bs->vlc) && vl_vlc_peekbits(&bs->vlc, 23));
 
    mb.num_skipped_macroblocks = 0;
-   bs->decoder->decode_macroblock(bs->decoder, target, &bs->desc->base, &mb.base, 1);
+   emit_macroblock(bs, target, &mb);
+}
+
+static void
+decode_slice_job(void *job, void *gdata, int thread_index)
+{
+   struct vl_mpg12_slice *slice = job;
+
+   decode_slice(&slice->bs, slice->target);
+}
+
+static void
+submit_slice(struct vl_mpg12_bs *bs, struct vl_mpg12_slice *slice)
+{
+   if (slice->failed) {
+      /* Out of memory, decode it once more straight into the decoder. */
+      slice->bs.vlc = slice->start;
+      slice->bs.slice = NULL;
+      decode_slice(&slice->bs, slice->target);
+      return;
+   }
+
+   if (!slice->num_mbs)
+      return;
+
+   for (unsigned i = 0; i < slice->num_mbs; ++i)
+      slice->mbs[i].blocks = slice->blocks + i * BLOCKS_PER_MB;
+
+   bs->decoder->decode_macroblock(bs->decoder, slice->target, &bs->desc->base,
+                                  &slice->mbs[0].base, slice->num_mbs);
+}
+
+static void
+decode_slices_parallel(struct vl_mpg12_bs *bs, struct pipe_video_buffer *target)
+{
+   unsigned num_slices = 0;
+
+   /* Slices can be decoded independently, so only find their start codes
+    * here. Slice data can't contain a start code prefix.
+    */
+   while (vl_vlc_search_byte(&bs->vlc, ~0, 0x00) && vl_vlc_bits_left(&bs->vlc) > 32) {
+      uint32_t code = vl_vlc_peekbits(&bs->vlc, 32);
+
+      if (code >= 0x101 && code <= 0x1AF) {
+         vl_vlc_eatbits(&bs->vlc, 24);
+
+         if (num_slices == bs->max_slices) {
+            unsigned max_slices = MAX2(bs->max_slices * 2, 16);
+            struct vl_mpg12_slice *slices =
+               REALLOC(bs->slices, bs->max_slices * sizeof(*slices),
+                       max_slices * sizeof(*slices));
+            if (!slices)
+               break;
+
+            memset(slices + bs->max_slices, 0,
+                   (max_slices - bs->max_slices) * sizeof(*slices));
+            for (unsigned i = bs->max_slices; i < max_slices; ++i)
+               util_queue_fence_init(&slices[i].fence);
+
+            bs->slices = slices;
+            bs->max_slices = max_slices;
+         }
+
+         struct vl_mpg12_slice *slice = &bs->slices[num_slices++];
+         slice->bs = *bs;
+         slice->bs.queue = NULL;
+         slice->start = bs->vlc;
+         slice->target = target;
+         slice->failed = false;
+         slice->num_mbs = 0;
+      }
+
+      vl_vlc_eatbits(&bs->vlc, 8);
+      vl_vlc_fillbits(&bs->vlc);
+   }
+
+   for (unsigned i = 0; i < num_slices; ++i)
+      bs->slices[i].bs.slice = &bs->slices[i];
+
+   /* This thread takes care of the first slice itself. */
+   for (unsigned i = 1; i < num_slices; ++i) {
+      util_queue_add_job(bs->queue, &bs->slices[i], &bs->slices[i].fence,
+                         decode_slice_job, NULL, 0);
+   }
+
+   for (unsigned i = 0; i < num_slices; ++i) {
+      struct vl_mpg12_slice *slice = &bs->slices[i];
+
+      if (i == 0)
+         decode_slice(&slice->bs, target);
+      else
+         util_queue_fence_wait(&slice->fence);
+
+      submit_slice(bs, slice);
+   }
 }
 
 void
@@ -976,6 +1127,27 @@ vl_mpg12_bs_init(struct vl_mpg12_bs *bs, struct pipe_video_codec *decoder)
    }
 }
 
+void
+vl_mpg12_bs_set_queue(struct vl_mpg12_bs *bs, struct util_queue *queue)
+{
+   assert(bs);
+
+   bs->queue = queue;
+}
+
+void
+vl_mpg12_bs_cleanup(struct vl_mpg12_bs *bs)
+{
+   for (unsigned i = 0; i < bs->max_slices; ++i) {
+      util_queue_fence_destroy(&bs->slices[i].fence);
+      FREE(bs->slices[i].mbs);
+      FREE(bs->slices[i].blocks);
+   }
+   FREE(bs->slices);
+   bs->slices = NULL;
+   bs->max_slices = 0;
+}
+
 void
 vl_mpg12_bs_decode(struct vl_mpg12_bs *bs,
                    struct pipe_video_buffer *target,
@@ -990,6 +1162,12 @@ vl_mpg12_bs_decode(struct vl_mpg12_bs *bs,
    bs->intra_dct_tbl = picture->intra_vlc_format ? tbl_B15 : tbl_B14_AC;
 
    vl_vlc_init(&bs->vlc, num_buffers, buffers, sizes);
+
+   if (bs->queue) {
+      decode_slices_parallel(bs, target);
+      return;
+   }
+
    while (vl_vlc_search_byte(&bs->vlc, ~0, 0x00) && vl_vlc_bits_left(&bs->vlc) > 32) {
       uint32_t code = vl_vlc_peekbits(&bs->vlc, 32);
 
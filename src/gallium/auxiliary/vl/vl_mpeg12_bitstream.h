@@ -31,6 +31,9 @@
 #include "vl_defines.h"
 #include "util/vl_vlc.h"
 
+struct util_queue;
+struct vl_mpg12_slice;
+
 struct vl_mpg12_bs
 {
    struct pipe_video_codec *decoder;
@@ -40,11 +43,29 @@ struct vl_mpg12_bs
 
    struct vl_vlc vlc;
    short pred_dc[3];
+
+   /* Slice this decodes into instead of calling decode_macroblock. */
+   struct vl_mpg12_slice *slice;
+
+   /* Slices of the current picture if decoding them in parallel. */
+   struct util_queue *queue;
+   struct vl_mpg12_slice *slices;
+   unsigned max_slices;
 };
 
 void
 vl_mpg12_bs_init(struct vl_mpg12_bs *bs, struct pipe_video_codec *decoder);
 
+/**
+ * Decode the slices of each picture in parallel on the threads of queue
+ * and hand the macroblocks to the decoder in bitstream order.
+ */
+void
+vl_mpg12_bs_set_queue(struct vl_mpg12_bs *bs, struct util_queue *queue);
+
+void
+vl_mpg12_bs_cleanup(struct vl_mpg12_bs *bs);
+
 void
 vl_mpg12_bs_decode(struct vl_mpg12_bs *bs,
                    struct pipe_video_buffer *target,
@@ -28,7 +28,9 @@
 #include <math.h>
 #include <assert.h>
 
+#include "util/u_cpu_detect.h"
 #include "util/u_memory.h"
+#include "util/u_queue.h"
 #include "util/u_sampler.h"
 #include "util/u_surface.h"
 #include "util/u_video.h"
@@ -472,6 +474,7 @@ vl_mpeg12_destroy_buffer(struct vl_mpeg12_buffer *buf)
    cleanup_idct_buffer(buf);
    cleanup_mc_buffer(buf);
    vl_vb_cleanup(&buf->vertex_stream);
+   vl_mpg12_bs_cleanup(&buf->bs);
 
    FREE(buf);
 }
@@ -520,6 +523,9 @@ vl_mpeg12_destroy(struct pipe_video_codec *decoder)
       if (dec->dec_buffers[i])
          vl_mpeg12_destroy_buffer(dec->dec_buffers[i]);
 
+   if (dec->has_slice_queue)
+      util_queue_destroy(&dec->slice_queue);
+
    dec->context->destroy(dec->context);
 
    FREE(dec);
@@ -560,8 +566,11 @@ vl_mpeg12_get_decode_buffer(struct vl_mpeg12_decoder *dec, struct pipe_video_buf
    if (!init_zscan_buffer(dec, buffer))
       goto error_zscan;
 
-   if (dec->base.entrypoint == PIPE_VIDEO_ENTRYPOINT_BITSTREAM)
+   if (dec->base.entrypoint == PIPE_VIDEO_ENTRYPOINT_BITSTREAM) {
       vl_mpg12_bs_init(&buffer->bs, &dec->base);
+      if (dec->has_slice_queue)
+         vl_mpg12_bs_set_queue(&buffer->bs, &dec->slice_queue);
+   }
 
    if (dec->base.expect_chunked_decode)
       priv->buffer = buffer;
@@ -1208,6 +1217,17 @@ vl_create_mpeg12_decoder(struct pipe_context *context,
 
    list_inithead(&dec->buffer_privates);
 
+   /* The CPU side VLC decoding is the expensive part of the bitstream
+    * entrypoint, spread the slices of a picture over a few threads.
+    */
+   if (templat->entrypoint == PIPE_VIDEO_ENTRYPOINT_BITSTREAM) {
+      unsigned num_threads = MIN2(util_get_cpu_caps()->nr_cpus, 8);
+
+      if (num_threads > 1)
+         dec->has_slice_queue = util_queue_init(&dec->slice_queue, "vlmpeg12",
+                                                64, num_threads - 1, 0, NULL);
+   }
+
    return &dec->base;
 
 error_pipe_state:
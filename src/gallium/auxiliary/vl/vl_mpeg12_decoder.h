@@ -31,6 +31,7 @@
 #include "pipe/p_video_codec.h"
 
 #include "util/list.h"
+#include "util/u_queue.h"
 
 #include "vl_mpeg12_bitstream.h"
 #include "vl_zscan.h"
@@ -81,6 +82,10 @@ struct vl_mpeg12_decoder
    struct vl_mpeg12_buffer *dec_buffers[4];
 
    struct list_head buffer_privates;
+
+   /* Worker threads for slice decoding of the bitstream entrypoint. */
+   struct util_queue slice_queue;
+   bool has_slice_queue;
 };
 
 struct vl_mpeg12_buffer
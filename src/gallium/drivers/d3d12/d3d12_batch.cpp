@@ -60,6 +60,7 @@ d3d12_init_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
                                         _mesa_key_pointer_equal);
 
    util_dynarray_init(&batch->local_bos, NULL);
+   util_dynarray_init(&batch->prefetch_bos, NULL);
 
    batch->surfaces = _mesa_set_create(NULL, _mesa_hash_pointer,
                                       _mesa_key_pointer_equal);
@@ -181,6 +182,7 @@ d3d12_reset_batch(struct d3d12_context *ctx, struct d3d12_batch *batch, uint64_t
       delete_bo(*bo);
    }
    util_dynarray_clear(&batch->local_bos);
+   util_dynarray_clear(&batch->prefetch_bos);
 
 #ifdef HAVE_GALLIUM_D3D12_GRAPHICS
    if (d3d12_screen(ctx->base.screen)->max_feature_level >= D3D_FEATURE_LEVEL_11_0) {
@@ -226,6 +228,7 @@ d3d12_destroy_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
    _mesa_set_destroy(batch->surfaces, NULL);
    _mesa_set_destroy(batch->objects, NULL);
    util_dynarray_fini(&batch->local_bos);
+   util_dynarray_fini(&batch->prefetch_bos);
 }
 
 void
@@ -277,6 +280,13 @@ d3d12_start_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
    batch->submit_id = ++ctx->submit_id;
 }
 
+/* A batch is recorded into a single command list on the context thread.
+ * Descriptor heap offsets, the per-context resource state tracking and the
+ * state fixup list built here at submission all assume the recording order
+ * is the submission order, so blits and compute transforms can't be recorded
+ * into other lists on worker threads without giving each list its own state
+ * tracking and descriptor ranges.
+ */
 void
 d3d12_end_batch(struct d3d12_context *ctx, struct d3d12_batch *batch)
 {
@@ -349,6 +359,29 @@ d3d12_batch_get_reference(struct d3d12_batch *batch,
    }
 }
 
+/* Evicted resources picked up by a batch are made resident in groups of
+ * this size while it is still being recorded.
+ */
+static constexpr unsigned residency_prefetch_size = 32;
+
+static void
+d3d12_batch_prefetch_residency(struct d3d12_batch *batch,
+                               struct d3d12_bo *bo)
+{
+#ifndef _GAMING_XBOX
+   uint64_t offset;
+   struct d3d12_bo *base_bo = d3d12_bo_get_base(bo, &offset);
+
+   /* Unlocked peek, d3d12_process_batch_residency has the final say */
+   if (base_bo->residency_status != d3d12_evicted)
+      return;
+
+   util_dynarray_append(&batch->prefetch_bos, d3d12_bo*, base_bo);
+   if (util_dynarray_num_elements(&batch->prefetch_bos, d3d12_bo*) >= residency_prefetch_size)
+      d3d12_prefetch_batch_residency(base_bo->screen, batch);
+#endif
+}
+
 inline uint8_t*
 d3d12_batch_acquire_reference(struct d3d12_batch *batch,
                           struct d3d12_bo *bo)
@@ -359,6 +392,7 @@ d3d12_batch_acquire_reference(struct d3d12_batch *batch,
          util_dynarray_append(&batch->local_bos, d3d12_bo*, bo);
          bo->local_reference_mask[batch->ctx_id] |= (1 << batch->ctx_index);
          bo->local_reference_state[batch->ctx_id][batch->ctx_index] = batch_bo_reference_none;
+         d3d12_batch_prefetch_residency(batch, bo);
       }
       return &bo->local_reference_state[batch->ctx_id][batch->ctx_index];
    }
@@ -367,6 +401,7 @@ d3d12_batch_acquire_reference(struct d3d12_batch *batch,
       if (entry == NULL) {
          d3d12_bo_reference(bo);
          entry = _mesa_hash_table_insert(batch->bos, bo, NULL);
+         d3d12_batch_prefetch_residency(batch, bo);
       }
 
       return (uint8_t*)&entry->data;
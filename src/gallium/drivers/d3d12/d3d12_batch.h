@@ -47,6 +47,8 @@ struct d3d12_batch {
 
    struct hash_table *bos;
    struct util_dynarray local_bos;
+   /* evicted base bos referenced since the last prefetch */
+   struct util_dynarray prefetch_bos;
    struct hash_table *sampler_tables;
    struct set *sampler_views;
    struct set *surfaces;
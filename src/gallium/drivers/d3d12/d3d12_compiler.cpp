@@ -33,11 +33,14 @@
 #include "pipe/p_state.h"
 
 #include "nir.h"
+#include "nir_serialize.h"
 #include "nir/nir_draw_helpers.h"
 #include "nir/tgsi_to_nir.h"
 #include "compiler/nir/nir_builder.h"
 
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
+#include "util/mesa-sha1.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
 #include "util/u_simple_shaders.h"
@@ -82,6 +85,44 @@ can_remove_dead_sampler(nir_variable *var, void *data)
    return glsl_type_is_sampler(base_type) && !glsl_type_is_bare_sampler(base_type);
 }
 
+/* The key covers the NIR as it is handed to nir_to_dxil, which is where
+ * everything the variant key lowers has already been applied.
+ */
+static void
+compute_dxil_cache_key(struct d3d12_context *ctx, nir_shader *nir,
+                       const struct nir_to_dxil_options *opts, cache_key key)
+{
+   struct d3d12_screen *screen = d3d12_screen(ctx->base.screen);
+   struct blob blob;
+   blob_init(&blob);
+   nir_serialize(&blob, nir, true);
+
+   struct mesa_sha1 sha1_ctx;
+   unsigned char sha1[20];
+   _mesa_sha1_init(&sha1_ctx);
+   _mesa_sha1_update(&sha1_ctx, blob.data, blob.size);
+   blob_finish(&blob);
+
+   uint32_t packed[] = {
+      opts->interpolate_at_vertex, opts->lower_int16,
+      opts->disable_math_refactoring, opts->last_ubo_is_not_arrayed,
+      opts->provoking_vertex, opts->num_kernel_globals,
+      opts->input_clip_size, opts->environment,
+      opts->shader_model_max, opts->validator_version_max,
+   };
+   _mesa_sha1_update(&sha1_ctx, packed, sizeof(packed));
+
+   /* The validator signs the blobs it accepts */
+   bool validated = false;
+#ifdef _WIN32
+   validated = ctx->dxil_validator && !(d3d12_debug & D3D12_DEBUG_EXPERIMENTAL);
+#endif
+   _mesa_sha1_update(&sha1_ctx, &validated, sizeof(validated));
+
+   _mesa_sha1_final(&sha1_ctx, sha1);
+   disk_cache_compute_key(screen->disk_cache, sha1, sizeof(sha1), key);
+}
+
 static struct d3d12_shader *
 compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
             struct d3d12_shader_key *key, struct nir_shader *nir)
@@ -145,8 +186,20 @@ compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
    opts.validator_version_max = dxil_get_validator_version(ctx->dxil_validator);
 #endif
 
+   /* nir_to_dxil still lowers the shader further, but nothing the driver
+    * reads back from shader->nir depends on that, so a cache hit can keep
+    * the NIR as it is.
+    */
+   cache_key dxil_key;
+   void *cached = NULL;
+   size_t cached_size = 0;
+   if (screen->disk_cache) {
+      compute_dxil_cache_key(ctx, nir, &opts, dxil_key);
+      cached = disk_cache_get(screen->disk_cache, dxil_key, &cached_size);
+   }
+
    struct blob tmp;
-   if (!nir_to_dxil(nir, &opts, NULL, &tmp)) {
+   if (!cached && !nir_to_dxil(nir, &opts, NULL, &tmp)) {
       debug_printf("D3D12: nir_to_dxil failed\n");
       return NULL;
    }
@@ -181,7 +234,7 @@ compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
    }
 
 #ifdef _WIN32
-   if (ctx->dxil_validator) {
+   if (ctx->dxil_validator && !cached) {
       if (!(d3d12_debug & D3D12_DEBUG_EXPERIMENTAL)) {
          char *err;
          if (!dxil_validate_module(ctx->dxil_validator, tmp.data,
@@ -208,7 +261,15 @@ compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
    }
 #endif
 
-   blob_finish_get_buffer(&tmp, &shader->bytecode, &shader->bytecode_length);
+   if (cached) {
+      shader->bytecode = cached;
+      shader->bytecode_length = cached_size;
+   } else {
+      blob_finish_get_buffer(&tmp, &shader->bytecode, &shader->bytecode_length);
+      if (screen->disk_cache)
+         disk_cache_put(screen->disk_cache, dxil_key, shader->bytecode,
+                        shader->bytecode_length, NULL);
+   }
 
    if (d3d12_debug & D3D12_DEBUG_DXIL) {
       char buf[256];
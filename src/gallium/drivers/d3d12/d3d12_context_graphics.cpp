@@ -1043,8 +1043,13 @@ static void
 d3d12_destroy_sampler_view(struct pipe_context *pctx,
                            struct pipe_sampler_view *pview)
 {
+   struct d3d12_screen *screen = d3d12_screen(pctx->screen);
    struct d3d12_sampler_view *view = d3d12_sampler_view(pview);
+
+   /* the handle belongs to the screen's pool, other contexts may be using it */
+   mtx_lock(&screen->descriptor_pool_mutex);
    d3d12_descriptor_handle_free(&view->handle);
+   mtx_unlock(&screen->descriptor_pool_mutex);
    pipe_resource_reference(&view->base.texture, NULL);
    FREE(view);
 }
@@ -40,6 +40,7 @@ extern "C" {
 #define D3D12_DEBUG_GPU_VALIDATOR (1 << 7)
 #define D3D12_DEBUG_SINGLETON     (1 << 8)
 #define D3D12_DEBUG_PIX           (1 << 9)
+#define D3D12_DEBUG_RESIDENCY     (1 << 10)
 
 extern uint32_t d3d12_debug;
 
@@ -39,6 +39,8 @@ struct d3d12_descriptor_pool {
    D3D12_DESCRIPTOR_HEAP_TYPE type;
    uint32_t num_descriptors;
    list_head heaps;
+   /* heap the last handle came from, tried first to avoid walking the list */
+   struct d3d12_descriptor_heap *current;
 };
 
 struct d3d12_descriptor_heap {
@@ -175,11 +177,43 @@ d3d12_descriptor_heap_append_handles(struct d3d12_descriptor_heap *heap,
                                      unsigned num_handles)
 {
    D3D12_CPU_DESCRIPTOR_HANDLE dst;
+   D3D12_CPU_DESCRIPTOR_HANDLE src_starts[64];
+   UINT src_sizes[64];
+   unsigned num_ranges = 0;
+
+   if (!num_handles)
+      return;
 
    assert(heap->next + (num_handles * heap->desc_size) <= heap->size);
    dst.ptr = heap->cpu_base + heap->next;
-   heap->dev->CopyDescriptors(1, &dst, &num_handles,
-                              num_handles, handles, NULL,
+
+   /* Views allocated one after another sit next to each other in the offline
+    * heaps, so merge those into ranges to keep the copy cheap.
+    */
+   for (unsigned i = 0; i < num_handles; i++) {
+      if (num_ranges &&
+          handles[i].ptr == src_starts[num_ranges - 1].ptr + src_sizes[num_ranges - 1] * heap->desc_size) {
+         src_sizes[num_ranges - 1]++;
+         continue;
+      }
+
+      if (num_ranges == ARRAY_SIZE(src_starts)) {
+         UINT num_copied = i;
+         heap->dev->CopyDescriptors(1, &dst, &num_copied, num_ranges, src_starts, src_sizes,
+                                    heap->desc.Type);
+         handles += num_copied;
+         num_handles -= num_copied;
+         heap->next += num_copied * heap->desc_size;
+         dst.ptr = heap->cpu_base + heap->next;
+         num_ranges = 0;
+         i = 0;
+      }
+
+      src_starts[num_ranges] = handles[i];
+      src_sizes[num_ranges++] = 1;
+   }
+
+   heap->dev->CopyDescriptors(1, &dst, &num_handles, num_ranges, src_starts, src_sizes,
                               heap->desc.Type);
    heap->next += num_handles * heap->desc_size;
 }
@@ -224,10 +258,14 @@ d3d12_descriptor_pool_alloc_handle(struct d3d12_descriptor_pool *pool,
 {
    struct d3d12_descriptor_heap *valid_heap = NULL;
 
-   list_for_each_entry(struct d3d12_descriptor_heap, heap, &pool->heaps, link) {
-      if (d3d12_descriptor_heap_can_allocate(heap)) {
-         valid_heap = heap;
-         break;
+   if (pool->current && d3d12_descriptor_heap_can_allocate(pool->current)) {
+      valid_heap = pool->current;
+   } else {
+      list_for_each_entry(struct d3d12_descriptor_heap, heap, &pool->heaps, link) {
+         if (d3d12_descriptor_heap_can_allocate(heap)) {
+            valid_heap = heap;
+            break;
+         }
       }
    }
 
@@ -236,8 +274,11 @@ d3d12_descriptor_pool_alloc_handle(struct d3d12_descriptor_pool *pool,
                                              pool->type,
                                              D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
                                              pool->num_descriptors);
+      if (!valid_heap)
+         return 0;
       list_addtail(&valid_heap->link, &pool->heaps);
    }
 
+   pool->current = valid_heap;
    return d3d12_descriptor_heap_alloc_handle(valid_heap, handle);
 }
@@ -37,7 +37,9 @@
 #include <directx/d3dx12_pipeline_state_stream.h>
 #endif
 
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
+#include "util/mesa-sha1.h"
 #include "util/set.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
@@ -265,6 +267,116 @@ copy_input_attribs(const D3D12_INPUT_ELEMENT_DESC *ves_elements, D3D12_INPUT_ELE
    }
 }
 
+static ID3D12PipelineState *
+create_pso(struct d3d12_screen *screen, CD3DX12_PIPELINE_STATE_STREAM3 &pso_desc)
+{
+   ID3D12PipelineState *ret;
+
+   if (screen->opts14.IndependentFrontAndBackStencilRefMaskSupported) {
+      D3D12_PIPELINE_STATE_STREAM_DESC pso_stream_desc{
+          sizeof(pso_desc),
+          &pso_desc
+      };
+
+      if (FAILED(screen->dev->CreatePipelineState(&pso_stream_desc,
+                                                  IID_PPV_ARGS(&ret))))
+         return NULL;
+   } 
+   else {
+      D3D12_GRAPHICS_PIPELINE_STATE_DESC v0desc = pso_desc.GraphicsDescV0();
+      if (FAILED(screen->dev->CreateGraphicsPipelineState(&v0desc,
+                                                       IID_PPV_ARGS(&ret))))
+         return NULL;
+   }
+
+   return ret;
+}
+
+static void
+sha1_update_bytecode(struct mesa_sha1 *ctx, const D3D12_SHADER_BYTECODE &bytecode)
+{
+   _mesa_sha1_update(ctx, &bytecode.BytecodeLength, sizeof(bytecode.BytecodeLength));
+   _mesa_sha1_update(ctx, bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+static void
+sha1_update_string(struct mesa_sha1 *ctx, const char *str)
+{
+   _mesa_sha1_update(ctx, str, strlen(str) + 1);
+}
+
+/* The PSO cache key has to be stable across processes, so unlike the
+ * d3d12_gfx_pipeline_state key it hashes what the CSO pointers point to.
+ * The root signature is implied by the shaders.
+ */
+static void
+compute_gfx_pso_cache_key(struct d3d12_screen *screen,
+                          const struct d3d12_gfx_pipeline_state *state,
+                          const CD3DX12_PIPELINE_STATE_STREAM3 &pso_desc,
+                          cache_key key)
+{
+   struct mesa_sha1 ctx;
+   uint8_t sha1[SHA1_DIGEST_LENGTH];
+
+   _mesa_sha1_init(&ctx);
+
+   sha1_update_bytecode(&ctx, pso_desc.VS);
+   sha1_update_bytecode(&ctx, pso_desc.HS);
+   sha1_update_bytecode(&ctx, pso_desc.DS);
+   sha1_update_bytecode(&ctx, pso_desc.GS);
+   sha1_update_bytecode(&ctx, pso_desc.PS);
+
+   const D3D12_STREAM_OUTPUT_DESC &so = pso_desc.StreamOutput;
+   for (unsigned i = 0; i < so.NumEntries; i++) {
+      const D3D12_SO_DECLARATION_ENTRY &entry = so.pSODeclaration[i];
+      if (entry.SemanticName)
+         sha1_update_string(&ctx, entry.SemanticName);
+      uint32_t packed[] = { entry.Stream, entry.SemanticIndex, entry.StartComponent,
+                            entry.ComponentCount, entry.OutputSlot };
+      _mesa_sha1_update(&ctx, packed, sizeof(packed));
+   }
+   _mesa_sha1_update(&ctx, so.pBufferStrides, so.NumStrides * sizeof(*so.pBufferStrides));
+   _mesa_sha1_update(&ctx, &so.RasterizedStream, sizeof(so.RasterizedStream));
+
+   const D3D12_INPUT_LAYOUT_DESC &input_layout = pso_desc.InputLayout;
+   for (unsigned i = 0; i < input_layout.NumElements; i++) {
+      const D3D12_INPUT_ELEMENT_DESC &elem = input_layout.pInputElementDescs[i];
+      sha1_update_string(&ctx, elem.SemanticName);
+      _mesa_sha1_update(&ctx, &elem.SemanticIndex, sizeof(elem) - offsetof(D3D12_INPUT_ELEMENT_DESC, SemanticIndex));
+   }
+
+   /* The CSOs are zero-allocated, so unlike the copies in the stream their
+    * padding is deterministic.  The rasterizer desc has none.
+    */
+   _mesa_sha1_update(&ctx, &state->blend->desc, sizeof(state->blend->desc));
+   _mesa_sha1_update(&ctx, &state->zsa->desc, sizeof(state->zsa->desc));
+   const D3D12_RASTERIZER_DESC &rast = pso_desc.RasterizerState;
+   _mesa_sha1_update(&ctx, &rast, sizeof(rast));
+
+   const D3D12_RT_FORMAT_ARRAY &rtvs = pso_desc.RTVFormats;
+   _mesa_sha1_update(&ctx, &rtvs.NumRenderTargets, sizeof(rtvs.NumRenderTargets));
+   _mesa_sha1_update(&ctx, rtvs.RTFormats, rtvs.NumRenderTargets * sizeof(rtvs.RTFormats[0]));
+
+   const DXGI_SAMPLE_DESC &samples = pso_desc.SampleDesc;
+   const UINT sample_mask = pso_desc.SampleMask;
+   const D3D12_INDEX_BUFFER_STRIP_CUT_VALUE strip_cut = pso_desc.IBStripCutValue;
+   const D3D12_PRIMITIVE_TOPOLOGY_TYPE topology = pso_desc.PrimitiveTopologyType;
+   const DXGI_FORMAT dsv_format = pso_desc.DSVFormat;
+   _mesa_sha1_update(&ctx, &samples, sizeof(samples));
+   _mesa_sha1_update(&ctx, &sample_mask, sizeof(sample_mask));
+   _mesa_sha1_update(&ctx, &strip_cut, sizeof(strip_cut));
+   _mesa_sha1_update(&ctx, &topology, sizeof(topology));
+   _mesa_sha1_update(&ctx, &dsv_format, sizeof(dsv_format));
+   _mesa_sha1_update(&ctx, &state->has_float_rtv, sizeof(state->has_float_rtv));
+
+   /* the V0 description drops state the stream keeps */
+   bool stream = screen->opts14.IndependentFrontAndBackStencilRefMaskSupported;
+   _mesa_sha1_update(&ctx, &stream, sizeof(stream));
+
+   _mesa_sha1_final(&ctx, sha1);
+   disk_cache_compute_key(screen->disk_cache, sha1, sizeof(sha1), key);
+}
+
 static ID3D12PipelineState *
 create_gfx_pipeline_state(struct d3d12_context *ctx)
 {
@@ -386,26 +498,39 @@ create_gfx_pipeline_state(struct d3d12_context *ctx)
 
    pso_desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-   ID3D12PipelineState *ret;
+   cache_key key;
+   size_t blob_size = 0;
+   void *blob = NULL;
+   if (screen->disk_cache) {
+      compute_gfx_pso_cache_key(screen, state, pso_desc, key);
+      blob = disk_cache_get(screen->disk_cache, key, &blob_size);
+   }
 
-   if (screen->opts14.IndependentFrontAndBackStencilRefMaskSupported) {
-      D3D12_PIPELINE_STATE_STREAM_DESC pso_stream_desc{
-          sizeof(pso_desc),
-          &pso_desc
-      };
+   ID3D12PipelineState *ret = NULL;
+   if (blob) {
+      cached_pso.pCachedBlob = blob;
+      cached_pso.CachedBlobSizeInBytes = blob_size;
+      ret = create_pso(screen, pso_desc);
+      free(blob);
+      cached_pso.pCachedBlob = NULL;
+      cached_pso.CachedBlobSizeInBytes = 0;
+   }
 
-      if (FAILED(screen->dev->CreatePipelineState(&pso_stream_desc,
-                                                  IID_PPV_ARGS(&ret)))) {
+   /* The blob is rejected if the driver changed or it doesn't match the
+    * description, in which case it is replaced below.
+    */
+   if (!ret) {
+      ret = create_pso(screen, pso_desc);
+      if (!ret) {
          debug_printf("D3D12: CreateGraphicsPipelineState failed!\n");
          return NULL;
       }
-   } 
-   else {
-      D3D12_GRAPHICS_PIPELINE_STATE_DESC v0desc = pso_desc.GraphicsDescV0();
-      if (FAILED(screen->dev->CreateGraphicsPipelineState(&v0desc,
-                                                       IID_PPV_ARGS(&ret)))) {
-         debug_printf("D3D12: CreateGraphicsPipelineState failed!\n");
-         return NULL;
+
+      ID3DBlob *cached;
+      if (screen->disk_cache && SUCCEEDED(ret->GetCachedBlob(&cached))) {
+         disk_cache_put(screen->disk_cache, key, cached->GetBufferPointer(),
+                        cached->GetBufferSize(), NULL);
+         cached->Release();
       }
    }
 
@@ -23,6 +23,7 @@
 
 #include "d3d12_batch.h"
 #include "d3d12_bufmgr.h"
+#include "d3d12_debug.h"
 #include "d3d12_residency.h"
 #include "d3d12_resource.h"
 #include "d3d12_screen.h"
@@ -33,6 +34,12 @@
 
 static constexpr unsigned residency_batch_size = 128;
 
+/* Keep this much of the budget free by evicting idle allocations ahead of
+ * time, so that making a batch's resources resident rarely has to wait for
+ * the GPU to release older ones.
+ */
+static constexpr double residency_budget_headroom = 0.05;
+
 static void
 log_eviction_info(struct d3d12_screen *screen, struct d3d12_bo *bo)
 {
@@ -40,6 +47,48 @@ log_eviction_info(struct d3d12_screen *screen, struct d3d12_bo *bo)
    screen->num_evictions++;
 }
 
+static void
+log_make_resident_info(struct d3d12_screen *screen, struct d3d12_bo *bo)
+{
+   screen->total_bytes_made_resident += bo->estimated_size;
+   screen->num_made_resident++;
+}
+
+/* Evict least recently used allocations the GPU is done with until usage
+ * is below the target, without waiting on anything.
+ */
+static void
+evict_idle_to_budget(struct d3d12_screen *screen, uint64_t completed_fence, uint64_t current_usage, uint64_t target_budget)
+{
+   ID3D12Pageable *to_evict[residency_batch_size];
+   unsigned num_pending_evictions = 0;
+
+   list_for_each_entry_safe(struct d3d12_bo, bo, &screen->residency_list, residency_list_entry) {
+      /* This residency list should all be base bos, not suballocated ones */
+      assert(bo->res);
+
+      if (bo->last_used_fence > completed_fence || current_usage < target_budget)
+         break;
+
+      assert(bo->residency_status == d3d12_resident);
+
+      to_evict[num_pending_evictions++] = bo->res;
+      log_eviction_info(screen, bo);
+      bo->residency_status = d3d12_evicted;
+      list_del(&bo->residency_list_entry);
+
+      current_usage -= MIN2(current_usage, bo->estimated_size);
+
+      if (num_pending_evictions == residency_batch_size) {
+         screen->dev->Evict(num_pending_evictions, to_evict);
+         num_pending_evictions = 0;
+      }
+   }
+
+   if (num_pending_evictions)
+      screen->dev->Evict(num_pending_evictions, to_evict);
+}
+
 static void
 evict_aged_allocations(struct d3d12_screen *screen, uint64_t completed_fence, int64_t time, int64_t grace_period)
 {
@@ -76,6 +125,8 @@ evict_aged_allocations(struct d3d12_screen *screen, uint64_t completed_fence, in
 static void
 evict_to_fence_or_budget(struct d3d12_screen *screen, uint64_t target_fence, uint64_t current_usage, uint64_t target_budget)
 {
+   if (screen->fence->GetCompletedValue() < target_fence)
+      screen->num_residency_stalls++;
    screen->fence->SetEventOnCompletion(target_fence, nullptr);
 
    ID3D12Pageable *to_evict[residency_batch_size];
@@ -148,6 +199,7 @@ gather_base_bos(struct d3d12_screen *screen, set *base_bo_set, struct d3d12_bo *
 
       base_bo->residency_status = d3d12_resident;
       size_to_make_resident += base_bo->estimated_size;
+      log_make_resident_info(screen, base_bo);
       list_addtail(&base_bo->residency_list_entry, &screen->residency_list);
    } else if (base_bo->last_used_fence != pending_fence_value &&
                base_bo->residency_status == d3d12_resident) {
@@ -160,6 +212,26 @@ gather_base_bos(struct d3d12_screen *screen, set *base_bo_set, struct d3d12_bo *
    base_bo->last_used_timestamp = current_time;
 }
 
+static void
+wait_for_residency(struct d3d12_screen *screen)
+{
+   /* The GPU needs to wait for everything made resident so far, including
+    * prefetches of this or other contexts that happened before submission.
+    */
+   if (screen->residency_fence_waited != screen->residency_fence_value) {
+      screen->cmdqueue->Wait(screen->residency_fence, screen->residency_fence_value);
+      screen->residency_fence_waited = screen->residency_fence_value;
+   }
+
+   if (d3d12_debug & D3D12_DEBUG_RESIDENCY) {
+      debug_printf("D3D12: residency: %u made resident (%" PRIu64 " KB, %u prefetched), "
+                   "%u evicted (%" PRIu64 " KB), %u stalls\n",
+                   screen->num_made_resident, screen->total_bytes_made_resident / 1024,
+                   screen->num_prefetched, screen->num_evictions,
+                   screen->total_bytes_evicted / 1024, screen->num_residency_stalls);
+   }
+}
+
 void
 d3d12_process_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *batch)
 {
@@ -183,14 +255,20 @@ d3d12_process_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *b
    /* Now that bos referenced by this batch are moved to the end of the LRU, trim it */
    evict_aged_allocations(screen, completed_fence_value, current_time, grace_period);
 
+   /* And make room for this batch out of what's idle, while that's free */
+   uint64_t headroom_budget = (uint64_t)(mem_info.budget * (1.0 - residency_budget_headroom));
+   if (mem_info.usage + size_to_make_resident > headroom_budget) {
+      screen->get_memory_info(screen, &mem_info);
+      evict_idle_to_budget(screen, completed_fence_value, mem_info.usage + size_to_make_resident, headroom_budget);
+   }
+
    /* If there's nothing needing to be made newly resident, we're done once we've trimmed */
    if (base_bo_set->entries == 0) {
       _mesa_set_destroy(base_bo_set, nullptr);
+      wait_for_residency(screen);
       return;
    }
 
-   uint64_t residency_fence_value_snapshot = screen->residency_fence_value;
-
    struct set_entry *entry = _mesa_set_next_entry(base_bo_set, nullptr);
    uint64_t batch_memory_size = 0;
    unsigned batch_count = 0;
@@ -253,9 +331,66 @@ d3d12_process_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *b
    }
    _mesa_set_destroy(base_bo_set, nullptr);
 
-   /* The GPU needs to wait for these resources to be made resident */
-   if (residency_fence_value_snapshot != screen->residency_fence_value)
-      screen->cmdqueue->Wait(screen->residency_fence, screen->residency_fence_value);
+   wait_for_residency(screen);
+}
+
+/* Start paging in the evicted resources the batch has picked up so far,
+ * instead of waiting for them all when it's submitted.  This only uses
+ * free budget, anything else is left to d3d12_process_batch_residency.
+ */
+void
+d3d12_prefetch_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *batch)
+{
+   d3d12_memory_info mem_info;
+   struct d3d12_bo *bos[residency_batch_size];
+   ID3D12Pageable *to_make_resident[residency_batch_size];
+   unsigned count = 0;
+
+   mtx_lock(&screen->submit_mutex);
+
+   screen->get_memory_info(screen, &mem_info);
+   uint64_t headroom_budget = (uint64_t)(mem_info.budget * (1.0 - residency_budget_headroom));
+   uint64_t usage = mem_info.usage;
+
+   util_dynarray_foreach(&batch->prefetch_bos, d3d12_bo*, bo) {
+      /* Another batch may have made it resident in the meantime, and
+       * suballocations can list the same base bo more than once.
+       */
+      if ((*bo)->residency_status != d3d12_evicted)
+         continue;
+      if (usage + (*bo)->estimated_size > headroom_budget)
+         break;
+
+      (*bo)->residency_status = d3d12_resident;
+      usage += (*bo)->estimated_size;
+      bos[count] = *bo;
+      to_make_resident[count++] = (*bo)->res;
+      if (count == residency_batch_size)
+         break;
+   }
+   util_dynarray_clear(&batch->prefetch_bos);
+
+   if (count &&
+       FAILED(screen->dev->EnqueueMakeResident(D3D12_RESIDENCY_FLAG_NONE, count, to_make_resident,
+                                               screen->residency_fence, screen->residency_fence_value + 1))) {
+      /* Leave them to the submission */
+      for (unsigned i = 0; i < count; i++)
+         bos[i]->residency_status = d3d12_evicted;
+   } else if (count) {
+      ++screen->residency_fence_value;
+
+      uint64_t pending_fence_value = screen->fence_value + 1;
+      int64_t current_time = os_time_get();
+      for (unsigned i = 0; i < count; i++) {
+         bos[i]->last_used_fence = pending_fence_value;
+         bos[i]->last_used_timestamp = current_time;
+         list_addtail(&bos[i]->residency_list_entry, &screen->residency_list);
+         log_make_resident_info(screen, bos[i]);
+      }
+      screen->num_prefetched += count;
+   }
+
+   mtx_unlock(&screen->submit_mutex);
 }
 
 bool
@@ -29,6 +29,9 @@ struct d3d12_batch;
 void
 d3d12_process_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *batch);
 
+void
+d3d12_prefetch_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *batch);
+
 bool
 d3d12_init_residency(struct d3d12_screen *screen);
 
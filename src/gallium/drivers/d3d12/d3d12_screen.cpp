@@ -44,6 +44,7 @@
 #include "util/u_screen.h"
 #include "util/u_dl.h"
 #include "util/mesa-sha1.h"
+#include "util/disk_cache.h"
 
 #include "nir.h"
 #include "frontend/sw_winsys.h"
@@ -75,6 +76,7 @@ d3d12_debug_options[] = {
    { "gpuvalidator", D3D12_DEBUG_GPU_VALIDATOR, "Enable GPU validator" },
    { "singleton",    D3D12_DEBUG_SINGLETON,     "Disallow use of device factory" },
    { "pix",          D3D12_DEBUG_PIX,           "Load WinPixGpuCaptuerer.dll" },
+   { "residency",    D3D12_DEBUG_RESIDENCY,     "Print residency churn on every submission" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -665,6 +667,8 @@ d3d12_destroy_screen(struct d3d12_screen *screen)
    mtx_destroy(&screen->varying_info_mutex);
 #endif // HAVE_GALLIUM_D3D12_GRAPHICS
 
+   disk_cache_destroy(screen->disk_cache);
+
    if (screen->d3d12_mod)
       util_dl_close(screen->d3d12_mod);
    glsl_type_singleton_decref();
@@ -1423,6 +1427,26 @@ try_create_device_factory(util_dl_library *d3d12_mod)
 }
 #endif
 
+static void
+d3d12_disk_cache_create(struct d3d12_screen *screen)
+{
+   struct mesa_sha1 sha1_ctx;
+   uint8_t sha1[SHA1_DIGEST_LENGTH];
+   char cache_id[SHA1_DIGEST_LENGTH * 2 + 1];
+
+   _mesa_sha1_init(&sha1_ctx);
+   if (!disk_cache_get_function_identifier((void *)d3d12_disk_cache_create, &sha1_ctx))
+      return;
+
+   /* Cached PSOs are only usable with the adapter and driver that produced them. */
+   _mesa_sha1_update(&sha1_ctx, screen->device_uuid, sizeof(screen->device_uuid));
+   _mesa_sha1_update(&sha1_ctx, &screen->driver_version, sizeof(screen->driver_version));
+   _mesa_sha1_final(&sha1_ctx, sha1);
+   _mesa_sha1_format(cache_id, sha1);
+
+   screen->disk_cache = disk_cache_create("d3d12", cache_id, 0);
+}
+
 bool
 d3d12_init_screen(struct d3d12_screen *screen, IUnknown *adapter)
 {
@@ -1715,5 +1739,8 @@ d3d12_init_screen(struct d3d12_screen *screen, IUnknown *adapter)
    d3d12_init_compute_caps(screen);
    d3d12_init_screen_caps(screen);
 
+   if (!screen->disk_cache)
+      d3d12_disk_cache_create(screen);
+
    return true;
 }
@@ -84,8 +84,13 @@ struct d3d12_screen {
    struct list_head residency_list;
    ID3D12Fence *residency_fence;
    uint64_t residency_fence_value;
+   uint64_t residency_fence_waited;
    unsigned num_evictions;
    uint64_t total_bytes_evicted;
+   unsigned num_made_resident;
+   uint64_t total_bytes_made_resident;
+   unsigned num_prefetched;
+   unsigned num_residency_stalls;
 
    struct list_head context_list;
    unsigned context_id_list[16];
@@ -94,6 +99,9 @@ struct d3d12_screen {
    struct set* varying_info_set;
    mtx_t varying_info_mutex;
 
+   /* cached PSO blobs, so that later runs don't have to recompile them */
+   struct disk_cache *disk_cache;
+
    struct slab_parent_pool transfer_pool;
    struct pb_manager *bufmgr;
    struct pb_manager *cache_bufmgr;
@@ -28,6 +28,7 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <algorithm>
 
 #include "pipe/p_context.h"
 #include "pipe/p_video_codec.h"
@@ -69,7 +70,12 @@ const bool D3D12_VIDEO_ENC_CBR_FORCE_VBV_EQUAL_BITRATE = debug_get_bool_option("
  */
 const size_t D3D12_VIDEO_ENC_ASYNC_DEPTH = static_cast<size_t>(debug_get_num_option("D3D12_VIDEO_ENC_ASYNC_DEPTH", 8));
 
-const size_t D3D12_VIDEO_ENC_METADATA_BUFFERS_COUNT = static_cast<size_t>(debug_get_num_option("D3D12_VIDEO_ENC_METADATA_BUFFERS_COUNT", 2 * D3D12_VIDEO_ENC_ASYNC_DEPTH));
+/**
+ * Number of frames whose metadata can be awaiting get_feedback, frames in flight
+ * need one each so this can't be below the async depth
+ */
+const size_t D3D12_VIDEO_ENC_METADATA_BUFFERS_COUNT = std::max(D3D12_VIDEO_ENC_ASYNC_DEPTH,
+   static_cast<size_t>(debug_get_num_option("D3D12_VIDEO_ENC_METADATA_BUFFERS_COUNT", 2 * D3D12_VIDEO_ENC_ASYNC_DEPTH)));
 
 constexpr unsigned int D3D12_VIDEO_H264_MB_IN_PIXELS = 16;
 
@@ -311,6 +311,7 @@ llvmpipe_create_context(struct pipe_screen *screen, void *priv,
       goto fail;
 
    llvmpipe->pipe.const_uploader = llvmpipe->pipe.stream_uploader;
+   u_upload_enable_ring(llvmpipe->pipe.stream_uploader);
 
    llvmpipe->blitter = util_blitter_create(&llvmpipe->pipe);
    if (!llvmpipe->blitter) {
@@ -28,10 +28,48 @@
  * based on threadpool.c but modified heavily to be compute shader tuned.
  */
 
+#include "util/u_cpu_detect.h"
+#include "util/u_debug.h"
 #include "util/u_thread.h"
 #include "util/u_memory.h"
 #include "lp_cs_tpool.h"
 
+DEBUG_GET_ONCE_BOOL_OPTION(thread_affinity, "LP_THREAD_AFFINITY", true)
+
+/**
+ * Number of L3 cache domains to spread num_threads worker threads over.
+ * Worker i is meant to run in domain i % domains.  This is 1 if there is
+ * only a single L3 or if pinning is disabled.
+ */
+unsigned
+lp_thread_num_l3_domains(unsigned num_threads)
+{
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+
+   if (!debug_get_option_thread_affinity() || !caps->L3_affinity_mask)
+      return 1;
+
+   return MAX2(MIN2(caps->num_L3_caches, num_threads), 1);
+}
+
+/**
+ * Pin the calling thread to the CPUs sharing the L3 cache of the given
+ * domain.  The L3 caches of different sockets are distinct, so this keeps
+ * a thread on one NUMA node as well.
+ */
+void
+lp_thread_bind_l3_domain(unsigned domain, unsigned num_domains)
+{
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+
+   if (num_domains <= 1)
+      return;
+
+   unsigned L3 = domain * caps->num_L3_caches / num_domains;
+   util_set_current_thread_affinity(caps->L3_affinity_mask[L3], NULL,
+                                    caps->num_cpu_mask_bits);
+}
+
 static int
 lp_cs_tpool_worker(void *data)
 {
@@ -41,6 +79,9 @@ lp_cs_tpool_worker(void *data)
    memset(&lmem, 0, sizeof(lmem));
    mtx_lock(&pool->m);
 
+   lp_thread_bind_l3_domain(pool->num_started++ % pool->num_l3_domains,
+                            pool->num_l3_domains);
+
    while (!pool->shutdown) {
       struct lp_cs_tpool_task *task;
       unsigned iter_per_thread;
@@ -96,6 +137,7 @@ lp_cs_tpool_create(unsigned num_threads)
 
    list_inithead(&pool->workqueue);
    assert (num_threads <= LP_MAX_THREADS);
+   pool->num_l3_domains = lp_thread_num_l3_domains(num_threads);
    for (unsigned i = 0; i < num_threads; i++) {
       if (thrd_success != u_thread_create(pool->threads + i, lp_cs_tpool_worker, pool)) {
          num_threads = i;  /* previous thread is max */
@@ -47,6 +47,8 @@ struct lp_cs_tpool {
 
    thrd_t threads[LP_MAX_THREADS];
    unsigned num_threads;
+   unsigned num_started;
+   unsigned num_l3_domains;
    struct list_head workqueue;
    bool shutdown;
 };
@@ -80,4 +82,7 @@ struct lp_cs_tpool_task *lp_cs_tpool_queue_task(struct lp_cs_tpool *,
 void lp_cs_tpool_wait_for_task(struct lp_cs_tpool *pool,
                             struct lp_cs_tpool_task **task);
 
+unsigned lp_thread_num_l3_domains(unsigned num_threads);
+void lp_thread_bind_l3_domain(unsigned domain, unsigned num_domains);
+
 #endif /* LP_BIN_QUEUE */
@@ -34,6 +34,7 @@
 #include "pipe/p_screen.h"
 #include "util/u_debug_image.h"
 #include "util/u_string.h"
+#include "util/u_upload_mgr.h"
 #include "draw/draw_context.h"
 #include "lp_flush.h"
 #include "lp_context.h"
@@ -59,10 +60,17 @@ llvmpipe_flush(struct pipe_context *pipe,
    /* ask the setup module to flush */
    lp_setup_flush(llvmpipe->setup, reason);
 
+   struct pipe_fence_handle *upload_fence = NULL;
+
    mtx_lock(&screen->rast_mutex);
    lp_rast_fence(screen->rast, (struct lp_fence **)fence);
+   lp_rast_fence(screen->rast, (struct lp_fence **)&upload_fence);
    mtx_unlock(&screen->rast_mutex);
 
+   /* Lets the ring mode uploader recycle the buffers of this flush. */
+   u_upload_fence(pipe->stream_uploader, upload_fence);
+   lp_fence_reference((struct lp_fence **)&upload_fence, NULL);
+
    if (fence && (!*fence))
       *fence = (struct pipe_fence_handle *)lp_fence_create(0);
 
@@ -68,6 +68,12 @@
 
 #define LP_MAX_THREADS 32
 
+/**
+ * Max number of pieces a triangle batch is split into for binning,
+ * one for the context thread plus one per binner thread.
+ */
+#define LP_MAX_BIN_JOBS 16
+
 
 /**
  * Max number of shader variants (for all shaders combined,
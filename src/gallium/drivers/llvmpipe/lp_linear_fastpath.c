@@ -202,8 +202,11 @@ lp_linear_check_fastpath(struct lp_fragment_shader_variant *variant)
       return false;
 
    const enum pipe_format tex_format = samp0->texture_state.format;
+   const enum pipe_format cbuf_format = variant->key.cbuf_format[0];
    if (variant->shader->kind == LP_FS_KIND_BLIT_RGBA &&
-       tex_format == PIPE_FORMAT_B8G8R8A8_UNORM &&
+       (tex_format == PIPE_FORMAT_B8G8R8A8_UNORM ||
+        tex_format == PIPE_FORMAT_R8G8B8A8_UNORM) &&
+       is_rgba8_same_order(tex_format, cbuf_format) &&
        is_nearest_clamp_sampler(samp0) &&
        variant->opaque) {
       variant->jit_linear_blit             = lp_linear_blit_rgba_blit;
@@ -211,8 +214,7 @@ lp_linear_check_fastpath(struct lp_fragment_shader_variant *variant)
 
    if (variant->shader->kind == LP_FS_KIND_BLIT_RGB1 &&
        variant->opaque &&
-       (tex_format == PIPE_FORMAT_B8G8R8A8_UNORM ||
-        tex_format == PIPE_FORMAT_B8G8R8X8_UNORM) &&
+       is_rgba8_same_order(tex_format, cbuf_format) &&
        is_nearest_clamp_sampler(samp0)) {
       variant->jit_linear_blit             = lp_linear_blit_rgb1_blit;
    }
@@ -113,6 +113,29 @@ is_nearest_clamp_sampler(const struct lp_sampler_static_state *sampler)
 }
 
 
+/* Check whether 32bpp texels of the given format can be written to the
+ * color buffer unchanged, ie. both share the same rgb byte order with
+ * alpha (or x) in the top byte.
+ */
+static inline bool
+is_rgba8_same_order(enum pipe_format tex_format,
+                    enum pipe_format cbuf_format)
+{
+   switch (tex_format) {
+   case PIPE_FORMAT_B8G8R8A8_UNORM:
+   case PIPE_FORMAT_B8G8R8X8_UNORM:
+      return cbuf_format == PIPE_FORMAT_B8G8R8A8_UNORM ||
+             cbuf_format == PIPE_FORMAT_B8G8R8X8_UNORM;
+   case PIPE_FORMAT_R8G8B8A8_UNORM:
+   case PIPE_FORMAT_R8G8B8X8_UNORM:
+      return cbuf_format == PIPE_FORMAT_R8G8B8A8_UNORM ||
+             cbuf_format == PIPE_FORMAT_R8G8B8X8_UNORM;
+   default:
+      return false;
+   }
+}
+
+
 /* Check for a sampler variant which matches is_linear_sampler
  * but has the additional constraints of using clamp wrapping
  */
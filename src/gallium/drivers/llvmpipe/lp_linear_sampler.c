@@ -691,8 +691,19 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
        return false;
    }
 
+   /* An alpha swizzle of one (eg. an XRGB buffer imported as BGRA) is
+    * the same as fetching from the X8 format.
+    */
+   enum pipe_format format = sampler_state->texture_state.format;
+   if (sampler_state->texture_state.swizzle_a == PIPE_SWIZZLE_1) {
+      if (format == PIPE_FORMAT_B8G8R8A8_UNORM)
+         format = PIPE_FORMAT_B8G8R8X8_UNORM;
+      else if (format == PIPE_FORMAT_R8G8B8A8_UNORM)
+         format = PIPE_FORMAT_R8G8B8X8_UNORM;
+   }
+
    if (is_nearest) {
-      switch (sampler_state->texture_state.format) {
+      switch (format) {
       case PIPE_FORMAT_B8G8R8A8_UNORM:
          if (rgba_order) {
             if (need_wrap)
@@ -787,7 +798,7 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
       samp->stretched_row_y[1] = -1;
       samp->stretched_row_index = 0;
 
-      switch (sampler_state->texture_state.format) {
+      switch (format) {
       case PIPE_FORMAT_B8G8R8A8_UNORM:
          if (rgba_order) {
             if (need_wrap)
@@ -915,11 +926,14 @@ lp_linear_check_sampler(const struct lp_sampler_static_state *sampler,
        sampler->texture_state.format != PIPE_FORMAT_R8G8B8X8_UNORM)
       return false;
 
-   /* We don't support sampler view swizzling on the linear path */
+   /* We don't support sampler view swizzling on the linear path, other
+    * than forcing alpha to one.
+    */
    if (sampler->texture_state.swizzle_r != PIPE_SWIZZLE_X ||
        sampler->texture_state.swizzle_g != PIPE_SWIZZLE_Y ||
        sampler->texture_state.swizzle_b != PIPE_SWIZZLE_Z ||
-       sampler->texture_state.swizzle_a != PIPE_SWIZZLE_W) {
+       (sampler->texture_state.swizzle_a != PIPE_SWIZZLE_W &&
+        sampler->texture_state.swizzle_a != PIPE_SWIZZLE_1)) {
       return false;
    }
 
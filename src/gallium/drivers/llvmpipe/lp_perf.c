@@ -118,6 +118,17 @@ lp_print_counters(void)
       debug_printf("llvmpipe: nr_color_tile_load:           %9u\n", lp_count.nr_color_tile_load);
       debug_printf("llvmpipe: nr_color_tile_store:          %9u\n", lp_count.nr_color_tile_store);
 
+      debug_printf("llvmpipe: nr_scenes:                    %9u\n", lp_count.nr_scenes);
+      debug_printf("llvmpipe:   average scene size:         %9.0f KB\n",
+                   lp_count.scene_bytes / 1024.0 / MAX2(lp_count.nr_scenes, 1));
+      debug_printf("llvmpipe:   nr_scene_blocks:            %9u\n", lp_count.nr_scene_blocks);
+      debug_printf("llvmpipe:     nr_scene_blocks_reused:   %9u (%3.0f%% of %u)\n",
+                   lp_count.nr_scene_blocks_reused,
+                   100.0 * lp_count.nr_scene_blocks_reused / MAX2(lp_count.nr_scene_blocks, 1),
+                   lp_count.nr_scene_blocks);
+      debug_printf("llvmpipe:   nr_scene_pool_growths:      %9u (2 MB each)\n",
+                   lp_count.nr_scene_chunks);
+
       debug_printf("llvmpipe: nr_llvm_compiles:             %u\n", lp_count.nr_llvm_compiles);
       debug_printf("llvmpipe: total LLVM compile time:      %.2f sec\n", lp_count.llvm_compile_time / 1000000.0);
       debug_printf("llvmpipe: average LLVM compile time:    %.2f sec\n", lp_count.llvm_compile_time / 1000000.0 / lp_count.nr_llvm_compiles);
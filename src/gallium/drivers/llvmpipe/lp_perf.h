@@ -68,6 +68,12 @@ struct lp_counters
    unsigned nr_color_tile_clear;
    unsigned nr_color_tile_load;
    unsigned nr_color_tile_store;
+
+   unsigned nr_scenes;
+   int64_t scene_bytes;             /**< total, over all scenes */
+   unsigned nr_scene_blocks;        /**< data blocks handed out */
+   unsigned nr_scene_blocks_reused; /**< ... out of previously used memory */
+   unsigned nr_scene_chunks;        /**< times the scene pool had to grow */
 };
 
 
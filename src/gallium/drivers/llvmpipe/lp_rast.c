@@ -37,6 +37,7 @@
 #include "util/os_time.h"
 
 #include "lp_scene_queue.h"
+#include "lp_cs_tpool.h"
 #include "lp_context.h"
 #include "lp_debug.h"
 #include "lp_fence.h"
@@ -78,7 +79,7 @@ lp_rast_begin(struct lp_rasterizer *rast,
    LP_DBG(DEBUG_RAST, "%s\n", __func__);
 
    lp_scene_begin_rasterization(scene);
-   lp_scene_bin_iter_begin(scene);
+   lp_scene_bin_iter_begin(scene, rast->num_l3_domains);
 }
 
 
@@ -1064,7 +1065,7 @@ rasterize_scene(struct lp_rasterizer_task *task,
       int i, j;
 
       assert(scene);
-      while ((bin = lp_scene_bin_iter_next(scene, &i, &j))) {
+      while ((bin = lp_scene_bin_iter_next(scene, task->l3_domain, &i, &j))) {
          if (!is_empty_bin(bin))
             rasterize_bin(task, bin, i, j);
       }
@@ -1169,6 +1170,8 @@ thread_function(void *init_data)
    snprintf(thread_name, sizeof thread_name, "llvmpipe-%u", task->thread_index);
    u_thread_setname(thread_name);
 
+   lp_thread_bind_l3_domain(task->l3_domain, rast->num_l3_domains);
+
    /* Make sure that denorms are treated like zeros. This is
     * the behavior required by D3D10. OpenGL doesn't care.
     */
@@ -1267,10 +1270,13 @@ lp_rast_create(unsigned num_threads)
       goto no_full_scenes;
    }
 
+   rast->num_l3_domains = lp_thread_num_l3_domains(num_threads);
+
    for (unsigned i = 0; i < MAX2(1, num_threads); i++) {
       struct lp_rasterizer_task *task = &rast->tasks[i];
       task->rast = rast;
       task->thread_index = i;
+      task->l3_domain = i % rast->num_l3_domains;
       task->thread_data.cache =
          align_malloc(sizeof(struct lp_build_format_cache), 16);
       if (!task->thread_data.cache) {
@@ -1282,6 +1288,8 @@ lp_rast_create(unsigned num_threads)
 
    rast->no_rast = debug_get_bool_option("LP_NO_RAST", false);
 
+   lp_rast_init_tri_funcs();
+
    create_rast_threads(rast);
 
    /* for synchronizing rasterization threads */
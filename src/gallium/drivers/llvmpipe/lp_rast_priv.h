@@ -96,6 +96,7 @@ struct lp_rasterizer_task
 
    /** "my" index */
    unsigned thread_index;
+   unsigned l3_domain;     /**< see lp_scene_bin_iter_next() */
 
    /** Non-interpolated passthru state and occlude counter for visible pixels */
    struct lp_jit_thread_data thread_data;
@@ -128,6 +129,7 @@ struct lp_rasterizer
    struct lp_rasterizer_task tasks[LP_MAX_THREADS];
 
    unsigned num_threads;
+   unsigned num_l3_domains;
    thrd_t threads[LP_MAX_THREADS];
 
    /** For synchronizing the rasterization threads */
@@ -362,6 +364,71 @@ void
 lp_rast_triangle_32_4_16(struct lp_rasterizer_task *,
                          const union lp_rast_cmd_arg);
 
+/* Coverage kernels behind lp_rast_triangle_32_3_16/_3_4.  They return the
+ * mask of pixels outside of the triangle, for the 16x16 variant only for
+ * the 4x4 blocks which are neither trivially rejected nor fully outside.
+ */
+struct lp_rast_block_mask {
+   unsigned mask:16;
+   unsigned i:8;        /**< block row */
+   unsigned j:8;        /**< block column */
+};
+
+typedef unsigned
+(*lp_rast_tri_32_3_16_masks_func)(const struct lp_rast_plane *plane,
+                                  int x, int y,
+                                  struct lp_rast_block_mask out[16]);
+
+typedef unsigned
+(*lp_rast_tri_32_3_4_mask_func)(const struct lp_rast_plane *plane,
+                                int x, int y);
+
+/* Per-plane values in the layout the kernels want: c at (x, y) biased so a
+ * sign test is enough, dcdx negated and the 4x4 block trivial reject bias.
+ * Everything wraps around in 32 bits, like the SSE2 code.
+ */
+static inline void
+lp_rast_tri_32_3_prepare(const struct lp_rast_plane *plane, int x, int y,
+                         uint32_t c[3], uint32_t dcdx[3], uint32_t dcdy[3],
+                         uint32_t rej4[3])
+{
+   for (unsigned i = 0; i < 3; i++) {
+      const int32_t dx = plane[i].dcdx;
+      const int32_t dy = plane[i].dcdy;
+
+      dcdx[i] = 0u - (uint32_t)dx;
+      dcdy[i] = (uint32_t)dy;
+      rej4[i] = ((uint32_t)MAX2(dy, 0) - (uint32_t)MIN2(dx, 0)) * 4 + 1;
+      c[i] = (uint32_t)plane[i].c + dcdx[i] * (uint32_t)x +
+             dcdy[i] * (uint32_t)y - 1;
+   }
+}
+
+#if DETECT_ARCH_SSE
+unsigned
+lp_rast_tri_32_3_16_masks_sse2(const struct lp_rast_plane *plane, int x, int y,
+                               struct lp_rast_block_mask out[16]);
+unsigned
+lp_rast_tri_32_3_4_mask_sse2(const struct lp_rast_plane *plane, int x, int y);
+#endif
+
+#if DETECT_ARCH_X86_64
+unsigned
+lp_rast_tri_32_3_16_masks_avx2(const struct lp_rast_plane *plane, int x, int y,
+                               struct lp_rast_block_mask out[16]);
+unsigned
+lp_rast_tri_32_3_4_mask_avx2(const struct lp_rast_plane *plane, int x, int y);
+
+unsigned
+lp_rast_tri_32_3_16_masks_avx512(const struct lp_rast_plane *plane, int x, int y,
+                                 struct lp_rast_block_mask out[16]);
+unsigned
+lp_rast_tri_32_3_4_mask_avx512(const struct lp_rast_plane *plane, int x, int y);
+#endif
+
+void
+lp_rast_init_tri_funcs(void);
+
 void
 lp_rast_rectangle(struct lp_rasterizer_task *,
                   const union lp_rast_cmd_arg);
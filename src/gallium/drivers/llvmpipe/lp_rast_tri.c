@@ -31,6 +31,7 @@
 
 #include <limits.h>
 #include "util/u_math.h"
+#include "util/u_cpu_detect.h"
 #include "lp_debug.h"
 #include "lp_perf.h"
 #include "lp_rast_priv.h"
@@ -288,16 +289,10 @@ static unsigned right_mask_tab[STAMP_SIZE] = {
 
 #define NR_PLANES 3
 
-void
-lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
-                         const union lp_rast_cmd_arg arg)
+unsigned
+lp_rast_tri_32_3_16_masks_sse2(const struct lp_rast_plane *plane, int x, int y,
+                               struct lp_rast_block_mask out[16])
 {
-   const struct lp_rast_triangle *tri = arg.triangle.tri;
-   const struct lp_rast_plane *plane = GET_PLANES(tri);
-   const int x = (arg.triangle.plane_mask & 0xff) + task->x;
-   const int y = (arg.triangle.plane_mask >> 8) + task->y;
-
-   struct { unsigned mask:16; unsigned i:8; unsigned j:8; } out[16];
    unsigned nr = 0;
 
    /* p0 and p2 are aligned, p1 is not (plane size 24 bytes). */
@@ -392,23 +387,12 @@ lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
       c = _mm_add_epi32(c, _mm_slli_epi32(dcdy, 2));
    }
 
-   for (unsigned i = 0; i < nr; i++)
-      lp_rast_shade_quads_mask(task,
-                               &tri->inputs,
-                               x + 4 * out[i].j,
-                               y + 4 * out[i].i,
-                               0xffff & ~out[i].mask);
+   return nr;
 }
 
-void
-lp_rast_triangle_32_3_4(struct lp_rasterizer_task *task,
-                        const union lp_rast_cmd_arg arg)
+unsigned
+lp_rast_tri_32_3_4_mask_sse2(const struct lp_rast_plane *plane, int x, int y)
 {
-   const struct lp_rast_triangle *tri = arg.triangle.tri;
-   const struct lp_rast_plane *plane = GET_PLANES(tri);
-   const unsigned x = (arg.triangle.plane_mask & 0xff) + task->x;
-   const unsigned y = (arg.triangle.plane_mask >> 8) + task->y;
-
    /* p0 and p2 are aligned, p1 is not (plane size 24 bytes). */
    __m128i p0 = _mm_load_si128((__m128i *)&plane[0]); /* clo, chi, dcdx, dcdy */
    __m128i p1 = _mm_loadu_si128((__m128i *)&plane[1]);
@@ -471,19 +455,84 @@ lp_rast_triangle_32_3_4(struct lp_rasterizer_task *task,
       __m128i c_23 = _mm_packs_epi32(c_2, c_3);
       __m128i c_0123 = _mm_packs_epi16(c_01, c_23);
 
-      unsigned mask = _mm_movemask_epi8(c_0123);
-
-      if (mask != 0xffff)
-         lp_rast_shade_quads_mask(task,
-                                  &tri->inputs,
-                                  x,
-                                  y,
-                                  0xffff & ~mask);
+      return _mm_movemask_epi8(c_0123);
    }
 }
 
 #undef NR_PLANES
 
+
+/* The kernels above, or wider variants of them, picked once at runtime.
+ */
+static struct {
+   lp_rast_tri_32_3_16_masks_func masks_16;
+   lp_rast_tri_32_3_4_mask_func mask_4;
+} tri_32_3_funcs = {
+   lp_rast_tri_32_3_16_masks_sse2,
+   lp_rast_tri_32_3_4_mask_sse2,
+};
+
+static void
+init_tri_32_3_funcs(void)
+{
+#if DETECT_ARCH_X86_64
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+
+   if (caps->has_avx512f) {
+      tri_32_3_funcs.masks_16 = lp_rast_tri_32_3_16_masks_avx512;
+      tri_32_3_funcs.mask_4 = lp_rast_tri_32_3_4_mask_avx512;
+   } else if (caps->has_avx2) {
+      tri_32_3_funcs.masks_16 = lp_rast_tri_32_3_16_masks_avx2;
+      tri_32_3_funcs.mask_4 = lp_rast_tri_32_3_4_mask_avx2;
+   }
+#endif
+}
+
+void
+lp_rast_init_tri_funcs(void)
+{
+   static once_flag once = ONCE_FLAG_INIT;
+   call_once(&once, init_tri_32_3_funcs);
+}
+
+void
+lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
+                         const union lp_rast_cmd_arg arg)
+{
+   const struct lp_rast_triangle *tri = arg.triangle.tri;
+   const struct lp_rast_plane *plane = GET_PLANES(tri);
+   const int x = (arg.triangle.plane_mask & 0xff) + task->x;
+   const int y = (arg.triangle.plane_mask >> 8) + task->y;
+
+   struct lp_rast_block_mask out[16];
+   unsigned nr = tri_32_3_funcs.masks_16(plane, x, y, out);
+
+   for (unsigned i = 0; i < nr; i++)
+      lp_rast_shade_quads_mask(task,
+                               &tri->inputs,
+                               x + 4 * out[i].j,
+                               y + 4 * out[i].i,
+                               0xffff & ~out[i].mask);
+}
+
+void
+lp_rast_triangle_32_3_4(struct lp_rasterizer_task *task,
+                        const union lp_rast_cmd_arg arg)
+{
+   const struct lp_rast_triangle *tri = arg.triangle.tri;
+   const struct lp_rast_plane *plane = GET_PLANES(tri);
+   const int x = (arg.triangle.plane_mask & 0xff) + task->x;
+   const int y = (arg.triangle.plane_mask >> 8) + task->y;
+
+   unsigned mask = tri_32_3_funcs.mask_4(plane, x, y);
+   if (mask != 0xffff)
+      lp_rast_shade_quads_mask(task,
+                               &tri->inputs,
+                               x,
+                               y,
+                               0xffff & ~mask);
+}
+
 #else
 
 #if defined(_ARCH_PWR8) && UTIL_ARCH_LITTLE_ENDIAN
@@ -730,6 +779,11 @@ lp_rast_triangle_32_3_4(struct lp_rasterizer_task *task,
    lp_rast_triangle_32_3_16(task, arg);
 }
 
+void
+lp_rast_init_tri_funcs(void)
+{
+}
+
 #endif
 
 #if DETECT_ARCH_SSE
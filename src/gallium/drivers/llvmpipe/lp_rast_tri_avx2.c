@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * AVX2 versions of the 32-bit, 3-plane coverage kernels.  The sixteen
+ * 4x4 blocks (or the sixteen pixels of a block) are split over two ymm
+ * registers: rows 0-1 in the low half and rows 2-3 in the high half.
+ *
+ * Built with -mavx2 and only called when util_get_cpu_caps() reports
+ * AVX2, see lp_rast_init_tri_funcs().
+ */
+
+#include "util/detect_arch.h"
+
+#if DETECT_ARCH_X86_64
+
+#include <immintrin.h>
+
+#include "util/bitscan.h"
+#include "lp_rast_priv.h"
+
+
+static inline unsigned
+sign_mask(__m256i lo, __m256i hi)
+{
+   return _mm256_movemask_ps(_mm256_castsi256_ps(lo)) |
+          _mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8;
+}
+
+
+/* Lane k of lo is column k & 3 of row k >> 2, hi is two rows further down,
+ * which is the bit order of the masks the SSE2 code builds.
+ */
+static inline void
+lane_offsets(uint32_t dx, uint32_t dy, __m256i *lo, __m256i *hi)
+{
+   const __m256i col = _mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3);
+   const __m256i row = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+   const __m256i vdy = _mm256_set1_epi32(dy);
+
+   *lo = _mm256_add_epi32(_mm256_mullo_epi32(col, _mm256_set1_epi32(dx)),
+                          _mm256_mullo_epi32(row, vdy));
+   *hi = _mm256_add_epi32(*lo, _mm256_slli_epi32(vdy, 1));
+}
+
+
+unsigned
+lp_rast_tri_32_3_16_masks_avx2(const struct lp_rast_plane *plane, int x, int y,
+                               struct lp_rast_block_mask out[16])
+{
+   uint32_t c[3], dcdx[3], dcdy[3], rej4[3];
+   alignas(32) int32_t blk[3][16];
+   __m256i span_lo[3], span_hi[3];
+   unsigned rej = 0;
+   unsigned nr = 0;
+
+   lp_rast_tri_32_3_prepare(plane, x, y, c, dcdx, dcdy, rej4);
+
+   for (unsigned p = 0; p < 3; p++) {
+      __m256i lo, hi;
+
+      lane_offsets(dcdx[p] * 4, dcdy[p] * 4, &lo, &hi);
+      lo = _mm256_add_epi32(lo, _mm256_set1_epi32(c[p]));
+      hi = _mm256_add_epi32(hi, _mm256_set1_epi32(c[p]));
+
+      rej |= sign_mask(_mm256_add_epi32(lo, _mm256_set1_epi32(rej4[p])),
+                       _mm256_add_epi32(hi, _mm256_set1_epi32(rej4[p])));
+      _mm256_store_si256((__m256i *)&blk[p][0], lo);
+      _mm256_store_si256((__m256i *)&blk[p][8], hi);
+      lane_offsets(dcdx[p], dcdy[p], &span_lo[p], &span_hi[p]);
+   }
+
+   unsigned live = ~rej & 0xffff;
+   while (live) {
+      const unsigned k = u_bit_scan(&live);
+      __m256i lo = _mm256_setzero_si256();
+      __m256i hi = _mm256_setzero_si256();
+
+      for (unsigned p = 0; p < 3; p++) {
+         __m256i cblk = _mm256_set1_epi32(blk[p][k]);
+
+         lo = _mm256_or_si256(lo, _mm256_add_epi32(cblk, span_lo[p]));
+         hi = _mm256_or_si256(hi, _mm256_add_epi32(cblk, span_hi[p]));
+      }
+
+      unsigned mask = sign_mask(lo, hi);
+
+      out[nr].i = k >> 2;
+      out[nr].j = k & 3;
+      out[nr].mask = mask;
+      if (mask != 0xffff)
+         nr++;
+   }
+
+   return nr;
+}
+
+
+unsigned
+lp_rast_tri_32_3_4_mask_avx2(const struct lp_rast_plane *plane, int x, int y)
+{
+   uint32_t c[3], dcdx[3], dcdy[3], rej4[3];
+   __m256i lo = _mm256_setzero_si256();
+   __m256i hi = _mm256_setzero_si256();
+
+   lp_rast_tri_32_3_prepare(plane, x, y, c, dcdx, dcdy, rej4);
+
+   for (unsigned p = 0; p < 3; p++) {
+      __m256i span_lo, span_hi;
+      __m256i cp = _mm256_set1_epi32(c[p]);
+
+      lane_offsets(dcdx[p], dcdy[p], &span_lo, &span_hi);
+      lo = _mm256_or_si256(lo, _mm256_add_epi32(cp, span_lo));
+      hi = _mm256_or_si256(hi, _mm256_add_epi32(cp, span_hi));
+   }
+
+   return sign_mask(lo, hi);
+}
+
+#endif /* DETECT_ARCH_X86_64 */
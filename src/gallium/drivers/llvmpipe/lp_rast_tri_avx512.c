@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * AVX-512 versions of the 32-bit, 3-plane coverage kernels.  All sixteen
+ * 4x4 blocks (or the sixteen pixels of a block) fit in one zmm register,
+ * so each plane is evaluated with a single add per step.
+ *
+ * Built with -mavx512f and only called when util_get_cpu_caps() reports
+ * AVX-512F, see lp_rast_init_tri_funcs().
+ */
+
+#include "util/detect_arch.h"
+
+#if DETECT_ARCH_X86_64
+
+#include <immintrin.h>
+
+#include "util/bitscan.h"
+#include "lp_rast_priv.h"
+
+
+/* Lane k is pixel (or block) column k & 3 of row k >> 2, which is also the
+ * bit order of the masks the SSE2 code builds.
+ */
+static inline __m512i
+lane_offsets(uint32_t dx, uint32_t dy)
+{
+   const __m512i col = _mm512_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3,
+                                         0, 1, 2, 3, 0, 1, 2, 3);
+   const __m512i row = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1,
+                                         2, 2, 2, 2, 3, 3, 3, 3);
+
+   return _mm512_add_epi32(_mm512_mullo_epi32(col, _mm512_set1_epi32(dx)),
+                           _mm512_mullo_epi32(row, _mm512_set1_epi32(dy)));
+}
+
+
+unsigned
+lp_rast_tri_32_3_16_masks_avx512(const struct lp_rast_plane *plane, int x, int y,
+                                 struct lp_rast_block_mask out[16])
+{
+   uint32_t c[3], dcdx[3], dcdy[3], rej4[3];
+   alignas(64) int32_t blk[3][16];
+   __m512i span[3];
+   __mmask16 rej = 0;
+   unsigned nr = 0;
+
+   lp_rast_tri_32_3_prepare(plane, x, y, c, dcdx, dcdy, rej4);
+
+   for (unsigned p = 0; p < 3; p++) {
+      __m512i cblk = _mm512_add_epi32(_mm512_set1_epi32(c[p]),
+                                      lane_offsets(dcdx[p] * 4, dcdy[p] * 4));
+
+      rej |= _mm512_cmplt_epi32_mask(_mm512_add_epi32(cblk, _mm512_set1_epi32(rej4[p])),
+                                     _mm512_setzero_si512());
+      _mm512_store_si512(blk[p], cblk);
+      span[p] = lane_offsets(dcdx[p], dcdy[p]);
+   }
+
+   unsigned live = ~rej & 0xffff;
+   while (live) {
+      const unsigned k = u_bit_scan(&live);
+
+      __m512i c0 = _mm512_add_epi32(_mm512_set1_epi32(blk[0][k]), span[0]);
+      __m512i c1 = _mm512_add_epi32(_mm512_set1_epi32(blk[1][k]), span[1]);
+      __m512i c2 = _mm512_add_epi32(_mm512_set1_epi32(blk[2][k]), span[2]);
+      __m512i cc = _mm512_or_si512(_mm512_or_si512(c0, c1), c2);
+
+      unsigned mask = _mm512_cmplt_epi32_mask(cc, _mm512_setzero_si512());
+
+      out[nr].i = k >> 2;
+      out[nr].j = k & 3;
+      out[nr].mask = mask;
+      if (mask != 0xffff)
+         nr++;
+   }
+
+   return nr;
+}
+
+
+unsigned
+lp_rast_tri_32_3_4_mask_avx512(const struct lp_rast_plane *plane, int x, int y)
+{
+   uint32_t c[3], dcdx[3], dcdy[3], rej4[3];
+   __m512i cc = _mm512_setzero_si512();
+
+   lp_rast_tri_32_3_prepare(plane, x, y, c, dcdx, dcdy, rej4);
+
+   for (unsigned p = 0; p < 3; p++)
+      cc = _mm512_or_si512(cc, _mm512_add_epi32(_mm512_set1_epi32(c[p]),
+                                                lane_offsets(dcdx[p], dcdy[p])));
+
+   return _mm512_cmplt_epi32_mask(cc, _mm512_setzero_si512());
+}
+
+#endif /* DETECT_ARCH_X86_64 */
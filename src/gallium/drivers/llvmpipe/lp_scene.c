@@ -25,6 +25,9 @@
  *
  **************************************************************************/
 
+#include "util/detect_os.h"
+#include "util/list.h"
+#include "util/u_debug.h"
 #include "util/u_framebuffer.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
@@ -34,10 +37,16 @@
 #include "lp_scene.h"
 #include "lp_fence.h"
 #include "lp_debug.h"
+#include "lp_perf.h"
+#include "lp_screen.h"
 #include "lp_context.h"
 #include "lp_state_fs.h"
 #include "lp_setup_context.h"
 
+#if DETECT_OS_LINUX
+#include <sys/mman.h>
+#endif
+
 
 #define RESOURCE_REF_SZ 32
 /** List of resource references */
@@ -57,6 +66,197 @@ struct shader_ref {
 };
 
 
+/**
+ * Scene data blocks are carved out of 2MB chunks which are kept around for
+ * the following scenes instead of going back to the system every time, as
+ * many as the high-water mark of the recent scenes needs.  A chunk is
+ * aligned to its size and starts with its header, so the chunk of a block
+ * is found by rounding the block's address down.
+ */
+#define LP_SCENE_CHUNK_SIZE (2 * 1024 * 1024)
+#define LP_SCENE_CHUNK_HEADER 64
+
+struct lp_scene_chunk {
+   struct list_head link;
+   struct data_block *free_blocks;  /**< blocks returned to the chunk */
+   unsigned num_untouched;          /**< blocks never handed out so far */
+   unsigned num_free;               /**< free_blocks + num_untouched */
+};
+
+#define LP_SCENE_CHUNK_BLOCKS \
+   ((LP_SCENE_CHUNK_SIZE - LP_SCENE_CHUNK_HEADER) / sizeof(struct data_block))
+
+/** Number of scenes over which the high-water mark is taken */
+#define LP_SCENE_POOL_WINDOW 16
+
+struct lp_scene_pool {
+   mtx_t mutex;
+
+   /** Chunks with free blocks first, full ones at the end */
+   struct list_head chunks;
+   unsigned num_chunks;
+
+   unsigned blocks_in_use;
+   unsigned peak, prev_peak;  /**< blocks in use, current/previous window */
+   unsigned num_scenes;
+
+   bool huge_pages;
+};
+
+
+struct lp_scene_pool *
+lp_scene_pool_create(void)
+{
+   STATIC_ASSERT(sizeof(struct lp_scene_chunk) <= LP_SCENE_CHUNK_HEADER);
+
+   struct lp_scene_pool *pool = CALLOC_STRUCT(lp_scene_pool);
+   if (!pool)
+      return NULL;
+
+   (void) mtx_init(&pool->mutex, mtx_plain);
+   list_inithead(&pool->chunks);
+   pool->huge_pages = debug_get_bool_option("LP_SCENE_HUGEPAGES", true);
+
+   return pool;
+}
+
+
+void
+lp_scene_pool_destroy(struct lp_scene_pool *pool)
+{
+   assert(pool->blocks_in_use == 0);
+
+   list_for_each_entry_safe(struct lp_scene_chunk, chunk, &pool->chunks, link)
+      align_free(chunk);
+
+   mtx_destroy(&pool->mutex);
+   FREE(pool);
+}
+
+
+static struct lp_scene_chunk *
+lp_scene_pool_grow(struct lp_scene_pool *pool)
+{
+   struct lp_scene_chunk *chunk =
+      align_malloc(LP_SCENE_CHUNK_SIZE, LP_SCENE_CHUNK_SIZE);
+   if (!chunk)
+      return NULL;
+
+#if DETECT_OS_LINUX && defined(MADV_HUGEPAGE)
+   if (pool->huge_pages)
+      madvise(chunk, LP_SCENE_CHUNK_SIZE, MADV_HUGEPAGE);
+#endif
+
+   chunk->free_blocks = NULL;
+   chunk->num_untouched = LP_SCENE_CHUNK_BLOCKS;
+   chunk->num_free = LP_SCENE_CHUNK_BLOCKS;
+   list_add(&chunk->link, &pool->chunks);
+   pool->num_chunks++;
+
+   LP_COUNT(nr_scene_chunks);
+
+   return chunk;
+}
+
+
+static struct data_block *
+lp_scene_pool_get_block(struct lp_scene_pool *pool)
+{
+   struct lp_scene_chunk *chunk = NULL;
+   struct data_block *block;
+
+   mtx_lock(&pool->mutex);
+
+   if (!list_is_empty(&pool->chunks))
+      chunk = list_first_entry(&pool->chunks, struct lp_scene_chunk, link);
+
+   if (!chunk || !chunk->num_free) {
+      chunk = lp_scene_pool_grow(pool);
+      if (!chunk) {
+         mtx_unlock(&pool->mutex);
+         return NULL;
+      }
+   }
+
+   if (chunk->free_blocks) {
+      block = chunk->free_blocks;
+      chunk->free_blocks = block->next;
+      LP_COUNT(nr_scene_blocks_reused);
+   } else {
+      struct data_block *blocks = (struct data_block *)
+         ((uint8_t *)chunk + LP_SCENE_CHUNK_HEADER);
+      block = &blocks[LP_SCENE_CHUNK_BLOCKS - chunk->num_untouched--];
+   }
+
+   if (--chunk->num_free == 0) {
+      list_del(&chunk->link);
+      list_addtail(&chunk->link, &pool->chunks);
+   }
+
+   pool->blocks_in_use++;
+   pool->peak = MAX2(pool->peak, pool->blocks_in_use);
+   LP_COUNT(nr_scene_blocks);
+
+   mtx_unlock(&pool->mutex);
+
+   return block;
+}
+
+
+/**
+ * Return the blocks from block up to, but not including, end to the pool.
+ */
+static void
+lp_scene_pool_put_blocks_locked(struct lp_scene_pool *pool,
+                                struct data_block *block,
+                                const struct data_block *end)
+{
+   while (block != end) {
+      struct data_block *next = block->next;
+      struct lp_scene_chunk *chunk = (struct lp_scene_chunk *)
+         ((uintptr_t)block & ~(uintptr_t)(LP_SCENE_CHUNK_SIZE - 1));
+
+      block->next = chunk->free_blocks;
+      chunk->free_blocks = block;
+      if (chunk->num_free++ == 0)
+         list_move_to(&chunk->link, &pool->chunks);
+
+      pool->blocks_in_use--;
+      block = next;
+   }
+}
+
+
+/**
+ * Called once per scene, gives back the chunks the recent scenes didn't
+ * need.
+ */
+static void
+lp_scene_pool_trim_locked(struct lp_scene_pool *pool)
+{
+   if (++pool->num_scenes % LP_SCENE_POOL_WINDOW == 0) {
+      pool->prev_peak = pool->peak;
+      pool->peak = pool->blocks_in_use;
+   }
+
+   const unsigned keep = DIV_ROUND_UP(MAX2(pool->peak, pool->prev_peak),
+                                      LP_SCENE_CHUNK_BLOCKS);
+   if (pool->num_chunks <= keep)
+      return;
+
+   list_for_each_entry_safe(struct lp_scene_chunk, chunk, &pool->chunks, link) {
+      if (!chunk->num_free)
+         break;
+      if (chunk->num_free == LP_SCENE_CHUNK_BLOCKS) {
+         list_del(&chunk->link);
+         align_free(chunk);
+         if (--pool->num_chunks <= keep)
+            break;
+      }
+   }
+}
+
+
 /**
  * Create a new scene object.
  * \param queue  the queue to put newly rendered/emptied scenes into
@@ -72,6 +272,7 @@ lp_scene_create(struct lp_setup_context *setup)
    scene->pipe = setup->pipe;
    scene->setup = setup;
    scene->data.head = &scene->data.first;
+   scene->pool = llvmpipe_screen(setup->pipe->screen)->scene_pool;
 
    (void) mtx_init(&scene->mutex, mtx_plain);
 
@@ -302,17 +503,18 @@ lp_scene_end_rasterization(struct lp_scene *scene)
       }
    }
 
-   /* Free all scene data blocks:
+   /* Give all scene data blocks back to the pool:
     */
    {
       struct data_block_list *list = &scene->data;
-      struct data_block *block, *tmp;
 
-      for (block = list->head; block; block = tmp) {
-         tmp = block->next;
-         if (block != &list->first)
-            FREE(block);
-      }
+      LP_COUNT(nr_scenes);
+      LP_COUNT_ADD(scene_bytes, scene->scene_size);
+
+      mtx_lock(&scene->pool->mutex);
+      lp_scene_pool_put_blocks_locked(scene->pool, list->head, &list->first);
+      lp_scene_pool_trim_locked(scene->pool);
+      mtx_unlock(&scene->pool->mutex);
 
       list->head = &list->first;
       list->head->next = NULL;
@@ -363,7 +565,7 @@ lp_scene_new_data_block(struct lp_scene *scene)
       scene->alloc_failed = true;
       return NULL;
    } else {
-      struct data_block *block = MALLOC_STRUCT(data_block);
+      struct data_block *block = lp_scene_pool_get_block(scene->pool);
       if (!block)
          return NULL;
 
@@ -550,58 +752,50 @@ lp_scene_is_resource_referenced(const struct lp_scene *scene,
 }
 
 
-/** advance curr_x,y to the next bin */
-static bool
-next_bin(struct lp_scene *scene)
-{
-   scene->curr_x++;
-   if (scene->curr_x >= scene->tiles_x) {
-      scene->curr_x = 0;
-      scene->curr_y++;
-   }
-   if (scene->curr_y >= scene->tiles_y) {
-      /* no more bins */
-      return false;
-   }
-   return true;
-}
-
-
 void
-lp_scene_bin_iter_begin(struct lp_scene *scene)
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_domains)
 {
-   scene->curr_x = scene->curr_y = -1;
+   assert(num_domains >= 1 && num_domains <= LP_MAX_THREADS);
+
+   scene->num_bin_domains = num_domains;
+   for (unsigned d = 0; d < num_domains; d++)
+      scene->bin_next[d] = d;
 }
 
 
 /**
- * Return pointer to next bin to be rendered.
- * The lp_scene::curr_x and ::curr_y fields will be advanced.
+ * Return pointer to next bin to be rendered by a thread of the given L3
+ * domain.
+ * Tile y * tiles_x + x belongs to domain (y * tiles_x + x) % num_domains,
+ * which only depends on the framebuffer size, so a tile keeps being
+ * rendered next to the same L3 from scene to scene.  A domain which is
+ * done with its own tiles helps with the others' rather than idling.
  * Multiple rendering threads will call this function to get a chunk
  * of work (a bin) to work on.
  */
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene , int *x, int *y)
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned domain,
+                       int *x, int *y)
 {
+   const unsigned num_tiles = scene->tiles_x * scene->tiles_y;
+   const unsigned num_domains = scene->num_bin_domains;
    struct cmd_bin *bin = NULL;
 
    mtx_lock(&scene->mutex);
 
-   if (scene->curr_x < 0) {
-      /* first bin */
-      scene->curr_x = 0;
-      scene->curr_y = 0;
-   } else if (!next_bin(scene)) {
-      /* no more bins left */
-      goto end;
-   }
+   for (unsigned i = 0; i < num_domains; i++) {
+      const unsigned d = (domain + i) % num_domains;
+      const unsigned t = scene->bin_next[d];
 
-   bin = lp_scene_get_bin(scene, scene->curr_x, scene->curr_y);
-   *x = scene->curr_x;
-   *y = scene->curr_y;
+      if (t < num_tiles) {
+         scene->bin_next[d] = t + num_domains;
+         *x = t % scene->tiles_x;
+         *y = t / scene->tiles_x;
+         bin = lp_scene_get_bin(scene, *x, *y);
+         break;
+      }
+   }
 
-end:
-   /*printf("return bin %p at %d, %d\n", (void *) bin, *bin_x, *bin_y);*/
    mtx_unlock(&scene->mutex);
    return bin;
 }
@@ -679,3 +873,126 @@ lp_scene_end_binning(struct lp_scene *scene)
          lp_debug_bins(scene);
    }
 }
+
+
+/**
+ * Binner scenes.
+ *
+ * A binner thread bins its piece of a triangle batch into a private scene
+ * which has the same tile layout as the scene being built, and the context
+ * thread then appends the binner scenes to that scene in submission order.
+ * Binner scenes only ever hold bins and data blocks: state, resources and
+ * shaders are all stored in and referenced by the real scene.
+ *
+ * \param max_size  how much of the real scene's size budget the binner may
+ *                  use
+ */
+bool
+lp_scene_begin_binner(struct lp_scene *binner,
+                      const struct lp_scene *scene,
+                      unsigned max_size)
+{
+   unsigned num_required_tiles = scene->tiles_x * scene->tiles_y;
+   if (binner->num_alloced_tiles < num_required_tiles) {
+      struct cmd_bin *tiles = reallocarray(binner->tiles, num_required_tiles,
+                                           sizeof(struct cmd_bin));
+      if (!tiles)
+         return false;
+      memset(tiles, 0, sizeof(struct cmd_bin) * num_required_tiles);
+      binner->tiles = tiles;
+      binner->num_alloced_tiles = num_required_tiles;
+   }
+
+   binner->tiles_x = scene->tiles_x;
+   binner->tiles_y = scene->tiles_y;
+   binner->fb_max_layer = scene->fb_max_layer;
+   binner->fb_max_samples = scene->fb_max_samples;
+   memcpy(binner->fixed_sample_pos, scene->fixed_sample_pos,
+          sizeof(scene->fixed_sample_pos));
+   binner->had_queries = scene->had_queries;
+   binner->permit_linear_rasterizer = scene->permit_linear_rasterizer;
+
+   /* Only compared against by the whole-tile optimization, hence not
+    * referenced.
+    */
+   binner->fb.zsbuf = scene->fb.zsbuf;
+
+   binner->scene_size = LP_SCENE_MAX_SIZE - MIN2(max_size, LP_SCENE_MAX_SIZE);
+   binner->alloc_failed = false;
+
+   /* The binned data has to outlive the binner scene, so never hand out its
+    * embedded block.
+    */
+   binner->data.first.used = DATA_BLOCK_SIZE;
+
+   return true;
+}
+
+
+static void
+lp_scene_reset_binner(struct lp_scene *binner)
+{
+   memset(binner->tiles, 0,
+          sizeof(struct cmd_bin) * binner->tiles_x * binner->tiles_y);
+   binner->data.head = &binner->data.first;
+   binner->data.first.next = NULL;
+   binner->fb.zsbuf = NULL;
+   binner->scene_size = 0;
+}
+
+
+/**
+ * Move the bins and data of a binner scene to the end of the given scene.
+ */
+void
+lp_scene_append_binner(struct lp_scene *scene,
+                       struct lp_scene *binner)
+{
+   assert(binner->tiles_x == scene->tiles_x);
+   assert(binner->tiles_y == scene->tiles_y);
+
+   /* Keep the scene's current block at the head so it is still used for
+    * the following allocations.
+    */
+   struct data_block *block, *next;
+   for (block = binner->data.head; block != &binner->data.first;
+        block = next) {
+      next = block->next;
+      block->next = scene->data.head->next;
+      scene->data.head->next = block;
+      scene->scene_size += sizeof *block;
+   }
+
+   const unsigned num_bins = lp_scene_get_num_bins(scene);
+   for (unsigned i = 0; i < num_bins; i++) {
+      const struct cmd_bin *src = &binner->tiles[i];
+      struct cmd_bin *dst = &scene->tiles[i];
+
+      if (!src->head)
+         continue;
+
+      if (dst->tail)
+         dst->tail->next = src->head;
+      else
+         dst->head = src->head;
+      dst->tail = src->tail;
+      dst->last_state = src->last_state;
+   }
+
+   lp_scene_reset_binner(binner);
+}
+
+
+/**
+ * Throw away everything binned into a binner scene.
+ */
+void
+lp_scene_discard_binner(struct lp_scene *binner)
+{
+   mtx_lock(&binner->pool->mutex);
+   lp_scene_pool_put_blocks_locked(binner->pool, binner->data.head,
+                                   &binner->data.first);
+   mtx_unlock(&binner->pool->mutex);
+
+   lp_scene_reset_binner(binner);
+}
@@ -120,6 +120,9 @@ struct resource_ref;
 
 struct shader_ref;
 
+/** Recycled memory for scene data blocks, shared by a screen's scenes */
+struct lp_scene_pool;
+
 struct lp_scene_surface {
    uint8_t *map;
    unsigned stride;
@@ -197,16 +200,23 @@ struct lp_scene {
     */
    unsigned tiles_x, tiles_y;
 
-   int curr_x, curr_y;  /**< for iterating over bins */
+   /** For iterating over bins, see lp_scene_bin_iter_next() */
+   unsigned num_bin_domains;
+   unsigned bin_next[LP_MAX_THREADS];
    mtx_t mutex;
 
    unsigned num_alloced_tiles;
    struct cmd_bin *tiles;
    struct data_block_list data;
+   struct lp_scene_pool *pool;
 };
 
 
 
+struct lp_scene_pool *lp_scene_pool_create(void);
+
+void lp_scene_pool_destroy(struct lp_scene_pool *pool);
+
 struct lp_scene *lp_scene_create(struct lp_setup_context *setup);
 
 void lp_scene_destroy(struct lp_scene *scene);
@@ -398,10 +408,11 @@ lp_scene_get_num_bins(const struct lp_scene *scene)
 
 
 void
-lp_scene_bin_iter_begin(struct lp_scene *scene);
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_domains);
 
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene, int *x, int *y);
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned domain,
+                       int *x, int *y);
 
 
 
@@ -415,6 +426,21 @@ void
 lp_scene_end_binning(struct lp_scene *scene);
 
 
+/* Private scenes for the binner threads
+ */
+bool
+lp_scene_begin_binner(struct lp_scene *binner,
+                      const struct lp_scene *scene,
+                      unsigned max_size);
+
+void
+lp_scene_append_binner(struct lp_scene *scene,
+                       struct lp_scene *binner);
+
+void
+lp_scene_discard_binner(struct lp_scene *binner);
+
+
 /* Begin/end rasterization of a scene
  */
 void
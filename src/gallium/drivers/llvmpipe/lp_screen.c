@@ -54,6 +54,7 @@
 #include "lp_limits.h"
 #include "lp_rast.h"
 #include "lp_cs_tpool.h"
+#include "lp_scene.h"
 #include "lp_flush.h"
 
 #include "frontend/sw_winsys.h"
@@ -356,6 +357,8 @@ llvmpipe_init_screen_caps(struct pipe_screen *screen)
     * draw module's state, which is per-context.
     */
    caps->shareable_shaders = false;
+   /* Blend, DSA and rasterizer states are plain copies of the templates. */
+   caps->shareable_state_objects = true;
    caps->max_gs_invocations = 32;
    caps->max_shader_buffer_size = LP_MAX_TGSI_SHADER_BUFFER_SIZE;
    caps->framebuffer_no_attachment = true;
@@ -731,11 +734,16 @@ llvmpipe_destroy_screen(struct pipe_screen *_screen)
    if (screen->cs_tpool)
       lp_cs_tpool_destroy(screen->cs_tpool);
 
+   if (screen->bin_tpool)
+      lp_cs_tpool_destroy(screen->bin_tpool);
+
    if (screen->rast)
       lp_rast_destroy(screen->rast);
 
    lp_jit_screen_cleanup(screen);
 
+   lp_scene_pool_destroy(screen->scene_pool);
+
    disk_cache_destroy(screen->disk_shader_cache);
 
    glsl_type_singleton_decref();
@@ -915,6 +923,10 @@ llvmpipe_screen_late_init(struct llvmpipe_screen *screen)
       goto out;
    }
 
+   /* Binning just stays on the context thread if this fails. */
+   if (screen->num_bin_threads)
+      screen->bin_tpool = lp_cs_tpool_create(screen->num_bin_threads);
+
    if (!lp_jit_screen_init(screen)) {
       ret = false;
       goto out;
@@ -948,6 +960,12 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
    if (!screen)
       return NULL;
 
+   screen->scene_pool = lp_scene_pool_create();
+   if (!screen->scene_pool) {
+      FREE(screen);
+      return NULL;
+   }
+
    screen->winsys = winsys;
 
    screen->base.destroy = llvmpipe_destroy_screen;
@@ -982,6 +1000,8 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
    screen->num_threads = debug_get_num_option("LP_NUM_THREADS",
                                               screen->num_threads);
    screen->num_threads = MIN2(screen->num_threads, LP_MAX_THREADS);
+   screen->num_bin_threads = debug_get_num_option("LP_NUM_BIN_THREADS", 0);
+   screen->num_bin_threads = MIN2(screen->num_bin_threads, LP_MAX_BIN_JOBS - 1);
 
 #if defined(HAVE_LIBDRM) && defined(HAVE_LINUX_UDMABUF_H)
    screen->udmabuf_fd = open("/dev/udmabuf", O_RDWR);
@@ -44,6 +44,7 @@
 
 struct sw_winsys;
 struct lp_cs_tpool;
+struct lp_scene_pool;
 
 struct llvmpipe_screen
 {
@@ -63,6 +64,13 @@ struct llvmpipe_screen
    struct lp_cs_tpool *cs_tpool;
    mtx_t cs_mutex;
 
+   /* Memory for the scene data blocks of all contexts */
+   struct lp_scene_pool *scene_pool;
+
+   /* Extra threads used for binning triangles, see lp_setup_vbuf.c */
+   unsigned num_bin_threads;
+   struct lp_cs_tpool *bin_tpool;
+
    bool allow_cl;
 
    mtx_t late_mutex;
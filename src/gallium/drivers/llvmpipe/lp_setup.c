@@ -1311,6 +1311,11 @@ lp_setup_destroy(struct lp_setup_context *setup)
       lp_scene_destroy(scene);
    }
 
+   for (unsigned i = 0; i < setup->num_bin_jobs; i++) {
+      lp_scene_destroy(setup->bin_jobs[i].scene);
+      FREE(setup->bin_jobs[i].setup);
+   }
+
    LP_DBG(DEBUG_SETUP, "number of scenes used: %d\n", setup->num_active_scenes);
    slab_destroy(&setup->scene_slab);
 
@@ -37,9 +37,20 @@
 #include "util/u_math.h"
 #include "lp_state_fs.h"
 #include "lp_state_setup.h"
+#include "lp_debug.h"
 #include "lp_perf.h"
 
 
+/* Report why the triangles couldn't be turned into rectangles, which is
+ * what keeps them off the linear path.
+ */
+#define REJECT(s) do {                                  \
+      if (LP_DEBUG & DEBUG_LINEAR)                      \
+         debug_printf("  -- %s: %s\n", __func__, s);    \
+      return false;                                     \
+} while (0)
+
+
 /**
  * Duplicated from lp_setup_vbuf.c.
  */
@@ -249,15 +260,15 @@ check_elts24(struct lp_setup_context *setup, const void *vb, int stride)
    int i;
 
    if (stride != 32)
-      return false;
+      REJECT("unexpected vertex stride");
 
    /* Check the shape is two rectangles:
     */
    if (!test_rect(v12, v2, v1, v18))
-      return false;
+      REJECT("outer shape not a rectangle");
 
    if (!test_rect(v6, v0, v3, v9))
-      return false;
+      REJECT("inner shape not a rectangle");
 
    /* XXX: check one rect is inside the other?
     */
@@ -268,7 +279,7 @@ check_elts24(struct lp_setup_context *setup, const void *vb, int stride)
       if (memcmp(get_vert(vb, i, stride),
                  get_vert(vb, elts[i], stride),
                  6 * sizeof(float)) != 0)
-         return false;
+         REJECT("unexpected tessellation");
    }
 
    /* Test that this is a stretch blit, meaning we should be able to
@@ -280,7 +291,7 @@ check_elts24(struct lp_setup_context *setup, const void *vb, int stride)
    for (i = 0; i < ARRAY_SIZE(uniq); i++) {
       const_float4_ptr v = get_vert(vb, stride, i);
       if (!test_interps(v, as, bs, at, bt))
-         return false;
+         REJECT("not a stretch blit");
    }
 
    make_vert(v18, v9, vA);
@@ -383,16 +394,23 @@ lp_setup_analyse_triangles(struct lp_setup_context *setup,
     * luckily easy to compute.
     */
    if (nr == 27 &&
-       variant_blit &&
-       setup->setup.variant->key.inputs[0].src_index == 1 &&
-       setup->setup.variant->key.inputs[0].usage_mask == 0x3 &&
        is_zero_area(get_vert(vb, nr-1, stride),
                     get_vert(vb, nr-2, stride),
-                    get_vert(vb, nr-3, stride)) &&
-       check_elts24(setup, vb, stride))
+                    get_vert(vb, nr-3, stride)))
    {
-      return true;
+      if (!variant_blit)
+         REJECT("window border without a blit shader");
+
+      if (setup->setup.variant->key.inputs[0].src_index != 1 ||
+          setup->setup.variant->key.inputs[0].usage_mask != 0x3)
+         REJECT("window border with unexpected texcoords");
+
+      return check_elts24(setup, vb, stride);
    }
 
+   if (LP_DEBUG & DEBUG_LINEAR)
+      debug_printf("  -- %s: %d triangles not decomposable into rects\n",
+                   __func__, nr / 3);
+
    return false;
 }
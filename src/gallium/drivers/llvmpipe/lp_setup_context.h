@@ -61,6 +61,21 @@ struct lp_setup_variant;
 
 
 
+/**
+ * A piece of a triangle batch binned by one of the binner threads, or by
+ * the context thread itself, see lp_setup_vbuf.c.
+ */
+struct lp_setup_bin_job {
+   struct lp_setup_context *setup;  /**< private copy binning into scene */
+   struct lp_scene *scene;          /**< private binner scene */
+   const void *vertex_buffer;
+   const uint16_t *indices;         /**< NULL for non-indexed draws */
+   unsigned stride;
+   unsigned start, end;             /**< range of vertices to bin */
+   unsigned binned;                 /**< end of what fit into the scene */
+};
+
+
 /**
  * Point/line/triangle setup context.
  * Note: "stored" below indicates data which is stored in the bins,
@@ -99,6 +114,11 @@ struct lp_setup_context
    struct llvmpipe_query *active_queries[LP_MAX_ACTIVE_BINNED_QUERIES];
    unsigned active_binned_queries;
 
+   /** Set in the copies of the context used by the binner threads */
+   bool in_binner;
+   unsigned num_bin_jobs;
+   struct lp_setup_bin_job bin_jobs[LP_MAX_BIN_JOBS];
+
    unsigned flatshade_first:1;
    unsigned ccw_is_frontface:1;
    unsigned scissor_test:1;
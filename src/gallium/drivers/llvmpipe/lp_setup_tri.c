@@ -1018,6 +1018,14 @@ retry_triangle_ccw(struct lp_setup_context *setup,
    }
 
    if (!do_triangle_ccw(setup, position, v0, v1, v2, front)) {
+      /* Binner threads can't flush the scene, the context thread will
+       * bin this triangle again once it's done merging their results.
+       */
+      if (setup->in_binner) {
+         setup->scene->alloc_failed = true;
+         return;
+      }
+
       if (!lp_setup_flush_and_restart(setup))
          return;
 
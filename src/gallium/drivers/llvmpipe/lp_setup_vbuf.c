@@ -44,6 +44,8 @@
 #include "util/u_math.h"
 #include "lp_state_fs.h"
 #include "lp_perf.h"
+#include "lp_screen.h"
+#include "lp_cs_tpool.h"
 
 
 /* It should be a multiple of both 6 and 4 (in other words, a multiple of 12)
@@ -53,6 +55,10 @@
 
 #define LP_MAX_VBUF_SIZE    4096
 
+/* Don't bother the binner threads with less than this many triangles each.
+ */
+#define LP_MIN_BIN_TRIANGLES 64
+
 
 
 /** cast wrapper */
@@ -165,6 +171,152 @@ rect(struct lp_setup_context *setup,
 }
 
 
+static inline const_float4_ptr
+get_job_vert(const struct lp_setup_bin_job *job, unsigned i)
+{
+   return get_vert(job->vertex_buffer, job->indices ? job->indices[i] : i,
+                   job->stride);
+}
+
+
+static void
+bin_triangles_job(struct lp_setup_bin_job *job)
+{
+   struct lp_setup_context *setup = job->setup;
+   unsigned i;
+
+   for (i = job->start; i + 2 < job->end; i += 3) {
+      setup->triangle(setup,
+                      get_job_vert(job, i),
+                      get_job_vert(job, i + 1),
+                      get_job_vert(job, i + 2));
+      if (lp_scene_is_oom(setup->scene))
+         break;
+   }
+
+   job->binned = i;
+}
+
+
+static void
+bin_triangles_task(void *data, int iter_idx, struct lp_cs_local_mem *lmem)
+{
+   struct lp_setup_context *setup = data;
+   bin_triangles_job(&setup->bin_jobs[iter_idx + 1]);
+}
+
+
+/**
+ * Bin a triangle list on the context thread and the binner threads.
+ *
+ * The batch is split into contiguous pieces which are each binned into a
+ * private scene using a copy of the setup context, so the binner threads
+ * never touch the scene being built.  The private scenes are then appended
+ * to it in submission order, which keeps the command order in every bin the
+ * same as when binning serially.  Whatever didn't fit into a binner scene's
+ * share of the scene budget is binned serially afterwards, flushing the
+ * scene as usual.
+ *
+ * \return false if the batch wasn't binned at all
+ */
+static bool
+bin_triangles_parallel(struct lp_setup_context *setup,
+                       const void *vertex_buffer, unsigned stride,
+                       const uint16_t *indices, unsigned nr)
+{
+   struct llvmpipe_screen *screen = llvmpipe_screen(setup->pipe->screen);
+   struct lp_cs_tpool *pool = screen->bin_tpool;
+
+   /* The rectangle paths aren't split, and the binner threads would race
+    * on the primitive counters.
+    */
+   if (!pool || !pool->num_threads || setup->permit_linear_rasterizer ||
+       llvmpipe_context(setup->pipe)->active_statistics_queries)
+      return false;
+
+   const unsigned num_tris = nr / 3;
+   const unsigned num_jobs = MIN2(screen->num_bin_threads + 1,
+                                  num_tris / LP_MIN_BIN_TRIANGLES);
+   if (num_jobs < 2)
+      return false;
+
+   struct lp_scene *scene = setup->scene;
+   const unsigned max_size = (LP_SCENE_MAX_SIZE - scene->scene_size) / num_jobs;
+   if (max_size < 2 * sizeof(struct data_block))
+      return false;
+
+   for (; setup->num_bin_jobs < num_jobs; setup->num_bin_jobs++) {
+      struct lp_setup_bin_job *job = &setup->bin_jobs[setup->num_bin_jobs];
+
+      job->setup = MALLOC_STRUCT(lp_setup_context);
+      job->scene = lp_scene_create(setup);
+      if (!job->setup || !job->scene) {
+         FREE(job->setup);
+         if (job->scene)
+            lp_scene_destroy(job->scene);
+         memset(job, 0, sizeof(*job));
+         return false;
+      }
+   }
+
+   /* Pick the triangle function now rather than in every copy. */
+   lp_setup_choose_triangle(setup);
+
+   const unsigned tris_per_job = DIV_ROUND_UP(num_tris, num_jobs);
+
+   for (unsigned j = 0; j < num_jobs; j++) {
+      struct lp_setup_bin_job *job = &setup->bin_jobs[j];
+
+      if (!lp_scene_begin_binner(job->scene, scene, max_size)) {
+         while (j--)
+            lp_scene_discard_binner(setup->bin_jobs[j].scene);
+         return false;
+      }
+
+      memcpy(job->setup, setup, sizeof(*setup));
+      job->setup->scene = job->scene;
+      job->setup->in_binner = true;
+
+      job->vertex_buffer = vertex_buffer;
+      job->indices = indices;
+      job->stride = stride;
+      job->start = MIN2(j * tris_per_job, num_tris) * 3;
+      job->end = MIN2((j + 1) * tris_per_job, num_tris) * 3;
+      job->binned = job->start;
+   }
+
+   struct lp_cs_tpool_task *task =
+      lp_cs_tpool_queue_task(pool, bin_triangles_task, setup, num_jobs - 1);
+   if (task)
+      bin_triangles_job(&setup->bin_jobs[0]);
+   lp_cs_tpool_wait_for_task(pool, &task);
+
+   unsigned resume = nr;
+   for (unsigned j = 0; j < num_jobs; j++) {
+      struct lp_setup_bin_job *job = &setup->bin_jobs[j];
+
+      if (resume < nr || job->binned == job->start) {
+         lp_scene_discard_binner(job->scene);
+         resume = MIN2(resume, job->start);
+         continue;
+      }
+
+      lp_scene_append_binner(scene, job->scene);
+      if (job->binned < job->end)
+         resume = job->binned;
+   }
+
+   for (unsigned i = resume; i + 2 < nr; i += 3) {
+      setup->triangle(setup,
+                      get_vert(vertex_buffer, indices ? indices[i] : i, stride),
+                      get_vert(vertex_buffer, indices ? indices[i + 1] : i + 1, stride),
+                      get_vert(vertex_buffer, indices ? indices[i + 2] : i + 2, stride));
+   }
+
+   return true;
+}
+
+
 /**
  * draw elements / indexed primitives
  */
@@ -223,7 +375,9 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const uint16_t *indices, uint nr
       break;
 
    case MESA_PRIM_TRIANGLES:
-      if (nr % 6 == 0 && !uses_constant_interp) {
+      if (bin_triangles_parallel(setup, vertex_buffer, stride, indices, nr)) {
+         /* Binned on the binner threads. */
+      } else if (nr % 6 == 0 && !uses_constant_interp) {
          for (i = 5; i < nr; i += 6) {
             rect(setup,
                  get_vert(vertex_buffer, indices[i-5], stride),
@@ -431,7 +585,9 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
       break;
 
    case MESA_PRIM_TRIANGLES:
-      if (nr % 6 == 0 && !uses_constant_interp) {
+      if (bin_triangles_parallel(setup, vertex_buffer, stride, NULL, nr)) {
+         /* Binned on the binner threads. */
+      } else if (nr % 6 == 0 && !uses_constant_interp) {
          for (i = 5; i < nr; i += 6) {
             rect(setup,
                  get_vert(vertex_buffer, i-5, stride),
@@ -27,6 +27,7 @@
 
 #include "util/u_math.h"
 #include "util/u_memory.h"
+#include "util/u_cpu_section.h"
 #include "pipe/p_shader_tokens.h"
 #include "draw/draw_context.h"
 #include "draw/draw_vertex.h"
@@ -274,6 +275,7 @@ void
 llvmpipe_update_derived(struct llvmpipe_context *llvmpipe)
 {
    struct llvmpipe_screen *lp_screen = llvmpipe_screen(llvmpipe->pipe.screen);
+   int64_t section_begin = util_cpu_section_begin();
 
    /* Check for updated textures.
     */
@@ -384,4 +386,6 @@ llvmpipe_update_derived(struct llvmpipe_context *llvmpipe)
    llvmpipe_update_derived_clear(llvmpipe);
 
    llvmpipe->dirty = 0;
+
+   util_cpu_section_end(UTIL_CPU_SECTION_STATE_UPDATE, section_begin);
 }
@@ -62,6 +62,7 @@
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 #include "util/u_pointer.h"
+#include "util/u_cpu_section.h"
 #include "util/format/u_format.h"
 #include "util/u_dump.h"
 #include "util/u_string.h"
@@ -3759,6 +3760,31 @@ lp_fs_get_ir_cache_key(struct lp_fragment_shader_variant *variant,
 }
 
 
+/**
+ * Return why the pipeline state rules out the linear path for this
+ * shader, or NULL if it doesn't.
+ */
+static const char *
+linear_pipeline_reject_reason(const struct lp_fragment_shader_variant_key *key,
+                              const struct nir_shader *nir)
+{
+   if (key->stencil[0].enabled)
+      return "stencil test";
+   if (key->depth.enabled)
+      return "depth test";
+   if (nir->info.fs.uses_discard)
+      return "shader uses discard";
+   if (key->blend.logicop_enable)
+      return "logicop";
+   if (key->cbuf_format[0] != PIPE_FORMAT_B8G8R8A8_UNORM &&
+       key->cbuf_format[0] != PIPE_FORMAT_B8G8R8X8_UNORM &&
+       key->cbuf_format[0] != PIPE_FORMAT_R8G8B8A8_UNORM &&
+       key->cbuf_format[0] != PIPE_FORMAT_R8G8B8X8_UNORM)
+      return "color buffer format";
+   return NULL;
+}
+
+
 /**
  * Generate a new fragment shader variant from the shader code and
  * other state indicated by the key.
@@ -3894,15 +3920,8 @@ generate_variant(struct llvmpipe_context *lp,
    /* Determine whether this shader + pipeline state is a candidate for
     * the linear path.
     */
-   const bool linear_pipeline =
-         !key->stencil[0].enabled &&
-         !key->depth.enabled &&
-         !nir->info.fs.uses_discard &&
-         !key->blend.logicop_enable &&
-         (key->cbuf_format[0] == PIPE_FORMAT_B8G8R8A8_UNORM ||
-          key->cbuf_format[0] == PIPE_FORMAT_B8G8R8X8_UNORM ||
-          key->cbuf_format[0] == PIPE_FORMAT_R8G8B8A8_UNORM ||
-          key->cbuf_format[0] == PIPE_FORMAT_R8G8B8X8_UNORM);
+   const char *linear_reject = linear_pipeline_reject_reason(key, nir);
+   const bool linear_pipeline = linear_reject == NULL;
 
    memcpy(&variant->key, key, sizeof *key);
 
@@ -3945,11 +3964,14 @@ generate_variant(struct llvmpipe_context *lp,
              shader->kind == LP_FS_KIND_BLIT_RGB1 ||
              shader->kind == LP_FS_KIND_LLVM_LINEAR) {
             llvmpipe_fs_variant_linear_llvm(lp, shader, variant);
+         } else if (LP_DEBUG & DEBUG_LINEAR) {
+            debug_printf("  -- shader not linear compatible\n");
          }
       }
    } else {
       if (LP_DEBUG & DEBUG_LINEAR) {
          lp_debug_fs_variant(variant);
+         debug_printf("  -- %s\n", linear_reject);
          debug_printf("    ----> no linear path for this variant\n");
       }
    }
@@ -4684,6 +4706,7 @@ void
 llvmpipe_update_fs(struct llvmpipe_context *lp)
 {
    struct lp_fragment_shader *shader = lp->fs;
+   int64_t section_begin = util_cpu_section_begin();
 
    char store[LP_FS_MAX_VARIANT_KEY_SIZE];
    const struct lp_fragment_shader_variant_key *key =
@@ -4775,6 +4798,8 @@ llvmpipe_update_fs(struct llvmpipe_context *lp)
       }
    }
 
+   util_cpu_section_end(UTIL_CPU_SECTION_SHADER_VARIANT, section_begin);
+
    /* Bind this variant */
    lp_setup_set_fs_variant(lp->setup, variant);
 }
@@ -30,6 +30,7 @@
 #include "util/u_math.h"
 #include "lp_debug.h"
 #include "lp_state.h"
+#include "gallivm/lp_bld_nir.h"
 #include "nir.h"
 
 /*
@@ -202,6 +203,63 @@ check_load_const_in_zero_one(const nir_load_const_instr *load)
 }
 
 
+/*
+ * Check that the sources of an arithmetic instruction are known to be in
+ * [0,1], ie. they are not FS inputs and immediates are in range.
+ */
+static bool
+check_alu_srcs_in_zero_one(const nir_alu_instr *alu)
+{
+   unsigned num_src = nir_op_infos[alu->op].num_inputs;
+   for (unsigned s = 0; s < num_src; s++) {
+      if (nir_src_is_const(alu->src[s].src)) {
+         nir_load_const_instr *load =
+            nir_instr_as_load_const(alu->src[s].src.ssa->parent_instr);
+         if (!check_load_const_in_zero_one(load)) {
+            return false;
+         }
+      } else if (is_fs_input(&alu->src[s].src)) {
+         /* we don't know if the fs inputs are in [0,1] */
+         return false;
+      }
+   }
+   return true;
+}
+
+
+/*
+ * Check if the value only ends up in the FS output, possibly through
+ * movs and vecs.  The saturating unorm8 arithmetic of the linear path
+ * matches the float result clamped to [0,1] there.
+ */
+static bool
+only_reaches_output(nir_def *def)
+{
+   nir_foreach_use_including_if(src, def) {
+      if (nir_src_is_if(src))
+         return false;
+
+      const nir_instr *use = nir_src_parent_instr(src);
+      if (use->type == nir_instr_type_intrinsic &&
+          nir_instr_as_intrinsic(use)->intrinsic == nir_intrinsic_store_deref)
+         continue;
+
+      if (use->type != nir_instr_type_alu)
+         return false;
+
+      nir_alu_instr *alu = nir_instr_as_alu(use);
+      if (alu->op != nir_op_mov &&
+          alu->op != nir_op_vec2 &&
+          alu->op != nir_op_vec4)
+         return false;
+
+      if (!only_reaches_output(&alu->def))
+         return false;
+   }
+   return true;
+}
+
+
 /*
  * Examine the NIR shader to determine if it's "linear".
  * For the linear path, we're optimizing the case of rendering a window-
@@ -318,32 +376,27 @@ llvmpipe_nir_fn_is_linear_compat(const struct nir_shader *shader,
             break;
          }
          case nir_instr_type_alu: {
-            const nir_alu_instr *alu = nir_instr_as_alu(instr);
+            nir_alu_instr *alu = nir_instr_as_alu(instr);
             switch (alu->op) {
             case nir_op_mov:
             case nir_op_vec2:
             case nir_op_vec4:
                // these instructions are OK
                break;
-            case nir_op_fmul: {
-               unsigned num_src = nir_op_infos[alu->op].num_inputs;;
-               for (unsigned s = 0; s < num_src; s++) {
-                  /* If the MUL uses immediate values, the values must
-                   * be 32-bit floats in the range [0,1].
-                   */
-                  if (nir_src_is_const(alu->src[s].src)) {
-                     nir_load_const_instr *load =
-                        nir_instr_as_load_const(alu->src[s].src.ssa->parent_instr);
-                     if (!check_load_const_in_zero_one(load)) {
-                        return false;
-                     }
-                  } else if (is_fs_input(&alu->src[s].src)) {
-                     /* we don't know if the fs inputs are in [0,1] */
-                     return false;
-                  }
-               }
+            case nir_op_fmul:
+            case nir_op_flrp:
+               /* Products and lerps of values in [0,1] stay in [0,1]. */
+               if (!check_alu_srcs_in_zero_one(alu))
+                  return false;
+               break;
+            case nir_op_fadd:
+               /* Sums may exceed 1.0, which is only fine if nothing but
+                * the final clamp to the color buffer sees them.
+                */
+               if (!check_alu_srcs_in_zero_one(alu) ||
+                   !only_reaches_output(&alu->def))
+                  return false;
                break;
-            }
             default:
                // disallowed instruction
                return false;
@@ -372,13 +425,23 @@ llvmpipe_nir_is_linear_compat(struct nir_shader *shader,
        (shader->info.outputs_written & ~BITFIELD64_BIT(FRAG_RESULT_DATA0)))
       return false;
 
+   /* Look at the shader the way the AoS code generator will see it, with
+    * lowered lerps folded back into flrp.
+    */
+   nir_shader *clone = nir_shader_clone(NULL, shader);
+   lp_build_nir_aos_prepasses(clone);
+
+   bool linear = true;
    info->num_texs = 0;
-   nir_foreach_function_impl(impl, shader) {
-      if (!llvmpipe_nir_fn_is_linear_compat(shader, impl, info))
-         return false;
+   nir_foreach_function_impl(impl, clone) {
+      if (!llvmpipe_nir_fn_is_linear_compat(clone, impl, info)) {
+         linear = false;
+         break;
+      }
    }
    info->num_texs = num_tex;
-   return true;
+   ralloc_free(clone);
+   return linear;
 }
 
 
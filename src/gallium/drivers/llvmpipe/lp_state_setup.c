@@ -29,6 +29,7 @@
 #include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
+#include "util/mesa-sha1.h"
 #include "gallivm/lp_bld_arit.h"
 #include "gallivm/lp_bld_bitarit.h"
 #include "gallivm/lp_bld_const.h"
@@ -628,6 +629,24 @@ init_args(struct gallivm_state *gallivm,
 }
 
 
+static void
+lp_setup_get_ir_cache_key(const struct lp_setup_variant_key *key,
+                          unsigned char ir_sha1_cache_key[20])
+{
+   /* The key fully determines the generated code, the build and the CPU
+    * are already part of the disk cache id.
+    */
+   static const char setup_function_base_hash[] = "llvmpipe setup";
+
+   struct mesa_sha1 ctx;
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, setup_function_base_hash,
+                     sizeof(setup_function_base_hash));
+   _mesa_sha1_update(&ctx, key, key->size);
+   _mesa_sha1_final(&ctx, ir_sha1_cache_key);
+}
+
+
 /**
  * Generate the runtime callable function for the coefficient calculation.
  *
@@ -636,6 +655,9 @@ static struct lp_setup_variant *
 generate_setup_variant(struct lp_setup_variant_key *key,
                        struct llvmpipe_context *lp)
 {
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[20];
    int64_t t0 = 0, t1;
 
    if (0)
@@ -647,12 +669,21 @@ generate_setup_variant(struct lp_setup_variant_key *key,
 
    variant->no = setup_no++;
 
-   char func_name[64];
-   snprintf(func_name, sizeof(func_name), "setup_variant_%u",
-            variant->no);
+   lp_setup_get_ir_cache_key(key, ir_sha1_cache_key);
+   lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
+   char module_name[64];
+   snprintf(module_name, sizeof(module_name), "setup%u", variant->no);
+
+   /* The function name ends up in the cached object, so it must not depend
+    * on the variant number.  Each module has its own symbol namespace.
+    */
+   const char *func_name = "setup_variant";
 
    struct gallivm_state *gallivm;
-   variant->gallivm = gallivm = gallivm_create(func_name, &lp->context, NULL);
+   variant->gallivm = gallivm = gallivm_create(module_name, &lp->context,
+                                               &cached);
    if (!variant->gallivm) {
       goto fail;
    }
@@ -740,6 +771,9 @@ generate_setup_variant(struct lp_setup_variant_key *key,
    if (!variant->jit_function)
       goto fail;
 
+   if (needs_caching)
+      lp_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
+
    gallivm_free_ir(variant->gallivm);
 
    /*
@@ -0,0 +1,221 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Checks the accuracy of the half precision bilinear filter used for half
+ * float textures against a double precision reference.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util/half_float.h"
+#include "util/u_memory.h"
+#include "util/u_math.h"
+
+#include "gallivm/lp_bld.h"
+#include "gallivm/lp_bld_init.h"
+#include "gallivm/lp_bld_limits.h"
+#include "gallivm/lp_bld_sample.h"
+#include "gallivm/lp_bld_type.h"
+
+#include "lp_test.h"
+
+
+#define NUM_VALUES 4096
+
+
+typedef void (*filter_func_t)(float *out, const float *in);
+
+
+void
+write_tsv_header(FILE *fp)
+{
+   fprintf(fp,
+           "result\t"
+           "length\n");
+
+   fflush(fp);
+}
+
+
+/*
+ * in holds six vectors: the s and t weights followed by the four texels.
+ */
+static LLVMValueRef
+build_filter_func(struct gallivm_state *gallivm, unsigned length,
+                  const char *name)
+{
+   struct lp_type type = lp_type_float_vec(32, length * 32);
+   LLVMContextRef context = gallivm->context;
+   LLVMBuilderRef builder = gallivm->builder;
+   LLVMTypeRef vec_type = lp_build_vec_type(gallivm, type);
+   LLVMTypeRef args[2] = { LLVMPointerType(vec_type, 0),
+                           LLVMPointerType(vec_type, 0) };
+   LLVMValueRef func = LLVMAddFunction(gallivm->module, name,
+                                       LLVMFunctionType(LLVMVoidTypeInContext(context),
+                                                        args, ARRAY_SIZE(args), 0));
+   LLVMBasicBlockRef block = LLVMAppendBasicBlockInContext(context, func, "entry");
+   LLVMValueRef in[6], res;
+   struct lp_build_context bld;
+
+   lp_build_context_init(&bld, gallivm, type);
+
+   LLVMSetFunctionCallConv(func, LLVMCCallConv);
+   LLVMPositionBuilderAtEnd(builder, block);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(in); i++) {
+      LLVMValueRef index = LLVMConstInt(LLVMInt32TypeInContext(context), i, 0);
+      LLVMValueRef ptr = LLVMBuildGEP2(builder, vec_type, LLVMGetParam(func, 1),
+                                       &index, 1, "");
+      in[i] = LLVMBuildLoad2(builder, vec_type, ptr, "");
+   }
+
+   lp_build_half_filter_2d(&bld, 1, in[0], in[1],
+                           &in[2], &in[3], &in[4], &in[5], &res);
+
+   LLVMBuildStore(builder, res, LLVMGetParam(func, 0));
+   LLVMBuildRetVoid(builder);
+
+   gallivm_verify_function(gallivm, func);
+
+   return func;
+}
+
+
+static float
+random_half(float range)
+{
+   float f = (float)rand() / RAND_MAX * 2.0f * range - range;
+
+   return _mesa_half_to_float(_mesa_float_to_half(f));
+}
+
+
+static bool
+test_filter(unsigned verbose, FILE *fp, unsigned length, unsigned num_values)
+{
+   char name[64];
+   lp_context_ref context;
+   struct gallivm_state *gallivm;
+   LLVMValueRef func;
+   filter_func_t filter;
+   float *in, *out;
+   bool success = true;
+
+   snprintf(name, sizeof name, "half_filter.v%u", length);
+
+   in = align_malloc(6 * length * sizeof(float), length * sizeof(float));
+   out = align_malloc(length * sizeof(float), length * sizeof(float));
+
+   lp_context_create(&context);
+   gallivm = gallivm_create("test_module", &context, NULL);
+
+   func = build_filter_func(gallivm, length, name);
+
+   gallivm_compile_module(gallivm);
+
+   filter = (filter_func_t) gallivm_jit_function(gallivm, func, name);
+
+   gallivm_free_ir(gallivm);
+
+   for (unsigned n = 0; n < num_values; n += length) {
+      for (unsigned i = 0; i < length; i++) {
+         in[0 * length + i] = (float)rand() / RAND_MAX;
+         in[1 * length + i] = (float)rand() / RAND_MAX;
+         for (unsigned v = 2; v < 6; v++)
+            in[v * length + i] = random_half((n / length) & 1 ? 1.0f : 1000.0f);
+      }
+
+      filter(out, in);
+
+      for (unsigned i = 0; i < length; i++) {
+         double s = in[0 * length + i], t = in[1 * length + i];
+         double v00 = in[2 * length + i], v01 = in[3 * length + i];
+         double v10 = in[4 * length + i], v11 = in[5 * length + i];
+         double v0 = v00 + s * (v01 - v00);
+         double v1 = v10 + s * (v11 - v10);
+         double ref = v0 + t * (v1 - v0);
+         double max = MAX2(MAX2(fabs(v00), fabs(v01)), MAX2(fabs(v10), fabs(v11)));
+
+         /*
+          * Each of the three lerps rounds to a half ulp of its result and the
+          * weights themselves are rounded to 11 bits, so allow 4 ulps of the
+          * largest texel.
+          */
+         bool pass = fabs(out[i] - ref) <= 4.0 * max / 2048.0;
+
+         if (!pass || verbose >= 2) {
+            printf("%s(%g, %g, %g, %g, s = %g, t = %g): ref = %g, out = %g, %s\n",
+                   name, v00, v01, v10, v11, s, t, ref, out[i],
+                   pass ? "PASS" : "FAIL");
+            fflush(stdout);
+         }
+
+         if (!pass)
+            success = false;
+      }
+   }
+
+   if (fp) {
+      fprintf(fp, "%s\t%u\n", success ? "pass" : "fail", length);
+      fflush(fp);
+   }
+
+   gallivm_destroy(gallivm);
+   lp_context_destroy(&context);
+
+   align_free(in);
+   align_free(out);
+
+   return success;
+}
+
+
+static bool
+test_lengths(unsigned verbose, FILE *fp, unsigned num_values)
+{
+   bool success = true;
+
+   /*
+    * Without f16c (or aarch64) LLVM cannot lower half arithmetic at all,
+    * see lp_build_half_to_float().  Where it can but lp_has_fp16_arith() is
+    * false the operations are promoted to float, which still gives the
+    * same results.
+    */
+   if (!lp_has_fp16())
+      return true;
+
+   for (unsigned length = 4; length <= lp_native_vector_width / 32; length *= 2) {
+      if (!test_filter(verbose, fp, length, num_values))
+         success = false;
+   }
+
+   return success;
+}
+
+
+bool
+test_all(unsigned verbose, FILE *fp)
+{
+   return test_lengths(verbose, fp, NUM_VALUES);
+}
+
+
+bool
+test_some(unsigned verbose, FILE *fp,
+          unsigned long n)
+{
+   return test_lengths(verbose, fp, MAX2(n, 1));
+}
+
+
+bool
+test_single(unsigned verbose, FILE *fp)
+{
+   return test_lengths(verbose, fp, 1);
+}
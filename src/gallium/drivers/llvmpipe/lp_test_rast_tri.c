@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Checks the AVX2 / AVX-512 triangle coverage kernels against the SSE2
+ * ones on random planes and reports how many triangles per second each of
+ * them evaluates.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "util/detect_arch.h"
+#include "util/os_time.h"
+#include "util/u_cpu_detect.h"
+
+#include "lp_rast_priv.h"
+#include "lp_test.h"
+
+
+#define NUM_TRIS 4096
+
+
+void
+write_tsv_header(FILE *fp)
+{
+   fprintf(fp,
+           "result\t"
+           "kernel\t"
+           "tris_per_sec\n");
+
+   fflush(fp);
+}
+
+
+#if DETECT_ARCH_SSE
+
+struct tri_kernel {
+   const char *name;
+   bool supported;
+   lp_rast_tri_32_3_16_masks_func masks_16;
+   lp_rast_tri_32_3_4_mask_func mask_4;
+};
+
+
+struct tri_case {
+   alignas(16) struct lp_rast_plane plane[4];
+   int x, y;
+};
+
+
+static void
+random_tri(struct tri_case *tri)
+{
+   for (unsigned i = 0; i < 3; i++) {
+      tri->plane[i].c = (int64_t)(rand() % 20000 - 10000) * 16 + rand() % 256;
+      tri->plane[i].dcdx = rand() % 2048 - 1024;
+      tri->plane[i].dcdy = rand() % 2048 - 1024;
+      tri->plane[i].eo = 0;
+   }
+   tri->x = rand() % 64;
+   tri->y = rand() % 64;
+}
+
+
+static bool
+test_kernel(unsigned verbose, FILE *fp,
+            const struct tri_kernel *ref,
+            const struct tri_kernel *kernel,
+            const struct tri_case *tris, unsigned num_tris)
+{
+   bool success = true;
+
+   for (unsigned t = 0; t < num_tris && success; t++) {
+      const struct tri_case *tri = &tris[t];
+      struct lp_rast_block_mask ref_out[16], out[16];
+
+      unsigned ref_nr = ref->masks_16(tri->plane, tri->x, tri->y, ref_out);
+      unsigned nr = kernel->masks_16(tri->plane, tri->x, tri->y, out);
+
+      if (nr != ref_nr)
+         success = false;
+      for (unsigned i = 0; i < nr && success; i++) {
+         if (out[i].i != ref_out[i].i ||
+             out[i].j != ref_out[i].j ||
+             out[i].mask != ref_out[i].mask)
+            success = false;
+      }
+
+      if (kernel->mask_4(tri->plane, tri->x, tri->y) !=
+          ref->mask_4(tri->plane, tri->x, tri->y))
+         success = false;
+
+      if (!success)
+         fprintf(stderr, "%s: mismatch for triangle %u\n", kernel->name, t);
+   }
+
+   int64_t start = os_time_get_nano();
+   unsigned sink = 0;
+   for (unsigned iter = 0; iter < 64; iter++) {
+      for (unsigned t = 0; t < num_tris; t++) {
+         struct lp_rast_block_mask out[16];
+         sink += kernel->masks_16(tris[t].plane, tris[t].x, tris[t].y, out);
+      }
+   }
+   int64_t elapsed = MAX2(os_time_get_nano() - start, 1);
+   double tris_per_sec = 64.0 * num_tris * 1e9 / elapsed;
+
+   if (verbose >= 1)
+      printf("%s: %.2f Mtris/s (%u)\n", kernel->name, tris_per_sec / 1e6, sink);
+
+   if (fp) {
+      fprintf(fp, "%s\t%s\t%.0f\n", success ? "pass" : "fail",
+              kernel->name, tris_per_sec);
+      fflush(fp);
+   }
+
+   return success;
+}
+
+
+static bool
+test_tris(unsigned verbose, FILE *fp, unsigned num_tris)
+{
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+   const struct tri_kernel kernels[] = {
+      { "sse2", true,
+        lp_rast_tri_32_3_16_masks_sse2, lp_rast_tri_32_3_4_mask_sse2 },
+#if DETECT_ARCH_X86_64
+      { "avx2", caps->has_avx2,
+        lp_rast_tri_32_3_16_masks_avx2, lp_rast_tri_32_3_4_mask_avx2 },
+      { "avx512", caps->has_avx512f,
+        lp_rast_tri_32_3_16_masks_avx512, lp_rast_tri_32_3_4_mask_avx512 },
+#endif
+   };
+   struct tri_case *tris = malloc(num_tris * sizeof(*tris));
+   bool success = true;
+
+   if (!tris)
+      return false;
+
+   for (unsigned t = 0; t < num_tris; t++)
+      random_tri(&tris[t]);
+
+   for (unsigned k = 0; k < ARRAY_SIZE(kernels); k++) {
+      if (kernels[k].supported &&
+          !test_kernel(verbose, fp, &kernels[0], &kernels[k], tris, num_tris))
+         success = false;
+   }
+
+   free(tris);
+   return success;
+}
+
+#else
+
+static bool
+test_tris(unsigned verbose, FILE *fp, unsigned num_tris)
+{
+   return true;
+}
+
+#endif
+
+
+bool
+test_all(unsigned verbose, FILE *fp)
+{
+   return test_tris(verbose, fp, NUM_TRIS);
+}
+
+
+bool
+test_some(unsigned verbose, FILE *fp,
+          unsigned long n)
+{
+   return test_tris(verbose, fp, MAX2(n, 1));
+}
+
+
+bool
+test_single(unsigned verbose, FILE *fp)
+{
+   return test_tris(verbose, fp, 1);
+}
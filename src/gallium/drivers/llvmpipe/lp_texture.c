@@ -39,6 +39,7 @@
 #include "util/simple_mtx.h"
 #include "util/u_inlines.h"
 #include "util/u_cpu_detect.h"
+#include "util/u_cpu_section.h"
 #include "util/format/u_format.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
@@ -926,12 +927,16 @@ llvmpipe_transfer_map_ms(struct pipe_context *pipe,
    if (!(usage & PIPE_MAP_UNSYNCHRONIZED)) {
       bool read_only = !(usage & PIPE_MAP_WRITE);
       bool do_not_block = !!(usage & PIPE_MAP_DONTBLOCK);
-      if (!llvmpipe_flush_resource(pipe, resource,
-                                   level,
-                                   read_only,
-                                   true, /* cpu_access */
-                                   do_not_block,
-                                   __func__)) {
+      int64_t section_begin = util_cpu_section_begin();
+      bool flushed = llvmpipe_flush_resource(pipe, resource,
+                                             level,
+                                             read_only,
+                                             true, /* cpu_access */
+                                             do_not_block,
+                                             __func__);
+
+      util_cpu_section_end(UTIL_CPU_SECTION_MAP_STALL, section_begin);
+      if (!flushed) {
          /*
           * It would have blocked, but gallium frontend requested no to.
           */
@@ -164,8 +164,10 @@ panfrost_pool_alloc_aligned(struct panfrost_pool *pool, size_t sz,
    }
 #endif
 
-   /* If we don't fit, allocate a new backing */
-   if (unlikely(bo == NULL || (offset + sz) >= pool->base.slab_size)) {
+   /* If we don't fit, allocate a new backing. The current BO may be bigger
+    * than a slab if it was created for a large allocation.
+    */
+   if (unlikely(bo == NULL || (offset + sz) > panfrost_bo_size(bo))) {
       bo = panfrost_pool_alloc_backing(
          pool, ALIGN_POT(MAX2(pool->base.slab_size, sz), 4096));
       if (!bo)
@@ -23,6 +23,8 @@ namespace r600 {
  * available
  */
 struct MemoryBacking {
+   MemoryBacking() = default;
+   MemoryBacking(void *buffer, size_t size);
    ~MemoryBacking();
    void *allocate(size_t size);
    void *allocate(size_t size, size_t align);
@@ -32,7 +34,7 @@ struct MemoryBacking {
 
 struct MemoryPoolImpl {
 public:
-   MemoryPoolImpl();
+   MemoryPoolImpl(void *buffer, size_t size);
    ~MemoryPoolImpl();
 #ifdef HAVE_MEMORY_RESOURCE
    using MemoryBacking = ::std::pmr::monotonic_buffer_resource;
@@ -40,9 +42,21 @@ public:
    MemoryBacking *pool;
 };
 
+/* Upper limit for the memory that is kept around between compiles */
+static const size_t max_retained_size = 16 * 1024 * 1024;
+
 MemoryPool::MemoryPool() noexcept:
-    impl(nullptr)
+    impl(nullptr),
+    m_buffer(nullptr),
+    m_buffer_size(0),
+    m_allocated(0)
+{
+}
+
+MemoryPool::~MemoryPool()
 {
+   delete impl;
+   std::free(m_buffer);
 }
 
 MemoryPool&
@@ -57,19 +71,36 @@ MemoryPool::free()
 {
    delete impl;
    impl = nullptr;
+
+   /* Grow the retained buffer to what this compile needed, so that the next
+    * compile of a similar shader is served from it alone. */
+   if (m_allocated > m_buffer_size && m_buffer_size < max_retained_size) {
+      size_t size = m_buffer_size ? m_buffer_size : 64 * 1024;
+      while (size < m_allocated && size < max_retained_size)
+         size *= 2;
+
+      void *buffer = std::malloc(size);
+      if (buffer) {
+         std::free(m_buffer);
+         m_buffer = buffer;
+         m_buffer_size = size;
+      }
+   }
+   m_allocated = 0;
 }
 
 void
 MemoryPool::initialize()
 {
    if (!impl)
-      impl = new MemoryPoolImpl();
+      impl = new MemoryPoolImpl(m_buffer, m_buffer_size);
 }
 
 void *
 MemoryPool::allocate(size_t size)
 {
    assert(impl);
+   m_allocated += size;
    return impl->pool->allocate(size);
 }
 
@@ -77,6 +108,7 @@ void *
 MemoryPool::allocate(size_t size, size_t align)
 {
    assert(impl);
+   m_allocated += size + align - 1;
    return impl->pool->allocate(size, align);
 }
 
@@ -110,11 +142,25 @@ Allocate::operator delete(void *p, size_t size)
    // MemoryPool::instance().deallocate(p, size);
 }
 
-MemoryPoolImpl::MemoryPoolImpl() { pool = new MemoryBacking(); }
+MemoryPoolImpl::MemoryPoolImpl(void *buffer, size_t size)
+{
+   if (buffer)
+      pool = new MemoryBacking(buffer, size);
+   else
+      pool = new MemoryBacking();
+}
 
 MemoryPoolImpl::~MemoryPoolImpl() { delete pool; }
 
 #ifndef HAVE_MEMORY_RESOURCE
+MemoryBacking::MemoryBacking(void *buffer, size_t size)
+{
+   /* Allocations go through malloc directly, so there is nothing to use
+    * the retained buffer for */
+   (void)buffer;
+   (void)size;
+}
+
 MemoryBacking::~MemoryBacking()
 {
    for (auto p : m_data)
@@ -39,8 +39,15 @@ public:
 
 private:
    MemoryPool() noexcept;
+   ~MemoryPool();
 
    struct MemoryPoolImpl *impl;
+
+   /* Kept between compiles so that a compile that doesn't need more memory
+    * than the previous ones gets by without going to the system allocator */
+   void *m_buffer;
+   size_t m_buffer_size;
+   size_t m_allocated;
 };
 
 template <typename T> struct Allocator {
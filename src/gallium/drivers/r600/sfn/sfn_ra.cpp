@@ -9,7 +9,9 @@
 #include "sfn_alu_defines.h"
 #include "sfn_debug.h"
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <queue>
 
 namespace r600 {
@@ -43,18 +45,39 @@ Interference::initialize()
    }
 }
 
+/* Sweep over the live ranges in the order they start and only test
+ * against the ranges that are still live, instead of testing all pairs.
+ * For the large shaders this is where most of the RA time went. */
 void
 Interference::initialize(ComponentInterference& comp_interference,
                          LiveRangeMap::ChannelLiveRange& clr)
 {
-   for (size_t row = 0; row < clr.size(); ++row) {
-      auto& row_entry = clr[row];
-      comp_interference.prepare_row(row);
-      for (size_t col = 0; col < row; ++col) {
-         auto& col_entry = clr[col];
-         if (row_entry.m_end >= col_entry.m_start && row_entry.m_start <= col_entry.m_end)
-            comp_interference.add(row, col);
+   if (clr.empty())
+      return;
+
+   comp_interference.prepare_row(clr.size() - 1);
+
+   std::vector<size_t> order(clr.size());
+   std::iota(order.begin(), order.end(), 0);
+   std::stable_sort(order.begin(), order.end(), [&clr](size_t lhs, size_t rhs) {
+      return clr[lhs].m_start < clr[rhs].m_start;
+   });
+
+   std::vector<size_t> active;
+   for (auto idx : order) {
+      auto& entry = clr[idx];
+      assert(entry.m_start <= entry.m_end);
+
+      for (size_t i = 0; i < active.size();) {
+         if (clr[active[i]].m_end < entry.m_start) {
+            active[i] = active.back();
+            active.pop_back();
+            continue;
+         }
+         comp_interference.add(std::max(idx, active[i]), std::min(idx, active[i]));
+         ++i;
       }
+      active.push_back(idx);
    }
 }
 
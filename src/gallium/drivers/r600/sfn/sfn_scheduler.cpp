@@ -138,6 +138,8 @@ public:
 
    void finalize();
 
+   void print_slot_fill(std::ostream& os) const;
+
 private:
    void
    schedule_block(Block& in_block, Shader::ShaderBlocks& out_blocks, ValueFactory& vf);
@@ -209,6 +211,8 @@ private:
 
    int m_lds_addr_count{0};
    int m_alu_groups_scheduled{0};
+   int m_alu_groups_total{0};
+   int m_alu_slots_used{0};
    r600_chip_class m_chip_class;
    radeon_family m_chip_family;
    bool m_idx0_loading{false};
@@ -248,6 +252,12 @@ schedule(Shader *original)
    s.run(scheduled_shader);
    s.finalize();
 
+   if (sfn_log.has_debug_flag(SfnLog::shader_info)) {
+      std::stringstream ss;
+      s.print_slot_fill(ss);
+      sfn_log << SfnLog::shader_info << ss.str();
+   }
+
    sfn_log << SfnLog::schedule << "Scheduled shader\n";
    if (sfn_log.has_debug_flag(SfnLog::schedule)) {
       std::stringstream ss;
@@ -523,6 +533,17 @@ BlockScheduler::finalize()
       m_last_param->set_is_last_export(true);
 }
 
+void
+BlockScheduler::print_slot_fill(std::ostream& os) const
+{
+   int slots = m_alu_groups_total * (AluGroup::has_t() ? 5 : 4);
+   os << "ALU groups: " << m_alu_groups_total << ", slots used: "
+      << m_alu_slots_used << "/" << slots;
+   if (slots)
+      os << " (" << 100 * m_alu_slots_used / slots << "%)";
+   os << "\n";
+}
+
 bool
 BlockScheduler::schedule_alu(Shader::ShaderBlocks& out_blocks)
 {
@@ -664,6 +685,12 @@ BlockScheduler::schedule_alu(Shader::ShaderBlocks& out_blocks)
 
    m_current_block->push_back(group);
 
+   ++m_alu_groups_total;
+   for (auto instr : *group) {
+      if (instr)
+         ++m_alu_slots_used;
+   }
+
    update_array_writes(*group);
 
    m_idx0_pending |= m_idx0_loading;
@@ -21,6 +21,10 @@ OPT_BOOL(zerovram, false, "Zero all VRAM allocations")
 OPT_BOOL(clear_lds, false, "Clear LDS at the end of shaders. Might decrease performance.")
 OPT_BOOL(cache_rb_gl2, false, "Enable GL2 caching for CB and DB.")
 OPT_BOOL(alt_hiz_logic, true, "Enable alternative HiZ logic")
+OPT_INT(memory_shader_cache_size, 0,
+        "Maximum size of the in-memory shader cache in MB (0 = 64 MB on 32-bit, 1024 MB otherwise)")
+OPT_INT(gpu_trace_frame_interval, 1,
+        "Trace draws and dispatches with Perfetto only in every Nth frame to reduce the overhead")
 
 #undef OPT_BOOL
 #undef OPT_INT
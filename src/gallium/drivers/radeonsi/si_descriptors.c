@@ -1890,9 +1890,44 @@ static void si_upload_bindless_descriptor(struct si_context *sctx, unsigned desc
 
 static void si_upload_bindless_descriptors(struct si_context *sctx)
 {
-   if (!sctx->bindless_descriptors_dirty)
+   if (!sctx->bindless_descriptors_dirty && !sctx->bindless_descriptors_realloc)
       return;
 
+   if (!sctx->bindless_descriptors_realloc) {
+      unsigned num_dirty = 0;
+
+      util_dynarray_foreach (&sctx->resident_tex_handles, struct si_texture_handle *, tex_handle)
+         num_dirty += (*tex_handle)->desc_dirty;
+      util_dynarray_foreach (&sctx->resident_img_handles, struct si_image_handle *, img_handle)
+         num_dirty += (*img_handle)->desc_dirty;
+
+      /* When many handles are made resident at once, uploading the whole array into a new
+       * buffer is cheaper than one WRITE_DATA per descriptor and it doesn't need to wait
+       * for idle.
+       */
+      sctx->bindless_descriptors_realloc =
+         num_dirty * 8 >= sctx->bindless_descriptors.num_elements;
+   }
+
+   if (sctx->bindless_descriptors_realloc) {
+      si_upload_descriptors(sctx, &sctx->bindless_descriptors);
+
+      /* The new buffer contains all descriptor updates. */
+      util_dynarray_foreach (&sctx->resident_tex_handles, struct si_texture_handle *, tex_handle)
+         (*tex_handle)->desc_dirty = false;
+      util_dynarray_foreach (&sctx->resident_img_handles, struct si_image_handle *, img_handle)
+         (*img_handle)->desc_dirty = false;
+
+      /* Make sure to re-emit the shader pointers for all stages. */
+      sctx->graphics_bindless_pointer_dirty = true;
+      sctx->compute_bindless_pointer_dirty = true;
+      si_mark_atom_dirty(sctx, &sctx->atoms.s.gfx_shader_pointers);
+
+      sctx->bindless_descriptors_realloc = false;
+      sctx->bindless_descriptors_dirty = false;
+      return;
+   }
+
    /* Wait for graphics/compute to be idle before updating the resident
     * descriptors directly in memory, in case the GPU is using them.
     */
@@ -2547,13 +2582,11 @@ static unsigned si_create_bindless_descriptor(struct si_context *sctx, uint32_t
    /* Copy the descriptor into the array. */
    memcpy(desc->list + desc_slot_offset, desc_list, size);
 
-   /* Re-upload the whole array of bindless descriptors into a new buffer.
+   /* Re-upload the whole array of bindless descriptors into a new buffer
+    * before the next draw or dispatch. This is done only once for all
+    * handles created in the meantime.
     */
-   si_upload_descriptors(sctx, desc);
-
-   /* Make sure to re-emit the shader pointers for all stages. */
-   sctx->graphics_bindless_pointer_dirty = true;
-   sctx->compute_bindless_pointer_dirty = true;
+   sctx->bindless_descriptors_realloc = true;
    si_mark_atom_dirty(sctx, &sctx->atoms.s.gfx_shader_pointers);
 
    return desc_slot;
@@ -2651,6 +2684,57 @@ static void si_delete_texture_handle(struct pipe_context *ctx, uint64_t handle)
    FREE(tex_handle);
 }
 
+/* Handles know their index in the resident lists, so that removing them
+ * doesn't need to search the lists, which can be very long.
+ */
+static void si_add_resident_tex_handle(struct si_context *sctx, struct si_texture_handle *tex_handle)
+{
+   tex_handle->resident_index =
+      util_dynarray_num_elements(&sctx->resident_tex_handles, struct si_texture_handle *);
+   util_dynarray_append(&sctx->resident_tex_handles, struct si_texture_handle *, tex_handle);
+}
+
+static void si_remove_resident_tex_handle(struct si_context *sctx,
+                                          struct si_texture_handle *tex_handle)
+{
+   struct si_texture_handle **list = sctx->resident_tex_handles.data;
+   struct si_texture_handle *last =
+      util_dynarray_pop(&sctx->resident_tex_handles, struct si_texture_handle *);
+
+   assert(tex_handle->resident_index <= util_dynarray_num_elements(&sctx->resident_tex_handles,
+                                                                     struct si_texture_handle *));
+   assert(last == tex_handle || list[tex_handle->resident_index] == tex_handle);
+
+   if (last != tex_handle) {
+      list[tex_handle->resident_index] = last;
+      last->resident_index = tex_handle->resident_index;
+   }
+}
+
+static void si_add_resident_img_handle(struct si_context *sctx, struct si_image_handle *img_handle)
+{
+   img_handle->resident_index =
+      util_dynarray_num_elements(&sctx->resident_img_handles, struct si_image_handle *);
+   util_dynarray_append(&sctx->resident_img_handles, struct si_image_handle *, img_handle);
+}
+
+static void si_remove_resident_img_handle(struct si_context *sctx,
+                                          struct si_image_handle *img_handle)
+{
+   struct si_image_handle **list = sctx->resident_img_handles.data;
+   struct si_image_handle *last =
+      util_dynarray_pop(&sctx->resident_img_handles, struct si_image_handle *);
+
+   assert(img_handle->resident_index <= util_dynarray_num_elements(&sctx->resident_img_handles,
+                                                                     struct si_image_handle *));
+   assert(last == img_handle || list[img_handle->resident_index] == img_handle);
+
+   if (last != img_handle) {
+      list[img_handle->resident_index] = last;
+      last->resident_index = img_handle->resident_index;
+   }
+}
+
 static void si_make_texture_handle_resident(struct pipe_context *ctx, uint64_t handle,
                                             bool resident)
 {
@@ -2699,7 +2783,7 @@ static void si_make_texture_handle_resident(struct pipe_context *ctx, uint64_t h
          si_mark_bindless_descriptors_dirty(sctx);
 
       /* Add the texture handle to the per-context list. */
-      util_dynarray_append(&sctx->resident_tex_handles, struct si_texture_handle *, tex_handle);
+      si_add_resident_tex_handle(sctx, tex_handle);
 
       /* Add the buffers to the current CS in case si_begin_new_cs()
        * is not going to be called.
@@ -2708,8 +2792,7 @@ static void si_make_texture_handle_resident(struct pipe_context *ctx, uint64_t h
                                  sview->is_stencil_sampler);
    } else {
       /* Remove the texture handle from the per-context list. */
-      util_dynarray_delete_unordered(&sctx->resident_tex_handles, struct si_texture_handle *,
-                                     tex_handle);
+      si_remove_resident_tex_handle(sctx, tex_handle);
 
       if (sctx->gfx_level < GFX12 && sview->base.texture->target != PIPE_BUFFER) {
          util_dynarray_delete_unordered(&sctx->resident_tex_needs_depth_decompress,
@@ -2825,7 +2908,7 @@ static void si_make_image_handle_resident(struct pipe_context *ctx, uint64_t han
          si_mark_bindless_descriptors_dirty(sctx);
 
       /* Add the image handle to the per-context list. */
-      util_dynarray_append(&sctx->resident_img_handles, struct si_image_handle *, img_handle);
+      si_add_resident_img_handle(sctx, img_handle);
 
       /* Add the buffers to the current CS in case si_begin_new_cs()
        * is not going to be called.
@@ -2835,8 +2918,7 @@ static void si_make_image_handle_resident(struct pipe_context *ctx, uint64_t han
                                     RADEON_USAGE_READWRITE : RADEON_USAGE_READ, false);
    } else {
       /* Remove the image handle from the per-context list. */
-      util_dynarray_delete_unordered(&sctx->resident_img_handles, struct si_image_handle *,
-                                     img_handle);
+      si_remove_resident_img_handle(sctx, img_handle);
 
       if (sctx->gfx_level < GFX12 && res->b.b.target != PIPE_BUFFER) {
          util_dynarray_delete_unordered(&sctx->resident_img_needs_color_decompress,
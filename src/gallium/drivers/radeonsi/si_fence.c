@@ -5,6 +5,7 @@
  */
 
 #include "si_build_pm4.h"
+#include "si_utrace.h"
 #include "util/os_time.h"
 #include "util/u_memory.h"
 #include "util/u_queue.h"
@@ -448,8 +449,10 @@ static void si_flush_all_queues(struct pipe_context *ctx,
       si_flush_implicit_resources(sctx);
    }
 
-   if (flags & PIPE_FLUSH_END_OF_FRAME)
+   if (flags & PIPE_FLUSH_END_OF_FRAME) {
       rflags |= PIPE_FLUSH_END_OF_FRAME;
+      si_utrace_end_frame(sctx);
+   }
 
    if (flags & (PIPE_FLUSH_TOP_OF_PIPE | PIPE_FLUSH_BOTTOM_OF_PIPE)) {
       assert(flags & PIPE_FLUSH_DEFERRED);
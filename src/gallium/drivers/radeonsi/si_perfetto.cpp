@@ -47,6 +47,10 @@ static const struct {
    {
       "draw",
       SI_DS_QUEUE_STAGE_DRAW,
+   },
+   {
+      "marker",
+      SI_DS_QUEUE_STAGE_MARKER,
    }
 };
 
@@ -277,6 +281,24 @@ void si_ds_end_##event_name(struct si_ds_device *device, uint64_t ts_ns, uint16_
 CREATE_DUAL_EVENT_CALLBACK(draw, SI_DS_QUEUE_STAGE_DRAW)
 CREATE_DUAL_EVENT_CALLBACK(compute, SI_DS_QUEUE_STAGE_COMPUTE)
 
+void si_ds_begin_marker(struct si_ds_device *device, uint64_t ts_ns, uint16_t tp_idx,
+                        const void *flush_data, const struct trace_si_begin_marker *payload,
+                        const void *indirect_data)
+{
+   const struct si_ds_flush_data *flush = (const struct si_ds_flush_data *) flush_data;
+   begin_event(flush->queue, ts_ns, SI_DS_QUEUE_STAGE_MARKER);
+}
+
+void si_ds_end_marker(struct si_ds_device *device, uint64_t ts_ns, uint16_t tp_idx,
+                      const void *flush_data, const struct trace_si_end_marker *payload,
+                      const void *indirect_data)
+{
+   const struct si_ds_flush_data *flush = (const struct si_ds_flush_data *) flush_data;
+
+   /* Name the event after the marker, so that it can be found in the timeline. */
+   end_event(flush->queue, ts_ns, SI_DS_QUEUE_STAGE_MARKER, flush->submission_id, payload->str);
+}
+
 uint64_t si_ds_begin_submit(struct si_ds_queue *queue)
 {
    return perfetto::base::GetBootTimeNs().count();
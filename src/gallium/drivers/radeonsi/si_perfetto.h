@@ -37,6 +37,7 @@ enum si_ds_queue_stage {
    SI_DS_QUEUE_STAGE_QUEUE,
    SI_DS_QUEUE_STAGE_COMPUTE,
    SI_DS_QUEUE_STAGE_DRAW,
+   SI_DS_QUEUE_STAGE_MARKER,
    SI_DS_QUEUE_STAGE_N_STAGES,
 };
 
@@ -433,6 +433,9 @@ static void si_emit_string_marker(struct pipe_context *ctx, const char *string,
 
    if (sctx->log)
       u_log_printf(sctx->log, "\nString marker: %*s\n", len, string);
+
+   if (unlikely(sctx->trace_marker_open || u_trace_perfetto_active(&sctx->ds.trace_context)))
+      si_utrace_string_marker(sctx, string, len);
 }
 
 static void si_set_debug_callback(struct pipe_context *ctx, const struct util_debug_callback *cb)
@@ -994,8 +997,9 @@ void si_destroy_screen(struct pipe_screen *pscreen)
    if (sscreen->debug_flags & DBG(CACHE_STATS)) {
       printf("live shader cache:   hits = %u, misses = %u\n", sscreen->live_shader_cache.hits,
              sscreen->live_shader_cache.misses);
-      printf("memory shader cache: hits = %u, misses = %u\n", sscreen->num_memory_shader_cache_hits,
-             sscreen->num_memory_shader_cache_misses);
+      printf("memory shader cache: hits = %u, misses = %u, evictions = %u, size = %u KB\n",
+             sscreen->num_memory_shader_cache_hits, sscreen->num_memory_shader_cache_misses,
+             sscreen->num_memory_shader_cache_evictions, sscreen->shader_cache_size / 1024);
       printf("disk shader cache:   hits = %u, misses = %u\n", sscreen->num_disk_shader_cache_hits,
              sscreen->num_disk_shader_cache_misses);
    }
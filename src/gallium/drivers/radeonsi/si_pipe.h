@@ -590,6 +590,7 @@ struct si_screen {
    unsigned num_shaders_created;
    unsigned num_memory_shader_cache_hits;
    unsigned num_memory_shader_cache_misses;
+   unsigned num_memory_shader_cache_evictions;
    unsigned num_disk_shader_cache_hits;
    unsigned num_disk_shader_cache_misses;
 
@@ -637,6 +638,10 @@ struct si_screen {
     */
    simple_mtx_t shader_cache_mutex;
    struct hash_table *shader_cache;
+   /* Entries ordered from the least to the most recently used. When the
+    * cache is full, the least recently used ones are evicted.
+    */
+   struct list_head shader_cache_lru;
    /* Maximum and current size */
    uint32_t shader_cache_size;
    uint32_t shader_cache_max_size;
@@ -750,6 +755,28 @@ struct si_framebuffer {
    bool disable_vrs_flat_shading;
    bool has_stencil;
    bool has_hiz_his;
+   unsigned serial; /* incremented by every set_framebuffer_state */
+};
+
+#define SI_CB_RENDER_STATE_CACHE_SIZE 16
+
+/* Register values computed by si_emit_cb_render_state, so that switching
+ * back and forth between a few blend/PS/framebuffer combinations doesn't
+ * recompute them every time.
+ */
+struct si_cb_render_state_cache_entry {
+   /* Key */
+   struct si_state_blend *blend;
+   unsigned fb_serial;
+   unsigned spi_shader_col_format;
+   bool ps_missing_dual_src_colors;
+
+   /* Registers */
+   uint32_t cb_target_mask;
+   uint32_t cb_dcc_control;
+   uint32_t sx_ps_downconvert;
+   uint32_t sx_blend_opt_epsilon;
+   uint32_t sx_blend_opt_control;
 };
 
 enum si_quant_mode
@@ -859,6 +886,7 @@ union si_vgt_param_key {
 
 struct si_texture_handle {
    unsigned desc_slot;
+   unsigned resident_index; /* in si_context::resident_tex_handles */
    bool desc_dirty;
    struct pipe_sampler_view *view;
    struct si_sampler_state sstate;
@@ -866,6 +894,7 @@ struct si_texture_handle {
 
 struct si_image_handle {
    unsigned desc_slot;
+   unsigned resident_index; /* in si_context::resident_img_handles */
    bool desc_dirty;
    struct pipe_image_view view;
 };
@@ -1037,6 +1066,7 @@ struct si_context {
    unsigned sample_locs_num_samples;
    uint16_t sample_mask;
    unsigned last_cb_target_mask;
+   struct si_cb_render_state_cache_entry cb_render_state_cache[SI_CB_RENDER_STATE_CACHE_SIZE];
    struct pipe_blend_color blend_color;
    struct pipe_clip_state clip_state;
    struct si_shader_data shader_pointers;
@@ -1091,6 +1121,12 @@ struct si_context {
    bool uses_nontrivial_vs_inputs;
    bool force_trivial_vs_inputs;
    bool do_update_shaders;
+   /* Some stage uses the unoptimized shader while its optimized variant is being
+    * compiled. Shaders are re-selected every few draws until it can be swapped in,
+    * so that it doesn't take a state change to start using it.
+    */
+   bool opt_variant_pending;
+   uint8_t opt_variant_poll_count;
    bool compute_shaderbuf_sgprs_dirty;
    bool compute_image_sgprs_dirty;
    bool vs_uses_base_instance;
@@ -1246,6 +1282,8 @@ struct si_context {
    struct util_idalloc bindless_used_slots;
    unsigned num_bindless_descriptors;
    bool bindless_descriptors_dirty;
+   /* The whole array must be uploaded into a new buffer before the next draw or dispatch. */
+   bool bindless_descriptors_realloc;
    bool graphics_internal_bindings_pointer_dirty;
    bool compute_internal_bindings_pointer_dirty;
    bool graphics_bindless_pointer_dirty;
@@ -1357,6 +1395,15 @@ struct si_context {
    struct si_ds_queue ds_queue;
    uint32_t *last_timestamp_cmd;
    unsigned int last_timestamp_cmd_cdw;
+   /* Whether draws and dispatches of the current frame are traced, see
+    * the gpu_trace_frame_interval option.
+    */
+   bool trace_draws;
+   unsigned trace_frame_nr;
+   /* The string marker that the open marker event will be named after. */
+   bool trace_marker_open;
+   unsigned trace_marker_len;
+   char trace_marker[128];
 };
 
 /* si_barrier.c */
@@ -1665,6 +1712,16 @@ void si_test_image_copy_region(struct si_screen *sscreen);
 void si_test_blit(struct si_screen *sscreen, unsigned test_flags);
 
 /* si_test_dma_perf.c */
+struct si_test_perf_stats {
+   unsigned count;
+   double mean, min, max, stddev;
+};
+
+bool si_test_perf_json(void);
+unsigned si_test_perf_num_repeats(void);
+void si_test_perf_compute_stats(const double *samples, unsigned num_samples,
+                                struct si_test_perf_stats *stats);
+void si_test_perf_print_json_stats(const char *name, const struct si_test_perf_stats *stats);
 void si_test_dma_perf(struct si_screen *sscreen);
 void si_test_mem_perf(struct si_screen *sscreen);
 void si_test_clear_buffer(struct si_screen *sscreen);
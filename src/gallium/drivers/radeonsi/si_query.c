@@ -68,6 +68,16 @@ static enum radeon_value_id winsys_id_from_type(unsigned type)
       return RADEON_BUFFER_WAIT_TIME_NS;
    case SI_QUERY_NUM_MAPPED_BUFFERS:
       return RADEON_NUM_MAPPED_BUFFERS;
+   case SI_QUERY_BO_CACHE_HITS:
+      return RADEON_BO_CACHE_HITS;
+   case SI_QUERY_BO_CACHE_MISSES:
+      return RADEON_BO_CACHE_MISSES;
+   case SI_QUERY_BO_CACHE_EXPIRED:
+      return RADEON_BO_CACHE_EXPIRED;
+   case SI_QUERY_BO_CACHE_TRIMMED:
+      return RADEON_BO_CACHE_TRIMMED;
+   case SI_QUERY_BO_CACHE_SIZE:
+      return RADEON_BO_CACHE_SIZE;
    case SI_QUERY_NUM_GFX_IBS:
       return RADEON_NUM_GFX_IBS;
    case SI_QUERY_GFX_BO_LIST_SIZE:
@@ -167,6 +177,7 @@ static bool si_query_sw_begin(struct si_context *sctx, struct si_query *squery)
    case SI_QUERY_CURRENT_GPU_MCLK:
    case SI_QUERY_BACK_BUFFER_PS_DRAW_RATIO:
    case SI_QUERY_NUM_MAPPED_BUFFERS:
+   case SI_QUERY_BO_CACHE_SIZE:
       query->begin_result = 0;
       break;
    case SI_QUERY_BUFFER_WAIT_TIME:
@@ -174,7 +185,11 @@ static bool si_query_sw_begin(struct si_context *sctx, struct si_query *squery)
    case SI_QUERY_NUM_GFX_IBS:
    case SI_QUERY_NUM_BYTES_MOVED:
    case SI_QUERY_NUM_EVICTIONS:
-   case SI_QUERY_NUM_VRAM_CPU_PAGE_FAULTS: {
+   case SI_QUERY_NUM_VRAM_CPU_PAGE_FAULTS:
+   case SI_QUERY_BO_CACHE_HITS:
+   case SI_QUERY_BO_CACHE_MISSES:
+   case SI_QUERY_BO_CACHE_EXPIRED:
+   case SI_QUERY_BO_CACHE_TRIMMED: {
       enum radeon_value_id ws_id = winsys_id_from_type(query->b.type);
       query->begin_result = sctx->ws->query_value(sctx->ws, ws_id);
       break;
@@ -324,6 +339,11 @@ static bool si_query_sw_end(struct si_context *sctx, struct si_query *squery)
    case SI_QUERY_BUFFER_WAIT_TIME:
    case SI_QUERY_GFX_IB_SIZE:
    case SI_QUERY_NUM_MAPPED_BUFFERS:
+   case SI_QUERY_BO_CACHE_HITS:
+   case SI_QUERY_BO_CACHE_MISSES:
+   case SI_QUERY_BO_CACHE_EXPIRED:
+   case SI_QUERY_BO_CACHE_TRIMMED:
+   case SI_QUERY_BO_CACHE_SIZE:
    case SI_QUERY_NUM_GFX_IBS:
    case SI_QUERY_NUM_BYTES_MOVED:
    case SI_QUERY_NUM_EVICTIONS:
@@ -1774,6 +1794,11 @@ static struct pipe_driver_query_info si_driver_query_list[] = {
    X("slab-wasted-GTT", SLAB_WASTED_GTT, BYTES, AVERAGE),
    X("buffer-wait-time", BUFFER_WAIT_TIME, MICROSECONDS, CUMULATIVE),
    X("num-mapped-buffers", NUM_MAPPED_BUFFERS, UINT64, AVERAGE),
+   X("bo-cache-hits", BO_CACHE_HITS, UINT64, CUMULATIVE),
+   X("bo-cache-misses", BO_CACHE_MISSES, UINT64, CUMULATIVE),
+   X("bo-cache-expired", BO_CACHE_EXPIRED, UINT64, CUMULATIVE),
+   X("bo-cache-trimmed", BO_CACHE_TRIMMED, UINT64, CUMULATIVE),
+   X("bo-cache-size", BO_CACHE_SIZE, BYTES, AVERAGE),
    X("num-GFX-IBs", NUM_GFX_IBS, UINT64, AVERAGE),
    X("GFX-BO-list-size", GFX_BO_LIST_SIZE, UINT64, AVERAGE),
    X("GFX-IB-size", GFX_IB_SIZE, UINT64, AVERAGE),
@@ -51,6 +51,11 @@ enum
    SI_QUERY_SLAB_WASTED_GTT,
    SI_QUERY_BUFFER_WAIT_TIME,
    SI_QUERY_NUM_MAPPED_BUFFERS,
+   SI_QUERY_BO_CACHE_HITS,
+   SI_QUERY_BO_CACHE_MISSES,
+   SI_QUERY_BO_CACHE_EXPIRED,
+   SI_QUERY_BO_CACHE_TRIMMED,
+   SI_QUERY_BO_CACHE_SIZE,
    SI_QUERY_NUM_GFX_IBS,
    SI_QUERY_GFX_BO_LIST_SIZE,
    SI_QUERY_GFX_IB_SIZE,
@@ -36,10 +36,10 @@ static unsigned si_pack_float_12p4(float x)
  * CB_TARGET_MASK is emitted here to avoid a hang with dual source blending
  * if there is not enough PS outputs.
  */
-static void si_emit_cb_render_state(struct si_context *sctx, unsigned index)
+static void si_compute_cb_render_state(struct si_context *sctx,
+                                       struct si_cb_render_state_cache_entry *state)
 {
-   struct radeon_cmdbuf *cs = &sctx->gfx_cs;
-   struct si_state_blend *blend = sctx->queued.named.blend;
+   struct si_state_blend *blend = state->blend;
    /* CB_COLORn_INFO.FORMAT=INVALID should disable unbound colorbuffers,
     * but you never know. */
    uint32_t cb_target_mask = sctx->framebuffer.colorbuf_enabled_4bit & blend->cb_target_mask;
@@ -51,22 +51,9 @@ static void si_emit_cb_render_state(struct si_context *sctx, unsigned index)
     *
     * Reproducible with Unigine Heaven 4.0 and drirc missing.
     */
-   if (blend->dual_src_blend && sctx->shader.ps.cso &&
-       (sctx->shader.ps.cso->info.colors_written & 0x3) != 0x3)
+   if (blend->dual_src_blend && state->ps_missing_dual_src_colors)
       cb_target_mask = 0;
 
-   /* GFX9: Flush DFSM when CB_TARGET_MASK changes.
-    * I think we don't have to do anything between IBs.
-    */
-   if (sctx->screen->dpbb_allowed && sctx->last_cb_target_mask != cb_target_mask &&
-       sctx->screen->pbb_context_states_per_bin > 1) {
-      sctx->last_cb_target_mask = cb_target_mask;
-
-      radeon_begin(cs);
-      radeon_event_write(V_028A90_BREAK_BATCH);
-      radeon_end();
-   }
-
    uint32_t cb_dcc_control = 0;
 
    if (sctx->gfx_level >= GFX8 && sctx->gfx_level < GFX12) {
@@ -97,9 +84,7 @@ static void si_emit_cb_render_state(struct si_context *sctx, unsigned index)
 
    /* RB+ register settings. */
    if (sctx->screen->info.rbplus_allowed) {
-      unsigned spi_shader_col_format =
-         sctx->shader.ps.cso ? sctx->shader.ps.current->key.ps.part.epilog.spi_shader_col_format
-                             : 0;
+      unsigned spi_shader_col_format = state->spi_shader_col_format;
       unsigned num_cbufs = util_last_bit(sctx->framebuffer.colorbuf_enabled_4bit &
                                          blend->cb_target_enabled_4bit) / 4;
 
@@ -235,6 +220,56 @@ static void si_emit_cb_render_state(struct si_context *sctx, unsigned index)
          sx_ps_downconvert = V_028754_SX_RT_EXPORT_32_R;
    }
 
+   state->cb_target_mask = cb_target_mask;
+   state->cb_dcc_control = cb_dcc_control;
+   state->sx_ps_downconvert = sx_ps_downconvert;
+   state->sx_blend_opt_epsilon = sx_blend_opt_epsilon;
+   state->sx_blend_opt_control = sx_blend_opt_control;
+}
+
+static void si_emit_cb_render_state(struct si_context *sctx, unsigned index)
+{
+   struct radeon_cmdbuf *cs = &sctx->gfx_cs;
+   struct si_state_blend *blend = sctx->queued.named.blend;
+   unsigned fb_serial = sctx->framebuffer.serial;
+   unsigned spi_shader_col_format =
+      sctx->shader.ps.cso ? sctx->shader.ps.current->key.ps.part.epilog.spi_shader_col_format : 0;
+   bool ps_missing_dual_src_colors =
+      sctx->shader.ps.cso && (sctx->shader.ps.cso->info.colors_written & 0x3) != 0x3;
+
+   unsigned hash = ((uintptr_t)blend >> 6) ^ fb_serial ^ spi_shader_col_format ^
+                   (spi_shader_col_format >> 16);
+   struct si_cb_render_state_cache_entry *state =
+      &sctx->cb_render_state_cache[hash % SI_CB_RENDER_STATE_CACHE_SIZE];
+
+   if (state->blend != blend || state->fb_serial != fb_serial ||
+       state->spi_shader_col_format != spi_shader_col_format ||
+       state->ps_missing_dual_src_colors != ps_missing_dual_src_colors) {
+      state->blend = blend;
+      state->fb_serial = fb_serial;
+      state->spi_shader_col_format = spi_shader_col_format;
+      state->ps_missing_dual_src_colors = ps_missing_dual_src_colors;
+      si_compute_cb_render_state(sctx, state);
+   }
+
+   uint32_t cb_target_mask = state->cb_target_mask;
+   uint32_t cb_dcc_control = state->cb_dcc_control;
+   uint32_t sx_ps_downconvert = state->sx_ps_downconvert;
+   uint32_t sx_blend_opt_epsilon = state->sx_blend_opt_epsilon;
+   uint32_t sx_blend_opt_control = state->sx_blend_opt_control;
+
+   /* GFX9: Flush DFSM when CB_TARGET_MASK changes.
+    * I think we don't have to do anything between IBs.
+    */
+   if (sctx->screen->dpbb_allowed && sctx->last_cb_target_mask != cb_target_mask &&
+       sctx->screen->pbb_context_states_per_bin > 1) {
+      sctx->last_cb_target_mask = cb_target_mask;
+
+      radeon_begin(cs);
+      radeon_event_write(V_028A90_BREAK_BATCH);
+      radeon_end();
+   }
+
    if (sctx->gfx_level >= GFX12) {
       /* GFX12 doesn't have CB_FDCC_CONTROL. */
       assert(cb_dcc_control == 0);
@@ -829,6 +864,12 @@ static void si_delete_blend_state(struct pipe_context *ctx, void *state)
    if (sctx->queued.named.blend == state)
       si_bind_blend_state(ctx, sctx->noop_blend);
 
+   /* A new blend state could get the same address. */
+   for (unsigned i = 0; i < SI_CB_RENDER_STATE_CACHE_SIZE; i++) {
+      if (sctx->cb_render_state_cache[i].blend == state)
+         sctx->cb_render_state_cache[i].blend = NULL;
+   }
+
    si_pm4_free_state(sctx, (struct si_pm4_state*)state, SI_STATE_IDX(blend));
 }
 
@@ -2719,6 +2760,7 @@ static void si_set_framebuffer_state(struct pipe_context *ctx,
    }
 
    si_update_ps_colorbuf0_slot(sctx);
+   sctx->framebuffer.serial++;
    si_mark_atom_dirty(sctx, &sctx->atoms.s.cb_render_state);
    si_mark_atom_dirty(sctx, &sctx->atoms.s.framebuffer);
 
@@ -52,6 +52,9 @@ static bool si_update_shaders(struct si_context *sctx)
       old_ps ? old_ps->key.ps.part.epilog.spi_shader_col_format : 0;
    int r;
 
+   /* si_shader_select sets this again if an optimized variant still isn't ready. */
+   sctx->opt_variant_pending = false;
+
    /* Update TCS and TES. */
    if (HAS_TESS) {
       if (!sctx->has_tessellation) {
@@ -2074,7 +2077,7 @@ static void si_draw(struct pipe_context *ctx,
 
    si_need_gfx_cs_space(sctx, num_draws, ALT_HIZ_LOGIC ? 8 : 0);
 
-   if (u_trace_perfetto_active(&sctx->ds.trace_context))
+   if (sctx->trace_draws && u_trace_perfetto_active(&sctx->ds.trace_context))
       trace_si_begin_draw(&sctx->trace);
 
    unsigned instance_count = info->instance_count;
@@ -2317,6 +2320,9 @@ static void si_draw(struct pipe_context *ctx,
       }
    }
 
+   if (unlikely(sctx->opt_variant_pending) && !(++sctx->opt_variant_poll_count % 16))
+      sctx->do_update_shaders = true;
+
    if (unlikely(sctx->do_update_shaders)) {
       if (unlikely(!(si_update_shaders<GFX_VERSION, HAS_TESS, HAS_GS, NGG>(sctx)))) {
          DRAW_CLEANUP;
@@ -2426,7 +2432,7 @@ static void si_draw(struct pipe_context *ctx,
       zstex->depth_cleared_level_mask &= ~BITFIELD_BIT(sctx->framebuffer.state.zsbuf->u.tex.level);
    }
 
-   if (u_trace_perfetto_active(&sctx->ds.trace_context)) {
+   if (sctx->trace_draws && u_trace_perfetto_active(&sctx->ds.trace_context)) {
       /* Just use the draw[0] vertex count for perfetto. */
       trace_si_end_draw(&sctx->trace, draws[0].count);
    }
@@ -335,6 +335,26 @@ static bool si_load_shader_binary(struct si_shader *shader, void *binary)
    return true;
 }
 
+struct si_shader_cache_entry {
+   unsigned char key[20];
+   unsigned size;
+   uint32_t *binary;
+   struct list_head lru;
+};
+
+static void si_shader_cache_evict_lru(struct si_screen *sscreen)
+{
+   struct si_shader_cache_entry *entry =
+      list_first_entry(&sscreen->shader_cache_lru, struct si_shader_cache_entry, lru);
+
+   _mesa_hash_table_remove_key(sscreen->shader_cache, entry->key);
+   list_del(&entry->lru);
+   sscreen->shader_cache_size -= entry->size;
+   sscreen->num_memory_shader_cache_evictions++;
+   FREE(entry->binary);
+   FREE(entry);
+}
+
 /**
  * Insert a shader into the cache. It's assumed the shader is not in the cache.
  * Use si_shader_cache_load_shader before calling this.
@@ -345,10 +365,6 @@ void si_shader_cache_insert_shader(struct si_screen *sscreen, unsigned char ir_s
    uint32_t *hw_binary;
    struct hash_entry *entry;
    uint8_t key[CACHE_KEY_SIZE];
-   bool memory_cache_full = sscreen->shader_cache_size >= sscreen->shader_cache_max_size;
-
-   if (!insert_into_disk_cache && memory_cache_full)
-      return;
 
    entry = _mesa_hash_table_search(sscreen->shader_cache, ir_sha1_cache_key);
    if (entry)
@@ -383,24 +399,34 @@ void si_shader_cache_insert_shader(struct si_screen *sscreen, unsigned char ir_s
       hw_binary = combined_binary;
    }
 
-   if (!memory_cache_full) {
-      if (_mesa_hash_table_insert(sscreen->shader_cache,
-                                  mem_dup(ir_sha1_cache_key, 20),
-                                  hw_binary) == NULL) {
-          FREE(hw_binary);
-          return;
-      }
-
-      sscreen->shader_cache_size += size;
-   }
-
    if (sscreen->disk_shader_cache && insert_into_disk_cache) {
       disk_cache_compute_key(sscreen->disk_shader_cache, ir_sha1_cache_key, 20, key);
       disk_cache_put(sscreen->disk_shader_cache, key, hw_binary, size, NULL);
    }
 
-   if (memory_cache_full)
+   struct si_shader_cache_entry *cache_entry =
+      size <= sscreen->shader_cache_max_size ? CALLOC_STRUCT(si_shader_cache_entry) : NULL;
+   if (!cache_entry) {
       FREE(hw_binary);
+      return;
+   }
+
+   /* Make room for the new entry. */
+   while (sscreen->shader_cache_size + size > sscreen->shader_cache_max_size)
+      si_shader_cache_evict_lru(sscreen);
+
+   memcpy(cache_entry->key, ir_sha1_cache_key, 20);
+   cache_entry->size = size;
+   cache_entry->binary = hw_binary;
+
+   if (!_mesa_hash_table_insert(sscreen->shader_cache, cache_entry->key, cache_entry)) {
+      FREE(hw_binary);
+      FREE(cache_entry);
+      return;
+   }
+
+   list_addtail(&cache_entry->lru, &sscreen->shader_cache_lru);
+   sscreen->shader_cache_size += size;
 }
 
 bool si_shader_cache_load_shader(struct si_screen *sscreen, unsigned char ir_sha1_cache_key[20],
@@ -409,7 +435,12 @@ bool si_shader_cache_load_shader(struct si_screen *sscreen, unsigned char ir_sha
    struct hash_entry *entry = _mesa_hash_table_search(sscreen->shader_cache, ir_sha1_cache_key);
 
    if (entry) {
-      if (si_load_shader_binary(shader, entry->data)) {
+      struct si_shader_cache_entry *cache_entry = (struct si_shader_cache_entry *)entry->data;
+
+      if (si_load_shader_binary(shader, cache_entry->binary)) {
+         /* Mark it as the most recently used. */
+         list_del(&cache_entry->lru);
+         list_addtail(&cache_entry->lru, &sscreen->shader_cache_lru);
          p_atomic_inc(&sscreen->num_memory_shader_cache_hits);
          return true;
       }
@@ -467,8 +498,10 @@ static bool si_shader_cache_key_equals(const void *a, const void *b)
 
 static void si_destroy_shader_cache_entry(struct hash_entry *entry)
 {
-   FREE((void *)entry->key);
-   FREE(entry->data);
+   struct si_shader_cache_entry *cache_entry = (struct si_shader_cache_entry *)entry->data;
+
+   FREE(cache_entry->binary);
+   FREE(cache_entry);
 }
 
 bool si_init_shader_cache(struct si_screen *sscreen)
@@ -476,9 +509,13 @@ bool si_init_shader_cache(struct si_screen *sscreen)
    (void)simple_mtx_init(&sscreen->shader_cache_mutex, mtx_plain);
    sscreen->shader_cache =
       _mesa_hash_table_create(NULL, si_shader_cache_key_hash, si_shader_cache_key_equals);
+   list_inithead(&sscreen->shader_cache_lru);
    sscreen->shader_cache_size = 0;
-   /* Maximum size: 64MB on 32 bits, 1GB else */
-   sscreen->shader_cache_max_size = ((sizeof(void *) == 4) ? 64 : 1024) * 1024 * 1024;
+   /* Default maximum size: 64MB on 32 bits, 1GB else */
+   unsigned max_size_mb = sscreen->options.memory_shader_cache_size > 0 ?
+                             MIN2(sscreen->options.memory_shader_cache_size, 4095) :
+                             (sizeof(void *) == 4) ? 64 : 1024;
+   sscreen->shader_cache_max_size = max_size_mb * 1024 * 1024;
 
    return sscreen->shader_cache != NULL;
 }
@@ -3092,6 +3129,7 @@ again:
          if (current->is_optimized) {
             key = use_local_key_copy(key, &local_key, key_size);
             memset(&local_key.opt, 0, key_opt_size);
+            sctx->opt_variant_pending = true;
             goto current_not_ready;
          }
 
@@ -3149,6 +3187,7 @@ current_not_ready:
             if (iter->is_optimized) {
                key = use_local_key_copy(key, &local_key, key_size);
                memset(&local_key.opt, 0, key_opt_size);
+               sctx->opt_variant_pending = true;
                goto again;
             }
 
@@ -3287,6 +3326,8 @@ current_not_ready:
 
       if (sscreen->options.sync_compile)
          util_queue_fence_wait(&shader->ready);
+      else
+         sctx->opt_variant_pending = true;
 
       goto again;
    }
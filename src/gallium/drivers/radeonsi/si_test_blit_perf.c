@@ -187,6 +187,13 @@ enum {
    NUM_METHODS,
 };
 
+static const char *method_strings[] = {
+   [METHOD_DEFAULT] = "Default",
+   [METHOD_GFX] = "Gfx",
+   [METHOD_COMPUTE] = "Compute",
+   [METHOD_SPECIAL] = "Special",
+};
+
 static const union pipe_color_union black_color_float = {.f = {0, 0, 0, 0}};
 static const union pipe_color_union solid_color_float = {.f = {0.2, 0.3, 0.4, 0.5}};
 static const union pipe_color_union black_color_uint = {.ui = {0, 0, 0, 0}};
@@ -208,12 +215,18 @@ void si_test_blit_perf(struct si_screen *sscreen)
    for (unsigned i = 0; i < ARRAY_SIZE(random_data); i++)
       random_data[i] = rand_xorshift128plus(seed_xorshift128plus);
 
+   unsigned num_measurements = si_test_perf_num_repeats();
+   bool json = si_test_perf_json();
+   double *results = malloc(num_measurements * sizeof(*results));
+
    sscreen->ws->cs_set_pstate(&sctx->gfx_cs, RADEON_CTX_PSTATE_PEAK);
 
-   printf("Op      , Special  ,Dim, Format            ,MS,Layout, Fill       , Box         ,"
-          "   small   ,   small   ,   small   ,   small   ,   LARGE   ,   LARGE   ,   LARGE   ,   LARGE\n");
-   printf("--------,----------,---,-------------------,--,------,------------,-------------,"
-          "  Default  ,    Gfx    ,  Compute  ,  Special  ,  Default  ,    Gfx    ,  Compute  ,  Special\n");
+   if (!json) {
+      printf("Op      , Special  ,Dim, Format            ,MS,Layout, Fill       , Box         ,"
+             "   small   ,   small   ,   small   ,   small   ,   LARGE   ,   LARGE   ,   LARGE   ,   LARGE\n");
+      printf("--------,----------,---,-------------------,--,------,------------,-------------,"
+             "  Default  ,    Gfx    ,  Compute  ,  Special  ,  Default  ,    Gfx    ,  Compute  ,  Special\n");
+   }
 
    for (unsigned test_flavor = 0; test_flavor < NUM_TESTS; test_flavor++) {
       for (unsigned dim = 1; dim <= 3; dim++) {
@@ -397,11 +410,13 @@ void si_test_blit_perf(struct si_screen *sscreen)
                            test_flavor == TEST_BLIT && !yflip ? "copy" :
                            test_flavor == TEST_RESOLVE ? "cbresolve" : "n/a";
 
-                        printf("%-8s, %-9s, %uD, %-18s, %u, %-5s, %-11s, %-11s",
-                               test_strings[test_flavor], special_op, dim,
-                               util_format_short_name(formats[format_index]), samples,
-                               layout_strings[layout], fill_strings[fill_flavor],
-                               box_strings[box_flavor]);
+                        if (!json) {
+                           printf("%-8s, %-9s, %uD, %-18s, %u, %-5s, %-11s, %-11s",
+                                  test_strings[test_flavor], special_op, dim,
+                                  util_format_short_name(formats[format_index]), samples,
+                                  layout_strings[layout], fill_strings[fill_flavor],
+                                  box_strings[box_flavor]);
+                        }
 
                         for (unsigned size_factor = 0; size_factor <= 1; size_factor++) {
                            /* Determine the box. */
@@ -496,198 +511,226 @@ void si_test_blit_perf(struct si_screen *sscreen)
                            }
 
                            for (unsigned method = 0; method < NUM_METHODS; method++) {
-                              struct pipe_surface *dst_surf = NULL;
-
-                              /* Create pipe_surface for clears. */
-                              if (test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR) {
-                                 struct pipe_surface surf_templ;
-
-                                 u_surface_default_template(&surf_templ, dst[size_factor]);
-                                 surf_templ.u.tex.last_layer = dst[size_factor]->depth0 - 1;
-                                 dst_surf = ctx->create_surface(ctx, dst[size_factor], &surf_templ);
-
-                                 /* Bind the colorbuffer for FB clears. */
-                                 if (box_flavor == BOX_FULL) {
-                                    struct pipe_framebuffer_state fb = {0};
-                                    fb.width = dst[size_factor]->width0;
-                                    fb.height = dst[size_factor]->height0;
-                                    fb.layers = dst[size_factor]->depth0;
-                                    fb.samples = dst[size_factor]->nr_samples;
-                                    fb.nr_cbufs = 1;
-                                    fb.cbufs[0] = dst_surf;
-                                    ctx->set_framebuffer_state(ctx, &fb);
-                                    si_emit_barrier_direct(sctx);
+                              struct si_test_perf_stats stats;
+
+                              for (unsigned r = 0; r < num_measurements; r++) {
+                                 struct pipe_surface *dst_surf = NULL;
+
+                                 /* Create pipe_surface for clears. */
+                                 if (test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR) {
+                                    struct pipe_surface surf_templ;
+
+                                    u_surface_default_template(&surf_templ, dst[size_factor]);
+                                    surf_templ.u.tex.last_layer = dst[size_factor]->depth0 - 1;
+                                    dst_surf = ctx->create_surface(ctx, dst[size_factor], &surf_templ);
+
+                                    /* Bind the colorbuffer for FB clears. */
+                                    if (box_flavor == BOX_FULL) {
+                                       struct pipe_framebuffer_state fb = {0};
+                                       fb.width = dst[size_factor]->width0;
+                                       fb.height = dst[size_factor]->height0;
+                                       fb.layers = dst[size_factor]->depth0;
+                                       fb.samples = dst[size_factor]->nr_samples;
+                                       fb.nr_cbufs = 1;
+                                       fb.cbufs[0] = dst_surf;
+                                       ctx->set_framebuffer_state(ctx, &fb);
+                                       si_emit_barrier_direct(sctx);
+                                    }
                                  }
-                              }
 
-                              struct pipe_query *q = ctx->create_query(ctx, PIPE_QUERY_TIME_ELAPSED, 0);
-                              unsigned num_warmup_repeats = 1, num_repeats = 4;
-                              bool success = true;
-
-                              /* Run tests. */
-                              for (unsigned i = 0; i < num_warmup_repeats + num_repeats; i++) {
-                                 /* The first few just warm up caches and the hw. */
-                                 if (i == num_warmup_repeats)
-                                    ctx->begin_query(ctx, q);
-
-                                 switch (test_flavor) {
-                                 case TEST_FB_CLEAR:
-                                 case TEST_CLEAR:
-                                    switch (method) {
-                                    case METHOD_DEFAULT:
-                                       if (test_flavor == TEST_FB_CLEAR) {
-                                          ctx->clear(ctx, PIPE_CLEAR_COLOR, NULL, clear_color, 0, 0);
-                                          sctx->barrier_flags |= SI_BARRIER_SYNC_AND_INV_CB | SI_BARRIER_INV_L2;
-                                       } else {
-                                          ctx->clear_render_target(ctx, dst_surf, clear_color,
-                                                                   dst_box.x, dst_box.y,
-                                                                   dst_box.width, dst_box.height,
-                                                                   false);
-                                       }
-                                       break;
-                                    case METHOD_GFX:
-                                       si_gfx_clear_render_target(ctx, dst_surf, clear_color,
-                                                                  dst_box.x, dst_box.y,
-                                                                  dst_box.width, dst_box.height,
-                                                                  false);
-                                       break;
-                                    case METHOD_COMPUTE:
-                                       success &=
-                                          si_compute_clear_image(sctx, dst_surf->texture,
-                                                                 dst_surf->format, 0, &dst_box,
-                                                                 clear_color, false, false);
-                                       break;
-                                    case METHOD_SPECIAL:
-                                       if (test_flavor == TEST_CLEAR) {
+                                 struct pipe_query *q = ctx->create_query(ctx, PIPE_QUERY_TIME_ELAPSED, 0);
+                                 unsigned num_warmup_repeats = 1, num_repeats = 4;
+                                 bool success = true;
+
+                                 /* Run tests. */
+                                 for (unsigned i = 0; i < num_warmup_repeats + num_repeats; i++) {
+                                    /* The first few just warm up caches and the hw. */
+                                    if (i == num_warmup_repeats)
+                                       ctx->begin_query(ctx, q);
+
+                                    switch (test_flavor) {
+                                    case TEST_FB_CLEAR:
+                                    case TEST_CLEAR:
+                                       switch (method) {
+                                       case METHOD_DEFAULT:
+                                          if (test_flavor == TEST_FB_CLEAR) {
+                                             ctx->clear(ctx, PIPE_CLEAR_COLOR, NULL, clear_color, 0, 0);
+                                             sctx->barrier_flags |= SI_BARRIER_SYNC_AND_INV_CB | SI_BARRIER_INV_L2;
+                                          } else {
+                                             ctx->clear_render_target(ctx, dst_surf, clear_color,
+                                                                      dst_box.x, dst_box.y,
+                                                                      dst_box.width, dst_box.height,
+                                                                      false);
+                                          }
+                                          break;
+                                       case METHOD_GFX:
+                                          si_gfx_clear_render_target(ctx, dst_surf, clear_color,
+                                                                     dst_box.x, dst_box.y,
+                                                                     dst_box.width, dst_box.height,
+                                                                     false);
+                                          break;
+                                       case METHOD_COMPUTE:
                                           success &=
-                                             si_compute_fast_clear_image(sctx, dst_surf->texture,
-                                                                         dst_surf->format, 0,
-                                                                         &dst_box, clear_color,
-                                                                         false, false);
-                                       } else {
-                                          ctx->clear_render_target(ctx, dst_surf, clear_color,
-                                                                   dst_box.x, dst_box.y,
-                                                                   dst_box.width, dst_box.height,
-                                                                   false);
+                                             si_compute_clear_image(sctx, dst_surf->texture,
+                                                                    dst_surf->format, 0, &dst_box,
+                                                                    clear_color, false, false);
+                                          break;
+                                       case METHOD_SPECIAL:
+                                          if (test_flavor == TEST_CLEAR) {
+                                             success &=
+                                                si_compute_fast_clear_image(sctx, dst_surf->texture,
+                                                                            dst_surf->format, 0,
+                                                                            &dst_box, clear_color,
+                                                                            false, false);
+                                          } else {
+                                             ctx->clear_render_target(ctx, dst_surf, clear_color,
+                                                                      dst_box.x, dst_box.y,
+                                                                      dst_box.width, dst_box.height,
+                                                                      false);
+                                          }
+                                          break;
                                        }
                                        break;
-                                    }
-                                    break;
-
-                                 case TEST_COPY:
-                                    switch (method) {
-                                    case METHOD_DEFAULT:
-                                       si_resource_copy_region(ctx, dst[size_factor], 0, dst_box.x,
-                                                               dst_box.y, dst_box.z, src[size_factor],
-                                                               0, &src_box);
-                                       break;
-                                    case METHOD_GFX:
-                                       si_gfx_copy_image(sctx, dst[size_factor], 0, dst_box.x,
-                                                         dst_box.y, dst_box.z, src[size_factor],
-                                                         0, &src_box);
-                                       break;
-                                    case METHOD_COMPUTE:
-                                       success &= si_compute_copy_image(sctx, dst[size_factor], 0,
-                                                                        src[size_factor], 0,
-                                                                        dst_box.x, dst_box.y,
-                                                                        dst_box.z, &src_box, false);
-                                       break;
-                                    case METHOD_SPECIAL:
-                                       success = false;
-                                       break;
-                                    }
-                                    break;
-
-                                 case TEST_BLIT:
-                                 case TEST_RESOLVE: {
-                                    struct pipe_blit_info info;
-                                    memset(&info, 0, sizeof(info));
-                                    info.dst.resource = dst[size_factor];
-                                    info.dst.level = 0;
-                                    info.dst.box = dst_box;
-                                    info.dst.format = templ.format;
-                                    info.src.resource = src[size_factor];
-                                    info.src.level = 0;
-                                    info.src.box = src_box;
-                                    info.src.format = templ.format;
-                                    info.mask = PIPE_MASK_RGBA;
-
-                                    switch (method) {
-                                    case METHOD_DEFAULT:
-                                       ctx->blit(ctx, &info);
-                                       break;
-                                    case METHOD_GFX:
-                                       si_gfx_blit(ctx, &info);
-                                       break;
-                                    case METHOD_COMPUTE:
-                                       success &= si_compute_blit(sctx, &info, NULL, 0, 0, false);
-                                       break;
-                                    case METHOD_SPECIAL:
-                                       if (test_flavor == TEST_BLIT && !yflip) {
+
+                                    case TEST_COPY:
+                                       switch (method) {
+                                       case METHOD_DEFAULT:
                                           si_resource_copy_region(ctx, dst[size_factor], 0, dst_box.x,
                                                                   dst_box.y, dst_box.z, src[size_factor],
                                                                   0, &src_box);
-                                       } else if (test_flavor == TEST_RESOLVE) {
-                                          success &= si_msaa_resolve_blit_via_CB(ctx, &info, false);
-                                       } else {
+                                          break;
+                                       case METHOD_GFX:
+                                          si_gfx_copy_image(sctx, dst[size_factor], 0, dst_box.x,
+                                                            dst_box.y, dst_box.z, src[size_factor],
+                                                            0, &src_box);
+                                          break;
+                                       case METHOD_COMPUTE:
+                                          success &= si_compute_copy_image(sctx, dst[size_factor], 0,
+                                                                           src[size_factor], 0,
+                                                                           dst_box.x, dst_box.y,
+                                                                           dst_box.z, &src_box, false);
+                                          break;
+                                       case METHOD_SPECIAL:
                                           success = false;
+                                          break;
+                                       }
+                                       break;
+
+                                    case TEST_BLIT:
+                                    case TEST_RESOLVE: {
+                                       struct pipe_blit_info info;
+                                       memset(&info, 0, sizeof(info));
+                                       info.dst.resource = dst[size_factor];
+                                       info.dst.level = 0;
+                                       info.dst.box = dst_box;
+                                       info.dst.format = templ.format;
+                                       info.src.resource = src[size_factor];
+                                       info.src.level = 0;
+                                       info.src.box = src_box;
+                                       info.src.format = templ.format;
+                                       info.mask = PIPE_MASK_RGBA;
+
+                                       switch (method) {
+                                       case METHOD_DEFAULT:
+                                          ctx->blit(ctx, &info);
+                                          break;
+                                       case METHOD_GFX:
+                                          si_gfx_blit(ctx, &info);
+                                          break;
+                                       case METHOD_COMPUTE:
+                                          success &= si_compute_blit(sctx, &info, NULL, 0, 0, false);
+                                          break;
+                                       case METHOD_SPECIAL:
+                                          if (test_flavor == TEST_BLIT && !yflip) {
+                                             si_resource_copy_region(ctx, dst[size_factor], 0, dst_box.x,
+                                                                     dst_box.y, dst_box.z, src[size_factor],
+                                                                     0, &src_box);
+                                          } else if (test_flavor == TEST_RESOLVE) {
+                                             success &= si_msaa_resolve_blit_via_CB(ctx, &info, false);
+                                          } else {
+                                             success = false;
+                                          }
+                                          break;
                                        }
                                        break;
                                     }
-                                    break;
-                                 }
+                                    }
                                  }
-                              }
 
-                              ctx->end_query(ctx, q);
-                              pipe_surface_reference(&dst_surf, NULL);
-
-                              /* Wait for idle after all tests. */
-                              sctx->barrier_flags |= SI_BARRIER_SYNC_AND_INV_CB |
-                                                     SI_BARRIER_SYNC_CS |
-                                                     SI_BARRIER_INV_L2 | SI_BARRIER_INV_SMEM |
-                                                     SI_BARRIER_INV_VMEM;
-                              si_emit_barrier_direct(sctx);
-
-                              /* Unbind the colorbuffer. */
-                              if ((test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR) &&
-                                  box_flavor == BOX_FULL) {
-                                 struct pipe_framebuffer_state fb = {0};
-                                 fb.width = 64;
-                                 fb.height = 64;
-                                 fb.layers = 1;
-                                 fb.samples = 1;
-                                 ctx->set_framebuffer_state(ctx, &fb);
-                              }
+                                 ctx->end_query(ctx, q);
+                                 pipe_surface_reference(&dst_surf, NULL);
 
-                              /* Get results. */
-                              if (success) {
-                                 union pipe_query_result result;
-                                 ctx->get_query_result(ctx, q, true, &result);
-                                 ctx->destroy_query(ctx, q);
+                                 /* Wait for idle after all tests. */
+                                 sctx->barrier_flags |= SI_BARRIER_SYNC_AND_INV_CB |
+                                                        SI_BARRIER_SYNC_CS |
+                                                        SI_BARRIER_INV_L2 | SI_BARRIER_INV_SMEM |
+                                                        SI_BARRIER_INV_VMEM;
+                                 si_emit_barrier_direct(sctx);
 
-                                 double sec = (double)result.u64 / (1000 * 1000 * 1000);
-                                 uint64_t pixels_per_surf = num_repeats * dst_box.width *
-                                                            dst_box.height * dst_box.depth;
-                                 uint64_t bytes;
-
-                                 if (test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR)
-                                    bytes = pixels_per_surf * pix_size;
-                                 else if (test_flavor == TEST_RESOLVE)
-                                    bytes = pixels_per_surf * (pix_size + bpe);
-                                 else
-                                    bytes = pixels_per_surf * pix_size * 2;
+                                 /* Unbind the colorbuffer. */
+                                 if ((test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR) &&
+                                     box_flavor == BOX_FULL) {
+                                    struct pipe_framebuffer_state fb = {0};
+                                    fb.width = 64;
+                                    fb.height = 64;
+                                    fb.layers = 1;
+                                    fb.samples = 1;
+                                    ctx->set_framebuffer_state(ctx, &fb);
+                                 }
 
-                                 double bytes_per_sec = bytes / sec;
+                                 /* Get results. */
+                                 if (success) {
+                                    union pipe_query_result result;
+                                    ctx->get_query_result(ctx, q, true, &result);
+                                    ctx->destroy_query(ctx, q);
+
+                                    double sec = (double)result.u64 / (1000 * 1000 * 1000);
+                                    uint64_t pixels_per_surf = num_repeats * dst_box.width *
+                                                               dst_box.height * dst_box.depth;
+                                    uint64_t bytes;
+
+                                    if (test_flavor == TEST_FB_CLEAR || test_flavor == TEST_CLEAR)
+                                       bytes = pixels_per_surf * pix_size;
+                                    else if (test_flavor == TEST_RESOLVE)
+                                       bytes = pixels_per_surf * (pix_size + bpe);
+                                    else
+                                       bytes = pixels_per_surf * pix_size * 2;
+
+                                    double bytes_per_sec = bytes / sec;
+
+                                    results[r] = bytes_per_sec / (1024 * 1024 * 1024);
+                                 } else {
+                                    ctx->destroy_query(ctx, q);
+                                    results[r] = 0;
+                                 }
+                              }
 
-                                 printf(" , %9.2f", bytes_per_sec / (1024 * 1024 * 1024));
+                              si_test_perf_compute_stats(results, num_measurements, &stats);
+
+                              if (json) {
+                                 printf("{\"benchmark\": \"blitperf\", \"gpu\": \"%s\", "
+                                        "\"op\": \"%s\", \"special\": \"%s\", \"dim\": %u, "
+                                        "\"format\": \"%s\", \"samples\": %u, \"layout\": \"%s\", "
+                                        "\"fill\": \"%s\", \"box\": \"%s\", \"size\": \"%s\", "
+                                        "\"method\": \"%s\", ",
+                                        sscreen->info.name, test_strings[test_flavor], special_op,
+                                        dim, util_format_short_name(formats[format_index]), samples,
+                                        layout_strings[layout], fill_strings[fill_flavor],
+                                        box_strings[box_flavor], size_factor ? "large" : "small",
+                                        method_strings[method]);
+                                 si_test_perf_print_json_stats("GBps", &stats);
+                                 printf("}\n");
+                              } else if (stats.count) {
+                                 printf(" , %9.2f", stats.mean);
                               } else {
                                  printf(" ,     n/a  ");
                               }
+                              fflush(stdout);
                            }
                         }
 
-                        printf("\n");
+                        if (!json)
+                           printf("\n");
                      }
                   }
 
@@ -701,6 +744,7 @@ void si_test_blit_perf(struct si_screen *sscreen)
       }
    }
 
+   free(results);
    ctx->destroy(ctx);
    exit(0);
 }
@@ -7,6 +7,9 @@
 #include "si_pipe.h"
 #include "si_query.h"
 #include "util/streaming-load-memcpy.h"
+#include "util/u_debug.h"
+
+#include <math.h>
 
 #define MIN_SIZE   512
 #define MAX_SIZE   (128 * 1024 * 1024)
@@ -111,33 +114,250 @@ static const struct align_info_t align_info[] = {
    [ALIGN_SRC1_DST2] = {"src=1 dst=2", 1, 2},
 };
 
+static const struct debug_named_value test_options[] = {
+   {"fill_vram", BITFIELD_BIT(TEST_FILL_VRAM), "Fill VRAM"},
+   {"fill_vram_12b", BITFIELD_BIT(TEST_FILL_VRAM_12B), "Fill VRAM with a 12-byte value"},
+   {"fill_gtt", BITFIELD_BIT(TEST_FILL_GTT), "Fill GTT"},
+   {"fill_gtt_12b", BITFIELD_BIT(TEST_FILL_GTT_12B), "Fill GTT with a 12-byte value"},
+   {"vram_vram", BITFIELD_BIT(TEST_COPY_VRAM_VRAM), "Copy VRAM to VRAM"},
+   {"vram_gtt", BITFIELD_BIT(TEST_COPY_VRAM_GTT), "Copy VRAM to GTT"},
+   {"gtt_vram", BITFIELD_BIT(TEST_COPY_GTT_VRAM), "Copy GTT to VRAM"},
+   DEBUG_NAMED_VALUE_END
+};
+
+static const struct debug_named_value method_options[] = {
+   {"default", BITFIELD_BIT(METHOD_DEFAULT), "What the driver would use"},
+   {"cpdma", BITFIELD_BIT(METHOD_CP_DMA), "CP DMA"},
+   {"cs2dw", BITFIELD_BIT(METHOD_COMPUTE_2DW), "Compute, 2 dwords per thread"},
+   {"cs3dw", BITFIELD_BIT(METHOD_COMPUTE_3DW), "Compute, 3 dwords per thread"},
+   {"cs4dw", BITFIELD_BIT(METHOD_COMPUTE_4DW), "Compute, 4 dwords per thread"},
+   DEBUG_NAMED_VALUE_END
+};
+
+DEBUG_GET_ONCE_BOOL_OPTION(test_perf_json, "AMD_TEST_PERF_JSON", false)
+DEBUG_GET_ONCE_NUM_OPTION(test_perf_repeats, "AMD_TEST_PERF_REPEATS", 1)
+
+/* Options shared by the performance tests:
+ *    AMD_TEST_PERF_JSON=true    print one JSON object per result instead of a table
+ *    AMD_TEST_PERF_REPEATS=n    measure every result n times and print statistics
+ */
+bool si_test_perf_json(void)
+{
+   return debug_get_option_test_perf_json();
+}
+
+unsigned si_test_perf_num_repeats(void)
+{
+   return CLAMP(debug_get_option_test_perf_repeats(), 1, 1000);
+}
+
+/* Compute the statistics of the non-zero samples. Zero means that the measurement failed. */
+void si_test_perf_compute_stats(const double *samples, unsigned num_samples,
+                                struct si_test_perf_stats *stats)
+{
+   memset(stats, 0, sizeof(*stats));
+
+   for (unsigned i = 0; i < num_samples; i++) {
+      if (samples[i] <= 0)
+         continue;
+
+      stats->min = stats->count ? MIN2(stats->min, samples[i]) : samples[i];
+      stats->max = MAX2(stats->max, samples[i]);
+      stats->mean += samples[i];
+      stats->count++;
+   }
+
+   if (!stats->count)
+      return;
+
+   stats->mean /= stats->count;
+
+   for (unsigned i = 0; i < num_samples; i++) {
+      if (samples[i] > 0)
+         stats->stddev += (samples[i] - stats->mean) * (samples[i] - stats->mean);
+   }
+   stats->stddev = sqrt(stats->stddev / stats->count);
+}
+
+void si_test_perf_print_json_stats(const char *name, const struct si_test_perf_stats *stats)
+{
+   if (stats->count) {
+      printf("\"%s\": {\"mean\": %.4f, \"min\": %.4f, \"max\": %.4f, \"stddev\": %.4f, "
+             "\"runs\": %u}", name, stats->mean, stats->min, stats->max, stats->stddev,
+             stats->count);
+   } else {
+      printf("\"%s\": null", name);
+   }
+}
+
+/* Return the throughput in GB/s, or 0 if the method doesn't support the test. */
+static double measure_dma_perf(struct si_context *sctx, unsigned test_flavor, unsigned method,
+                               unsigned src_offset, unsigned dst_offset, unsigned size,
+                               unsigned clear_value_size, unsigned dwords_per_thread)
+{
+   struct si_screen *sscreen = sctx->screen;
+   struct pipe_screen *screen = &sscreen->b;
+   struct pipe_context *ctx = &sctx->b;
+   bool is_copy = test_flavor >= TEST_COPY_VRAM_VRAM;
+   struct pipe_resource *dst, *src;
+   enum pipe_resource_usage dst_usage = PIPE_USAGE_DEFAULT;
+   enum pipe_resource_usage src_usage = PIPE_USAGE_DEFAULT;
+
+   if (test_flavor == TEST_FILL_GTT || test_flavor == TEST_FILL_GTT_12B ||
+       test_flavor == TEST_COPY_VRAM_GTT)
+      dst_usage = PIPE_USAGE_STREAM;
+
+   if (test_flavor == TEST_COPY_GTT_VRAM)
+      src_usage = PIPE_USAGE_STREAM;
+
+   /* Don't test large sizes with GTT because it's slow. */
+   if ((dst_usage == PIPE_USAGE_STREAM || src_usage == PIPE_USAGE_STREAM) &&
+       size > 16 * 1024 * 1024)
+      return 0;
+
+   dst = pipe_aligned_buffer_create(screen, 0, dst_usage, dst_offset + size, 256);
+   src = is_copy ? pipe_aligned_buffer_create(screen, 0, src_usage, src_offset + size, 256) : NULL;
+
+   struct pipe_query *q = ctx->create_query(ctx, PIPE_QUERY_TIME_ELAPSED, 0);
+   bool success = true;
+
+   /* Run tests. */
+   for (unsigned iter = 0; iter < WARMUP_RUNS + NUM_RUNS; iter++) {
+      const uint32_t clear_value[4] = {0x12345678, 0x23456789, 0x34567890, 0x45678901};
+
+      if (iter == WARMUP_RUNS)
+         ctx->begin_query(ctx, q);
+
+      if (method == METHOD_DEFAULT) {
+         if (is_copy) {
+            si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
+            si_copy_buffer(sctx, dst, src, dst_offset, src_offset, size);
+            si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
+         } else {
+            sctx->b.clear_buffer(&sctx->b, dst, dst_offset, size, &clear_value,
+                                 clear_value_size);
+         }
+      } else if (method == METHOD_CP_DMA) {
+         /* CP DMA */
+         if (sscreen->info.cp_sdma_ge_use_system_memory_scope) {
+            /* The CP DMA code doesn't implement this case. */
+            success = false;
+            continue;
+         }
+
+         if (is_copy) {
+            /* CP DMA copies are about as slow as PCIe on GFX6-8. */
+            if (sctx->gfx_level <= GFX8 && size > 16 * 1024 * 1024) {
+               success = false;
+               continue;
+            }
+
+            si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
+            si_cp_dma_copy_buffer(sctx, dst, src, dst_offset, src_offset, size);
+            si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
+         } else {
+            /* CP DMA clears must be aligned to 4 bytes. */
+            if (dst_offset % 4 || size % 4 ||
+                /* CP DMA clears are so slow on GFX6-8 that we risk getting a GPU timeout. */
+                (sctx->gfx_level <= GFX8 && size > 512 * 1024)) {
+               success = false;
+               continue;
+            }
+
+            assert(clear_value_size == 4);
+            si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
+            si_cp_dma_clear_buffer(sctx, &sctx->gfx_cs, dst, dst_offset, size,
+                                   clear_value[0]);
+            si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
+         }
+      } else {
+         /* Compute */
+         si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
+         success &=
+            si_compute_clear_copy_buffer(sctx, dst, dst_offset, src, src_offset,
+                                         size, clear_value, clear_value_size,
+                                         dwords_per_thread, false, false);
+         si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
+      }
+
+      sctx->barrier_flags |= SI_BARRIER_INV_L2;
+   }
+
+   ctx->end_query(ctx, q);
+
+   pipe_resource_reference(&dst, NULL);
+   pipe_resource_reference(&src, NULL);
+
+   /* Get results. */
+   union pipe_query_result result;
+
+   ctx->get_query_result(ctx, q, true, &result);
+   ctx->destroy_query(ctx, q);
+
+   /* Navi10 and Vega10 sometimes incorrectly return elapsed time of 0 nanoseconds
+    * for very small ops.
+    */
+   if (!success || !result.u64)
+      return 0;
+
+   double GB = 1024.0 * 1024.0 * 1024.0;
+   double seconds = result.u64 / (double)NUM_RUNS / (1000.0 * 1000.0 * 1000.0);
+   return (size / GB) / seconds * (test_flavor == TEST_COPY_VRAM_VRAM ? 2 : 1);
+}
+
+/* Besides AMD_TEST_PERF_*, this supports:
+ *    AMD_TEST_DMA_TESTS=...     comma-separated list of test_options, e.g. "gtt_vram,vram_vram"
+ *    AMD_TEST_DMA_METHODS=...   comma-separated list of method_options
+ *    AMD_TEST_DMA_MIN_SIZE=n    the smallest size in bytes
+ *    AMD_TEST_DMA_MAX_SIZE=n    the largest size in bytes
+ */
 void si_test_dma_perf(struct si_screen *sscreen)
 {
    struct pipe_screen *screen = &sscreen->b;
    struct pipe_context *ctx = screen->context_create(screen, NULL, 0);
    struct si_context *sctx = (struct si_context *)ctx;
+   uint64_t tests = debug_get_flags_option("AMD_TEST_DMA_TESTS", test_options,
+                                           BITFIELD_MASK(NUM_TESTS));
+   uint64_t methods = debug_get_flags_option("AMD_TEST_DMA_METHODS", method_options,
+                                             BITFIELD_MASK(NUM_METHODS));
+   unsigned min_size = util_next_power_of_two(MAX2(debug_get_num_option("AMD_TEST_DMA_MIN_SIZE",
+                                                                        MIN_SIZE), 4));
+   unsigned max_size = MIN2(debug_get_num_option("AMD_TEST_DMA_MAX_SIZE", MAX_SIZE), MAX_SIZE);
+   unsigned num_repeats = si_test_perf_num_repeats();
+   bool json = si_test_perf_json();
+   double *samples = malloc(num_repeats * sizeof(*samples));
+   bool first_test = true;
 
    sscreen->ws->cs_set_pstate(&sctx->gfx_cs, RADEON_CTX_PSTATE_PEAK);
 
-   printf("Test          , Method , Alignment  ,");
-   for (unsigned size = MIN_SIZE; size <= MAX_SIZE; size <<= SIZE_SHIFT) {
-      if (size >= 1024 * 1024)
-         printf("%6uMB,", size / (1024 * 1024));
-      else if (size >= 1024)
-         printf("%6uKB,", size / 1024);
-      else
-         printf(" %6uB,", size);
+   if (!json) {
+      printf("Test          , Method , Alignment  ,");
+      for (unsigned size = min_size; size <= max_size; size <<= SIZE_SHIFT) {
+         if (size >= 1024 * 1024)
+            printf("%6uMB,", size / (1024 * 1024));
+         else if (size >= 1024)
+            printf("%6uKB,", size / 1024);
+         else
+            printf(" %6uB,", size);
+      }
+      printf("\n");
    }
-   printf("\n");
 
    /* Run benchmarks. */
    for (unsigned test_flavor = 0; test_flavor < NUM_TESTS; test_flavor++) {
       bool is_copy = test_flavor >= TEST_COPY_VRAM_VRAM;
 
-      if (test_flavor)
+      if (!(tests & BITFIELD_BIT(test_flavor)))
+         continue;
+
+      if (!first_test && !json)
          puts("");
+      first_test = false;
 
       for (unsigned method = 0; method < NUM_METHODS; method++) {
+         if (!(methods & BITFIELD_BIT(method)))
+            continue;
+
          for (unsigned align = 0; align < NUM_ALIGNMENTS; align++) {
             unsigned dwords_per_thread, clear_value_size;
             unsigned src_offset = align_info[align].src_offset;
@@ -170,124 +390,43 @@ void si_test_dma_perf(struct si_screen *sscreen)
                clear_value_size = dst_offset % 4 ? 1 : 4;
             }
 
-            printf("%-14s, %-7s, %-11s,", test_strings[test_flavor], method_strings[method],
-                   align_info[align].string);
-
-            for (unsigned size = MIN_SIZE; size <= MAX_SIZE; size <<= SIZE_SHIFT) {
-               struct pipe_resource *dst, *src;
-               enum pipe_resource_usage dst_usage = PIPE_USAGE_DEFAULT;
-               enum pipe_resource_usage src_usage = PIPE_USAGE_DEFAULT;
-
-               if (test_flavor == TEST_FILL_GTT || test_flavor == TEST_FILL_GTT_12B ||
-                   test_flavor == TEST_COPY_VRAM_GTT)
-                  dst_usage = PIPE_USAGE_STREAM;
+            if (!json) {
+               printf("%-14s, %-7s, %-11s,", test_strings[test_flavor], method_strings[method],
+                      align_info[align].string);
+            }
 
-               if (test_flavor == TEST_COPY_GTT_VRAM)
-                  src_usage = PIPE_USAGE_STREAM;
+            for (unsigned size = min_size; size <= max_size; size <<= SIZE_SHIFT) {
+               struct si_test_perf_stats stats;
 
-               /* Don't test large sizes with GTT because it's slow. */
-               if ((dst_usage == PIPE_USAGE_STREAM || src_usage == PIPE_USAGE_STREAM) &&
-                   size > 16 * 1024 * 1024) {
-                  printf("%8s,", "n/a");
-                  continue;
+               for (unsigned r = 0; r < num_repeats; r++) {
+                  samples[r] = measure_dma_perf(sctx, test_flavor, method, src_offset,
+                                                dst_offset, size, clear_value_size,
+                                                dwords_per_thread);
                }
-
-               dst = pipe_aligned_buffer_create(screen, 0, dst_usage, dst_offset + size, 256);
-               src = is_copy ? pipe_aligned_buffer_create(screen, 0, src_usage, src_offset + size, 256) : NULL;
-
-               struct pipe_query *q = ctx->create_query(ctx, PIPE_QUERY_TIME_ELAPSED, 0);
-               bool success = true;
-
-               /* Run tests. */
-               for (unsigned iter = 0; iter < WARMUP_RUNS + NUM_RUNS; iter++) {
-                  const uint32_t clear_value[4] = {0x12345678, 0x23456789, 0x34567890, 0x45678901};
-
-                  if (iter == WARMUP_RUNS)
-                     ctx->begin_query(ctx, q);
-
-                  if (method == METHOD_DEFAULT) {
-                     if (is_copy) {
-                        si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
-                        si_copy_buffer(sctx, dst, src, dst_offset, src_offset, size);
-                        si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
-                     } else {
-                        sctx->b.clear_buffer(&sctx->b, dst, dst_offset, size, &clear_value,
-                                             clear_value_size);
-                     }
-                  } else if (method == METHOD_CP_DMA) {
-                     /* CP DMA */
-                     if (sscreen->info.cp_sdma_ge_use_system_memory_scope) {
-                        /* The CP DMA code doesn't implement this case. */
-                        success = false;
-                        continue;
-                     }
-
-                     if (is_copy) {
-                        /* CP DMA copies are about as slow as PCIe on GFX6-8. */
-                        if (sctx->gfx_level <= GFX8 && size > 16 * 1024 * 1024) {
-                           success = false;
-                           continue;
-                        }
-
-                        si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
-                        si_cp_dma_copy_buffer(sctx, dst, src, dst_offset, src_offset, size);
-                        si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
-                     } else {
-                        /* CP DMA clears must be aligned to 4 bytes. */
-                        if (dst_offset % 4 || size % 4 ||
-                            /* CP DMA clears are so slow on GFX6-8 that we risk getting a GPU timeout. */
-                            (sctx->gfx_level <= GFX8 && size > 512 * 1024)) {
-                           success = false;
-                           continue;
-                        }
-
-                        assert(clear_value_size == 4);
-                        si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
-                        si_cp_dma_clear_buffer(sctx, &sctx->gfx_cs, dst, dst_offset, size,
-                                               clear_value[0]);
-                        si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
-                     }
-                  } else {
-                     /* Compute */
-                     si_barrier_before_simple_buffer_op(sctx, 0, dst, src);
-                     success &=
-                        si_compute_clear_copy_buffer(sctx, dst, dst_offset, src, src_offset,
-                                                     size, clear_value, clear_value_size,
-                                                     dwords_per_thread, false, false);
-                     si_barrier_after_simple_buffer_op(sctx, 0, dst, src);
-                  }
-
-                  sctx->barrier_flags |= SI_BARRIER_INV_L2;
-               }
-
-               ctx->end_query(ctx, q);
-
-               pipe_resource_reference(&dst, NULL);
-               pipe_resource_reference(&src, NULL);
-
-               /* Get results. */
-               union pipe_query_result result;
-
-               ctx->get_query_result(ctx, q, true, &result);
-               ctx->destroy_query(ctx, q);
-
-               /* Navi10 and Vega10 sometimes incorrectly return elapsed time of 0 nanoseconds
-                * for very small ops.
-                */
-               if (success && result.u64) {
-                  double GB = 1024.0 * 1024.0 * 1024.0;
-                  double seconds = result.u64 / (double)NUM_RUNS / (1000.0 * 1000.0 * 1000.0);
-                  double GBps = (size / GB) / seconds * (test_flavor == TEST_COPY_VRAM_VRAM ? 2 : 1);
-                  printf("%8.2f,", GBps);
+               si_test_perf_compute_stats(samples, num_repeats, &stats);
+
+               if (json) {
+                  printf("{\"benchmark\": \"dmaperf\", \"gpu\": \"%s\", \"test\": \"%s\", "
+                         "\"method\": \"%s\", \"alignment\": \"%s\", \"size\": %u, ",
+                         sscreen->info.name, test_strings[test_flavor], method_strings[method],
+                         align_info[align].string, size);
+                  si_test_perf_print_json_stats("GBps", &stats);
+                  printf("}\n");
+               } else if (stats.count) {
+                  printf("%8.2f,", stats.mean);
                } else {
                   printf("%8s,", "n/a");
                }
+               fflush(stdout);
             }
-            puts("");
+
+            if (!json)
+               puts("");
          }
       }
    }
 
+   free(samples);
    ctx->destroy(ctx);
    exit(0);
 }
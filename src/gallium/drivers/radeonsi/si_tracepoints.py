@@ -52,6 +52,12 @@ def define_tracepoints(args):
                           Arg(type='uint32_t', var='group_z', c_format='%u'),],
                  tp_print=['group=%ux%ux%u', '__entry->group_x', '__entry->group_y', '__entry->group_z'])
 
+    # GL string markers, each one lasts until the next one
+    begin_end_tp('marker',
+                 tp_args=[Arg(type='unsigned', var='len'),
+                          Arg(type='str', var='str', c_format='%s', length_arg='len + 1', copy_func='strncpy'),],
+                 tp_struct=[Arg(type='uint8_t', name='dummy', var='0'),])
+
 def generate_code(args):
     from u_trace import utrace_generate
     from u_trace import utrace_generate_perfetto_utils
@@ -6,6 +6,7 @@
 
 #include "si_utrace.h"
 #include "si_perfetto.h"
+#include "si_tracepoints.h"
 #include "amd/common/ac_gpu_info.h"
 
 #include "util/u_trace_gallium.h"
@@ -66,6 +67,7 @@ void si_utrace_init(struct si_context *sctx)
                              si_utrace_delete_flush_data);
 
    si_ds_device_init_queue(&sctx->ds, &sctx->ds_queue, "%s", "render");
+   sctx->trace_draws = true;
 }
 
 void si_utrace_fini(struct si_context *sctx)
@@ -79,3 +81,30 @@ void si_utrace_flush(struct si_context *sctx, uint64_t submission_id)
    si_ds_flush_data_init(flush_data, &sctx->ds_queue, submission_id);
    u_trace_flush(&sctx->trace, flush_data, U_TRACE_FRAME_UNKNOWN, false);
 }
+
+void si_utrace_end_frame(struct si_context *sctx)
+{
+   unsigned interval = MAX2(sctx->screen->options.gpu_trace_frame_interval, 1);
+
+   sctx->trace_draws = ++sctx->trace_frame_nr % interval == 0;
+}
+
+/* Close the event of the previous marker and open one for this marker. All draws
+ * and dispatches until the next marker fall into its event in the timeline.
+ */
+void si_utrace_string_marker(struct si_context *sctx, const char *string, int len)
+{
+   if (sctx->trace_marker_open) {
+      trace_si_end_marker(&sctx->trace, sctx->trace_marker_len, sctx->trace_marker);
+      sctx->trace_marker_open = false;
+   }
+
+   if (!sctx->trace_draws || !u_trace_perfetto_active(&sctx->ds.trace_context))
+      return;
+
+   sctx->trace_marker_len = MIN2(len, sizeof(sctx->trace_marker) - 1);
+   memcpy(sctx->trace_marker, string, sctx->trace_marker_len);
+   sctx->trace_marker[sctx->trace_marker_len] = 0;
+   sctx->trace_marker_open = true;
+   trace_si_begin_marker(&sctx->trace);
+}
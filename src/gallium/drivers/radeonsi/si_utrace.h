@@ -14,5 +14,7 @@ void si_utrace_init(struct si_context *sctx);
 void si_utrace_fini(struct si_context *sctx);
 
 void si_utrace_flush(struct si_context *sctx, uint64_t submission_id);
+void si_utrace_end_frame(struct si_context *sctx);
+void si_utrace_string_marker(struct si_context *sctx, const char *string, int len);
 
 #endif
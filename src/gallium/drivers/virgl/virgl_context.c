@@ -413,6 +413,10 @@ static void virgl_bind_blend_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (unsigned long)blend_state;
+
+   if (vctx->bound_blend == handle)
+      return;
+   vctx->bound_blend = handle;
    virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_BLEND);
 }
 
@@ -421,6 +425,8 @@ static void virgl_delete_blend_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (unsigned long)blend_state;
+   if (vctx->bound_blend == handle)
+      vctx->bound_blend = 0;
    virgl_encode_delete_object(vctx, handle, VIRGL_OBJECT_BLEND);
 }
 
@@ -440,6 +446,10 @@ static void virgl_bind_depth_stencil_alpha_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (unsigned long)blend_state;
+
+   if (vctx->bound_dsa == handle)
+      return;
+   vctx->bound_dsa = handle;
    virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_DSA);
 }
 
@@ -448,6 +458,8 @@ static void virgl_delete_depth_stencil_alpha_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    uint32_t handle = (unsigned long)dsa_state;
+   if (vctx->bound_dsa == handle)
+      vctx->bound_dsa = 0;
    virgl_encode_delete_object(vctx, handle, VIRGL_OBJECT_DSA);
 }
 
@@ -479,6 +491,10 @@ static void virgl_bind_rasterizer_state(struct pipe_context *ctx,
       vctx->rs_state = *vrs;
       handle = vrs->handle;
    }
+
+   if (vctx->bound_rasterizer == handle)
+      return;
+   vctx->bound_rasterizer = handle;
    virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_RASTERIZER);
 }
 
@@ -487,6 +503,8 @@ static void virgl_delete_rasterizer_state(struct pipe_context *ctx,
 {
    struct virgl_context *vctx = virgl_context(ctx);
    struct virgl_rasterizer_state *vrs = rs_state;
+   if (vctx->bound_rasterizer == vrs->handle)
+      vctx->bound_rasterizer = 0;
    virgl_encode_delete_object(vctx, vrs->handle, VIRGL_OBJECT_RASTERIZER);
    FREE(vrs);
 }
@@ -91,6 +91,9 @@ struct virgl_context {
    bool vertex_array_dirty;
 
    struct virgl_rasterizer_state rs_state;
+
+   /* Handles bound on the host, which keeps them across submits. */
+   uint32_t bound_blend, bound_dsa, bound_rasterizer;
    struct virgl_so_target so_targets[PIPE_MAX_SO_BUFFERS];
    unsigned num_so_targets;
 
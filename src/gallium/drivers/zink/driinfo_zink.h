@@ -8,6 +8,7 @@ DRI_CONF_SECTION_END
 DRI_CONF_SECTION_PERFORMANCE
 DRI_CONF_MESA_GLTHREAD_DRIVER(true)
 DRI_CONF_OPT_B(zink_shader_object_enable, false, "Enable support for EXT_shader_object")
+DRI_CONF_OPT_I(zink_frame_latency, 0, 0, 16, "Maximum number of frames queued for presentation, 0 leaves it to the swapchain")
 DRI_CONF_SECTION_END
 
 DRI_CONF_SECTION_QUALITY
@@ -5038,6 +5038,11 @@ nir_to_spirv(struct nir_shader *s, const struct zink_shader_info *sinfo, const s
    }
    ctx.num_defs = entry->ssa_alloc;
 
+   /* Most defs become one instruction of a handful of words, so this avoids
+    * regrowing the instruction buffer over and over for big shaders.
+    */
+   spirv_builder_reserve_instructions(&ctx.builder, entry->ssa_alloc * 6);
+
    SpvId *block_ids = ralloc_array_size(ctx.mem_ctx,
                                         sizeof(SpvId), entry->num_blocks);
    if (!block_ids)
@@ -57,7 +57,7 @@ static inline bool
 spirv_buffer_prepare(struct spirv_buffer *b, void *mem_ctx, size_t needed)
 {
    needed += b->num_words;
-   if (b->room >= b->num_words + needed)
+   if (b->room >= needed)
       return true;
 
    return spirv_buffer_grow(b, mem_ctx, needed);
@@ -1829,6 +1829,12 @@ spirv_builder_get_words(struct spirv_builder *b, uint32_t *words,
    return written;
 }
 
+void
+spirv_builder_reserve_instructions(struct spirv_builder *b, size_t num_words)
+{
+   spirv_buffer_prepare(&b->instructions, b->mem_ctx, num_words);
+}
+
 void
 spirv_builder_begin_local_vars(struct spirv_builder *b)
 {
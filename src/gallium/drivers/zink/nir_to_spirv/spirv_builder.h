@@ -500,5 +500,7 @@ spirv_builder_emit_vertex(struct spirv_builder *b, uint32_t stream, bool multist
 void
 spirv_builder_end_primitive(struct spirv_builder *b, uint32_t stream, bool multistream);
 void
+spirv_builder_reserve_instructions(struct spirv_builder *b, size_t num_words);
+void
 spirv_builder_begin_local_vars(struct spirv_builder *b);
 #endif
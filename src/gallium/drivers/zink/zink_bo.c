@@ -34,6 +34,7 @@
 #include "zink_resource.h"
 #include "zink_screen.h"
 #include "util/u_hash_table.h"
+#include "util/vma.h"
 
 #ifdef HAVE_LIBDRM
 #define ZINK_USE_DMABUF
@@ -192,6 +193,169 @@ bo_slab_destroy(struct zink_screen *screen, struct pb_buffer *pbuf)
       pb_slab_free(get_slabs(screen, bo->base.base.size, 0), &bo->u.slab.entry);
 }
 
+/*
+ * Buffers between the largest slab entry and ZINK_MID_MAX_SIZE would otherwise
+ * each get their own VkDeviceMemory, which quickly runs into maxMemoryAllocationCount
+ * on some hosts. Instead, they are suballocated from ZINK_MID_BLOCK_SIZE blocks
+ * with a first-fit range allocator; freed ranges are reclaimed once the gpu is idle.
+ */
+#define ZINK_MID_MAX_SIZE (4 * 1024 * 1024)
+#define ZINK_MID_BLOCK_SIZE (32 * 1024 * 1024)
+
+struct zink_bo_block {
+   struct list_head link;
+   struct zink_bo *buffer;
+   /* offsets are biased by ZINK_MID_BLOCK_SIZE since util_vma_heap can't return 0 */
+   struct util_vma_heap heap;
+   unsigned num_allocs;
+};
+
+static void
+bo_mid_free(struct zink_screen *screen, struct zink_bo *bo)
+{
+   struct zink_bo_block *block = bo->u.slab.block;
+
+   util_vma_heap_free(&block->heap, bo->offset - block->buffer->offset + ZINK_MID_BLOCK_SIZE, bo->u.slab.alloc_size);
+   screen->pb.mid.used -= bo->base.base.size;
+   if (!--block->num_allocs) {
+      list_del(&block->link);
+      util_vma_heap_finish(&block->heap);
+      screen->pb.mid.allocated -= block->buffer->base.base.size;
+      zink_bo_unref(screen, block->buffer);
+      FREE(block);
+   }
+   simple_mtx_destroy(&bo->lock);
+   FREE(bo);
+}
+
+/* called with the mid lock held */
+static unsigned
+bo_mid_reclaim(struct zink_screen *screen, bool force)
+{
+   unsigned num_reclaims = 0;
+   list_for_each_entry_safe(struct zink_bo, bo, &screen->pb.mid.reclaim, u.slab.entry.head) {
+      if (!force && !bo_can_reclaim(screen, &bo->base))
+         continue;
+      list_del(&bo->u.slab.entry.head);
+      bo_mid_free(screen, bo);
+      num_reclaims++;
+   }
+   return num_reclaims;
+}
+
+static void
+bo_mid_destroy(struct zink_screen *screen, struct pb_buffer *pbuf)
+{
+   struct zink_bo *bo = zink_bo(pbuf);
+
+   assert(!bo->mem && bo->u.slab.block);
+   simple_mtx_lock(&screen->pb.mid.lock);
+   if (bo_can_reclaim(screen, pbuf))
+      bo_mid_free(screen, bo);
+   else
+      list_addtail(&bo->u.slab.entry.head, &screen->pb.mid.reclaim);
+   simple_mtx_unlock(&screen->pb.mid.lock);
+}
+
+static const struct pb_vtbl bo_mid_vtbl = {
+   /* Cast to void* because one of the function parameters is a struct pointer instead of void*. */
+   (void*)bo_mid_destroy
+   /* other functions are never called */
+};
+
+static struct zink_bo_block *
+bo_mid_block_create(struct zink_screen *screen, unsigned mem_type_idx)
+{
+   struct zink_bo_block *block = CALLOC_STRUCT(zink_bo_block);
+   if (!block)
+      return NULL;
+   enum zink_heap heap = zink_heap_from_domain_flags(screen->info.mem_props.memoryTypes[mem_type_idx].propertyFlags, 0);
+   block->buffer = zink_bo(zink_bo_create(screen, ZINK_MID_BLOCK_SIZE, 64 * 1024, heap, ZINK_ALLOC_NO_SUBALLOC, mem_type_idx, NULL));
+   if (!block->buffer) {
+      FREE(block);
+      return NULL;
+   }
+   util_vma_heap_init(&block->heap, ZINK_MID_BLOCK_SIZE, block->buffer->base.base.size);
+   block->heap.alloc_high = false;
+   return block;
+}
+
+static struct zink_bo *
+bo_mid_create(struct zink_screen *screen, uint64_t size, unsigned alignment, unsigned mem_type_idx)
+{
+   /* buffers and images may share a block */
+   alignment = MAX2(alignment, screen->info.props.limits.bufferImageGranularity);
+   alignment = MAX2(alignment, 4096);
+   uint64_t alloc_size = align64(size, alignment);
+   uint64_t offset = 0;
+   struct zink_bo_block *block = NULL;
+
+   simple_mtx_lock(&screen->pb.mid.lock);
+   bo_mid_reclaim(screen, false);
+   list_for_each_entry(struct zink_bo_block, b, &screen->pb.mid.blocks[mem_type_idx], link) {
+      offset = util_vma_heap_alloc(&b->heap, alloc_size, alignment);
+      if (offset) {
+         block = b;
+         break;
+      }
+   }
+   if (!block) {
+      /* creating the block may need to clean up the buffer managers, which takes the lock */
+      simple_mtx_unlock(&screen->pb.mid.lock);
+      block = bo_mid_block_create(screen, mem_type_idx);
+      simple_mtx_lock(&screen->pb.mid.lock);
+      if (block) {
+         list_addtail(&block->link, &screen->pb.mid.blocks[mem_type_idx]);
+         screen->pb.mid.allocated += block->buffer->base.base.size;
+         offset = util_vma_heap_alloc(&block->heap, alloc_size, alignment);
+      }
+   }
+   struct zink_bo *bo = offset ? CALLOC_STRUCT(zink_bo) : NULL;
+   if (!bo) {
+      if (offset)
+         util_vma_heap_free(&block->heap, offset, alloc_size);
+      simple_mtx_unlock(&screen->pb.mid.lock);
+      return NULL;
+   }
+   block->num_allocs++;
+   screen->pb.mid.used += size;
+   simple_mtx_unlock(&screen->pb.mid.lock);
+
+   simple_mtx_init(&bo->lock, mtx_plain);
+   pipe_reference_init(&bo->base.base.reference, 1);
+   bo->base.base.alignment_log2 = util_logbase2(alignment);
+   bo->base.base.size = size;
+   bo->base.base.placement = mem_type_idx;
+   bo->base.vtbl = &bo_mid_vtbl;
+   bo->offset = block->buffer->offset + offset - ZINK_MID_BLOCK_SIZE;
+   bo->u.slab.real = block->buffer;
+   bo->u.slab.block = block;
+   bo->u.slab.alloc_size = alloc_size;
+   bo->unique_id = p_atomic_inc_return(&screen->pb.next_bo_unique_id);
+   return bo;
+}
+
+/* for the HUD: the block memory not handed out to live allocations, and how much of
+ * the free space isn't usable for the largest allocation in percent
+ */
+void
+zink_bo_get_suballoc_stats(struct zink_screen *screen, uint64_t *allocated, uint64_t *wasted, unsigned *fragmentation)
+{
+   uint64_t free_size = 0, max_free = 0;
+
+   simple_mtx_lock(&screen->pb.mid.lock);
+   *allocated = screen->pb.mid.allocated;
+   *wasted = screen->pb.mid.allocated - screen->pb.mid.used;
+   for (unsigned i = 0; i < screen->info.mem_props.memoryTypeCount; i++) {
+      list_for_each_entry(struct zink_bo_block, block, &screen->pb.mid.blocks[i], link) {
+         free_size += block->heap.free_size;
+         max_free = MAX2(max_free, util_vma_heap_get_max_free_continuous_size(&block->heap));
+      }
+   }
+   simple_mtx_unlock(&screen->pb.mid.lock);
+   *fragmentation = free_size ? (free_size - max_free) * 100 / free_size : 0;
+}
+
 static bool
 clean_up_buffer_managers(struct zink_screen *screen)
 {
@@ -202,6 +366,10 @@ clean_up_buffer_managers(struct zink_screen *screen)
          //pb_slabs_reclaim(&screen->bo_slabs_encrypted[i]);
    }
 
+   simple_mtx_lock(&screen->pb.mid.lock);
+   num_reclaims += bo_mid_reclaim(screen, false);
+   simple_mtx_unlock(&screen->pb.mid.lock);
+
    num_reclaims += pb_cache_release_all_buffers(&screen->pb.bo_cache);
    return !!num_reclaims;
 }
@@ -653,6 +821,16 @@ no_slab:
       return bo_sparse_create(screen, size);
    }
 
+   /* blocks would take up too much of a small BAR */
+   if (!(flags & ZINK_ALLOC_NO_SUBALLOC) && !pNext && size <= ZINK_MID_MAX_SIZE &&
+       heap >= 0 && heap < ZINK_HEAP_MAX && (heap != ZINK_HEAP_DEVICE_LOCAL_VISIBLE || screen->resizable_bar)) {
+      bo = bo_mid_create(screen, size, alignment, mem_type_idx);
+      if (!bo && clean_up_buffer_managers(screen))
+         bo = bo_mid_create(screen, size, alignment, mem_type_idx);
+      if (bo)
+         return &bo->base;
+   }
+
    /* Align size to page size. This is the minimum alignment for normal
     * BOs. Aligning this here helps the cached bufmgr. Especially small BOs,
     * like constant/uniform buffers, can benefit from better and more reuse.
@@ -1370,6 +1548,11 @@ zink_bo_init(struct zink_screen *screen)
       min_slab_order = max_order + 1;
    }
    screen->pb.min_alloc_size = 1 << screen->pb.bo_slabs[0].min_order;
+
+   simple_mtx_init(&screen->pb.mid.lock, mtx_plain);
+   for (unsigned i = 0; i < ARRAY_SIZE(screen->pb.mid.blocks); i++)
+      list_inithead(&screen->pb.mid.blocks[i]);
+   list_inithead(&screen->pb.mid.reclaim);
    return true;
 }
 
@@ -1380,5 +1563,9 @@ zink_bo_deinit(struct zink_screen *screen)
       if (screen->pb.bo_slabs[i].groups)
          pb_slabs_deinit(&screen->pb.bo_slabs[i]);
    }
+   simple_mtx_lock(&screen->pb.mid.lock);
+   bo_mid_reclaim(screen, true);
+   simple_mtx_unlock(&screen->pb.mid.lock);
+   simple_mtx_destroy(&screen->pb.mid.lock);
    pb_cache_deinit(&screen->pb.bo_cache);
 }
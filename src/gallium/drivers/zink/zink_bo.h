@@ -110,6 +110,9 @@ zink_bo_init(struct zink_screen *screen);
 void
 zink_bo_deinit(struct zink_screen *screen);
 
+void
+zink_bo_get_suballoc_stats(struct zink_screen *screen, uint64_t *allocated, uint64_t *wasted, unsigned *fragmentation);
+
 struct pb_buffer *
 zink_bo_create(struct zink_screen *screen, uint64_t size, unsigned alignment, enum zink_heap heap, enum zink_alloc_flag flags, unsigned mem_type_idx, const void *pNext);
 
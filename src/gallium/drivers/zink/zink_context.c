@@ -3196,6 +3196,10 @@ zink_batch_no_rp_safe(struct zink_context *ctx)
 {
    if (!ctx->in_rp)
       return;
+   /* commands recorded while ending the renderpass must not be reordered against queued barriers */
+   const unsigned barrier_depth = ctx->pending_barriers.depth;
+   zink_flush_pending_barriers(ctx);
+   ctx->pending_barriers.depth = 0;
    if (ctx->render_condition.query)
       zink_stop_conditional_render(ctx);
    /* suspend all queries that were started in a renderpass
@@ -3210,6 +3214,7 @@ zink_batch_no_rp_safe(struct zink_context *ctx)
       ctx->in_rp = false;
    }
    assert(!ctx->in_rp);
+   ctx->pending_barriers.depth = barrier_depth;
 }
 
 void
@@ -5406,6 +5411,7 @@ zink_context_create(struct pipe_screen *pscreen, void *priv, unsigned flags)
    _mesa_set_init(&ctx->update_barriers[1][1], ctx, _mesa_hash_pointer, _mesa_key_pointer_equal);
    ctx->need_barriers[0] = &ctx->update_barriers[0][0];
    ctx->need_barriers[1] = &ctx->update_barriers[1][0];
+   util_dynarray_init(&ctx->pending_barriers.imbs, ctx);
 
    slab_create_child(&ctx->transfer_pool, &screen->transfer_pool);
    slab_create_child(&ctx->transfer_pool_unsync, &screen->transfer_pool);
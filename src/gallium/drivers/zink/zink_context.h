@@ -126,6 +126,12 @@ zink_resource_image_barrier(struct zink_context *ctx, struct zink_resource *res,
                       VkImageLayout new_layout, VkAccessFlags flags, VkPipelineStageFlags pipeline);
 void
 zink_resource_image_barrier2(struct zink_context *ctx, struct zink_resource *res, VkImageLayout new_layout, VkAccessFlags flags, VkPipelineStageFlags pipeline);
+void
+zink_flush_pending_barriers(struct zink_context *ctx);
+void
+zink_batch_barriers_begin(struct zink_context *ctx);
+void
+zink_batch_barriers_end(struct zink_context *ctx);
 bool
 zink_check_unordered_transfer_access(struct zink_resource *res, unsigned level, const struct pipe_box *box);
 bool
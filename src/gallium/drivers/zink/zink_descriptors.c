@@ -1064,6 +1064,7 @@ reinit_db(struct zink_screen *screen, struct zink_batch_state *bs)
 {
    zink_batch_descriptor_deinit(screen, bs);
    zink_batch_descriptor_init(screen, bs);
+   bs->dd.db_epoch++;
 }
 
 static void
@@ -1172,6 +1173,14 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, bool is_compute,
       assert(type + 1 < pg->num_dsl);
       assert(type < ZINK_DESCRIPTOR_BASE_TYPES);
       bool changed = (changed_sets & BITFIELD_BIT(type)) > 0;
+      if (changed && pg->dd.db_last[type].bs == bs && pg->dd.db_last[type].db_epoch == bs->dd.db_epoch &&
+          pg->dd.db_last[type].state_gen == ctx->dd.state_gen[is_compute][type]) {
+         /* only flagged because another program was in use: the descriptors this program
+          * wrote last time are still in this batch's buffer, so rebind them by offset
+          */
+         bs->dd.cur_db_offset[type] = pg->dd.db_last[type].offset;
+         changed = false;
+      }
       uint64_t offset = changed ? bs->dd.db_offset : bs->dd.cur_db_offset[type];
       if (pg->dd.db_template[type] && changed) {
          const struct zink_descriptor_layout_key *key = pg->dd.pool_key[type]->layout;
@@ -1215,6 +1224,10 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, bool is_compute,
          }
          bs->dd.cur_db_offset[type] = bs->dd.db_offset;
          bs->dd.db_offset += pg->dd.db_size[type];
+         pg->dd.db_last[type].bs = bs;
+         pg->dd.db_last[type].db_epoch = bs->dd.db_epoch;
+         pg->dd.db_last[type].state_gen = ctx->dd.state_gen[is_compute][type];
+         pg->dd.db_last[type].offset = offset;
       }
       /* templates are indexed by the set id, so increment type by 1
          * (this is effectively an optimization of indirecting through screen->desc_set_id)
@@ -1465,8 +1478,10 @@ zink_context_invalidate_descriptor_state(struct zink_context *ctx, gl_shader_sta
 {
    if (type == ZINK_DESCRIPTOR_TYPE_UBO && !start)
       ctx->dd.push_state_changed[shader == MESA_SHADER_COMPUTE] = true;
-   else
+   else {
       ctx->dd.state_changed[shader == MESA_SHADER_COMPUTE] |= BITFIELD_BIT(type);
+      ctx->dd.state_gen[shader == MESA_SHADER_COMPUTE][type]++;
+   }
 }
 void
 zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, gl_shader_stage shader, enum zink_descriptor_type type, unsigned start, unsigned count)
@@ -1477,6 +1492,7 @@ zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, gl_sh
       if (type > ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW)
          type -= ZINK_DESCRIPTOR_COMPACT;
       ctx->dd.state_changed[shader == MESA_SHADER_COMPUTE] |= BITFIELD_BIT(type);
+      ctx->dd.state_gen[shader == MESA_SHADER_COMPUTE][type]++;
    }
 }
 
@@ -1535,6 +1551,7 @@ zink_batch_descriptor_reset(struct zink_screen *screen, struct zink_batch_state
 {
    if (zink_descriptor_mode == ZINK_DESCRIPTOR_MODE_DB) {
       bs->dd.db_offset = 0;
+      bs->dd.db_epoch++;
       if (bs->dd.db && bs->dd.db->base.b.width0 < bs->ctx->dd.db.max_db_size * screen->base_descriptor_size)
          reinit_db(screen, bs);
       bs->dd.db_bound = false;
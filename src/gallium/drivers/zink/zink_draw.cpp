@@ -417,6 +417,8 @@ zink_draw(struct pipe_context *pctx,
       }
    }
 
+   /* coalesce all the draw-time barriers below into a single vkCmdPipelineBarrier2 */
+   zink_batch_barriers_begin(ctx);
    barrier_draw_buffers(ctx, dinfo, dindirect, index_buffer);
    /* this may re-emit draw buffer barriers, but such synchronization is harmless */
    if (!ctx->blitting)
@@ -433,6 +435,7 @@ zink_draw(struct pipe_context *pctx,
       if (!ctx->unordered_blitting)
          res->obj->unordered_read = false;
    }
+   zink_batch_barriers_end(ctx);
 
    zink_query_update_gs_states(ctx);
 
@@ -1038,6 +1041,7 @@ zink_launch_grid(struct pipe_context *pctx, const struct pipe_grid_info *info)
    if (ctx->render_condition_active)
       zink_start_conditional_render(ctx);
 
+   zink_batch_barriers_begin(ctx);
    if (info->indirect) {
       /*
          VK_ACCESS_INDIRECT_COMMAND_READ_BIT specifies read access to indirect command data read as
@@ -1050,6 +1054,7 @@ zink_launch_grid(struct pipe_context *pctx, const struct pipe_grid_info *info)
    }
 
    zink_update_barriers(ctx, true, NULL, info->indirect, NULL);
+   zink_batch_barriers_end(ctx);
    if (ctx->memory_barrier)
       zink_flush_memory_barrier(ctx, true);
 
@@ -23,6 +23,7 @@
  */
 
 #include "util/detect_os.h"
+#include "util/os_time.h"
 
 #include "zink_context.h"
 #include "zink_screen.h"
@@ -811,6 +812,46 @@ out:
    free(cpi);
 }
 
+static bool
+has_present_wait(struct zink_screen *screen)
+{
+   return screen->info.have_KHR_present_id && screen->info.have_KHR_present_wait;
+}
+
+/* low latency mode: don't queue another present until the one zink_frame_latency
+ * presents back has been displayed, or at least taken by the presentation engine
+ * if present ids aren't available
+ */
+static void
+kopper_pace_present(struct zink_screen *screen, struct kopper_displaytarget *cdt)
+{
+   struct kopper_swapchain *cswap = cdt->swapchain;
+   unsigned latency = screen->driconf.frame_latency;
+
+   if (!latency)
+      return;
+
+   if (!has_present_wait(screen)) {
+      /* async presents are in order, so waiting for the last one drains the queue */
+      if (cdt->async && p_atomic_read_relaxed(&cswap->async_presents) >= latency)
+         util_queue_fence_wait(&cswap->present_fence);
+      return;
+   }
+
+   if (cswap->present_id < latency)
+      return;
+
+   uint64_t id = cswap->present_id + 1 - latency;
+   /* a window that isn't visible may never display anything, don't stall on it forever */
+   VkResult ret = VKSCR(WaitForPresentKHR)(screen->dev, cswap->swapchain, id, 100 * 1000 * 1000);
+   if (ret != VK_SUCCESS)
+      return;
+
+   int64_t latency_ns = os_time_get_nano() - cswap->present_queued[id % ARRAY_SIZE(cswap->present_queued)];
+   uint64_t avg = p_atomic_read_relaxed(&screen->present_latency_ns);
+   p_atomic_set(&screen->present_latency_ns, avg ? (avg * 7 + latency_ns) / 8 : latency_ns);
+}
+
 void
 zink_kopper_present_queue(struct zink_screen *screen, struct zink_resource *res, unsigned nrects, struct pipe_box *boxes)
 {
@@ -866,6 +907,16 @@ zink_kopper_present_queue(struct zink_screen *screen, struct zink_resource *res,
       }
       cpi->info.pNext = &cpi->rinfo;
    }
+   kopper_pace_present(screen, cdt);
+   if (has_present_wait(screen)) {
+      cpi->id = ++cdt->swapchain->present_id;
+      cdt->swapchain->present_queued[cpi->id % ARRAY_SIZE(cdt->swapchain->present_queued)] = os_time_get_nano();
+      cpi->idinfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+      cpi->idinfo.pNext = cpi->info.pNext;
+      cpi->idinfo.swapchainCount = 1;
+      cpi->idinfo.pPresentIds = &cpi->id;
+      cpi->info.pNext = &cpi->idinfo;
+   }
    /* Ex GLX_EXT_buffer_age:
     *
     *  Buffers' ages are initialized to 0 at buffer creation time.
@@ -39,6 +39,9 @@ struct zink_batch_usage;
 /* number of times a swapchain can be read without forcing readback mode */
 #define ZINK_READBACK_THRESHOLD 3
 
+/* upper bound of zink_frame_latency */
+#define ZINK_MAX_FRAME_LATENCY 16
+
 struct kopper_swapchain_image {
    bool init;
    bool readback_needs_update;
@@ -64,6 +67,9 @@ struct kopper_swapchain {
    unsigned max_acquires;
    unsigned async_presents;
    struct util_queue_fence present_fence;
+   /* VK_KHR_present_id of the last queued present, and when each was queued */
+   uint64_t present_id;
+   int64_t present_queued[ZINK_MAX_FRAME_LATENCY + 1];
    struct zink_batch_usage *batch_uses;
    struct kopper_swapchain_image *images;
 };
@@ -107,6 +113,8 @@ struct zink_kopper_present_info {
    VkPresentRegionsKHR rinfo;
    VkPresentRegionKHR region;
    VkRectLayerKHR regions[64];
+   VkPresentIdKHR idinfo;
+   uint64_t id;
    uint32_t image;
    struct kopper_swapchain *swapchain;
    struct zink_resource *res;
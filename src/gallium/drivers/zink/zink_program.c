@@ -2200,12 +2200,69 @@ gfx_program_precompile_job(void *data, void *gdata, int thread_index)
    zink_screen_get_pipeline_cache(screen, &prog->base, true);
    if (!screen->info.have_EXT_shader_object) {
       simple_mtx_lock(&prog->libs->lock);
-      zink_create_pipeline_lib(screen, prog, &state);
+      struct zink_gfx_library_key *gkey = zink_create_pipeline_lib(screen, prog, &state);
       simple_mtx_unlock(&prog->libs->lock);
+      /* eager mode: link the optimized pipelines now so that the draw-time
+       * cache-only lookup in zink_get_gfx_pipeline() hits instead of fast-linking
+       */
+      for (unsigned i = 0; gkey && i < prog->num_precompile_inputs; i++) {
+         VkPipeline pipeline = zink_create_gfx_pipeline_combined(screen, prog, prog->precompile_inputs[i], &gkey->pipeline, 1,
+                                                                 prog->precompile_output, true, false);
+         if (pipeline)
+            VKSCR(DestroyPipeline)(screen->dev, pipeline, NULL);
+      }
    }
    zink_screen_update_pipeline_cache(screen, &prog->base, true);
 }
 
+/* gather the partial pipelines the current state would use for the common topology classes:
+ * only possible with dynamic vertex input, where the input library depends on nothing but the topology
+ */
+static void
+gfx_program_init_eager_precompile(struct zink_context *ctx, struct zink_gfx_program *prog)
+{
+   struct zink_screen *screen = zink_screen(ctx->base.screen);
+   if (prog->base.uses_shobj || screen->driver_workarounds.disable_optimized_compile ||
+       !screen->info.have_EXT_graphics_pipeline_library || !screen->info.have_EXT_extended_dynamic_state3 ||
+       !screen->info.have_EXT_vertex_input_dynamic_state || !ctx->gfx_pipeline_state.uses_dynamic_stride ||
+       zink_debug & ZINK_DEBUG_NOOPT)
+      return;
+   /* same as zink_can_use_pipeline_libs() for the parts not owned by the program */
+   if (ctx->gfx_pipeline_state.render_pass || ctx->gfx_pipeline_state.force_persample_interp ||
+       ctx->gfx_pipeline_state.min_samples || ctx->fb_state.viewmask || ctx->is_generated_gs_bound)
+      return;
+
+   static const enum mesa_prim modes[] = {MESA_PRIM_POINTS, MESA_PRIM_LINES, MESA_PRIM_TRIANGLES};
+   const enum mesa_prim *prims = modes;
+   unsigned num_prims = ARRAY_SIZE(modes);
+   if (prog->shaders[MESA_SHADER_TESS_CTRL]) {
+      static const enum mesa_prim patches = MESA_PRIM_PATCHES;
+      prims = &patches;
+      num_prims = 1;
+   } else if (screen->info.dynamic_state3_props.dynamicPrimitiveTopologyUnrestricted) {
+      /* a single pipeline for every topology */
+      prims = &modes[2];
+      num_prims = 1;
+   }
+
+   const unsigned saved_idx = ctx->gfx_pipeline_state.idx;
+   for (unsigned i = 0; i < num_prims; i++) {
+      ctx->gfx_pipeline_state.idx = screen->info.dynamic_state3_props.dynamicPrimitiveTopologyUnrestricted ?
+                                    0 : get_primtype_idx(prims[i]);
+      struct zink_gfx_input_key *ikey = zink_find_or_create_input_dynamic(ctx, zink_primitive_topology(prims[i]));
+      if (ikey->pipeline)
+         prog->precompile_inputs[prog->num_precompile_inputs++] = ikey->pipeline;
+   }
+   ctx->gfx_pipeline_state.idx = saved_idx;
+
+   struct zink_gfx_output_key *okey = screen->have_full_ds3 ?
+                                      zink_find_or_create_output_ds3(ctx) :
+                                      zink_find_or_create_output(ctx);
+   prog->precompile_output = okey->pipeline;
+   if (!prog->precompile_output)
+      prog->num_precompile_inputs = 0;
+}
+
 static void
 zink_link_gfx_shader(struct pipe_context *pctx, void **shaders)
 {
@@ -2262,6 +2319,8 @@ zink_link_gfx_shader(struct pipe_context *pctx, void **shaders)
    } else {
       if (zink_screen(pctx->screen)->info.have_EXT_shader_object)
          prog->base.uses_shobj = !zshaders[MESA_SHADER_VERTEX]->info.view_mask && !BITSET_TEST(zshaders[MESA_SHADER_FRAGMENT]->info.system_values_read, SYSTEM_VALUE_SAMPLE_MASK_IN);
+      if (zink_debug & ZINK_DEBUG_EAGERGPL)
+         gfx_program_init_eager_precompile(ctx, prog);
       if (zink_debug & ZINK_DEBUG_NOBGC)
          gfx_program_precompile_job(prog, pctx->screen, 0);
       else
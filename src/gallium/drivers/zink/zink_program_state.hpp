@@ -220,7 +220,7 @@ zink_get_gfx_pipeline(struct zink_context *ctx,
          pc_entry->gpl.ikey = ikey;
          pc_entry->gpl.gkey = gkey;
          pc_entry->gpl.okey = okey;
-         /* try to hit optimized compile cache first if possible */
+         /* try to hit optimized compile cache first if possible, e.g. from ZINK_DEBUG=eagergpl precompiles */
          if (!prog->is_separable)
             pc_entry->pipeline = zink_create_gfx_pipeline_combined(screen, prog, ikey->pipeline, &gkey->pipeline, 1, okey->pipeline, true, true);
          if (!pc_entry->pipeline) {
@@ -14,6 +14,10 @@
 #define NOWAIT_CHECK_THRESHOLD 10 //prevent spinning
 
 #define ZINK_QUERY_RENDER_PASSES (PIPE_QUERY_DRIVER_SPECIFIC + 0)
+#define ZINK_QUERY_SUBALLOC_ALLOCATED (PIPE_QUERY_DRIVER_SPECIFIC + 1)
+#define ZINK_QUERY_SUBALLOC_WASTED (PIPE_QUERY_DRIVER_SPECIFIC + 2)
+#define ZINK_QUERY_SUBALLOC_FRAGMENTATION (PIPE_QUERY_DRIVER_SPECIFIC + 3)
+#define ZINK_QUERY_PRESENT_LATENCY (PIPE_QUERY_DRIVER_SPECIFIC + 4)
 
 struct zink_query_pool {
    struct list_head list;
@@ -93,6 +97,10 @@ struct zink_query {
 
 static const struct pipe_driver_query_info zink_specific_queries[] = {
    {"render-passes", ZINK_QUERY_RENDER_PASSES, { 0 }},
+   {"suballoc-allocated", ZINK_QUERY_SUBALLOC_ALLOCATED, { 0 }, PIPE_DRIVER_QUERY_TYPE_BYTES, PIPE_DRIVER_QUERY_RESULT_TYPE_AVERAGE},
+   {"suballoc-wasted", ZINK_QUERY_SUBALLOC_WASTED, { 0 }, PIPE_DRIVER_QUERY_TYPE_BYTES, PIPE_DRIVER_QUERY_RESULT_TYPE_AVERAGE},
+   {"suballoc-fragmentation", ZINK_QUERY_SUBALLOC_FRAGMENTATION, { 100 }, PIPE_DRIVER_QUERY_TYPE_PERCENTAGE, PIPE_DRIVER_QUERY_RESULT_TYPE_AVERAGE},
+   {"present-latency", ZINK_QUERY_PRESENT_LATENCY, { 0 }, PIPE_DRIVER_QUERY_TYPE_MICROSECONDS, PIPE_DRIVER_QUERY_RESULT_TYPE_AVERAGE},
 };
 
 static inline int
@@ -1137,6 +1145,25 @@ zink_get_query_result(struct pipe_context *pctx,
       return true;
    }
 
+   if (query->type >= ZINK_QUERY_SUBALLOC_ALLOCATED && query->type <= ZINK_QUERY_SUBALLOC_FRAGMENTATION) {
+      uint64_t allocated, wasted;
+      unsigned fragmentation;
+      zink_bo_get_suballoc_stats(zink_screen(pctx->screen), &allocated, &wasted, &fragmentation);
+      if (query->type == ZINK_QUERY_SUBALLOC_ALLOCATED)
+         result->u64 = allocated;
+      else if (query->type == ZINK_QUERY_SUBALLOC_WASTED)
+         result->u64 = wasted;
+      else
+         result->u64 = fragmentation;
+      return true;
+   }
+
+   if (query->type == ZINK_QUERY_PRESENT_LATENCY) {
+      /* only measured when presents are paced with VK_KHR_present_wait */
+      result->u64 = p_atomic_read_relaxed(&zink_screen(pctx->screen)->present_latency_ns) / 1000;
+      return true;
+   }
+
    if (query->needs_update) {
       assert(!ctx->tc || !threaded_query(q)->flushed);
       update_qbo(ctx, query);
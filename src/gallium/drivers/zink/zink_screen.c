@@ -118,6 +118,7 @@ zink_debug_options[] = {
    { "quiet", ZINK_DEBUG_QUIET, "Suppress warnings" },
    { "ioopt", ZINK_DEBUG_IOOPT, "Optimize IO" },
    { "nopc", ZINK_DEBUG_NOPC, "No precompilation" },
+   { "eagergpl", ZINK_DEBUG_EAGERGPL, "Precompile optimized pipelines for the bound state when linking programs" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -3263,6 +3264,7 @@ zink_internal_create_screen(const struct pipe_screen_config *config, int64_t dev
       //screen->driconf.inline_uniforms = driQueryOptionb(config->options, "radeonsi_inline_uniforms");
       screen->driconf.emulate_point_smooth = driQueryOptionb(config->options, "zink_emulate_point_smooth");
       screen->driconf.zink_shader_object_enable = driQueryOptionb(config->options, "zink_shader_object_enable");
+      screen->driconf.frame_latency = driQueryOptioni(config->options, "zink_frame_latency");
    }
 
    simple_mtx_lock(&instance_lock);
@@ -3539,6 +3541,8 @@ zink_internal_create_screen(const struct pipe_screen_config *config, int64_t dev
    slab_create_parent(&screen->transfer_pool, sizeof(struct zink_transfer), 16);
 
    screen->driconf.inline_uniforms = debug_get_bool_option("ZINK_INLINE_UNIFORMS", screen->is_cpu);
+   screen->driconf.frame_latency = MIN2(debug_get_num_option("ZINK_FRAME_LATENCY", screen->driconf.frame_latency),
+                                        ZINK_MAX_FRAME_LATENCY);
 
    if (!zink_screen_init_semaphore(screen)) {
       if (!screen->driver_name_is_inferred)
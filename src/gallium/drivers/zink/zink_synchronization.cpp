@@ -388,6 +388,95 @@ struct emit_memory_barrier {
 };
 
 
+/* all sync2 barriers recorded between zink_batch_barriers_begin/end are accumulated
+ * into a single VkDependencyInfo for the cmdbuf they target; nothing else may be
+ * recorded into that cmdbuf until it is flushed
+ */
+void
+zink_flush_pending_barriers(struct zink_context *ctx)
+{
+   unsigned num_imbs = util_dynarray_num_elements(&ctx->pending_barriers.imbs, VkImageMemoryBarrier2);
+   /* dstStageMask is never empty for a queued memory barrier */
+   bool has_mb = ctx->pending_barriers.mb.dstStageMask != 0;
+   if (!num_imbs && !has_mb)
+      return;
+   VkDependencyInfo dep = {
+      VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      NULL,
+      0,
+      has_mb,
+      &ctx->pending_barriers.mb,
+      0,
+      NULL,
+      num_imbs,
+      (VkImageMemoryBarrier2 *)ctx->pending_barriers.imbs.data
+   };
+   VKCTX(CmdPipelineBarrier2)(ctx->pending_barriers.cmdbuf, &dep);
+   memset(&ctx->pending_barriers.mb, 0, sizeof(ctx->pending_barriers.mb));
+   util_dynarray_clear(&ctx->pending_barriers.imbs);
+}
+
+void
+zink_batch_barriers_begin(struct zink_context *ctx)
+{
+   struct zink_screen *screen = zink_screen(ctx->base.screen);
+   /* sync1 has no equivalent of VkDependencyInfo */
+   if (screen->info.have_vulkan13 || screen->info.have_KHR_synchronization2)
+      ctx->pending_barriers.depth++;
+}
+
+void
+zink_batch_barriers_end(struct zink_context *ctx)
+{
+   if (!ctx->pending_barriers.depth || --ctx->pending_barriers.depth)
+      return;
+   zink_flush_pending_barriers(ctx);
+}
+
+/* returns true if the barrier for cmdbuf should be queued instead of emitted */
+static bool
+queue_pending_barrier(struct zink_context *ctx, VkCommandBuffer cmdbuf)
+{
+   if (!ctx->pending_barriers.depth)
+      return false;
+   if (ctx->pending_barriers.cmdbuf != cmdbuf) {
+      zink_flush_pending_barriers(ctx);
+      ctx->pending_barriers.cmdbuf = cmdbuf;
+   }
+   return true;
+}
+
+static void
+queue_image_barrier(struct zink_context *ctx, const VkImageMemoryBarrier2 *imb)
+{
+   /* a second transition of the same image can't share a dependency with the first:
+    * fold it into the pending one so the image only transitions once
+    */
+   util_dynarray_foreach(&ctx->pending_barriers.imbs, VkImageMemoryBarrier2, pending) {
+      if (pending->image == imb->image && pending->subresourceRange.aspectMask == imb->subresourceRange.aspectMask) {
+         pending->dstStageMask = imb->dstStageMask;
+         pending->dstAccessMask = imb->dstAccessMask;
+         pending->newLayout = imb->newLayout;
+         if (!pending->pNext)
+            pending->pNext = imb->pNext;
+         return;
+      }
+   }
+   util_dynarray_append(&ctx->pending_barriers.imbs, VkImageMemoryBarrier2, *imb);
+}
+
+static void
+queue_memory_barrier(struct zink_context *ctx, const VkMemoryBarrier2 *bmb)
+{
+   /* buffer barriers are global memory barriers, so merging them is always a superset */
+   VkMemoryBarrier2 *mb = &ctx->pending_barriers.mb;
+   mb->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+   mb->srcStageMask |= bmb->srcStageMask;
+   mb->srcAccessMask |= bmb->srcAccessMask;
+   mb->dstStageMask |= bmb->dstStageMask;
+   mb->dstAccessMask |= bmb->dstAccessMask;
+}
+
 template <>
 struct emit_memory_barrier<barrier_KHR_synchronzation2> {
    static void for_image(struct zink_context *ctx, struct zink_resource *res, VkImageLayout new_layout,
@@ -407,6 +496,10 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
          res->queue = VK_QUEUE_FAMILY_IGNORED;
          *queue_import = true;
       }
+      if (queue_pending_barrier(ctx, cmdbuf)) {
+         queue_image_barrier(ctx, &imb);
+         return;
+      }
       VkDependencyInfo dep = {
          VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
          NULL,
@@ -441,6 +534,10 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
       }
       bmb.dstStageMask = pipeline;
       bmb.dstAccessMask = flags;
+      if (queue_pending_barrier(ctx, cmdbuf)) {
+         queue_memory_barrier(ctx, &bmb);
+         return;
+      }
       VkDependencyInfo dep = {
           VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
           NULL,
@@ -243,6 +243,7 @@ enum zink_debug {
    ZINK_DEBUG_QUIET = (1<<18),
    ZINK_DEBUG_IOOPT = (1<<19),
    ZINK_DEBUG_NOPC = (1<<20),
+   ZINK_DEBUG_EAGERGPL = (1<<21),
 };
 
 enum zink_pv_emulation_primitive {
@@ -425,6 +426,7 @@ struct zink_descriptor_data {
    bool has_fbfetch;
    bool push_state_changed[2]; //gfx, compute
    uint8_t state_changed[2]; //gfx, compute
+   uint32_t state_gen[2][ZINK_DESCRIPTOR_BASE_TYPES]; //gfx, compute; bumped on every invalidation
    struct zink_descriptor_layout_key *push_layout_keys[2]; //gfx, compute
    struct zink_descriptor_layout *push_dsl[2]; //gfx, compute
    VkDescriptorUpdateTemplate push_template[2]; //gfx, compute
@@ -476,6 +478,13 @@ struct zink_program_descriptor_data {
    };
    uint32_t db_size[ZINK_DESCRIPTOR_NON_BINDLESS_TYPES]; //the total size of the layout
    uint32_t *db_offset[ZINK_DESCRIPTOR_NON_BINDLESS_TYPES]; //the offset of each binding in the layout
+   /* the last descriptor buffer update of each set, reusable until the batch db restarts or the state changes */
+   struct {
+      const struct zink_batch_state *bs;
+      uint32_t db_epoch;
+      uint32_t state_gen;
+      uint64_t offset;
+   } db_last[ZINK_DESCRIPTOR_BASE_TYPES];
 };
 
 struct zink_descriptor_pool {
@@ -531,6 +540,7 @@ struct zink_batch_descriptor_data {
    uint8_t *db_map; //the host map for the buffer
    struct pipe_transfer *db_xfer; //the transfer map for the buffer
    uint64_t db_offset; //the "next" offset that will be used when the buffer is updated
+   uint32_t db_epoch; //incremented whenever db_offset restarts, invalidating previously written offsets
 };
 
 /** batch types */
@@ -697,6 +707,9 @@ struct zink_bo {
       struct {
          struct pb_slab_entry entry;
          struct zink_bo *real;
+         /* mid-size suballocations only: entry.head links into the reclaim list */
+         struct zink_bo_block *block;
+         uint64_t alloc_size;
       } slab;
       struct {
          uint32_t num_va_pages;
@@ -1125,6 +1138,11 @@ struct zink_gfx_program {
    struct zink_gfx_pipeline_cache_entry *last_pipeline[2][4]; //[dynamic, renderpass][primtype idx]
 
    struct zink_gfx_lib_cache *libs;
+
+   /* ZINK_DEBUG_EAGERGPL: ctx-owned input/output libraries to link against in the precompile job */
+   VkPipeline precompile_inputs[4];
+   VkPipeline precompile_output;
+   uint8_t num_precompile_inputs;
 };
 
 struct zink_compute_program {
@@ -1454,6 +1472,14 @@ struct zink_screen {
       struct pb_slabs bo_slabs[NUM_SLAB_ALLOCATORS];
       unsigned min_alloc_size;
       uint32_t next_bo_unique_id;
+      /* suballocator for buffers too big for slabs, see zink_bo.c */
+      struct {
+         simple_mtx_t lock;
+         struct list_head blocks[VK_MAX_MEMORY_TYPES];
+         struct list_head reclaim;
+         uint64_t allocated; //total size of all blocks
+         uint64_t used; //total requested size of live allocations
+      } mid;
    } pb;
    uint8_t heap_map[ZINK_HEAP_MAX][VK_MAX_MEMORY_TYPES];  // mapping from zink heaps to memory type indices
    uint8_t heap_count[ZINK_HEAP_MAX];  // number of memory types per zink heap
@@ -1526,8 +1552,12 @@ struct zink_screen {
       bool inline_uniforms;
       bool emulate_point_smooth;
       bool zink_shader_object_enable;
+      unsigned frame_latency;
    } driconf;
 
+   /* running average of the time from queueing a present until it's displayed */
+   uint64_t present_latency_ns;
+
    struct zink_format_props format_props[PIPE_FORMAT_COUNT];
    struct zink_modifier_props modifier_props[PIPE_FORMAT_COUNT];
    bool format_props_init[PIPE_FORMAT_COUNT];
@@ -2016,6 +2046,13 @@ struct zink_context {
    struct set update_barriers[2][2]; //[gfx, compute][current, next]
    uint8_t barrier_set_idx[2];
    unsigned memory_barrier;
+   /* sync2 barriers accumulated between zink_batch_barriers_begin/end for a single cmdbuf */
+   struct {
+      unsigned depth;
+      VkCommandBuffer cmdbuf;
+      VkMemoryBarrier2 mb;
+      struct util_dynarray imbs; //VkImageMemoryBarrier2
+   } pending_barriers;
 
    uint32_t ds3_states;
    unsigned work_count;
@@ -39,8 +39,12 @@
 #include "Debug.h"
 #include "Format.h"
 
+#include "tgsi/tgsi_parse.h"
 #include "tgsi/tgsi_ureg.h"
+#include "util/hash_table.h"
+#include "util/simple_mtx.h"
 #include "util/u_gen_mipmap.h"
+#include "util/u_memory.h"
 #include "util/u_sampler.h"
 #include "util/format/u_format.h"
 
@@ -522,6 +526,126 @@ DestroySampler(D3D10DDI_HDEVICE hDevice,     // IN
 }
 
 
+/*
+ * Translated shaders, shared by all devices in the process.
+ *
+ * Applications commonly create the same shader many times (once per device,
+ * or again after every level load), and translating the D3D10 token stream
+ * to TGSI is the most expensive part of shader creation in the frontend.
+ * The key is a copy of the whole token stream, so lookups never match a
+ * different shader.
+ */
+
+#define SHADER_CACHE_MAX_ENTRIES 4096
+
+struct ShaderCacheEntry {
+   const struct tgsi_token *tokens;
+   unsigned output_mapping[PIPE_MAX_SHADER_OUTPUTS];
+};
+
+static simple_mtx_t shader_cache_lock = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *shader_cache = NULL;
+
+
+static unsigned
+ShaderCodeSize(const UINT *pCode)
+{
+   return DECODE_D3D10_SB_TOKENIZED_PROGRAM_LENGTH(pCode[1]) * sizeof(UINT);
+}
+
+
+static uint32_t
+ShaderCodeHash(const void *key)
+{
+   const UINT *pCode = (const UINT *)key;
+
+   return _mesa_hash_data(pCode, ShaderCodeSize(pCode));
+}
+
+
+static bool
+ShaderCodeEqual(const void *a, const void *b)
+{
+   unsigned size = ShaderCodeSize((const UINT *)a);
+
+   return size == ShaderCodeSize((const UINT *)b) && !memcmp(a, b, size);
+}
+
+
+/*
+ * ----------------------------------------------------------------------
+ *
+ * TranslateShader --
+ *
+ *    Translate the D3D10 shader code to TGSI, reusing an earlier
+ *    translation of identical code.  The returned tokens belong to the
+ *    caller and must be freed with ureg_free_tokens().
+ *
+ * ----------------------------------------------------------------------
+ */
+
+static const struct tgsi_token *
+TranslateShader(const UINT *pCode,              // IN
+                unsigned *output_mapping)       // OUT
+{
+   uint32_t hash = ShaderCodeHash(pCode);
+   const struct tgsi_token *tokens;
+
+   simple_mtx_lock(&shader_cache_lock);
+   if (!shader_cache) {
+      shader_cache = _mesa_hash_table_create(NULL, ShaderCodeHash,
+                                             ShaderCodeEqual);
+   }
+   if (shader_cache) {
+      struct hash_entry *entry =
+         _mesa_hash_table_search_pre_hashed(shader_cache, hash, pCode);
+      if (entry) {
+         const ShaderCacheEntry *cached = (const ShaderCacheEntry *)entry->data;
+
+         tokens = tgsi_dup_tokens(cached->tokens);
+         memcpy(output_mapping, cached->output_mapping,
+                sizeof cached->output_mapping);
+         simple_mtx_unlock(&shader_cache_lock);
+         return tokens;
+      }
+   }
+   simple_mtx_unlock(&shader_cache_lock);
+
+   tokens = Shader_tgsi_translate(pCode, output_mapping);
+   if (!tokens) {
+      return NULL;
+   }
+
+   unsigned size = ShaderCodeSize(pCode);
+   ShaderCacheEntry *cached = CALLOC_STRUCT(ShaderCacheEntry);
+   void *key = MALLOC(size);
+   if (cached && key) {
+      memcpy(key, pCode, size);
+      memcpy(cached->output_mapping, output_mapping,
+             sizeof cached->output_mapping);
+      cached->tokens = tgsi_dup_tokens(tokens);
+   }
+
+   simple_mtx_lock(&shader_cache_lock);
+   if (shader_cache && cached && key && cached->tokens &&
+       _mesa_hash_table_num_entries(shader_cache) < SHADER_CACHE_MAX_ENTRIES &&
+       !_mesa_hash_table_search_pre_hashed(shader_cache, hash, key)) {
+      _mesa_hash_table_insert_pre_hashed(shader_cache, hash, key, cached);
+      cached = NULL;
+      key = NULL;
+   }
+   simple_mtx_unlock(&shader_cache_lock);
+
+   if (cached) {
+      ureg_free_tokens(cached->tokens);
+      FREE(cached);
+   }
+   FREE(key);
+
+   return tokens;
+}
+
+
 /*
  * ----------------------------------------------------------------------
  *
@@ -548,7 +672,7 @@ CreateVertexShader(D3D10DDI_HDEVICE hDevice,                                  //
    pShader->output_resolved = true;
 
    memset(&pShader->state, 0, sizeof pShader->state);
-   pShader->state.tokens = Shader_tgsi_translate(pCode, pShader->output_mapping);
+   pShader->state.tokens = TranslateShader(pCode, pShader->output_mapping);
 
    pShader->handle = pipe->create_vs_state(pipe, &pShader->state);
 
@@ -684,7 +808,7 @@ CreateGeometryShader(D3D10DDI_HDEVICE hDevice,                                //
    pShader->output_resolved = true;
 
    memset(&pShader->state, 0, sizeof pShader->state);
-   pShader->state.tokens = Shader_tgsi_translate(pShaderCode, pShader->output_mapping);
+   pShader->state.tokens = TranslateShader(pShaderCode, pShader->output_mapping);
 
    pShader->handle = pipe->create_gs_state(pipe, &pShader->state);
 }
@@ -848,8 +972,8 @@ CreateGeometryShaderWithStreamOutput(
 
    memset(&pShader->state, 0, sizeof pShader->state);
    if (pData->pShaderCode) {
-      pShader->state.tokens = Shader_tgsi_translate(pData->pShaderCode,
-                                                    pShader->output_mapping);
+      pShader->state.tokens = TranslateShader(pData->pShaderCode,
+                                              pShader->output_mapping);
    }
    pShader->output_resolved = (pShader->state.tokens != NULL);
 
@@ -1000,8 +1124,8 @@ CreatePixelShader(D3D10DDI_HDEVICE hDevice,                                // IN
    pShader->output_resolved = true;
 
    memset(&pShader->state, 0, sizeof pShader->state);
-   pShader->state.tokens = Shader_tgsi_translate(pShaderCode,
-                                                 pShader->output_mapping);
+   pShader->state.tokens = TranslateShader(pShaderCode,
+                                           pShader->output_mapping);
 
    pShader->handle = pipe->create_fs_state(pipe, &pShader->state);
 
@@ -28,10 +28,13 @@
 #include "vk_common_entrypoints.h"
 
 static void
-lvp_cmd_buffer_destroy(struct vk_command_buffer *cmd_buffer)
+lvp_cmd_buffer_destroy(struct vk_command_buffer *vk_cmd_buffer)
 {
-   vk_command_buffer_finish(cmd_buffer);
-   vk_free(&cmd_buffer->pool->alloc, cmd_buffer);
+   struct lvp_cmd_buffer *cmd_buffer =
+      container_of(vk_cmd_buffer, struct lvp_cmd_buffer, vk);
+
+   vk_command_buffer_finish(vk_cmd_buffer);
+   vk_free(&vk_cmd_buffer->pool->alloc, cmd_buffer);
 }
 
 static VkResult
@@ -64,9 +67,11 @@ lvp_create_cmd_buffer(struct vk_command_pool *pool,
 
 static void
 lvp_reset_cmd_buffer(struct vk_command_buffer *vk_cmd_buffer,
-                     UNUSED VkCommandBufferResetFlags flags)
+                     VkCommandBufferResetFlags flags)
 {
    vk_command_buffer_reset(vk_cmd_buffer);
+   if (flags & VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT)
+      vk_command_buffer_release_arena(vk_cmd_buffer);
 }
 
 const struct vk_command_buffer_ops lvp_cmd_buffer_ops = {
@@ -1607,6 +1607,30 @@ destroy_pipelines(struct lvp_queue *queue)
    simple_mtx_unlock(&queue->lock);
 }
 
+struct lvp_replay_job {
+   struct lvp_queue *queue;
+   struct lvp_cmd_buffer *cmd_buffer;
+   struct util_queue_fence fence;
+};
+
+static void
+replay_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct lvp_replay_job *job = data;
+
+   lvp_execute_cmds(job->queue->device, job->queue, thread_index, job->cmd_buffer);
+}
+
+static void
+wait_replay_jobs(struct lvp_replay_job *jobs, unsigned *first, unsigned count)
+{
+   for (unsigned i = *first; i < count; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+   *first = count;
+}
+
 static VkResult
 lvp_queue_submit(struct vk_queue *vk_queue,
                  struct vk_queue_submit *submit)
@@ -1639,11 +1663,39 @@ lvp_queue_submit(struct vk_queue *vk_queue,
       lvp_image_bind_sparse(queue->device, queue, bind);
    }
 
+   /* Runs of command buffers without any synchronization commands are
+    * handed to the replay threads, anything else waits for them and then
+    * runs on the queue's own context.  lvp_execute_cmds() waits for the
+    * work it submits, so once all jobs are done the submission is complete.
+    */
+   struct lvp_replay_job *jobs = NULL;
+   unsigned num_jobs = 0, num_waited = 0;
+
+   if (queue->num_lanes && submit->command_buffer_count > 1)
+      jobs = calloc(submit->command_buffer_count, sizeof(*jobs));
+
    for (uint32_t i = 0; i < submit->command_buffer_count; i++) {
       struct lvp_cmd_buffer *cmd_buffer =
          container_of(submit->command_buffers[i], struct lvp_cmd_buffer, vk);
 
-      lvp_execute_cmds(queue->device, queue, cmd_buffer);
+      if (jobs && lvp_cmd_buffer_replays_in_parallel(cmd_buffer)) {
+         struct lvp_replay_job *job = &jobs[num_jobs++];
+
+         job->queue = queue;
+         job->cmd_buffer = cmd_buffer;
+         util_queue_fence_init(&job->fence);
+         util_queue_add_job(&queue->replay, job, &job->fence,
+                            replay_job_execute, NULL, 0);
+      } else {
+         if (jobs)
+            wait_replay_jobs(jobs, &num_waited, num_jobs);
+         lvp_execute_cmds(queue->device, queue, -1, cmd_buffer);
+      }
+   }
+
+   if (jobs) {
+      wait_replay_jobs(jobs, &num_waited, num_jobs);
+      free(jobs);
    }
 
    simple_mtx_unlock(&queue->lock);
@@ -1661,6 +1713,23 @@ lvp_queue_submit(struct vk_queue *vk_queue,
    return VK_SUCCESS;
 }
 
+static void
+lvp_queue_finish_lanes(struct lvp_queue *queue)
+{
+   if (util_queue_is_initialized(&queue->replay))
+      util_queue_destroy(&queue->replay);
+
+   for (unsigned i = 0; i < queue->num_lanes; i++) {
+      struct lvp_replay_lane *lane = &queue->lanes[i];
+
+      u_upload_destroy(lane->uploader);
+      cso_destroy_context(lane->cso);
+      lane->ctx->destroy(lane->ctx);
+      free(lane->state);
+   }
+   queue->num_lanes = 0;
+}
+
 static VkResult
 lvp_queue_init(struct lvp_device *device, struct lvp_queue *queue,
                const VkDeviceQueueCreateInfo *create_info,
@@ -1688,6 +1757,32 @@ lvp_queue_init(struct lvp_device *device, struct lvp_queue *queue,
    simple_mtx_init(&queue->lock, mtx_plain);
    util_dynarray_init(&queue->pipeline_destroys, NULL);
 
+   unsigned num_lanes = MIN2(debug_get_num_option("LVP_REPLAY_THREADS", 0),
+                             MAX_REPLAY_THREADS);
+   size_t state_size = lvp_get_rendering_state_size();
+
+   for (unsigned i = 0; i < num_lanes; i++) {
+      struct lvp_replay_lane *lane = &queue->lanes[i];
+
+      lane->state = calloc(1, state_size);
+      lane->ctx = device->pscreen->context_create(device->pscreen, NULL, PIPE_CONTEXT_ROBUST_BUFFER_ACCESS);
+      if (!lane->state || !lane->ctx) {
+         free(lane->state);
+         if (lane->ctx)
+            lane->ctx->destroy(lane->ctx);
+         break;
+      }
+      lane->cso = cso_create_context(lane->ctx, CSO_NO_VBUF);
+      lane->uploader = u_upload_create(lane->ctx, 1024 * 1024, PIPE_BIND_CONSTANT_BUFFER, PIPE_USAGE_STREAM, 0);
+      queue->num_lanes++;
+   }
+
+   /* thread_index of each job picks the lane, so one thread per lane */
+   if (queue->num_lanes &&
+       !util_queue_init(&queue->replay, "lvp_replay", 16, queue->num_lanes,
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL))
+      lvp_queue_finish_lanes(queue);
+
    return VK_SUCCESS;
 }
 
@@ -1697,6 +1792,7 @@ lvp_queue_finish(struct lvp_queue *queue)
    vk_queue_finish(&queue->vk);
 
    destroy_pipelines(queue);
+   lvp_queue_finish_lanes(queue);
    simple_mtx_destroy(&queue->lock);
    util_dynarray_fini(&queue->pipeline_destroys);
 
@@ -85,6 +85,7 @@ struct rendering_state {
    struct lvp_device *device;
    struct u_upload_mgr *uploader;
    struct cso_context *cso;
+   int lane; /* replay lane of pctx, -1 for the queue's own context */
 
    bool blend_dirty;
    bool rs_dirty;
@@ -312,8 +313,13 @@ static void emit_compute_state(struct rendering_state *state)
       state->constbuf_dirty[MESA_SHADER_COMPUTE] = false;
    }
 
-   if (state->compute_shader_dirty)
-      state->pctx->bind_compute_state(state->pctx, state->shaders[MESA_SHADER_COMPUTE]->shader_cso);
+   if (state->compute_shader_dirty) {
+      struct lvp_shader *shader = state->shaders[MESA_SHADER_COMPUTE];
+      void *cso = state->lane < 0 ? shader->shader_cso :
+                  lvp_shader_compile_lane(state->device, shader, state->lane);
+
+      state->pctx->bind_compute_state(state->pctx, cso);
+   }
 
    state->compute_shader_dirty = false;
 
@@ -5309,16 +5315,70 @@ static void lvp_execute_cmd_buffer(struct list_head *cmds,
    }
 }
 
+/*
+ * Whether the command buffer may run on a replay lane, concurrently with the
+ * other command buffers of the submission.
+ *
+ * Without any synchronization command in it, nothing in the command buffer
+ * depends on work submitted before it, and nothing after it can depend on
+ * its work without waiting on a barrier of its own, which forces a serial
+ * replay.  Only compute and transfer commands are allowed because graphics
+ * states are not shareable between pipe contexts.
+ */
+bool
+lvp_cmd_buffer_replays_in_parallel(struct lvp_cmd_buffer *cmd_buffer)
+{
+   struct vk_cmd_queue_entry *cmd;
+
+   LIST_FOR_EACH_ENTRY(cmd, &cmd_buffer->vk.cmd_queue.cmds, cmd_link) {
+      switch ((unsigned)cmd->type) {
+      case VK_CMD_BIND_PIPELINE: {
+         LVP_FROM_HANDLE(lvp_pipeline, pipeline, cmd->u.bind_pipeline.pipeline);
+         if (pipeline->type != LVP_PIPELINE_COMPUTE)
+            return false;
+         break;
+      }
+      case VK_CMD_BIND_DESCRIPTOR_SETS2:
+      case VK_CMD_PUSH_CONSTANTS2:
+      case VK_CMD_DISPATCH:
+      case VK_CMD_DISPATCH_BASE:
+      case VK_CMD_DISPATCH_INDIRECT:
+      case VK_CMD_COPY_BUFFER2:
+      case VK_CMD_UPDATE_BUFFER:
+      case VK_CMD_FILL_BUFFER:
+         break;
+      default:
+         return false;
+      }
+   }
+
+   return true;
+}
+
 VkResult lvp_execute_cmds(struct lvp_device *device,
                           struct lvp_queue *queue,
+                          int lane,
                           struct lvp_cmd_buffer *cmd_buffer)
 {
-   struct rendering_state *state = queue->state;
-   memset(state, 0, sizeof(*state));
-   state->pctx = queue->ctx;
+   struct rendering_state *state;
+   struct cso_context *cso;
+
+   if (lane < 0) {
+      state = queue->state;
+      memset(state, 0, sizeof(*state));
+      state->pctx = queue->ctx;
+      state->uploader = queue->uploader;
+      cso = queue->cso;
+   } else {
+      state = queue->lanes[lane].state;
+      memset(state, 0, sizeof(*state));
+      state->pctx = queue->lanes[lane].ctx;
+      state->uploader = queue->lanes[lane].uploader;
+      cso = queue->lanes[lane].cso;
+   }
+   state->lane = lane;
    state->device = device;
-   state->uploader = queue->uploader;
-   state->cso = queue->cso;
+   state->cso = cso;
    state->blend_dirty = true;
    state->dsa_dirty = true;
    state->rs_dirty = true;
@@ -5356,7 +5416,7 @@ VkResult lvp_execute_cmds(struct lvp_device *device,
 
    state->start_vb = -1;
    state->num_vb = 0;
-   cso_unbind_context(queue->cso);
+   cso_unbind_context(cso);
    for (unsigned i = 0; i < ARRAY_SIZE(state->so_targets); i++) {
       if (state->so_targets[i]) {
          state->pctx->stream_output_target_destroy(state->pctx, state->so_targets[i]);
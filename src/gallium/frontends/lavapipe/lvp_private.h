@@ -106,6 +106,7 @@ extern "C" {
 #define MAX_PER_STAGE_DESCRIPTOR_UNIFORM_BLOCKS 8
 #define MAX_DGC_STREAMS 16
 #define MAX_DGC_TOKENS 16
+#define MAX_REPLAY_THREADS 8
 /* Currently lavapipe does not support more than 1 image plane */
 #define LVP_MAX_PLANE_COUNT 1
 
@@ -186,6 +187,16 @@ void lvp_finish_wsi(struct lvp_physical_device *physical_device);
 bool lvp_physical_device_extension_supported(struct lvp_physical_device *dev,
                                               const char *name);
 
+/* An extra pipe context used by one of the queue's replay threads, see
+ * lvp_cmd_buffer_replays_in_parallel().
+ */
+struct lvp_replay_lane {
+   struct pipe_context *ctx;
+   struct cso_context *cso;
+   struct u_upload_mgr *uploader;
+   void *state;
+};
+
 struct lvp_queue {
    struct vk_queue vk;
    struct lvp_device *                         device;
@@ -196,6 +207,10 @@ struct lvp_queue {
    void *state;
    struct util_dynarray pipeline_destroys;
    simple_mtx_t lock;
+
+   struct util_queue replay;
+   struct lvp_replay_lane lanes[MAX_REPLAY_THREADS];
+   unsigned num_lanes;
 };
 
 struct lvp_pipeline_cache {
@@ -446,6 +461,8 @@ struct lvp_shader {
    struct lvp_pipeline_nir *tess_ccw;
    void *shader_cso;
    void *tess_ccw_cso;
+   /* compute only: shader_cso recreated on each replay lane's context */
+   void *lane_cso[MAX_REPLAY_THREADS];
    struct pipe_stream_output_info stream_output;
    struct blob blob; //preserved for GetShaderBinaryDataEXT
    uint32_t push_constant_size;
@@ -725,7 +742,10 @@ VkResult lvp_image_bind_sparse(struct lvp_device *device,
 
 VkResult lvp_execute_cmds(struct lvp_device *device,
                           struct lvp_queue *queue,
+                          int lane,
                           struct lvp_cmd_buffer *cmd_buffer);
+bool
+lvp_cmd_buffer_replays_in_parallel(struct lvp_cmd_buffer *cmd_buffer);
 size_t
 lvp_get_rendering_state_size(void);
 struct lvp_image *lvp_swapchain_get_image(VkSwapchainKHR swapchain,
@@ -803,6 +823,9 @@ lvp_shader_optimize(nir_shader *nir);
 void *
 lvp_shader_compile(struct lvp_device *device, struct lvp_shader *shader, nir_shader *nir, bool locked);
 
+void *
+lvp_shader_compile_lane(struct lvp_device *device, struct lvp_shader *shader, unsigned lane);
+
 enum vk_cmd_type
 lvp_nv_dgc_token_to_cmd_type(const VkIndirectCommandsLayoutTokenNV *token);
 
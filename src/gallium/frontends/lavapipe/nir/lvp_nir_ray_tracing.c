@@ -61,16 +61,11 @@ static nir_def *
 lvp_build_intersect_ray_box(nir_builder *b, nir_def *node_addr, nir_def *ray_tmax,
                             nir_def *origin, nir_def *dir, nir_def *inv_dir)
 {
-   const struct glsl_type *vec2_type = glsl_vector_type(GLSL_TYPE_FLOAT, 2);
-   const struct glsl_type *uvec2_type = glsl_vector_type(GLSL_TYPE_UINT, 2);
-
-   nir_variable *distances =
-      nir_variable_create(b->shader, nir_var_shader_temp, vec2_type, "distances");
-   nir_store_var(b, distances, nir_imm_vec2(b, INFINITY, INFINITY), 0xf);
-
-   nir_variable *child_indices =
-      nir_variable_create(b->shader, nir_var_shader_temp, uvec2_type, "child_indices");
-   nir_store_var(b, child_indices, nir_imm_ivec2(b, 0xffffffffu, 0xffffffffu), 0xf);
+   /* Everything is selected rather than branched on, so that the lanes of
+    * a SIMD vector don't diverge on every box test.
+    */
+   nir_def *child_indices[2];
+   nir_def *distances[2];
 
    inv_dir = nir_bcsel(b, nir_feq_imm(b, dir, 0), nir_imm_float(b, FLT_MAX), inv_dir);
 
@@ -112,31 +107,19 @@ lvp_build_intersect_ray_box(nir_builder *b, nir_def *node_addr, nir_def *ray_tma
                            nir_fmax(b, nir_channel(b, bound0, 1), nir_channel(b, bound1, 1))),
                   nir_fmax(b, nir_channel(b, bound0, 2), nir_channel(b, bound1, 2)));
 
-      nir_push_if(b,
-                  nir_iand(b, min_x_is_not_nan,
-                           nir_iand(b, nir_fge(b, tmax, nir_fmax(b, nir_imm_float(b, 0.0f), tmin)),
-                                    nir_flt(b, tmin, ray_tmax))));
-      {
-         nir_def *new_child_indices[2] = {child_index, child_index};
-         nir_store_var(b, child_indices, nir_vec(b, new_child_indices, 2), 1u << i);
+      nir_def *hit =
+         nir_iand(b, min_x_is_not_nan,
+                  nir_iand(b, nir_fge(b, tmax, nir_fmax(b, nir_imm_float(b, 0.0f), tmin)),
+                           nir_flt(b, tmin, ray_tmax)));
 
-         nir_def *new_distances[2] = {tmin, tmin};
-         nir_store_var(b, distances, nir_vec(b, new_distances, 2), 1u << i);
-      }
-      nir_pop_if(b, NULL);
+      child_indices[i] = nir_bcsel(b, hit, child_index, nir_imm_int(b, 0xffffffffu));
+      distances[i] = nir_bcsel(b, hit, tmin, nir_imm_float(b, INFINITY));
    }
 
-   nir_def *ssa_distances = nir_load_var(b, distances);
-   nir_def *ssa_indices = nir_load_var(b, child_indices);
-   nir_push_if(b, nir_flt(b, nir_channel(b, ssa_distances, 1), nir_channel(b, ssa_distances, 0)));
-   {
-      nir_store_var(b, child_indices,
-                    nir_vec2(b, nir_channel(b, ssa_indices, 1), nir_channel(b, ssa_indices, 0)),
-                    0b11);
-   }
-   nir_pop_if(b, NULL);
-
-   return nir_load_var(b, child_indices);
+   /* Visit the closer child first. */
+   nir_def *swap = nir_flt(b, distances[1], distances[0]);
+   return nir_vec2(b, nir_bcsel(b, swap, child_indices[1], child_indices[0]),
+                   nir_bcsel(b, swap, child_indices[0], child_indices[1]));
 }
 
 static nir_def *
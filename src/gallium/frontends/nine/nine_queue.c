@@ -4,6 +4,7 @@
  */
 
 #include "nine_queue.h"
+#include "util/u_queue.h"
 #include "util/u_thread.h"
 #include "util/macros.h"
 #include "nine_helpers.h"
@@ -39,6 +40,8 @@
  * Constrains:
  * Only a single consumer and a single producer are supported.
  *
+ * Every cmdbuf is handed over with a pair of util_queue_fences, which only
+ * enter the kernel when the other side is actually waiting.
  */
 
 struct nine_cmdbuf {
@@ -46,7 +49,10 @@ struct nine_cmdbuf {
     unsigned num_instr;
     unsigned offset;
     void *mem_pool;
-    BOOL full;
+    /* Signalled by the producer once the cmdbuf may be executed. */
+    struct util_queue_fence filled;
+    /* Signalled by the consumer once the cmdbuf may be reused. */
+    struct util_queue_fence emptied;
 };
 
 struct nine_queue_pool {
@@ -55,10 +61,6 @@ struct nine_queue_pool {
     unsigned tail;
     unsigned cur_instr;
     BOOL worker_wait;
-    cnd_t event_pop;
-    cnd_t event_push;
-    mtx_t mutex_pop;
-    mtx_t mutex_push;
 };
 
 /* Consumer functions: */
@@ -68,14 +70,8 @@ nine_queue_wait_flush(struct nine_queue_pool* ctx)
     struct nine_cmdbuf *cmdbuf = &ctx->pool[ctx->tail];
 
     /* wait for cmdbuf full */
-    mtx_lock(&ctx->mutex_push);
-    while (!cmdbuf->full)
-    {
-        DBG("waiting for full cmdbuf\n");
-        cnd_wait(&ctx->event_push, &ctx->mutex_push);
-    }
+    util_queue_fence_wait(&cmdbuf->filled);
     DBG("got cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_push);
 
     cmdbuf->offset = 0;
     ctx->cur_instr = 0;
@@ -94,11 +90,9 @@ nine_queue_get(struct nine_queue_pool* ctx)
 
     if (ctx->cur_instr == cmdbuf->num_instr) {
         /* signal waiting producer */
-        mtx_lock(&ctx->mutex_pop);
         DBG("freeing cmdbuf=%p\n", cmdbuf);
-        cmdbuf->full = 0;
-        cnd_signal(&ctx->event_pop);
-        mtx_unlock(&ctx->mutex_pop);
+        util_queue_fence_reset(&cmdbuf->filled);
+        util_queue_fence_signal(&cmdbuf->emptied);
 
         ctx->tail = (ctx->tail + 1) & NINE_CMD_BUFS_MASK;
 
@@ -131,24 +125,16 @@ nine_queue_flush(struct nine_queue_pool* ctx)
         return;
 
     /* signal waiting worker */
-    mtx_lock(&ctx->mutex_push);
-    cmdbuf->full = 1;
-    cnd_signal(&ctx->event_push);
-    mtx_unlock(&ctx->mutex_push);
+    util_queue_fence_reset(&cmdbuf->emptied);
+    util_queue_fence_signal(&cmdbuf->filled);
 
     ctx->head = (ctx->head + 1) & NINE_CMD_BUFS_MASK;
 
     cmdbuf = &ctx->pool[ctx->head];
 
     /* wait for queue empty */
-    mtx_lock(&ctx->mutex_pop);
-    while (cmdbuf->full)
-    {
-        DBG("waiting for empty cmdbuf\n");
-        cnd_wait(&ctx->event_pop, &ctx->mutex_pop);
-    }
+    util_queue_fence_wait(&cmdbuf->emptied);
     DBG("got empty cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_pop);
     cmdbuf->offset = 0;
     cmdbuf->num_instr = 0;
 }
@@ -223,11 +209,11 @@ nine_queue_create(void)
             goto failed;
     }
 
-    cnd_init(&ctx->event_pop);
-    (void) mtx_init(&ctx->mutex_pop, mtx_plain);
-
-    cnd_init(&ctx->event_push);
-    (void) mtx_init(&ctx->mutex_push, mtx_plain);
+    for (i = 0; i < NINE_CMD_BUFS; i++) {
+        util_queue_fence_init(&ctx->pool[i].filled);
+        util_queue_fence_reset(&ctx->pool[i].filled);
+        util_queue_fence_init(&ctx->pool[i].emptied);
+    }
 
     /* Block until first cmdbuf has been flushed. */
     ctx->worker_wait = true;
@@ -249,14 +235,19 @@ nine_queue_delete(struct nine_queue_pool *ctx)
 {
     unsigned i;
 
-    mtx_destroy(&ctx->mutex_pop);
-    cnd_destroy(&ctx->event_pop);
+    for (i = 0; i < NINE_CMD_BUFS; i++) {
+        struct nine_cmdbuf *cmdbuf = &ctx->pool[i];
 
-    mtx_destroy(&ctx->mutex_push);
-    cnd_destroy(&ctx->event_push);
+        /* Nobody waits anymore, fences must be signalled to be destroyed. */
+        if (!util_queue_fence_is_signalled(&cmdbuf->filled))
+            util_queue_fence_signal(&cmdbuf->filled);
+        if (!util_queue_fence_is_signalled(&cmdbuf->emptied))
+            util_queue_fence_signal(&cmdbuf->emptied);
+        util_queue_fence_destroy(&cmdbuf->filled);
+        util_queue_fence_destroy(&cmdbuf->emptied);
 
-    for (i = 0; i < NINE_CMD_BUFS; i++)
-        FREE(ctx->pool[i].mem_pool);
+        FREE(cmdbuf->mem_pool);
+    }
 
     FREE(ctx);
 }
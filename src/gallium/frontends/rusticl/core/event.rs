@@ -4,6 +4,7 @@ use crate::core::context::*;
 use crate::core::queue::*;
 use crate::impl_cl_type_trait;
 
+use mesa_rust::pipe::fence::*;
 use mesa_rust::pipe::query::*;
 use mesa_rust_gen::*;
 use mesa_rust_util::static_assert;
@@ -41,6 +42,8 @@ struct EventMutState {
     time_submit: cl_ulong,
     time_start: cl_ulong,
     time_end: cl_ulong,
+    // fence of the flush that submitted this event, until it completes
+    fence: Option<Arc<PipeFence>>,
 }
 
 pub struct Event {
@@ -192,8 +195,38 @@ impl Event {
         }
     }
 
+    pub(super) fn set_fence(&self, fence: &Arc<PipeFence>) {
+        let mut lock = self.state();
+        lock.fence = Some(Arc::clone(fence));
+        self.cv.notify_all();
+    }
+
+    /// Waits until the event got flushed by its queue and returns the fence to synchronize with,
+    /// or `None` if the event already completed or failed in the meantime.
+    pub fn wait_flushed(&self) -> Option<Arc<PipeFence>> {
+        let mut lock = self.state();
+        while lock.status >= CL_RUNNING as cl_int && lock.fence.is_none() {
+            lock = self
+                .cv
+                .wait_timeout(lock, Duration::from_secs(1))
+                .unwrap()
+                .0;
+
+            if self.queue.as_ref().is_some_and(|q| q.is_dead()) {
+                return None;
+            }
+        }
+
+        if lock.status >= CL_RUNNING as cl_int {
+            lock.fence.clone()
+        } else {
+            None
+        }
+    }
+
     pub(super) fn signal(&self) {
-        let state = self.state();
+        let mut state = self.state();
+        state.fence = None;
         // we don't want to call signal on errored events, but if that still happens, handle it
         // gracefully
         debug_assert_eq!(state.status, CL_SUBMITTED as cl_int);
@@ -6,6 +6,7 @@ use crate::core::platform::*;
 use crate::impl_cl_type_trait;
 
 use mesa_rust::pipe::context::PipeContext;
+use mesa_rust::pipe::fence::PipeFence;
 use mesa_rust_gen::*;
 use mesa_rust_util::properties::*;
 use rusticl_opencl_gen::*;
@@ -14,6 +15,7 @@ use std::cmp;
 use std::mem;
 use std::mem::ManuallyDrop;
 use std::ops::Deref;
+use std::ptr;
 use std::sync::mpsc;
 use std::sync::Arc;
 use std::sync::Mutex;
@@ -96,7 +98,11 @@ impl_cl_type_trait!(cl_command_queue, Queue, CL_INVALID_COMMAND_QUEUE);
 
 fn flush_events(evs: &mut Vec<Arc<Event>>, pipe: &PipeContext) -> cl_int {
     if !evs.is_empty() {
-        pipe.flush().wait();
+        // Hand out the fence before waiting on it, so other queues can synchronize with these
+        // events on the GPU.
+        let fence = Arc::new(pipe.flush());
+        evs.iter().for_each(|e| e.set_fence(&fence));
+        fence.wait();
         if pipe.device_reset_status() != pipe_reset_status::PIPE_NO_RESET {
             // if the context reset while executing, simply put all events into error state.
             evs.drain(..)
@@ -169,8 +175,26 @@ impl Queue {
                             // check if any dependency has an error
                             for dep in &e.deps {
                                 // We have to wait on user events or events from other queues.
-                                let dep_err = if dep.is_user() || dep.queue != e.queue {
+                                // Events from queues on the same device only need to be
+                                // flushed, the GPU can wait for them on its own.
+                                let dep_err = if dep.is_user() {
                                     dep.wait()
+                                } else if dep.queue != e.queue {
+                                    let fence = dep
+                                        .queue
+                                        .as_ref()
+                                        .filter(|q| {
+                                            ptr::eq(q.device, ctx.dev)
+                                                && ctx.is_fence_server_sync_supported()
+                                        })
+                                        .and_then(|_| dep.wait_flushed());
+
+                                    if let Some(fence) = fence {
+                                        ctx.fence_server_sync(&fence);
+                                        dep.status()
+                                    } else {
+                                        dep.wait()
+                                    }
                                 } else {
                                     dep.status()
                                 };
@@ -592,6 +592,17 @@ impl PipeContext {
         }
     }
 
+    pub fn is_fence_server_sync_supported(&self) -> bool {
+        unsafe { self.pipe.as_ref().fence_server_sync.is_some() }
+    }
+
+    /// Makes the GPU wait for `fence` before executing anything submitted afterwards.
+    pub fn fence_server_sync(&self, fence: &PipeFence) {
+        unsafe {
+            self.pipe.as_ref().fence_server_sync.unwrap()(self.pipe.as_ptr(), fence.handle());
+        }
+    }
+
     pub fn import_fence(&self, fence_fd: &FenceFd) -> PipeFence {
         unsafe {
             let mut fence = ptr::null_mut();
@@ -22,6 +22,10 @@ pub struct PipeFence {
     screen: Arc<PipeScreen>,
 }
 
+// fences are reference counted screen objects and can be waited on from any thread
+unsafe impl Send for PipeFence {}
+unsafe impl Sync for PipeFence {}
+
 impl PipeFence {
     pub fn new(fence: *mut pipe_fence_handle, screen: &Arc<PipeScreen>) -> Self {
         Self {
@@ -30,6 +34,10 @@ impl PipeFence {
         }
     }
 
+    pub(super) fn handle(&self) -> *mut pipe_fence_handle {
+        self.fence
+    }
+
     pub fn wait(&self) {
         self.screen.fence_finish(self.fence);
     }
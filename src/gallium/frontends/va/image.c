@@ -33,6 +33,7 @@
 #include "util/u_surface.h"
 #include "util/u_video.h"
 #include "util/u_process.h"
+#include "util/streaming-load-memcpy.h"
 
 #include "vl/vl_winsys.h"
 #include "vl/vl_video_buffer.h"
@@ -545,10 +546,18 @@ vlVaGetImage(VADriverContextP ctx, VASurfaceID surface, int x, int y,
             mtx_unlock(&drv->mutex);
             return VA_STATUS_ERROR_OPERATION_FAILED;
          }
-         util_copy_rect((uint8_t*)(data[i] + pitches[i] * j),
-            view_resources[i]->format,
-            pitches[i] * view_resources[i]->array_size, 0, 0,
-            box.width, box.height, map, transfer->stride, 0, 0);
+
+         /* The mapping is often write-combined, use streaming loads. */
+         enum pipe_format res_format = view_resources[i]->format;
+         unsigned dst_stride = pitches[i] * view_resources[i]->array_size;
+         unsigned row_size = util_format_get_stride(res_format, box.width);
+         unsigned rows = util_format_get_nblocksy(res_format, box.height);
+         uint8_t *dst = data[i] + pitches[i] * j;
+
+         for (unsigned row = 0; row < rows; row++) {
+            util_streaming_load_memcpy(dst + row * dst_stride,
+                                       map + row * transfer->stride, row_size);
+         }
          pipe_texture_unmap(drv->pipe, transfer);
       }
    }
@@ -883,6 +883,7 @@ struct pipe_caps {
    bool texture_query_samples;
    bool force_persample_interp;
    bool shareable_shaders;
+   bool shareable_state_objects;
    bool copy_between_compressed_and_plain_formats;
    bool clear_scissored;
    bool draw_parameters;
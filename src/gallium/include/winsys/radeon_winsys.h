@@ -116,6 +116,11 @@ enum radeon_value_id
    RADEON_SLAB_WASTED_GTT,
    RADEON_BUFFER_WAIT_TIME_NS,
    RADEON_NUM_MAPPED_BUFFERS,
+   RADEON_BO_CACHE_HITS,
+   RADEON_BO_CACHE_MISSES,
+   RADEON_BO_CACHE_EXPIRED,
+   RADEON_BO_CACHE_TRIMMED,
+   RADEON_BO_CACHE_SIZE,
    RADEON_TIMESTAMP,
    RADEON_NUM_GFX_IBS,
    RADEON_NUM_SDMA_IBS,
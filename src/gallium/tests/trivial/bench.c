@@ -0,0 +1,344 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Measures a few common gallium hot paths the same way on every driver the
+ * pipe-loader can find, and prints the results as JSON:
+ *
+ *   draws          - draw calls per second with unchanged state
+ *   state_changes  - draw calls per second alternating two rasterizer CSOs
+ *   buffer_upload  - MiB per second through pipe_buffer_write
+ *   buffer_map     - microseconds per discarding map/unmap of a buffer
+ *   shader_compile - microseconds per fragment shader create/delete
+ *   readback       - MiB per second mapping the render target for reading
+ *
+ * The first argument optionally overrides the number of iterations.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pipe/p_context.h"
+#include "pipe/p_defines.h"
+#include "pipe/p_screen.h"
+#include "pipe/p_shader_tokens.h"
+#include "pipe/p_state.h"
+#include "cso_cache/cso_context.h"
+#include "pipe-loader/pipe_loader.h"
+#include "util/os_time.h"
+#include "util/u_draw_quad.h"
+#include "util/u_inlines.h"
+#include "util/u_memory.h"
+#include "util/u_simple_shaders.h"
+
+#define WIDTH 256
+#define HEIGHT 256
+#define UPLOAD_SIZE (1024 * 1024)
+
+struct bench {
+   struct pipe_screen *screen;
+   struct pipe_context *pipe;
+   struct cso_context *cso;
+
+   struct pipe_rasterizer_state rast[2];
+   struct pipe_framebuffer_state fb;
+   struct cso_velems_state velem;
+   struct pipe_resource *vbuf;
+   struct pipe_resource *target;
+   void *vs, *fs;
+
+   unsigned iterations;
+};
+
+static void
+finish(struct bench *b)
+{
+   struct pipe_fence_handle *fence = NULL;
+
+   b->pipe->flush(b->pipe, &fence, 0);
+   if (fence) {
+      b->screen->fence_finish(b->screen, NULL, fence, OS_TIMEOUT_INFINITE);
+      b->screen->fence_reference(b->screen, &fence, NULL);
+   }
+}
+
+static double
+seconds_since(int64_t start)
+{
+   return (os_time_get_nano() - start) / 1e9;
+}
+
+static void
+init_bench(struct bench *b)
+{
+   static const float vertices[3][2][4] = {
+      { { 0.0f, -0.9f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+      { { -0.9f, 0.9f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+      { { 0.9f, 0.9f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+   };
+
+   b->cso = cso_create_context(b->pipe, 0);
+
+   b->vbuf = pipe_buffer_create(b->screen, PIPE_BIND_VERTEX_BUFFER,
+                                PIPE_USAGE_DEFAULT, sizeof(vertices));
+   pipe_buffer_write(b->pipe, b->vbuf, 0, sizeof(vertices), vertices);
+
+   struct pipe_resource tmpl = {
+      .target = PIPE_TEXTURE_2D,
+      .format = PIPE_FORMAT_B8G8R8A8_UNORM,
+      .width0 = WIDTH,
+      .height0 = HEIGHT,
+      .depth0 = 1,
+      .array_size = 1,
+      .bind = PIPE_BIND_RENDER_TARGET,
+   };
+   b->target = b->screen->resource_create(b->screen, &tmpl);
+
+   struct pipe_surface surf_tmpl = {
+      .format = PIPE_FORMAT_B8G8R8A8_UNORM,
+   };
+   b->fb.width = WIDTH;
+   b->fb.height = HEIGHT;
+   b->fb.nr_cbufs = 1;
+   b->fb.cbufs[0] = b->pipe->create_surface(b->pipe, b->target, &surf_tmpl);
+
+   for (unsigned i = 0; i < 2; i++) {
+      b->rast[i].cull_face = PIPE_FACE_NONE;
+      b->rast[i].half_pixel_center = 1;
+      b->rast[i].bottom_edge_rule = 1;
+      b->rast[i].depth_clip_near = 1;
+      b->rast[i].depth_clip_far = 1;
+   }
+   b->rast[1].scissor = 1;
+
+   b->velem.count = 2;
+   for (unsigned i = 0; i < 2; i++) {
+      b->velem.velems[i].src_offset = i * 4 * sizeof(float);
+      b->velem.velems[i].src_format = PIPE_FORMAT_R32G32B32A32_FLOAT;
+      b->velem.velems[i].src_stride = 2 * 4 * sizeof(float);
+   }
+
+   const enum tgsi_semantic semantic_names[] =
+      { TGSI_SEMANTIC_POSITION, TGSI_SEMANTIC_COLOR };
+   const unsigned semantic_indexes[] = { 0, 0 };
+   b->vs = util_make_vertex_passthrough_shader(b->pipe, 2, semantic_names,
+                                               semantic_indexes, false);
+   b->fs = util_make_fragment_passthrough_shader(b->pipe, TGSI_SEMANTIC_COLOR,
+                                                 TGSI_INTERPOLATE_PERSPECTIVE,
+                                                 true);
+
+   struct pipe_blend_state blend = { 0 };
+   blend.rt[0].colormask = PIPE_MASK_RGBA;
+   struct pipe_depth_stencil_alpha_state dsa = { 0 };
+   struct pipe_viewport_state viewport = {
+      .scale = { WIDTH / 2.0f, HEIGHT / 2.0f, 0.5f },
+      .translate = { WIDTH / 2.0f, HEIGHT / 2.0f, 0.5f },
+      .swizzle_x = PIPE_VIEWPORT_SWIZZLE_POSITIVE_X,
+      .swizzle_y = PIPE_VIEWPORT_SWIZZLE_POSITIVE_Y,
+      .swizzle_z = PIPE_VIEWPORT_SWIZZLE_POSITIVE_Z,
+      .swizzle_w = PIPE_VIEWPORT_SWIZZLE_POSITIVE_W,
+   };
+   struct pipe_scissor_state scissor = {
+      .maxx = WIDTH / 2,
+      .maxy = HEIGHT,
+   };
+
+   cso_set_framebuffer(b->cso, &b->fb);
+   cso_set_blend(b->cso, &blend);
+   cso_set_depth_stencil_alpha(b->cso, &dsa);
+   cso_set_rasterizer(b->cso, &b->rast[0]);
+   cso_set_viewport(b->cso, &viewport);
+   b->pipe->set_scissor_states(b->pipe, 0, 1, &scissor);
+   cso_set_vertex_shader_handle(b->cso, b->vs);
+   cso_set_fragment_shader_handle(b->cso, b->fs);
+   cso_set_vertex_elements(b->cso, &b->velem);
+}
+
+static void
+fini_bench(struct bench *b)
+{
+   cso_destroy_context(b->cso);
+
+   b->pipe->delete_vs_state(b->pipe, b->vs);
+   b->pipe->delete_fs_state(b->pipe, b->fs);
+
+   pipe_surface_reference(&b->fb.cbufs[0], NULL);
+   pipe_resource_reference(&b->target, NULL);
+   pipe_resource_reference(&b->vbuf, NULL);
+}
+
+static double
+bench_draws(struct bench *b, bool change_state)
+{
+   finish(b);
+
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < b->iterations; i++) {
+      if (change_state)
+         cso_set_rasterizer(b->cso, &b->rast[i & 1]);
+
+      util_draw_vertex_buffer(b->pipe, b->cso, b->vbuf, 0, false,
+                              MESA_PRIM_TRIANGLES, 2, 3);
+   }
+   finish(b);
+
+   cso_set_rasterizer(b->cso, &b->rast[0]);
+   return b->iterations / seconds_since(start);
+}
+
+static double
+bench_buffer_upload(struct bench *b)
+{
+   struct pipe_resource *buf =
+      pipe_buffer_create(b->screen, PIPE_BIND_VERTEX_BUFFER,
+                         PIPE_USAGE_DEFAULT, UPLOAD_SIZE);
+   void *data = CALLOC(1, UPLOAD_SIZE);
+   unsigned count = MAX2(b->iterations / 100, 1);
+
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i++)
+      pipe_buffer_write(b->pipe, buf, 0, UPLOAD_SIZE, data);
+   finish(b);
+
+   double mib_per_s = count * (UPLOAD_SIZE / (1024.0 * 1024.0)) /
+                      seconds_since(start);
+
+   FREE(data);
+   pipe_resource_reference(&buf, NULL);
+   return mib_per_s;
+}
+
+static double
+bench_buffer_map(struct bench *b)
+{
+   struct pipe_resource *buf =
+      pipe_buffer_create(b->screen, PIPE_BIND_VERTEX_BUFFER,
+                         PIPE_USAGE_STREAM, 4096);
+   struct pipe_transfer *transfer;
+
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < b->iterations; i++) {
+      uint32_t *map = pipe_buffer_map(b->pipe, buf,
+                                      PIPE_MAP_WRITE |
+                                      PIPE_MAP_DISCARD_WHOLE_RESOURCE,
+                                      &transfer);
+      if (!map)
+         break;
+
+      map[0] = i;
+      pipe_buffer_unmap(b->pipe, transfer);
+   }
+   finish(b);
+
+   double us = seconds_since(start) * 1e6 / b->iterations;
+
+   pipe_resource_reference(&buf, NULL);
+   return us;
+}
+
+static double
+bench_shader_compile(struct bench *b)
+{
+   unsigned count = MAX2(b->iterations / 100, 1);
+
+   /* Varying the interpolation mode keeps drivers from handing out the same
+    * variant from a cache every time.
+    */
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i++) {
+      void *fs = util_make_fragment_passthrough_shader(
+         b->pipe, TGSI_SEMANTIC_GENERIC,
+         (i & 1) ? TGSI_INTERPOLATE_LINEAR : TGSI_INTERPOLATE_PERSPECTIVE,
+         true);
+      b->pipe->delete_fs_state(b->pipe, fs);
+   }
+   finish(b);
+
+   return seconds_since(start) * 1e6 / count;
+}
+
+static double
+bench_readback(struct bench *b)
+{
+   unsigned count = MAX2(b->iterations / 100, 1);
+   struct pipe_transfer *transfer;
+   volatile uint32_t sum = 0;
+
+   int64_t start = os_time_get_nano();
+   for (unsigned i = 0; i < count; i++) {
+      /* Dirty the target so every map has to wait for the GPU. */
+      util_draw_vertex_buffer(b->pipe, b->cso, b->vbuf, 0, false,
+                              MESA_PRIM_TRIANGLES, 2, 3);
+
+      const uint8_t *map = pipe_texture_map(b->pipe, b->target, 0, 0,
+                                            PIPE_MAP_READ, 0, 0,
+                                            WIDTH, HEIGHT, &transfer);
+      if (!map)
+         return 0;
+
+      for (unsigned y = 0; y < HEIGHT; y++)
+         sum += *(const uint32_t *)(map + y * transfer->stride);
+      pipe_texture_unmap(b->pipe, transfer);
+   }
+
+   return count * (WIDTH * HEIGHT * 4 / (1024.0 * 1024.0)) /
+          seconds_since(start);
+}
+
+int
+main(int argc, char **argv)
+{
+   struct pipe_loader_device **devs;
+   unsigned iterations = argc > 1 ? atoi(argv[1]) : 10000;
+   int num_devs = pipe_loader_probe(NULL, 0, false);
+
+   if (num_devs <= 0 || !iterations) {
+      fprintf(stderr, "usage: %s [iterations], with a usable device\n",
+              argv[0]);
+      return 1;
+   }
+
+   devs = CALLOC(num_devs, sizeof(*devs));
+   pipe_loader_probe(devs, num_devs, false);
+
+   unsigned printed = 0;
+   printf("[\n");
+   for (int i = 0; i < num_devs; i++) {
+      struct bench b = { .iterations = iterations };
+
+      b.screen = pipe_loader_create_screen(devs[i], false);
+      if (!b.screen)
+         continue;
+
+      b.pipe = b.screen->context_create(b.screen, NULL, 0);
+      if (!b.pipe) {
+         b.screen->destroy(b.screen);
+         continue;
+      }
+
+      init_bench(&b);
+
+      printf("%s  {\n", printed++ ? ",\n" : "");
+      printf("    \"driver\": \"%s\",\n", devs[i]->driver_name);
+      printf("    \"device\": \"%s\",\n", b.screen->get_name(b.screen));
+      printf("    \"iterations\": %u,\n", iterations);
+      printf("    \"draws_per_s\": %.0f,\n", bench_draws(&b, false));
+      printf("    \"state_change_draws_per_s\": %.0f,\n", bench_draws(&b, true));
+      printf("    \"buffer_upload_mib_per_s\": %.1f,\n", bench_buffer_upload(&b));
+      printf("    \"buffer_map_us\": %.3f,\n", bench_buffer_map(&b));
+      printf("    \"shader_compile_us\": %.1f,\n", bench_shader_compile(&b));
+      printf("    \"readback_mib_per_s\": %.1f\n", bench_readback(&b));
+      printf("  }");
+
+      fini_bench(&b);
+      b.pipe->destroy(b.pipe);
+      b.screen->destroy(b.screen);
+   }
+   printf("\n]\n");
+
+   pipe_loader_release(devs, num_devs);
+   FREE(devs);
+
+   return 0;
+}
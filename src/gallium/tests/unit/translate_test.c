@@ -76,6 +76,15 @@ int main(int argc, char** argv)
       create_fn = translate_generic_create;
    else if (!strcmp(argv[1], "x86"))
       create_fn = translate_sse2_create;
+   else if (!strcmp(argv[1], "simd"))
+   {
+      if (!translate_simd_is_supported())
+      {
+         printf("translate_simd is not supported on this CPU\n");
+         return 0;
+      }
+      create_fn = translate_simd_create;
+   }
    else
    {
       const char *translate_options[] = {
@@ -99,7 +108,7 @@ int main(int argc, char** argv)
 
    if (!create_fn)
    {
-      printf("Usage: ./translate_test [default|generic|x86|nosse|sse|sse2|sse3|ssse3|sse4.1|avx]\n");
+      printf("Usage: ./translate_test [default|generic|x86|simd|nosse|sse|sse2|sse3|ssse3|sse4.1|avx]\n");
       return 2;
    }
 
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+# Copyright © 2025 Valve Corporation
+# SPDX-License-Identifier: MIT
+
+"""Convert a binary trace (GALLIUM_TRACE_BINARY) to the XML trace format.
+
+The format is described in src/gallium/auxiliary/driver_trace/tr_dump.c.
+The output is the same XML the trace driver writes, so it can be fed to
+dump.py and the other tools here.  Compressed traces need the zstandard
+module when Mesa was built with zstd.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+
+MAGIC = b'GALTRACE'
+VERSION = 1
+FILE_ZSTD = 1 << 0
+FILE_ZLIB = 1 << 1
+CHUNK_COMPRESSED = 1 << 31
+
+(NAME, CALL_BEGIN, CALL_END, ARG_BEGIN, ARG_END, RET_BEGIN, RET_END,
+ FALSE, TRUE, INT, UINT, FLOAT, BYTES, STRING, ENUM, ARRAY_BEGIN, ARRAY_END,
+ ELEM_BEGIN, ELEM_END, STRUCT_BEGIN, STRUCT_END, MEMBER_BEGIN, MEMBER_END,
+ NULL, PTR, NIR) = range(1, 27)
+
+
+class FormatError(Exception):
+    pass
+
+
+def read_chunks(stream):
+    """Return the uncompressed token stream of a binary trace."""
+    if stream.read(len(MAGIC)) != MAGIC:
+        raise FormatError('not a binary gallium trace')
+
+    version, flags = struct.unpack('<II', stream.read(8))
+    if version != VERSION:
+        raise FormatError(f'unsupported version {version}')
+
+    if flags & FILE_ZSTD:
+        try:
+            import zstandard
+        except ImportError:
+            raise FormatError('the zstandard module is needed for this trace')
+        decompress = zstandard.ZstdDecompressor().decompress
+    else:
+        decompress = zlib.decompress
+
+    data = bytearray()
+    while True:
+        header = stream.read(8)
+        if len(header) < 8:
+            # A truncated trace, e.g. from a crash, ends at the last chunk.
+            break
+        size, stored_size = struct.unpack('<II', header)
+        chunk = stream.read(stored_size & ~CHUNK_COMPRESSED)
+        if stored_size & CHUNK_COMPRESSED:
+            if decompress is zlib.decompress:
+                chunk = zlib.decompress(chunk)
+            else:
+                chunk = decompress(chunk, max_output_size=size)
+        if len(chunk) != size:
+            break
+        data += chunk
+    return bytes(data)
+
+
+def escape(data):
+    out = []
+    for c in data:
+        if c == ord('<'):
+            out.append('&lt;')
+        elif c == ord('>'):
+            out.append('&gt;')
+        elif c == ord('&'):
+            out.append('&amp;')
+        elif c == ord("'"):
+            out.append('&apos;')
+        elif c == ord('"'):
+            out.append('&quot;')
+        elif 0x20 <= c <= 0x7e:
+            out.append(chr(c))
+        else:
+            out.append(f'&#{c};')
+    return ''.join(out)
+
+
+class Converter:
+
+    def __init__(self, data, out):
+        self.data = data
+        self.pos = 0
+        self.out = out
+        self.names = {}
+
+    def uint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def int(self):
+        value = self.uint()
+        return (value >> 1) ^ -(value & 1)
+
+    def bytes(self):
+        size = self.uint()
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def name(self):
+        return escape(self.names[self.uint()])
+
+    def convert(self):
+        write = self.out.write
+
+        write("<?xml version='1.0' encoding='UTF-8'?>\n")
+        write("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n")
+        write("<trace version='0.1'>\n")
+
+        while self.pos < len(self.data):
+            op = self.data[self.pos]
+            self.pos += 1
+
+            if op == NAME:
+                index = self.uint()
+                self.names[index] = self.bytes()
+            elif op == CALL_BEGIN:
+                no = self.uint()
+                klass = self.name()
+                method = self.name()
+                write(f"\t<call no='{no}' class='{klass}' method='{method}'>\n")
+            elif op == CALL_END:
+                write(f'\t\t<time><int>{self.int()}</int></time>\n')
+                write('\t</call>\n')
+            elif op == ARG_BEGIN:
+                write(f"\t\t<arg name='{self.name()}'>")
+            elif op == ARG_END:
+                write('</arg>\n')
+            elif op == RET_BEGIN:
+                write('\t\t<ret>')
+            elif op == RET_END:
+                write('</ret>\n')
+            elif op == FALSE:
+                write('<bool>0</bool>')
+            elif op == TRUE:
+                write('<bool>1</bool>')
+            elif op == INT:
+                write(f'<int>{self.int()}</int>')
+            elif op == UINT:
+                write(f'<uint>{self.uint()}</uint>')
+            elif op == FLOAT:
+                value, = struct.unpack_from('<d', self.data, self.pos)
+                self.pos += 8
+                write('<float>%g</float>' % value)
+            elif op == BYTES:
+                write(f'<bytes>{self.bytes().hex().upper()}</bytes>')
+            elif op == STRING:
+                write(f'<string>{escape(self.bytes())}</string>')
+            elif op == ENUM:
+                write(f'<enum>{self.name()}</enum>')
+            elif op == ARRAY_BEGIN:
+                write('<array>')
+            elif op == ARRAY_END:
+                write('</array>')
+            elif op == ELEM_BEGIN:
+                write('<elem>')
+            elif op == ELEM_END:
+                write('</elem>')
+            elif op == STRUCT_BEGIN:
+                write(f"<struct name='{self.name()}'>")
+            elif op == STRUCT_END:
+                write('</struct>')
+            elif op == MEMBER_BEGIN:
+                write(f"<member name='{self.name()}'>")
+            elif op == MEMBER_END:
+                write('</member>')
+            elif op == NULL:
+                write('<null/>')
+            elif op == PTR:
+                write('<ptr>0x%08x</ptr>' % self.uint())
+            elif op == NIR:
+                text = self.bytes().decode('utf-8', errors='replace')
+                write(f'<string><![CDATA[{text}]]></string>')
+            else:
+                raise FormatError(f'unknown token {op} at {self.pos - 1}')
+
+        write('</trace>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', type=argparse.FileType('rb'),
+                        help='binary trace')
+    parser.add_argument('output', type=argparse.FileType('w'), nargs='?',
+                        default=sys.stdout, help='XML trace (default: stdout)')
+    args = parser.parse_args()
+
+    try:
+        Converter(read_chunks(args.input), args.output).convert()
+    except (FormatError, IndexError, KeyError) as e:
+        sys.exit(f'{args.input.name}: {e}')
+
+
+if __name__ == '__main__':
+    main()
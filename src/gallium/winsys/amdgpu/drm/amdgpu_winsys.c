@@ -170,6 +170,7 @@ static uint64_t amdgpu_query_value(struct radeon_winsys *rws,
 {
    struct amdgpu_winsys *aws = amdgpu_winsys(rws);
    struct amdgpu_heap_info heap = {0};
+   struct pb_cache_stats cache_stats;
    uint64_t retval = 0;
 
    switch (value) {
@@ -189,6 +190,21 @@ static uint64_t amdgpu_query_value(struct radeon_winsys *rws,
       return aws->buffer_wait_time;
    case RADEON_NUM_MAPPED_BUFFERS:
       return aws->num_mapped_buffers;
+   case RADEON_BO_CACHE_HITS:
+      pb_cache_get_stats(&aws->bo_cache, &cache_stats);
+      return cache_stats.hits;
+   case RADEON_BO_CACHE_MISSES:
+      pb_cache_get_stats(&aws->bo_cache, &cache_stats);
+      return cache_stats.misses;
+   case RADEON_BO_CACHE_EXPIRED:
+      pb_cache_get_stats(&aws->bo_cache, &cache_stats);
+      return cache_stats.expired;
+   case RADEON_BO_CACHE_TRIMMED:
+      pb_cache_get_stats(&aws->bo_cache, &cache_stats);
+      return cache_stats.trimmed;
+   case RADEON_BO_CACHE_SIZE:
+      pb_cache_get_stats(&aws->bo_cache, &cache_stats);
+      return cache_stats.cache_size;
    case RADEON_TIMESTAMP:
       ac_drm_query_info(aws->dev, AMDGPU_INFO_TIMESTAMP, 8, &retval);
       return retval;
@@ -720,6 +720,7 @@ static uint64_t radeon_query_value(struct radeon_winsys *rws,
                                    enum radeon_value_id value)
 {
    struct radeon_drm_winsys *ws = (struct radeon_drm_winsys*)rws;
+   struct pb_cache_stats cache_stats;
    uint64_t retval = 0;
 
    switch (value) {
@@ -735,6 +736,21 @@ static uint64_t radeon_query_value(struct radeon_winsys *rws,
       return ws->buffer_wait_time;
    case RADEON_NUM_MAPPED_BUFFERS:
       return ws->num_mapped_buffers;
+   case RADEON_BO_CACHE_HITS:
+      pb_cache_get_stats(&ws->bo_cache, &cache_stats);
+      return cache_stats.hits;
+   case RADEON_BO_CACHE_MISSES:
+      pb_cache_get_stats(&ws->bo_cache, &cache_stats);
+      return cache_stats.misses;
+   case RADEON_BO_CACHE_EXPIRED:
+      pb_cache_get_stats(&ws->bo_cache, &cache_stats);
+      return cache_stats.expired;
+   case RADEON_BO_CACHE_TRIMMED:
+      pb_cache_get_stats(&ws->bo_cache, &cache_stats);
+      return cache_stats.trimmed;
+   case RADEON_BO_CACHE_SIZE:
+      pb_cache_get_stats(&ws->bo_cache, &cache_stats);
+      return cache_stats.cache_size;
    case RADEON_TIMESTAMP:
       if (ws->gen < DRV_R600) {
          assert(0);
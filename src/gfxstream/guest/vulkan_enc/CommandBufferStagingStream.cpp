@@ -11,7 +11,6 @@
 #include <unistd.h>
 
 #include <atomic>
-#include <vector>
 
 #include "util/log.h"
 
@@ -110,20 +109,20 @@ CommandBufferStagingStream::CommandBufferStagingStream(const Alloc& allocFn, con
         // ꜛ               ꜛ
         // [copyLocation]  ptr to data [ptr]
 
-        const size_t toCopySize = m_writePos + kSyncDataSize;
-        unsigned char* copyLocation = static_cast<unsigned char*>(mem.ptr);
-        std::vector<uint8_t> tmp(copyLocation, copyLocation + toCopySize);
-        m_free(mem);
-
-        // get new buffer and copy previous stream data to it
+        // get new buffer first, so previous stream data is copied to it
+        // directly instead of through a temporary copy of the whole stream
         Memory newMemory = m_alloc(size);
         unsigned char* newBuf = static_cast<unsigned char*>(newMemory.ptr);
         if (!newBuf) {
             mesa_loge("Custom allocation (%zu bytes) failed\n", size);
+            m_free(mem);
             return newMemory;
         }
-        // copy previous data
-        memcpy(newBuf, tmp.data(), toCopySize);
+
+        const size_t toCopySize = m_writePos + kSyncDataSize;
+        const unsigned char* copyLocation = static_cast<const unsigned char*>(mem.ptr);
+        memcpy(newBuf, copyLocation, toCopySize);
+        m_free(mem);
 
         return newMemory;
     };
@@ -5,6 +5,7 @@
 #include "HostVisibleMemoryVirtualization.h"
 #include "util/detect_os.h"
 
+#include <algorithm>
 #include <set>
 
 #include "ResourceTracker.h"
@@ -17,7 +18,7 @@ namespace vk {
 CoherentMemory::CoherentMemory(VirtGpuResourceMappingPtr blobMapping, uint64_t size,
                                VkDevice device, VkDeviceMemory memory)
     : mSize(size), mBlobMapping(blobMapping), mDevice(device), mMemory(memory) {
-    mHeap = u_mmInit(0, kHostVisibleHeapSize);
+    mHeap = u_mmInit(0, (int)std::min<uint64_t>(size, INT32_MAX));
     mBaseAddr = blobMapping->asRawPtr();
 }
 
@@ -25,7 +26,7 @@ CoherentMemory::CoherentMemory(VirtGpuResourceMappingPtr blobMapping, uint64_t s
 CoherentMemory::CoherentMemory(GoldfishAddressSpaceBlockPtr block, uint64_t gpuAddr, uint64_t size,
                                VkDevice device, VkDeviceMemory memory)
     : mSize(size), mBlock(block), mDevice(device), mMemory(memory) {
-    mHeap = u_mmInit(0, kHostVisibleHeapSize);
+    mHeap = u_mmInit(0, (int)std::min<uint64_t>(size, INT32_MAX));
     mBaseAddr = (uint8_t*)block->mmap(gpuAddr);
 }
 #endif  // DETECT_OS_ANDROID
@@ -39,6 +40,10 @@ CoherentMemory::~CoherentMemory() {
 VkDeviceMemory CoherentMemory::getDeviceMemory() const { return mMemory; }
 
 bool CoherentMemory::subAllocate(uint64_t size, uint8_t** ptr, uint64_t& offset) {
+    // The heap covers exactly the host allocation, so a full block fails here
+    // instead of handing out offsets past the end of the mapping.
+    if (!mHeap || size > mSize || size > INT32_MAX) return false;
+
     auto block = u_mmAllocMem(mHeap, (int)size, 0, 0);
     if (!block) return false;
 
@@ -20,7 +20,6 @@ constexpr uint64_t kMegaByte = 1048576;
 constexpr uint64_t kLargestPageSize = 65536;
 
 constexpr uint64_t kDefaultHostMemBlockSize = 16 * kMegaByte;  // 16 mb
-constexpr uint64_t kHostVisibleHeapSize = 512 * kMegaByte;     // 512 mb
 
 namespace gfxstream {
 namespace vk {
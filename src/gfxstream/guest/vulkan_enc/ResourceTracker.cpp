@@ -203,14 +203,12 @@ struct CommandBufferPendingDescriptorSets {
         info_##type[obj] = type##_Info();                  \
     }
 
-#define HANDLE_UNREGISTER_IMPL_IMPL(type)                  \
-    void ResourceTracker::unregister_##type(type obj) {    \
-        std::lock_guard<std::recursive_mutex> lock(mLock); \
-        info_##type.erase(obj);                            \
-    }
+#define HANDLE_REGISTER_TRIVIAL_IMPL_IMPL(type)     \
+    void ResourceTracker::register_##type(type) {}  \
+    void ResourceTracker::unregister_##type(type) {}
 
-GOLDFISH_VK_LIST_HANDLE_TYPES(HANDLE_REGISTER_IMPL_IMPL)
-GOLDFISH_VK_LIST_TRIVIAL_HANDLE_TYPES(HANDLE_UNREGISTER_IMPL_IMPL)
+GOLDFISH_VK_LIST_TRACKED_HANDLE_TYPES(HANDLE_REGISTER_IMPL_IMPL)
+GOLDFISH_VK_LIST_TRIVIAL_HANDLE_TYPES(HANDLE_REGISTER_TRIVIAL_IMPL_IMPL)
 uint32_t getWaitSemaphoreCount(const VkSubmitInfo& pSubmit) { return pSubmit.waitSemaphoreCount; }
 
 uint32_t getWaitSemaphoreCount(const VkSubmitInfo2& pSubmit) {
@@ -3217,17 +3215,22 @@ VkResult ResourceTracker::getCoherentMemory(const VkMemoryAllocateInfo* pAllocat
     CoherentMemoryPtr coherentMemory = nullptr;
     uint8_t* ptr = nullptr;
     uint64_t offset = 0;
-    {
+    if (!dedicated) {
         std::lock_guard<std::recursive_mutex> lock(mLock);
+        // Every suballocation shares its block's CoherentMemory, only try
+        // each block once.
+        std::unordered_set<const CoherentMemory*> triedBlocks;
         for (const auto& [memory, info] : info_VkDeviceMemory) {
             if (info.device != device) continue;
 
             if (info.memoryTypeIndex != pAllocateInfo->memoryTypeIndex) continue;
 
-            if (info.dedicated || dedicated) continue;
+            if (info.dedicated) continue;
 
             if (!info.coherentMemory) continue;
 
+            if (!triedBlocks.insert(info.coherentMemory.get()).second) continue;
+
             if (!info.coherentMemory->subAllocate(pAllocateInfo->allocationSize, &ptr, offset))
                 continue;
 
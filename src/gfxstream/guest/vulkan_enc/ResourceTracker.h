@@ -933,7 +933,7 @@ class ResourceTracker {
 
 #define HANDLE_REGISTER_DECLARATION(type) std::unordered_map<type, type##_Info> info_##type;
 
-    GOLDFISH_VK_LIST_HANDLE_TYPES(HANDLE_REGISTER_DECLARATION)
+    GOLDFISH_VK_LIST_TRACKED_HANDLE_TYPES(HANDLE_REGISTER_DECLARATION)
 
     std::unordered_map<const VkEncoder*, std::unordered_map<void*, CleanupCallback>>
         mEncoderCleanupCallbacks;
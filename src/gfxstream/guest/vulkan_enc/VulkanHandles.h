@@ -11,11 +11,14 @@ namespace vk {
 
 #define GOLDFISH_VK_LIST_TRIVIAL_DISPATCHABLE_HANDLE_TYPES(f) f(VkPhysicalDevice)
 
-#define GOLDFISH_VK_LIST_DISPATCHABLE_HANDLE_TYPES(f) \
-    f(VkInstance)                                     \
-    f(VkDevice)                                       \
-    f(VkCommandBuffer)                                \
-    f(VkQueue)                                        \
+#define GOLDFISH_VK_LIST_TRACKED_DISPATCHABLE_HANDLE_TYPES(f) \
+    f(VkInstance)                                             \
+    f(VkDevice)                                               \
+    f(VkCommandBuffer)                                        \
+    f(VkQueue)
+
+#define GOLDFISH_VK_LIST_DISPATCHABLE_HANDLE_TYPES(f)     \
+    GOLDFISH_VK_LIST_TRACKED_DISPATCHABLE_HANDLE_TYPES(f) \
     GOLDFISH_VK_LIST_TRIVIAL_DISPATCHABLE_HANDLE_TYPES(f)
 
 #ifdef VK_NVX_binary_import
@@ -112,25 +115,34 @@ namespace vk {
     __GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES_NV_RAY_TRACING(f)                \
     __GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES_KHR_ACCELERATION_STRUCTURE(f)
 
-#define GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES(f)       \
-    f(VkDeviceMemory)                                           \
-    f(VkBuffer)                                                 \
-    f(VkImage)                                                  \
-    f(VkSemaphore)                                              \
-    f(VkDescriptorUpdateTemplate)                               \
-    f(VkFence)                                                  \
-    f(VkDescriptorPool)                                         \
-    f(VkDescriptorSet)                                          \
-    f(VkDescriptorSetLayout)                                    \
-    f(VkCommandPool)                                            \
-    f(VkSampler)                                                \
-    __GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES_FUCHSIA(f) \
+#define GOLDFISH_VK_LIST_TRACKED_NON_DISPATCHABLE_HANDLE_TYPES(f) \
+    f(VkDeviceMemory)                                             \
+    f(VkBuffer)                                                   \
+    f(VkImage)                                                    \
+    f(VkSemaphore)                                                \
+    f(VkDescriptorUpdateTemplate)                                 \
+    f(VkFence)                                                    \
+    f(VkDescriptorPool)                                           \
+    f(VkDescriptorSet)                                            \
+    f(VkDescriptorSetLayout)                                      \
+    f(VkCommandPool)                                              \
+    f(VkSampler)                                                  \
+    __GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES_FUCHSIA(f)
+
+#define GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES(f)     \
+    GOLDFISH_VK_LIST_TRACKED_NON_DISPATCHABLE_HANDLE_TYPES(f) \
     GOLDFISH_VK_LIST_TRIVIAL_NON_DISPATCHABLE_HANDLE_TYPES(f)
 
 #define GOLDFISH_VK_LIST_HANDLE_TYPES(f)          \
     GOLDFISH_VK_LIST_DISPATCHABLE_HANDLE_TYPES(f) \
     GOLDFISH_VK_LIST_NON_DISPATCHABLE_HANDLE_TYPES(f)
 
+// Handle types ResourceTracker keeps an info map for.  The trivial ones
+// carry no guest-side state, so registering them doesn't take the lock.
+#define GOLDFISH_VK_LIST_TRACKED_HANDLE_TYPES(f)          \
+    GOLDFISH_VK_LIST_TRACKED_DISPATCHABLE_HANDLE_TYPES(f) \
+    GOLDFISH_VK_LIST_TRACKED_NON_DISPATCHABLE_HANDLE_TYPES(f)
+
 #define GOLDFISH_VK_LIST_TRIVIAL_HANDLE_TYPES(f)          \
     GOLDFISH_VK_LIST_TRIVIAL_DISPATCHABLE_HANDLE_TYPES(f) \
     GOLDFISH_VK_LIST_TRIVIAL_NON_DISPATCHABLE_HANDLE_TYPES(f)
@@ -102,6 +102,7 @@ intel_measure_init(struct intel_measure_device *device)
       const char *buffer_size_s = strstr(env_copy, "buffer_size=");
       const char *cpu_s = strstr(env_copy, "cpu");
       const char *no_ogl = strstr(env_copy, "nogl");
+      const char *json_s = strstr(env_copy, "json");
       while (true) {
          char *sep = strrchr(env_copy, ',');
          if (sep == NULL)
@@ -214,6 +215,10 @@ intel_measure_init(struct intel_measure_device *device)
       if (cpu_s) {
          config.cpu_measure = true;
       }
+
+      if (json_s) {
+         config.json_output = true;
+      }
    }
 
    device->config = NULL;
@@ -573,6 +578,25 @@ buffered_event_count(struct intel_measure_device *device)
    return 0;
 }
 
+/**
+ * Write str as a JSON string.  Event names may come from application debug
+ * labels, so they need escaping.
+ */
+static void
+print_json_string(const char *str)
+{
+   fputc('"', config.file);
+   for (const char *c = str; *c; c++) {
+      if (*c == '"' || *c == '\\')
+         fprintf(config.file, "\\%c", *c);
+      else if ((unsigned char)*c < 0x20)
+         fprintf(config.file, "\\u%04x", *c);
+      else
+         fputc(*c, config.file);
+   }
+   fputc('"', config.file);
+}
+
 /**
  * Take result_count events from the ringbuffer and output them as a single
  * line.
@@ -615,6 +639,28 @@ print_combined_results(struct intel_measure_device *measure_device,
    const struct intel_measure_snapshot *begin = &start_result->snapshot;
    uint32_t renderpass = (start_result->primary_renderpass)
       ? start_result->primary_renderpass : begin->renderpass;
+
+   if (config.json_output) {
+      fprintf(config.file, "{\"draw_start\":%"PRIu64",\"draw_end\":%"PRIu64","
+              "\"frame\":%u,\"batch\":%u,\"batch_size\":%"PRIu64","
+              "\"renderpass\":%u,\"event_index\":%u,\"event_count\":%u,"
+              "\"type\":",
+              start_result->start_ts, current_result->end_ts,
+              start_result->frame,
+              start_result->batch_count, start_result->batch_size,
+              renderpass, start_result->event_index, event_count);
+      print_json_string(begin->event_name);
+      fprintf(config.file, ",\"count\":%u,\"vs\":%u,\"tcs\":%u,\"tes\":%u,"
+              "\"gs\":%u,\"fs\":%u,\"cs\":%u,\"ms\":%u,\"ts\":%u,"
+              "\"idle_us\":%.3lf,\"time_us\":%.3lf}\n",
+              begin->count,
+              begin->vs, begin->tcs, begin->tes, begin->gs,
+              begin->fs, begin->cs, begin->ms, begin->ts,
+              (double)duration_idle_ns / 1000.0,
+              (double)duration_time_ns / 1000.0);
+      return;
+   }
+
    fprintf(config.file, "%"PRIu64",%"PRIu64",%u,%u,%"PRIu64",%u,%u,%u,%s,%u,"
            "0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,0x%x,%.3lf,%.3lf\n",
            start_result->start_ts, current_result->end_ts,
@@ -643,6 +689,17 @@ intel_measure_print_cpu_result(unsigned int frame,
    assert(config.cpu_measure);
    uint64_t start_ns = os_time_get_nano();
 
+   if (config.json_output) {
+      fprintf(config.file, "{\"draw_start\":%"PRIu64",\"frame\":%u,"
+              "\"batch\":%u,\"batch_size\":%"PRIu64",\"event_index\":%u,"
+              "\"event_count\":%u,\"type\":",
+              start_ns, frame, batch_count, batch_size,
+              event_index, event_count);
+      print_json_string(event_name);
+      fprintf(config.file, ",\"count\":%u}\n", count);
+      return;
+   }
+
    fprintf(config.file, "%"PRIu64",%u,%3u,%"PRIu64",%3u,%u,%s,%u\n",
            start_ns, frame, batch_count, batch_size,
            event_index, event_count, event_name, count);
@@ -665,15 +722,18 @@ intel_measure_print(struct intel_measure_device *device,
       free(config.deferred_create_filename);
       config.deferred_create_filename = NULL;
 
-      if (!config.cpu_measure)
-         fputs("draw_start,draw_end,frame,batch,batch_size,renderpass,"
-               "event_index,event_count,type,count,vs,tcs,tes,"
-               "gs,fs,cs,ms,ts,idle_us,time_us\n",
-               config.file);
-      else
-         fputs("draw_start,frame,batch,batch_size,event_index,event_count,"
-               "type,count\n",
-               config.file);
+      /* JSON lines carry their field names, so there is no header. */
+      if (!config.json_output) {
+         if (!config.cpu_measure)
+            fputs("draw_start,draw_end,frame,batch,batch_size,renderpass,"
+                  "event_index,event_count,type,count,vs,tcs,tes,"
+                  "gs,fs,cs,ms,ts,idle_us,time_us\n",
+                  config.file);
+         else
+            fputs("draw_start,frame,batch,batch_size,event_index,event_count,"
+                  "type,count\n",
+                  config.file);
+      }
    }
 
    while (true) {
@@ -109,6 +109,11 @@ struct intel_measure_config {
 
    /* Measure CPU timing, not GPU timing */
    bool                       cpu_measure;
+
+   /* Write one JSON object per line instead of CSV.  Set with
+    * INTEL_MEASURE=json
+    */
+   bool                       json_output;
 };
 
 struct intel_measure_batch;
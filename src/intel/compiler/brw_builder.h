@@ -254,7 +254,7 @@ public:
    brw_inst *
    emit(const brw_inst &inst) const
    {
-      return emit(new(shader->mem_ctx) brw_inst(inst));
+      return emit(new(shader->inst_ctx) brw_inst(inst, shader->inst_ctx));
    }
 
    /**
@@ -46,19 +46,19 @@ pop_stack(exec_list *list)
 }
 
 static exec_node *
-link(void *mem_ctx, bblock_t *block, enum bblock_link_kind kind)
+link(linear_ctx *lin_ctx, bblock_t *block, enum bblock_link_kind kind)
 {
-   bblock_link *l = new(mem_ctx) bblock_link(block, kind);
+   bblock_link *l = new(lin_ctx) bblock_link(block, kind);
    return &l->link;
 }
 
 void
-push_stack(exec_list *list, void *mem_ctx, bblock_t *block)
+push_stack(exec_list *list, linear_ctx *lin_ctx, bblock_t *block)
 {
    /* The kind of the link is immaterial, but we need to provide one since
     * this is (ab)using the edge data structure in order to implement a stack.
     */
-   list->push_tail(link(mem_ctx, block, bblock_link_logical));
+   list->push_tail(link(lin_ctx, block, bblock_link_logical));
 }
 
 bblock_t::bblock_t(cfg_t *cfg) :
@@ -70,11 +70,11 @@ bblock_t::bblock_t(cfg_t *cfg) :
 }
 
 void
-bblock_t::add_successor(void *mem_ctx, bblock_t *successor,
+bblock_t::add_successor(linear_ctx *lin_ctx, bblock_t *successor,
                         enum bblock_link_kind kind)
 {
-   successor->parents.push_tail(::link(mem_ctx, this, kind));
-   children.push_tail(::link(mem_ctx, successor, kind));
+   successor->parents.push_tail(::link(lin_ctx, this, kind));
+   children.push_tail(::link(lin_ctx, successor, kind));
 }
 
 bool
@@ -178,12 +178,10 @@ bblock_t::unlink_list(exec_list *list)
       foreach_list_typed_safe(bblock_link, sub_link, link, sub_list) {
          if (sub_link->block == this) {
             sub_link->link.remove();
-            ralloc_free(sub_link);
          }
       }
 
       link->link.remove();
-      ralloc_free(link);
    }
 }
 
@@ -191,6 +189,7 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
    s(s)
 {
    mem_ctx = ralloc_context(NULL);
+   lin_ctx = linear_context(mem_ctx);
    block_list.make_empty();
    blocks = NULL;
    num_blocks = 0;
@@ -218,7 +217,7 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
       case SHADER_OPCODE_FLOW:
          cur->instructions.push_tail(inst);
          next = new_block();
-         cur->add_successor(mem_ctx, next, bblock_link_logical);
+         cur->add_successor(lin_ctx, next, bblock_link_logical);
          set_next_block(&cur, next, ip);
          break;
 
@@ -228,8 +227,8 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
 	 /* Push our information onto a stack so we can recover from
 	  * nested ifs.
 	  */
-         push_stack(&if_stack, mem_ctx, cur_if);
-         push_stack(&else_stack, mem_ctx, cur_else);
+         push_stack(&if_stack, lin_ctx, cur_if);
+         push_stack(&else_stack, lin_ctx, cur_else);
 
 	 cur_if = cur;
 	 cur_else = NULL;
@@ -238,7 +237,7 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
 	  * instructions.
 	  */
 	 next = new_block();
-         cur_if->add_successor(mem_ctx, next, bblock_link_logical);
+         cur_if->add_successor(lin_ctx, next, bblock_link_logical);
 
 	 set_next_block(&cur, next, ip);
 	 break;
@@ -250,8 +249,8 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
 
 	 next = new_block();
          assert(cur_if != NULL);
-         cur_if->add_successor(mem_ctx, next, bblock_link_logical);
-         cur_else->add_successor(mem_ctx, next, bblock_link_physical);
+         cur_if->add_successor(lin_ctx, next, bblock_link_logical);
+         cur_else->add_successor(lin_ctx, next, bblock_link_physical);
 
 	 set_next_block(&cur, next, ip);
 	 break;
@@ -265,7 +264,7 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
          } else {
             cur_endif = new_block();
 
-            cur->add_successor(mem_ctx, cur_endif, bblock_link_logical);
+            cur->add_successor(lin_ctx, cur_endif, bblock_link_logical);
 
             set_next_block(&cur, cur_endif, ip - 1);
          }
@@ -273,10 +272,10 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
          cur->instructions.push_tail(inst);
 
          if (cur_else) {
-            cur_else->add_successor(mem_ctx, cur_endif, bblock_link_logical);
+            cur_else->add_successor(lin_ctx, cur_endif, bblock_link_logical);
          } else {
             assert(cur_if != NULL);
-            cur_if->add_successor(mem_ctx, cur_endif, bblock_link_logical);
+            cur_if->add_successor(lin_ctx, cur_endif, bblock_link_logical);
          }
 
          assert(cur_if->end()->opcode == BRW_OPCODE_IF);
@@ -291,8 +290,8 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
 	 /* Push our information onto a stack so we can recover from
 	  * nested loops.
 	  */
-         push_stack(&do_stack, mem_ctx, cur_do);
-         push_stack(&while_stack, mem_ctx, cur_while);
+         push_stack(&do_stack, lin_ctx, cur_do);
+         push_stack(&while_stack, lin_ctx, cur_while);
 
 	 /* Set up the block just after the while.  Don't know when exactly
 	  * it will start, yet.
@@ -305,7 +304,7 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
          } else {
             cur_do = new_block();
 
-            cur->add_successor(mem_ctx, cur_do, bblock_link_logical);
+            cur->add_successor(lin_ctx, cur_do, bblock_link_logical);
 
             set_next_block(&cur, cur_do, ip - 1);
          }
@@ -339,8 +338,8 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
           * corruption.
           */
          next = new_block();
-         cur->add_successor(mem_ctx, next, bblock_link_logical);
-         cur->add_successor(mem_ctx, cur_while, bblock_link_physical);
+         cur->add_successor(lin_ctx, next, bblock_link_logical);
+         cur->add_successor(lin_ctx, cur_while, bblock_link_physical);
          set_next_block(&cur, next, ip);
 	 break;
 
@@ -361,13 +360,13 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
           * loop, the top of the loop again, into a use of the variable).
           */
          assert(cur_do != NULL);
-         cur->add_successor(mem_ctx, cur_do->next(), bblock_link_logical);
+         cur->add_successor(lin_ctx, cur_do->next(), bblock_link_logical);
 
 	 next = new_block();
 	 if (inst->predicate)
-            cur->add_successor(mem_ctx, next, bblock_link_logical);
+            cur->add_successor(lin_ctx, next, bblock_link_logical);
          else
-            cur->add_successor(mem_ctx, next, bblock_link_physical);
+            cur->add_successor(lin_ctx, next, bblock_link_physical);
 
 	 set_next_block(&cur, next, ip);
 	 break;
@@ -386,14 +385,14 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
           * See the DO case for additional explanation.
           */
          assert(cur_do != NULL);
-         cur->add_successor(mem_ctx, cur_do, bblock_link_physical);
-         cur->add_successor(mem_ctx, cur_while, bblock_link_logical);
+         cur->add_successor(lin_ctx, cur_do, bblock_link_physical);
+         cur->add_successor(lin_ctx, cur_while, bblock_link_logical);
 
 	 next = new_block();
 	 if (inst->predicate)
-            cur->add_successor(mem_ctx, next, bblock_link_logical);
+            cur->add_successor(lin_ctx, next, bblock_link_logical);
          else
-            cur->add_successor(mem_ctx, next, bblock_link_physical);
+            cur->add_successor(lin_ctx, next, bblock_link_physical);
 
 	 set_next_block(&cur, next, ip);
 	 break;
@@ -413,9 +412,9 @@ cfg_t::cfg_t(const brw_shader *s, exec_list *instructions) :
           * the loop to keep the CFG as unambiguous as possible.
           */
          if (inst->predicate) {
-            cur->add_successor(mem_ctx, cur_do, bblock_link_logical);
+            cur->add_successor(lin_ctx, cur_do, bblock_link_logical);
          } else {
-            cur->add_successor(mem_ctx, cur_do->next(), bblock_link_logical);
+            cur->add_successor(lin_ctx, cur_do->next(), bblock_link_logical);
          }
 
 	 set_next_block(&cur, cur_while, ip);
@@ -458,7 +457,6 @@ cfg_t::remove_block(bblock_t *block)
          if (block == successor->block) {
             old_link_kind = successor->kind;
             successor->link.remove();
-            ralloc_free(successor);
             break;
          }
       }
@@ -485,7 +483,7 @@ cfg_t::remove_block(bblock_t *block)
          }
 
          if (need_to_link) {
-            predecessor->block->children.push_tail(link(mem_ctx,
+            predecessor->block->children.push_tail(link(lin_ctx,
                                                         successor->block,
                                                         new_link_kind));
          }
@@ -506,7 +504,6 @@ cfg_t::remove_block(bblock_t *block)
          if (block == predecessor->block) {
             old_link_kind = predecessor->kind;
             predecessor->link.remove();
-            ralloc_free(predecessor);
          }
       }
 
@@ -532,7 +529,7 @@ cfg_t::remove_block(bblock_t *block)
          }
 
          if (need_to_link) {
-            successor->block->parents.push_tail(link(mem_ctx,
+            successor->block->parents.push_tail(link(lin_ctx,
                                                      predecessor->block,
                                                      new_link_kind));
          }
@@ -553,7 +550,7 @@ cfg_t::remove_block(bblock_t *block)
 bblock_t *
 cfg_t::new_block()
 {
-   bblock_t *block = new(mem_ctx) bblock_t(this);
+   bblock_t *block = new(lin_ctx) bblock_t(this);
 
    return block;
 }
@@ -54,7 +54,7 @@ enum bblock_link_kind {
 };
 
 struct bblock_link {
-   DECLARE_RALLOC_CXX_OPERATORS(bblock_link)
+   DECLARE_LINEAR_ALLOC_CXX_OPERATORS(bblock_link)
 
    bblock_link(bblock_t *block, enum bblock_link_kind kind)
       : block(block), kind(kind)
@@ -75,11 +75,11 @@ struct brw_shader;
 struct cfg_t;
 
 struct bblock_t {
-   DECLARE_RALLOC_CXX_OPERATORS(bblock_t)
+   DECLARE_LINEAR_ALLOC_CXX_OPERATORS(bblock_t)
 
    explicit bblock_t(cfg_t *cfg);
 
-   void add_successor(void *mem_ctx, bblock_t *successor,
+   void add_successor(linear_ctx *lin_ctx, bblock_t *successor,
                       enum bblock_link_kind kind);
    bool is_predecessor_of(const bblock_t *block,
                           enum bblock_link_kind kind) const;
@@ -350,6 +350,12 @@ struct cfg_t {
    const struct brw_shader *s;
    void *mem_ctx;
 
+   /**
+    * Linear context for the blocks and the edges, which are only released
+    * with the CFG.
+    */
+   linear_ctx *lin_ctx;
+
    /** Ordered list (by ip) of basic blocks */
    struct exec_list block_list;
    struct bblock_t **blocks;
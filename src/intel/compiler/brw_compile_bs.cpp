@@ -114,7 +114,8 @@ compile_single_bs(const struct brw_compiler *compiler,
 
       const bool allow_spilling = !brw_simd_any_compiled(simd_state);
       if (run_bs(*v[simd], allow_spilling)) {
-         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
+         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers,
+                                v[simd]->performance_analysis.require().throughput);
       } else {
          simd_state.error[simd] = ralloc_strdup(params->base.mem_ctx,
                                                 v[simd]->fail_msg);
@@ -144,6 +145,7 @@ compile_single_bs(const struct brw_compiler *compiler,
 
    int offset = g->generate_code(selected->cfg, dispatch_width, selected->shader_stats,
                                  selected->performance_analysis.require(), stats);
+   brw_simd_fill_stats(simd_state, stats);
    if (prog_offset)
       *prog_offset = offset;
    else
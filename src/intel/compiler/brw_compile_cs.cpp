@@ -205,7 +205,8 @@ brw_compile_cs(const struct brw_compiler *compiler,
       if (run_cs(*v[simd], allow_spilling)) {
          cs_fill_push_const_info(compiler->devinfo, prog_data);
 
-         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
+         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers,
+                                v[simd]->performance_analysis.require().throughput);
 
          if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers &&
              !nir->info.workgroup_size_variable)
@@ -258,6 +259,7 @@ brw_compile_cs(const struct brw_compiler *compiler,
                             v[simd]->performance_analysis.require(), stats);
          if (stats)
             stats->max_dispatch_width = max_dispatch_width;
+         brw_simd_fill_stats(simd_state, stats);
          stats = stats ? stats + 1 : NULL;
 
          prog_data->base.grf_used = MAX2(prog_data->base.grf_used,
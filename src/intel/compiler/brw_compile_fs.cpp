@@ -15,6 +15,7 @@
 #include "shader_enums.h"
 #include "dev/intel_debug.h"
 #include "dev/intel_wa.h"
+#include "util/u_queue.h"
 
 #include <memory>
 
@@ -1529,6 +1530,98 @@ run_fs(brw_shader &s, bool allow_spilling, bool do_rep_send)
    return !s.failed;
 }
 
+namespace {
+
+/**
+ * A SIMD variant of a fragment shader compiled on the compiler thread pool,
+ * concurrently with the calling thread.  It has its own memory context,
+ * clone of the NIR and copy of the prog_data, so that it doesn't share any
+ * mutable state with the other variants.
+ */
+struct brw_fs_async_variant {
+   brw_fs_async_variant(const struct brw_compiler *compiler,
+                        const struct brw_compile_fs_params *params,
+                        const struct brw_wm_prog_data *prog_data,
+                        unsigned dispatch_width, brw_shader *uniforms_from)
+   {
+      base = params->base;
+      base.mem_ctx = ralloc_context(NULL);
+      base.nir = nir_shader_clone(base.mem_ctx, params->base.nir);
+
+      memcpy(&initial_prog_data, prog_data, sizeof(*prog_data));
+      memcpy(&variant_prog_data, prog_data, sizeof(*prog_data));
+
+      shader = std::make_unique<brw_shader>(compiler, &base, params->key,
+                                            &variant_prog_data, base.nir,
+                                            dispatch_width, 1,
+                                            base.stats != NULL,
+                                            false /* debug_enabled */);
+      shader->import_uniforms(uniforms_from);
+
+      util_queue_fence_init(&fence);
+   }
+
+   ~brw_fs_async_variant()
+   {
+      util_queue_fence_destroy(&fence);
+      shader.reset();
+      ralloc_free(base.mem_ctx);
+   }
+
+   static void
+   run(void *job, void *gdata, int thread_index)
+   {
+      brw_fs_async_variant *v = (brw_fs_async_variant *)job;
+      v->ok = run_fs(*v->shader, false /* allow_spilling */,
+                     false /* do_rep_send */);
+   }
+
+   void
+   start(struct util_queue *queue)
+   {
+      util_queue_add_job(queue, this, &fence, run, NULL, 0);
+   }
+
+   void
+   wait()
+   {
+      util_queue_fence_wait(&fence);
+   }
+
+   /**
+    * Applies the changes the variant made to its copy of the prog_data on
+    * top of \p prog_data, as if it had been compiled after the variants of
+    * the calling thread, and hands over the shader and its memory.
+    */
+   std::unique_ptr<brw_shader>
+   merge(struct brw_wm_prog_data *prog_data, void *mem_ctx)
+   {
+      const uint8_t *initial = (const uint8_t *)&initial_prog_data;
+      const uint8_t *src = (const uint8_t *)&variant_prog_data;
+      uint8_t *dst = (uint8_t *)prog_data;
+
+      for (size_t i = 0; i < sizeof(*prog_data); i++) {
+         if (src[i] != initial[i])
+            dst[i] = src[i];
+      }
+
+      ralloc_steal(mem_ctx, base.mem_ctx);
+      base.mem_ctx = NULL;
+
+      shader->prog_data = &prog_data->base;
+      return std::move(shader);
+   }
+
+   struct brw_compile_params base;
+   struct brw_wm_prog_data initial_prog_data;
+   struct brw_wm_prog_data variant_prog_data;
+   std::unique_ptr<brw_shader> shader;
+   struct util_queue_fence fence;
+   bool ok = false;
+};
+
+}
+
 const unsigned *
 brw_compile_fs(const struct brw_compiler *compiler,
                struct brw_compile_fs_params *params)
@@ -1735,6 +1828,22 @@ brw_compile_fs(const struct brw_compiler *compiler,
       }
 
    } else {
+      /* If SIMD8 compiled without spilling, SIMD16 and SIMD32 will most
+       * likely both be needed.  Compile SIMD32 on the thread pool while
+       * SIMD16 is compiled here.  The result is dropped below if SIMD16 ends
+       * up in a state where SIMD32 wouldn't have been tried at all.
+       */
+      std::unique_ptr<brw_fs_async_variant> async32;
+      if (compiler->simd_queue && !debug_enabled && simd8_cfg &&
+          !has_spilled && v8->max_dispatch_width >= 32 &&
+          reqd_dispatch_width == SUBGROUP_SIZE_VARYING &&
+          INTEL_SIMD(FS, 16) && INTEL_SIMD(FS, 32)) {
+         async32 = std::make_unique<brw_fs_async_variant>(compiler, params,
+                                                          prog_data, 32,
+                                                          v8.get());
+         async32->start(compiler->simd_queue);
+      }
+
       if ((!has_spilled && (!v8 || v8->max_dispatch_width >= 16) &&
            INTEL_SIMD(FS, 16)) ||
           reqd_dispatch_width == SUBGROUP_SIZE_REQUIRE_16) {
@@ -1767,11 +1876,22 @@ brw_compile_fs(const struct brw_compiler *compiler,
       const bool simd16_failed = v16 && !simd16_cfg;
 
       /* Currently, the compiler only supports SIMD32 on SNB+ */
-      if (!has_spilled &&
-          (!v8 || v8->max_dispatch_width >= 32) &&
-          (!v16 || v16->max_dispatch_width >= 32) &&
-          reqd_dispatch_width == SUBGROUP_SIZE_VARYING &&
-          !simd16_failed && INTEL_SIMD(FS, 32)) {
+      const bool try_simd32 =
+         !has_spilled &&
+         (!v8 || v8->max_dispatch_width >= 32) &&
+         (!v16 || v16->max_dispatch_width >= 32) &&
+         reqd_dispatch_width == SUBGROUP_SIZE_VARYING &&
+         !simd16_failed && INTEL_SIMD(FS, 32);
+
+      bool simd32_ok = false;
+      if (async32) {
+         async32->wait();
+         if (try_simd32) {
+            v32 = async32->merge(prog_data, params->base.mem_ctx);
+            simd32_ok = async32->ok;
+         }
+         async32.reset();
+      } else if (try_simd32) {
          /* Try a SIMD32 compile */
          v32 = std::make_unique<brw_shader>(compiler, &params->base, key,
                                             prog_data, nir, 32, 1,
@@ -1782,7 +1902,11 @@ brw_compile_fs(const struct brw_compiler *compiler,
          else if (v16)
             v32->import_uniforms(v16.get());
 
-         if (!run_fs(*v32, allow_spilling, false)) {
+         simd32_ok = run_fs(*v32, allow_spilling, false);
+      }
+
+      if (v32) {
+         if (!simd32_ok) {
             brw_shader_perf_log(compiler, params->base.log_data,
                                 "SIMD32 shader failed to compile: %s\n",
                                 v32->fail_msg);
@@ -1934,8 +2058,22 @@ brw_compile_fs(const struct brw_compiler *compiler,
       max_dispatch_width = 32;
    }
 
-   for (struct brw_compile_stats *s = params->base.stats; s != NULL && s != stats; s++)
+   /* Report the estimates of all the variants that were compiled, including
+    * the ones that were dropped, to make the SIMD width choice visible.
+    */
+   uint32_t simd_throughput[3] = {};
+   brw_shader *simd_variants[] = { v8.get(), v16.get(), v32.get() };
+   for (unsigned i = 0; i < ARRAY_SIZE(simd_variants); i++) {
+      if (simd_variants[i] && !simd_variants[i]->failed) {
+         const brw_performance &perf = simd_variants[i]->performance_analysis.require();
+         simd_throughput[i] = perf.throughput * 1000.0f;
+      }
+   }
+
+   for (struct brw_compile_stats *s = params->base.stats; s != NULL && s != stats; s++) {
       s->max_dispatch_width = max_dispatch_width;
+      memcpy(s->simd_throughput, simd_throughput, sizeof(simd_throughput));
+   }
 
    g.add_const_data(nir->constant_data, nir->constant_data_size);
    return g.get_assembly();
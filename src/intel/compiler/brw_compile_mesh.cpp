@@ -424,7 +424,8 @@ brw_compile_task(const struct brw_compiler *compiler,
       const bool allow_spilling = simd == 0 ||
          (!simd_state.compiled[simd - 1] && !brw_simd_should_compile(simd_state, simd - 1));
       if (run_task_mesh(*v[simd], allow_spilling)) {
-         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
+         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers,
+                                v[simd]->performance_analysis.require().throughput);
 
          if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers)
             break;
@@ -466,6 +467,7 @@ brw_compile_task(const struct brw_compiler *compiler,
 
    g.generate_code(selected->cfg, selected->dispatch_width, selected->shader_stats,
                    selected->performance_analysis.require(), params->base.stats);
+   brw_simd_fill_stats(simd_state, params->base.stats);
    g.add_const_data(nir->constant_data, nir->constant_data_size);
    return g.get_assembly();
 }
@@ -1745,7 +1747,8 @@ brw_compile_mesh(const struct brw_compiler *compiler,
       const bool allow_spilling = simd == 0 ||
          (!simd_state.compiled[simd - 1] && !brw_simd_should_compile(simd_state, simd - 1));
       if (run_task_mesh(*v[simd], allow_spilling)) {
-         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
+         brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers,
+                                v[simd]->performance_analysis.require().throughput);
 
          if (devinfo->ver >= 30 && !v[simd]->spilled_any_registers)
             break;
@@ -1791,6 +1794,7 @@ brw_compile_mesh(const struct brw_compiler *compiler,
 
    g.generate_code(selected->cfg, selected->dispatch_width, selected->shader_stats,
                    selected->performance_analysis.require(), params->base.stats);
+   brw_simd_fill_stats(simd_state, params->base.stats);
    g.add_const_data(nir->constant_data, nir->constant_data_size);
    return g.get_assembly();
 }
@@ -27,7 +27,9 @@
 #include "brw_private.h"
 #include "dev/intel_debug.h"
 #include "compiler/nir/nir.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
+#include "util/u_queue.h"
 
 const struct nir_shader_compiler_options brw_scalar_nir_options = {
    .avoid_ternary_with_two_constants = true,
@@ -85,6 +87,32 @@ const struct nir_shader_compiler_options brw_scalar_nir_options = {
    .compact_view_index = true,
 };
 
+static void
+brw_simd_queue_destroy(void *queue)
+{
+   util_queue_destroy((struct util_queue *)queue);
+}
+
+static void
+brw_init_simd_queue(struct brw_compiler *compiler)
+{
+   const int nr_cpus = util_get_cpu_caps()->nr_cpus;
+
+   if (nr_cpus < 2 ||
+       !debug_get_bool_option("INTEL_PARALLEL_SIMD_COMPILE", true))
+      return;
+
+   struct util_queue *queue = rzalloc(compiler, struct util_queue);
+   if (!util_queue_init(queue, "brw_simd", 32, MIN2(nr_cpus - 1, 4),
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL)) {
+      ralloc_free(queue);
+      return;
+   }
+
+   ralloc_set_destructor(queue, brw_simd_queue_destroy);
+   compiler->simd_queue = queue;
+}
+
 struct brw_compiler *
 brw_compiler_create(void *mem_ctx, const struct intel_device_info *devinfo)
 {
@@ -202,6 +230,8 @@ brw_compiler_create(void *mem_ctx, const struct intel_device_info *devinfo)
    compiler->mesh.mue_compaction =
          debug_get_bool_option("INTEL_MESH_COMPACTION", true);
 
+   brw_init_simd_queue(compiler);
+
    return compiler;
 }
 
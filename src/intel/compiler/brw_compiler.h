@@ -121,6 +121,12 @@ struct brw_compiler {
     */
    int spilling_rate;
 
+   /**
+    * Thread pool used to compile SIMD variants of fragment shaders
+    * concurrently, or NULL if they are compiled on the calling thread.
+    */
+   struct util_queue *simd_queue;
+
    struct nir_shader *clc_shader;
 
    struct {
@@ -1258,6 +1264,11 @@ struct brw_compile_stats {
    uint32_t fills;
    uint32_t max_live_registers;
    uint32_t non_ssa_registers_after_nir;
+   /**
+    * Estimated throughput of each SIMD variant that was compiled, selected or
+    * not, in invocations per 1000 cycles (0 if not compiled).
+    */
+   uint32_t simd_throughput[3];
 };
 
 /** @} */
@@ -11,6 +11,8 @@
 #include "brw_inst.h"
 #include "brw_isa_info.h"
 
+#include <new>
+
 static void
 initialize_sources(brw_inst *inst, const brw_reg src[], uint8_t num_sources);
 
@@ -100,20 +102,41 @@ brw_inst::brw_inst(enum opcode opcode, uint8_t exec_width, const brw_reg &dst,
 brw_inst::brw_inst(const brw_inst &that)
 {
    memcpy((void*)this, &that, sizeof(that));
+   this->src_ctx = NULL;
+   initialize_sources(this, that.src, that.sources);
+}
+
+brw_inst::brw_inst(const brw_inst &that, linear_ctx *ctx)
+{
+   memcpy((void*)this, &that, sizeof(that));
+   this->src_ctx = ctx;
    initialize_sources(this, that.src, that.sources);
 }
 
 brw_inst::~brw_inst()
 {
-   if (this->src != this->builtin_src)
+   if (this->src != this->builtin_src && this->src_ctx == NULL)
       delete[] this->src;
 }
 
+static brw_reg *
+allocate_sources(brw_inst *inst, uint8_t num_sources)
+{
+   if (inst->src_ctx == NULL)
+      return new brw_reg[num_sources];
+
+   brw_reg *src = (brw_reg *)
+      linear_alloc_child_array(inst->src_ctx, sizeof(brw_reg), num_sources);
+   for (unsigned i = 0; i < num_sources; i++)
+      new (&src[i]) brw_reg();
+   return src;
+}
+
 static void
 initialize_sources(brw_inst *inst, const brw_reg src[], uint8_t num_sources)
 {
    if (num_sources > ARRAY_SIZE(inst->builtin_src))
-      inst->src = new brw_reg[num_sources];
+      inst->src = allocate_sources(inst, num_sources);
    else
       inst->src = inst->builtin_src;
 
@@ -136,7 +159,7 @@ brw_inst::resize_sources(uint8_t num_sources)
 
    if (old_src == this->builtin_src) {
       if (num_sources > builtin_size) {
-         new_src = new brw_reg[num_sources];
+         new_src = allocate_sources(this, num_sources);
          for (unsigned i = 0; i < this->sources; i++)
             new_src[i] = old_src[i];
 
@@ -154,12 +177,13 @@ brw_inst::resize_sources(uint8_t num_sources)
          new_src = old_src;
 
       } else {
-         new_src = new brw_reg[num_sources];
+         new_src = allocate_sources(this, num_sources);
          for (unsigned i = 0; i < this->sources; i++)
             new_src[i] = old_src[i];
       }
 
-      if (old_src != new_src)
+      /* Sources from the linear context are released with it. */
+      if (old_src != new_src && this->src_ctx == NULL)
          delete[] old_src;
    }
 
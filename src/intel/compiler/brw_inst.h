@@ -46,7 +46,18 @@ private:
              const brw_reg *src, unsigned sources);
 
 public:
-   DECLARE_RALLOC_CXX_OPERATORS(brw_inst)
+   /**
+    * Instructions that are part of a program live in the linear context of
+    * the shader (brw_shader::inst_ctx) and are released all at once with it,
+    * so their destructor is never run.  Only temporaries on the stack own
+    * heap memory.
+    */
+   static void *operator new(size_t size, linear_ctx *ctx)
+   {
+      void *p = linear_alloc_child(ctx, size);
+      assert(p != NULL);
+      return p;
+   }
 
    brw_inst();
    brw_inst(enum opcode opcode, uint8_t exec_size);
@@ -60,6 +71,7 @@ public:
    brw_inst(enum opcode opcode, uint8_t exec_size, const brw_reg &dst,
            const brw_reg src[], unsigned sources);
    brw_inst(const brw_inst &that);
+   brw_inst(const brw_inst &that, linear_ctx *ctx);
    ~brw_inst();
 
    void resize_sources(uint8_t num_sources);
@@ -228,6 +240,12 @@ public:
    brw_reg *src;
    brw_reg builtin_src[4];
 
+   /**
+    * Linear context src is allocated from when it doesn't fit in
+    * builtin_src, or NULL if it's allocated from the heap.
+    */
+   linear_ctx *src_ctx;
+
 #ifndef NDEBUG
    /** @{
     * Annotation for the generated IR.
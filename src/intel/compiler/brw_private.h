@@ -61,6 +61,12 @@ struct brw_simd_selection_state {
 
    bool compiled[SIMD_COUNT];
    bool spilled[SIMD_COUNT];
+
+   /**
+    * Throughput estimate of each compiled variant from brw_performance, in
+    * invocations per cycle, or 0 if unknown.
+    */
+   float throughput[SIMD_COUNT];
 };
 
 inline int brw_simd_first_compiled(const brw_simd_selection_state &state)
@@ -81,10 +87,14 @@ unsigned brw_geometry_stage_dispatch_width(const struct intel_device_info *devin
 
 bool brw_simd_should_compile(brw_simd_selection_state &state, unsigned simd);
 
-void brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spilled);
+void brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spilled,
+                            float throughput = 0.0f);
 
 int brw_simd_select(const brw_simd_selection_state &state);
 
+void brw_simd_fill_stats(const brw_simd_selection_state &state,
+                         struct brw_compile_stats *stats);
+
 int brw_simd_select_for_workgroup_size(const struct intel_device_info *devinfo,
                                        const struct brw_cs_prog_data *prog_data,
                                        const unsigned *sizes);
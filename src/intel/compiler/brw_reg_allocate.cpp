@@ -32,6 +32,9 @@
 #include "util/set.h"
 #include "util/register_allocate.h"
 
+#include <algorithm>
+#include <climits>
+
 static void
 assign_reg(const struct intel_device_info *devinfo,
            unsigned *reg_hw_locations, brw_reg *reg)
@@ -269,9 +272,14 @@ public:
       last_vgrf_node = 0;
       first_spill_node = 0;
 
-      spill_vgrf_ip = NULL;
-      spill_vgrf_ip_alloc = 0;
+      spill_prev_at_ip = NULL;
+      spill_prev_at_ip_alloc = 0;
       spill_node_count = 0;
+      last_spill_at_ip = NULL;
+
+      vgrf_by_start = NULL;
+      vgrf_end_tree = NULL;
+      vgrf_tree_size = 0;
    }
 
    ~brw_reg_alloc()
@@ -282,8 +290,16 @@ public:
    bool assign_regs(bool allow_spilling, bool spill_all);
 
 private:
+   void setup_payload_interference(unsigned node, int node_start_ip);
    void setup_live_interference(unsigned node,
                                 int node_start_ip, int node_end_ip);
+   void build_vgrf_interval_tree();
+   void add_vgrf_interval_interference(unsigned node, int node_start_ip,
+                                       int node_end_ip, unsigned tree_node,
+                                       unsigned lo, unsigned hi,
+                                       unsigned count);
+   void setup_spill_live_interference(unsigned node,
+                                      int node_start_ip, int node_end_ip);
    void setup_inst_interference(const brw_inst *inst);
 
    void build_interference_graph(bool allow_spilling);
@@ -329,9 +345,26 @@ private:
    int last_vgrf_node;
    int first_spill_node;
 
-   int *spill_vgrf_ip;
-   int spill_vgrf_ip_alloc;
+   /* For each spill node, the previous spill node created for the same
+    * instruction, or -1.  last_spill_at_ip holds the most recent one for
+    * each instruction, so that the spill nodes of an instruction can be
+    * found without looking at all of them.
+    */
+   int *spill_prev_at_ip;
+   int spill_prev_at_ip_alloc;
    int spill_node_count;
+   int *last_spill_at_ip;
+
+   /* The original VGRFs sorted by the start of their live range, and an
+    * implicit binary tree over that order holding the maximum live end of
+    * each subtree.  The liveness isn't recomputed while spilling, so this is
+    * built once and lets the interference of every spill and fill register
+    * be set up from the VGRFs actually live around it, rather than from all
+    * of them.
+    */
+   int *vgrf_by_start;
+   int *vgrf_end_tree;
+   unsigned vgrf_tree_size;
 };
 
 namespace {
@@ -367,8 +400,7 @@ namespace {
 }
 
 void
-brw_reg_alloc::setup_live_interference(unsigned node,
-                                      int node_start_ip, int node_end_ip)
+brw_reg_alloc::setup_payload_interference(unsigned node, int node_start_ip)
 {
    /* Mark any virtual grf that is live between the start of the program and
     * the last use of a payload node interfering with that payload node.
@@ -384,6 +416,13 @@ brw_reg_alloc::setup_live_interference(unsigned node,
       if (node_start_ip <= payload_last_use_ip[i])
          ra_add_node_interference(g, node, first_payload_node + i);
    }
+}
+
+void
+brw_reg_alloc::setup_live_interference(unsigned node,
+                                      int node_start_ip, int node_end_ip)
+{
+   setup_payload_interference(node, node_start_ip);
 
    /* Add interference with every vgrf whose live range intersects this
     * node's.  We only need to look at nodes below this one as the reflexivity
@@ -1074,6 +1113,87 @@ brw_reg_alloc::choose_spill_reg()
    return node - first_vgrf_node;
 }
 
+void
+brw_reg_alloc::build_vgrf_interval_tree()
+{
+   const unsigned count = last_vgrf_node - first_vgrf_node + 1;
+
+   vgrf_by_start = ralloc_array(mem_ctx, int, count);
+   for (unsigned i = 0; i < count; i++)
+      vgrf_by_start[i] = i;
+
+   const brw_live_variables &l = live;
+   std::sort(vgrf_by_start, vgrf_by_start + count,
+             [&](int a, int b) { return l.vgrf_start[a] < l.vgrf_start[b]; });
+
+   vgrf_tree_size = 1;
+   while (vgrf_tree_size < count)
+      vgrf_tree_size *= 2;
+
+   vgrf_end_tree = ralloc_array(mem_ctx, int, 2 * vgrf_tree_size);
+   for (unsigned i = 0; i < vgrf_tree_size; i++) {
+      vgrf_end_tree[vgrf_tree_size + i] =
+         i < count ? live.vgrf_end[vgrf_by_start[i]] : INT_MIN;
+   }
+   for (unsigned i = vgrf_tree_size - 1; i > 0; i--)
+      vgrf_end_tree[i] = MAX2(vgrf_end_tree[2 * i], vgrf_end_tree[2 * i + 1]);
+}
+
+/**
+ * Adds interference between \p node and the VGRFs in the subtree
+ * \p tree_node, covering [lo, hi) of vgrf_by_start, whose position is below
+ * \p count and whose live range ends after \p node_start_ip.
+ */
+void
+brw_reg_alloc::add_vgrf_interval_interference(unsigned node, int node_start_ip,
+                                             int node_end_ip, unsigned tree_node,
+                                             unsigned lo, unsigned hi,
+                                             unsigned count)
+{
+   if (lo >= count || vgrf_end_tree[tree_node] <= node_start_ip)
+      return;
+
+   if (hi - lo == 1) {
+      const int vgrf = vgrf_by_start[lo];
+      assert(live.vgrf_start[vgrf] < node_end_ip);
+      ra_add_node_interference(g, node, first_vgrf_node + vgrf);
+      return;
+   }
+
+   const unsigned mid = (lo + hi) / 2;
+   add_vgrf_interval_interference(node, node_start_ip, node_end_ip,
+                                  2 * tree_node, lo, mid, count);
+   add_vgrf_interval_interference(node, node_start_ip, node_end_ip,
+                                  2 * tree_node + 1, mid, hi, count);
+}
+
+/**
+ * Equivalent to setup_live_interference() for a node created while
+ * spilling, which only needs to consider the original VGRFs.
+ */
+void
+brw_reg_alloc::setup_spill_live_interference(unsigned node,
+                                            int node_start_ip, int node_end_ip)
+{
+   setup_payload_interference(node, node_start_ip);
+
+   if (!vgrf_by_start)
+      build_vgrf_interval_tree();
+
+   /* Only the VGRFs whose live range starts before this node's ends can
+    * interfere with it.
+    */
+   const unsigned vgrf_count = last_vgrf_node - first_vgrf_node + 1;
+   const brw_live_variables &l = live;
+   const unsigned count =
+      std::lower_bound(vgrf_by_start, vgrf_by_start + vgrf_count, node_end_ip,
+                       [&](int vgrf, int ip) { return l.vgrf_start[vgrf] < ip; }) -
+      vgrf_by_start;
+
+   add_vgrf_interval_interference(node, node_start_ip, node_end_ip,
+                                  1, 0, vgrf_tree_size, count);
+}
+
 brw_reg
 brw_reg_alloc::alloc_spill_reg(unsigned size, int ip)
 {
@@ -1083,26 +1203,30 @@ brw_reg_alloc::alloc_spill_reg(unsigned size, int ip)
    assert(n == first_vgrf_node + vgrf);
    assert(n == first_spill_node + spill_node_count);
 
-   setup_live_interference(n, ip - 1, ip + 1);
+   setup_spill_live_interference(n, ip - 1, ip + 1);
+
+   if (!last_spill_at_ip) {
+      last_spill_at_ip = ralloc_array(mem_ctx, int, live_instr_count);
+      memset(last_spill_at_ip, -1, live_instr_count * sizeof(int));
+   }
 
    /* Add interference between this spill node and any other spill nodes for
     * the same instruction.
     */
-   for (int s = 0; s < spill_node_count; s++) {
-      if (spill_vgrf_ip[s] == ip)
-         ra_add_node_interference(g, n, first_spill_node + s);
-   }
+   for (int s = last_spill_at_ip[ip]; s >= 0; s = spill_prev_at_ip[s])
+      ra_add_node_interference(g, n, first_spill_node + s);
 
    /* Add this spill node to the list for next time */
-   if (spill_node_count >= spill_vgrf_ip_alloc) {
-      if (spill_vgrf_ip_alloc == 0)
-         spill_vgrf_ip_alloc = 16;
+   if (spill_node_count >= spill_prev_at_ip_alloc) {
+      if (spill_prev_at_ip_alloc == 0)
+         spill_prev_at_ip_alloc = 16;
       else
-         spill_vgrf_ip_alloc *= 2;
-      spill_vgrf_ip = reralloc(mem_ctx, spill_vgrf_ip, int,
-                               spill_vgrf_ip_alloc);
+         spill_prev_at_ip_alloc *= 2;
+      spill_prev_at_ip = reralloc(mem_ctx, spill_prev_at_ip, int,
+                                  spill_prev_at_ip_alloc);
    }
-   spill_vgrf_ip[spill_node_count++] = ip;
+   spill_prev_at_ip[spill_node_count] = last_spill_at_ip[ip];
+   last_spill_at_ip[ip] = spill_node_count++;
 
    return brw_vgrf(vgrf, BRW_TYPE_F);
 }
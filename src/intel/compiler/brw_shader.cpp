@@ -428,6 +428,12 @@ brw_shader::init()
 {
    this->max_dispatch_width = 32;
 
+   /* Even small shaders use thousands of instructions, so allocate them in
+    * large chunks.
+    */
+   const linear_opts inst_ctx_opts = { .min_buffer_size = 64 * 1024 };
+   this->inst_ctx = linear_context_with_opts(mem_ctx, &inst_ctx_opts);
+
    this->failed = false;
    this->fail_msg = NULL;
 
@@ -458,6 +464,7 @@ brw_shader::init()
 brw_shader::~brw_shader()
 {
    delete this->payload_;
+   linear_free_context(this->inst_ctx);
 }
 
 void
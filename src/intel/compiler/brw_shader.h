@@ -111,6 +111,12 @@ public:
    /** ralloc context for temporary data used during compile */
    void *mem_ctx;
 
+   /**
+    * Linear context the instructions are allocated from, released in one
+    * step when the shader is destroyed.
+    */
+   linear_ctx *inst_ctx;
+
    /** List of brw_inst. */
    exec_list instructions;
 
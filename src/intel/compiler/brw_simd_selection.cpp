@@ -190,7 +190,8 @@ brw_simd_should_compile(brw_simd_selection_state &state, unsigned simd)
 }
 
 void
-brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spilled)
+brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spilled,
+                       float throughput)
 {
    assert(simd < SIMD_COUNT);
    assert(!state.compiled[simd]);
@@ -198,6 +199,7 @@ brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spil
    auto cs_prog_data = get_cs_prog_data(state);
 
    state.compiled[simd] = true;
+   state.throughput[simd] = throughput;
    if (cs_prog_data)
       cs_prog_data->prog_mask |= 1u << simd;
 
@@ -214,10 +216,19 @@ brw_simd_mark_compiled(brw_simd_selection_state &state, unsigned simd, bool spil
 int
 brw_simd_select(const struct brw_simd_selection_state &state)
 {
+   /* Pick the variant without spills that has the best estimated
+    * throughput.  Ties and missing estimates favor the wider variant.
+    */
+   int best = -1;
    for (int i = SIMD_COUNT - 1; i >= 0; i--) {
-      if (state.compiled[i] && !state.spilled[i])
-         return i;
+      if (!state.compiled[i] || state.spilled[i])
+         continue;
+      if (best < 0 || state.throughput[i] > state.throughput[best])
+         best = i;
    }
+   if (best >= 0)
+      return best;
+
    for (int i = SIMD_COUNT - 1; i >= 0; i--) {
       if (state.compiled[i])
          return i;
@@ -225,6 +236,17 @@ brw_simd_select(const struct brw_simd_selection_state &state)
    return -1;
 }
 
+void
+brw_simd_fill_stats(const brw_simd_selection_state &state,
+                    struct brw_compile_stats *stats)
+{
+   if (!stats)
+      return;
+
+   for (unsigned i = 0; i < SIMD_COUNT; i++)
+      stats->simd_throughput[i] = state.compiled[i] ? state.throughput[i] * 1000.0f : 0;
+}
+
 int
 brw_simd_select_for_workgroup_size(const struct intel_device_info *devinfo,
                                    const struct brw_cs_prog_data *prog_data,
@@ -28,7 +28,35 @@
 #include "elk_nir_options.h"
 #include "dev/intel_debug.h"
 #include "compiler/nir/nir.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
+#include "util/u_queue.h"
+
+static void
+elk_simd_queue_destroy(void *queue)
+{
+   util_queue_destroy((struct util_queue *)queue);
+}
+
+static void
+elk_init_simd_queue(struct elk_compiler *compiler)
+{
+   const int nr_cpus = util_get_cpu_caps()->nr_cpus;
+
+   if (nr_cpus < 2 ||
+       !debug_get_bool_option("INTEL_PARALLEL_SIMD_COMPILE", true))
+      return;
+
+   struct util_queue *queue = rzalloc(compiler, struct util_queue);
+   if (!util_queue_init(queue, "elk_simd", 32, MIN2(nr_cpus - 1, 4),
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL)) {
+      ralloc_free(queue);
+      return;
+   }
+
+   ralloc_set_destructor(queue, elk_simd_queue_destroy);
+   compiler->simd_queue = queue;
+}
 
 struct elk_compiler *
 elk_compiler_create(void *mem_ctx, const struct intel_device_info *devinfo)
@@ -135,6 +163,8 @@ elk_compiler_create(void *mem_ctx, const struct intel_device_info *devinfo)
       compiler->nir_options[i] = nir_options;
    }
 
+   elk_init_simd_queue(compiler);
+
    return compiler;
 }
 
@@ -124,6 +124,12 @@ struct elk_compiler {
     * in case the render thread hasn't responded within 2 minutes.
     */
    int spilling_rate;
+
+   /**
+    * Thread pool used to compile SIMD variants of fragment shaders
+    * concurrently, or NULL if they are compiled on the calling thread.
+    */
+   struct util_queue *simd_queue;
 };
 
 #define elk_shader_debug_log(compiler, data, fmt, ... ) do {    \
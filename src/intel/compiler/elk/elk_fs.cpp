@@ -44,6 +44,7 @@
 #include "compiler/glsl_types.h"
 #include "compiler/nir/nir_builder.h"
 #include "util/u_math.h"
+#include "util/u_queue.h"
 
 #include <memory>
 
@@ -6677,6 +6678,101 @@ elk_register_blocks(int reg_count)
    return ALIGN(reg_count, 16) / 16 - 1;
 }
 
+namespace {
+
+/**
+ * A SIMD variant of a fragment shader compiled on the compiler thread pool,
+ * concurrently with the calling thread.  It has its own memory context,
+ * clone of the NIR and copy of the prog_data, so that it doesn't share any
+ * mutable state with the other variants.
+ *
+ * The visitor keeps pointing at the params and prog_data copy, so this has
+ * to outlive the visitor once it has been merged.
+ */
+struct elk_fs_async_variant {
+   elk_fs_async_variant(const struct elk_compiler *compiler,
+                        const struct elk_compile_fs_params *params,
+                        const struct elk_wm_prog_data *prog_data,
+                        unsigned dispatch_width, elk_fs_visitor *uniforms_from)
+   {
+      base = params->base;
+      base.mem_ctx = ralloc_context(NULL);
+      base.nir = nir_shader_clone(base.mem_ctx, params->base.nir);
+
+      memcpy(&initial_prog_data, prog_data, sizeof(*prog_data));
+      memcpy(&variant_prog_data, prog_data, sizeof(*prog_data));
+
+      shader = std::make_unique<elk_fs_visitor>(compiler, &base, params->key,
+                                                &variant_prog_data, base.nir,
+                                                dispatch_width,
+                                                base.stats != NULL,
+                                                false /* debug_enabled */);
+      shader->import_uniforms(uniforms_from);
+
+      util_queue_fence_init(&fence);
+   }
+
+   ~elk_fs_async_variant()
+   {
+      util_queue_fence_destroy(&fence);
+      shader.reset();
+      ralloc_free(base.mem_ctx);
+   }
+
+   static void
+   run(void *job, void *gdata, int thread_index)
+   {
+      elk_fs_async_variant *v = (elk_fs_async_variant *)job;
+      v->ok = v->shader->run_fs(false /* allow_spilling */,
+                                false /* do_rep_send */);
+   }
+
+   void
+   start(struct util_queue *queue)
+   {
+      util_queue_add_job(queue, this, &fence, run, NULL, 0);
+   }
+
+   void
+   wait()
+   {
+      util_queue_fence_wait(&fence);
+   }
+
+   /**
+    * Applies the changes the variant made to its copy of the prog_data on
+    * top of \p prog_data, as if it had been compiled after the variants of
+    * the calling thread, and hands over the shader and its memory.
+    */
+   std::unique_ptr<elk_fs_visitor>
+   merge(struct elk_wm_prog_data *prog_data, void *mem_ctx)
+   {
+      const uint8_t *initial = (const uint8_t *)&initial_prog_data;
+      const uint8_t *src = (const uint8_t *)&variant_prog_data;
+      uint8_t *dst = (uint8_t *)prog_data;
+
+      for (size_t i = 0; i < sizeof(*prog_data); i++) {
+         if (src[i] != initial[i])
+            dst[i] = src[i];
+      }
+
+      ralloc_steal(mem_ctx, base.mem_ctx);
+      base.mem_ctx = NULL;
+
+      shader->prog_data = &prog_data->base;
+      return std::move(shader);
+   }
+
+   struct elk_compile_params base;
+   struct elk_wm_prog_data initial_prog_data;
+   struct elk_wm_prog_data variant_prog_data;
+   std::unique_ptr<elk_fs_visitor> shader;
+   struct util_queue_fence fence;
+   bool ok = false;
+};
+
+}
+
 const unsigned *
 elk_compile_fs(const struct elk_compiler *compiler,
                struct elk_compile_fs_params *params)
@@ -6721,6 +6817,10 @@ elk_compile_fs(const struct elk_compiler *compiler,
 
    elk_nir_populate_wm_prog_data(nir, compiler->devinfo, key, prog_data);
 
+   /* Declared before the visitors, so that a merged SIMD32 visitor is
+    * destroyed before the state it points at.
+    */
+   std::unique_ptr<elk_fs_async_variant> async32;
    std::unique_ptr<elk_fs_visitor> v8, v16, v32, vmulti;
    elk_cfg_t *simd8_cfg = NULL, *simd16_cfg = NULL, *simd32_cfg = NULL;
    float throughput = 0;
@@ -6757,6 +6857,21 @@ elk_compile_fs(const struct elk_compiler *compiler,
                                "using SIMD8 when dual src blending.\n");
    }
 
+   /* If SIMD8 compiled without spilling, SIMD16 and SIMD32 will most likely
+    * both be needed.  Compile SIMD32 on the thread pool while SIMD16 is
+    * compiled here.  The result is dropped below if SIMD16 ends up in a
+    * state where SIMD32 wouldn't have been tried at all.
+    */
+   if (compiler->simd_queue && !debug_enabled && simd8_cfg &&
+       !has_spilled && v8->max_dispatch_width >= 32 &&
+       !params->use_rep_send && devinfo->ver >= 6 &&
+       INTEL_SIMD(FS, 16) && INTEL_SIMD(FS, 32)) {
+      async32 = std::make_unique<elk_fs_async_variant>(compiler, params,
+                                                       prog_data, 32,
+                                                       v8.get());
+      async32->start(compiler->simd_queue);
+   }
+
    if (!has_spilled &&
        (!v8 || v8->max_dispatch_width >= 16) &&
        (INTEL_SIMD(FS, 16) || params->use_rep_send)) {
@@ -6788,11 +6903,23 @@ elk_compile_fs(const struct elk_compiler *compiler,
    const bool simd16_failed = v16 && !simd16_cfg;
 
    /* Currently, the compiler only supports SIMD32 on SNB+ */
-   if (!has_spilled &&
-       (!v8 || v8->max_dispatch_width >= 32) &&
-       (!v16 || v16->max_dispatch_width >= 32) && !params->use_rep_send &&
-       devinfo->ver >= 6 && !simd16_failed &&
-       INTEL_SIMD(FS, 32)) {
+   const bool try_simd32 =
+      !has_spilled &&
+      (!v8 || v8->max_dispatch_width >= 32) &&
+      (!v16 || v16->max_dispatch_width >= 32) && !params->use_rep_send &&
+      devinfo->ver >= 6 && !simd16_failed &&
+      INTEL_SIMD(FS, 32);
+
+   bool simd32_ok = false;
+   if (async32) {
+      async32->wait();
+      if (try_simd32) {
+         v32 = async32->merge(prog_data, params->base.mem_ctx);
+         simd32_ok = async32->ok;
+      } else {
+         async32.reset();
+      }
+   } else if (try_simd32) {
       /* Try a SIMD32 compile */
       v32 = std::make_unique<elk_fs_visitor>(compiler, &params->base, key,
                                          prog_data, nir, 32,
@@ -6803,7 +6930,11 @@ elk_compile_fs(const struct elk_compiler *compiler,
       else if (v16)
          v32->import_uniforms(v16.get());
 
-      if (!v32->run_fs(allow_spilling, false)) {
+      simd32_ok = v32->run_fs(allow_spilling, false);
+   }
+
+   if (v32) {
+      if (!simd32_ok) {
          elk_shader_perf_log(compiler, params->base.log_data,
                              "SIMD32 shader failed to compile: %s\n",
                              v32->fail_msg);
@@ -86,6 +86,26 @@ TEST_F(SIMDSelectionCS, DefaultsToSIMD16)
    ASSERT_EQ(brw_simd_select(simd_state), SIMD16);
 }
 
+TEST_F(SIMDSelectionCS, PrefersBestThroughput)
+{
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD8));
+   brw_simd_mark_compiled(simd_state, SIMD8, not_spilled, 0.5f);
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD16));
+   brw_simd_mark_compiled(simd_state, SIMD16, not_spilled, 0.25f);
+
+   ASSERT_EQ(brw_simd_select(simd_state), SIMD8);
+}
+
+TEST_F(SIMDSelectionCS, EqualThroughputPrefersWider)
+{
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD8));
+   brw_simd_mark_compiled(simd_state, SIMD8, not_spilled, 0.5f);
+   ASSERT_TRUE(brw_simd_should_compile(simd_state, SIMD16));
+   brw_simd_mark_compiled(simd_state, SIMD16, not_spilled, 0.5f);
+
+   ASSERT_EQ(brw_simd_select(simd_state), SIMD16);
+}
+
 TEST_F(SIMDSelectionCS, TooBigFor16)
 {
    prog_data->local_size[0] = devinfo->max_cs_workgroup_threads;
@@ -4300,6 +4300,21 @@ VkResult anv_GetPipelineExecutableStatisticsKHR(
       stat->value.u64 = exe->stats.cycles;
    }
 
+   for (unsigned i = 0; i < ARRAY_SIZE(exe->stats.simd_throughput); i++) {
+      if (exe->stats.simd_throughput[i] == 0)
+         continue;
+
+      vk_outarray_append_typed(VkPipelineExecutableStatisticKHR, &out, stat) {
+         VK_PRINT_STR(stat->name, "SIMD%u Throughput", 8u << i);
+         VK_COPY_STR(stat->description,
+                   "Estimate of the number of invocations per 1000 EU cycles "
+                   "of the variant of this shader compiled for the given "
+                   "SIMD width, which is used to choose the dispatch width.");
+         stat->format = VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR;
+         stat->value.u64 = exe->stats.simd_throughput[i];
+      }
+   }
+
    vk_outarray_append_typed(VkPipelineExecutableStatisticKHR, &out, stat) {
       VK_COPY_STR(stat->name, "Spill Count");
       VK_COPY_STR(stat->description,
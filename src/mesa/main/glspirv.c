@@ -23,6 +23,7 @@
 
 #include "glspirv.h"
 #include "errors.h"
+#include "shaderapi.h"
 #include "shaderobj.h"
 #include "spirv_capabilities.h"
 #include "mtypes.h"
@@ -108,6 +109,8 @@ _mesa_spirv_shader_binary(struct gl_context *ctx,
    for (int i = 0; i < n; ++i) {
       struct gl_shader *sh = shaders[i];
 
+      _mesa_wait_shader_links(ctx, sh);
+
       spirv_data = rzalloc(NULL, struct gl_shader_spirv_data);
       _mesa_shader_spirv_data_reference(&sh->spirv_data, spirv_data);
       _mesa_spirv_module_reference(&spirv_data->SpirVModule, module);
@@ -2448,6 +2448,13 @@ struct gl_shared_state
    /** Table of both gl_shader and gl_shader_program objects */
    struct _mesa_HashTable ShaderObjects;
 
+   /**
+    * Worker threads running glLinkProgram for all the sharing contexts
+    * (GL_KHR_parallel_shader_compile).  Created on first use, with Mutex
+    * held.
+    */
+   struct util_queue LinkQueue;
+
    /* GL_EXT_framebuffer_object */
    struct _mesa_HashTable RenderBuffers;
    struct _mesa_HashTable FrameBuffers;
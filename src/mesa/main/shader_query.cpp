@@ -631,42 +631,73 @@ valid_array_index(const GLchar *name, int len, unsigned *array_index)
    return true;
 }
 
+/* Look up a resource by name in the ProgramResourceHash.
+ *
+ * *conclusive is set if the name can't match anything else, so that the
+ * caller can skip the linear search of the resource list on a miss.
+ */
 static struct gl_program_resource *
 search_resource_hash(struct gl_shader_program *shProg,
                      GLenum programInterface, const char *name, int len,
-                     unsigned *array_index)
+                     unsigned *array_index, bool *conclusive)
 {
    unsigned type = GET_PROGRAM_RESOURCE_TYPE_FROM_GLENUM(programInterface);
    assert(type < ARRAY_SIZE(shProg->data->ProgramResourceHash));
+   struct hash_table *ht = shProg->data->ProgramResourceHash[type];
+
+   *conclusive = false;
 
-   if (!shProg->data->ProgramResourceHash[type])
+   if (!ht)
       return NULL;
 
+   /* Try the whole name first. This also finds elements of block arrays,
+    * which have one resource per element, and the base names of resources
+    * ending with "[0]".
+    */
+   uint32_t hash = _mesa_hash_string_with_length(name, len);
+   struct hash_entry *entry =
+      _mesa_hash_table_search_pre_hashed(ht, hash, name);
+   if (entry) {
+      if (array_index)
+         *array_index = 0;
+      return (struct gl_program_resource *)entry->data;
+   }
+
    const char *base_name_end;
    long index = link_util_parse_program_resource_name(name, len, &base_name_end);
-   char *name_copy;
 
-   /* If dealing with array, we need to get the basename. */
-   if (index >= 0) {
-      name_copy = (char *) alloca(base_name_end - name + 1);
-      memcpy(name_copy, name, base_name_end - name);
-      name_copy[base_name_end - name] = '\0';
-      len = base_name_end - name;
-   } else {
-      name_copy = (char*) name;
+   /* Without an array index, the linear search can only find the exact
+    * name or the name with "[0]" appended, which are both in the table,
+    * unless the name refers to a member.
+    */
+   if (index < 0) {
+      *conclusive = !memchr(name, '.', len) && !memchr(name, '[', len);
+      return NULL;
    }
 
-   uint32_t hash = _mesa_hash_string_with_length(name_copy, len);
-   struct hash_entry *entry =
-      _mesa_hash_table_search_pre_hashed(shProg->data->ProgramResourceHash[type],
-                                         hash, name_copy);
+   /* If dealing with array, we need to get the basename. */
+   len = base_name_end - name;
+   char *name_copy = (char *) alloca(len + 1);
+   memcpy(name_copy, name, len);
+   name_copy[len] = '\0';
+
+   hash = _mesa_hash_string_with_length(name_copy, len);
+   entry = _mesa_hash_table_search_pre_hashed(ht, hash, name_copy);
    if (!entry)
       return NULL;
 
+   struct gl_program_resource *res = (struct gl_program_resource *)entry->data;
+   struct gl_resource_name rname;
+
+   /* "name[0]" is only found by its base name without any index. */
+   if (!_mesa_program_get_resource_name(res, &rname) ||
+       entry->key != rname.string)
+      return NULL;
+
    if (array_index)
-      *array_index = index >= 0 ? index : 0;
+      *array_index = index;
 
-   return (struct gl_program_resource *)entry->data;
+   return res;
 }
 
 /* Find a program resource with specific name in given interface.
@@ -682,10 +713,12 @@ _mesa_program_resource_find_name(struct gl_shader_program *shProg,
    int len = strlen(name);
 
    /* If we have a name, try the ProgramResourceHash first. */
+   bool conclusive;
    struct gl_program_resource *res =
-      search_resource_hash(shProg, programInterface, name, len, array_index);
+      search_resource_hash(shProg, programInterface, name, len, array_index,
+                           &conclusive);
 
-   if (res)
+   if (res || conclusive)
       return res;
 
    res = shProg->data->ProgramResourceList;
@@ -2166,8 +2199,21 @@ _mesa_create_program_resource_hash(struct gl_shader_program *shProg)
                                        _mesa_key_string_equal);
          }
 
-         _mesa_hash_table_insert(shProg->data->ProgramResourceHash[type],
-                                 name.string, res);
+         struct hash_table *ht = shProg->data->ProgramResourceHash[type];
+
+         _mesa_hash_table_insert(ht, name.string, res);
+
+         /* Also add the base name of "name[0]", which matches it too, unless
+          * another resource has that name.
+          */
+         if (name.suffix_is_zero_square_bracketed &&
+             name.last_square_bracket == name.length - 3) {
+            char *base = ralloc_strndup(ht, name.string,
+                                        name.last_square_bracket);
+
+            if (!_mesa_hash_table_search(ht, base))
+               _mesa_hash_table_insert(ht, base, res);
+         }
       }
    }
 }
@@ -39,6 +39,7 @@
 #include "util/mesa-blake3.h"
 #include "compiler/shader_info.h"
 #include "compiler/glsl/list.h"
+#include "util/u_queue.h"
 
 #include "pipe/p_state.h"
 
@@ -159,11 +160,18 @@ struct gl_shader
    GLint RefCount;  /**< Reference count */
    GLchar *Label;   /**< GL_KHR_debug */
    GLboolean DeletePending;
+   /** Number of queued program links reading this shader (atomic). */
+   int LinksInFlight;
    bool IsES;              /**< True if this shader uses GLSL ES */
    bool has_implicit_conversions;
    bool has_implicit_int_to_uint_conversion;
 
    enum gl_compile_status CompileStatus;
+   /**
+    * The compile was skipped without the shader having been seen by the
+    * on-disk cache before, so CompileStatus and InfoLog aren't known yet.
+    */
+   bool CompileDeferred;
 
    /** SHA1 of the pre-processed source used by the disk cache. */
    uint8_t disk_cache_sha1[SHA1_DIGEST_LENGTH];
@@ -374,6 +382,16 @@ struct gl_shader_program
    GLint RefCount;  /**< Reference count */
    GLboolean DeletePending;
 
+   /**
+    * Set while glLinkProgram runs on the shared link queue, or has run there
+    * but still needs to be finished on a context thread.  See
+    * _mesa_finish_program_link().
+    */
+   bool LinkPending;
+
+   /** Signalled when the queued part of the link is done. */
+   struct util_queue_fence LinkFence;
+
    /**
     * Is the application intending to glGetProgramBinary this program?
     *
@@ -63,6 +63,8 @@
 #include "util/list.h"
 #include "util/log.h"
 #include "util/perf/cpu_trace.h"
+#include "util/u_atomic.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_process.h"
 #include "util/u_string.h"
 #include "api_exec_decl.h"
@@ -730,6 +732,16 @@ get_shader_program_completion_status(struct gl_context *ctx,
 {
    struct pipe_screen *screen = ctx->screen;
 
+   if (shprog->LinkPending) {
+      if (!util_queue_fence_is_signalled(&shprog->LinkFence))
+         return false;
+
+      /* Create the driver shaders, which may be compiled in the
+       * background too.
+       */
+      _mesa_finish_program_link(ctx, shprog);
+   }
+
    if (!screen->is_parallel_shader_compilation_finished)
       return true;
 
@@ -761,8 +773,19 @@ static void
 get_programiv(struct gl_context *ctx, GLuint program, GLenum pname,
               GLint *params)
 {
-   struct gl_shader_program *shProg
-      = _mesa_lookup_shader_program_err(ctx, program, "glGetProgramiv(program)");
+   struct gl_shader_program *shProg;
+
+   /* Querying the completion status mustn't wait for a queued link. */
+   if (pname == GL_COMPLETION_STATUS_ARB) {
+      shProg = _mesa_lookup_shader_program_err_no_wait(ctx, program, false,
+                                                       "glGetProgramiv(program)");
+      if (shProg)
+         *params = get_shader_program_completion_status(ctx, shProg);
+      return;
+   }
+
+   shProg = _mesa_lookup_shader_program_err(ctx, program,
+                                            "glGetProgramiv(program)");
 
    /* Is transform feedback available in this context?
     */
@@ -793,9 +816,6 @@ get_programiv(struct gl_context *ctx, GLuint program, GLenum pname,
    case GL_DELETE_STATUS:
       *params = shProg->DeletePending;
       return;
-   case GL_COMPLETION_STATUS_ARB:
-      *params = get_shader_program_completion_status(ctx, shProg);
-      return;
    case GL_LINK_STATUS:
       *params = shProg->data->LinkStatus ? GL_TRUE : GL_FALSE;
       return;
@@ -1028,6 +1048,23 @@ get_programiv(struct gl_context *ctx, GLuint program, GLenum pname,
 }
 
 
+/**
+ * Run a compile that glCompileShader deferred, because the compile status
+ * or the info log of the shader is needed now.
+ */
+static void
+finish_deferred_compile(struct gl_context *ctx, struct gl_shader *sh)
+{
+   if (!sh->CompileDeferred)
+      return;
+
+   /* This compiles the source given to glCompileShader, which was kept as
+    * the fallback source if glShaderSource was called since.
+    */
+   _mesa_glsl_compile_shader(ctx, sh, NULL, false, false, true);
+}
+
+
 /**
  * glGetShaderiv() - get GLSL shader state
  */
@@ -1053,9 +1090,11 @@ get_shaderiv(struct gl_context *ctx, GLuint name, GLenum pname, GLint *params)
       *params = GL_TRUE;
       return;
    case GL_COMPILE_STATUS:
+      finish_deferred_compile(ctx, shader);
       *params = shader->CompileStatus ? GL_TRUE : GL_FALSE;
       break;
    case GL_INFO_LOG_LENGTH:
+      finish_deferred_compile(ctx, shader);
       *params = (shader->InfoLog && shader->InfoLog[0] != '\0') ?
          strlen(shader->InfoLog) + 1 : 0;
       break;
@@ -1121,6 +1160,7 @@ get_shader_info_log(struct gl_context *ctx, GLuint shader, GLsizei bufSize,
       return;
    }
 
+   finish_deferred_compile(ctx, sh);
    _mesa_copy_string(infoLog, bufSize, length, sh->InfoLog);
 }
 
@@ -1213,6 +1253,8 @@ _mesa_compile_shader(struct gl_context *ctx, struct gl_shader *sh)
       return;
    }
 
+   _mesa_wait_shader_links(ctx, sh);
+
    if (!sh->Source) {
       /* If the user called glCompileShader without first calling
        * glShaderSource, we should fail to compile, but not raise a GL_ERROR.
@@ -1331,46 +1373,14 @@ capture_shader_program(struct gl_context *ctx,
 }
 
 /**
- * Link a program's shaders.
+ * Update the context state after a program was linked.
+ *
+ * \param programs_in_use  mask of the stages the program was current for
  */
-static ALWAYS_INLINE void
-link_program(struct gl_context *ctx, struct gl_shader_program *shProg,
-             bool no_error)
+static void
+finish_link_program(struct gl_context *ctx, struct gl_shader_program *shProg,
+                    unsigned programs_in_use)
 {
-   if (!shProg)
-      return;
-
-   MESA_TRACE_FUNC();
-
-   if (!no_error) {
-      /* From the ARB_transform_feedback2 specification:
-       * "The error INVALID_OPERATION is generated by LinkProgram if <program>
-       * is the name of a program being used by one or more transform feedback
-       * objects, even if the objects are not currently bound or are paused."
-       */
-      if (_mesa_transform_feedback_is_using_program(ctx, shProg)) {
-         _mesa_error(ctx, GL_INVALID_OPERATION,
-                     "glLinkProgram(transform feedback is using the program)");
-         return;
-      }
-   }
-
-   capture_shader_program(ctx, shProg);
-
-   unsigned programs_in_use = 0;
-   if (ctx->_Shader)
-      for (unsigned stage = 0; stage < MESA_SHADER_STAGES; stage++) {
-         if (ctx->_Shader->CurrentProgram[stage] &&
-             ctx->_Shader->CurrentProgram[stage]->Id == shProg->Name) {
-            programs_in_use |= 1 << stage;
-         }
-      }
-
-   ensure_builtin_types(ctx);
-
-   FLUSH_VERTICES(ctx, 0, 0);
-   st_link_shader(ctx, shProg);
-
    /* From section 7.3 (Program Objects) of the OpenGL 4.5 spec:
     *
     *    "If LinkProgram or ProgramBinary successfully re-links a program
@@ -1428,24 +1438,217 @@ link_program(struct gl_context *ctx, struct gl_shader_program *shProg,
 }
 
 
+struct link_program_job {
+   struct gl_context *ctx;
+   struct gl_shader_program *shProg;
+};
+
+
+static void
+link_program_execute(void *data, void *gdata, int thread_index)
+{
+   struct link_program_job *job = (struct link_program_job *) data;
+   struct gl_shader_program *shProg = job->shProg;
+
+   st_link_shader_compile(job->ctx, shProg);
+
+   for (unsigned i = 0; i < shProg->NumShaders; i++)
+      p_atomic_dec(&shProg->Shaders[i]->LinksInFlight);
+}
+
+
+static void
+link_program_cleanup(void *data, void *gdata, int thread_index)
+{
+   free(data);
+}
+
+
+/**
+ * Return the queue running glLinkProgram in the background, creating it if
+ * needed, or NULL if programs are linked synchronously.
+ */
+static struct util_queue *
+get_link_queue(struct gl_context *ctx)
+{
+   struct gl_shared_state *shared = ctx->Shared;
+   const unsigned num_cpus = util_get_cpu_caps()->nr_cpus;
+
+   /* GL_KHR_parallel_shader_compile: a limit of 0 disables the threads. */
+   if (num_cpus < 2 || ctx->Hint.MaxShaderCompilerThreads == 0)
+      return NULL;
+
+   simple_mtx_lock(&shared->Mutex);
+   if (!util_queue_is_initialized(&shared->LinkQueue)) {
+      util_queue_init(&shared->LinkQueue, "gl_link", 64,
+                      MIN2(num_cpus - 1, 4),
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                      UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL);
+   }
+   simple_mtx_unlock(&shared->Mutex);
+
+   return util_queue_is_initialized(&shared->LinkQueue) ?
+          &shared->LinkQueue : NULL;
+}
+
+
+/**
+ * Whether glLinkProgram can return before the link is done.
+ */
+static bool
+can_link_async(struct gl_context *ctx, struct gl_shader_program *shProg,
+               unsigned programs_in_use)
+{
+   /* A program which is current or was linked successfully before may be in
+    * use by the context or a pipeline object, which the link has to update
+    * right away.
+    */
+   if (programs_in_use || shProg->data->LinkStatus)
+      return false;
+
+   for (unsigned i = 0; i < shProg->NumShaders; i++) {
+      struct gl_shader *sh = shProg->Shaders[i];
+
+      /* Shaders whose compile was skipped thanks to the shader cache are
+       * compiled by the linker on a cache miss, which modifies them.
+       */
+      if (sh->CompileStatus == COMPILE_SKIPPED || sh->spirv_data)
+         return false;
+   }
+
+   return true;
+}
+
+
+/**
+ * Wait for the queued links which read the shader \p sh, before modifying
+ * it.
+ */
+void
+_mesa_wait_shader_links(struct gl_context *ctx, struct gl_shader *sh)
+{
+   if (p_atomic_read(&sh->LinksInFlight))
+      util_queue_finish(&ctx->Shared->LinkQueue);
+}
+
+
+/**
+ * Wait for all the queued links, which may reference the context.
+ */
+void
+_mesa_wait_program_links(struct gl_context *ctx)
+{
+   if (util_queue_is_initialized(&ctx->Shared->LinkQueue))
+      util_queue_finish(&ctx->Shared->LinkQueue);
+}
+
+
+/**
+ * Finish a glLinkProgram which was queued.  Called before the program is
+ * used or its state is queried.
+ */
+void
+_mesa_finish_program_link(struct gl_context *ctx,
+                          struct gl_shader_program *shProg)
+{
+   if (!shProg->LinkPending)
+      return;
+
+   util_queue_fence_wait(&shProg->LinkFence);
+   shProg->LinkPending = false;
+
+   st_link_shader_end(ctx, shProg);
+   finish_link_program(ctx, shProg, 0);
+}
+
+
+/**
+ * Link a program's shaders.
+ */
+static ALWAYS_INLINE void
+link_program(struct gl_context *ctx, struct gl_shader_program *shProg,
+             bool no_error, bool allow_async)
+{
+   if (!shProg)
+      return;
+
+   MESA_TRACE_FUNC();
+
+   if (!no_error) {
+      /* From the ARB_transform_feedback2 specification:
+       * "The error INVALID_OPERATION is generated by LinkProgram if <program>
+       * is the name of a program being used by one or more transform feedback
+       * objects, even if the objects are not currently bound or are paused."
+       */
+      if (_mesa_transform_feedback_is_using_program(ctx, shProg)) {
+         _mesa_error(ctx, GL_INVALID_OPERATION,
+                     "glLinkProgram(transform feedback is using the program)");
+         return;
+      }
+   }
+
+   capture_shader_program(ctx, shProg);
+
+   unsigned programs_in_use = 0;
+   if (ctx->_Shader)
+      for (unsigned stage = 0; stage < MESA_SHADER_STAGES; stage++) {
+         if (ctx->_Shader->CurrentProgram[stage] &&
+             ctx->_Shader->CurrentProgram[stage]->Id == shProg->Name) {
+            programs_in_use |= 1 << stage;
+         }
+      }
+
+   ensure_builtin_types(ctx);
+
+   FLUSH_VERTICES(ctx, 0, 0);
+
+   struct util_queue *queue = NULL;
+   if (allow_async && can_link_async(ctx, shProg, programs_in_use))
+      queue = get_link_queue(ctx);
+
+   if (queue) {
+      struct link_program_job *job = malloc(sizeof(*job));
+
+      if (job) {
+         job->ctx = ctx;
+         job->shProg = shProg;
+
+         st_link_shader_prepare_async(ctx);
+         st_link_shader_begin(ctx, shProg);
+
+         for (unsigned i = 0; i < shProg->NumShaders; i++)
+            p_atomic_inc(&shProg->Shaders[i]->LinksInFlight);
+
+         shProg->LinkPending = true;
+         util_queue_add_job(queue, job, &shProg->LinkFence,
+                            link_program_execute, link_program_cleanup, 0);
+         return;
+      }
+   }
+
+   st_link_shader(ctx, shProg);
+   finish_link_program(ctx, shProg, programs_in_use);
+}
+
+
 static void
 link_program_error(struct gl_context *ctx, struct gl_shader_program *shProg)
 {
-   link_program(ctx, shProg, false);
+   link_program(ctx, shProg, false, true);
 }
 
 
 static void
 link_program_no_error(struct gl_context *ctx, struct gl_shader_program *shProg)
 {
-   link_program(ctx, shProg, true);
+   link_program(ctx, shProg, true, true);
 }
 
 
 void
 _mesa_link_program(struct gl_context *ctx, struct gl_shader_program *shProg)
 {
-   link_program_error(ctx, shProg);
+   link_program(ctx, shProg, false, false);
 }
 
 
@@ -2153,6 +2356,7 @@ shader_source(struct gl_context *ctx, GLuint shaderObj, GLsizei count,
    }
 #endif /* ENABLE_SHADER_CACHE */
 
+   _mesa_wait_shader_links(ctx, sh);
    set_shader_source(sh, source, original_blake3);
 
    free(offsets);
@@ -302,6 +302,8 @@ init_shader_program(struct gl_shader_program *prog)
    prog->TransformFeedback.BufferMode = GL_INTERLEAVED_ATTRIBS;
 
    exec_list_make_empty(&prog->EmptyUniformLocations);
+
+   util_queue_fence_init(&prog->LinkFence);
 }
 
 /**
@@ -411,6 +413,9 @@ void
 _mesa_delete_shader_program(struct gl_context *ctx,
                             struct gl_shader_program *shProg)
 {
+   util_queue_fence_wait(&shProg->LinkFence);
+   util_queue_fence_destroy(&shProg->LinkFence);
+
    _mesa_free_shader_program_data(ctx, shProg);
    ralloc_free(shProg);
 }
@@ -433,6 +438,8 @@ _mesa_lookup_shader_program(struct gl_context *ctx, GLuint name)
       if (shProg && shProg->Type != GL_SHADER_PROGRAM_MESA) {
          return NULL;
       }
+      if (shProg)
+         _mesa_finish_program_link(ctx, shProg);
       return shProg;
    }
    return NULL;
@@ -440,11 +447,12 @@ _mesa_lookup_shader_program(struct gl_context *ctx, GLuint name)
 
 
 /**
- * As above, but record an error if program is not found.
+ * As above, but record an error if program is not found, and don't finish
+ * a queued glLinkProgram.
  */
 struct gl_shader_program *
-_mesa_lookup_shader_program_err_glthread(struct gl_context *ctx, GLuint name,
-                                         bool glthread, const char *caller)
+_mesa_lookup_shader_program_err_no_wait(struct gl_context *ctx, GLuint name,
+                                        bool glthread, const char *caller)
 {
    if (!name) {
       _mesa_error_glthread_safe(ctx, GL_INVALID_VALUE, glthread, "%s", caller);
@@ -468,6 +476,26 @@ _mesa_lookup_shader_program_err_glthread(struct gl_context *ctx, GLuint name,
 }
 
 
+/**
+ * As above, but finish a queued glLinkProgram.
+ */
+struct gl_shader_program *
+_mesa_lookup_shader_program_err_glthread(struct gl_context *ctx, GLuint name,
+                                         bool glthread, const char *caller)
+{
+   struct gl_shader_program *shProg =
+      _mesa_lookup_shader_program_err_no_wait(ctx, name, glthread, caller);
+
+   if (shProg && shProg->LinkPending) {
+      /* The link has to be finished by the thread owning the context. */
+      if (glthread)
+         _mesa_glthread_finish_before(ctx, caller);
+      _mesa_finish_program_link(ctx, shProg);
+   }
+   return shProg;
+}
+
+
 struct gl_shader_program *
 _mesa_lookup_shader_program_err(struct gl_context *ctx, GLuint name,
                                 const char *caller)
@@ -95,6 +95,10 @@ _mesa_delete_linked_shader(struct gl_context *ctx,
 extern struct gl_shader_program *
 _mesa_lookup_shader_program(struct gl_context *ctx, GLuint name);
 
+extern struct gl_shader_program *
+_mesa_lookup_shader_program_err_no_wait(struct gl_context *ctx, GLuint name,
+                                        bool glthread, const char *caller);
+
 extern struct gl_shader_program *
 _mesa_lookup_shader_program_err_glthread(struct gl_context *ctx, GLuint name,
                                          bool glthread, const char *caller);
@@ -351,6 +351,12 @@ free_shared_state(struct gl_context *ctx, struct gl_shared_state *shared)
 {
    GLuint i;
 
+   /* Let the queued links complete before freeing the programs. */
+   if (util_queue_is_initialized(&shared->LinkQueue)) {
+      util_queue_finish(&shared->LinkQueue);
+      util_queue_destroy(&shared->LinkQueue);
+   }
+
    /* Free the dummy/fallback texture objects */
    for (i = 0; i < NUM_TEXTURE_TARGETS; i++) {
       for (unsigned j = 0; j < ARRAY_SIZE(shared->FallbackTex[0]); j++) {
@@ -270,89 +270,84 @@ static uint32_t hash52(uint32_t p)
    return p;
 }
 
-static int select_partition(int seed, int x, int y, int z, int partitioncount,
-                            int small_block)
+/* The partition pattern of a block only depends on its seed, so this derives
+ * the per-seed multipliers once and then just evaluates them per texel.
+ */
+struct PartitionSelector
 {
-   if (small_block) {
-      x <<= 1;
-      y <<= 1;
-      z <<= 1;
+   int partitioncount;
+   int shift;
+   uint8_t seed[12];
+   uint32_t rnum;
+
+   PartitionSelector(int seed_in, int partitioncount, int small_block)
+      : partitioncount(partitioncount), shift(small_block ? 1 : 0)
+   {
+      int s = seed_in + (partitioncount - 1) * 1024;
+      rnum = hash52(s);
+      seed[0] = rnum & 0xF;
+      seed[1] = (rnum >> 4) & 0xF;
+      seed[2] = (rnum >> 8) & 0xF;
+      seed[3] = (rnum >> 12) & 0xF;
+      seed[4] = (rnum >> 16) & 0xF;
+      seed[5] = (rnum >> 20) & 0xF;
+      seed[6] = (rnum >> 24) & 0xF;
+      seed[7] = (rnum >> 28) & 0xF;
+      seed[8] = (rnum >> 18) & 0xF;
+      seed[9] = (rnum >> 22) & 0xF;
+      seed[10] = (rnum >> 26) & 0xF;
+      seed[11] = ((rnum >> 30) | (rnum << 2)) & 0xF;
+
+      for (int i = 0; i < 12; ++i)
+         seed[i] *= seed[i];
+
+      int sh1, sh2, sh3;
+      if (s & 1) {
+         sh1 = (s & 2 ? 4 : 5);
+         sh2 = (partitioncount == 3 ? 6 : 5);
+      } else {
+         sh1 = (partitioncount == 3 ? 6 : 5);
+         sh2 = (s & 2 ? 4 : 5);
+      }
+      sh3 = (s & 0x10) ? sh1 : sh2;
+
+      for (int i = 0; i < 8; ++i)
+         seed[i] >>= (i & 1) ? sh2 : sh1;
+      for (int i = 8; i < 12; ++i)
+         seed[i] >>= sh3;
    }
-   seed += (partitioncount - 1) * 1024;
-   uint32_t rnum = hash52(seed);
-   uint8_t seed1 = rnum & 0xF;
-   uint8_t seed2 = (rnum >> 4) & 0xF;
-   uint8_t seed3 = (rnum >> 8) & 0xF;
-   uint8_t seed4 = (rnum >> 12) & 0xF;
-   uint8_t seed5 = (rnum >> 16) & 0xF;
-   uint8_t seed6 = (rnum >> 20) & 0xF;
-   uint8_t seed7 = (rnum >> 24) & 0xF;
-   uint8_t seed8 = (rnum >> 28) & 0xF;
-   uint8_t seed9 = (rnum >> 18) & 0xF;
-   uint8_t seed10 = (rnum >> 22) & 0xF;
-   uint8_t seed11 = (rnum >> 26) & 0xF;
-   uint8_t seed12 = ((rnum >> 30) | (rnum << 2)) & 0xF;
-
-   seed1 *= seed1;
-   seed2 *= seed2;
-   seed3 *= seed3;
-   seed4 *= seed4;
-   seed5 *= seed5;
-   seed6 *= seed6;
-   seed7 *= seed7;
-   seed8 *= seed8;
-   seed9 *= seed9;
-   seed10 *= seed10;
-   seed11 *= seed11;
-   seed12 *= seed12;
-
-   int sh1, sh2, sh3;
-   if (seed & 1) {
-      sh1 = (seed & 2 ? 4 : 5);
-      sh2 = (partitioncount == 3 ? 6 : 5);
-   } else {
-      sh1 = (partitioncount == 3 ? 6 : 5);
-      sh2 = (seed & 2 ? 4 : 5);
+
+   int select(int x, int y, int z) const
+   {
+      x <<= shift;
+      y <<= shift;
+      z <<= shift;
+
+      int a = seed[0] * x + seed[1] * y + seed[10] * z + (rnum >> 14);
+      int b = seed[2] * x + seed[3] * y + seed[11] * z + (rnum >> 10);
+      int c = seed[4] * x + seed[5] * y + seed[8] * z + (rnum >> 6);
+      int d = seed[6] * x + seed[7] * y + seed[9] * z + (rnum >> 2);
+
+      a &= 0x3F;
+      b &= 0x3F;
+      c &= 0x3F;
+      d &= 0x3F;
+
+      if (partitioncount < 4)
+         d = 0;
+      if (partitioncount < 3)
+         c = 0;
+
+      if (a >= b && a >= c && a >= d)
+         return 0;
+      else if (b >= c && b >= d)
+         return 1;
+      else if (c >= d)
+         return 2;
+      else
+         return 3;
    }
-   sh3 = (seed & 0x10) ? sh1 : sh2;
-
-   seed1 >>= sh1;
-   seed2 >>= sh2;
-   seed3 >>= sh1;
-   seed4 >>= sh2;
-   seed5 >>= sh1;
-   seed6 >>= sh2;
-   seed7 >>= sh1;
-   seed8 >>= sh2;
-   seed9 >>= sh3;
-   seed10 >>= sh3;
-   seed11 >>= sh3;
-   seed12 >>= sh3;
-
-   int a = seed1 * x + seed2 * y + seed11 * z + (rnum >> 14);
-   int b = seed3 * x + seed4 * y + seed12 * z + (rnum >> 10);
-   int c = seed5 * x + seed6 * y + seed9 * z + (rnum >> 6);
-   int d = seed7 * x + seed8 * y + seed10 * z + (rnum >> 2);
-
-   a &= 0x3F;
-   b &= 0x3F;
-   c &= 0x3F;
-   d &= 0x3F;
-
-   if (partitioncount < 4)
-      d = 0;
-   if (partitioncount < 3)
-      c = 0;
-
-   if (a >= b && a >= c && a >= d)
-      return 0;
-   else if (b >= c && b >= d)
-      return 1;
-   else if (c >= d)
-      return 2;
-   else
-      return 3;
-}
+};
 
 
 struct InputBitVector
@@ -1258,38 +1253,40 @@ void Block::compute_infill_weights(int block_w, int block_h, int block_d)
 {
    int Ds = block_w <= 1 ? 0 : (1024 + block_w / 2) / (block_w - 1);
    int Dt = block_h <= 1 ? 0 : (1024 + block_h / 2) / (block_h - 1);
-   int Dr = block_d <= 1 ? 0 : (1024 + block_d / 2) / (block_d - 1);
+
+   /* The grid coordinates are separable, so compute them once per row and
+    * column instead of once per texel.
+    */
+   uint8_t js[12], fs[12], jt[12], ft[12];
+   assert(block_w <= (int)ARRAY_SIZE(js) && block_h <= (int)ARRAY_SIZE(jt));
+   for (int s = 0; s < block_w; ++s) {
+      int gs = (Ds * s * (wt_w - 1) + 32) >> 6;
+      assert(gs >= 0 && gs <= 176);
+      js[s] = gs >> 4;
+      fs[s] = gs & 0xf;
+   }
+   for (int t = 0; t < block_h; ++t) {
+      int gt = (Dt * t * (wt_h - 1) + 32) >> 6;
+      assert(gt >= 0 && gt <= 176);
+      jt[t] = gt >> 4;
+      ft[t] = gt & 0xf;
+   }
+
+   /* TODO: 3D */
    for (int r = 0; r < block_d; ++r) {
       for (int t = 0; t < block_h; ++t) {
+         uint8_t *out0 = &infill_weights[0][t*block_w + r*block_w*block_h];
+         uint8_t *out1 = &infill_weights[1][t*block_w + r*block_w*block_h];
+
          for (int s = 0; s < block_w; ++s) {
-            int cs = Ds * s;
-            int ct = Dt * t;
-            int cr = Dr * r;
-            int gs = (cs * (wt_w - 1) + 32) >> 6;
-            int gt = (ct * (wt_h - 1) + 32) >> 6;
-            int gr = (cr * (wt_d - 1) + 32) >> 6;
-            assert(gs >= 0 && gs <= 176);
-            assert(gt >= 0 && gt <= 176);
-            assert(gr >= 0 && gr <= 176);
-            int js = gs >> 4;
-            int fs = gs & 0xf;
-            int jt = gt >> 4;
-            int ft = gt & 0xf;
-            int jr = gr >> 4;
-            int fr = gr & 0xf;
-
-            /* TODO: 3D */
-            (void)jr;
-            (void)fr;
-
-            int w11 = (fs * ft + 8) >> 4;
-            int w10 = ft - w11;
-            int w01 = fs - w11;
-            int w00 = 16 - fs - ft + w11;
+            int w11 = (fs[s] * ft[t] + 8) >> 4;
+            int w10 = ft[t] - w11;
+            int w01 = fs[s] - w11;
+            int w00 = 16 - fs[s] - ft[t] + w11;
+            int v0 = js[s] + jt[t] * wt_w;
 
             if (dual_plane) {
                int p00, p01, p10, p11, i0, i1;
-               int v0 = js + jt * wt_w;
                p00 = weights[(v0) * 2];
                p01 = weights[(v0 + 1) * 2];
                p10 = weights[(v0 + wt_w) * 2];
@@ -1302,11 +1299,10 @@ void Block::compute_infill_weights(int block_w, int block_h, int block_d)
                assert((v0 + wt_w + 1) * 2 + 1 < (int)ARRAY_SIZE(weights));
                i1 = (p00*w00 + p01*w01 + p10*w10 + p11*w11 + 8) >> 4;
                assert(0 <= i0 && i0 <= 64);
-               infill_weights[0][s + t*block_w + r*block_w*block_h] = i0;
-               infill_weights[1][s + t*block_w + r*block_w*block_h] = i1;
+               out0[s] = i0;
+               out1[s] = i1;
             } else {
                int p00, p01, p10, p11, i;
-               int v0 = js + jt * wt_w;
                p00 = weights[v0];
                p01 = weights[v0 + 1];
                p10 = weights[v0 + wt_w];
@@ -1314,7 +1310,7 @@ void Block::compute_infill_weights(int block_w, int block_h, int block_d)
                assert(v0 + wt_w + 1 < (int)ARRAY_SIZE(weights));
                i = (p00*w00 + p01*w01 + p10*w10 + p11*w11 + 8) >> 4;
                assert(0 <= i && i <= 64);
-               infill_weights[0][s + t*block_w + r*block_w*block_h] = i;
+               out0[s] = i;
             }
          }
       }
@@ -1624,6 +1620,24 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
    }
 
    int small_block = (decoder.block_w * decoder.block_h * decoder.block_d) < 31;
+   PartitionSelector selector(partition_index, num_parts, small_block);
+
+   /* Expand the endpoints of each partition to 16 bits. */
+   uint16_t c0[4][4], c1[4][4];
+   for (int p = 0; p < num_parts; ++p) {
+      for (int i = 0; i < 4; ++i) {
+         uint8_t e0 = endpoints_decoded[0][p].v[i];
+         uint8_t e1 = endpoints_decoded[1][p].v[i];
+
+         if (decoder.srgb) {
+            c0[p][i] = (uint16_t)((e0 << 8) | 0x80);
+            c1[p][i] = (uint16_t)((e1 << 8) | 0x80);
+         } else {
+            c0[p][i] = (uint16_t)((e0 << 8) | e0);
+            c1[p][i] = (uint16_t)((e1 << 8) | e1);
+         }
+      }
+   }
 
    int idx = 0;
    for (int z = 0; z < decoder.block_d; ++z) {
@@ -1632,7 +1646,7 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
 
             int partition;
             if (num_parts > 1) {
-               partition = select_partition(partition_index, x, y, z, num_parts, small_block);
+               partition = selector.select(x, y, z);
                assert(partition < num_parts);
             } else {
                partition = 0;
@@ -1640,32 +1654,8 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
 
             /* TODO: HDR */
 
-            uint8x4_t e0 = endpoints_decoded[0][partition];
-            uint8x4_t e1 = endpoints_decoded[1][partition];
-            uint16_t c0[4], c1[4];
-
-            /* Expand to 16 bits. */
-            if (decoder.srgb) {
-               c0[0] = (uint16_t)((e0.v[0] << 8) | 0x80);
-               c0[1] = (uint16_t)((e0.v[1] << 8) | 0x80);
-               c0[2] = (uint16_t)((e0.v[2] << 8) | 0x80);
-               c0[3] = (uint16_t)((e0.v[3] << 8) | 0x80);
-
-               c1[0] = (uint16_t)((e1.v[0] << 8) | 0x80);
-               c1[1] = (uint16_t)((e1.v[1] << 8) | 0x80);
-               c1[2] = (uint16_t)((e1.v[2] << 8) | 0x80);
-               c1[3] = (uint16_t)((e1.v[3] << 8) | 0x80);
-            } else {
-               c0[0] = (uint16_t)((e0.v[0] << 8) | e0.v[0]);
-               c0[1] = (uint16_t)((e0.v[1] << 8) | e0.v[1]);
-               c0[2] = (uint16_t)((e0.v[2] << 8) | e0.v[2]);
-               c0[3] = (uint16_t)((e0.v[3] << 8) | e0.v[3]);
-
-               c1[0] = (uint16_t)((e1.v[0] << 8) | e1.v[0]);
-               c1[1] = (uint16_t)((e1.v[1] << 8) | e1.v[1]);
-               c1[2] = (uint16_t)((e1.v[2] << 8) | e1.v[2]);
-               c1[3] = (uint16_t)((e1.v[3] << 8) | e1.v[3]);
-            }
+            const uint16_t *e0 = c0[partition];
+            const uint16_t *e1 = c1[partition];
 
             int w[4];
             if (dual_plane) {
@@ -1680,10 +1670,10 @@ void Block::write_decoded(const Decoder &decoder, uint16_t *output)
 
             /* Interpolate to produce UNORM16, applying weights. */
             uint16_t c[4] = {
-               (uint16_t)((c0[0] * (64 - w[0]) + c1[0] * w[0] + 32) >> 6),
-               (uint16_t)((c0[1] * (64 - w[1]) + c1[1] * w[1] + 32) >> 6),
-               (uint16_t)((c0[2] * (64 - w[2]) + c1[2] * w[2] + 32) >> 6),
-               (uint16_t)((c0[3] * (64 - w[3]) + c1[3] * w[3] + 32) >> 6),
+               (uint16_t)((e0[0] * (64 - w[0]) + e1[0] * w[0] + 32) >> 6),
+               (uint16_t)((e0[1] * (64 - w[1]) + e1[1] * w[1] + 32) >> 6),
+               (uint16_t)((e0[2] * (64 - w[2]) + e1[2] * w[2] + 32) >> 6),
+               (uint16_t)((e0[3] * (64 - w[3]) + e1[3] * w[3] + 32) >> 6),
             };
 
             if (decoder.output_unorm8) {
@@ -31,6 +31,7 @@
 #include "main/debug_output.h"
 #include "main/framebuffer.h"
 #include "main/glthread.h"
+#include "main/shaderapi.h"
 #include "main/shaderobj.h"
 #include "main/state.h"
 #include "main/version.h"
@@ -469,7 +470,8 @@ st_create_context_priv(struct gl_context *ctx, struct pipe_context *pipe,
       break;
    }
 
-   st->cso_context = cso_create_context(pipe, cso_flags);
+   /* Contexts of a share group tend to create the same states. */
+   st->cso_context = cso_create_context(pipe, cso_flags | CSO_SHARE_STATES);
    ctx->cso_context = st->cso_context;
 
    STATIC_ASSERT(ARRAY_SIZE(st->update_functions) <= 64);
@@ -917,6 +919,9 @@ st_destroy_context(struct st_context *st)
    /* This must be called first so that glthread has a chance to finish */
    _mesa_glthread_destroy(ctx);
 
+   /* Queued links can reference this context. */
+   _mesa_wait_program_links(ctx);
+
    _mesa_HashWalk(&ctx->Shared->TexObjects, destroy_tex_sampler_cb, st);
 
    /* For the fallback textures, free any sampler views belonging to this
@@ -394,10 +394,9 @@ st_link_glsl_to_nir(struct gl_context *ctx,
    struct gl_linked_shader *linked_shader[MESA_SHADER_STAGES];
    unsigned num_shaders = 0;
 
-   /* Return early if we are loading the shader from on-disk cache */
-   if (st_load_nir_from_disk_cache(ctx, shader_program)) {
+   /* The NIR is loaded from the on-disk cache by st_link_glsl_to_nir_end() */
+   if (ctx->Cache && shader_program->data->LinkStatus == LINKING_SKIPPED)
       return GL_TRUE;
-   }
 
    MESA_TRACE_FUNC();
 
@@ -587,6 +586,32 @@ st_link_glsl_to_nir(struct gl_context *ctx,
          st_translate_stream_output_info(prog);
 
       st_store_nir_in_disk_cache(st, prog);
+   }
+
+   return true;
+}
+
+/**
+ * The part of linking which needs the pipe context: creating the driver
+ * shaders.
+ */
+static GLboolean
+st_link_glsl_to_nir_end(struct gl_context *ctx,
+                        struct gl_shader_program *shader_program)
+{
+   struct st_context *st = st_context(ctx);
+
+   /* Return early if we are loading the shader from on-disk cache */
+   if (st_load_nir_from_disk_cache(ctx, shader_program)) {
+      return GL_TRUE;
+   }
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      struct gl_linked_shader *shader = shader_program->_LinkedShaders[i];
+      if (!shader)
+         continue;
+
+      struct gl_program *prog = shader->Program;
 
       st_release_variants(st, prog);
       char *error = st_finalize_program(st, prog, true);
@@ -598,7 +623,7 @@ st_link_glsl_to_nir(struct gl_context *ctx,
       }
    }
 
-   struct pipe_context *pctx = st_context(ctx)->pipe;
+   struct pipe_context *pctx = st->pipe;
    if (pctx->link_shader) {
       void *driver_handles[PIPE_SHADER_TYPES];
       memset(driver_handles, 0, sizeof(driver_handles));
@@ -720,14 +745,58 @@ st_finalize_nir(struct st_context *st, struct gl_program *prog,
 void
 st_link_shader(struct gl_context *ctx, struct gl_shader_program *prog)
 {
-   unsigned int i;
-   bool spirv = false;
-
-   MESA_TRACE_FUNC();
+   st_link_shader_begin(ctx, prog);
+   st_link_shader_compile(ctx, prog);
+   st_link_shader_end(ctx, prog);
+}
 
+/**
+ * Release the results of the previous link.
+ */
+void
+st_link_shader_begin(struct gl_context *ctx, struct gl_shader_program *prog)
+{
    _mesa_clear_shader_program_data(ctx, prog);
 
    prog->data = _mesa_create_shader_program_data();
+}
+
+/**
+ * Create the context state which st_link_shader_compile() would otherwise
+ * create on demand, so that it can run on another thread.
+ */
+void
+st_link_shader_prepare_async(struct gl_context *ctx)
+{
+   if (ctx->SoftFP64 || !_mesa_is_desktop_gl(ctx) ||
+       ctx->Const.GLSLVersion < 400)
+      return;
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      const nir_shader_compiler_options *options =
+         ctx->Const.ShaderCompilerOptions[i].NirOptions;
+
+      if (options &&
+          (options->lower_doubles_options & nir_lower_fp64_full_software)) {
+         ctx->SoftFP64 = glsl_float64_funcs_to_nir(ctx, options);
+         return;
+      }
+   }
+}
+
+/**
+ * Run the GLSL linker and the NIR linking passes.
+ *
+ * This doesn't touch the pipe context nor the state of the context, and can
+ * run on a thread of the shared link queue.
+ */
+void
+st_link_shader_compile(struct gl_context *ctx, struct gl_shader_program *prog)
+{
+   unsigned int i;
+   bool spirv = false;
+
+   MESA_TRACE_FUNC();
 
    prog->data->LinkStatus = LINKING_SUCCESS;
 
@@ -775,6 +844,19 @@ st_link_shader(struct gl_context *ctx, struct gl_shader_program *prog)
    if (prog->data->LinkStatus && !st_link_glsl_to_nir(ctx, prog)) {
       prog->data->LinkStatus = LINKING_FAILURE;
    }
+}
+
+/**
+ * Create the driver shaders, and finish the link.
+ */
+void
+st_link_shader_end(struct gl_context *ctx, struct gl_shader_program *prog)
+{
+   MESA_TRACE_FUNC();
+
+   if (prog->data->LinkStatus && !st_link_glsl_to_nir_end(ctx, prog)) {
+      prog->data->LinkStatus = LINKING_FAILURE;
+   }
 
    if (prog->data->LinkStatus != LINKING_FAILURE)
       _mesa_create_program_resource_hash(prog);
@@ -27,11 +27,15 @@
 #include "util/macros.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
+#include "util/hash_table.h"
 #include "util/rb_tree.h"
 
 #include <assert.h>
 #include <stdio.h>
 
+static uint32_t const_hash(const void *key);
+static bool const_equal(const void *a, const void *b);
+
 void
 dxil_module_init(struct dxil_module *m, void *ralloc_ctx)
 {
@@ -49,6 +53,8 @@ dxil_module_init(struct dxil_module *m, void *ralloc_ctx)
    list_inithead(&m->attr_set_list);
    list_inithead(&m->gvar_list);
    list_inithead(&m->const_list);
+   m->const_table = _mesa_hash_table_create(ralloc_ctx, const_hash,
+                                            const_equal);
    list_inithead(&m->mdnode_list);
    list_inithead(&m->md_named_node_list);
 
@@ -1590,43 +1596,123 @@ emit_type_table(struct dxil_module *m)
           exit_block(m);
 }
 
-static struct dxil_const *
-create_const(struct dxil_module *m, const struct dxil_type *type, bool undef)
+/* Returns the data that tells constants of the same type apart. */
+static const void *
+const_key_data(const struct dxil_const *c, size_t *size)
 {
-   struct dxil_const *ret = ralloc_size(m->ralloc_ctx,
-                                        sizeof(struct dxil_const));
-   if (ret) {
-      ret->value.id = -1;
-      ret->value.type = type;
-      ret->undef = undef;
-      list_addtail(&ret->head, &m->const_list);
+   const struct dxil_type *type = c->value.type;
+
+   *size = 0;
+   if (c->undef)
+      return NULL;
+
+   switch (type->type) {
+   case TYPE_INTEGER:
+      *size = sizeof(c->int_value);
+      return &c->int_value;
+
+   case TYPE_FLOAT:
+      /* Half floats are stored as their bits, the others are compared
+       * bitwise too so that 0.0 and -0.0 stay distinct.
+       */
+      if (type->float_bits == 16) {
+         *size = sizeof(c->int_value);
+         return &c->int_value;
+      }
+      *size = sizeof(c->float_value);
+      return &c->float_value;
+
+   case TYPE_ARRAY:
+   case TYPE_VECTOR:
+      *size = sizeof(*c->array_values) * type->array_or_vector_def.num_elems;
+      return c->array_values;
+
+   case TYPE_STRUCT:
+      *size = sizeof(*c->struct_values) * type->struct_def.elem.num_types;
+      return c->struct_values;
+
+   default:
+      unreachable("unexpected constant type");
    }
-   return ret;
 }
 
+static uint32_t
+const_hash(const void *key)
+{
+   const struct dxil_const *c = key;
+   uint32_t hash = _mesa_hash_pointer(c->value.type) ^ c->undef;
+   size_t size;
+   const void *data = const_key_data(c, &size);
+
+   return size ? _mesa_hash_data_with_seed(data, size, hash) : hash;
+}
+
+static bool
+const_equal(const void *a, const void *b)
+{
+   const struct dxil_const *ca = a, *cb = b;
+
+   if (ca->value.type != cb->value.type || ca->undef != cb->undef)
+      return false;
+
+   size_t size;
+   const void *data_a = const_key_data(ca, &size);
+   const void *data_b = const_key_data(cb, &size);
+   return !size || !memcmp(data_a, data_b, size);
+}
+
+/* Returns the constant matching key, creating it if it doesn't exist yet.
+ * Large shaders have thousands of constants, so they are looked up through
+ * m->const_table, while m->const_list keeps them in creation order for
+ * emission.
+ */
 static const struct dxil_value *
-get_int_const(struct dxil_module *m, const struct dxil_type *type,
-              intmax_t value)
+get_const(struct dxil_module *m, const struct dxil_const *key)
 {
-   assert(type && type->type == TYPE_INTEGER);
+   uint32_t hash = const_hash(key);
+   struct hash_entry *entry =
+      _mesa_hash_table_search_pre_hashed(m->const_table, hash, key);
+   if (entry)
+      return &((struct dxil_const *)entry->key)->value;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
+   struct dxil_const *c = ralloc_size(m->ralloc_ctx,
+                                      sizeof(struct dxil_const));
+   if (!c)
+      return NULL;
 
-      if (c->int_value == value)
-         return &c->value;
+   *c = *key;
+   c->value.id = -1;
+
+   enum type_type type = key->value.type->type;
+   if (!key->undef &&
+       (type == TYPE_ARRAY || type == TYPE_VECTOR || type == TYPE_STRUCT)) {
+      size_t size;
+      const void *values = const_key_data(key, &size);
+      c->array_values = ralloc_memdup(m->ralloc_ctx, values, size);
+      if (!c->array_values)
+         return NULL;
    }
 
-   c = create_const(m, type, false);
-   if (!c)
+   if (!_mesa_hash_table_insert_pre_hashed(m->const_table, hash, c, c))
       return NULL;
 
-   c->int_value = value;
+   list_addtail(&c->head, &m->const_list);
    return &c->value;
 }
 
+static const struct dxil_value *
+get_int_const(struct dxil_module *m, const struct dxil_type *type,
+              intmax_t value)
+{
+   assert(type && type->type == TYPE_INTEGER);
+
+   struct dxil_const key = {
+      .value.type = type,
+      .int_value = value,
+   };
+   return get_const(m, &key);
+}
+
 static intmax_t
 get_int_from_const_value(const struct dxil_value *value)
 {
@@ -1722,21 +1808,11 @@ dxil_module_get_float16_const(struct dxil_module *m, uint16_t value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->int_value == (uintmax_t)value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->int_value = (uintmax_t)value;
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .int_value = (uintmax_t)value,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1746,21 +1822,11 @@ dxil_module_get_float_const(struct dxil_module *m, float value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->float_value == value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->float_value = value;
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .float_value = value,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1770,21 +1836,11 @@ dxil_module_get_double_const(struct dxil_module *m, double value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->float_value == value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->float_value = value;
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .float_value = value,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1792,26 +1848,12 @@ dxil_module_get_array_const(struct dxil_module *m, const struct dxil_type *type,
                             const struct dxil_value **values)
 {
    assert(type->type == TYPE_ARRAY);
-   unsigned int num_values = type->array_or_vector_def.num_elems;
-
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (!memcmp(c->array_values, values, sizeof(*values) * num_values))
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-   void *tmp =
-      ralloc_array(m->ralloc_ctx, struct dxil_value *, num_values);
-   memcpy(tmp, values, sizeof(*values) * num_values);
-   c->array_values = tmp;
 
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .array_values = values,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1819,26 +1861,12 @@ dxil_module_get_vector_const(struct dxil_module *m, const struct dxil_type *type
                             const struct dxil_value **values)
 {
    assert(type->type == TYPE_VECTOR);
-   unsigned int num_values = type->array_or_vector_def.num_elems;
-
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (!memcmp(c->vector_values, values, sizeof(*values) * num_values))
-         return &c->value;
-   }
 
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-   void *tmp =
-      ralloc_array(m->ralloc_ctx, struct dxil_value *, num_values);
-   memcpy(tmp, values, sizeof(*values) * num_values);
-   c->vector_values = tmp;
-
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .vector_values = values,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1846,17 +1874,11 @@ dxil_module_get_undef(struct dxil_module *m, const struct dxil_type *type)
 {
    assert(type != NULL);
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type)
-         continue;
-
-      if (c->undef)
-         return &c->value;
-   }
-
-   c = create_const(m, type, true);
-   return c ? &c->value : NULL;
+   struct dxil_const key = {
+      .value.type = type,
+      .undef = true,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
@@ -1864,26 +1886,12 @@ dxil_module_get_struct_const(struct dxil_module *m, const struct dxil_type *type
                  const struct dxil_value **values)
 {
    assert(type->type == TYPE_STRUCT);
-   unsigned int num_values = type->struct_def.elem.num_types;
-
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
 
-      if (!memcmp(c->struct_values, values, sizeof(*values) * num_values))
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-   void *tmp =
-      ralloc_array(m->ralloc_ctx, struct dxil_value *, num_values);
-   memcpy(tmp, values, sizeof(*values) * num_values);
-   c->struct_values = tmp;
-
-   return &c->value;
+   struct dxil_const key = {
+      .value.type = type,
+      .struct_values = values,
+   };
+   return get_const(m, &key);
 }
 
 const struct dxil_value *
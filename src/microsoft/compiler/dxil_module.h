@@ -258,6 +258,7 @@ struct dxil_module {
    struct list_head func_def_list;
    struct list_head attr_set_list;
    struct list_head const_list;
+   struct hash_table *const_table;
    struct list_head mdnode_list;
    struct list_head md_named_node_list;
    const struct dxil_type *void_type;
@@ -1192,6 +1192,15 @@ Program::Program(Type type, Target *arch)
    targetPriv = NULL;
 }
 
+size_t
+Program::getIRMemorySize() const
+{
+   return mem_Instruction.getSize() + mem_CmpInstruction.getSize() +
+          mem_TexInstruction.getSize() + mem_FlowInstruction.getSize() +
+          mem_LValue.getSize() + mem_Symbol.getSize() +
+          mem_ImmediateValue.getSize();
+}
+
 Program::~Program()
 {
    for (ArrayList::Iterator it = allFuncs.iterator(); !it.end(); it.next())
@@ -1341,6 +1350,8 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
 
 out:
    INFO_DBG(prog->dbgFlags, VERBOSE, "nv50_ir_generate_code: ret = %i\n", ret);
+   INFO_DBG(prog->dbgFlags, VERBOSE, "peak IR pool memory: %zu bytes\n",
+            prog->getIRMemorySize());
 
    info_out->bin.maxGPR = prog->maxGPR;
    info_out->bin.code = prog->code;
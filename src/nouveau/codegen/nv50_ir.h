@@ -1386,6 +1386,8 @@ public:
    MemoryPool mem_Symbol;
    MemoryPool mem_ImmediateValue;
 
+   size_t getIRMemorySize() const;
+
    uint32_t dbgFlags;
    uint8_t  optLevel;
 
@@ -4432,6 +4432,9 @@ SchedDataCalculatorGM107::visit(BasicBlock *bb)
    setDelay(insn, bbDelay, next);
    cycle += getStall(insn);
 
+   cycleCount += cycle;
+   insnCount += bb->getInsnCount();
+
    score->rebase(cycle); // common base for initializing out blocks' scores
    return true;
 }
@@ -4446,6 +4449,10 @@ CodeEmitterGM107::prepareEmission(Function *func)
    SchedDataCalculatorGM107 sched(targGM107);
    CodeEmitter::prepareEmission(func);
    sched.run(func, true, true);
+
+   INFO_DBG(func->getProgram()->dbgFlags, BASIC,
+            "%s: %i instructions in ~%i cycles\n", func->getName(),
+            sched.getInsnCount(), sched.getCycleCount());
 }
 
 static inline uint32_t sizeToBundlesGM107(uint32_t size)
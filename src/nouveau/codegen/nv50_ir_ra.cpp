@@ -682,6 +682,8 @@ private:
    void buildRIG(ArrayList&);
    bool coalesce(ArrayList&);
    bool doCoalesce(ArrayList&, unsigned int mask);
+   void computeLoopDepths();
+   float refWeight(const Instruction *) const;
    void calculateSpillWeights();
    bool simplify();
    bool selectRegisters();
@@ -740,6 +742,9 @@ private:
    std::list<ValuePair> mustSpill;
 
    MergedDefs &mergedDefs;
+
+   // number of loops each basic block is in, indexed by BB id
+   std::vector<uint8_t> loopDepth;
 };
 
 const GCRA::RelDegree GCRA::relDegree;
@@ -1182,6 +1187,68 @@ GCRA::buildRIG(ArrayList& insns)
    }
 }
 
+// A loop consists of its header and all blocks that reach one of the back
+// edges to it without passing through the header.
+void
+GCRA::computeLoopDepths()
+{
+   const unsigned int size = func->allBBlocks.getSize();
+
+   loopDepth.assign(size, 0);
+   if (!func->loopNestingBound)
+      return;
+
+   std::vector<bool> inLoop;
+   std::stack<BasicBlock *> work;
+
+   for (ArrayList::Iterator bi = func->allBBlocks.iterator();
+        !bi.end(); bi.next()) {
+      BasicBlock *header = BasicBlock::get(bi);
+
+      inLoop.assign(size, false);
+      for (Graph::EdgeIterator ei = header->cfg.incident(); !ei.end(); ei.next()) {
+         if (ei.getType() != Graph::Edge::BACK)
+            continue;
+         inLoop[header->getId()] = true;
+         BasicBlock *latch = BasicBlock::get(ei.getNode());
+         if (!inLoop[latch->getId()]) {
+            inLoop[latch->getId()] = true;
+            work.push(latch);
+         }
+      }
+      if (!inLoop[header->getId()])
+         continue;
+
+      while (!work.empty()) {
+         BasicBlock *bb = work.top();
+         work.pop();
+         for (Graph::EdgeIterator ei = bb->cfg.incident(); !ei.end(); ei.next()) {
+            BasicBlock *pred = BasicBlock::get(ei.getNode());
+            if (!inLoop[pred->getId()]) {
+               inLoop[pred->getId()] = true;
+               work.push(pred);
+            }
+         }
+      }
+
+      for (unsigned int i = 0; i < size; ++i) {
+         if (inLoop[i] && loopDepth[i] < UINT8_MAX)
+            ++loopDepth[i];
+      }
+   }
+}
+
+// References inside loops are executed many times, so make spilling the
+// values used there correspondingly more expensive.
+float
+GCRA::refWeight(const Instruction *insn) const
+{
+   if (!insn->bb)
+      return 1.0f;
+   const unsigned int depth = loopDepth[insn->bb->getId()];
+   return (float)(1 << (3 * std::min(depth, 4u)));
+}
+
 void
 GCRA::calculateSpillWeights()
 {
@@ -1197,12 +1264,13 @@ GCRA::calculateSpillWeights()
       LValue *val = nodes[i].getValue();
 
       if (!val->noSpill) {
-         int rc = 0;
-         for (ValueDef *def : mergedDefs(val))
-            rc += def->get()->refCount();
+         float rc = 0.0f;
+         for (ValueDef *def : mergedDefs(val)) {
+            for (ValueRef *use : def->get()->uses)
+               rc += refWeight(use->getInsn());
+         }
 
-         nodes[i].weight =
-            (float)rc * (float)rc / (float)nodes[i].livei.extent();
+         nodes[i].weight = rc * rc / (float)nodes[i].livei.extent();
       }
 
       if (nodes[i].degree < nodes[i].degreeLimit) {
@@ -1465,6 +1533,7 @@ GCRA::allocateRegisters(ArrayList& insns)
       func->printLiveIntervals();
 
    buildRIG(insns);
+   computeLoopDepths();
    calculateSpillWeights();
    ret = simplify();
    if (!ret)
@@ -7,6 +7,11 @@ class SchedDataCalculatorGM107 : public Pass
 public:
    SchedDataCalculatorGM107(const TargetGM107 *targ) : score(NULL), targ(targ) {}
 
+   // estimated issue cycles of a single pass through all blocks, from the
+   // stall counts
+   int getCycleCount() const { return cycleCount; }
+   int getInsnCount() const { return insnCount; }
+
 private:
    struct RegScores
    {
@@ -102,6 +107,9 @@ private:
    RegScores *score; // for current BB
    std::vector<RegScores> scoreBoards;
 
+   int cycleCount = 0;
+   int insnCount = 0;
+
    const TargetGM107 *targ;
    bool visit(Function *);
    bool visit(BasicBlock *);
@@ -22,8 +22,64 @@
 
 #include "nv50_ir_util.h"
 
+#include <vector>
+
 namespace nv50_ir {
 
+namespace {
+
+// Upper limit for the chunk memory a thread keeps around between compiles.
+const size_t chunkCacheLimit = 8 << 20;
+
+struct ChunkCache
+{
+   ~ChunkCache()
+   {
+      for (const Chunk &chunk : chunks)
+         FREE(chunk.mem);
+   }
+
+   struct Chunk {
+      size_t size;
+      void *mem;
+   };
+
+   std::vector<Chunk> chunks;
+   size_t size = 0;
+};
+
+thread_local ChunkCache chunkCache;
+
+} // anonymous namespace
+
+void *
+MemoryPool::allocChunk(size_t size)
+{
+   std::vector<ChunkCache::Chunk> &chunks = chunkCache.chunks;
+
+   for (size_t i = chunks.size(); i > 0; --i) {
+      if (chunks[i - 1].size == size) {
+         void *mem = chunks[i - 1].mem;
+         chunks[i - 1] = chunks.back();
+         chunks.pop_back();
+         chunkCache.size -= size;
+         return mem;
+      }
+   }
+   return MALLOC(size);
+}
+
+void
+MemoryPool::releaseChunk(void *mem, size_t size)
+{
+   if (chunkCache.size + size > chunkCacheLimit) {
+      FREE(mem);
+      return;
+   }
+   chunkCache.chunks.push_back({ size, mem });
+   chunkCache.size += size;
+}
+
 void DLList::clear()
 {
    for (Item *next, *item = head.next; item != &head; item = next) {
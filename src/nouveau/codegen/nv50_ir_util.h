@@ -607,13 +607,13 @@ private:
    {
       const unsigned int id = count >> objStepLog2;
 
-      uint8_t *const mem = (uint8_t *)MALLOC(objSize << objStepLog2);
+      uint8_t *const mem = (uint8_t *)allocChunk(objSize << objStepLog2);
       if (!mem)
          return false;
 
       if (!(id % 32)) {
          if (!enlargeAllocationsArray(id, 32)) {
-            FREE(mem);
+            releaseChunk(mem, objSize << objStepLog2);
             return false;
          }
       }
@@ -634,7 +634,7 @@ public:
    {
       unsigned int allocCount = (count + (1 << objStepLog2) - 1) >> objStepLog2;
       for (unsigned int i = 0; i < allocCount && allocArray[i]; ++i)
-         FREE(allocArray[i]);
+         releaseChunk(allocArray[i], objSize << objStepLog2);
       if (allocArray)
          FREE(allocArray);
    }
@@ -668,8 +668,21 @@ public:
       released = ptr;
    }
 
+   // memory held by the pool, it never shrinks so this is also the peak
+   size_t getSize() const
+   {
+      const unsigned int allocCount =
+         (count + (1 << objStepLog2) - 1) >> objStepLog2;
+      return (size_t)allocCount * (objSize << objStepLog2);
+   }
+
 private:
-   uint8_t **allocArray; // array (list) of MALLOC allocations
+   // Chunks of freed pools are kept per thread for the next compile, so
+   // allocating them doesn't need any locking.
+   static void *allocChunk(size_t size);
+   static void releaseChunk(void *mem, size_t size);
+
+   uint8_t **allocArray; // array (list) of chunk allocations
 
    void *released; // list of released objects
 
@@ -38,6 +38,8 @@
 #include "zstd.h"
 #endif
 
+#include <stdlib.h>
+
 #include "util/compress.h"
 #include "util/perf/cpu_trace.h"
 #include "macros.h"
@@ -166,4 +168,99 @@ util_compress_inflate(const uint8_t *in_data, size_t in_data_size,
 #endif
 }
 
+struct util_compress_dict {
+#ifdef HAVE_ZSTD
+   ZSTD_CDict *cdict;
+   ZSTD_DDict *ddict;
+   unsigned id;
+#endif
+};
+
+struct util_compress_dict *
+util_compress_dict_create(const void *data, size_t size)
+{
+#ifdef HAVE_ZSTD
+   struct util_compress_dict *dict = calloc(1, sizeof(*dict));
+   if (!dict)
+      return NULL;
+
+   dict->cdict = ZSTD_createCDict(data, size, ZSTD_COMPRESSION_LEVEL);
+   dict->ddict = ZSTD_createDDict(data, size);
+   if (!dict->cdict || !dict->ddict) {
+      util_compress_dict_destroy(dict);
+      return NULL;
+   }
+
+   dict->id = ZSTD_getDictID_fromDDict(dict->ddict);
+   return dict;
+#else
+   return NULL;
+#endif
+}
+
+void
+util_compress_dict_destroy(struct util_compress_dict *dict)
+{
+   if (!dict)
+      return;
+
+#ifdef HAVE_ZSTD
+   ZSTD_freeCDict(dict->cdict);
+   ZSTD_freeDDict(dict->ddict);
+#endif
+   free(dict);
+}
+
+size_t
+util_compress_deflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_buff_size)
+{
+#ifdef HAVE_ZSTD
+   if (dict) {
+      MESA_TRACE_FUNC();
+      ZSTD_CCtx *cctx = ZSTD_createCCtx();
+      if (!cctx)
+         return 0;
+
+      size_t ret = ZSTD_compress_usingCDict(cctx, out_data, out_buff_size,
+                                            in_data, in_data_size,
+                                            dict->cdict);
+      ZSTD_freeCCtx(cctx);
+      return ZSTD_isError(ret) ? 0 : ret;
+   }
+#endif
+
+   return util_compress_deflate(in_data, in_data_size, out_data,
+                                out_buff_size);
+}
+
+bool
+util_compress_inflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_data_size)
+{
+#ifdef HAVE_ZSTD
+   /* Data compressed before the dictionary was set up has no dictionary ID
+    * and still decompresses on its own.  Data compressed with a different
+    * dictionary fails and is treated like a cache miss.
+    */
+   if (dict && (!dict->id || ZSTD_getDictID_fromFrame(in_data, in_data_size))) {
+      MESA_TRACE_FUNC();
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      if (!dctx)
+         return false;
+
+      size_t ret = ZSTD_decompress_usingDDict(dctx, out_data, out_data_size,
+                                              in_data, in_data_size,
+                                              dict->ddict);
+      ZSTD_freeDCtx(dctx);
+      return !ZSTD_isError(ret);
+   }
+#endif
+
+   return util_compress_inflate(in_data, in_data_size, out_data,
+                                out_data_size);
+}
+
 #endif
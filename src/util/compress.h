@@ -37,4 +37,24 @@ size_t
 util_compress_deflate(const uint8_t *in_data, size_t in_data_size,
                       uint8_t *out_data, size_t out_buff_size);
 
+struct util_compress_dict;
+
+/* Returns NULL if the dictionary can't be used, e.g. without zstd. */
+struct util_compress_dict *
+util_compress_dict_create(const void *data, size_t size);
+
+void
+util_compress_dict_destroy(struct util_compress_dict *dict);
+
+/* Like util_compress_inflate/deflate, with a NULL dict behaving the same. */
+bool
+util_compress_inflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_data_size);
+
+size_t
+util_compress_deflate_dict(const struct util_compress_dict *dict,
+                           const uint8_t *in_data, size_t in_data_size,
+                           uint8_t *out_data, size_t out_buff_size);
+
 #endif
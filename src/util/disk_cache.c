@@ -43,6 +43,7 @@
 #include "util/rand_xor.h"
 #include "util/u_atomic.h"
 #include "util/mesa-sha1.h"
+#include "util/os_file.h"
 #include "util/perf/cpu_trace.h"
 #include "util/ralloc.h"
 #include "util/compiler.h"
@@ -138,6 +139,19 @@ disk_cache_type_create(const char *gpu_name,
    if (strcmp(driver_id, "make_check_uncompressed") == 0)
       cache->compression_disabled = true;
 
+   /* A zstd dictionary, e.g. trained with `zstd --train` on entries of this
+    * driver, makes the small cache entries compress much better.
+    */
+   const char *dict_path = getenv("MESA_SHADER_CACHE_ZSTD_DICT");
+   if (dict_path && !cache->compression_disabled) {
+      size_t dict_size;
+      char *dict_data = os_read_file(dict_path, &dict_size);
+      if (dict_data) {
+         cache->compress_dict = util_compress_dict_create(dict_data, dict_size);
+         free(dict_data);
+      }
+   }
+
    if (cache_type == DISK_CACHE_SINGLE_FILE) {
       if (!disk_cache_load_cache_index_foz(local, cache))
          goto path_fail;
@@ -207,8 +221,10 @@ disk_cache_type_create(const char *gpu_name,
    return cache;
 
  fail:
-   if (cache)
+   if (cache) {
+      util_compress_dict_destroy(cache->compress_dict);
       ralloc_free(cache);
+   }
    ralloc_free(local);
 
    return NULL;
@@ -343,6 +359,9 @@ disk_cache_destroy(struct disk_cache *cache)
       disk_cache_destroy_mmap(cache);
    }
 
+   if (cache)
+      util_compress_dict_destroy(cache->compress_dict);
+
    ralloc_free(cache);
 }
 
@@ -493,7 +512,8 @@ blob_put_compressed(struct disk_cache *cache, const cache_key key,
    entry->uncompressed_size = size;
 
    size_t compressed_size =
-         util_compress_deflate(data, size, entry->compressed_data, max_buf);
+         util_compress_deflate_dict(cache->compress_dict, data, size,
+                                    entry->compressed_data, max_buf);
    if (!compressed_size)
       goto out;
 
@@ -541,8 +561,10 @@ blob_get_compressed(struct disk_cache *cache, const cache_key key,
    }
 
    unsigned compressed_size = entry_size - sizeof(*entry);
-   bool ret = util_compress_inflate(entry->compressed_data, compressed_size,
-                                    data, entry->uncompressed_size);
+   bool ret = util_compress_inflate_dict(cache->compress_dict,
+                                         entry->compressed_data,
+                                         compressed_size, data,
+                                         entry->uncompressed_size);
    if (!ret) {
       free(data);
       free(entry);
@@ -630,6 +652,56 @@ disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
    return buf;
 }
 
+struct disk_cache_get_job {
+   struct util_queue_fence fence;
+   struct disk_cache *cache;
+   cache_key key;
+   disk_cache_get_async_cb callback;
+   void *data;
+};
+
+static void
+cache_get_async(void *job, void *gdata, int thread_index)
+{
+   struct disk_cache_get_job *dc_job = (struct disk_cache_get_job *) job;
+   size_t size;
+
+   void *buf = disk_cache_get(dc_job->cache, dc_job->key, &size);
+   dc_job->callback(dc_job->data, buf, size);
+}
+
+static void
+destroy_get_job(void *job, void *gdata, int thread_index)
+{
+   free(job);
+}
+
+void
+disk_cache_get_async(struct disk_cache *cache, const cache_key key,
+                     disk_cache_get_async_cb callback, void *data)
+{
+   struct disk_cache_get_job *dc_job = NULL;
+
+   if (util_queue_is_initialized(&cache->cache_queue))
+      dc_job = malloc(sizeof(*dc_job));
+
+   if (!dc_job) {
+      size_t size;
+      void *buf = disk_cache_get(cache, key, &size);
+      callback(data, buf, size);
+      return;
+   }
+
+   dc_job->cache = cache;
+   memcpy(dc_job->key, key, sizeof(cache_key));
+   dc_job->callback = callback;
+   dc_job->data = data;
+
+   util_queue_fence_init(&dc_job->fence);
+   util_queue_add_job(&cache->cache_queue, dc_job, &dc_job->fence,
+                      cache_get_async, destroy_get_job, 0);
+}
+
 void
 disk_cache_put_key(struct disk_cache *cache, const cache_key key)
 {
@@ -64,6 +64,12 @@ typedef signed long
 (*disk_cache_get_cb) (const void *key, signed long keySize,
                       void *value, signed long valueSize);
 
+/* Called by disk_cache_get_async() with the malloc'ed item, or NULL and
+ * a size of 0 if it wasn't found.  The callee owns the item.
+ */
+typedef void
+(*disk_cache_get_async_cb) (void *data, void *item, size_t size);
+
 struct cache_item_metadata {
    /**
     * The cache item type. This could be used to identify a GLSL cache item,
@@ -234,6 +240,20 @@ disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
 void *
 disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size);
 
+/**
+ * Retrieve an item like disk_cache_get(), but on the cache's worker threads.
+ *
+ * \callback is called with \data and the result once the lookup completed,
+ * from a worker thread, or from the calling thread if the cache has no
+ * worker threads.  With several worker threads the lookup may finish before
+ * earlier disk_cache_put() calls, so use disk_cache_wait_for_idle() first to
+ * read back recent puts.  disk_cache_wait_for_idle() and disk_cache_destroy()
+ * also wait for pending lookups.
+ */
+void
+disk_cache_get_async(struct disk_cache *cache, const cache_key key,
+                     disk_cache_get_async_cb callback, void *data);
+
 /**
  * Store the name \key within the cache, (without any associated data).
  *
@@ -317,6 +337,13 @@ disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
    return NULL;
 }
 
+static inline void
+disk_cache_get_async(struct disk_cache *cache, const cache_key key,
+                     disk_cache_get_async_cb callback, void *data)
+{
+   callback(data, NULL, 0);
+}
+
 static inline void
 disk_cache_put_key(struct disk_cache *cache, const cache_key key)
 {
@@ -613,8 +613,9 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
 
       memcpy(uncompressed_data, data, cache_data_size);
    } else {
-      if (!util_compress_inflate(data, cache_data_size, uncompressed_data,
-                                 cf_data->uncompressed_size))
+      if (!util_compress_inflate_dict(cache->compress_dict, data,
+                                      cache_data_size, uncompressed_data,
+                                      cf_data->uncompressed_size))
          goto fail;
    }
 
@@ -713,8 +714,9 @@ create_cache_item_header_and_blob(struct disk_cache_put_job *dc_job,
       if (compressed_data == NULL)
          return false;
       compressed_size =
-         util_compress_deflate(dc_job->data, dc_job->size,
-                              compressed_data, max_buf);
+         util_compress_deflate_dict(dc_job->cache->compress_dict,
+                                    dc_job->data, dc_job->size,
+                                    compressed_data, max_buf);
       if (compressed_size == 0)
          goto fail;
    }
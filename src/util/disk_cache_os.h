@@ -96,6 +96,9 @@ struct disk_cache {
    /* Don't compress cached data. This is for testing purposes only. */
    bool compression_disabled;
 
+   /* Optional zstd dictionary, see MESA_SHADER_CACHE_ZSTD_DICT. */
+   struct util_compress_dict *compress_dict;
+
    struct {
       bool enabled;
       unsigned hits;
@@ -23,6 +23,7 @@
 from mako.template import Template
 from xml.etree import ElementTree
 import argparse
+import hashlib
 import os
 
 def dbg(str):
@@ -42,8 +43,9 @@ class Option(object):
         self.value = xml.attrib['value']
 
 class Application(object):
-    def __init__(self, xml):
+    def __init__(self, xml, order):
         self.cname = cname('application')
+        self.order = order
         self.name = xml.attrib['name']
         self.executable = xml.attrib.get('executable', None)
         self.executable_regexp = xml.attrib.get('executable_regexp', None)
@@ -56,8 +58,9 @@ class Application(object):
             self.options.append(Option(option))
 
 class Engine(object):
-    def __init__(self, xml):
+    def __init__(self, xml, order):
         self.cname = cname('engine')
+        self.order = order
         self.engine_name_match = xml.attrib['engine_name_match']
         self.engine_versions = xml.attrib.get('engine_versions', None)
         self.options = []
@@ -73,21 +76,36 @@ class Device(object):
         self.applications = []
         self.engines = []
 
-        for application in xml.findall('application'):
-            self.applications.append(Application(application))
+        # Keep track of the document order of applications and engines, as
+        # options they both set need to be applied in that order.
+        for order, child in enumerate(xml):
+            if child.tag == 'application':
+                self.applications.append(Application(child, order))
+            elif child.tag == 'engine':
+                self.engines.append(Engine(child, order))
 
-        for engine in xml.findall('engine'):
-            self.engines.append(Engine(engine))
+class File(object):
+    def __init__(self, xmlpath, first_device, num_devices):
+        self.name = os.path.basename(xmlpath)
+        with open(xmlpath, 'rb') as f:
+            self.sha1 = hashlib.sha1(f.read()).hexdigest()
+        self.first_device = first_device
+        self.num_devices = num_devices
 
 class DriConf(object):
     def __init__(self, xmlpaths):
         self.devices = []
+        self.files = []
         for xmlpath in xmlpaths:
             root = ElementTree.parse(xmlpath).getroot()
 
+            first_device = len(self.devices)
             for device in root.findall('device'):
                 self.devices.append(Device(device))
 
+            self.files.append(File(xmlpath, first_device,
+                                   len(self.devices) - first_device))
+
 
 template = """\
 /* Copyright (C) 2021 Google, Inc.
@@ -124,6 +142,7 @@ struct driconf_application {
     const char *sha1;
     const char *application_name_match;
     const char *application_versions;
+    unsigned order;
     unsigned num_options;
     const struct driconf_option *options;
 };
@@ -131,6 +150,7 @@ struct driconf_application {
 struct driconf_engine {
     const char *engine_name_match;
     const char *engine_versions;
+    unsigned order;
     unsigned num_options;
     const struct driconf_option *options;
 };
@@ -144,6 +164,16 @@ struct driconf_device {
     const struct driconf_application *applications;
 };
 
+/* The devices each built-in drirc file contributed, along with the SHA-1 of
+ * the file, so that an installed copy can be recognized at runtime.
+ */
+struct driconf_file {
+    const char *name;
+    const char *sha1;
+    unsigned first_device;
+    unsigned num_devices;
+};
+
 <%def name="render_options(cname, options)">
 static const struct driconf_option ${cname}[] = {
 %    for option in options:
@@ -164,6 +194,7 @@ static const struct driconf_engine ${device.cname}_engines[] = {
 %        if engine.engine_versions:
       .engine_versions = "${engine.engine_versions}",
 %        endif
+      .order = ${engine.order},
       .num_options = ${len(engine.options)},
       .options = ${engine.cname + '_options'},
     },
@@ -194,6 +225,7 @@ static const struct driconf_application ${device.cname}_applications[] = {
 %        if application.application_versions:
       .application_versions = "${application.application_versions}",
 %        endif
+      .order = ${application.order},
       .num_options = ${len(application.options)},
       .options = ${application.cname + '_options'},
     },
@@ -224,6 +256,16 @@ static const struct driconf_device *driconf[] = {
     &${device.cname},
 %endfor
 };
+
+static const struct driconf_file driconf_files[] = {
+%for file in driconf.files:
+    { .name = "${file.name}",
+      .sha1 = "${file.sha1}",
+      .first_device = ${file.first_device},
+      .num_devices = ${file.num_devices},
+    },
+%endfor
+};
 """
 
 parser = argparse.ArgumentParser()
@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/detect_arch.h"
+#include "util/format/u_format.h"
+
+#if (DETECT_ARCH_X86_64 || (DETECT_ARCH_X86 && defined(__SSE2__))) && !defined(NO_FORMAT_ASM)
+
+#include <emmintrin.h>
+#include "u_format_pack.h"
+
+/* SSE2 is part of the x86-64 baseline, so unlike the NEON paths on 32-bit ARM
+ * these don't need runtime CPU detection.
+ */
+
+/* Swaps the R and B bytes of four 32-bit pixels. */
+static inline __m128i
+swap_rb(__m128i p)
+{
+   const __m128i ga = _mm_set1_epi32(0xff00ff00);
+   const __m128i low = _mm_set1_epi32(0xff);
+
+   __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), low);
+   __m128i b = _mm_slli_epi32(_mm_and_si128(p, low), 16);
+
+   return _mm_or_si128(_mm_and_si128(p, ga), _mm_or_si128(r, b));
+}
+
+/* Converts four RGBA8 unorm pixels to 16 floats, with the same
+ * x * (1.0f / 0xff) the generic code uses so the results are identical.
+ */
+static inline void
+store_rgba8_as_float(float *restrict dst, __m128i p)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128 scale = _mm_set1_ps(1.0f / 0xff);
+
+   __m128i lo = _mm_unpacklo_epi8(p, zero);
+   __m128i hi = _mm_unpackhi_epi8(p, zero);
+
+   _mm_storeu_ps(dst + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+   _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+   _mm_storeu_ps(dst + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+   _mm_storeu_ps(dst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+}
+
+static void
+util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse2(uint8_t *restrict dst, const uint8_t *restrict src, unsigned width)
+{
+   while (width >= 4) {
+      __m128i p = _mm_loadu_si128((const __m128i *)src);
+      _mm_storeu_si128((__m128i *)dst, swap_rb(p));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_b8g8r8a8_unorm_unpack_rgba_8unorm(dst, src, width);
+}
+
+static void
+util_format_b8g8r8a8_unorm_unpack_rgba_float_sse2(void *restrict in_dst, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = in_dst;
+
+   while (width >= 4) {
+      __m128i p = _mm_loadu_si128((const __m128i *)src);
+      store_rgba8_as_float(dst, swap_rb(p));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_b8g8r8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static void
+util_format_r8g8b8a8_unorm_unpack_rgba_float_sse2(void *restrict in_dst, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = in_dst;
+
+   while (width >= 4) {
+      store_rgba8_as_float(dst, _mm_loadu_si128((const __m128i *)src));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_r8g8b8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static const struct util_format_unpack_description util_format_unpack_descriptions_sse2[] = {
+   [PIPE_FORMAT_B8G8R8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse2,
+      .unpack_rgba = &util_format_b8g8r8a8_unorm_unpack_rgba_float_sse2,
+   },
+   [PIPE_FORMAT_R8G8B8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8a8_unorm_unpack_rgba_8unorm,
+      .unpack_rgba = &util_format_r8g8b8a8_unorm_unpack_rgba_float_sse2,
+   },
+};
+
+const struct util_format_unpack_description *
+util_format_unpack_description_sse2(enum pipe_format format)
+{
+   if (format >= ARRAY_SIZE(util_format_unpack_descriptions_sse2))
+      return NULL;
+
+   if (!util_format_unpack_descriptions_sse2[format].unpack_rgba)
+      return NULL;
+
+   return &util_format_unpack_descriptions_sse2[format];
+}
+
+#endif /* DETECT_ARCH_X86_64 || DETECT_ARCH_X86 */
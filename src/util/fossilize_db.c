@@ -114,6 +114,14 @@ create_foz_db_filenames(const char *cache_path,
 }
 
 
+/* Index entries are a blob hash, a payload header and the 64bit offset of
+ * the cache item, read in batches of this many.
+ */
+#define FOZ_INDEX_ENTRY_SIZE \
+   (FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header) + \
+    sizeof(uint64_t))
+#define FOZ_INDEX_ENTRIES_PER_READ 1024
+
 /* This looks at stuff that was added to the index since the last time we looked at it. This is safe
  * to do without locking the file as we assume the file is append only */
 static void
@@ -124,65 +132,77 @@ update_foz_index(struct foz_db *foz_db, FILE *db_idx, unsigned file_idx)
    uint64_t len = ftell(db_idx);
    uint64_t parsed_offset = offset;
 
+   fseek(db_idx, offset, SEEK_SET);
    if (offset == len)
       return;
 
-   fseek(db_idx, offset, SEEK_SET);
-   while (offset < len) {
-      char bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header)];
-      struct foz_payload_header *header;
+   uint8_t *buf = malloc(FOZ_INDEX_ENTRIES_PER_READ * FOZ_INDEX_ENTRY_SIZE);
+   if (!buf)
+      return;
+
+   struct hash_table *table = foz_db->index_db->table;
+   _mesa_hash_table_reserve(table, _mesa_hash_table_num_entries(table) +
+                            (len - offset) / FOZ_INDEX_ENTRY_SIZE);
 
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
+   while (offset < len) {
+      /* A trailing partial entry is corrupt, our process might have been
+       * killed before we could write all data.
        */
-      if (offset + sizeof(bytes_to_read) > len)
+      size_t count = MIN2((len - offset) / FOZ_INDEX_ENTRY_SIZE,
+                          FOZ_INDEX_ENTRIES_PER_READ);
+      if (!count)
          break;
 
-      /* NAME + HEADER in one read */
-      if (fread(bytes_to_read, 1, sizeof(bytes_to_read), db_idx) !=
-          sizeof(bytes_to_read))
+      count = fread(buf, FOZ_INDEX_ENTRY_SIZE, count, db_idx);
+      if (!count)
          break;
 
-      offset += sizeof(bytes_to_read);
-      header = (struct foz_payload_header*)&bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH];
+      offset += count * FOZ_INDEX_ENTRY_SIZE;
 
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
+      /* One allocation per batch rather than per entry keeps the memory
+       * overhead of big indices down.
        */
-      if (offset + header->payload_size > len ||
-          header->payload_size != sizeof(uint64_t))
+      struct foz_db_entry *entries =
+         ralloc_array(foz_db->mem_ctx, struct foz_db_entry, count);
+      if (!entries)
          break;
 
-      char hash_str[FOSSILIZE_BLOB_HASH_LENGTH + 1] = {0};
-      memcpy(hash_str, bytes_to_read, FOSSILIZE_BLOB_HASH_LENGTH);
+      for (size_t i = 0; i < count; i++) {
+         const uint8_t *bytes = buf + i * FOZ_INDEX_ENTRY_SIZE;
+         struct foz_db_entry *entry = &entries[i];
 
-      /* read cache item offset from index file */
-      uint64_t cache_offset;
-      if (fread(&cache_offset, 1, sizeof(cache_offset), db_idx) !=
-          sizeof(cache_offset))
-         break;
+         memcpy(&entry->header, bytes + FOSSILIZE_BLOB_HASH_LENGTH,
+                sizeof(entry->header));
 
-      offset += header->payload_size;
-      parsed_offset = offset;
+         /* Corrupt entry. */
+         if (entry->header.payload_size != sizeof(uint64_t))
+            goto out;
 
-      struct foz_db_entry *entry = ralloc(foz_db->mem_ctx,
-                                          struct foz_db_entry);
-      entry->header = *header;
-      entry->file_idx = file_idx;
-      _mesa_sha1_hex_to_sha1(entry->key, hash_str);
+         char hash_str[FOSSILIZE_BLOB_HASH_LENGTH + 1] = {0};
+         memcpy(hash_str, bytes, FOSSILIZE_BLOB_HASH_LENGTH);
 
-      /* Truncate the entry's hash string to a 64bit hash for use with a
-       * 64bit hash table for looking up file offsets.
-       */
-      hash_str[16] = '\0';
-      uint64_t key = strtoull(hash_str, NULL, 16);
+         /* read cache item offset from index file */
+         memcpy(&entry->offset,
+                bytes + FOSSILIZE_BLOB_HASH_LENGTH + sizeof(entry->header),
+                sizeof(entry->offset));
 
-      entry->offset = cache_offset;
+         entry->file_idx = file_idx;
+         _mesa_sha1_hex_to_sha1(entry->key, hash_str);
 
-      _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
-   }
+         /* Truncate the entry's hash string to a 64bit hash for use with a
+          * 64bit hash table for looking up file offsets.
+          */
+         hash_str[16] = '\0';
+         uint64_t key = strtoull(hash_str, NULL, 16);
 
+         _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
+
+         parsed_offset += FOZ_INDEX_ENTRY_SIZE;
+      }
+   }
 
+out:
+   free(buf);
    fseek(db_idx, parsed_offset, SEEK_SET);
 }
 
@@ -109,7 +109,7 @@ mesa_db_flock(FILE *file, int op)
 }
 
 static bool
-mesa_db_lock(struct mesa_cache_db *db)
+mesa_db_lock_op(struct mesa_cache_db *db, int op)
 {
    simple_mtx_lock(&db->flock_mtx);
 
@@ -117,10 +117,10 @@ mesa_db_lock(struct mesa_cache_db *db)
        !mesa_db_reopen_file(&db->cache))
       goto close_files;
 
-   if (mesa_db_flock(db->cache.file, LOCK_EX) < 0)
+   if (mesa_db_flock(db->cache.file, op) < 0)
       goto close_files;
 
-   if (mesa_db_flock(db->index.file, LOCK_EX) < 0)
+   if (mesa_db_flock(db->index.file, op) < 0)
       goto unlock_cache;
 
    return true;
@@ -136,6 +136,21 @@ close_files:
    return false;
 }
 
+static bool
+mesa_db_lock(struct mesa_cache_db *db)
+{
+   return mesa_db_lock_op(db, LOCK_EX);
+}
+
+/* Other processes may read at the same time, so nothing but the access
+ * time of the entry being read may be written under this lock.
+ */
+static bool
+mesa_db_lock_shared(struct mesa_cache_db *db)
+{
+   return mesa_db_lock_op(db, LOCK_SH);
+}
+
 static void
 mesa_db_unlock(struct mesa_cache_db *db)
 {
@@ -505,6 +520,36 @@ entry_sort_lru(const void *_a, const void *_b, void *arg)
    return a->last_access_time > b->last_access_time ? 1 : -1;
 }
 
+/* Sorts entries by access time like entry_sort_lru, which is the slow part
+ * of compacting and scoring a big DB with util_qsort_r.
+ */
+static void
+mesa_db_sort_entries_lru(struct mesa_cache_db *db,
+                         struct mesa_index_db_hash_entry **entries,
+                         size_t num_entries)
+{
+   struct util_radix_sort_item *items =
+      malloc(2 * num_entries * sizeof(*items));
+
+   if (!items) {
+      util_qsort_r(entries, num_entries, sizeof(*entries),
+                   entry_sort_lru, db);
+      return;
+   }
+
+   for (size_t i = 0; i < num_entries; i++) {
+      items[i].key = entries[i]->last_access_time;
+      items[i].data = entries[i];
+   }
+
+   util_radix_sort_u64(items, items + num_entries, num_entries);
+
+   for (size_t i = 0; i < num_entries; i++)
+      entries[i] = items[i].data;
+
+   free(items);
+}
+
 static int
 entry_sort_offset(const void *_a, const void *_b, void *arg)
 {
@@ -570,8 +615,7 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size,
       i++;
    }
 
-   util_qsort_r(entries, num_entries, sizeof(*entries),
-                entry_sort_lru, db);
+   mesa_db_sort_entries_lru(db, entries, num_entries);
 
    for (i = 0; blob_size > 0 && i < num_entries; i++) {
       blob_size -= blob_file_size(entries[i]->size);
@@ -760,10 +804,10 @@ mesa_cache_db_file_entry_size(void)
    return sizeof(struct mesa_cache_db_file_entry);
 }
 
-void *
-mesa_cache_db_read_entry(struct mesa_cache_db *db,
-                         const uint8_t *cache_key_160bit,
-                         size_t *size)
+static void *
+mesa_db_read_entry(struct mesa_cache_db *db,
+                   const uint8_t *cache_key_160bit,
+                   size_t *size, bool shared, bool *retry)
 {
    uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
    struct mesa_cache_db_file_entry cache_entry;
@@ -771,14 +815,24 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    struct mesa_index_db_hash_entry *hash_entry;
    void *data = NULL;
 
-   if (!mesa_db_lock(db))
+   *retry = false;
+
+   if (shared ? !mesa_db_lock_shared(db) : !mesa_db_lock(db))
       return NULL;
 
    if (!db->alive)
       goto fail;
 
-   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
-      goto fail_fatal;
+   if (mesa_db_uuid_changed(db)) {
+      /* Reloading may recreate the files, which needs the exclusive lock. */
+      if (shared) {
+         *retry = true;
+         goto fail;
+      }
+
+      if (!mesa_db_reload(db))
+         goto fail_fatal;
+   }
 
    if (!mesa_db_update_index(db))
       goto fail_fatal;
@@ -826,6 +880,11 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    return data;
 
 fail_fatal:
+   if (shared) {
+      *retry = true;
+      goto fail;
+   }
+
    mesa_db_zap(db);
 fail:
    free(data);
@@ -835,6 +894,26 @@ fail:
    return NULL;
 }
 
+void *
+mesa_cache_db_read_entry(struct mesa_cache_db *db,
+                         const uint8_t *cache_key_160bit,
+                         size_t *size)
+{
+   bool retry;
+   void *data;
+
+   /* Lookups only update the access time of the entry, so they take the
+    * file locks shared and processes using the same DB don't serialize on
+    * each other.  Anything that needs to rewrite the files, like a reload
+    * or zapping a corrupted DB, is redone under the exclusive lock.
+    */
+   data = mesa_db_read_entry(db, cache_key_160bit, size, true, &retry);
+   if (!data && retry)
+      data = mesa_db_read_entry(db, cache_key_160bit, size, false, &retry);
+
+   return data;
+}
+
 static bool
 mesa_cache_db_has_space_locked(struct mesa_cache_db *db, size_t blob_size)
 {
@@ -1045,8 +1124,7 @@ mesa_cache_db_eviction_score(struct mesa_cache_db *db)
    hash_table_foreach(db->index_db->table, entry)
       entries[i++] = entry->data;
 
-   util_qsort_r(entries, num_entries, sizeof(*entries),
-                entry_sort_lru, db);
+   mesa_db_sort_entries_lru(db, entries, num_entries);
 
    for (i = 0; eviction_size > 0 && i < num_entries; i++) {
       uint64_t entry_age = os_time_get_nano() - entries[i]->last_access_time;
@@ -33,7 +33,11 @@
 #define __NEEDS_TRACE_PRIV
 #include "u_trace_priv.h"
 
-#define PAYLOAD_BUFFER_SIZE 0x100
+/* Payloads are typically a few dozen bytes, so size the buffers to hold the
+ * payloads of a good part of a chunk rather than allocating a new one every
+ * handful of tracepoints.
+ */
+#define PAYLOAD_BUFFER_SIZE 0x1000
 #define TIMESTAMP_BUF_SIZE 0x1000
 #define TRACES_PER_CHUNK (TIMESTAMP_BUF_SIZE / sizeof(uint64_t))
 
@@ -33,6 +33,10 @@
 #include "util/u_math.h"
 #include "util/u_printf.h"
 
+#ifdef RALLOC_THREAD_CACHE
+#include "util/u_call_once.h"
+#endif
+
 #include "ralloc.h"
 
 #define CANARY 0x5A1106
@@ -58,6 +62,11 @@ struct ralloc_header
    unsigned size;
 #endif
 
+#ifdef RALLOC_THREAD_CACHE
+   /* Thread cache bucket the block fits in, or THREAD_CACHE_NO_BUCKET. */
+   uint8_t cache_bucket;
+#endif
+
    struct ralloc_header *parent;
 
    /* The first child (head of a linked list) */
@@ -86,6 +95,170 @@ get_header(const void *ptr)
 
 #define PTR_FROM_HEADER(info) (((char *) info) + sizeof(ralloc_header))
 
+#ifdef RALLOC_THREAD_CACHE
+/* A per-thread cache of freed small blocks, so that compiler threads
+ * allocating and freeing lots of small nodes mostly stay out of the system
+ * allocator.  Blocks are plain malloc() memory, so a block freed by one
+ * thread just lands in that thread's cache and can be reused from there.
+ */
+#define THREAD_CACHE_GRANULARITY 16
+#define THREAD_CACHE_MAX_BLOCK_SIZE 512
+#define THREAD_CACHE_NUM_BUCKETS \
+   (THREAD_CACHE_MAX_BLOCK_SIZE / THREAD_CACHE_GRANULARITY)
+#define THREAD_CACHE_MAX_BLOCKS 32
+#define THREAD_CACHE_NO_BUCKET UINT8_MAX
+
+static_assert(THREAD_CACHE_GRANULARITY % alignof(ralloc_header) == 0,
+              "Thread cache blocks must keep the header aligned");
+static_assert(THREAD_CACHE_NUM_BUCKETS < THREAD_CACHE_NO_BUCKET,
+              "Thread cache buckets use uint8_t");
+
+enum thread_cache_state {
+   THREAD_CACHE_UNINITIALIZED = 0,
+   THREAD_CACHE_ACTIVE,
+   /* The thread is exiting, don't cache anything anymore. */
+   THREAD_CACHE_DEAD,
+};
+
+struct ralloc_thread_cache {
+   /* Free blocks of each bucket, linked through their next pointer. */
+   ralloc_header *blocks[THREAD_CACHE_NUM_BUCKETS];
+   uint8_t count[THREAD_CACHE_NUM_BUCKETS];
+   enum thread_cache_state state;
+};
+
+static thread_local struct ralloc_thread_cache thread_cache;
+static tss_t thread_cache_key;
+static bool thread_cache_key_valid;
+static util_once_flag thread_cache_once = UTIL_ONCE_FLAG_INIT;
+
+static void
+thread_cache_destroy(void *data)
+{
+   struct ralloc_thread_cache *cache = data;
+
+   for (unsigned i = 0; i < THREAD_CACHE_NUM_BUCKETS; i++) {
+      while (cache->blocks[i]) {
+         ralloc_header *info = cache->blocks[i];
+         cache->blocks[i] = info->next;
+         free(info);
+      }
+      cache->count[i] = 0;
+   }
+
+   cache->state = THREAD_CACHE_DEAD;
+}
+
+static void
+thread_cache_create_key(void)
+{
+   thread_cache_key_valid =
+      tss_create(&thread_cache_key, thread_cache_destroy) == thrd_success;
+}
+
+static struct ralloc_thread_cache *
+get_thread_cache(void)
+{
+   struct ralloc_thread_cache *cache = &thread_cache;
+
+   if (likely(cache->state == THREAD_CACHE_ACTIVE))
+      return cache;
+
+   if (cache->state == THREAD_CACHE_DEAD)
+      return NULL;
+
+   /* Register the cache so it gets emptied when the thread exits. */
+   util_call_once(&thread_cache_once, thread_cache_create_key);
+   if (!thread_cache_key_valid ||
+       tss_set(thread_cache_key, cache) != thrd_success) {
+      cache->state = THREAD_CACHE_DEAD;
+      return NULL;
+   }
+
+   cache->state = THREAD_CACHE_ACTIVE;
+   return cache;
+}
+
+static unsigned
+thread_cache_bucket(size_t block_size)
+{
+   return DIV_ROUND_UP(block_size, THREAD_CACHE_GRANULARITY) - 1;
+}
+#endif
+
+/* Allocates a block of block_size bytes for a header and its data. */
+static ralloc_header *
+alloc_block(size_t block_size)
+{
+#ifdef RALLOC_THREAD_CACHE
+   if (block_size <= THREAD_CACHE_MAX_BLOCK_SIZE) {
+      unsigned bucket = thread_cache_bucket(block_size);
+      struct ralloc_thread_cache *cache = get_thread_cache();
+      ralloc_header *info;
+
+      if (cache && cache->blocks[bucket]) {
+         info = cache->blocks[bucket];
+         cache->blocks[bucket] = info->next;
+         cache->count[bucket]--;
+      } else {
+         info = malloc((bucket + 1) * THREAD_CACHE_GRANULARITY);
+      }
+
+      if (likely(info != NULL))
+         info->cache_bucket = bucket;
+      return info;
+   }
+
+   ralloc_header *info = malloc(block_size);
+   if (likely(info != NULL))
+      info->cache_bucket = THREAD_CACHE_NO_BUCKET;
+   return info;
+#else
+   return malloc(block_size);
+#endif
+}
+
+static ralloc_header *
+realloc_block(ralloc_header *old, size_t block_size)
+{
+#ifdef RALLOC_THREAD_CACHE
+   unsigned bucket = THREAD_CACHE_NO_BUCKET;
+
+   if (block_size <= THREAD_CACHE_MAX_BLOCK_SIZE) {
+      bucket = thread_cache_bucket(block_size);
+      block_size = (bucket + 1) * THREAD_CACHE_GRANULARITY;
+   }
+
+   ralloc_header *info = realloc(old, block_size);
+   if (likely(info != NULL))
+      info->cache_bucket = bucket;
+   return info;
+#else
+   return realloc(old, block_size);
+#endif
+}
+
+static void
+free_block(ralloc_header *info)
+{
+#ifdef RALLOC_THREAD_CACHE
+   unsigned bucket = info->cache_bucket;
+
+   if (bucket != THREAD_CACHE_NO_BUCKET) {
+      struct ralloc_thread_cache *cache = get_thread_cache();
+
+      if (cache && cache->count[bucket] < THREAD_CACHE_MAX_BLOCKS) {
+         info->next = cache->blocks[bucket];
+         cache->blocks[bucket] = info;
+         cache->count[bucket]++;
+         return;
+      }
+   }
+#endif
+
+   free(info);
+}
+
 static void
 add_child(ralloc_header *parent, ralloc_header *info)
 {
@@ -115,8 +288,8 @@ ralloc_size(const void *ctx, size_t size)
     *  - Allocations of a size that rounds up to a multiple of 8 bytes and
     *    not 16 bytes, are only required to have at least 8 byte alignment.
     */
-   void *block = malloc(align64(size + sizeof(ralloc_header),
-                                alignof(ralloc_header)));
+   void *block = alloc_block(align64(size + sizeof(ralloc_header),
+                                     alignof(ralloc_header)));
    ralloc_header *info;
    ralloc_header *parent;
 
@@ -164,8 +337,8 @@ resize(void *ptr, size_t size)
    ralloc_header *child, *old, *info;
 
    old = get_header(ptr);
-   info = realloc(old, align64(size + sizeof(ralloc_header),
-                               alignof(ralloc_header)));
+   info = realloc_block(old, align64(size + sizeof(ralloc_header),
+                                     alignof(ralloc_header)));
 
    if (info == NULL)
       return NULL;
@@ -323,7 +496,7 @@ unsafe_free(ralloc_header *info)
    if (info->destructor != NULL)
       info->destructor(PTR_FROM_HEADER(info));
 
-   free(info);
+   free_block(info);
 }
 
 void
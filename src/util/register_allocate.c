@@ -856,24 +856,6 @@ ra_class_allocations_conflict(struct ra_class *c1, unsigned int r1,
    }
 }
 
-static struct ra_node *
-ra_find_conflicting_neighbor(struct ra_graph *g, unsigned int n, unsigned int r)
-{
-   struct ra_list *adj = &g->nodes[n].adjacency;
-   for (unsigned i = 0; i < adj->size; i++) {
-      unsigned int n2 = adj->elems[i];
-
-      /* If our adjacent node is in the stack, it's not allocated yet. */
-      if (!BITSET_TEST(g->tmp.in_stack, n2) &&
-          ra_class_allocations_conflict(g->regs->classes[g->nodes[n].class], r,
-                                        g->regs->classes[g->nodes[n2].class], g->nodes[n2].reg)) {
-         return &g->nodes[n2];
-      }
-   }
-
-   return NULL;
-}
-
 /* Computes a bitfield of what regs are available for a given register
  * selection.
  *
@@ -917,6 +899,36 @@ ra_compute_available_regs(struct ra_graph *g, unsigned int n, BITSET_WORD *regs)
    return false;
 }
 
+/* Returns the first reg set in regs at or after start, wrapping around to
+ * the beginning of the register file.  regs must have at least one bit set.
+ */
+static unsigned int
+ra_find_available_reg(const BITSET_WORD *regs, unsigned int count,
+                      unsigned int start)
+{
+   const unsigned int words = BITSET_WORDS(count);
+   unsigned int start_word;
+   BITSET_WORD tmp;
+
+   start %= count;
+   start_word = BITSET_BITWORD(start);
+
+   tmp = regs[start_word] & (~(BITSET_WORD)0 << (start % BITSET_WORDBITS));
+   for (unsigned int i = start_word; i < words; i++) {
+      if (i != start_word)
+         tmp = regs[i];
+      if (tmp)
+         return i * BITSET_WORDBITS + ffs(tmp) - 1;
+   }
+
+   for (unsigned int i = 0; i <= start_word; i++) {
+      if (regs[i])
+         return i * BITSET_WORDBITS + ffs(regs[i]) - 1;
+   }
+
+   unreachable("no available reg");
+}
+
 /**
  * Pops nodes from the stack back into the graph, coloring them with
  * registers as they go.
@@ -928,58 +940,36 @@ static bool
 ra_select(struct ra_graph *g)
 {
    int start_search_reg = 0;
-   BITSET_WORD *select_regs = NULL;
-
-   if (g->select_reg_callback)
-      select_regs = malloc(BITSET_WORDS(g->regs->count) * sizeof(BITSET_WORD));
+   BITSET_WORD *select_regs =
+      malloc(BITSET_WORDS(g->regs->count) * sizeof(BITSET_WORD));
 
    while (g->tmp.stack_count != 0) {
-      unsigned int ri;
-      unsigned int r = -1;
+      unsigned int r;
       int n = g->tmp.stack[g->tmp.stack_count - 1];
-      struct ra_class *c = g->regs->classes[g->nodes[n].class];
 
       /* set this to false even if we return here so that
        * ra_get_best_spill_node() considers this node later.
        */
       BITSET_CLEAR(g->tmp.in_stack, n);
 
-      if (g->select_reg_callback) {
-         if (!ra_compute_available_regs(g, n, select_regs)) {
-            free(select_regs);
-            return false;
-         }
+      /* Computing the whole set of available regs once is a handful of word
+       * operations per neighbor, while probing the regs one at a time walks
+       * the adjacency list again for every reg that turns out to conflict.
+       */
+      if (!ra_compute_available_regs(g, n, select_regs)) {
+         free(select_regs);
+         return false;
+      }
 
+      if (g->select_reg_callback) {
          r = g->select_reg_callback(n, select_regs, g->select_reg_callback_data);
          assert(r < g->regs->count);
       } else {
          /* Find the lowest-numbered reg which is not used by a member
           * of the graph adjacent to us.
           */
-         for (ri = 0; ri < g->regs->count; ri++) {
-            r = (start_search_reg + ri) % g->regs->count;
-            if (!reg_belongs_to_class(r, c))
-               continue;
-
-            struct ra_node *conflicting = ra_find_conflicting_neighbor(g, n, r);
-            if (!conflicting) {
-               /* Found a reg! */
-               break;
-            }
-            if (g->regs->classes[conflicting->class]->contig_len) {
-               /* Skip to point at the last base reg of the conflicting reg
-                * allocation -- the loop will increment us to check the next reg
-                * after the conflicting allocaiton.
-                */
-               unsigned conflicting_end = (conflicting->reg +
-                                           g->regs->classes[conflicting->class]->contig_len - 1);
-               assert(conflicting_end >= r);
-               ri += conflicting_end - r;
-            }
-         }
-
-         if (ri >= g->regs->count)
-            return false;
+         r = ra_find_available_reg(select_regs, g->regs->count,
+                                   start_search_reg);
       }
 
       g->nodes[n].reg = r;
@@ -31,6 +31,12 @@
 #define SLAB_MAGIC_ALLOCATED 0xcafe4321
 #define SLAB_MAGIC_FREE 0x7ee01234
 
+/* Bounds of the number of elements freed into another pool that are
+ * collected before they are returned to their owner.
+ */
+#define SLAB_MAGAZINE_MIN 4
+#define SLAB_MAGAZINE_MAX 64
+
 #ifndef NDEBUG
 #define SET_MAGIC(element, value)   (element)->magic = (value)
 #define CHECK_MAGIC(element, value) assert((element)->magic == (value))
@@ -129,6 +135,66 @@ void slab_create_child(struct slab_child_pool *pool,
    pool->pages = NULL;
    pool->free = NULL;
    pool->migrated = NULL;
+   pool->magazine = NULL;
+   pool->magazine_owner = 0;
+   pool->magazine_count = 0;
+   pool->magazine_size = MIN2(SLAB_MAGAZINE_MIN, parent->num_elements);
+}
+
+/* Hand the magazine back to its owner. Must be called with the parent mutex
+ * held, the elements are returned if their pages have been orphaned, and
+ * must then be freed with slab_free_orphaned after unlocking.
+ */
+static struct slab_element_header *
+slab_flush_magazine_locked(struct slab_child_pool *pool)
+{
+   struct slab_element_header *orphaned = NULL;
+
+   /* The owner may have been destroyed since the elements were freed, and
+    * even replaced by a new pool at the same address, so look at each of
+    * them again.
+    */
+   while (pool->magazine) {
+      struct slab_element_header *elt = pool->magazine;
+      intptr_t owner_int = p_atomic_read(&elt->owner);
+
+      pool->magazine = elt->next;
+
+      if (!(owner_int & 1)) {
+         struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+         elt->next = owner->migrated;
+         p_atomic_set(&owner->migrated, elt);
+      } else {
+         elt->next = orphaned;
+         orphaned = elt;
+      }
+   }
+
+   pool->magazine_owner = 0;
+   pool->magazine_count = 0;
+   return orphaned;
+}
+
+static void
+slab_free_orphaned_list(struct slab_element_header *elt)
+{
+   while (elt) {
+      struct slab_element_header *next = elt->next;
+      slab_free_orphaned(elt);
+      elt = next;
+   }
+}
+
+static void
+slab_flush_magazine(struct slab_child_pool *pool)
+{
+   struct slab_element_header *orphaned;
+
+   simple_mtx_lock(&pool->parent->mutex);
+   orphaned = slab_flush_magazine_locked(pool);
+   simple_mtx_unlock(&pool->parent->mutex);
+
+   slab_free_orphaned_list(orphaned);
 }
 
 /**
@@ -144,6 +210,8 @@ void slab_destroy_child(struct slab_child_pool *pool)
 
    simple_mtx_lock(&pool->parent->mutex);
 
+   struct slab_element_header *orphaned = slab_flush_magazine_locked(pool);
+
    while (pool->pages) {
       struct slab_page_header *page = pool->pages;
       pool->pages = page->u.next;
@@ -163,6 +231,8 @@ void slab_destroy_child(struct slab_child_pool *pool)
 
    simple_mtx_unlock(&pool->parent->mutex);
 
+   slab_free_orphaned_list(orphaned);
+
    while (pool->free) {
       struct slab_element_header *elt = pool->free;
       pool->free = elt->next;
@@ -209,13 +279,22 @@ slab_alloc(struct slab_child_pool *pool)
    struct slab_element_header *elt;
 
    if (!pool->free) {
+      struct slab_element_header *orphaned = NULL;
+
       /* First, collect elements that belong to us but were freed from a
-       * different child pool.
+       * different child pool. Don't bother with the mutex if there are none
+       * and we aren't holding any elements of other pools either, a
+       * concurrent return just ends up in the next refill.
        */
-      simple_mtx_lock(&pool->parent->mutex);
-      pool->free = pool->migrated;
-      pool->migrated = NULL;
-      simple_mtx_unlock(&pool->parent->mutex);
+      if (p_atomic_read(&pool->migrated) || pool->magazine) {
+         simple_mtx_lock(&pool->parent->mutex);
+         pool->free = pool->migrated;
+         pool->migrated = NULL;
+         orphaned = slab_flush_magazine_locked(pool);
+         simple_mtx_unlock(&pool->parent->mutex);
+
+         slab_free_orphaned_list(orphaned);
+      }
 
       /* Now allocate a new page. */
       if (!pool->free && !slab_add_new_page(pool))
@@ -250,7 +329,9 @@ slab_zalloc(struct slab_child_pool *pool)
  *
  * Freeing an object in a different child pool from the one where it was
  * allocated is allowed, as long the pool belong to the same parent. No
- * additional locking is required in this case.
+ * additional locking is required in this case. Such objects are batched up
+ * and returned to their owner once enough of them have been freed, or when
+ * this pool needs to take the parent mutex anyway.
  */
 void slab_free(struct slab_child_pool *pool, void *ptr)
 {
@@ -269,7 +350,36 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
       return;
    }
 
-   /* The slow case: migration or an orphaned page. */
+   /* Migration: collect runs of elements with the same owner, so that they
+    * can be returned with a single lock. The owner may be destroyed before
+    * that, which is sorted out when flushing.
+    */
+   owner_int = p_atomic_read(&elt->owner);
+   if (pool->parent && !(owner_int & 1)) {
+      if (pool->magazine && pool->magazine_owner != owner_int) {
+         /* Frees alternate between owners, smaller batches waste less. */
+         pool->magazine_size = MAX2(pool->magazine_size / 2,
+                                    MIN2(SLAB_MAGAZINE_MIN,
+                                         pool->parent->num_elements));
+         slab_flush_magazine(pool);
+      }
+
+      if (!pool->magazine)
+         pool->magazine_owner = owner_int;
+      elt->next = pool->magazine;
+      pool->magazine = elt;
+
+      if (++pool->magazine_count >= pool->magazine_size) {
+         /* A steady stream of frees for one owner, batch more of them. */
+         pool->magazine_size = MIN2(pool->magazine_size * 2,
+                                    MIN2(SLAB_MAGAZINE_MAX,
+                                         pool->parent->num_elements));
+         slab_flush_magazine(pool);
+      }
+      return;
+   }
+
+   /* The slow case: an orphaned page, or freeing without a pool. */
    if (pool->parent)
       simple_mtx_lock(&pool->parent->mutex);
 
@@ -281,7 +391,7 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
    if (!(owner_int & 1)) {
       struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
       elt->next = owner->migrated;
-      owner->migrated = elt;
+      p_atomic_set(&owner->migrated, elt);
       if (pool->parent)
          simple_mtx_unlock(&pool->parent->mutex);
    } else {
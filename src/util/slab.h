@@ -33,7 +33,8 @@
  * Allocations obtained from one child pool should usually be freed in the
  * same child pool. Freeing an allocation in a different child pool associated
  * to the same parent is allowed (and requires no locking by the caller), but
- * it is discouraged because it implies a performance penalty.
+ * it is slower. Such frees are collected in a small "magazine" of the freeing
+ * pool, which is handed back to the owner in one go under the parent mutex.
  *
  * For convenience and to ease the transition, there is also a set of wrapper
  * functions around a single parent-child pair.
@@ -72,6 +73,15 @@ struct slab_child_pool {
     * This list is protected by the parent mutex.
     */
    struct slab_element_header *migrated;
+
+   /* Elements of another pool that were freed with this pool as the
+    * argument to slab_free, and that haven't been returned to their owner
+    * yet. They all have the same owner.
+    */
+   struct slab_element_header *magazine;
+   intptr_t magazine_owner;
+   unsigned magazine_count;
+   unsigned magazine_size;
 };
 
 void slab_create_parent(struct slab_parent_pool *parent,
@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "util/streaming-load-memcpy.h"
+
+/* Copies the bulk of a 16-byte aligned buffer with 32-byte VMOVNTDQA loads,
+ * four per iteration to keep one full cacheline of streaming loads in
+ * flight.  dst and src must be aligned the same modulo 32.  Returns the
+ * number of bytes copied, the caller copies the rest.
+ */
+size_t
+util_streaming_load_memcpy_avx2(void *restrict dst, void *restrict src,
+                                size_t len)
+{
+   char *restrict d = dst;
+   char *restrict s = src;
+   size_t copied = 0;
+
+   assert(!(((uintptr_t)d ^ (uintptr_t)s) & 31));
+   assert(!((uintptr_t)d & 15));
+
+   if (len >= 16 && ((uintptr_t)d & 31)) {
+      _mm_store_si128((__m128i *)d, _mm_stream_load_si128((__m128i *)s));
+      d += 16;
+      s += 16;
+      len -= 16;
+      copied += 16;
+   }
+
+   while (len >= 128) {
+      __m256i *dst_lines = (__m256i *)d;
+      __m256i *src_lines = (__m256i *)s;
+
+      __m256i temp1 = _mm256_stream_load_si256(src_lines + 0);
+      __m256i temp2 = _mm256_stream_load_si256(src_lines + 1);
+      __m256i temp3 = _mm256_stream_load_si256(src_lines + 2);
+      __m256i temp4 = _mm256_stream_load_si256(src_lines + 3);
+
+      _mm256_store_si256(dst_lines + 0, temp1);
+      _mm256_store_si256(dst_lines + 1, temp2);
+      _mm256_store_si256(dst_lines + 2, temp3);
+      _mm256_store_si256(dst_lines + 3, temp4);
+
+      d += 128;
+      s += 128;
+      len -= 128;
+      copied += 128;
+   }
+
+   return copied;
+}
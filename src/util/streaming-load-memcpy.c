@@ -66,6 +66,18 @@ util_streaming_load_memcpy(void *restrict dst, void *restrict src, size_t len)
    if (len >= 64)
       _mm_mfence();
 
+#ifdef HAVE_STREAMING_LOAD_AVX2
+   /* 32-byte loads need dst and src to be co-aligned to 32 bytes. */
+   if (len >= 128 && !(((uintptr_t)d ^ (uintptr_t)s) & 31) &&
+       util_get_cpu_caps()->has_avx2) {
+      size_t copied = util_streaming_load_memcpy_avx2(d, s, len);
+
+      d += copied;
+      s += copied;
+      len -= copied;
+   }
+#endif
+
    while (len >= 64) {
       __m128i *dst_cacheline = (__m128i *)d;
       __m128i *src_cacheline = (__m128i *)s;
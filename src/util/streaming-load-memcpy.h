@@ -38,4 +38,9 @@
 void
 util_streaming_load_memcpy(void *restrict dst, void *restrict src, size_t len);
 
+/* Used by util_streaming_load_memcpy() on CPUs with AVX2. */
+size_t
+util_streaming_load_memcpy_avx2(void *restrict dst, void *restrict src,
+                                size_t len);
+
 #endif /* STREAMING_LOAD_MEMCPY_H */
@@ -0,0 +1,331 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "bitscan.h"
+#include "ralloc.h"
+#include "swiss_table.h"
+
+#define GROUP_SIZE 16
+#define MIN_SIZE GROUP_SIZE
+
+/* Control bytes of full slots hold the low 7 bits of the hash, free slots
+ * have the top bit set.
+ */
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xfe
+
+static inline uint8_t
+hash_ctrl(uint32_t hash)
+{
+   return hash & 0x7f;
+}
+
+static inline bool
+ctrl_is_full(uint8_t ctrl)
+{
+   return !(ctrl & 0x80);
+}
+
+/* Returns a mask of the slots in the group whose control byte is value. */
+static inline uint32_t
+group_match(const uint8_t *ctrl, uint8_t value)
+{
+#if defined(__SSE2__)
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+   static const uint8_t bits[GROUP_SIZE] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+   };
+   uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(value));
+   uint8x16_t masked = vandq_u8(eq, vld1q_u8(bits));
+   return vaddv_u8(vget_low_u8(masked)) |
+          ((uint32_t)vaddv_u8(vget_high_u8(masked)) << 8);
+#else
+   uint32_t mask = 0;
+   for (unsigned i = 0; i < GROUP_SIZE; i++)
+      mask |= (uint32_t)(ctrl[i] == value) << i;
+   return mask;
+#endif
+}
+
+/* Returns a mask of the empty and deleted slots in the group. */
+static inline uint32_t
+group_match_free(const uint8_t *ctrl)
+{
+#if defined(__SSE2__)
+   return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+   return group_match(ctrl, CTRL_EMPTY) | group_match(ctrl, CTRL_DELETED);
+#endif
+}
+
+/* Groups are probed triangularly, which visits every group of a power of two
+ * sized table.  The table is never more than 7/8 full, so every probe
+ * sequence ends at a group with an empty slot.
+ */
+#define swiss_table_foreach_group(ht, hash, group)                           \
+   for (uint32_t _mask = (ht)->size / GROUP_SIZE - 1,                        \
+                 group = ((hash) >> 7) & _mask, _step = 1;;                  \
+        group = (group + _step++) & _mask)
+
+static void
+init_slots(struct swiss_table *ht, uint32_t size)
+{
+   ht->size = size;
+   ht->entries = 0;
+   ht->deleted_entries = 0;
+   ht->ctrl = ralloc_array(ht, uint8_t, size);
+   ht->table = rzalloc_array(ht, struct hash_entry, size);
+   if (ht->ctrl)
+      memset(ht->ctrl, CTRL_EMPTY, size);
+}
+
+struct swiss_table *
+_mesa_swiss_table_create(void *mem_ctx,
+                         uint32_t (*key_hash_function)(const void *key),
+                         bool (*key_equals_function)(const void *a,
+                                                     const void *b))
+{
+   struct swiss_table *ht = ralloc(mem_ctx, struct swiss_table);
+   if (!ht)
+      return NULL;
+
+   ht->key_hash_function = key_hash_function;
+   ht->key_equals_function = key_equals_function;
+   init_slots(ht, MIN_SIZE);
+
+   if (!ht->ctrl || !ht->table) {
+      ralloc_free(ht);
+      return NULL;
+   }
+
+   return ht;
+}
+
+/**
+ * Frees the given hash table.
+ *
+ * If delete_function is passed, it gets called on each entry present before
+ * freeing.
+ */
+void
+_mesa_swiss_table_destroy(struct swiss_table *ht,
+                          void (*delete_function)(struct hash_entry *entry))
+{
+   if (!ht)
+      return;
+
+   if (delete_function) {
+      swiss_table_foreach(ht, entry)
+         delete_function(entry);
+   }
+
+   ralloc_free(ht);
+}
+
+/**
+ * Deletes all entries of the given hash table without deleting the table
+ * itself or changing its structure.
+ *
+ * If delete_function is passed, it gets called on each entry present.
+ */
+void
+_mesa_swiss_table_clear(struct swiss_table *ht,
+                        void (*delete_function)(struct hash_entry *entry))
+{
+   if (delete_function) {
+      swiss_table_foreach(ht, entry)
+         delete_function(entry);
+   }
+
+   memset(ht->ctrl, CTRL_EMPTY, ht->size);
+   ht->entries = 0;
+   ht->deleted_entries = 0;
+}
+
+struct hash_entry *
+_mesa_swiss_table_search_pre_hashed(const struct swiss_table *ht,
+                                    uint32_t hash, const void *key)
+{
+   assert(!ht->key_hash_function || hash == ht->key_hash_function(key));
+
+   swiss_table_foreach_group(ht, hash, group) {
+      const uint8_t *ctrl = &ht->ctrl[group * GROUP_SIZE];
+      unsigned match = group_match(ctrl, hash_ctrl(hash));
+
+      while (match) {
+         struct hash_entry *entry =
+            &ht->table[group * GROUP_SIZE + u_bit_scan(&match)];
+
+         if (entry->hash == hash && ht->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      if (group_match(ctrl, CTRL_EMPTY))
+         return NULL;
+   }
+}
+
+struct hash_entry *
+_mesa_swiss_table_search(const struct swiss_table *ht, const void *key)
+{
+   assert(ht->key_hash_function);
+   return _mesa_swiss_table_search_pre_hashed(ht, ht->key_hash_function(key),
+                                              key);
+}
+
+static uint32_t
+find_free_slot(const struct swiss_table *ht, uint32_t hash)
+{
+   swiss_table_foreach_group(ht, hash, group) {
+      unsigned mask = group_match_free(&ht->ctrl[group * GROUP_SIZE]);
+
+      if (mask)
+         return group * GROUP_SIZE + u_bit_scan(&mask);
+   }
+}
+
+static bool
+rehash(struct swiss_table *ht, uint32_t new_size)
+{
+   struct swiss_table old = *ht;
+
+   init_slots(ht, new_size);
+   if (!ht->ctrl || !ht->table) {
+      ralloc_free(ht->ctrl);
+      ralloc_free(ht->table);
+      *ht = old;
+      return false;
+   }
+
+   for (uint32_t i = 0; i < old.size; i++) {
+      if (ctrl_is_full(old.ctrl[i])) {
+         uint32_t slot = find_free_slot(ht, old.table[i].hash);
+
+         ht->ctrl[slot] = old.ctrl[i];
+         ht->table[slot] = old.table[i];
+      }
+   }
+
+   ht->entries = old.entries;
+
+   ralloc_free(old.ctrl);
+   ralloc_free(old.table);
+   return true;
+}
+
+struct hash_entry *
+_mesa_swiss_table_insert_pre_hashed(struct swiss_table *ht, uint32_t hash,
+                                    const void *key, void *data)
+{
+   struct hash_entry *entry = _mesa_swiss_table_search_pre_hashed(ht, hash, key);
+
+   /* Note: If a matching entry already exists, this replaces its key and
+    * data, like _mesa_hash_table_insert does.
+    */
+   if (entry) {
+      entry->key = key;
+      entry->data = data;
+      return entry;
+   }
+
+   if ((ht->entries + ht->deleted_entries + 1) * 8 > ht->size * 7) {
+      /* Grow if live entries fill more than half of the table, otherwise
+       * deleted entries take up the space and rehashing in place drops them.
+       */
+      uint32_t new_size = (ht->entries + 1) * 2 > ht->size ? ht->size * 2
+                                                           : ht->size;
+      if (!rehash(ht, new_size))
+         return NULL;
+   }
+
+   uint32_t slot = find_free_slot(ht, hash);
+
+   if (ht->ctrl[slot] == CTRL_DELETED)
+      ht->deleted_entries--;
+
+   ht->ctrl[slot] = hash_ctrl(hash);
+   entry = &ht->table[slot];
+   entry->hash = hash;
+   entry->key = key;
+   entry->data = data;
+   ht->entries++;
+
+   return entry;
+}
+
+struct hash_entry *
+_mesa_swiss_table_insert(struct swiss_table *ht, const void *key, void *data)
+{
+   assert(ht->key_hash_function);
+   return _mesa_swiss_table_insert_pre_hashed(ht, ht->key_hash_function(key),
+                                              key, data);
+}
+
+/**
+ * This function deletes the given hash table entry.
+ *
+ * Note that deletion doesn't otherwise modify the table, so an iteration over
+ * the table deleting entries is safe.
+ */
+void
+_mesa_swiss_table_remove(struct swiss_table *ht, struct hash_entry *entry)
+{
+   if (!entry)
+      return;
+
+   uint32_t slot = entry - ht->table;
+   const uint8_t *group = &ht->ctrl[slot & ~(GROUP_SIZE - 1)];
+
+   /* If the group still has an empty slot, no probe sequence continues past
+    * it, so the slot can become empty again instead of a tombstone.
+    */
+   if (group_match(group, CTRL_EMPTY)) {
+      ht->ctrl[slot] = CTRL_EMPTY;
+   } else {
+      ht->ctrl[slot] = CTRL_DELETED;
+      ht->deleted_entries++;
+   }
+
+   ht->entries--;
+}
+
+/**
+ * Removes the entry with the corresponding key, if exists.
+ */
+void
+_mesa_swiss_table_remove_key(struct swiss_table *ht, const void *key)
+{
+   _mesa_swiss_table_remove(ht, _mesa_swiss_table_search(ht, key));
+}
+
+/**
+ * This function is an iterator over the hash table.
+ *
+ * Pass in NULL for the first entry, as in the start of a for loop.
+ */
+struct hash_entry *
+_mesa_swiss_table_next_entry(const struct swiss_table *ht,
+                             struct hash_entry *entry)
+{
+   uint32_t slot = entry ? entry - ht->table + 1 : 0;
+
+   for (; slot < ht->size; slot++) {
+      if (ctrl_is_full(ht->ctrl[slot]))
+         return &ht->table[slot];
+   }
+
+   return NULL;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * @file
+ * Open addressing hash table that probes groups of 16 slots at a time.
+ *
+ * Every slot has a control byte holding 7 bits of its hash, so a lookup
+ * compares the control bytes of a whole group with one SSE2 or NEON compare
+ * and only calls key_equals_function for the few slots that match.  The API
+ * mirrors _mesa_hash_table and uses the same struct hash_entry, so users can
+ * switch one call site at a time.  Entry pointers are only valid until the
+ * next insertion.
+ */
+
+#ifndef _SWISS_TABLE_H
+#define _SWISS_TABLE_H
+
+#include "hash_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct swiss_table {
+   uint8_t *ctrl;
+   struct hash_entry *table;
+   uint32_t (*key_hash_function)(const void *key);
+   bool (*key_equals_function)(const void *a, const void *b);
+   uint32_t size;
+   uint32_t entries;
+   uint32_t deleted_entries;
+};
+
+struct swiss_table *
+_mesa_swiss_table_create(void *mem_ctx,
+                         uint32_t (*key_hash_function)(const void *key),
+                         bool (*key_equals_function)(const void *a,
+                                                     const void *b));
+
+void _mesa_swiss_table_destroy(struct swiss_table *ht,
+                               void (*delete_function)(struct hash_entry *entry));
+void _mesa_swiss_table_clear(struct swiss_table *ht,
+                             void (*delete_function)(struct hash_entry *entry));
+
+static inline uint32_t
+_mesa_swiss_table_num_entries(const struct swiss_table *ht)
+{
+   return ht->entries;
+}
+
+struct hash_entry *
+_mesa_swiss_table_insert(struct swiss_table *ht, const void *key, void *data);
+struct hash_entry *
+_mesa_swiss_table_insert_pre_hashed(struct swiss_table *ht, uint32_t hash,
+                                    const void *key, void *data);
+struct hash_entry *
+_mesa_swiss_table_search(const struct swiss_table *ht, const void *key);
+struct hash_entry *
+_mesa_swiss_table_search_pre_hashed(const struct swiss_table *ht,
+                                    uint32_t hash, const void *key);
+void _mesa_swiss_table_remove(struct swiss_table *ht,
+                              struct hash_entry *entry);
+void _mesa_swiss_table_remove_key(struct swiss_table *ht,
+                                  const void *key);
+
+struct hash_entry *_mesa_swiss_table_next_entry(const struct swiss_table *ht,
+                                                struct hash_entry *entry);
+
+/**
+ * This foreach function is safe against deletion (which just replaces
+ * an entry's control byte), but not against insertion (which may rehash
+ * the table, making entry a dangling pointer).
+ */
+#define swiss_table_foreach(ht, entry)                                     \
+   for (struct hash_entry *entry = _mesa_swiss_table_next_entry(ht, NULL); \
+        entry != NULL;                                                     \
+        entry = _mesa_swiss_table_next_entry(ht, entry))
+
+#ifdef __cplusplus
+} /* extern C */
+#endif
+
+#endif /* _SWISS_TABLE_H */
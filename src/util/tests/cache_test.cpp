@@ -114,6 +114,20 @@ does_cache_contain(struct disk_cache *cache, const cache_key key)
    return false;
 }
 
+struct async_get_result {
+   void *item;
+   size_t size;
+};
+
+static void
+async_get_cb(void *data, void *item, size_t size)
+{
+   struct async_get_result *result = (struct async_get_result *) data;
+
+   result->item = item;
+   result->size = size;
+}
+
 static bool
 cache_exists(struct disk_cache *cache)
 {
@@ -306,6 +320,15 @@ test_put_and_get(bool test_cache_size_limit, const char *driver_id)
 
    free(result);
 
+   /* The same item through the worker threads. */
+   struct async_get_result async_result = { NULL, 0 };
+   disk_cache_get_async(cache, blob_key, async_get_cb, &async_result);
+   disk_cache_wait_for_idle(cache);
+   EXPECT_STREQ(blob, (char *) async_result.item) << "disk_cache_get_async of existing item (pointer)";
+   EXPECT_EQ(async_result.size, sizeof(blob)) << "disk_cache_get_async of existing item (size)";
+
+   free(async_result.item);
+
    /* Test put and get of a second item. */
    disk_cache_compute_key(cache, string, sizeof(string), string_key);
    disk_cache_put(cache, string_key, string, sizeof(string), NULL);
@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <float.h>
 
 #include "util/half_float.h"
@@ -865,11 +866,62 @@ test_all(void)
 }
 
 
+/* The CPU specific unpack paths only handle whole groups of pixels
+ * themselves, so compare full rows against the generic code too.
+ */
+static bool
+test_unpack_rows(void)
+{
+   enum pipe_format format;
+   bool success = true;
+
+   for (format = 1; format < PIPE_FORMAT_COUNT; ++format) {
+      const struct util_format_unpack_description *unpack =
+         util_format_unpack_description(format);
+      const struct util_format_unpack_description *generic =
+         util_format_unpack_description_generic(format);
+      const unsigned width = 37;
+      uint8_t packed[37 * 16];
+      float unpacked[37 * 4], expected[37 * 4];
+      uint8_t unpacked_8unorm[37 * 4], expected_8unorm[37 * 4];
+
+      if (!unpack || unpack == generic ||
+          util_format_get_blockwidth(format) != 1 ||
+          util_format_get_blocksize(format) > 16)
+         continue;
+
+      for (unsigned i = 0; i < sizeof(packed); i++)
+         packed[i] = (uint8_t)(i * 37 + 11);
+
+      if (unpack->unpack_rgba && generic->unpack_rgba) {
+         unpack->unpack_rgba(unpacked, packed, width);
+         generic->unpack_rgba(expected, packed, width);
+         if (memcmp(unpacked, expected, sizeof(expected))) {
+            printf("FAILED: %s unpack_rgba rows\n", util_format_name(format));
+            success = false;
+         }
+      }
+
+      if (unpack->unpack_rgba_8unorm && generic->unpack_rgba_8unorm) {
+         unpack->unpack_rgba_8unorm(unpacked_8unorm, packed, width);
+         generic->unpack_rgba_8unorm(expected_8unorm, packed, width);
+         if (memcmp(unpacked_8unorm, expected_8unorm, sizeof(expected_8unorm))) {
+            printf("FAILED: %s unpack_rgba_8unorm rows\n", util_format_name(format));
+            success = false;
+         }
+      }
+   }
+
+   return success;
+}
+
+
 int main(int argc, char **argv)
 {
    bool success;
 
    success = test_all();
+   success = test_unpack_rows() && success;
 
    return success ? 0 : 1;
 }
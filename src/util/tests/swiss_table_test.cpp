@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2025 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include "util/hash_table.h"
+#include "util/swiss_table.h"
+
+static uint32_t
+bad_hash(const void *key)
+{
+   /* Everything collides in the first group. */
+   return (uintptr_t)key & 0x7f;
+}
+
+TEST(swiss_table, basic)
+{
+   struct swiss_table *ht =
+      _mesa_swiss_table_create(NULL, _mesa_hash_pointer,
+                               _mesa_key_pointer_equal);
+   const void *a = (const void *)10;
+   const void *b = (const void *)20;
+
+   _mesa_swiss_table_insert(ht, a, (void *)1);
+   _mesa_swiss_table_insert(ht, b, (void *)2);
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), 2);
+
+   /* Inserting an existing key replaces its data. */
+   _mesa_swiss_table_insert(ht, a, (void *)3);
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), 2);
+   EXPECT_EQ(_mesa_swiss_table_search(ht, a)->data, (void *)3);
+
+   _mesa_swiss_table_remove_key(ht, a);
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), 1);
+   EXPECT_EQ(_mesa_swiss_table_search(ht, a), nullptr);
+   EXPECT_EQ(_mesa_swiss_table_search(ht, b)->data, (void *)2);
+
+   _mesa_swiss_table_clear(ht, NULL);
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), 0);
+   EXPECT_EQ(_mesa_swiss_table_search(ht, b), nullptr);
+
+   _mesa_swiss_table_destroy(ht, NULL);
+}
+
+TEST(swiss_table, insert_and_remove_many)
+{
+   struct swiss_table *ht =
+      _mesa_swiss_table_create(NULL, _mesa_hash_pointer,
+                               _mesa_key_pointer_equal);
+   const uintptr_t num = 10000;
+
+   for (uintptr_t i = 1; i <= num; i++)
+      _mesa_swiss_table_insert(ht, (void *)i, (void *)(i * 2));
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), num);
+
+   for (uintptr_t i = 1; i <= num; i++)
+      ASSERT_EQ(_mesa_swiss_table_search(ht, (void *)i)->data, (void *)(i * 2));
+
+   /* Remove every other entry and make sure the rest survives rehashing. */
+   for (uintptr_t i = 1; i <= num; i += 2)
+      _mesa_swiss_table_remove_key(ht, (void *)i);
+   for (uintptr_t i = num + 1; i <= num * 2; i++)
+      _mesa_swiss_table_insert(ht, (void *)i, (void *)(i * 2));
+
+   for (uintptr_t i = 1; i <= num * 2; i++) {
+      struct hash_entry *entry = _mesa_swiss_table_search(ht, (void *)i);
+
+      if (i <= num && (i & 1))
+         ASSERT_EQ(entry, nullptr);
+      else
+         ASSERT_EQ(entry->data, (void *)(i * 2));
+   }
+
+   unsigned count = 0;
+   swiss_table_foreach(ht, entry)
+      count++;
+   EXPECT_EQ(count, _mesa_swiss_table_num_entries(ht));
+
+   _mesa_swiss_table_destroy(ht, NULL);
+}
+
+TEST(swiss_table, collisions)
+{
+   struct swiss_table *ht =
+      _mesa_swiss_table_create(NULL, bad_hash, _mesa_key_pointer_equal);
+
+   /* Keys with the same 7 bit tag all have to be compared fully. */
+   for (uintptr_t i = 1; i <= 1000; i++)
+      _mesa_swiss_table_insert(ht, (void *)(i << 7), (void *)i);
+
+   for (uintptr_t i = 1; i <= 1000; i++) {
+      _mesa_swiss_table_remove_key(ht, (void *)(i << 7));
+      for (uintptr_t j = i + 1; j <= i + 10 && j <= 1000; j++)
+         ASSERT_EQ(_mesa_swiss_table_search(ht, (void *)(j << 7))->data,
+                   (void *)j);
+   }
+   EXPECT_EQ(_mesa_swiss_table_num_entries(ht), 0);
+
+   _mesa_swiss_table_destroy(ht, NULL);
+}
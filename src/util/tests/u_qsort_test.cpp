@@ -23,6 +23,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "util/u_qsort.h"
 
 constexpr int CONTEXT_CHECK = 12345;
@@ -51,3 +54,31 @@ TEST(u_qsort_test, qsort_test)
       EXPECT_EQ(data[i], i + 1);
    }
 }
+
+TEST(u_qsort_test, radix_sort_test)
+{
+   const size_t num = 10000;
+   std::vector<util_radix_sort_item> items(num), tmp(num);
+   uint64_t seed = 0x123456789abcdefull;
+
+   for (size_t i = 0; i < num; ++i) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      /* Lots of duplicates and a common upper half, like timestamps. */
+      items[i].key = (0xabcdull << 32) | (seed >> 52);
+      items[i].data = reinterpret_cast<void *>(i);
+   }
+
+   std::vector<util_radix_sort_item> expected = items;
+   std::stable_sort(expected.begin(), expected.end(),
+                    [](const util_radix_sort_item &a,
+                       const util_radix_sort_item &b) {
+                       return a.key < b.key;
+                    });
+
+   util_radix_sort_u64(items.data(), tmp.data(), num);
+
+   for (size_t i = 0; i < num; ++i) {
+      EXPECT_EQ(items[i].key, expected[i].key);
+      EXPECT_EQ(items[i].data, expected[i].data);
+   }
+}
@@ -444,6 +444,27 @@ static void
 check_os_arm_support(void)
 {
     util_cpu_caps.has_neon = true;
+
+#if defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+    util_cpu_caps.has_neon_fp16 = true;
+#elif DETECT_OS_LINUX
+    Elf64_auxv_t aux;
+    int fd;
+
+    fd = open("/proc/self/auxv", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+       while (read(fd, &aux, sizeof(Elf64_auxv_t)) == sizeof(Elf64_auxv_t)) {
+          if (aux.a_type == AT_HWCAP) {
+             uint64_t hwcap = aux.a_un.a_val;
+
+             /* HWCAP_ASIMDHP */
+             util_cpu_caps.has_neon_fp16 = (hwcap >> 10) & 1;
+             break;
+          }
+       }
+       close (fd);
+    }
+#endif /* DETECT_OS_LINUX */
 }
 #endif /* DETECT_ARCH_ARM || DETECT_ARCH_AARCH64 */
 
@@ -725,6 +746,7 @@ void check_cpu_caps_override(void)
       util_cpu_caps.has_avx512bw   = 0;
       util_cpu_caps.has_avx512vl   = 0;
       util_cpu_caps.has_avx512vbmi = 0;
+      util_cpu_caps.has_avx512fp16 = 0;
    }
 #endif /* DETECT_ARCH_X86 || DETECT_ARCH_X86_64 */
 }
@@ -920,6 +942,7 @@ _util_cpu_detect_once(void)
                util_cpu_caps.has_avx512bw   = (regs7[1] >> 30) & 1;
                util_cpu_caps.has_avx512vl   = (regs7[1] >> 31) & 1;
                util_cpu_caps.has_avx512vbmi = (regs7[2] >>  1) & 1;
+               util_cpu_caps.has_avx512fp16 = (regs7[3] >> 23) & 1;
             }
          }
       }
@@ -983,6 +1006,7 @@ _util_cpu_detect_once(void)
       printf("util_cpu_caps.has_altivec = %u\n", util_cpu_caps.has_altivec);
       printf("util_cpu_caps.has_vsx = %u\n", util_cpu_caps.has_vsx);
       printf("util_cpu_caps.has_neon = %u\n", util_cpu_caps.has_neon);
+      printf("util_cpu_caps.has_neon_fp16 = %u\n", util_cpu_caps.has_neon_fp16);
       printf("util_cpu_caps.has_msa = %u\n", util_cpu_caps.has_msa);
       printf("util_cpu_caps.has_daz = %u\n", util_cpu_caps.has_daz);
       printf("util_cpu_caps.has_lsx = %u\n", util_cpu_caps.has_lsx);
@@ -996,6 +1020,7 @@ _util_cpu_detect_once(void)
       printf("util_cpu_caps.has_avx512bw = %u\n", util_cpu_caps.has_avx512bw);
       printf("util_cpu_caps.has_avx512vl = %u\n", util_cpu_caps.has_avx512vl);
       printf("util_cpu_caps.has_avx512vbmi = %u\n", util_cpu_caps.has_avx512vbmi);
+      printf("util_cpu_caps.has_avx512fp16 = %u\n", util_cpu_caps.has_avx512fp16);
       printf("util_cpu_caps.has_clflushopt = %u\n", util_cpu_caps.has_clflushopt);
       printf("util_cpu_caps.num_L3_caches = %u\n", util_cpu_caps.num_L3_caches);
       printf("util_cpu_caps.num_cpu_mask_bits = %u\n", util_cpu_caps.num_cpu_mask_bits);
@@ -102,6 +102,7 @@ struct util_cpu_caps_t {
    unsigned has_vsx:1;
    unsigned has_daz:1;
    unsigned has_neon:1;
+   unsigned has_neon_fp16:1;
    unsigned has_msa:1;
    unsigned has_lsx:1;
    unsigned has_lasx:1;
@@ -115,6 +116,7 @@ struct util_cpu_caps_t {
    unsigned has_avx512bw:1;
    unsigned has_avx512vl:1;
    unsigned has_avx512vbmi:1;
+   unsigned has_avx512fp16:1;
 
    unsigned has_clflushopt:1;
 
@@ -22,7 +22,9 @@
  */
 
 #include "u_qsort.h"
+#include <string.h>
 #include <thread>
+#include <utility>
 
 thread_local int (*tl_qsort_r_compar)(const void *, const void *, void *);
 thread_local void *tl_qsort_r_arg;
@@ -50,3 +52,39 @@ util_qsort_adapter(void *ctx, const void *elem1, const void *elem2)
       reinterpret_cast<util_qsort_adapter_data*>(ctx);
    return data->compar(elem1, elem2, data->args);
 }
+
+void
+util_radix_sort_u64(struct util_radix_sort_item *items,
+                    struct util_radix_sort_item *tmp, size_t nmemb)
+{
+   struct util_radix_sort_item *src = items, *dst = tmp;
+
+   if (nmemb < 2)
+      return;
+
+   for (unsigned shift = 0; shift < 64; shift += 8) {
+      size_t count[256] = {0};
+
+      for (size_t i = 0; i < nmemb; i++)
+         count[(src[i].key >> shift) & 0xff]++;
+
+      /* Skip bytes that are the same in all keys. */
+      if (count[(src[0].key >> shift) & 0xff] == nmemb)
+         continue;
+
+      size_t offset = 0;
+      for (unsigned i = 0; i < 256; i++) {
+         size_t c = count[i];
+         count[i] = offset;
+         offset += c;
+      }
+
+      for (size_t i = 0; i < nmemb; i++)
+         dst[count[(src[i].key >> shift) & 0xff]++] = src[i];
+
+      std::swap(src, dst);
+   }
+
+   if (src != items)
+      memcpy(items, src, nmemb * sizeof(*items));
+}
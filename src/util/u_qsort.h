@@ -24,6 +24,7 @@
 #ifndef U_QSORT_H
 #define U_QSORT_H
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "detect_os.h"
@@ -37,6 +38,19 @@ void util_tls_qsort_r(void *base, size_t nmemb, size_t size,
                       void *arg);
 
 
+struct util_radix_sort_item {
+   uint64_t key;
+   void *data;
+};
+
+/**
+ * Stable sort of items by key, in ascending order.  tmp must have room for
+ * nmemb items.  Much faster than util_qsort_r() for large arrays, especially
+ * when keys share their upper bytes like timestamps do.
+ */
+void util_radix_sort_u64(struct util_radix_sort_item *items,
+                         struct util_radix_sort_item *tmp, size_t nmemb);
+
 struct util_qsort_adapter_data {
    int (*compar)(const void*, const void*, void*);
    void *args;
@@ -546,7 +546,7 @@ util_queue_add_job_locked(struct util_queue *queue,
                           util_queue_execute_func execute,
                           util_queue_execute_func cleanup,
                           const size_t job_size,
-                          bool locked)
+                          bool locked, bool urgent)
 {
    struct util_queue_job *ptr;
 
@@ -609,7 +609,16 @@ util_queue_add_job_locked(struct util_queue *queue,
       }
    }
 
-   ptr = &queue->jobs[queue->write_idx];
+   if (urgent) {
+      /* Put it in front of all queued jobs so that it's picked up next. */
+      queue->read_idx = (queue->read_idx + queue->max_jobs - 1) %
+                        queue->max_jobs;
+      ptr = &queue->jobs[queue->read_idx];
+   } else {
+      ptr = &queue->jobs[queue->write_idx];
+      queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
+   }
+
    assert(ptr->job == NULL);
    ptr->job = job;
    ptr->global_data = queue->global_data;
@@ -618,7 +627,6 @@ util_queue_add_job_locked(struct util_queue *queue,
    ptr->cleanup = cleanup;
    ptr->job_size = job_size;
 
-   queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
    queue->total_jobs_size += ptr->job_size;
 
    queue->num_queued++;
@@ -636,7 +644,25 @@ util_queue_add_job(struct util_queue *queue,
                    const size_t job_size)
 {
    util_queue_add_job_locked(queue, job, fence, execute, cleanup, job_size,
-                             false);
+                             false, false);
+}
+
+/**
+ * Like util_queue_add_job, but the job is executed before all jobs that are
+ * already queued and haven't started yet.  For latency critical work like
+ * a shader compile the application is waiting for, queued behind background
+ * compiles.
+ */
+void
+util_queue_add_job_urgent(struct util_queue *queue,
+                          void *job,
+                          struct util_queue_fence *fence,
+                          util_queue_execute_func execute,
+                          util_queue_execute_func cleanup,
+                          const size_t job_size)
+{
+   util_queue_add_job_locked(queue, job, fence, execute, cleanup, job_size,
+                             false, true);
 }
 
 /**
@@ -713,7 +739,8 @@ util_queue_finish(struct util_queue *queue)
    for (unsigned i = 0; i < queue->num_threads; ++i) {
       util_queue_fence_init(&fences[i]);
       util_queue_add_job_locked(queue, &barrier, &fences[i],
-                                util_queue_finish_execute, NULL, 0, true);
+                                util_queue_finish_execute, NULL, 0, true,
+                                false);
    }
    queue->create_threads_on_demand = true;
    mtx_unlock(&queue->lock);
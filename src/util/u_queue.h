@@ -257,6 +257,12 @@ void util_queue_add_job(struct util_queue *queue,
                         util_queue_execute_func execute,
                         util_queue_execute_func cleanup,
                         const size_t job_size);
+void util_queue_add_job_urgent(struct util_queue *queue,
+                               void *job,
+                               struct util_queue_fence *fence,
+                               util_queue_execute_func execute,
+                               util_queue_execute_func cleanup,
+                               const size_t job_size);
 void util_queue_drop_job(struct util_queue *queue,
                          struct util_queue_fence *fence);
 
@@ -28,26 +28,104 @@
 #include "util/u_math.h"
 #include "util/vma.h"
 
+/* Holes are kept in a red-black tree ordered by offset, where every node
+ * also tracks the largest hole in its subtree.  That lets allocation skip
+ * whole subtrees that can't fit the requested size while keeping the same
+ * first-fit order as walking the holes from the top or the bottom.
+ */
 struct util_vma_hole {
-   struct list_head link;
+   struct rb_node node;
    uint64_t offset;
    uint64_t size;
+
+   /** Largest hole size in the subtree rooted at this hole */
+   uint64_t max_size;
 };
 
+static inline struct util_vma_hole *
+util_vma_hole(struct rb_node *node)
+{
+   return node ? rb_node_data(struct util_vma_hole, node, node) : NULL;
+}
+
 #define util_vma_foreach_hole(_hole, _heap) \
-   list_for_each_entry(struct util_vma_hole, _hole, &(_heap)->holes, link)
+   rb_tree_foreach(struct util_vma_hole, _hole, &(_heap)->holes, node)
+
+#define util_vma_foreach_hole_rev(_hole, _heap) \
+   rb_tree_foreach_rev(struct util_vma_hole, _hole, &(_heap)->holes, node)
+
+static void
+util_vma_hole_update(struct rb_node *node)
+{
+   struct util_vma_hole *hole = util_vma_hole(node);
+
+   hole->max_size = hole->size;
+   if (node->left)
+      hole->max_size = MAX2(hole->max_size, util_vma_hole(node->left)->max_size);
+   if (node->right)
+      hole->max_size = MAX2(hole->max_size, util_vma_hole(node->right)->max_size);
+}
+
+/* Called after the size of a hole changed in place. */
+static void
+util_vma_hole_resized(struct util_vma_hole *hole)
+{
+   for (struct rb_node *node = &hole->node; node; node = rb_node_parent(node))
+      util_vma_hole_update(node);
+}
+
+static int
+util_vma_hole_cmp(const struct rb_node *_a, const struct rb_node *_b)
+{
+   const struct util_vma_hole *a = rb_node_data(struct util_vma_hole, _a, node);
+   const struct util_vma_hole *b = rb_node_data(struct util_vma_hole, _b, node);
 
-#define util_vma_foreach_hole_safe(_hole, _heap) \
-   list_for_each_entry_safe(struct util_vma_hole, _hole, &(_heap)->holes, link)
+   if (a->offset == b->offset)
+      return 0;
 
-#define util_vma_foreach_hole_safe_rev(_hole, _heap) \
-   list_for_each_entry_safe_rev(struct util_vma_hole, _hole, &(_heap)->holes, link)
+   return b->offset > a->offset ? 1 : -1;
+}
+
+static void
+util_vma_hole_insert(struct util_vma_heap *heap, struct util_vma_hole *hole)
+{
+   rb_augmented_tree_insert(&heap->holes, &hole->node, util_vma_hole_cmp,
+                            util_vma_hole_update);
+}
+
+static void
+util_vma_hole_remove(struct util_vma_heap *heap, struct util_vma_hole *hole)
+{
+   rb_augmented_tree_remove(&heap->holes, &hole->node, util_vma_hole_update);
+   free(hole);
+}
+
+/* Returns the highest hole starting at or below offset. */
+static struct util_vma_hole *
+util_vma_hole_find_below(struct util_vma_heap *heap, uint64_t offset)
+{
+   struct util_vma_hole *found = NULL;
+   struct rb_node *node = heap->holes.root;
+
+   while (node) {
+      struct util_vma_hole *hole = util_vma_hole(node);
+
+      if (hole->offset <= offset) {
+         found = hole;
+         node = node->right;
+      } else {
+         node = node->left;
+      }
+   }
+
+   return found;
+}
 
 void
 util_vma_heap_init(struct util_vma_heap *heap,
                    uint64_t start, uint64_t size)
 {
-   list_inithead(&heap->holes);
+   rb_tree_init(&heap->holes);
    heap->free_size = 0;
    if (size > 0)
       util_vma_heap_free(heap, start, size);
@@ -59,11 +137,22 @@ util_vma_heap_init(struct util_vma_heap *heap,
    heap->nospan_shift = 0;
 }
 
+static void
+util_vma_free_holes(struct rb_node *node)
+{
+   /* Post-order, since iterating in order needs the parents to stay alive */
+   if (!node)
+      return;
+
+   util_vma_free_holes(node->left);
+   util_vma_free_holes(node->right);
+   free(util_vma_hole(node));
+}
+
 void
 util_vma_heap_finish(struct util_vma_heap *heap)
 {
-   util_vma_foreach_hole_safe(hole, heap)
-      free(hole);
+   util_vma_free_holes(heap->holes.root);
 }
 
 #ifndef NDEBUG
@@ -71,29 +160,35 @@ static void
 util_vma_heap_validate(struct util_vma_heap *heap)
 {
    uint64_t free_size = 0;
-   uint64_t prev_offset = 0;
+   struct util_vma_hole *prev = NULL;
    util_vma_foreach_hole(hole, heap) {
       assert(hole->offset > 0);
       assert(hole->size > 0);
 
       free_size += hole->size;
 
-      if (&hole->link == heap->holes.next) {
-         /* This must be the top-most hole.  Assert that, if it overflows, it
-          * overflows to 0, i.e. 2^64.
-          */
-         assert(hole->size + hole->offset == 0 ||
-                hole->size + hole->offset > hole->offset);
-      } else {
-         /* This is not the top-most hole so it must not overflow and, in
-          * fact, must be strictly lower than the top-most hole.  If
-          * hole->size + hole->offset == prev_offset, then we failed to join
-          * holes during a util_vma_heap_free.
+      uint64_t max_size = hole->size;
+      if (hole->node.left)
+         max_size = MAX2(max_size, util_vma_hole(hole->node.left)->max_size);
+      if (hole->node.right)
+         max_size = MAX2(max_size, util_vma_hole(hole->node.right)->max_size);
+      assert(hole->max_size == max_size);
+
+      if (prev) {
+         /* The lower hole must not overflow and must end strictly below
+          * this one.  If prev->size + prev->offset == hole->offset, then we
+          * failed to join holes during a util_vma_heap_free.
           */
-         assert(hole->size + hole->offset > hole->offset &&
-                hole->size + hole->offset < prev_offset);
+         assert(prev->size + prev->offset > prev->offset &&
+                prev->size + prev->offset < hole->offset);
       }
-      prev_offset = hole->offset;
+      prev = hole;
+   }
+
+   /* The top-most hole may only overflow to 0, i.e. 2^64. */
+   if (prev) {
+      assert(prev->size + prev->offset == 0 ||
+             prev->size + prev->offset > prev->offset);
    }
 
    assert(free_size == heap->free_size);
@@ -112,8 +207,7 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
 
    if (offset == hole->offset && size == hole->size) {
       /* Just get rid of the hole. */
-      list_del(&hole->link);
-      free(hole);
+      util_vma_hole_remove(heap, hole);
       goto done;
    }
 
@@ -122,6 +216,7 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
    if (waste == 0) {
       /* We allocated at the top.  Shrink the hole down. */
       hole->size -= size;
+      util_vma_hole_resized(hole);
       goto done;
    }
 
@@ -129,6 +224,7 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
       /* We allocated at the bottom. Shrink the hole up. */
       hole->offset += size;
       hole->size -= size;
+      util_vma_hole_resized(hole);
       goto done;
    }
 
@@ -143,16 +239,117 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
     * original hole.
     */
    hole->size = offset - hole->offset;
+   util_vma_hole_resized(hole);
 
-   /* Place the new hole before the old hole so that the list is in order
-    * from high to low.
-    */
-   list_addtail(&high_hole->link, &hole->link);
+   util_vma_hole_insert(heap, high_hole);
 
  done:
    heap->free_size -= size;
 }
 
+/* Returns whether an allocation fits at the top of the hole, and where. */
+static bool
+util_vma_hole_fit_high(const struct util_vma_heap *heap,
+                       const struct util_vma_hole *hole,
+                       uint64_t size, uint64_t alignment, uint64_t *offset_out)
+{
+   if (size > hole->size)
+      return false;
+
+   /* Compute the offset as the highest address where a chunk of the
+    * given size can be without going over the top of the hole.
+    *
+    * This calculation is known to not overflow because we know that
+    * hole->size + hole->offset can only overflow to 0 and size > 0.
+    */
+   uint64_t offset = (hole->size - size) + hole->offset;
+
+   if (heap->nospan_shift) {
+      uint64_t end = offset + size - 1;
+      if ((end >> heap->nospan_shift) != (offset >> heap->nospan_shift)) {
+         /* can we shift the offset down and still fit in the current hole? */
+         end &= ~BITFIELD64_MASK(heap->nospan_shift);
+         assert(end >= size);
+         offset -= size;
+         if (offset < hole->offset)
+            return false;
+      }
+   }
+
+   /* Align the offset.  We align down and not up because we are
+    * allocating from the top of the hole and not the bottom.
+    */
+   offset = (offset / alignment) * alignment;
+
+   if (offset < hole->offset)
+      return false;
+
+   *offset_out = offset;
+   return true;
+}
+
+/* Returns whether an allocation fits at the bottom of the hole, and where. */
+static bool
+util_vma_hole_fit_low(const struct util_vma_heap *heap,
+                      const struct util_vma_hole *hole,
+                      uint64_t size, uint64_t alignment, uint64_t *offset_out)
+{
+   if (size > hole->size)
+      return false;
+
+   uint64_t offset = hole->offset;
+
+   /* Align the offset */
+   uint64_t misalign = offset % alignment;
+   if (misalign) {
+      uint64_t pad = alignment - misalign;
+      if (pad > hole->size - size)
+         return false;
+
+      offset += pad;
+   }
+
+   if (heap->nospan_shift) {
+      uint64_t end = offset + size - 1;
+      if ((end >> heap->nospan_shift) != (offset >> heap->nospan_shift)) {
+         /* can we shift the offset up and still fit in the current hole? */
+         offset = end & ~BITFIELD64_MASK(heap->nospan_shift);
+         if ((offset + size) > (hole->offset + hole->size))
+            return false;
+      }
+   }
+
+   *offset_out = offset;
+   return true;
+}
+
+/* Finds the highest (or lowest) hole the allocation fits in, skipping
+ * subtrees whose holes are all too small.
+ */
+static struct util_vma_hole *
+util_vma_find_hole(const struct util_vma_heap *heap, struct rb_node *node,
+                   uint64_t size, uint64_t alignment, uint64_t *offset_out)
+{
+   if (!node || util_vma_hole(node)->max_size < size)
+      return NULL;
+
+   struct rb_node *first = heap->alloc_high ? node->right : node->left;
+   struct rb_node *last = heap->alloc_high ? node->left : node->right;
+   struct util_vma_hole *hole;
+
+   hole = util_vma_find_hole(heap, first, size, alignment, offset_out);
+   if (hole)
+      return hole;
+
+   hole = util_vma_hole(node);
+   if (heap->alloc_high ?
+       util_vma_hole_fit_high(heap, hole, size, alignment, offset_out) :
+       util_vma_hole_fit_low(heap, hole, size, alignment, offset_out))
+      return hole;
+
+   return util_vma_find_hole(heap, last, size, alignment, offset_out);
+}
+
 uint64_t
 util_vma_heap_alloc(struct util_vma_heap *heap,
                     uint64_t size, uint64_t alignment)
@@ -171,74 +368,14 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
             BITFIELD64_BIT(heap->nospan_shift));
    }
 
-   if (heap->alloc_high) {
-      util_vma_foreach_hole_safe(hole, heap) {
-         if (size > hole->size)
-            continue;
-
-         /* Compute the offset as the highest address where a chunk of the
-          * given size can be without going over the top of the hole.
-          *
-          * This calculation is known to not overflow because we know that
-          * hole->size + hole->offset can only overflow to 0 and size > 0.
-          */
-         uint64_t offset = (hole->size - size) + hole->offset;
-
-         if (heap->nospan_shift) {
-            uint64_t end = offset + size - 1;
-            if ((end >> heap->nospan_shift) != (offset >> heap->nospan_shift)) {
-               /* can we shift the offset down and still fit in the current hole? */
-               end &= ~BITFIELD64_MASK(heap->nospan_shift);
-               assert(end >= size);
-               offset -= size;
-               if (offset < hole->offset)
-                  continue;
-            }
-         }
-
-         /* Align the offset.  We align down and not up because we are
-          * allocating from the top of the hole and not the bottom.
-          */
-         offset = (offset / alignment) * alignment;
-
-         if (offset < hole->offset)
-            continue;
+   uint64_t offset;
+   struct util_vma_hole *hole =
+      util_vma_find_hole(heap, heap->holes.root, size, alignment, &offset);
 
-         util_vma_hole_alloc(heap, hole, offset, size);
-         util_vma_heap_validate(heap);
-         return offset;
-      }
-   } else {
-      util_vma_foreach_hole_safe_rev(hole, heap) {
-         if (size > hole->size)
-            continue;
-
-         uint64_t offset = hole->offset;
-
-         /* Align the offset */
-         uint64_t misalign = offset % alignment;
-         if (misalign) {
-            uint64_t pad = alignment - misalign;
-            if (pad > hole->size - size)
-               continue;
-
-            offset += pad;
-         }
-
-         if (heap->nospan_shift) {
-            uint64_t end = offset + size - 1;
-            if ((end >> heap->nospan_shift) != (offset >> heap->nospan_shift)) {
-               /* can we shift the offset up and still fit in the current hole? */
-               offset = end & ~BITFIELD64_MASK(heap->nospan_shift);
-               if ((offset + size) > (hole->offset + hole->size))
-                  continue;
-            }
-         }
-
-         util_vma_hole_alloc(heap, hole, offset, size);
-         util_vma_heap_validate(heap);
-         return offset;
-      }
+   if (hole) {
+      util_vma_hole_alloc(heap, hole, offset, size);
+      util_vma_heap_validate(heap);
+      return offset;
    }
 
    /* Failed to allocate */
@@ -262,25 +399,15 @@ util_vma_heap_alloc_addr(struct util_vma_heap *heap,
     */
    assert(offset + size == 0 || offset + size > offset);
 
-   /* Find the hole if one exists. */
-   util_vma_foreach_hole_safe(hole, heap) {
-      if (hole->offset > offset)
-         continue;
-
-      /* Holes are ordered high-to-low so the first hole we find with
-       * hole->offset <= is our hole.  If it's not big enough to contain the
-       * requested range, then the allocation fails.
-       */
-      assert(hole->offset <= offset);
-      if (hole->size < offset - hole->offset + size)
-         return false;
-
-      util_vma_hole_alloc(heap, hole, offset, size);
-      return true;
-   }
+   /* The highest hole starting at or below offset is our hole.  If it's not
+    * big enough to contain the requested range, then the allocation fails.
+    */
+   struct util_vma_hole *hole = util_vma_hole_find_below(heap, offset);
+   if (!hole || hole->size < offset - hole->offset + size)
+      return false;
 
-   /* We didn't find a suitable hole */
-   return false;
+   util_vma_hole_alloc(heap, hole, offset, size);
+   return true;
 }
 
 void
@@ -303,14 +430,10 @@ util_vma_heap_free(struct util_vma_heap *heap,
    util_vma_heap_validate(heap);
 
    /* Find immediately higher and lower holes if they exist. */
-   struct util_vma_hole *high_hole = NULL, *low_hole = NULL;
-   util_vma_foreach_hole(hole, heap) {
-      if (hole->offset <= offset) {
-         low_hole = hole;
-         break;
-      }
-      high_hole = hole;
-   }
+   struct util_vma_hole *low_hole = util_vma_hole_find_below(heap, offset);
+   struct util_vma_hole *high_hole =
+      util_vma_hole(low_hole ? rb_node_next(&low_hole->node)
+                             : rb_tree_first(&heap->holes));
 
    if (high_hole)
       assert(offset + size <= high_hole->offset);
@@ -325,15 +448,17 @@ util_vma_heap_free(struct util_vma_heap *heap,
    if (low_adjacent && high_adjacent) {
       /* Merge the two holes */
       low_hole->size += size + high_hole->size;
-      list_del(&high_hole->link);
-      free(high_hole);
+      util_vma_hole_remove(heap, high_hole);
+      util_vma_hole_resized(low_hole);
    } else if (low_adjacent) {
       /* Merge into the low hole */
       low_hole->size += size;
+      util_vma_hole_resized(low_hole);
    } else if (high_adjacent) {
       /* Merge into the high hole */
       high_hole->offset = offset;
       high_hole->size += size;
+      util_vma_hole_resized(high_hole);
    } else {
       /* Neither hole is adjacent; make a new one */
       struct util_vma_hole *hole = calloc(1, sizeof(*hole));
@@ -341,11 +466,7 @@ util_vma_heap_free(struct util_vma_heap *heap,
       hole->offset = offset;
       hole->size = size;
 
-      /* Add it after the high hole so we maintain high-to-low ordering */
-      if (high_hole)
-         list_add(&hole->link, &high_hole->link);
-      else
-         list_add(&hole->link, &heap->holes);
+      util_vma_hole_insert(heap, hole);
    }
 
    heap->free_size += size;
@@ -355,12 +476,9 @@ util_vma_heap_free(struct util_vma_heap *heap,
 uint64_t
 util_vma_heap_get_max_free_continuous_size(struct util_vma_heap *heap)
 {
-   uint64_t max_size = 0;
-   util_vma_foreach_hole_safe(hole, heap) {
-      max_size = MAX2(max_size, hole->size);
-   }
+   struct util_vma_hole *root = util_vma_hole(heap->holes.root);
 
-   return max_size;
+   return root ? root->max_size : 0;
 }
 
 void
@@ -370,7 +488,7 @@ util_vma_heap_print(struct util_vma_heap *heap, FILE *fp,
    fprintf(fp, "%sutil_vma_heap:\n", tab);
 
    uint64_t total_free = 0;
-   util_vma_foreach_hole(hole, heap) {
+   util_vma_foreach_hole_rev(hole, heap) {
       fprintf(fp, "%s    hole: offset = %"PRIu64" (0x%"PRIx64"), "
               "size = %"PRIu64" (0x%"PRIx64")\n",
               tab, hole->offset, hole->offset, hole->size, hole->size);
@@ -28,13 +28,14 @@
 #include <stdio.h>
 
 #include "list.h"
+#include "rb_tree.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct util_vma_heap {
-   struct list_head holes;
+   struct rb_tree holes;
 
    /** Total size of free memory. */
    uint64_t free_size;
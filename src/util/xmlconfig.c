@@ -830,6 +830,107 @@ parseOptConfAttr(struct OptConfData *data, const char **attr)
    }
 }
 
+#include "driconf_static.h"
+
+static void
+parseStaticOptions(struct OptConfData *data, const struct driconf_option *options,
+                   unsigned num_options)
+{
+   if (data->ignoringDevice || data->ignoringApp)
+      return;
+   for (unsigned i = 0; i < num_options; i++) {
+      const char *optattr[] = {
+         "name", options[i].name,
+         "value", options[i].value,
+         NULL
+      };
+      parseOptConfAttr(data, optattr);
+   }
+}
+
+static void
+parseStaticEngine(struct OptConfData *data, const struct driconf_engine *e)
+{
+   const char *engattr[] = {
+      "engine_name_match", e->engine_name_match,
+      "engine_versions", e->engine_versions,
+      NULL
+   };
+
+   data->ignoringApp = 0;
+   parseEngineAttr(data, engattr);
+   parseStaticOptions(data, e->options, e->num_options);
+}
+
+static void
+parseStaticApplication(struct OptConfData *data,
+                       const struct driconf_application *a)
+{
+   const char *appattr[] = {
+      "name", a->name,
+      "executable", a->executable,
+      "executable_regexp", a->executable_regexp,
+      "sha1", a->sha1,
+      "application_name_match", a->application_name_match,
+      "application_versions", a->application_versions,
+      NULL
+   };
+
+   data->ignoringApp = 0;
+   parseAppAttr(data, appattr);
+   parseStaticOptions(data, a->options, a->num_options);
+}
+
+/** \brief Apply devices of the configuration built in at compile time */
+static void
+parseStaticDevices(struct OptConfData *data, unsigned first_device,
+                   unsigned num_devices)
+{
+   data->ignoringDevice = 0;
+   data->ignoringApp = 0;
+   data->inDriConf = 0;
+   data->inDevice = 0;
+   data->inApp = 0;
+   data->inOption = 0;
+
+   for (unsigned i = first_device; i < first_device + num_devices; i++) {
+      const struct driconf_device *d = driconf[i];
+      const char *devattr[] = {
+         "driver", d->driver,
+         "device", d->device,
+         NULL
+      };
+
+      data->ignoringDevice = 0;
+      data->inDevice++;
+      parseDeviceAttr(data, devattr);
+      data->inDevice--;
+
+      /* Like the XML parser, don't bother matching applications of devices
+       * we ignore.
+       */
+      if (data->ignoringDevice)
+         continue;
+
+      data->inApp++;
+
+      /* Apply engines and applications in the order the file had them, so
+       * that the last match wins like it does when parsing the XML.
+       */
+      unsigned e = 0, a = 0;
+      while (e < d->num_engines || a < d->num_applications) {
+         if (a == d->num_applications ||
+             (e < d->num_engines &&
+              d->engines[e].order < d->applications[a].order))
+            parseStaticEngine(data, &d->engines[e++]);
+         else
+            parseStaticApplication(data, &d->applications[a++]);
+      }
+
+      data->inApp--;
+   }
+}
+
 #if WITH_XMLCONFIG
 
 /** \brief Elements in configuration files. */
@@ -1004,6 +1105,47 @@ parseOneConfigFile(struct OptConfData *data, const char *filename)
    XML_ParserFree(p);
 }
 
+/**
+ * \brief Apply the pre-parsed copy of a configuration file that was built in
+ * at compile time, if the file is unchanged since then.
+ *
+ * This skips parsing the big default configuration files with expat on every
+ * screen and instance creation.
+ */
+static bool
+parseBuiltinConfigFile(struct OptConfData *data, const char *filename)
+{
+   const char *basename = strrchr(filename, '/');
+   basename = basename ? basename + 1 : filename;
+
+   for (unsigned i = 0; i < ARRAY_SIZE(driconf_files); i++) {
+      const struct driconf_file *file = &driconf_files[i];
+
+      if (strcmp(basename, file->name))
+         continue;
+
+      size_t len;
+      char *content = os_read_file(filename, &len);
+      if (!content)
+         return false;
+
+      uint8_t sha1x[SHA1_DIGEST_LENGTH];
+      char sha1s[SHA1_DIGEST_STRING_LENGTH];
+      _mesa_sha1_compute(content, len, sha1x);
+      _mesa_sha1_format(sha1s, sha1x);
+      free(content);
+
+      if (strcmp(sha1s, file->sha1))
+         return false;
+
+      data->name = filename;
+      parseStaticDevices(data, file->first_device, file->num_devices);
+      return true;
+   }
+
+   return false;
+}
+
 static int
 scandir_filter(const struct dirent *ent)
 {
@@ -1061,87 +1203,17 @@ parseConfigDir(struct OptConfData *data, const char *dirname)
       }
 #endif
 
-      parseOneConfigFile(data, filename);
+      if (!parseBuiltinConfigFile(data, filename))
+         parseOneConfigFile(data, filename);
    }
 
    free(entries);
 }
 #else
-#  include "driconf_static.h"
-
-static void
-parseStaticOptions(struct OptConfData *data, const struct driconf_option *options,
-                   unsigned num_options)
-{
-   if (data->ignoringDevice || data->ignoringApp)
-      return;
-   for (unsigned i = 0; i < num_options; i++) {
-      const char *optattr[] = {
-         "name", options[i].name,
-         "value", options[i].value,
-         NULL
-      };
-      parseOptConfAttr(data, optattr);
-   }
-}
-
 static void
 parseStaticConfig(struct OptConfData *data)
 {
-   data->ignoringDevice = 0;
-   data->ignoringApp = 0;
-   data->inDriConf = 0;
-   data->inDevice = 0;
-   data->inApp = 0;
-   data->inOption = 0;
-
-   for (unsigned i = 0; i < ARRAY_SIZE(driconf); i++) {
-      const struct driconf_device *d = driconf[i];
-      const char *devattr[] = {
-         "driver", d->driver,
-         "device", d->device,
-         NULL
-      };
-
-      data->ignoringDevice = 0;
-      data->inDevice++;
-      parseDeviceAttr(data, devattr);
-      data->inDevice--;
-
-      data->inApp++;
-
-      for (unsigned j = 0; j < d->num_engines; j++) {
-         const struct driconf_engine *e = &d->engines[j];
-         const char *engattr[] = {
-            "engine_name_match", e->engine_name_match,
-            "engine_versions", e->engine_versions,
-            NULL
-         };
-
-         data->ignoringApp = 0;
-         parseEngineAttr(data, engattr);
-         parseStaticOptions(data, e->options, e->num_options);
-      }
-
-      for (unsigned j = 0; j < d->num_applications; j++) {
-         const struct driconf_application *a = &d->applications[j];
-         const char *appattr[] = {
-            "name", a->name,
-            "executable", a->executable,
-            "executable_regexp", a->executable_regexp,
-            "sha1", a->sha1,
-            "application_name_match", a->application_name_match,
-            "application_versions", a->application_versions,
-            NULL
-         };
-
-         data->ignoringApp = 0;
-         parseAppAttr(data, appattr);
-         parseStaticOptions(data, a->options, a->num_options);
-      }
-
-      data->inApp--;
-   }
+   parseStaticDevices(data, 0, ARRAY_SIZE(driconf));
 }
 #endif /* WITH_XMLCONFIG */
 
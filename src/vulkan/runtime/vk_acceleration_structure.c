@@ -554,6 +554,7 @@ build_leaves(VkCommandBuffer commandBuffer,
          .header = pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.header_offset,
          .ids = pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.sort_buffer_offset[0],
       };
+      bool first_geometry = true;
 
       for (unsigned j = 0; j < pInfos[i].geometryCount; ++j) {
          const VkAccelerationStructureGeometryKHR *geom =
@@ -566,8 +567,18 @@ build_leaves(VkCommandBuffer commandBuffer,
 
          leaf_consts.geom_data = vk_fill_geometry_data(pInfos[i].type, bvh_states[i].leaf_node_count, j, geom, build_range_info);
 
-         disp->CmdPushConstants(commandBuffer, layout,
-                                VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(leaf_consts), &leaf_consts);
+         /* The scratch pointers stay the same for all geometries of a build,
+          * so only the first dispatch has to push them.
+          */
+         if (first_geometry) {
+            disp->CmdPushConstants(commandBuffer, layout,
+                                   VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(leaf_consts), &leaf_consts);
+            first_geometry = false;
+         } else {
+            disp->CmdPushConstants(commandBuffer, layout,
+                                   VK_SHADER_STAGE_COMPUTE_BIT, offsetof(struct leaf_args, geom_data),
+                                   sizeof(leaf_consts.geom_data), &leaf_consts.geom_data);
+         }
          device->cmd_dispatch_unaligned(commandBuffer, build_range_info->primitiveCount, 1, 1);
 
          bvh_states[i].leaf_node_count += build_range_info->primitiveCount;
@@ -611,6 +622,8 @@ morton_generate(VkCommandBuffer commandBuffer, struct vk_device *device,
    for (uint32_t i = 0; i < infoCount; ++i) {
       if (bvh_states[i].config.internal_type == INTERNAL_BUILD_TYPE_UPDATE)
          continue;
+      if (!bvh_states[i].leaf_node_count)
+         continue;
       const struct morton_args consts = {
          .bvh = pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.ir_offset,
          .header = pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.header_offset,
@@ -28,6 +28,98 @@
 #include "vk_common_entrypoints.h"
 #include "vk_device.h"
 
+#include "util/u_math.h"
+
+#define VK_CMD_ARENA_MIN_BLOCK (16 * 1024)
+
+struct vk_cmd_arena_block {
+   struct vk_cmd_arena_block *next;
+   size_t size;
+};
+
+/* The vk_cmd_queue allocates every entry and every deep-copied argument
+ * separately and frees them one by one on reset.  Point it at a bump
+ * allocator instead: frees are no-ops and the memory goes away (or is
+ * rewound) all at once in vk_cmd_arena_reset().
+ */
+static void *
+vk_cmd_arena_alloc(void *user_data, size_t size, size_t align,
+                   UNUSED VkSystemAllocationScope scope)
+{
+   struct vk_command_buffer *cmd_buffer = user_data;
+   uint8_t *ptr =
+      (uint8_t *)align_uintptr((uintptr_t)cmd_buffer->cmd_arena_ptr, align);
+
+   if (!cmd_buffer->cmd_arena_ptr || ptr + size > cmd_buffer->cmd_arena_end) {
+      size_t block_size =
+         MAX2(VK_CMD_ARENA_MIN_BLOCK,
+              cmd_buffer->cmd_arena ? cmd_buffer->cmd_arena->size * 2 : 0);
+      block_size = MAX2(block_size,
+                        sizeof(struct vk_cmd_arena_block) + size + align);
+
+      struct vk_cmd_arena_block *block =
+         vk_alloc(&cmd_buffer->pool->alloc, block_size, 8,
+                  VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!block)
+         return NULL;
+
+      block->next = cmd_buffer->cmd_arena;
+      block->size = block_size;
+      cmd_buffer->cmd_arena = block;
+      cmd_buffer->cmd_arena_ptr = (uint8_t *)(block + 1);
+      cmd_buffer->cmd_arena_end = (uint8_t *)block + block_size;
+
+      ptr = (uint8_t *)align_uintptr((uintptr_t)cmd_buffer->cmd_arena_ptr,
+                                     align);
+   }
+
+   cmd_buffer->cmd_arena_ptr = ptr + size;
+   return ptr;
+}
+
+static void *
+vk_cmd_arena_realloc(void *user_data, void *original, size_t size,
+                     size_t align, VkSystemAllocationScope scope)
+{
+   /* Nothing recorded into the cmd_queue is ever reallocated. */
+   assert(original == NULL);
+   if (original)
+      return NULL;
+
+   return vk_cmd_arena_alloc(user_data, size, align, scope);
+}
+
+static void
+vk_cmd_arena_free(UNUSED void *user_data, UNUSED void *ptr)
+{
+}
+
+/* Keeps the largest block when keep_one is set so that a command buffer
+ * that is re-recorded every frame settles on a single allocation.
+ */
+static void
+vk_cmd_arena_reset(struct vk_command_buffer *cmd_buffer, bool keep_one)
+{
+   struct vk_cmd_arena_block *block = cmd_buffer->cmd_arena;
+
+   if (keep_one && block) {
+      struct vk_cmd_arena_block *next = block->next;
+      block->next = NULL;
+      cmd_buffer->cmd_arena_ptr = (uint8_t *)(block + 1);
+      block = next;
+   } else {
+      cmd_buffer->cmd_arena = NULL;
+      cmd_buffer->cmd_arena_ptr = NULL;
+      cmd_buffer->cmd_arena_end = NULL;
+   }
+
+   while (block) {
+      struct vk_cmd_arena_block *next = block->next;
+      vk_free(&cmd_buffer->pool->alloc, block);
+      block = next;
+   }
+}
+
 VkResult
 vk_command_buffer_init(struct vk_command_pool *pool,
                        struct vk_command_buffer *command_buffer,
@@ -44,7 +136,14 @@ vk_command_buffer_init(struct vk_command_pool *pool,
    vk_dynamic_graphics_state_init(&command_buffer->dynamic_graphics_state);
    command_buffer->state = MESA_VK_COMMAND_BUFFER_STATE_INITIAL;
    command_buffer->record_result = VK_SUCCESS;
-   vk_cmd_queue_init(&command_buffer->cmd_queue, &pool->alloc);
+   command_buffer->cmd_queue_alloc = (VkAllocationCallbacks) {
+      .pUserData = command_buffer,
+      .pfnAllocation = vk_cmd_arena_alloc,
+      .pfnReallocation = vk_cmd_arena_realloc,
+      .pfnFree = vk_cmd_arena_free,
+   };
+   vk_cmd_queue_init(&command_buffer->cmd_queue,
+                     &command_buffer->cmd_queue_alloc);
    vk_meta_object_list_init(&command_buffer->meta_objects);
    util_dynarray_init(&command_buffer->labels, NULL);
    command_buffer->region_begin = true;
@@ -61,7 +160,11 @@ vk_command_buffer_reset(struct vk_command_buffer *command_buffer)
    command_buffer->state = MESA_VK_COMMAND_BUFFER_STATE_INITIAL;
    command_buffer->record_result = VK_SUCCESS;
    vk_command_buffer_reset_render_pass(command_buffer);
+   /* The walk only runs the driver_free_cb of entries holding references,
+    * the memory itself is released by rewinding the arena.
+    */
    vk_cmd_queue_reset(&command_buffer->cmd_queue);
+   vk_cmd_arena_reset(command_buffer, true);
    vk_meta_object_list_reset(command_buffer->base.device,
                              &command_buffer->meta_objects);
    util_dynarray_foreach (&command_buffer->labels, VkDebugUtilsLabelEXT, label)
@@ -70,6 +173,18 @@ vk_command_buffer_reset(struct vk_command_buffer *command_buffer)
    command_buffer->region_begin = true;
 }
 
+/**
+ * Frees the arena block vk_command_buffer_reset() keeps around, for
+ * VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT.  Must be called after
+ * vk_command_buffer_reset().
+ */
+void
+vk_command_buffer_release_arena(struct vk_command_buffer *command_buffer)
+{
+   assert(list_is_empty(&command_buffer->cmd_queue.cmds));
+   vk_cmd_arena_reset(command_buffer, false);
+}
+
 void
 vk_command_buffer_begin(struct vk_command_buffer *command_buffer,
                         const VkCommandBufferBeginInfo *pBeginInfo)
@@ -100,6 +215,7 @@ vk_command_buffer_finish(struct vk_command_buffer *command_buffer)
    list_del(&command_buffer->pool_link);
    vk_command_buffer_reset_render_pass(command_buffer);
    vk_cmd_queue_finish(&command_buffer->cmd_queue);
+   vk_cmd_arena_reset(command_buffer, false);
    util_dynarray_foreach (&command_buffer->labels, VkDebugUtilsLabelEXT, label)
       vk_free(&command_buffer->base.device->alloc, (void *)label->pLabelName);
    util_dynarray_fini(&command_buffer->labels);
@@ -36,6 +36,7 @@
 extern "C" {
 #endif
 
+struct vk_cmd_arena_block;
 struct vk_command_pool;
 struct vk_framebuffer;
 struct vk_image_view;
@@ -126,6 +127,16 @@ struct vk_command_buffer {
    /** Command list for emulated secondary command buffers */
    struct vk_cmd_queue cmd_queue;
 
+   /**
+    * Recorded commands and their argument copies are bump-allocated from
+    * these blocks through cmd_queue_alloc, whose frees are no-ops.  The head
+    * of the list is the largest block and the only one kept across resets.
+    */
+   VkAllocationCallbacks cmd_queue_alloc;
+   struct vk_cmd_arena_block *cmd_arena;
+   uint8_t *cmd_arena_ptr;
+   uint8_t *cmd_arena_end;
+
    /** Object list for meta objects */
    struct vk_meta_object_list meta_objects;
 
@@ -210,6 +221,9 @@ vk_command_buffer_reset_render_pass(struct vk_command_buffer *cmd_buffer);
 void
 vk_command_buffer_reset(struct vk_command_buffer *command_buffer);
 
+void
+vk_command_buffer_release_arena(struct vk_command_buffer *command_buffer);
+
 void
 vk_command_buffer_recycle(struct vk_command_buffer *command_buffer);
 
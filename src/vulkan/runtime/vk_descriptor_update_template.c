@@ -29,6 +29,28 @@
 #include "vk_device.h"
 #include "vk_log.h"
 
+/* Whether entry b picks up exactly where a stops, both in the descriptor set
+ * and in the user data, so that they can be applied as a single entry.
+ */
+static bool
+vk_descriptor_template_entries_contiguous(
+   const struct vk_descriptor_template_entry *a,
+   const struct vk_descriptor_template_entry *b)
+{
+   if (a->type != b->type || a->binding != b->binding ||
+       b->array_element != a->array_element + a->array_count)
+      return false;
+
+   /* For inline uniform blocks, the array element and count are in bytes
+    * and the stride is ignored.
+    */
+   if (a->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK)
+      return b->offset == a->offset + a->array_count;
+
+   return a->stride == b->stride &&
+          b->offset == a->offset + a->array_count * a->stride;
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    const VkDescriptorUpdateTemplateCreateInfo *pCreateInfo,
@@ -65,8 +87,14 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    if (template->type == VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET)
       template->set = pCreateInfo->set;
 
+   /* Applications commonly describe an array as one entry per element.
+    * Fold such runs into a single entry so drivers walking the template on
+    * every update do one iteration of their outer loop per run instead.
+    * An entry whose writes roll over into the next binding can't be
+    * followed by a valid entry continuing the same binding, so merging
+    * never changes which descriptors get written.
+    */
    uint32_t entry_idx = 0;
-   template->entry_count = entry_count;
    for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
       const VkDescriptorUpdateTemplateEntry *pEntry =
          &pCreateInfo->pDescriptorUpdateEntries[i];
@@ -74,7 +102,7 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       if (pEntry->descriptorCount == 0)
          continue;
 
-      template->entries[entry_idx++] = (struct vk_descriptor_template_entry) {
+      const struct vk_descriptor_template_entry entry = {
          .type = pEntry->descriptorType,
          .binding = pEntry->dstBinding,
          .array_element = pEntry->dstArrayElement,
@@ -82,8 +110,20 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
          .offset = pEntry->offset,
          .stride = pEntry->stride,
       };
+
+      if (entry_idx > 0) {
+         struct vk_descriptor_template_entry *prev =
+            &template->entries[entry_idx - 1];
+         if (vk_descriptor_template_entries_contiguous(prev, &entry)) {
+            prev->array_count += entry.array_count;
+            continue;
+         }
+      }
+
+      template->entries[entry_idx++] = entry;
    }
-   assert(entry_idx == entry_count);
+   assert(entry_idx <= entry_count);
+   template->entry_count = entry_idx;
 
    *pDescriptorUpdateTemplate =
       vk_descriptor_update_template_to_handle(template);
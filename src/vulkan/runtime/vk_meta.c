@@ -26,8 +26,10 @@
 
 #include "vk_buffer.h"
 #include "vk_command_buffer.h"
+#include "vk_common_entrypoints.h"
 #include "vk_device.h"
 #include "vk_pipeline.h"
+#include "vk_pipeline_cache.h"
 #include "vk_util.h"
 
 #include "nir.h"
@@ -91,6 +93,23 @@ vk_meta_device_init(struct vk_device *device,
    meta->cmd_draw_rects = vk_meta_draw_rects;
    meta->cmd_draw_volume = vk_meta_draw_volume;
 
+   /* Without any cache, every process rebuilds every meta pipeline it uses
+    * from scratch.  A VK_NULL_HANDLE cache already falls back to mem_cache.
+    */
+   if (device->mem_cache == NULL &&
+       device->dispatch_table.CreatePipelineCache ==
+          vk_common_CreatePipelineCache) {
+      struct vk_pipeline_cache_create_info info = { 0 };
+      struct vk_pipeline_cache *cache =
+         vk_pipeline_cache_create(device, &info, NULL);
+
+      /* Meta works without it, just slower on first use. */
+      if (cache != NULL) {
+         meta->pipeline_cache = vk_pipeline_cache_to_handle(cache);
+         meta->owns_pipeline_cache = true;
+      }
+   }
+
    return VK_SUCCESS;
 }
 
@@ -104,6 +123,11 @@ vk_meta_device_finish(struct vk_device *device,
    }
    _mesa_hash_table_destroy(meta->cache, NULL);
    simple_mtx_destroy(&meta->cache_mtx);
+
+   if (meta->owns_pipeline_cache) {
+      vk_pipeline_cache_destroy(vk_pipeline_cache_from_handle(meta->pipeline_cache),
+                                NULL);
+   }
 }
 
 uint64_t
@@ -107,7 +107,15 @@ struct vk_meta_device {
    struct hash_table *cache;
    simple_mtx_t cache_mtx;
 
+   /** Cache meta pipelines are created with
+    *
+    * If left as VK_NULL_HANDLE by the driver, vk_meta_device_init() creates
+    * one when the driver uses the common pipeline cache but doesn't have an
+    * implicit device->mem_cache, so that meta pipelines still end up in the
+    * disk cache.
+    */
    VkPipelineCache pipeline_cache;
+   bool owns_pipeline_cache;
 
    uint32_t max_bind_map_buffer_size_B;
    bool use_layered_rendering;
@@ -109,7 +109,8 @@ struct vk_physical_device {
     * when importing the cache. If an object type isn't in this list, then it
     * will be loaded as a raw data object and then deserialized when we first
     * look it up. Deserializing immediately avoids a copy but may be more
-    * expensive for objects that aren't hit.
+    * expensive for objects that aren't hit. Large caches are always imported
+    * as raw data objects.
     */
    const struct vk_pipeline_cache_object_ops *const *pipeline_cache_import_ops;
 };
@@ -37,6 +37,12 @@
 #include "util/hash_table.h"
 #include "util/set.h"
 
+/* Initial data larger than this is imported as raw data objects, which are
+ * only deserialized and written to the disk cache when they are looked up.
+ * Applications that hand us huge caches usually only hit a fraction of them.
+ */
+#define VK_PIPELINE_CACHE_LAZY_IMPORT_SIZE (64 * 1024 * 1024)
+
 #define vk_pipeline_cache_log(cache, ...)                                      \
    if (cache->base.client_visible)                                             \
       vk_logw(VK_LOG_OBJS(cache), __VA_ARGS__)
@@ -119,6 +125,7 @@ vk_raw_data_cache_object_create(struct vk_device *device,
                                  obj_key_data, key_size);
    data_obj->data = obj_data;
    data_obj->data_size = data_size;
+   data_obj->disk_cache_pending = false;
 
    memcpy(obj_key_data, key_data, key_size);
    memcpy(obj_data, data, data_size);
@@ -413,6 +420,15 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
          return NULL;
       }
 
+      struct disk_cache *disk_cache = get_disk_cache(cache);
+      if (data_obj->disk_cache_pending && !cache->skip_disk_cache && disk_cache) {
+         cache_key cache_key;
+         disk_cache_compute_key(disk_cache, data_obj->base.key_data,
+                                data_obj->base.key_size, cache_key);
+         disk_cache_put(disk_cache, cache_key, data_obj->data,
+                        data_obj->data_size, NULL);
+      }
+
       vk_pipeline_cache_object_unref(cache->base.device, object);
       object = vk_pipeline_cache_insert_object(cache, real_object);
    }
@@ -584,6 +600,8 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
    if (memcmp(&header, &cache->header, sizeof(header)) != 0)
       return;
 
+   const bool lazy = size > VK_PIPELINE_CACHE_LAZY_IMPORT_SIZE;
+
    for (uint32_t i = 0; i < count; i++) {
       int32_t type = blob_read_uint32(&blob);
       uint32_t key_size = blob_read_uint32(&blob);
@@ -594,12 +612,24 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
       if (blob.overrun)
          break;
 
-      const struct vk_pipeline_cache_object_ops *ops =
-         find_ops_for_type(cache->base.device->physical, type);
+      struct vk_pipeline_cache_object *object = NULL;
+      if (lazy) {
+         struct vk_raw_data_cache_object *data_obj =
+            vk_raw_data_cache_object_create(cache->base.device,
+                                            key_data, key_size,
+                                            data, data_size);
+         if (data_obj) {
+            data_obj->disk_cache_pending = true;
+            object = vk_pipeline_cache_insert_object(cache, &data_obj->base);
+         }
+      } else {
+         const struct vk_pipeline_cache_object_ops *ops =
+            find_ops_for_type(cache->base.device->physical, type);
 
-      struct vk_pipeline_cache_object *object =
-         vk_pipeline_cache_create_and_insert_object(cache, key_data, key_size,
-                                                    data, data_size, ops);
+         object = vk_pipeline_cache_create_and_insert_object(cache, key_data,
+                                                             key_size, data,
+                                                             data_size, ops);
+      }
 
       if (object == NULL) {
          vk_pipeline_cache_log(cache, "Failed to load pipeline cache object");
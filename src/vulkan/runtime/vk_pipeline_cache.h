@@ -302,6 +302,11 @@ struct vk_raw_data_cache_object {
 
    const void *data;
    size_t data_size;
+
+   /* Imported without being written to the disk cache, which is done when
+    * the object is first deserialized.
+    */
+   bool disk_cache_pending;
 };
 
 struct vk_raw_data_cache_object *
@@ -592,6 +592,24 @@ vk_queue_submits_merge(struct vk_queue *queue,
    return merged;
 }
 
+/* Whether the submit thread may hand second to the driver together with
+ * first.  Unlike vk_queue_submits_merge(), which only sees the batches of a
+ * single vkQueueSubmit(), this is used across calls and must not move any
+ * wait or signal relative to the command buffers, so it only takes submits
+ * with nothing but command buffers in between.
+ */
+static bool
+vk_queue_submits_can_coalesce(const struct vk_queue_submit *first,
+                              const struct vk_queue_submit *second)
+{
+   return first->signal_count == 0 &&
+          first->_mem_signal_temp == NULL &&
+          second->wait_count == 0 &&
+          !vk_queue_submit_has_bind(first) &&
+          !vk_queue_submit_has_bind(second) &&
+          first->perf_pass_index == second->perf_pass_index;
+}
+
 static void
 vk_queue_push_submit(struct vk_queue *queue,
                      struct vk_queue_submit *submit)
@@ -816,6 +834,30 @@ vk_queue_submit_thread_func(void *_data)
          list_first_entry(&queue->submit.submits,
                           struct vk_queue_submit, link);
 
+      /* Fold any submits queued up behind this one that only add command
+       * buffers into it, so that they cost a single driver submit.
+       */
+      while (submit->link.next != &queue->submit.submits) {
+         struct vk_queue_submit *next =
+            list_entry(submit->link.next, struct vk_queue_submit, link);
+         if (!vk_queue_submits_can_coalesce(submit, next))
+            break;
+
+         list_del(&submit->link);
+         list_del(&next->link);
+
+         struct vk_queue_submit *merged =
+            vk_queue_submits_merge(queue, submit, next);
+         if (merged == NULL) {
+            list_add(&next->link, &queue->submit.submits);
+            list_add(&submit->link, &queue->submit.submits);
+            break;
+         }
+
+         list_add(&merged->link, &queue->submit.submits);
+         submit = merged;
+      }
+
       /* Drop the lock while we wait */
       mtx_unlock(&queue->submit.mutex);
 
@@ -451,6 +451,35 @@ vk_sync_timeline_wait_locked(struct vk_device *device,
    if (result != VK_SUCCESS)
       return result;
 
+   /* Block on the first point that satisfies wait_value instead of on each
+    * point before it in turn.  Points nearly always signal in order, so once
+    * it has signaled the loop below only retires the earlier points without
+    * sleeping, rather than waking up and retaking the mutex once per point.
+    */
+   struct vk_sync_timeline_point *target = NULL;
+   list_for_each_entry(struct vk_sync_timeline_point, point,
+                       &timeline->pending_points, link) {
+      if (point->value >= wait_value) {
+         target = point;
+         break;
+      }
+   }
+
+   if (target != NULL && target != vk_sync_timeline_first_point(timeline)) {
+      vk_sync_timeline_point_ref(target);
+      mtx_unlock(&timeline->mutex);
+
+      result = vk_sync_wait(device, &target->sync, 0,
+                            VK_SYNC_WAIT_COMPLETE,
+                            abs_timeout_ns);
+
+      mtx_lock(&timeline->mutex);
+      vk_sync_timeline_point_unref(timeline, target);
+
+      if (result != VK_SUCCESS)
+         return result;
+   }
+
    while (timeline->highest_past < wait_value) {
       struct vk_sync_timeline_point *point = vk_sync_timeline_first_point(timeline);
 